@@ -0,0 +1,158 @@
+/***************************************************************************//**
+* @file adc_rng.c
+* @version 1.0.0
+*******************************************************************************
+* # License
+* <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_adc.h"
+#include "em_ldma.h"
+
+#include "adc_rng.h"
+
+// max ADC clock for Series 1 devices
+#define adcFreq                     16000000
+
+// VIN attenuation factor must be set to maximum to use the ADC as a RNG
+#define ADC_SINGLECTRLX_VINATT_MAX  0xF
+
+// Ping-pong buffer of raw samples and the descriptors filling its halves in
+// turn, forever
+static uint32_t rawSamples[2][ADC_RNG_BLOCK_SAMPLES];
+static LDMA_Descriptor_t rawDesc[2];
+static LDMA_TransferCfg_t rawXfer =
+  LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_ADC0_SINGLE);
+
+// Half to be processed next
+static uint32_t rawHalf;
+
+static adc_rng_extractor_t extractor;
+static volatile uint32_t overruns;
+
+/**************************************************************************//**
+ * @brief  LDMA interrupt handler, runs a filled half through the extractor
+ *****************************************************************************/
+void LDMA_IRQHandler(void)
+{
+  uint32_t pending = LDMA_IntGetEnabled();
+
+  if (pending & LDMA_IF_ERROR) {
+    LDMA_IntClear(LDMA_IF_ERROR);
+  }
+
+  if (pending & (1 << ADC_RNG_LDMA_CHANNEL)) {
+    LDMA_IntClear(1 << ADC_RNG_LDMA_CHANNEL);
+
+    adc_rng_extract(&extractor, rawSamples[rawHalf], ADC_RNG_BLOCK_SAMPLES);
+    rawHalf ^= 1;
+
+    // The other half filled up meanwhile: the LDMA is already overwriting
+    // samples that were not processed yet
+    if (LDMA_IntGet() & (1 << ADC_RNG_LDMA_CHANNEL)) {
+      overruns++;
+    }
+  }
+}
+
+/**************************************************************************//**
+ * @brief  Configure ADC0 as a noise source in repeat mode and start
+ *****************************************************************************/
+void adc_rng_init(void)
+{
+  ADC_Init_TypeDef init = ADC_INIT_DEFAULT;
+  ADC_InitSingle_TypeDef initSingle = ADC_INITSINGLE_DEFAULT;
+  LDMA_Init_t ldmaInit = LDMA_INIT_DEFAULT;
+
+  CMU_ClockEnable(cmuClock_ADC0, true);
+  ADC_Reset(ADC0);
+
+  // Max ADC clock, and no warm-up between conversions
+  init.prescale = ADC_PrescaleCalc(adcFreq, 0);
+  init.timebase = ADC_TimebaseCalc(0);
+  init.warmUpMode = adcWarmupKeepADCWarm;
+
+  // Same noise source configuration as the polled example, converting
+  // continuously
+  initSingle.diff       = true;               // Differential inputs
+  initSingle.reference  = adcRefVEntropy;     // internal 2.5V reference
+  initSingle.resolution = adcRes12Bit;        // 12-bit resolution
+  initSingle.posSel     = adcPosSelVSS;       // POSSEL connected to VSS
+  initSingle.negSel     = adcNegSelVSS;       // NEGSEL connected to VSS
+  initSingle.acqTime    = ADC_RNG_ACQ_TIME;
+  initSingle.rep        = true;               // Repeat mode
+
+  ADC_Init(ADC0, &init);
+  ADC_InitSingle(ADC0, &initSingle);
+  ADC0->SINGLECTRLX |= ADC_SINGLECTRLX_VINATT_MAX << \
+      _ADC_SINGLECTRLX_VINATT_SHIFT;
+  ADC0->SINGLEFIFOCLEAR |= ADC_SINGLEFIFOCLEAR_SINGLEFIFOCLEAR;
+
+  adc_rng_extract_init(&extractor);
+  rawHalf = 0;
+
+  // Two linked descriptors, each raising an interrupt when its half is full
+  LDMA_Init(&ldmaInit);
+  rawDesc[0] = (LDMA_Descriptor_t)
+               LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(ADC0->SINGLEDATA),
+                                                rawSamples[0],
+                                                ADC_RNG_BLOCK_SAMPLES,
+                                                1);
+  rawDesc[1] = (LDMA_Descriptor_t)
+               LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(ADC0->SINGLEDATA),
+                                                rawSamples[1],
+                                                ADC_RNG_BLOCK_SAMPLES,
+                                                -1);
+  rawDesc[0].xfer.doneIfs = 1;
+  rawDesc[1].xfer.doneIfs = 1;
+  LDMA_StartTransfer(ADC_RNG_LDMA_CHANNEL, &rawXfer, rawDesc);
+
+  ADC_Start(ADC0, adcStartSingle);
+}
+
+/**************************************************************************//**
+ * @brief  Read conditioned random bytes
+ *****************************************************************************/
+size_t adc_rng_read(uint8_t *buffer, size_t length)
+{
+  return adc_rng_extract_read(&extractor, buffer, length);
+}
+
+/**************************************************************************//**
+ * @brief  Get the harvester counters
+ *****************************************************************************/
+void adc_rng_stats_get(adc_rng_stats_t *stats)
+{
+  *stats = extractor.stats;
+  stats->overruns = overruns;
+}
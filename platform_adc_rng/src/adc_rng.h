@@ -0,0 +1,82 @@
+/***************************************************************************//**
+* @file adc_rng.h
+* @version 1.0.0
+*******************************************************************************
+* # License
+* <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#ifndef ADC_RNG_H
+#define ADC_RNG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "adc_rng_extract.h"
+
+// LDMA channel draining the ADC single FIFO
+#ifndef ADC_RNG_LDMA_CHANNEL
+#define ADC_RNG_LDMA_CHANNEL    0
+#endif
+
+// Raw samples in each half of the ping-pong buffer
+#ifndef ADC_RNG_BLOCK_SAMPLES
+#define ADC_RNG_BLOCK_SAMPLES   256
+#endif
+
+// ADC acquisition time, which sets the sample rate in repeat mode: the
+// extractor must keep up with it in the LDMA interrupt
+#ifndef ADC_RNG_ACQ_TIME
+#define ADC_RNG_ACQ_TIME        adcAcqTime32
+#endif
+
+/**************************************************************************//**
+ * @brief Configure ADC0 as a noise source in repeat mode and start
+ *   harvesting.
+ *
+ * The LDMA fills the two halves of a raw sample buffer in turn and the LDMA
+ * interrupt runs each filled half through the extractor.
+ *****************************************************************************/
+void adc_rng_init(void);
+
+/**************************************************************************//**
+ * @brief Read conditioned random bytes.
+ *
+ * @return Number of bytes read, up to length, 0 if none are ready yet.
+ *****************************************************************************/
+size_t adc_rng_read(uint8_t *buffer, size_t length);
+
+/**************************************************************************//**
+ * @brief Get the harvester counters.
+ *****************************************************************************/
+void adc_rng_stats_get(adc_rng_stats_t *stats);
+
+#endif // ADC_RNG_H
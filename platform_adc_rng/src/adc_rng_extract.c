@@ -0,0 +1,349 @@
+/***************************************************************************//**
+* @file adc_rng_extract.c
+* @version 1.0.0
+*******************************************************************************
+* # License
+* <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include <string.h>
+
+#include "em_device.h"
+
+#include "adc_rng_extract.h"
+
+#if (ADC_RNG_POOL_SIZE & (ADC_RNG_POOL_SIZE - 1))
+#error "ADC_RNG_POOL_SIZE must be a power of two"
+#endif
+
+#define ROTR(x, n)  (((x) >> (n)) | ((x) << (32 - (n))))
+
+static const uint32_t sha256K[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+  0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+  0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+  0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+  0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+  0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/*
+ * von Neumann extraction of a pair of 3-bit samples, bit by bit: a bit that
+ * differs between the two samples gives the bit of the first one, equal bits
+ * give nothing. Indexed by (first << 3) | second: number of bits in bits
+ * [7:4], bits in [2:0].
+ */
+static uint8_t vonNeumann[64];
+
+/**************************************************************************//**
+ * @brief Build the von Neumann table.
+ *****************************************************************************/
+static void von_neumann_init(void)
+{
+  uint32_t first, second, bit, count, bits;
+
+  for (first = 0; first < 8; first++) {
+    for (second = 0; second < 8; second++) {
+      count = 0;
+      bits = 0;
+      for (bit = 0; bit < 3; bit++) {
+        if (((first ^ second) >> bit) & 1) {
+          bits |= ((first >> bit) & 1) << count;
+          count++;
+        }
+      }
+      vonNeumann[(first << 3) | second] = (uint8_t)((count << 4) | bits);
+    }
+  }
+}
+
+/**************************************************************************//**
+ * @brief SHA-256 compression of one 64-byte block.
+ *****************************************************************************/
+static void sha256_compress(uint32_t state[8], const uint8_t *block)
+{
+  uint32_t w[64];
+  uint32_t a, b, c, d, e, f, g, h, t1, t2;
+  uint32_t i;
+
+  for (i = 0; i < 16; i++) {
+    w[i] = ((uint32_t)block[4 * i] << 24) | ((uint32_t)block[4 * i + 1] << 16)
+           | ((uint32_t)block[4 * i + 2] << 8) | block[4 * i + 3];
+  }
+  for (i = 16; i < 64; i++) {
+    w[i] = w[i - 16] + (ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3))
+           + w[i - 7] + (ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10));
+  }
+
+  a = state[0];
+  b = state[1];
+  c = state[2];
+  d = state[3];
+  e = state[4];
+  f = state[5];
+  g = state[6];
+  h = state[7];
+  for (i = 0; i < 64; i++) {
+    t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g))
+         + sha256K[i] + w[i];
+    t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+/**************************************************************************//**
+ * @brief Compute the SHA-256 digest of a message.
+ *****************************************************************************/
+void adc_rng_sha256(const uint8_t *message, size_t length, uint8_t digest[32])
+{
+  uint32_t state[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+  };
+  uint8_t block[64];
+  uint64_t bits = (uint64_t)length * 8;
+  size_t rest;
+  uint32_t i;
+
+  while (length >= 64) {
+    sha256_compress(state, message);
+    message += 64;
+    length -= 64;
+  }
+
+  // Padding: 0x80, zeros, then the message length in bits
+  rest = length;
+  memcpy(block, message, rest);
+  block[rest++] = 0x80;
+  if (rest > 56) {
+    memset(&block[rest], 0, 64 - rest);
+    sha256_compress(state, block);
+    rest = 0;
+  }
+  memset(&block[rest], 0, 56 - rest);
+  for (i = 0; i < 8; i++) {
+    block[56 + i] = (uint8_t)(bits >> (56 - 8 * i));
+  }
+  sha256_compress(state, block);
+
+  for (i = 0; i < 8; i++) {
+    digest[4 * i] = (uint8_t)(state[i] >> 24);
+    digest[4 * i + 1] = (uint8_t)(state[i] >> 16);
+    digest[4 * i + 2] = (uint8_t)(state[i] >> 8);
+    digest[4 * i + 3] = (uint8_t)state[i];
+  }
+}
+
+/**************************************************************************//**
+ * @brief Start over after a health test failure or at start-up.
+ *****************************************************************************/
+static void extract_restart(adc_rng_extractor_t *extractor)
+{
+  extractor->started = false;
+  extractor->startup = ADC_RNG_STARTUP_SAMPLES;
+  extractor->paired = false;
+  extractor->bits = 0;
+  extractor->bitCount = 0;
+  extractor->blockLength = 0;
+}
+
+/**************************************************************************//**
+ * @brief Run the health tests on a sample.
+ *
+ * @return False if a test failed.
+ *****************************************************************************/
+static bool health_test(adc_rng_extractor_t *extractor, uint8_t sample)
+{
+  if (!extractor->started) {
+    extractor->started = true;
+    extractor->rctSample = sample;
+    extractor->rctCount = 1;
+    extractor->aptSample = sample;
+    extractor->aptCount = 1;
+    extractor->aptIndex = 1;
+    return true;
+  }
+
+  // Repetition count test
+  if (sample == extractor->rctSample) {
+    if (++extractor->rctCount >= ADC_RNG_RCT_CUTOFF) {
+      extractor->stats.rctFailures++;
+      return false;
+    }
+  } else {
+    extractor->rctSample = sample;
+    extractor->rctCount = 1;
+  }
+
+  // Adaptive proportion test
+  if (extractor->aptIndex == ADC_RNG_APT_WINDOW) {
+    extractor->aptSample = sample;
+    extractor->aptCount = 1;
+    extractor->aptIndex = 1;
+  } else {
+    if ((sample == extractor->aptSample)
+        && (++extractor->aptCount >= ADC_RNG_APT_CUTOFF)) {
+      extractor->stats.aptFailures++;
+      return false;
+    }
+    extractor->aptIndex++;
+  }
+  return true;
+}
+
+/**************************************************************************//**
+ * @brief Hash a full block into the pool.
+ *****************************************************************************/
+static void condition(adc_rng_extractor_t *extractor)
+{
+  uint8_t digest[ADC_RNG_CONDITIONER_OUTPUT];
+  uint32_t head = extractor->head;
+
+  extractor->blockLength = 0;
+  if ((ADC_RNG_POOL_SIZE - (head - extractor->tail))
+      < ADC_RNG_CONDITIONER_OUTPUT) {
+    extractor->stats.dropped++;
+    return;
+  }
+
+  adc_rng_sha256(extractor->block, ADC_RNG_CONDITIONER_INPUT, digest);
+  for (uint32_t i = 0; i < ADC_RNG_CONDITIONER_OUTPUT; i++) {
+    extractor->pool[(head + i) & (ADC_RNG_POOL_SIZE - 1)] = digest[i];
+  }
+  // The reader must not see the new head before the digest is in the pool.
+  __DMB();
+  extractor->head = head + ADC_RNG_CONDITIONER_OUTPUT;
+  extractor->stats.blocks++;
+}
+
+/**************************************************************************//**
+ * @brief Start an extractor with an empty pool.
+ *****************************************************************************/
+void adc_rng_extract_init(adc_rng_extractor_t *extractor)
+{
+  memset(extractor, 0, sizeof(*extractor));
+  if (vonNeumann[(1 << 3) | 0] == 0) {
+    von_neumann_init();
+  }
+  extract_restart(extractor);
+}
+
+/**************************************************************************//**
+ * @brief Run raw ADC samples through the extractor.
+ *****************************************************************************/
+void adc_rng_extract(adc_rng_extractor_t *extractor,
+                     const uint32_t *samples,
+                     uint32_t count)
+{
+  uint8_t sample, pair;
+
+  extractor->stats.samples += count;
+  while (count-- > 0) {
+    sample = (uint8_t)(*samples++ & ADC_RNG_SAMPLE_MASK);
+
+    if (!health_test(extractor, sample)) {
+      extract_restart(extractor);
+      continue;
+    }
+    if (extractor->startup > 0) {
+      extractor->startup--;
+      continue;
+    }
+
+    if (!extractor->paired) {
+      extractor->first = sample;
+      extractor->paired = true;
+      continue;
+    }
+    extractor->paired = false;
+
+    pair = vonNeumann[(extractor->first << 3) | sample];
+    extractor->bits |= (uint32_t)(pair & 0x7) << extractor->bitCount;
+    extractor->bitCount += pair >> 4;
+    extractor->stats.debiasedBits += pair >> 4;
+
+    if (extractor->bitCount >= 8) {
+      extractor->block[extractor->blockLength++] = (uint8_t)extractor->bits;
+      extractor->bits >>= 8;
+      extractor->bitCount -= 8;
+      if (extractor->blockLength == ADC_RNG_CONDITIONER_INPUT) {
+        condition(extractor);
+      }
+    }
+  }
+}
+
+/**************************************************************************//**
+ * @brief Take conditioned bytes out of the pool.
+ *****************************************************************************/
+size_t adc_rng_extract_read(adc_rng_extractor_t *extractor,
+                            uint8_t *buffer,
+                            size_t length)
+{
+  uint32_t tail = extractor->tail;
+  uint32_t available = extractor->head - tail;
+
+  if (length > available) {
+    length = available;
+  }
+  // Read the pool bytes only after the head that covers them.
+  __DMB();
+  for (size_t i = 0; i < length; i++) {
+    buffer[i] = extractor->pool[(tail + i) & (ADC_RNG_POOL_SIZE - 1)];
+    extractor->pool[(tail + i) & (ADC_RNG_POOL_SIZE - 1)] = 0;
+  }
+  // The LDMA interrupt may hash new bytes into these slots once it sees the
+  // new tail, so they are read and wiped first.
+  __DMB();
+  extractor->tail = tail + length;
+
+  return length;
+}
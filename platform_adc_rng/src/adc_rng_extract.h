@@ -0,0 +1,149 @@
+/***************************************************************************//**
+* @file adc_rng_extract.h
+* @version 1.0.0
+*******************************************************************************
+* # License
+* <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#ifndef ADC_RNG_EXTRACT_H
+#define ADC_RNG_EXTRACT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// The LSB[2:0] of each ADC sample are the noise source
+#define ADC_RNG_SAMPLE_MASK         0x7
+
+// Continuous health tests of NIST SP 800-90B section 4.4 on the 3-bit raw
+// samples, assessed at 2 bits of min-entropy each, for a false positive
+// probability of 2^-20:
+//   repetition count     C = 1 + ceil(20 / 2)                        = 11
+//   adaptive proportion  C = 1 + CRITBINOM(512, 2^-2, 1 - 2^-20)     = 177
+#ifndef ADC_RNG_RCT_CUTOFF
+#define ADC_RNG_RCT_CUTOFF          11
+#endif
+#ifndef ADC_RNG_APT_CUTOFF
+#define ADC_RNG_APT_CUTOFF          177
+#endif
+#define ADC_RNG_APT_WINDOW          512
+
+// Samples tested but not used after a start or a health test failure
+#ifndef ADC_RNG_STARTUP_SAMPLES
+#define ADC_RNG_STARTUP_SAMPLES     1024
+#endif
+
+// Debiased bytes hashed into one SHA-256 output of 32 bytes
+#define ADC_RNG_CONDITIONER_INPUT   64
+#define ADC_RNG_CONDITIONER_OUTPUT  32
+
+// Conditioned bytes waiting to be read, a power of two
+#ifndef ADC_RNG_POOL_SIZE
+#define ADC_RNG_POOL_SIZE           1024
+#endif
+
+typedef struct {
+  uint32_t samples;         // Raw samples processed
+  uint32_t debiasedBits;    // Bits out of the von Neumann extractor
+  uint32_t blocks;          // Conditioned blocks added to the pool
+  uint32_t dropped;         // Conditioned blocks dropped, pool full
+  uint32_t rctFailures;     // Repetition count test failures
+  uint32_t aptFailures;     // Adaptive proportion test failures
+  uint32_t overruns;        // Raw blocks the extractor did not keep up with,
+                            // counted by adc_rng.c
+} adc_rng_stats_t;
+
+typedef struct {
+  // Health tests
+  bool started;
+  uint8_t rctSample;
+  uint32_t rctCount;
+  uint8_t aptSample;
+  uint32_t aptCount;
+  uint32_t aptIndex;
+  uint32_t startup;
+
+  // von Neumann extractor: first sample of the pair, and bits collected
+  bool paired;
+  uint8_t first;
+  uint32_t bits;
+  uint32_t bitCount;
+
+  // Conditioner input
+  uint8_t block[ADC_RNG_CONDITIONER_INPUT];
+  uint32_t blockLength;
+
+  // Conditioned output, written by adc_rng_extract() and read by
+  // adc_rng_extract_read()
+  uint8_t pool[ADC_RNG_POOL_SIZE];
+  volatile uint32_t head;
+  volatile uint32_t tail;
+
+  adc_rng_stats_t stats;
+} adc_rng_extractor_t;
+
+/**************************************************************************//**
+ * @brief Start an extractor with an empty pool.
+ *****************************************************************************/
+void adc_rng_extract_init(adc_rng_extractor_t *extractor);
+
+/**************************************************************************//**
+ * @brief Run raw ADC samples through the health tests, the von Neumann
+ *   extractor and the SHA-256 conditioner.
+ *
+ * A health test failure drops what was collected since the last conditioned
+ * block and starts over with start-up testing.
+ *
+ * @param[in] samples ADC results, only the LSB[2:0] are used.
+ * @param[in] count Number of samples.
+ *****************************************************************************/
+void adc_rng_extract(adc_rng_extractor_t *extractor,
+                     const uint32_t *samples,
+                     uint32_t count);
+
+/**************************************************************************//**
+ * @brief Take conditioned bytes out of the pool.
+ *
+ * Can be called while adc_rng_extract() runs in an interrupt.
+ *
+ * @return Number of bytes read, up to length.
+ *****************************************************************************/
+size_t adc_rng_extract_read(adc_rng_extractor_t *extractor,
+                            uint8_t *buffer,
+                            size_t length);
+
+/**************************************************************************//**
+ * @brief Compute the SHA-256 digest of a message (FIPS 180-4).
+ *****************************************************************************/
+void adc_rng_sha256(const uint8_t *message, size_t length, uint8_t digest[32]);
+
+#endif // ADC_RNG_EXTRACT_H
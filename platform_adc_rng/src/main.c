@@ -39,6 +39,7 @@
 #include "em_chip.h"
 #include "em_cmu.h"
 #include "em_adc.h"
+#include "adc_rng.h"
 
 // max ADC clock for Series 1 devices
 #define adcFreq                     16000000
@@ -55,8 +56,21 @@
 // to shift each new sample by 3 bits to create a larger random number.
 #define ADC_RND_BIT_SHIFT           3
 
+// Conditioned bytes generated to measure the throughput
+#define RNG_BENCHMARK_BYTES         4096
+
 volatile uint32_t sample, random_number;
 
+// Conditioned random bits per second, one conversion at a time and with the
+// LDMA harvester, and the harvester counters
+volatile uint32_t polled_bits_per_second, ldma_bits_per_second;
+adc_rng_stats_t rng_stats;
+
+static uint8_t rng_buffer[RNG_BENCHMARK_BYTES];
+
+// Extractor fed one conversion at a time, for comparison with the harvester
+static adc_rng_extractor_t polled_extractor;
+
 /**************************************************************************//**
  * @brief  Initialize ADC function
  *****************************************************************************/
@@ -87,12 +101,41 @@ void initADC (void)
   ADC_InitSingle(ADC0, &initSingle);
 }
 
+/**************************************************************************//**
+ * @brief  Conditioned bits per second from a byte count and a cycle count
+ *****************************************************************************/
+uint32_t bitsPerSecond (uint32_t bytes, uint32_t cycles)
+{
+  return (uint32_t)(((uint64_t)bytes * 8 * CMU_ClockFreqGet(cmuClock_CORE))
+                    / cycles);
+}
+
+/**************************************************************************//**
+ * @brief  Generate conditioned bytes polling one conversion at a time
+ *****************************************************************************/
+void pollRandomBytes (uint8_t *buffer, uint32_t length)
+{
+  uint32_t got = 0;
+  uint32_t data;
+
+  adc_rng_extract_init(&polled_extractor);
+  while (got < length) {
+    ADC_Start(ADC0, adcStartSingle);
+    while (!(ADC0->IF & _ADC_IF_SINGLE_MASK));
+    data = ADC_DataSingleGet(ADC0);
+
+    adc_rng_extract(&polled_extractor, &data, 1);
+    got += adc_rng_extract_read(&polled_extractor, &buffer[got], length - got);
+  }
+}
+
 /**************************************************************************//**
  * @brief  Main function
  *****************************************************************************/
 int main(void)
 {
   uint32_t i;
+  uint32_t start, got, value;
 
   // Since this example generates a 32-bit random number and since the ADC
   // produces 3 bits of random data per sample, we will need to go through 11
@@ -135,6 +178,35 @@ int main(void)
     random_number |= sample << (i * ADC_RND_BIT_SHIFT);
   }
 
-  // Infinite loop
-  while (1);
+  // Cycle counter for the throughput measurements
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  // Same health tests, extraction and conditioning, polling the ADC
+  start = DWT->CYCCNT;
+  pollRandomBytes(rng_buffer, RNG_BENCHMARK_BYTES);
+  polled_bits_per_second = bitsPerSecond(RNG_BENCHMARK_BYTES,
+                                         DWT->CYCCNT - start);
+
+  // Continuous harvesting: the ADC converts in repeat mode, the LDMA drains
+  // its FIFO and the extractor runs in the LDMA interrupt
+  start = DWT->CYCCNT;
+  adc_rng_init();
+  got = 0;
+  while (got < RNG_BENCHMARK_BYTES) {
+    got += adc_rng_read(&rng_buffer[got], RNG_BENCHMARK_BYTES - got);
+  }
+  ldma_bits_per_second = bitsPerSecond(RNG_BENCHMARK_BYTES,
+                                       DWT->CYCCNT - start);
+
+  // Infinite loop, a new 32-bit random number as soon as there is one
+  while (1) {
+    got = 0;
+    while (got < sizeof(value)) {
+      got += adc_rng_read((uint8_t *)&value + got, sizeof(value) - got);
+    }
+    random_number = value;
+    adc_rng_stats_get(&rng_stats);
+  }
 }
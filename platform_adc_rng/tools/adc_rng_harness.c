@@ -0,0 +1,268 @@
+/***************************************************************************//**
+* @file adc_rng_harness.c
+* @version 1.0.0
+*******************************************************************************
+* # License
+* <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+/*
+ * Host harness of the ADC entropy extractor (../src/adc_rng_extract.c).
+ *
+ * Feeds recorded or synthetic raw ADC samples through the health tests, the
+ * von Neumann extractor and the SHA-256 conditioner, and reports most common
+ * value min-entropy estimates (NIST SP 800-90B section 6.3.1) of the raw
+ * samples and of the output, the health test failures and the throughput.
+ *
+ * Build:
+ *   cc -O2 -I../src -Istub -o adc_rng_harness adc_rng_harness.c \
+ *      ../src/adc_rng_extract.c -lm
+ *
+ * Usage:
+ *   adc_rng_harness [options] [file]
+ *
+ *   file                 Recorded ADC results, one per line in decimal or 0x
+ *                        hex, for instance dumped from the raw sample buffer
+ *   --binary             The file holds little-endian 16-bit results instead
+ *   --samples N          Synthetic samples when there is no file
+ *                        (default 4000000)
+ *   --bias P             Synthetic: each bit is 1 with probability P
+ *                        (default 0.5)
+ *   --repeat P           Synthetic: a sample repeats the previous one with
+ *                        probability P (default 0)
+ *   --stuck-after N      Synthetic: the source is stuck after N samples
+ *   --sample-rate HZ     ADC sample rate used to project the device output
+ *                        rate (default 355000, 45 ADC clocks at 16 MHz)
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "adc_rng_extract.h"
+
+#define CHUNK 256
+
+static uint64_t xorshiftState = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t xorshift(void)
+{
+  xorshiftState ^= xorshiftState >> 12;
+  xorshiftState ^= xorshiftState << 25;
+  xorshiftState ^= xorshiftState >> 27;
+  return xorshiftState * 0x2545F4914F6CDD1DULL;
+}
+
+static double uniform(void)
+{
+  return (double)(xorshift() >> 11) / 9007199254740992.0;
+}
+
+/**************************************************************************//**
+ * @brief  Most common value min-entropy estimate, in bits per symbol
+ *****************************************************************************/
+static double mcv_entropy(const uint64_t *counts, uint32_t symbols,
+                          uint64_t total)
+{
+  uint64_t max = 0;
+  double p, pu;
+
+  if (total < 2) {
+    return 0.0;
+  }
+  for (uint32_t i = 0; i < symbols; i++) {
+    if (counts[i] > max) {
+      max = counts[i];
+    }
+  }
+  p = (double)max / total;
+  pu = p + 2.576 * sqrt(p * (1.0 - p) / (total - 1));
+  if (pu > 1.0) {
+    pu = 1.0;
+  }
+  return -log2(pu);
+}
+
+/**************************************************************************//**
+ * @brief  Load recorded samples
+ *****************************************************************************/
+static uint32_t *samples_load(const char *path, int binary, uint32_t *count)
+{
+  FILE *file = fopen(path, binary ? "rb" : "r");
+  uint32_t *samples = NULL;
+  uint32_t capacity = 0, n = 0;
+  unsigned char raw[2];
+  char line[64];
+  long value;
+
+  if (file == NULL) {
+    return NULL;
+  }
+  for (;;) {
+    if (binary) {
+      if (fread(raw, 1, 2, file) != 2) {
+        break;
+      }
+      value = raw[0] | (raw[1] << 8);
+    } else {
+      if (fgets(line, sizeof(line), file) == NULL) {
+        break;
+      }
+      if ((line[0] == '#') || (sscanf(line, "%li", &value) != 1)) {
+        continue;
+      }
+    }
+    if (n == capacity) {
+      capacity = capacity ? 2 * capacity : 65536;
+      samples = realloc(samples, capacity * sizeof(uint32_t));
+    }
+    samples[n++] = (uint32_t)value;
+  }
+  fclose(file);
+  *count = n;
+  return samples;
+}
+
+/**************************************************************************//**
+ * @brief  Generate synthetic samples
+ *****************************************************************************/
+static uint32_t *samples_generate(uint32_t count, double bias, double repeat,
+                                  uint32_t stuckAfter)
+{
+  uint32_t *samples = malloc(count * sizeof(uint32_t));
+  uint32_t sample = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    if (i >= stuckAfter) {
+      // Stuck at the last value
+    } else if ((i > 0) && (uniform() < repeat)) {
+      // Repeats the previous sample
+    } else {
+      // 12-bit result, the noise is in the low bits
+      sample = (uint32_t)(xorshift() >> 52) & 0xFF8;
+      for (uint32_t bit = 0; bit < 3; bit++) {
+        if (uniform() < bias) {
+          sample |= 1U << bit;
+        }
+      }
+    }
+    samples[i] = sample;
+  }
+  return samples;
+}
+
+int main(int argc, char **argv)
+{
+  static adc_rng_extractor_t extractor;
+  const char *path = NULL;
+  int binary = 0;
+  uint32_t count = 4000000, stuckAfter = UINT32_MAX;
+  double bias = 0.5, repeat = 0.0, sampleRate = 355000.0;
+  uint32_t *samples;
+  uint64_t rawCounts[8] = { 0 }, outCounts[256] = { 0 }, outBytes = 0;
+  uint8_t out[CHUNK];
+  size_t got;
+  clock_t start;
+  double seconds, bitsPerSample;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--binary") == 0) {
+      binary = 1;
+    } else if ((strcmp(argv[i], "--samples") == 0) && (i + 1 < argc)) {
+      count = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if ((strcmp(argv[i], "--bias") == 0) && (i + 1 < argc)) {
+      bias = atof(argv[++i]);
+    } else if ((strcmp(argv[i], "--repeat") == 0) && (i + 1 < argc)) {
+      repeat = atof(argv[++i]);
+    } else if ((strcmp(argv[i], "--stuck-after") == 0) && (i + 1 < argc)) {
+      stuckAfter = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if ((strcmp(argv[i], "--sample-rate") == 0) && (i + 1 < argc)) {
+      sampleRate = atof(argv[++i]);
+    } else if ((argv[i][0] != '-') && (path == NULL)) {
+      path = argv[i];
+    } else {
+      fprintf(stderr, "usage: %s [--binary] [--samples N] [--bias P] "
+              "[--repeat P] [--stuck-after N] [--sample-rate HZ] [file]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+
+  if (path != NULL) {
+    samples = samples_load(path, binary, &count);
+    if ((samples == NULL) || (count == 0)) {
+      fprintf(stderr, "no samples in %s\n", path);
+      return 1;
+    }
+  } else {
+    samples = samples_generate(count, bias, repeat, stuckAfter);
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    rawCounts[samples[i] & ADC_RNG_SAMPLE_MASK]++;
+  }
+
+  // Fed in blocks as the LDMA interrupt does, the pool read after each
+  adc_rng_extract_init(&extractor);
+  start = clock();
+  for (uint32_t i = 0; i < count; i += CHUNK) {
+    adc_rng_extract(&extractor, &samples[i],
+                    (count - i) < CHUNK ? (count - i) : CHUNK);
+    while ((got = adc_rng_extract_read(&extractor, out, sizeof(out))) > 0) {
+      for (size_t j = 0; j < got; j++) {
+        outCounts[out[j]]++;
+      }
+      outBytes += got;
+    }
+  }
+  seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+  bitsPerSample = (double)outBytes * 8 / count;
+
+  printf("samples:      %u%s\n", count, path ? "" : " (synthetic)");
+  printf("raw:          %.3f bits/sample min-entropy (MCV), 3 bits used\n",
+         mcv_entropy(rawCounts, 8, count));
+  printf("debiased:     %.3f bits/sample\n",
+         (double)extractor.stats.debiasedBits / count);
+  printf("conditioned:  %llu bytes, %.3f bits/sample, "
+         "%.3f bits/byte min-entropy (MCV)\n",
+         (unsigned long long)outBytes, bitsPerSample,
+         mcv_entropy(outCounts, 256, outBytes));
+  printf("health:       %u repetition count, %u adaptive proportion failures\n",
+         extractor.stats.rctFailures, extractor.stats.aptFailures);
+  printf("host:         %.1f Msamples/s, %.2f MB/s conditioned\n",
+         seconds > 0 ? count / seconds / 1e6 : 0.0,
+         seconds > 0 ? outBytes / seconds / 1e6 : 0.0);
+  printf("device:       %.0f conditioned bits/s at %.0f samples/s\n",
+         bitsPerSample * sampleRate, sampleRate);
+
+  free(samples);
+  return 0;
+}
@@ -0,0 +1,184 @@
+/***************************************************************************//**
+ * @file emu_temp_fixed.h
+ * @brief Fixed-point EMU temperature linearization and calibration
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef EMU_TEMP_FIXED_H
+#define EMU_TEMP_FIXED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sl_component_catalog.h"
+#if defined(SL_CATALOG_NVM3_PRESENT)
+#include "nvm3.h"
+#endif
+
+/*******************************************************************************
+ ******************************  DEFINES **************************************
+ ******************************************************************************/
+
+// All temperatures are degrees Celsius in Q16 (1.0 C = 65536). The raw sensor
+//   value is the EMU temperature in quarter degrees Kelvin.
+#define EMU_TEMP_Q16_ONE            65536
+#define EMU_TEMP_ZERO_C_RAW_Q16     17901158 // 273.15 K * 65536
+
+// Piecewise-linear table: EMU_TEMP_LUT_SIZE points, one every
+//   2^EMU_TEMP_LUT_SHIFT raw steps (4 K), covering -41.15 C to 126.85 C.
+#define EMU_TEMP_LUT_RAW_MIN        928
+#define EMU_TEMP_LUT_SHIFT          4
+#define EMU_TEMP_LUT_SIZE           43
+
+// NVM3 object holding the per-device two-point calibration.
+#ifndef EMU_TEMP_CALIBRATION_NVM3_KEY
+#define EMU_TEMP_CALIBRATION_NVM3_KEY 0x54C0
+#endif
+
+// Round a floating-point constant expression to an integer. Only used in
+//   initializers, so the arithmetic is done by the compiler.
+#define EMU_TEMP_ROUND(x)     ((x) < 0 ? (x) - 0.5 : (x) + 0.5)
+
+// Degrees Celsius constant in Q16, folded by the compiler.
+#define EMU_TEMP_CELSIUS_Q16(c)     ((int32_t)EMU_TEMP_ROUND((c) * 65536.0))
+
+// Third-order polynomial, a*x^3 + b*x^2 + c*x + d. Set a to 0 for the
+//   second-order correction.
+#define EMU_TEMP_POLY(a, b, c, d, x) \
+  ((((a) * (x) + (b)) * (x) + (c)) * (x) + (d))
+
+// Coefficients of emu_temp_poly_t, in Q32 to keep the precision of the small
+//   high-order terms.
+#define EMU_TEMP_POLY_INIT(a, b, c, d)             \
+  { { (int64_t)EMU_TEMP_ROUND((a) * 4294967296.0), \
+      (int64_t)EMU_TEMP_ROUND((b) * 4294967296.0), \
+      (int64_t)EMU_TEMP_ROUND((c) * 4294967296.0), \
+      (int64_t)EMU_TEMP_ROUND((d) * 4294967296.0) } }
+
+// Table point i in Q16, evaluated by the compiler from the coefficients.
+#define EMU_TEMP_LUT_CELSIUS(i) \
+  ((EMU_TEMP_LUT_RAW_MIN + ((i) << EMU_TEMP_LUT_SHIFT)) / 4.0 - 273.15)
+#define EMU_TEMP_LUT_POINT(a, b, c, d, i) \
+  (int32_t)EMU_TEMP_ROUND(                \
+    EMU_TEMP_POLY(a, b, c, d, EMU_TEMP_LUT_CELSIUS(i)) * 65536.0)
+#define EMU_TEMP_LUT_POINTS8(a, b, c, d, i) \
+  EMU_TEMP_LUT_POINT(a, b, c, d, (i)),      \
+  EMU_TEMP_LUT_POINT(a, b, c, d, (i) + 1),  \
+  EMU_TEMP_LUT_POINT(a, b, c, d, (i) + 2),  \
+  EMU_TEMP_LUT_POINT(a, b, c, d, (i) + 3),  \
+  EMU_TEMP_LUT_POINT(a, b, c, d, (i) + 4),  \
+  EMU_TEMP_LUT_POINT(a, b, c, d, (i) + 5),  \
+  EMU_TEMP_LUT_POINT(a, b, c, d, (i) + 6),  \
+  EMU_TEMP_LUT_POINT(a, b, c, d, (i) + 7)
+
+// Initializer of a const int32_t[EMU_TEMP_LUT_SIZE] table built at compile
+//   time from a set of polynomial coefficients.
+#define EMU_TEMP_LUT_INIT(a, b, c, d)   \
+  { EMU_TEMP_LUT_POINTS8(a, b, c, d, 0),  \
+    EMU_TEMP_LUT_POINTS8(a, b, c, d, 8),  \
+    EMU_TEMP_LUT_POINTS8(a, b, c, d, 16), \
+    EMU_TEMP_LUT_POINTS8(a, b, c, d, 24), \
+    EMU_TEMP_LUT_POINTS8(a, b, c, d, 32), \
+    EMU_TEMP_LUT_POINT(a, b, c, d, 40),   \
+    EMU_TEMP_LUT_POINT(a, b, c, d, 41),   \
+    EMU_TEMP_LUT_POINT(a, b, c, d, 42) }
+
+/*******************************************************************************
+ *******************************   STRUCTS   ***********************************
+ ******************************************************************************/
+
+typedef struct {
+  int64_t coeff[4];             // x^3 .. x^0 terms in Q32
+} emu_temp_poly_t;
+
+typedef struct {
+  int32_t gain;                 // Q16
+  int32_t offset;               // degrees C in Q16
+} emu_temp_calibration_t;
+
+/*******************************************************************************
+ *********************  GLOBAL FUNCTION DECLARATION ****************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @brief Read the last EMU temperature measurement.
+ *
+ * @return Temperature in quarter degrees Kelvin.
+ ******************************************************************************/
+uint32_t emu_temp_raw_get(void);
+
+/***************************************************************************//**
+ * @brief Convert a raw measurement to degrees Celsius in Q16.
+ ******************************************************************************/
+int32_t emu_temp_raw_to_q16(uint32_t raw);
+
+/***************************************************************************//**
+ * @brief Evaluate a correction polynomial with Horner's method.
+ *
+ * @param[in] poly Coefficients, see EMU_TEMP_POLY_INIT().
+ * @param[in] temp Uncorrected temperature in Q16.
+ *
+ * @return Corrected temperature in Q16.
+ ******************************************************************************/
+int32_t emu_temp_poly_q16(const emu_temp_poly_t *poly, int32_t temp);
+
+/***************************************************************************//**
+ * @brief Interpolate a correction table.
+ *
+ * @param[in] lut Table, see EMU_TEMP_LUT_INIT().
+ * @param[in] raw Raw measurement. Values outside the table are extrapolated
+ *                from the first or last segment.
+ *
+ * @return Corrected temperature in Q16.
+ ******************************************************************************/
+int32_t emu_temp_lut_q16(const int32_t *lut, uint32_t raw);
+
+/***************************************************************************//**
+ * @brief Compute a two-point calibration.
+ *
+ * @param[out] cal Calibration mapping each measured temperature to its
+ *                 reference.
+ * @param[in] measured1, reference1 First point, in Q16.
+ * @param[in] measured2, reference2 Second point, in Q16.
+ *
+ * @return False if the two measured temperatures are equal.
+ ******************************************************************************/
+bool emu_temp_calibration_compute(emu_temp_calibration_t *cal,
+                                  int32_t measured1, int32_t reference1,
+                                  int32_t measured2, int32_t reference2);
+
+/***************************************************************************//**
+ * @brief Apply a calibration to a corrected temperature in Q16.
+ ******************************************************************************/
+int32_t emu_temp_calibration_apply(const emu_temp_calibration_t *cal,
+                                   int32_t temp);
+
+#if defined(SL_CATALOG_NVM3_PRESENT)
+/***************************************************************************//**
+ * @brief Load the calibration of this device from NVM3.
+ *
+ * @param[out] cal Stored calibration, or the identity if there is no valid
+ *                 one.
+ *
+ * @return True if a valid calibration was loaded.
+ ******************************************************************************/
+bool emu_temp_calibration_load(emu_temp_calibration_t *cal);
+
+/***************************************************************************//**
+ * @brief Store the calibration of this device in NVM3.
+ ******************************************************************************/
+Ecode_t emu_temp_calibration_store(const emu_temp_calibration_t *cal);
+#endif
+
+#endif // EMU_TEMP_FIXED_H
@@ -22,25 +22,72 @@
 #include "em_emu.h"
 
 #include "app.h"
+#include "emu_temp_fixed.h"
 
 #include "sl_iostream.h"
 #include "sl_iostream_init_instances.h"
 #include "sl_iostream_handles.h"
 
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+// Polynomial corrections. Get the coefficients from the RM
+#define X3_TERM_3RD_ORDER   (-7.841e-7)
+#define X2_TERM_3RD_ORDER   (-1.454e-6)
+#define X1_TERM_3RD_ORDER   (1.005)
+#define X0_TERM_3RD_ORDER   (-4.897e-1)
+
+#define X2_TERM_2ND_ORDER   (-1.155e-4)
+#define X1_TERM_2ND_ORDER   (1.005)
+#define X0_TERM_2ND_ORDER   (-3.886e-1)
+
+// 1 to interpolate tables built by the compiler from the coefficients, 0 to
+//   evaluate the polynomials with Horner's method in fixed point.
+#define USE_CORRECTION_LUT  1
+
+// 1 to compute a two-point calibration from the values below and store it in
+//   NVM3 at startup, 0 to only load a stored one. Run the example without a
+//   stored calibration at two known temperatures and enter the 3rd order
+//   corrected value it prints at each, with the reference, in degrees C.
+#define STORE_CALIBRATION           0
+#define CALIBRATION_MEASURED_LOW    (-20.0)
+#define CALIBRATION_REFERENCE_LOW   (-20.0)
+#define CALIBRATION_MEASURED_HIGH   (85.0)
+#define CALIBRATION_REFERENCE_HIGH  (85.0)
+
 /*******************************************************************************
  ***************************  LOCAL VARIABLES   ********************************
  ******************************************************************************/
 
 static volatile uint32_t measure_EMU_temp = false;
 
-static float x3_term_3rd_order = -7.841e-7;
-static float x2_term_3rd_order = -1.454e-6;
-static float x1_term_3rd_order = 1.005;
-static float x0_term_3rd_order = -4.897e-1;
+#if USE_CORRECTION_LUT
+static const int32_t lut_3rd_order[EMU_TEMP_LUT_SIZE] =
+  EMU_TEMP_LUT_INIT(X3_TERM_3RD_ORDER, X2_TERM_3RD_ORDER,
+                    X1_TERM_3RD_ORDER, X0_TERM_3RD_ORDER);
+
+static const int32_t lut_2nd_order[EMU_TEMP_LUT_SIZE] =
+  EMU_TEMP_LUT_INIT(0.0, X2_TERM_2ND_ORDER,
+                    X1_TERM_2ND_ORDER, X0_TERM_2ND_ORDER);
+#else
+static const emu_temp_poly_t poly_3rd_order =
+  EMU_TEMP_POLY_INIT(X3_TERM_3RD_ORDER, X2_TERM_3RD_ORDER,
+                     X1_TERM_3RD_ORDER, X0_TERM_3RD_ORDER);
+
+static const emu_temp_poly_t poly_2nd_order =
+  EMU_TEMP_POLY_INIT(0.0, X2_TERM_2ND_ORDER,
+                     X1_TERM_2ND_ORDER, X0_TERM_2ND_ORDER);
+#endif
+
+// Per-device two-point calibration, identity if none is stored
+static emu_temp_calibration_t calibration;
 
-static float x2_term_2nd_order = -1.155e-4;
-static float x1_term_2nd_order = 1.005;
-static float x0_term_2nd_order = -3.886e-1;
+/*******************************************************************************
+ *********************   LOCAL FUNCTION PROTOTYPES   ***************************
+ ******************************************************************************/
+
+static void print_celsius(const char *label, int32_t temp);
 
 /*******************************************************************************
  **************************   GLOBAL FUNCTIONS   *******************************
@@ -64,6 +111,27 @@ void app_init(void)
   // Using printf to print to UART VCOM instance
   printf("\nEMU_Temp linearization example \n\n");
 
+#if STORE_CALIBRATION
+  if (emu_temp_calibration_compute(
+        &calibration,
+        EMU_TEMP_CELSIUS_Q16(CALIBRATION_MEASURED_LOW),
+        EMU_TEMP_CELSIUS_Q16(CALIBRATION_REFERENCE_LOW),
+        EMU_TEMP_CELSIUS_Q16(CALIBRATION_MEASURED_HIGH),
+        EMU_TEMP_CELSIUS_Q16(CALIBRATION_REFERENCE_HIGH))
+      && (emu_temp_calibration_store(&calibration) == ECODE_NVM3_OK)) {
+    printf("Device calibration stored\n");
+  } else {
+    printf("Device calibration not stored\n");
+  }
+#endif
+
+  // Load the calibration of this device, if any
+  if (emu_temp_calibration_load(&calibration)) {
+    printf("Device calibration loaded\n\n");
+  } else {
+    printf("No device calibration\n\n");
+  }
+
   // Initialize the EMU temperature sensor. Enable interrupts when temperature
   // measurement completes (every 250ms according to RM)
 
@@ -79,30 +147,36 @@ void app_init(void)
  ******************************************************************************/
 void app_process_action(void)
 {
-  float EMU_temp_raw = 0.0;
-  float EMU_temp_2nd_order_poly = 0.0;
-  float EMU_temp_3rd_order_poly = 0.0;
+  uint32_t EMU_temp_sample;
+  int32_t EMU_temp_raw;
+  int32_t EMU_temp_2nd_order_poly;
+  int32_t EMU_temp_3rd_order_poly;
 
   if (measure_EMU_temp == true) {
-    // Get EMU temperature in degrees C
-    EMU_temp_raw = EMU_TemperatureGet();
+    // Get EMU temperature in quarter degrees K and degrees C (Q16)
+    EMU_temp_sample = emu_temp_raw_get();
+    EMU_temp_raw = emu_temp_raw_to_q16(EMU_temp_sample);
+
+    // Polynomial Corrections, in fixed point
+#if USE_CORRECTION_LUT
+    EMU_temp_2nd_order_poly = emu_temp_lut_q16(lut_2nd_order, EMU_temp_sample);
+    EMU_temp_3rd_order_poly = emu_temp_lut_q16(lut_3rd_order, EMU_temp_sample);
+#else
+    EMU_temp_2nd_order_poly = emu_temp_poly_q16(&poly_2nd_order, EMU_temp_raw);
+    EMU_temp_3rd_order_poly = emu_temp_poly_q16(&poly_3rd_order, EMU_temp_raw);
+#endif
 
-    // Polynomial Corrections. Get the coefficients from the RM
+    // Per-device calibration
     EMU_temp_2nd_order_poly =
-      ((x2_term_2nd_order * EMU_temp_raw) + x1_term_2nd_order)
-      * EMU_temp_raw + x0_term_2nd_order;
-
+      emu_temp_calibration_apply(&calibration, EMU_temp_2nd_order_poly);
     EMU_temp_3rd_order_poly =
-      (((x3_term_3rd_order * EMU_temp_raw) + x2_term_3rd_order)
-       * EMU_temp_raw + x1_term_3rd_order)
-      * EMU_temp_raw + x0_term_3rd_order;
+      emu_temp_calibration_apply(&calibration, EMU_temp_3rd_order_poly);
 
     // Output via serial UART
-    printf(
-      "EMU_TempRaw:\t\t\t%3.2f\t  2nd Poly Correction:\t%3.2f\t  3rd Poly Correction:\t%3.2f\n",
-      EMU_temp_raw,
-      EMU_temp_2nd_order_poly,
-      EMU_temp_3rd_order_poly);
+    print_celsius("EMU_TempRaw:\t\t\t", EMU_temp_raw);
+    print_celsius("\t  2nd Poly Correction:\t", EMU_temp_2nd_order_poly);
+    print_celsius("\t  3rd Poly Correction:\t", EMU_temp_3rd_order_poly);
+    printf("\n");
 
     // Clear flag
     measure_EMU_temp = false;
@@ -119,3 +193,23 @@ void EMU_IRQHandler(void)
   // Flag main to get EMU temperature and send value over UART
   measure_EMU_temp = true;
 }
+
+/*******************************************************************************
+ **************************   LOCAL FUNCTIONS   ********************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @brief Print a label and a Q16 temperature with two decimals, without
+ *        floating-point printf support.
+ ******************************************************************************/
+static void print_celsius(const char *label, int32_t temp)
+{
+  uint32_t magnitude = (temp < 0) ? -(uint32_t)temp : (uint32_t)temp;
+  uint32_t hundredths = (magnitude * 100 + (EMU_TEMP_Q16_ONE / 2)) >> 16;
+
+  printf("%s%s%lu.%02lu",
+         label,
+         (temp < 0) ? "-" : "",
+         hundredths / 100,
+         hundredths % 100);
+}
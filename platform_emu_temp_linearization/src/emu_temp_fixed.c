@@ -0,0 +1,171 @@
+/***************************************************************************//**
+ * @file emu_temp_fixed.c
+ * @brief Fixed-point EMU temperature linearization and calibration
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include "em_device.h"
+
+#include "emu_temp_fixed.h"
+
+#if defined(SL_CATALOG_NVM3_PRESENT)
+#include "nvm3_default.h"
+#endif
+
+/*******************************************************************************
+ ******************************  DEFINES **************************************
+ ******************************************************************************/
+
+#define LUT_STEP              (1 << EMU_TEMP_LUT_SHIFT)
+#define LUT_RAW_LAST          \
+  (EMU_TEMP_LUT_RAW_MIN + (EMU_TEMP_LUT_SIZE - 2) * LUT_STEP)
+
+// A stored calibration outside these limits is treated as corrupt.
+#define CALIBRATION_GAIN_MIN    (EMU_TEMP_Q16_ONE * 3 / 4)
+#define CALIBRATION_GAIN_MAX    (EMU_TEMP_Q16_ONE * 5 / 4)
+#define CALIBRATION_OFFSET_MAX  (EMU_TEMP_Q16_ONE * 10)
+
+/*******************************************************************************
+ **************************   GLOBAL FUNCTIONS   *******************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Read the last EMU temperature measurement.
+ ******************************************************************************/
+uint32_t emu_temp_raw_get(void)
+{
+  uint32_t temp = EMU->TEMP;
+
+#if defined(_EMU_TEMP_TEMPLSB_MASK)
+  // TEMP (Kelvin) and TEMPLSB (quarter Kelvin) are adjacent, so both fields
+  //   together are the temperature in quarter Kelvin.
+  return (temp & (_EMU_TEMP_TEMP_MASK | _EMU_TEMP_TEMPLSB_MASK))
+         >> _EMU_TEMP_TEMPLSB_SHIFT;
+#else
+  return ((temp & _EMU_TEMP_TEMP_MASK) >> _EMU_TEMP_TEMP_SHIFT) << 2;
+#endif
+}
+
+/***************************************************************************//**
+ * Convert a raw measurement to degrees Celsius in Q16.
+ ******************************************************************************/
+int32_t emu_temp_raw_to_q16(uint32_t raw)
+{
+  return (int32_t)(raw * (EMU_TEMP_Q16_ONE / 4)) - EMU_TEMP_ZERO_C_RAW_Q16;
+}
+
+/***************************************************************************//**
+ * Evaluate a correction polynomial with Horner's method.
+ ******************************************************************************/
+int32_t emu_temp_poly_q16(const emu_temp_poly_t *poly, int32_t temp)
+{
+  // The accumulator stays in Q32. With |temp| below 2^24 (256 C) every
+  //   product fits in 64 bits.
+  int64_t acc = poly->coeff[0];
+
+  acc = ((acc * temp) >> 16) + poly->coeff[1];
+  acc = ((acc * temp) >> 16) + poly->coeff[2];
+  acc = ((acc * temp) >> 16) + poly->coeff[3];
+
+  return (int32_t)((acc + (1 << 15)) >> 16);
+}
+
+/***************************************************************************//**
+ * Interpolate a correction table.
+ ******************************************************************************/
+int32_t emu_temp_lut_q16(const int32_t *lut, uint32_t raw)
+{
+  uint32_t index = 0;
+  int32_t offset;
+
+  if (raw >= LUT_RAW_LAST) {
+    index = EMU_TEMP_LUT_SIZE - 2;
+  } else if (raw > EMU_TEMP_LUT_RAW_MIN) {
+    index = (raw - EMU_TEMP_LUT_RAW_MIN) >> EMU_TEMP_LUT_SHIFT;
+  }
+
+  // Offset into the segment, negative or beyond the segment when the raw
+  //   value is outside the table.
+  offset = (int32_t)raw
+           - (int32_t)(EMU_TEMP_LUT_RAW_MIN + (index << EMU_TEMP_LUT_SHIFT));
+
+  return lut[index]
+         + (((lut[index + 1] - lut[index]) * offset) >> EMU_TEMP_LUT_SHIFT);
+}
+
+/***************************************************************************//**
+ * Compute a two-point calibration.
+ ******************************************************************************/
+bool emu_temp_calibration_compute(emu_temp_calibration_t *cal,
+                                  int32_t measured1, int32_t reference1,
+                                  int32_t measured2, int32_t reference2)
+{
+  if (measured1 == measured2) {
+    return false;
+  }
+
+  cal->gain = (int32_t)(((int64_t)(reference2 - reference1) << 16)
+                        / (measured2 - measured1));
+  cal->offset = reference1
+                - (int32_t)(((int64_t)cal->gain * measured1) >> 16);
+  return true;
+}
+
+/***************************************************************************//**
+ * Apply a calibration to a corrected temperature in Q16.
+ ******************************************************************************/
+int32_t emu_temp_calibration_apply(const emu_temp_calibration_t *cal,
+                                   int32_t temp)
+{
+  return (int32_t)(((int64_t)cal->gain * temp) >> 16) + cal->offset;
+}
+
+#if defined(SL_CATALOG_NVM3_PRESENT)
+/***************************************************************************//**
+ * Load the calibration of this device from NVM3.
+ ******************************************************************************/
+bool emu_temp_calibration_load(emu_temp_calibration_t *cal)
+{
+  emu_temp_calibration_t stored;
+
+  cal->gain = EMU_TEMP_Q16_ONE;
+  cal->offset = 0;
+
+  if (nvm3_readData(nvm3_defaultHandle,
+                    EMU_TEMP_CALIBRATION_NVM3_KEY,
+                    &stored,
+                    sizeof(stored)) != ECODE_NVM3_OK) {
+    return false;
+  }
+  if ((stored.gain < CALIBRATION_GAIN_MIN)
+      || (stored.gain > CALIBRATION_GAIN_MAX)
+      || (stored.offset < -CALIBRATION_OFFSET_MAX)
+      || (stored.offset > CALIBRATION_OFFSET_MAX)) {
+    return false;
+  }
+
+  *cal = stored;
+  return true;
+}
+
+/***************************************************************************//**
+ * Store the calibration of this device in NVM3.
+ ******************************************************************************/
+Ecode_t emu_temp_calibration_store(const emu_temp_calibration_t *cal)
+{
+  return nvm3_writeData(nvm3_defaultHandle,
+                        EMU_TEMP_CALIBRATION_NVM3_KEY,
+                        cal,
+                        sizeof(*cal));
+}
+#endif
@@ -0,0 +1,313 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host accuracy and speed test of the fixed-point temperature correction
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ *******************************************************************************
+ *
+ * Runs ../src/emu_temp_fixed.c with the coefficients of every board of the
+ * example, and compares the table (USE_CORRECTION_LUT 1) and Horner's method
+ * (USE_CORRECTION_LUT 0) with the polynomial in double precision, for every
+ * raw measurement from -40 C to 125 C. The float polynomial of the former
+ * example is reported too. Also checks the register decoding and a two-point
+ * calibration, then prints the time per correction of the three methods.
+ *
+ * Cycles are read with the time stamp counter on x86 hosts, elsewhere the
+ * nanoseconds per correction are printed. The host has a double precision
+ * FPU: on a device without one, the float polynomial is much slower.
+ *
+ * Build:
+ *   cd tools
+ *   cc -O2 -Wall -Wextra -I../inc -Istub -o emu_temp_lut_test \
+ *      emu_temp_lut_test.c -lm
+ ******************************************************************************/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Built in, for the register decoding of emu_temp_raw_get()
+#include "../src/emu_temp_fixed.c"
+
+// Raw measurements in quarter Kelvin of -40 C and 125 C, rounded inwards
+#define RAW_MIN       933
+#define RAW_MAX       1592
+
+#define RUNS          200
+
+// Error limits given in the README, degrees C
+#define LUT_LIMIT     0.003
+#define HORNER_LIMIT  0.0002
+
+// Calibration points, degrees C. The Q16 gain is within 2^-17 of the exact
+//   one, which is up to 0.001 C at 125 C, plus the rounding of the offset and
+//   of the products.
+#define CAL_LOW       (-20.0)
+#define CAL_HIGH      85.0
+#define CAL_LIMIT     0.003
+
+// One correction of a board, with its table and Q32 coefficients built by
+//   the macros the example uses
+#define CORRECTION(board, order, a, b, c, d) \
+  { board, order, { a, b, c, d },            \
+    EMU_TEMP_LUT_INIT(a, b, c, d),           \
+    EMU_TEMP_POLY_INIT(a, b, c, d) }
+
+typedef struct {
+  const char *board;
+  int order;
+  double coeff[4];
+  int32_t lut[EMU_TEMP_LUT_SIZE];
+  emu_temp_poly_t poly;
+} correction_t;
+
+// Coefficients of ../src/brd*/app.c
+static const correction_t corrections[] = {
+  CORRECTION("brd4182a", 3, -8.186e-7, -3.005e-5, 1.015, -2.860),
+  CORRECTION("brd4182a", 2, 0.0, -1.570e-4, 1.017, -2.733),
+  CORRECTION("brd4186c", 3, -9.939e-7, -1.526e-4, 1.040, -3.577),
+  CORRECTION("brd4186c", 2, 0.0, -2.849e-4, 1.040, -3.374),
+  CORRECTION("brd4194a", 3, -7.841e-7, -1.454e-6, 1.005, -4.897e-1),
+  CORRECTION("brd4194a", 2, 0.0, -1.155e-4, 1.005, -3.886e-1),
+  CORRECTION("brd4210a", 3, -1.016e-6, -8.618e-5, 1.027, -3.921),
+  CORRECTION("brd4210a", 2, 0.0, -2.468e-4, 1.030, -3.772),
+  CORRECTION("brd4270b", 3, -2.360e-7, -6.742e-5, 1.028, -1.569),
+  CORRECTION("brd4270b", 2, 0.0, -2.870e-4, 1.033, -1.211),
+  CORRECTION("brd4400c", 3, -1.613e-6, 2.001e-5, 1.012, -2.894),
+  CORRECTION("brd4400c", 2, 0.0, -2.037e-4, 1.014, -2.683),
+};
+
+#define CORRECTIONS   (sizeof(corrections) / sizeof(corrections[0]))
+
+EMU_TypeDef emuStub;
+
+static uint32_t failures;
+
+/***************************************************************************//**
+ * Polynomial of a correction in double precision.
+ ******************************************************************************/
+static double poly_double(const correction_t *correction, double temp)
+{
+  const double *k = correction->coeff;
+
+  return EMU_TEMP_POLY(k[0], k[1], k[2], k[3], temp);
+}
+
+/***************************************************************************//**
+ * Polynomial of a correction in float, as the example computed it before.
+ ******************************************************************************/
+static float poly_float(const float *k, float temp)
+{
+  return ((k[0] * temp + k[1]) * temp + k[2]) * temp + k[3];
+}
+
+/***************************************************************************//**
+ * Raw measurement to degrees C in float, as EMU_TemperatureGet().
+ ******************************************************************************/
+static float raw_to_float(uint32_t raw)
+{
+  return (float)raw / 4.0f - 273.15f;
+}
+
+/***************************************************************************//**
+ * Time stamp, in cycles where the host has a counter.
+ ******************************************************************************/
+static uint64_t now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (uint64_t)time.tv_sec * 1000000000ULL + (uint64_t)time.tv_nsec;
+#endif
+}
+
+/***************************************************************************//**
+ * Largest error of the three methods against the double polynomial.
+ ******************************************************************************/
+static void accuracy(const correction_t *correction)
+{
+  double reference, lutError = 0, hornerError = 0, floatError = 0;
+  float k[4];
+
+  for (int i = 0; i < 4; i++) {
+    k[i] = (float)correction->coeff[i];
+  }
+  for (uint32_t raw = RAW_MIN; raw <= RAW_MAX; raw++) {
+    reference = poly_double(correction, raw / 4.0 - 273.15);
+    lutError = fmax(lutError,
+                    fabs(emu_temp_lut_q16(correction->lut, raw) / 65536.0
+                         - reference));
+    hornerError = fmax(hornerError,
+                       fabs(emu_temp_poly_q16(&correction->poly,
+                                              emu_temp_raw_to_q16(raw))
+                            / 65536.0 - reference));
+    floatError = fmax(floatError,
+                      fabs(poly_float(k, raw_to_float(raw)) - reference));
+  }
+
+  printf("%-9s %5d %12.6f %12.6f %12.6f\n", correction->board,
+         correction->order, lutError, hornerError, floatError);
+  if ((lutError > LUT_LIMIT) || (hornerError > HORNER_LIMIT)) {
+    failures++;
+  }
+}
+
+/***************************************************************************//**
+ * Decoding of the EMU->TEMP register.
+ ******************************************************************************/
+static void decoding(void)
+{
+  for (uint32_t raw = RAW_MIN; raw <= RAW_MAX; raw++) {
+    // Set bits outside both fields, which must be ignored
+    emuStub.TEMP = raw | 0xFFFF0000UL;
+    if (emu_temp_raw_get() != raw) {
+      printf("  EMU->TEMP 0x%08lx read as %lu\n",
+             (unsigned long)emuStub.TEMP, (unsigned long)emu_temp_raw_get());
+      failures++;
+      return;
+    }
+    if (fabs(emu_temp_raw_to_q16(raw) / 65536.0 - (raw / 4.0 - 273.15))
+        > 1.0 / 65536) {
+      printf("  raw %lu converted to %ld\n", (unsigned long)raw,
+             (long)emu_temp_raw_to_q16(raw));
+      failures++;
+      return;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * Two-point calibration of devices reading off by a gain and an offset.
+ ******************************************************************************/
+static void calibration(void)
+{
+  emu_temp_calibration_t cal;
+  double gain, offset, temp, error = 0;
+
+  if (emu_temp_calibration_compute(&cal, 10, 20, 10, 30)) {
+    printf("  calibration with equal measured points accepted\n");
+    failures++;
+  }
+
+  for (int g = -10; g <= 10; g++) {
+    for (int o = -5; o <= 5; o++) {
+      gain = 1.0 + g / 100.0;
+      offset = o;
+      if (!emu_temp_calibration_compute(
+            &cal,
+            EMU_TEMP_CELSIUS_Q16(CAL_LOW * gain + offset),
+            EMU_TEMP_CELSIUS_Q16(CAL_LOW),
+            EMU_TEMP_CELSIUS_Q16(CAL_HIGH * gain + offset),
+            EMU_TEMP_CELSIUS_Q16(CAL_HIGH))) {
+        printf("  calibration not computed\n");
+        failures++;
+        return;
+      }
+      for (temp = -40.0; temp <= 125.0; temp += 0.25) {
+        error = fmax(error,
+                     fabs(emu_temp_calibration_apply(
+                            &cal, EMU_TEMP_CELSIUS_Q16(temp * gain + offset))
+                          / 65536.0 - temp));
+      }
+    }
+  }
+  printf("two-point calibration, gain 0.9..1.1, offset -5..5 C: largest "
+         "error %.6f C\n", error);
+  if (error > CAL_LIMIT) {
+    failures++;
+  }
+}
+
+/***************************************************************************//**
+ * Best of RUNS times per correction of the three methods, on one board.
+ ******************************************************************************/
+static void benchmark(const correction_t *correction)
+{
+  volatile int32_t sinkFixed;
+  volatile float sinkFloat;
+  uint64_t start, ticks;
+  uint64_t best[3] = { UINT64_MAX, UINT64_MAX, UINT64_MAX };
+  uint32_t count = RAW_MAX - RAW_MIN + 1;
+  float k[4];
+
+  for (int i = 0; i < 4; i++) {
+    k[i] = (float)correction->coeff[i];
+  }
+  for (int run = 0; run < RUNS; run++) {
+    start = now();
+    for (uint32_t raw = RAW_MIN; raw <= RAW_MAX; raw++) {
+      sinkFloat = poly_float(k, raw_to_float(raw));
+    }
+    ticks = now() - start;
+    best[0] = (ticks < best[0]) ? ticks : best[0];
+
+    start = now();
+    for (uint32_t raw = RAW_MIN; raw <= RAW_MAX; raw++) {
+      sinkFixed = emu_temp_lut_q16(correction->lut, raw);
+    }
+    ticks = now() - start;
+    best[1] = (ticks < best[1]) ? ticks : best[1];
+
+    start = now();
+    for (uint32_t raw = RAW_MIN; raw <= RAW_MAX; raw++) {
+      sinkFixed = emu_temp_poly_q16(&correction->poly,
+                                    emu_temp_raw_to_q16(raw));
+    }
+    ticks = now() - start;
+    best[2] = (ticks < best[2]) ? ticks : best[2];
+  }
+  (void)sinkFixed;
+  (void)sinkFloat;
+
+#if defined(__x86_64__) || defined(__i386__)
+  printf("\n%-24s %10s %10s %10s\n", "cycles per correction", "float",
+         "table", "horner");
+#else
+  printf("\n%-24s %10s %10s %10s\n", "ns per correction", "float",
+         "table", "horner");
+#endif
+  printf("%-9s order %d %8s %10.2f %10.2f %10.2f\n", correction->board,
+         correction->order, "", (double)best[0] / count,
+         (double)best[1] / count, (double)best[2] / count);
+}
+
+int main(void)
+{
+  uint32_t before;
+
+  printf("largest error against the double polynomial, -40 C to 125 C, "
+         "degrees C\n");
+  printf("%-9s %5s %12s %12s %12s\n", "board", "order", "table", "horner",
+         "float");
+  for (size_t i = 0; i < CORRECTIONS; i++) {
+    accuracy(&corrections[i]);
+  }
+  printf("limits: table %.4f, horner %.4f\n\n", LUT_LIMIT, HORNER_LIMIT);
+
+  before = failures;
+  decoding();
+  printf("EMU->TEMP decoding: %s\n", (failures == before) ? "ok" : "FAIL");
+  calibration();
+
+  benchmark(&corrections[0]);
+
+  printf("\n%s\n", failures ? "FAIL" : "PASS");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,36 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for em_device.h, for tools/emu_temp_lut_test.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef EM_DEVICE_H
+#define EM_DEVICE_H
+
+#include <stdint.h>
+
+// Only the EMU temperature register, as on series 2 devices
+typedef struct {
+  volatile uint32_t TEMP;
+} EMU_TypeDef;
+
+#define _EMU_TEMP_TEMPLSB_SHIFT   0
+#define _EMU_TEMP_TEMPLSB_MASK    0x3UL
+#define _EMU_TEMP_TEMP_SHIFT      2
+#define _EMU_TEMP_TEMP_MASK       0x7FCUL
+
+extern EMU_TypeDef emuStub;
+#define EMU                       (&emuStub)
+
+#endif // EM_DEVICE_H
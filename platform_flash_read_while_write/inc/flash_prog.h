@@ -0,0 +1,105 @@
+/***************************************************************************//**
+ * @file
+ * @brief Buffered flash programming with read-while-write
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef FLASH_PROG_H
+#define FLASH_PROG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Jobs are queued and run from the MSC interrupt. Each job erases the pages
+ * of its range if asked, then streams its data: the MSC address increments
+ * by itself and the next word waits in WDATA while the current one is
+ * programmed, so the only per-word work is one WDATA write, from the CPU
+ * or from the DMA. The code keeps running from the other flash bank
+ * meanwhile.
+ */
+
+/***************************************************************************//**
+ * Job completion status.
+ ******************************************************************************/
+typedef enum {
+  flashProgOk = 0,
+  flashProgInvalidAddress,    // Outside flash, not aligned, or rejected
+  flashProgLocked,            // Page locked
+} flash_prog_status_t;
+
+typedef struct flash_prog_job flash_prog_job_t;
+
+/***************************************************************************//**
+ * Called from the MSC interrupt when a job is done.
+ ******************************************************************************/
+typedef void (*flash_prog_callback_t)(flash_prog_job_t *job,
+                                      flash_prog_status_t status);
+
+/***************************************************************************//**
+ * Programming job, owned by the caller until its callback.
+ ******************************************************************************/
+struct flash_prog_job {
+  uint32_t address;           // Word aligned, page aligned to erase
+  const uint32_t *data;       // Words to write, or NULL to only erase
+  uint32_t words;             // Length of the range in words
+  bool erase;                 // Erase the pages of the range first
+  flash_prog_callback_t callback;
+  void *context;              // For the caller
+
+  // Used by the engine
+  flash_prog_job_t *next;
+  uint32_t erased;            // Bytes erased
+  uint32_t written;           // Words written
+};
+
+/***************************************************************************//**
+ * Engine configuration.
+ ******************************************************************************/
+typedef struct {
+  bool writeDouble;           // Program two words at a time
+  bool useDma;                // Feed WDATA from the DMA instead of the CPU
+  uint32_t dmaChannel;
+} flash_prog_config_t;
+
+/***************************************************************************//**
+ * Initialize the engine, with an empty queue.
+ *
+ * The MSC interrupt must call flash_prog_irq_handler(). With useDma, the DMA
+ * is initialized too, and its interrupt is the one of emlib.
+ ******************************************************************************/
+void flash_prog_init(const flash_prog_config_t *config);
+
+/***************************************************************************//**
+ * Queue a job.
+ *
+ * The job runs after the ones queued before it. Jobs can be queued from the
+ * callbacks.
+ *
+ * @return flashProgInvalidAddress if the range is not valid, and then the job
+ *   is not queued, else flashProgOk.
+ ******************************************************************************/
+flash_prog_status_t flash_prog_submit(flash_prog_job_t *job);
+
+/***************************************************************************//**
+ * True when all the queued jobs are done.
+ ******************************************************************************/
+bool flash_prog_idle(void);
+
+/***************************************************************************//**
+ * MSC interrupt handler of the engine.
+ ******************************************************************************/
+void flash_prog_irq_handler(void);
+
+#endif // FLASH_PROG_H
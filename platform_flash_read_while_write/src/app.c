@@ -16,28 +16,85 @@
  ******************************************************************************/
 
 #include "em_cmu.h"
+#include "em_device.h"
 #include "em_gpio.h"
-#include "em_msc.h"
 
-// The write will be performed to the lower half of flash. Hence the start and
-// end addresses of the lower half are defined here.
-#define WRITE_ADDRESS_START     ((uint32_t *)0x00080000)
-#define WRITE_ADDRESS_END       ((uint32_t *)0x00100000)
+#include "flash_prog.h"
 
-// counts 1ms timeTicks
-volatile uint32_t msTicks;
+// The write will be performed to the upper half of flash, the bank the code
+// does not run from. Hence the start and end addresses of the upper half are
+// defined here.
+#define WRITE_ADDRESS_START     0x00080000UL
+#define WRITE_ADDRESS_END       0x00100000UL
 
-// The flash page size in a Giant Gecko device is 4096 bytes
-uint32_t GG_S0_PAGE_SIZE = 0x1000;
+#define PAGE_WORDS              (FLASH_PAGE_SIZE / sizeof(uint32_t))
+#define PAGES                   ((WRITE_ADDRESS_END - WRITE_ADDRESS_START) \
+                                 / FLASH_PAGE_SIZE)
 
-static void FLASH_writeWord(uint32_t *adr, uint32_t data);
+// Set to 1 to feed the flash from the DMA instead of the MSC interrupt
+#ifndef FLASH_PROG_USE_DMA
+#define FLASH_PROG_USE_DMA      0
+#endif
+
+// Pattern written to each page
+static uint32_t pattern[PAGE_WORDS];
+
+// One job per page: erase, then write the pattern
+static flash_prog_job_t jobs[PAGES];
+
+static volatile uint32_t pagesDone;
+static volatile uint32_t pagesFailed;
+static uint32_t startCycles;
+static volatile uint32_t endCycles;
+static bool verified;
+
+// Results, to look at from the debugger
+volatile uint32_t bytesPerSecond;
+volatile uint32_t verifyErrors;
+// Passes of app_process_action() while the flash was being written
+volatile uint32_t appLoops;
+
+/***************************************************************************//**
+ * Called from the MSC interrupt when a page is written.
+ ******************************************************************************/
+static void page_done(flash_prog_job_t *job, flash_prog_status_t status)
+{
+  (void)job;
+
+  if (status != flashProgOk) {
+    pagesFailed++;
+  }
+  if (++pagesDone == PAGES) {
+    endCycles = DWT->CYCCNT;
+  }
+}
+
+/***************************************************************************//**
+ * Check the written half of flash against the pattern.
+ ******************************************************************************/
+static uint32_t flash_verify(void)
+{
+  const uint32_t *flash = (const uint32_t *)WRITE_ADDRESS_START;
+  uint32_t errors = 0;
+
+  for (uint32_t i = 0; i < PAGES * PAGE_WORDS; i++) {
+    if (flash[i] != pattern[i % PAGE_WORDS]) {
+      errors++;
+    }
+  }
+  return errors;
+}
 
 /***************************************************************************//**
  * Initialize application.
  ******************************************************************************/
 void app_init(void)
 {
-  uint32_t address;
+  flash_prog_config_t config = {
+    .writeDouble = true,
+    .useDma = FLASH_PROG_USE_DMA,
+    .dmaChannel = 0,
+  };
 
   // Enable high frequency and GPIO clocks
   CMU_ClockEnable(cmuClock_HFPER, true);
@@ -46,27 +103,31 @@ void app_init(void)
   // Configure the GPIO to push-pull
   GPIO_PinModeSet(gpioPortD, 6, gpioModePushPull, 0);
 
-  // Set the start address for page erase
-  address = (uint32_t)WRITE_ADDRESS_START;
+  // Cycle counter, to time the programming
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 
-  // Erase the lower half of flash
-  while (address < (uint32_t)WRITE_ADDRESS_END) {
-    MSC_ErasePage((uint32_t *)address);
-    // Since flash erases the entire page, increment by a page for the next
-    // erase
-    address = address + GG_S0_PAGE_SIZE;
+  for (uint32_t i = 0; i < PAGE_WORDS; i++) {
+    pattern[i] = 0xA5A5A5A5 ^ i;
   }
 
-  // Write a pattern across the entire lower half of flash
-  for (address = (uint32_t)WRITE_ADDRESS_START; \
-       address < (uint32_t)WRITE_ADDRESS_END;) {
-    FLASH_writeWord((uint32_t *)address, 0xA5A5A5A5);
-    // Increment by a word
-    address = address + 4;
+  flash_prog_init(&config);
+
+  // Queue the whole upper half of flash. The pages are erased and written
+  // from the MSC interrupt while app_process_action() keeps running.
+  startCycles = DWT->CYCCNT;
+  for (uint32_t page = 0; page < PAGES; page++) {
+    jobs[page].address = WRITE_ADDRESS_START + page * FLASH_PAGE_SIZE;
+    jobs[page].data = pattern;
+    jobs[page].words = PAGE_WORDS;
+    jobs[page].erase = true;
+    jobs[page].callback = page_done;
+    jobs[page].context = NULL;
+    if (flash_prog_submit(&jobs[page]) != flashProgOk) {
+      pagesFailed++;
+    }
   }
-
-  // Disable writing to the MSC module.
-  MSC->WRITECTRL &= ~MSC_WRITECTRL_WREN;
 }
 
 /***************************************************************************//**
@@ -74,40 +135,29 @@ void app_init(void)
  ******************************************************************************/
 void app_process_action(void)
 {
-}
-
-/**************************************************************************//**
- * Programs a single word into flash. In general, the write data must be
- * aligned to words and contain a number of bytes that is divisible by four.
- *
- * It is recommended to erase the flash page before performing a write. A
- * function has been custom written instead of using MSC_WriteWord since most
- * em_msc functions are executed from RAM which is necessary when the flash
- * region is not split to read and write sections.
- *
- *****************************************************************************/
-static void FLASH_writeWord(uint32_t *adr, uint32_t data)
-{
-  // Enable Read-While-Write feature (RWWEN) and write and erase feature(WREN)
-  MSC->WRITECTRL |= MSC_WRITECTRL_RWWEN | MSC_WRITECTRL_WREN;
-
-  // Load page address for the write operation
-  MSC->ADDRB = (uint32_t)adr;
-  MSC->WRITECMD = MSC_WRITECMD_LADDRIM;
-
-  // The WDATA register must be written when the WDATAREADY bit is set
-  while (!(MSC->STATUS & MSC_STATUS_WDATAREADY)) {}
+  uint32_t cycles;
 
-  // Load data to be written to the address in MSC_ADDR
-  MSC->WDATA = data;
-
-  // Starts write of the first word written to MSC_WDATA
-  MSC->WRITECMD = MSC_WRITECMD_WRITEONCE;
-
-  /* Poll till the write is complete */
-  while (MSC->STATUS & MSC_STATUS_BUSY) {
-    // Add a GPIO toggle within the wait function. Observe the GPIO in an
-    // o-scope to see the device writing when it is reading
+  if (!flash_prog_idle()) {
+    // Runs from the lower bank while the upper one is written. Observe the
+    // GPIO in an o-scope to see the device reading while it is writing.
     GPIO_PinOutToggle(gpioPortD, 6);
+    appLoops++;
+    return;
   }
+
+  if (!verified) {
+    verified = true;
+    verifyErrors = flash_verify() + pagesFailed;
+    cycles = endCycles - startCycles;
+    bytesPerSecond = (uint32_t)(((uint64_t)PAGES * FLASH_PAGE_SIZE
+                                 * CMU_ClockFreqGet(cmuClock_CORE)) / cycles);
+  }
+}
+
+/***************************************************************************//**
+ * MSC interrupt handler, runs the flash programming.
+ ******************************************************************************/
+void MSC_IRQHandler(void)
+{
+  flash_prog_irq_handler();
 }
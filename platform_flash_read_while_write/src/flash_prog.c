@@ -0,0 +1,393 @@
+/***************************************************************************//**
+ * @file
+ * @brief Buffered flash programming with read-while-write
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+
+#include "flash_prog.h"
+
+#if defined(FLASH_PROG_HOST_MODEL)
+// Built on the host against the MSC model in tools/
+#include "flash_model.h"
+#else
+#include "em_cmu.h"
+#include "em_common.h"
+#include "em_core.h"
+#include "em_device.h"
+#include "em_dma.h"
+
+#define MSC_READ(reg)           (MSC->reg)
+#define MSC_WRITE(reg, value)   (MSC->reg = (value))
+
+// DMA channel control structures, primary and alternate, aligned as the
+// DMA controller needs
+#define DMA_CONTROL_CHANNELS    16
+#endif
+
+static flash_prog_config_t progConfig;
+
+// Jobs not done yet, the first one is running
+static flash_prog_job_t *queueHead;
+static flash_prog_job_t *queueTail;
+
+// Current write burst: the words from burstNext up to burstEnd still go to
+// WDATA. The address only increments within a page, so a burst never
+// crosses one.
+static flash_prog_job_t *burstJob;
+static const uint32_t *burstData;
+static uint32_t burstNext;
+static uint32_t burstEnd;
+static bool burstDouble;
+static bool burstEnding;
+static bool dmaRunning;
+
+static void dma_done(void);
+
+#if defined(FLASH_PROG_HOST_MODEL)
+
+static void dma_init(void)
+{
+}
+
+static void dma_start(const uint32_t *data, uint32_t words)
+{
+  flash_model_dma_start(data, words, dma_done);
+}
+
+#else
+
+SL_ALIGN(512)
+static DMA_DESCRIPTOR_TypeDef dmaControlBlock[DMA_CONTROL_CHANNELS * 2]
+SL_ATTRIBUTE_ALIGN(512);
+
+static void dma_callback(unsigned int channel, bool primary, void *user)
+{
+  (void)channel;
+  (void)primary;
+  (void)user;
+  dma_done();
+}
+
+static DMA_CB_TypeDef dmaCallback = { dma_callback, NULL, 0 };
+
+/***************************************************************************//**
+ * Set up a DMA channel to move words to WDATA when it is ready.
+ ******************************************************************************/
+static void dma_init(void)
+{
+  DMA_Init_TypeDef init;
+  DMA_CfgChannel_TypeDef channelConfig;
+  DMA_CfgDescr_TypeDef descriptorConfig;
+
+  CMU_ClockEnable(cmuClock_DMA, true);
+
+  init.hprot = 0;
+  init.controlBlock = dmaControlBlock;
+  DMA_Init(&init);
+
+  channelConfig.highPri = true;
+  channelConfig.enableInt = true;
+  channelConfig.select = DMAREQ_MSC_WDATA;
+  channelConfig.cb = &dmaCallback;
+  DMA_CfgChannel(progConfig.dmaChannel, &channelConfig);
+
+  descriptorConfig.dstInc = dmaDataIncNone;
+  descriptorConfig.srcInc = dmaDataInc4;
+  descriptorConfig.size = dmaDataSize4;
+  descriptorConfig.arbRate = dmaArbitrate1;
+  descriptorConfig.hprot = 0;
+  DMA_CfgDescr(progConfig.dmaChannel, true, &descriptorConfig);
+}
+
+static void dma_start(const uint32_t *data, uint32_t words)
+{
+  DMA_ActivateBasic(progConfig.dmaChannel, true, false,
+                    (void *)&MSC->WDATA, (void *)data, words - 1);
+}
+
+#endif
+
+/***************************************************************************//**
+ * Size to erase for a job, in whole pages.
+ ******************************************************************************/
+static uint32_t erase_size(const flash_prog_job_t *job)
+{
+  return (job->words * sizeof(uint32_t) + FLASH_PAGE_SIZE - 1)
+         & ~(FLASH_PAGE_SIZE - 1);
+}
+
+/***************************************************************************//**
+ * Load the address of the next erase or write, with the MSC idle.
+ ******************************************************************************/
+static flash_prog_status_t address_load(uint32_t address)
+{
+  uint32_t status;
+
+  MSC_WRITE(ADDRB, address);
+  MSC_WRITE(WRITECMD, MSC_WRITECMD_LADDRIM);
+
+  status = MSC_READ(STATUS);
+  if (status & MSC_STATUS_INVADDR) {
+    return flashProgInvalidAddress;
+  }
+  if (status & MSC_STATUS_LOCKED) {
+    return flashProgLocked;
+  }
+  return flashProgOk;
+}
+
+/***************************************************************************//**
+ * Give WDATA the next words of the burst while it has room.
+ ******************************************************************************/
+static void burst_feed(void)
+{
+  while ((burstNext != burstEnd)
+         && (MSC_READ(STATUS) & MSC_STATUS_WDATAREADY)) {
+    MSC_WRITE(WDATA, *burstData++);
+    burstNext += sizeof(uint32_t);
+  }
+
+  // Once the last word left WDATA, end the burst rather than let the MSC
+  // wait for more until the word timeout, which raises no interrupt.
+  if ((burstNext == burstEnd) && !burstEnding
+      && (MSC_READ(STATUS) & MSC_STATUS_WDATAREADY)) {
+    MSC_WRITE(WRITECMD, MSC_WRITECMD_WRITEEND);
+    burstEnding = true;
+  }
+}
+
+/***************************************************************************//**
+ * Start writing the next words of a job, with the MSC idle.
+ ******************************************************************************/
+static flash_prog_status_t burst_start(flash_prog_job_t *job)
+{
+  uint32_t address = job->address + job->written * sizeof(uint32_t);
+  uint32_t end = job->address + job->words * sizeof(uint32_t);
+  uint32_t pageEnd = (address | (FLASH_PAGE_SIZE - 1)) + 1;
+  uint32_t control = MSC_READ(WRITECTRL) & ~MSC_WRITECTRL_WDOUBLE;
+  flash_prog_status_t status;
+  bool writeDouble;
+
+  if (end > pageEnd) {
+    end = pageEnd;
+  }
+
+  // Double words need an aligned pair, the odd word around goes alone
+  writeDouble = progConfig.writeDouble && ((address & 7) == 0)
+                && ((end - address) >= 8);
+  if (writeDouble) {
+    end = address + ((end - address) & ~7u);
+    control |= MSC_WRITECTRL_WDOUBLE;
+  }
+  MSC_WRITE(WRITECTRL, control);
+
+  status = address_load(address);
+  if (status != flashProgOk) {
+    return status;
+  }
+
+  burstJob = job;
+  burstData = job->data + job->written;
+  burstNext = address;
+  burstEnd = end;
+  burstDouble = writeDouble;
+  burstEnding = false;
+
+  // Load the first data phase, then write each word as it is given
+  MSC_WRITE(IFC, MSC_IFC_WRITE);
+  MSC_WRITE(WDATA, *burstData++);
+  burstNext += sizeof(uint32_t);
+  if (writeDouble) {
+    while (!(MSC_READ(STATUS) & MSC_STATUS_WDATAREADY)) {
+    }
+    MSC_WRITE(WDATA, *burstData++);
+    burstNext += sizeof(uint32_t);
+  }
+  MSC_WRITE(WRITECMD, MSC_WRITECMD_WRITETRIG);
+
+  if (progConfig.useDma && (burstNext != burstEnd)) {
+    // No interrupt per word: wait for the DMA to be done
+    MSC_WRITE(IEN, MSC_IEN_ERASE);
+    dmaRunning = true;
+    dma_start(burstData, (burstEnd - burstNext) / sizeof(uint32_t));
+  } else {
+    MSC_WRITE(IEN, MSC_IEN_ERASE | MSC_IEN_WRITE);
+    burst_feed();
+  }
+  return flashProgOk;
+}
+
+/***************************************************************************//**
+ * Take a job off the queue and report it.
+ ******************************************************************************/
+static void job_finish(flash_prog_job_t *job, flash_prog_status_t status)
+{
+  queueHead = job->next;
+  if (queueHead == NULL) {
+    queueTail = NULL;
+    // Nothing left to write
+    MSC_WRITE(WRITECTRL, MSC_READ(WRITECTRL)
+              & ~(MSC_WRITECTRL_WREN | MSC_WRITECTRL_WDOUBLE));
+  }
+  if (job->callback != NULL) {
+    job->callback(job, status);
+  }
+}
+
+/***************************************************************************//**
+ * Move the jobs on: feed the running burst, or start the next step once the
+ * MSC is idle. Runs with the MSC interrupt masked.
+ ******************************************************************************/
+static void advance(void)
+{
+  flash_prog_job_t *job;
+  flash_prog_status_t status;
+
+  while ((job = queueHead) != NULL) {
+    if ((burstJob != NULL) && !dmaRunning) {
+      burst_feed();
+    }
+    if (dmaRunning || (MSC_READ(STATUS) & MSC_STATUS_BUSY)) {
+      return;
+    }
+
+    // Idle: the burst is over, at its end or because WDATA was given too
+    // late. Then the words still in WDATA are not written: data phases take
+    // one word, or an aligned pair of words, and WDATA is not ready when it
+    // holds a whole phase.
+    if (burstJob != NULL) {
+      uint32_t buffered = 0;
+
+      if (!(MSC_READ(STATUS) & MSC_STATUS_WDATAREADY)) {
+        buffered = burstDouble ? 2 : 1;
+      } else if (burstDouble && (burstNext & 4)) {
+        buffered = 1;
+      }
+      if (buffered != 0) {
+        MSC_WRITE(WRITECMD, MSC_WRITECMD_CLEARWDATA);
+      }
+      burstJob->written = (burstNext - burstJob->address) / sizeof(uint32_t)
+                          - buffered;
+      burstJob = NULL;
+    }
+
+    if (job->erase && (job->erased < erase_size(job))) {
+      status = address_load(job->address + job->erased);
+      if (status == flashProgOk) {
+        MSC_WRITE(WRITECMD, MSC_WRITECMD_ERASEPAGE);
+        job->erased += FLASH_PAGE_SIZE;
+        return;
+      }
+    } else if ((job->data != NULL) && (job->written < job->words)) {
+      status = burst_start(job);
+      if (status == flashProgOk) {
+        return;
+      }
+    } else {
+      status = flashProgOk;
+    }
+    job_finish(job, status);
+  }
+}
+
+/***************************************************************************//**
+ * The DMA gave WDATA all the words of the burst.
+ ******************************************************************************/
+static void dma_done(void)
+{
+  burstData += (burstEnd - burstNext) / sizeof(uint32_t);
+  burstNext = burstEnd;
+  dmaRunning = false;
+
+  // The interrupt of the last write, or the one already pending, goes on
+  MSC_WRITE(IEN, MSC_IEN_ERASE | MSC_IEN_WRITE);
+}
+
+/***************************************************************************//**
+ * Initialize the engine.
+ ******************************************************************************/
+void flash_prog_init(const flash_prog_config_t *config)
+{
+  progConfig = *config;
+  queueHead = NULL;
+  queueTail = NULL;
+  burstJob = NULL;
+  dmaRunning = false;
+
+  if (progConfig.useDma) {
+    dma_init();
+  }
+
+  MSC_WRITE(IFC, MSC_IFC_ERASE | MSC_IFC_WRITE);
+  MSC_WRITE(IEN, MSC_IEN_ERASE | MSC_IEN_WRITE);
+  NVIC_ClearPendingIRQ(MSC_IRQn);
+  NVIC_EnableIRQ(MSC_IRQn);
+}
+
+/***************************************************************************//**
+ * Queue a job.
+ ******************************************************************************/
+flash_prog_status_t flash_prog_submit(flash_prog_job_t *job)
+{
+  uint32_t size = job->words * sizeof(uint32_t);
+  CORE_DECLARE_IRQ_STATE;
+
+  if ((job->words == 0) || (job->words > (FLASH_SIZE / sizeof(uint32_t)))
+      || (job->address & 3)
+      || ((job->address - FLASH_BASE) > (FLASH_SIZE - size))
+      || (job->erase && (job->address & (FLASH_PAGE_SIZE - 1)))
+      || (!job->erase && (job->data == NULL))) {
+    return flashProgInvalidAddress;
+  }
+
+  job->next = NULL;
+  job->erased = 0;
+  job->written = 0;
+
+  CORE_ENTER_ATOMIC();
+  if (queueTail != NULL) {
+    queueTail->next = job;
+    queueTail = job;
+  } else {
+    queueHead = job;
+    queueTail = job;
+    // Reads go on from the other bank while the MSC writes
+    MSC_WRITE(WRITECTRL, MSC_READ(WRITECTRL)
+              | MSC_WRITECTRL_WREN | MSC_WRITECTRL_RWWEN);
+    advance();
+  }
+  CORE_EXIT_ATOMIC();
+  return flashProgOk;
+}
+
+/***************************************************************************//**
+ * True when all the queued jobs are done.
+ ******************************************************************************/
+bool flash_prog_idle(void)
+{
+  return queueHead == NULL;
+}
+
+/***************************************************************************//**
+ * MSC interrupt handler of the engine.
+ ******************************************************************************/
+void flash_prog_irq_handler(void)
+{
+  uint32_t flags = MSC_READ(IF);
+
+  MSC_WRITE(IFC, flags);
+  advance();
+}
@@ -0,0 +1,491 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host model of the Series 0 Giant Gecko MSC flash programming
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ *******************************************************************************
+ *
+ * Rules checked, each break counts as a violation:
+ *  - commands, address loads and WDOUBLE or WREN changes only while idle,
+ *  - erases and writes only with WREN, to a valid and unlocked address,
+ *  - WDATA only written while WDATAREADY,
+ *  - a write starts with a whole data phase in WDATA: one word, or a pair at
+ *    a double word aligned address with WDOUBLE,
+ *  - the address of a burst does not increment into the next page,
+ *  - a word is not written more than twice between erases,
+ *  - WRITEEND does not drop words waiting in WDATA.
+ *
+ * Words are written by clearing bits, so data written over non-erased flash
+ * shows up as wrong contents.
+ *
+ * While the MSC erases or writes a bank, code fetches from that bank wait,
+ * and from the other bank too without RWWEN. Interrupts are taken between
+ * register accesses.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "flash_model.h"
+
+#define NEVER             UINT64_MAX
+#define VIOLATIONS_SHOWN  10
+
+typedef enum {
+  opIdle,
+  opErase,
+  opWrite,
+  opWait,             // Burst waiting for the next data phase
+} model_op_t;
+
+static flash_model_config_t modelConfig;
+static flash_model_stats_t stats;
+static void (*mscIrqHandler)(void);
+
+static uint32_t memory[FLASH_SIZE / sizeof(uint32_t)];
+static uint8_t writeCounts[FLASH_SIZE / sizeof(uint32_t)];
+
+// Registers
+static uint32_t writeCtrl;
+static uint32_t addrB;
+static uint32_t address;
+static uint32_t flags;
+static uint32_t ien;
+static bool invalidAddress;
+static bool locked;
+static bool wordTimeout;
+static uint32_t wdata[2];
+static uint32_t wdataCount;
+
+// Operation in progress
+static model_op_t op;
+static uint64_t opEnd;
+static uint32_t opBank;
+static bool burst;
+static bool burstFirst;
+static bool burstEnding;
+static uint32_t phase[2];
+static uint32_t phaseWords;
+
+// DMA
+static const uint32_t *dmaData;
+static uint32_t dmaLeft;
+static uint64_t dmaNext;
+static bool dmaIrq;
+static void (*dmaDoneHandler)(void);
+
+// Interrupts
+static int irqMasked;
+static bool inHandler;
+static bool stalled;
+
+static void advance_to(uint64_t time);
+
+static void violation(const char *what)
+{
+  if (stats.violations++ < VIOLATIONS_SHOWN) {
+    printf("  violation at %.3f ms, address 0x%05lx: %s\n",
+           stats.timeNs / 1e6, (unsigned long)address, what);
+  }
+}
+
+static uint32_t phase_size(void)
+{
+  return (writeCtrl & MSC_WRITECTRL_WDOUBLE) ? 2 : 1;
+}
+
+static bool busy(void)
+{
+  return op != opIdle;
+}
+
+/***************************************************************************//**
+ * Let the DMA move a word once WDATA has room.
+ ******************************************************************************/
+static void dma_request(void)
+{
+  if ((dmaLeft != 0) && (dmaNext == NEVER) && (wdataCount < phase_size())) {
+    dmaNext = stats.timeNs + modelConfig.dmaNs;
+  }
+}
+
+/***************************************************************************//**
+ * Program the data phase in WDATA at the current address.
+ ******************************************************************************/
+static void phase_start(void)
+{
+  if ((phase_size() == 2) && (address & 7)) {
+    violation("double word write to an unaligned address");
+  }
+  if (burst && !burstFirst && ((address % FLASH_PAGE_SIZE) == 0)) {
+    violation("burst address incremented into the next page");
+  }
+  burstFirst = false;
+
+  memcpy(phase, wdata, sizeof(phase));
+  phaseWords = wdataCount;
+  wdataCount = 0;
+
+  op = opWrite;
+  opEnd = stats.timeNs
+          + ((phaseWords == 2) ? modelConfig.doubleNs : modelConfig.wordNs);
+  opBank = address / FLASH_BANK_SIZE;
+  dma_request();
+}
+
+static void phase_end(void)
+{
+  for (uint32_t i = 0; i < phaseWords; i++) {
+    uint32_t index = (address % FLASH_SIZE) / sizeof(uint32_t);
+
+    if (writeCounts[index] >= 2) {
+      violation("word written more than twice since its erase");
+    }
+    writeCounts[index]++;
+    memory[index] &= phase[i];
+    address += sizeof(uint32_t);
+  }
+  stats.phases++;
+  flags |= MSC_IF_WRITE;
+
+  if (burst && !burstEnding) {
+    if (wdataCount == phase_size()) {
+      phase_start();
+    } else {
+      op = opWait;
+      opEnd = stats.timeNs + modelConfig.wordTimeoutNs;
+    }
+  } else {
+    op = opIdle;
+    burst = false;
+  }
+}
+
+static void wdata_write(uint32_t value)
+{
+  if (wdataCount >= phase_size()) {
+    violation("WDATA written while not ready");
+    return;
+  }
+  wdata[wdataCount++] = value;
+  if ((op == opWait) && (wdataCount == phase_size())) {
+    phase_start();
+  }
+}
+
+/***************************************************************************//**
+ * Run an event: the end of an operation or a DMA transfer.
+ ******************************************************************************/
+static void event_run(void)
+{
+  if ((op != opIdle) && (opEnd <= dmaNext)) {
+    stats.timeNs = opEnd;
+    if (op == opErase) {
+      uint32_t first = (address % FLASH_SIZE) / sizeof(uint32_t)
+                       & ~(FLASH_PAGE_SIZE / sizeof(uint32_t) - 1);
+
+      memset(&memory[first], 0xff, FLASH_PAGE_SIZE);
+      memset(&writeCounts[first], 0, FLASH_PAGE_SIZE / sizeof(uint32_t));
+      flags |= MSC_IF_ERASE;
+      op = opIdle;
+    } else if (op == opWrite) {
+      phase_end();
+    } else {
+      op = opIdle;
+      burst = false;
+      wordTimeout = true;
+      stats.timeouts++;
+    }
+  } else {
+    stats.timeNs = dmaNext;
+    dmaNext = NEVER;
+    wdata_write(*dmaData++);
+    if (--dmaLeft == 0) {
+      dmaIrq = true;
+    }
+  }
+  dma_request();
+}
+
+static uint64_t event_next(void)
+{
+  uint64_t next = dmaNext;
+
+  if ((op != opIdle) && (opEnd < next)) {
+    next = opEnd;
+  }
+  return next;
+}
+
+/***************************************************************************//**
+ * Take the pending interrupts, if not masked.
+ ******************************************************************************/
+static void irq_take(void)
+{
+  uint64_t start;
+
+  while (!inHandler && (irqMasked == 0)) {
+    void (*handler)(void);
+
+    if (dmaIrq) {
+      dmaIrq = false;
+      handler = dmaDoneHandler;
+    } else if (flags & ien) {
+      handler = mscIrqHandler;
+    } else {
+      return;
+    }
+    inHandler = true;
+    start = stats.timeNs;
+    advance_to(stats.timeNs + modelConfig.irqEntryNs);
+    handler();
+    inHandler = false;
+    stats.irqs++;
+    stats.irqNs += stats.timeNs - start;
+  }
+}
+
+static void advance_to(uint64_t time)
+{
+  while (event_next() <= time) {
+    event_run();
+    irq_take();
+  }
+  if (stats.timeNs < time) {
+    stats.timeNs = time;
+  }
+}
+
+/***************************************************************************//**
+ * CPU time from the code bank, waiting while the flash cannot be read.
+ ******************************************************************************/
+static void cpu_run(uint32_t ns)
+{
+  uint64_t start = stats.timeNs;
+  bool outer = !stalled;
+
+  // Handlers taken meanwhile stall too, count the time once
+  stalled = true;
+  while (((op == opErase) || (op == opWrite))
+         && (!(writeCtrl & MSC_WRITECTRL_RWWEN)
+             || (opBank == modelConfig.codeBank))) {
+    advance_to(opEnd);
+  }
+  if (outer) {
+    stalled = false;
+    stats.stallNs += stats.timeNs - start;
+  }
+  advance_to(stats.timeNs + ns);
+  irq_take();
+}
+
+static void command(uint32_t value)
+{
+  if (value & MSC_WRITECMD_CLEARWDATA) {
+    wdataCount = 0;
+  }
+
+  if (value & MSC_WRITECMD_WRITEEND) {
+    if (wdataCount != 0) {
+      violation("WRITEEND with words waiting in WDATA");
+    }
+    if (op == opWait) {
+      op = opIdle;
+      burst = false;
+    } else if (op == opWrite) {
+      burstEnding = true;
+    }
+  }
+
+  if (value & (MSC_WRITECMD_LADDRIM | MSC_WRITECMD_ERASEPAGE
+               | MSC_WRITECMD_WRITEONCE | MSC_WRITECMD_WRITETRIG)) {
+    if (busy()) {
+      violation("command while busy");
+      return;
+    }
+  }
+
+  if (value & MSC_WRITECMD_LADDRIM) {
+    address = addrB;
+    invalidAddress = (address >= FLASH_BASE + FLASH_SIZE) || (address & 3);
+    locked = (address & ~(FLASH_PAGE_SIZE - 1)) == modelConfig.lockedPage;
+  }
+
+  if (value & (MSC_WRITECMD_ERASEPAGE | MSC_WRITECMD_WRITEONCE
+               | MSC_WRITECMD_WRITETRIG)) {
+    if (!(writeCtrl & MSC_WRITECTRL_WREN)) {
+      violation("erase or write without WREN");
+      return;
+    }
+    if (invalidAddress || locked) {
+      violation("erase or write to an invalid or locked address");
+      return;
+    }
+  }
+
+  if (value & MSC_WRITECMD_ERASEPAGE) {
+    op = opErase;
+    opEnd = stats.timeNs + modelConfig.eraseNs;
+    opBank = address / FLASH_BANK_SIZE;
+    stats.erases++;
+  } else if (value & (MSC_WRITECMD_WRITEONCE | MSC_WRITECMD_WRITETRIG)) {
+    if (wdataCount != phase_size()) {
+      violation("write started without a whole data phase in WDATA");
+      return;
+    }
+    burst = (value & MSC_WRITECMD_WRITETRIG) != 0;
+    burstFirst = true;
+    burstEnding = false;
+    wordTimeout = false;
+    stats.bursts++;
+    phase_start();
+  }
+}
+
+/***************************************************************************//**
+ * Register accesses.
+ ******************************************************************************/
+uint32_t flash_model_read(flash_model_reg_t reg)
+{
+  uint32_t value = 0;
+
+  cpu_run(modelConfig.accessNs);
+
+  switch (reg) {
+    case FLASH_MODEL_WRITECTRL:
+      value = writeCtrl;
+      break;
+    case FLASH_MODEL_ADDRB:
+      value = addrB;
+      break;
+    case FLASH_MODEL_STATUS:
+      value = (busy() ? MSC_STATUS_BUSY : 0)
+              | (locked ? MSC_STATUS_LOCKED : 0)
+              | (invalidAddress ? MSC_STATUS_INVADDR : 0)
+              | ((wdataCount < phase_size()) ? MSC_STATUS_WDATAREADY : 0)
+              | (wordTimeout ? MSC_STATUS_WORDTIMEOUT : 0);
+      break;
+    case FLASH_MODEL_IF:
+      value = flags;
+      break;
+    case FLASH_MODEL_IEN:
+      value = ien;
+      break;
+    default:
+      break;
+  }
+  return value;
+}
+
+void flash_model_write(flash_model_reg_t reg, uint32_t value)
+{
+  cpu_run(modelConfig.accessNs);
+
+  switch (reg) {
+    case FLASH_MODEL_WRITECTRL:
+      if (busy() && ((value ^ writeCtrl)
+                     & (MSC_WRITECTRL_WDOUBLE | MSC_WRITECTRL_WREN))) {
+        violation("WDOUBLE or WREN changed while busy");
+      }
+      if (wdataCount && ((value ^ writeCtrl) & MSC_WRITECTRL_WDOUBLE)) {
+        violation("WDOUBLE changed with words in WDATA");
+      }
+      writeCtrl = value;
+      break;
+    case FLASH_MODEL_WRITECMD:
+      command(value);
+      break;
+    case FLASH_MODEL_ADDRB:
+      addrB = value;
+      break;
+    case FLASH_MODEL_WDATA:
+      wdata_write(value);
+      break;
+    case FLASH_MODEL_IFC:
+      flags &= ~value;
+      break;
+    case FLASH_MODEL_IEN:
+      ien = value;
+      break;
+    default:
+      break;
+  }
+  dma_request();
+  irq_take();
+}
+
+int flash_model_irq_mask(void)
+{
+  return irqMasked++;
+}
+
+void flash_model_irq_restore(int state)
+{
+  irqMasked = state;
+  irq_take();
+}
+
+void flash_model_dma_start(const uint32_t *data, uint32_t words,
+                           void (*done)(void))
+{
+  dmaData = data;
+  dmaLeft = words;
+  dmaNext = NEVER;
+  dmaDoneHandler = done;
+  dma_request();
+}
+
+void flash_model_run(uint32_t ns)
+{
+  cpu_run(ns);
+}
+
+const uint32_t *flash_model_memory(uint32_t address)
+{
+  return &memory[(address % FLASH_SIZE) / sizeof(uint32_t)];
+}
+
+const flash_model_stats_t *flash_model_stats(void)
+{
+  return &stats;
+}
+
+void flash_model_init(const flash_model_config_t *config,
+                      void (*msc_irq)(void))
+{
+  modelConfig = *config;
+  mscIrqHandler = msc_irq;
+  memset(&stats, 0, sizeof(stats));
+
+  // Flash starts written over, so that missing erases show
+  memset(memory, 0x5a, sizeof(memory));
+  memset(writeCounts, 2, sizeof(writeCounts));
+
+  writeCtrl = 0;
+  addrB = 0;
+  address = 0;
+  flags = 0;
+  ien = 0;
+  invalidAddress = false;
+  locked = false;
+  wordTimeout = false;
+  wdataCount = 0;
+  op = opIdle;
+  burst = false;
+  dmaLeft = 0;
+  dmaNext = NEVER;
+  dmaIrq = false;
+  irqMasked = 0;
+  inHandler = false;
+  stalled = false;
+}
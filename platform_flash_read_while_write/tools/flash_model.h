@@ -0,0 +1,145 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host model of the Series 0 Giant Gecko MSC flash programming
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef FLASH_MODEL_H
+#define FLASH_MODEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Stands in for the device headers when ../src/flash_prog.c is built with
+ * FLASH_PROG_HOST_MODEL. Register accesses go to the model, which keeps the
+ * time, runs the erases and writes, raises the MSC interrupt and counts the
+ * accesses that break the MSC rules.
+ */
+
+// Flash of the EFM32GG990F1024: two banks of 512 KB
+#define FLASH_BASE                  0x00000000UL
+#define FLASH_SIZE                  0x00100000UL
+#define FLASH_PAGE_SIZE             4096
+#define FLASH_BANK_SIZE             (FLASH_SIZE / 2)
+
+#define MSC_WRITECTRL_WREN          (0x1UL << 0)
+#define MSC_WRITECTRL_IRQERASEABORT (0x1UL << 1)
+#define MSC_WRITECTRL_WDOUBLE       (0x1UL << 2)
+#define MSC_WRITECTRL_LPWRITE       (0x1UL << 3)
+#define MSC_WRITECTRL_RWWEN         (0x1UL << 7)
+
+#define MSC_WRITECMD_LADDRIM        (0x1UL << 0)
+#define MSC_WRITECMD_ERASEPAGE      (0x1UL << 1)
+#define MSC_WRITECMD_WRITEEND       (0x1UL << 2)
+#define MSC_WRITECMD_WRITEONCE      (0x1UL << 3)
+#define MSC_WRITECMD_WRITETRIG      (0x1UL << 4)
+#define MSC_WRITECMD_ERASEABORT     (0x1UL << 5)
+#define MSC_WRITECMD_CLEARWDATA     (0x1UL << 12)
+
+#define MSC_STATUS_BUSY             (0x1UL << 0)
+#define MSC_STATUS_LOCKED           (0x1UL << 1)
+#define MSC_STATUS_INVADDR          (0x1UL << 2)
+#define MSC_STATUS_WDATAREADY       (0x1UL << 3)
+#define MSC_STATUS_WORDTIMEOUT      (0x1UL << 4)
+
+#define MSC_IF_ERASE                (0x1UL << 0)
+#define MSC_IF_WRITE                (0x1UL << 1)
+#define MSC_IFC_ERASE               MSC_IF_ERASE
+#define MSC_IFC_WRITE               MSC_IF_WRITE
+#define MSC_IEN_ERASE               MSC_IF_ERASE
+#define MSC_IEN_WRITE               MSC_IF_WRITE
+
+typedef enum {
+  FLASH_MODEL_WRITECTRL,
+  FLASH_MODEL_WRITECMD,
+  FLASH_MODEL_ADDRB,
+  FLASH_MODEL_WDATA,
+  FLASH_MODEL_STATUS,
+  FLASH_MODEL_IF,
+  FLASH_MODEL_IFC,
+  FLASH_MODEL_IEN,
+} flash_model_reg_t;
+
+#define MSC_READ(reg)           flash_model_read(FLASH_MODEL_##reg)
+#define MSC_WRITE(reg, value)   flash_model_write(FLASH_MODEL_##reg, (value))
+
+#define MSC_IRQn                0
+#define NVIC_ClearPendingIRQ(irq) ((void)(irq))
+#define NVIC_EnableIRQ(irq)       ((void)(irq))
+
+#define CORE_DECLARE_IRQ_STATE  int irqState_ = 0
+#define CORE_ENTER_ATOMIC()     (irqState_ = flash_model_irq_mask())
+#define CORE_EXIT_ATOMIC()      flash_model_irq_restore(irqState_)
+
+/***************************************************************************//**
+ * Model timing and setup, in nanoseconds.
+ ******************************************************************************/
+typedef struct {
+  uint32_t wordNs;            // Programming one word
+  uint32_t doubleNs;          // Programming a pair of words with WDOUBLE
+  uint32_t eraseNs;           // Erasing a page
+  uint32_t wordTimeoutNs;     // Wait for the next word of a burst
+  uint32_t accessNs;          // CPU time of one register access
+  uint32_t irqEntryNs;        // Interrupt latency, entry and exit
+  uint32_t dmaNs;             // DMA transfer after a request
+  uint32_t codeBank;          // Bank the code runs from
+  uint32_t lockedPage;        // Address of a locked page, or UINT32_MAX
+} flash_model_config_t;
+
+/***************************************************************************//**
+ * Counters of the model.
+ ******************************************************************************/
+typedef struct {
+  uint64_t timeNs;            // Time now
+  uint64_t stallNs;           // Time the CPU waited for the flash
+  uint64_t irqNs;             // Time in interrupt handlers
+  uint32_t irqs;
+  uint32_t erases;
+  uint32_t phases;            // Data phases programmed
+  uint32_t bursts;            // Write sequences started
+  uint32_t timeouts;          // Bursts ended by the word timeout
+  uint32_t violations;        // Accesses breaking the MSC rules
+} flash_model_stats_t;
+
+void flash_model_init(const flash_model_config_t *config,
+                      void (*msc_irq)(void));
+
+uint32_t flash_model_read(flash_model_reg_t reg);
+void flash_model_write(flash_model_reg_t reg, uint32_t value);
+
+int flash_model_irq_mask(void);
+void flash_model_irq_restore(int state);
+
+/***************************************************************************//**
+ * Start the DMA moving words to WDATA, one per request; done() is called as
+ * an interrupt after the last one.
+ ******************************************************************************/
+void flash_model_dma_start(const uint32_t *data, uint32_t words,
+                           void (*done)(void));
+
+/***************************************************************************//**
+ * Run the application for some CPU time, from the code bank, with the
+ * interrupts coming in.
+ ******************************************************************************/
+void flash_model_run(uint32_t ns);
+
+/***************************************************************************//**
+ * Flash contents.
+ ******************************************************************************/
+const uint32_t *flash_model_memory(uint32_t address);
+
+const flash_model_stats_t *flash_model_stats(void);
+
+#endif // FLASH_MODEL_H
@@ -0,0 +1,362 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host simulation of the flash programming engine on the MSC model
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ *******************************************************************************
+ *
+ * Runs ../src/flash_prog.c against the MSC model of flash_model.c, next to
+ * the word by word flow the example used before, and checks the flash
+ * contents and the MSC rules.
+ *
+ * Build:
+ *   cc -O2 -DFLASH_PROG_HOST_MODEL -Iinc -Itools -o flash_prog_sim \
+ *      tools/flash_prog_sim.c tools/flash_model.c src/flash_prog.c
+ *
+ * Usage:
+ *   ./flash_prog_sim [pages] [word timeout in ns]
+ *
+ * Times are in nanoseconds. The defaults follow the EFM32GG datasheet:
+ * 20 us per word, 20 ms per page erase; a pair of words with WDOUBLE is taken
+ * to cost the same as one word.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "flash_model.h"
+#include "flash_prog.h"
+
+#define WRITE_ADDRESS_START     0x00080000UL
+#define PAGE_WORDS              (FLASH_PAGE_SIZE / sizeof(uint32_t))
+#define MAX_PAGES               64
+
+// Application time between looks at the engine, and the longest section the
+// application runs with the interrupts masked in the "masking" scenario
+#define APP_SLICE_NS            1000
+#define APP_MASK_NS             40000
+
+typedef enum {
+  modeWordByWord,               // The example before the engine
+  modeEngine,
+} sim_mode_t;
+
+typedef struct {
+  const char *name;
+  sim_mode_t mode;
+  bool writeDouble;
+  bool useDma;
+  bool masking;                 // Application masks interrupts at times
+  uint32_t irqEntryNs;
+  uint32_t codeBank;            // 1 writes the bank the code runs from
+} scenario_t;
+
+static const scenario_t scenarios[] = {
+  { "word by word",      modeWordByWord, false, false, false, 1000, 0 },
+  { "engine",            modeEngine,     false, false, false, 1000, 0 },
+  { "engine double",     modeEngine,     true,  false, false, 1000, 0 },
+  { "engine dma",        modeEngine,     false, true,  false, 1000, 0 },
+  { "engine double dma", modeEngine,     true,  true,  false, 1000, 0 },
+  { "slow interrupts",   modeEngine,     true,  false, false, 8000, 0 },
+  { "masking",           modeEngine,     true,  false, true,  1000, 0 },
+  { "same bank",         modeEngine,     true,  false, false, 1000, 1 },
+};
+
+static uint32_t pages = 16;
+static uint32_t wordTimeoutNs = 5000;
+
+static uint32_t pattern[MAX_PAGES * PAGE_WORDS];
+static uint32_t expected[FLASH_SIZE / sizeof(uint32_t)];
+static bool checked[FLASH_SIZE / sizeof(uint32_t)];
+
+static uint32_t jobsDone;
+static uint32_t jobErrors;
+static uint64_t appNs;
+static uint64_t bulkDoneNs;
+
+/***************************************************************************//**
+ * Expected contents.
+ ******************************************************************************/
+static void expect_erase(uint32_t address, uint32_t bytes)
+{
+  for (uint32_t i = 0; i < bytes / sizeof(uint32_t); i++) {
+    expected[address / sizeof(uint32_t) + i] = 0xffffffff;
+    checked[address / sizeof(uint32_t) + i] = true;
+  }
+}
+
+static void expect_write(uint32_t address, const uint32_t *data,
+                         uint32_t words)
+{
+  for (uint32_t i = 0; i < words; i++) {
+    expected[address / sizeof(uint32_t) + i] &= data[i];
+  }
+}
+
+static uint32_t contents_check(void)
+{
+  uint32_t errors = 0;
+
+  for (uint32_t i = 0; i < FLASH_SIZE / sizeof(uint32_t); i++) {
+    if (checked[i]
+        && (*flash_model_memory(i * sizeof(uint32_t)) != expected[i])) {
+      errors++;
+    }
+  }
+  return errors;
+}
+
+/***************************************************************************//**
+ * The example before the engine: erase page by page, then write word by word
+ * with WRITEONCE, polling the MSC in between.
+ ******************************************************************************/
+static void word_by_word_run(void)
+{
+  uint32_t end = WRITE_ADDRESS_START + pages * FLASH_PAGE_SIZE;
+
+  for (uint32_t address = WRITE_ADDRESS_START; address < end;
+       address += FLASH_PAGE_SIZE) {
+    MSC_WRITE(WRITECTRL, MSC_READ(WRITECTRL) | MSC_WRITECTRL_WREN);
+    MSC_WRITE(ADDRB, address);
+    MSC_WRITE(WRITECMD, MSC_WRITECMD_LADDRIM);
+    MSC_WRITE(WRITECMD, MSC_WRITECMD_ERASEPAGE);
+    while (MSC_READ(STATUS) & MSC_STATUS_BUSY) {
+    }
+  }
+
+  for (uint32_t address = WRITE_ADDRESS_START; address < end; address += 4) {
+    MSC_WRITE(WRITECTRL, MSC_READ(WRITECTRL)
+              | MSC_WRITECTRL_RWWEN | MSC_WRITECTRL_WREN);
+    MSC_WRITE(ADDRB, address);
+    MSC_WRITE(WRITECMD, MSC_WRITECMD_LADDRIM);
+    while (!(MSC_READ(STATUS) & MSC_STATUS_WDATAREADY)) {
+    }
+    MSC_WRITE(WDATA, pattern[(address - WRITE_ADDRESS_START) / 4]);
+    MSC_WRITE(WRITECMD, MSC_WRITECMD_WRITEONCE);
+    while (MSC_READ(STATUS) & MSC_STATUS_BUSY) {
+    }
+  }
+  MSC_WRITE(WRITECTRL, MSC_READ(WRITECTRL) & ~MSC_WRITECTRL_WREN);
+}
+
+/***************************************************************************//**
+ * Engine jobs: the pages in one job, then a range erased without data and
+ * written at odd word addresses across a page boundary, then a tail queued
+ * from a callback.
+ ******************************************************************************/
+static flash_prog_job_t bulkJob;
+static flash_prog_job_t eraseJob;
+static flash_prog_job_t oddJob;
+static flash_prog_job_t tailJob;
+static flash_prog_job_t lockedJob;
+
+static void job_done(flash_prog_job_t *job, flash_prog_status_t status)
+{
+  flash_prog_status_t expectedStatus = (flash_prog_status_t)(intptr_t)
+                                       job->context;
+
+  jobsDone++;
+  if (job == &bulkJob) {
+    bulkDoneNs = flash_model_stats()->timeNs;
+  }
+  if (status != expectedStatus) {
+    printf("  job at 0x%05lx: status %d, expected %d\n",
+           (unsigned long)job->address, status, expectedStatus);
+    jobErrors++;
+  }
+  if (job == &oddJob) {
+    // Fills the words left erased in front of the odd job
+    if (flash_prog_submit(&tailJob) != flashProgOk) {
+      jobErrors++;
+    }
+  }
+}
+
+static void job_set(flash_prog_job_t *job, uint32_t address,
+                    const uint32_t *data, uint32_t words, bool erase,
+                    flash_prog_status_t status)
+{
+  memset(job, 0, sizeof(*job));
+  job->address = address;
+  job->data = data;
+  job->words = words;
+  job->erase = erase;
+  job->callback = job_done;
+  job->context = (void *)(intptr_t)status;
+}
+
+static void engine_run(const scenario_t *scenario)
+{
+  flash_prog_config_t config = {
+    .writeDouble = scenario->writeDouble,
+    .useDma = scenario->useDma,
+    .dmaChannel = 0,
+  };
+  uint32_t bulkAddress = WRITE_ADDRESS_START;
+  uint32_t oddAddress = bulkAddress + pages * FLASH_PAGE_SIZE;
+  uint32_t oddWords = PAGE_WORDS + 7;
+  flash_prog_job_t invalidJob;
+  uint32_t submitted = 0;
+  // Twice the time of all the erases and single word writes
+  uint64_t timeLimitNs = 2ULL * (pages + 3)
+                         * (20000000 + PAGE_WORDS * 20000ULL);
+
+  flash_prog_init(&config);
+
+  job_set(&bulkJob, bulkAddress, pattern, pages * PAGE_WORDS, true,
+          flashProgOk);
+  job_set(&eraseJob, oddAddress, NULL, 2 * PAGE_WORDS, true, flashProgOk);
+  job_set(&oddJob, oddAddress + 12, pattern + 3, oddWords, false,
+          flashProgOk);
+  job_set(&tailJob, oddAddress, pattern + 11, 3, false, flashProgOk);
+  job_set(&lockedJob, oddAddress + 2 * FLASH_PAGE_SIZE, pattern, 16, true,
+          flashProgLocked);
+
+  expect_erase(bulkAddress, pages * FLASH_PAGE_SIZE);
+  expect_write(bulkAddress, pattern, pages * PAGE_WORDS);
+  expect_erase(oddAddress, 2 * FLASH_PAGE_SIZE);
+  expect_write(oddAddress + 12, pattern + 3, oddWords);
+  expect_write(oddAddress, pattern + 11, 3);
+
+  // Refused without being queued
+  job_set(&invalidJob, FLASH_SIZE - 8, pattern, 4, false, flashProgOk);
+  if (flash_prog_submit(&invalidJob) != flashProgInvalidAddress) {
+    jobErrors++;
+  }
+  invalidJob.address = bulkAddress + 4;
+  invalidJob.erase = true;
+  if (flash_prog_submit(&invalidJob) != flashProgInvalidAddress) {
+    jobErrors++;
+  }
+
+  submitted += flash_prog_submit(&bulkJob) == flashProgOk;
+  submitted += flash_prog_submit(&eraseJob) == flashProgOk;
+  submitted += flash_prog_submit(&oddJob) == flashProgOk;
+  submitted += flash_prog_submit(&lockedJob) == flashProgOk;
+  if (submitted != 4) {
+    jobErrors++;
+  }
+
+  while (!flash_prog_idle()) {
+    if (flash_model_stats()->timeNs > timeLimitNs) {
+      printf("  jobs not done after %.0f ms\n", timeLimitNs / 1e6);
+      jobErrors++;
+      break;
+    }
+    if (scenario->masking && ((rand() % 64) == 0)) {
+      int state = flash_model_irq_mask();
+      uint32_t ns = (uint32_t)rand() % APP_MASK_NS;
+
+      flash_model_run(ns);
+      appNs += ns;
+      flash_model_irq_restore(state);
+    }
+    flash_model_run(APP_SLICE_NS);
+    appNs += APP_SLICE_NS;
+  }
+
+  if (jobsDone != 5) {
+    printf("  %lu jobs done, expected 5\n", (unsigned long)jobsDone);
+    jobErrors++;
+  }
+}
+
+static void mscIrqHandler(void)
+{
+  flash_prog_irq_handler();
+}
+
+static uint32_t scenario_run(const scenario_t *scenario)
+{
+  flash_model_config_t config = {
+    .wordNs = 20000,
+    .doubleNs = 20000,
+    .eraseNs = 20000000,
+    .wordTimeoutNs = wordTimeoutNs,
+    .accessNs = 50,
+    .irqEntryNs = scenario->irqEntryNs,
+    .dmaNs = 100,
+    .codeBank = scenario->codeBank,
+    .lockedPage = WRITE_ADDRESS_START + (pages + 2) * FLASH_PAGE_SIZE,
+  };
+  const flash_model_stats_t *stats;
+  uint32_t errors;
+  double seconds;
+
+  flash_model_init(&config, mscIrqHandler);
+  memset(checked, 0, sizeof(checked));
+  jobsDone = 0;
+  jobErrors = 0;
+  appNs = 0;
+  bulkDoneNs = 0;
+
+  if (scenario->mode == modeWordByWord) {
+    expect_erase(WRITE_ADDRESS_START, pages * FLASH_PAGE_SIZE);
+    expect_write(WRITE_ADDRESS_START, pattern, pages * PAGE_WORDS);
+    word_by_word_run();
+    bulkDoneNs = flash_model_stats()->timeNs;
+  } else {
+    engine_run(scenario);
+  }
+
+  stats = flash_model_stats();
+  errors = contents_check();
+  seconds = bulkDoneNs / 1e9;
+
+  printf("%-18s %8.1f %7.1f %6.1f %6.1f %7lu %6lu %8lu %5lu %4lu\n",
+         scenario->name, seconds * 1e3,
+         pages * FLASH_PAGE_SIZE / seconds / 1024,
+         100.0 * appNs / stats->timeNs,
+         100.0 * stats->stallNs / stats->timeNs,
+         (unsigned long)stats->irqs, (unsigned long)stats->bursts,
+         (unsigned long)stats->timeouts, (unsigned long)stats->violations,
+         (unsigned long)(errors + jobErrors));
+  return stats->violations + errors + jobErrors;
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t failures = 0;
+
+  if (argc > 1) {
+    pages = (uint32_t)strtoul(argv[1], NULL, 0);
+  }
+  if (argc > 2) {
+    wordTimeoutNs = (uint32_t)strtoul(argv[2], NULL, 0);
+  }
+  if ((pages == 0) || (pages > MAX_PAGES)) {
+    fprintf(stderr, "pages: 1 to %d\n", MAX_PAGES);
+    return 2;
+  }
+
+  // Show the scenarios as they are done
+  setvbuf(stdout, NULL, _IOLBF, 0);
+
+  srand(1);
+  for (uint32_t i = 0; i < pages * PAGE_WORDS; i++) {
+    pattern[i] = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+  }
+
+  printf("%lu pages, word timeout %lu ns\n\n", (unsigned long)pages,
+         (unsigned long)wordTimeoutNs);
+  printf("%-18s %8s %7s %6s %6s %7s %6s %8s %5s %4s\n", "scenario", "ms",
+         "KB/s", "app%", "stall%", "irqs", "bursts", "timeouts", "rules",
+         "bad");
+  for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+    failures += scenario_run(&scenarios[i]);
+  }
+
+  printf("\n%s\n", failures ? "FAIL" : "PASS");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,110 @@
+/***************************************************************************//**
+ * @file
+ * @brief LDMA driven GPCRC check of a list of flash regions
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef CRC_CHECK_H
+#define CRC_CHECK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// LDMA channel feeding the GPCRC
+#ifndef CRC_CHECK_LDMA_CHANNEL
+#define CRC_CHECK_LDMA_CHANNEL    1
+#endif
+
+// Descriptors and CRC results of one batch. A batch covers up to
+// CRC_CHECK_MAX_RESULTS pages and runs without the CPU; the CPU only checks
+// the results and starts the next batch.
+#ifndef CRC_CHECK_MAX_DESCRIPTORS
+#define CRC_CHECK_MAX_DESCRIPTORS 48
+#endif
+#ifndef CRC_CHECK_MAX_RESULTS
+#define CRC_CHECK_MAX_RESULTS     16
+#endif
+
+#define CRC_CHECK_NO_FAILURE      0xFFFFFFFFUL
+
+/***************************************************************************//**
+ * Check applied to a region.
+ ******************************************************************************/
+typedef enum {
+  crcCheckBlank,        // Every page is erased, length a multiple of pages
+  crcCheckExpected,     // The IEEE 802.3 CRC of the region is expected
+  crcCheckCompare,      // Every page has the same CRC as in the reference
+} crc_check_type_t;
+
+/***************************************************************************//**
+ * Region to check. Address and length are multiples of 4 bytes.
+ ******************************************************************************/
+typedef struct {
+  crc_check_type_t type;
+  uint32_t address;
+  uint32_t length;      // Bytes
+  uint32_t expected;    // crcCheckExpected: CRC of the region
+  uint32_t reference;   // crcCheckCompare: address of the reference copy
+} crc_check_region_t;
+
+/***************************************************************************//**
+ * Result of a region.
+ ******************************************************************************/
+typedef struct {
+  bool passed;
+  uint32_t failure;     // Address of the first failing page, or of the
+                        // region for crcCheckExpected, or CRC_CHECK_NO_FAILURE
+  uint32_t crc;         // crcCheckExpected: CRC computed
+} crc_check_result_t;
+
+/***************************************************************************//**
+ * Completion callback, called from the LDMA interrupt.
+ *
+ * @param[in] failed Number of regions that did not pass.
+ * @param[in] user Passed to crc_check_start().
+ ******************************************************************************/
+typedef void (*crc_check_callback_t)(uint32_t failed, void *user);
+
+/***************************************************************************//**
+ * Set up the service. The LDMA must be initialized and the GPCRC set up for
+ * the IEEE 802.3 polynomial with an initial value of 0xFFFFFFFF.
+ ******************************************************************************/
+void crc_check_init(void);
+
+/***************************************************************************//**
+ * Start checking a list of regions.
+ *
+ * The regions are checked in order, page after page, by the LDMA feeding the
+ * GPCRC. The GPCRC must not be used otherwise until the callback is called.
+ *
+ * @param[in] regions Region list, must stay valid until completion.
+ * @param[out] results One result per region, written until completion.
+ * @param[in] count Number of regions.
+ * @param[in] callback Called when all regions are checked, may be NULL.
+ * @param[in] user Passed to the callback.
+ *
+ * @return False if a check is in progress or a region is not aligned.
+ ******************************************************************************/
+bool crc_check_start(const crc_check_region_t *regions,
+                     crc_check_result_t *results,
+                     uint32_t count,
+                     crc_check_callback_t callback,
+                     void *user);
+
+/***************************************************************************//**
+ * Check whether a list of regions is being checked.
+ ******************************************************************************/
+bool crc_check_busy(void);
+
+#endif // CRC_CHECK_H
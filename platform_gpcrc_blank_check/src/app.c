@@ -27,6 +27,7 @@
 #include "em_emu.h"
 #include "em_chip.h"
 #include "app_log.h"
+#include "crc_check.h"
 
 #ifdef _SILICON_LABS_32B_SERIES_1
 // IEEE 802.3 CRC of blank 2 KB flash page
@@ -41,6 +42,9 @@
 // LDMA GPCRC channel assignment
 #define LDMA_GPCRC_CHAN     0
 
+// Pages in each region of the multi-region check benchmark
+#define CRC_CHECK_PAGES     8
+
 // LDMA GPCRC descriptor and transfer configuration structures
 static LDMA_Descriptor_t ldmaCrcDesc[2];
 static LDMA_TransferCfg_t ldmaCrcXferCfg;
@@ -258,6 +262,116 @@ uint32_t crcManualBlankCheckPage(uint32_t baseAddr)
   return result;
 }
 
+/*
+ * The CPU feeds a flash region to the GPCRC, giving the IEEE 802.3 CRC
+ * that the multi-region check is expected to find.
+ */
+uint32_t crcManualRegion(uint32_t baseAddr, uint32_t length)
+{
+  uint32_t i;
+
+  GPCRC_Start(GPCRC);
+  for (i = 0; i < length; i += 4) {
+    GPCRC_InputU32(GPCRC, (*(uint32_t *)(baseAddr + i)));
+  }
+
+  return ~GPCRC_DataRead(GPCRC);
+}
+
+static volatile bool crcCheckDone;
+static uint32_t crcCheckFailed;
+
+void crcCheckCallback(uint32_t failed, void *user)
+{
+  (void)user;
+
+  crcCheckFailed = failed;
+  crcCheckDone = true;
+}
+
+/*
+ * Check three regions back to back with the LDMA and GPCRC:
+ *
+ * - the last pages of flash are blank checked, as done after an erase
+ * - the first pages of flash have the CRC the CPU computed for them
+ * - the first pages of flash are compared page by page with a copy,
+ *   as done when validating a firmware slot (here the copy is the
+ *   region itself)
+ *
+ * The CPU is only involved between batches of up to
+ * CRC_CHECK_MAX_RESULTS pages.
+ */
+void crcCheckBenchmark(float tickLength)
+{
+  static crc_check_region_t regions[3];
+  static crc_check_result_t results[3];
+  static const char *names[3] = { "blank", "expected CRC", "compare" };
+  uint32_t length = CRC_CHECK_PAGES * FLASH_PAGE_SIZE;
+  // Pages read through the GPCRC, twice for a compared page
+  uint32_t pages = 4 * CRC_CHECK_PAGES;
+  uint32_t timerCount;
+  uint32_t microseconds;
+  uint32_t i;
+
+  regions[0].type = crcCheckBlank;
+  regions[0].address = FLASH_BASE + FLASH_SIZE - length;
+  regions[0].length = length;
+  regions[1].type = crcCheckExpected;
+  regions[1].address = FLASH_BASE;
+  regions[1].length = length;
+  regions[1].expected = crcManualRegion(FLASH_BASE, length);
+  regions[2].type = crcCheckCompare;
+  regions[2].address = FLASH_BASE;
+  regions[2].length = length;
+  regions[2].reference = FLASH_BASE;
+
+  crcCheckDone = false;
+
+  // Reset TIMER0 counter
+  TIMER_CounterSet(TIMER0, _TIMER_CNT_RESETVALUE);
+
+  // Start counting
+  TIMER0->CMD = TIMER_CMD_START;
+
+  if (crc_check_start(regions, results, 3, crcCheckCallback, NULL) == false) {
+    __BKPT(0);
+  }
+
+  // Wait while the regions are checked
+  while (crcCheckDone == false) {
+    // Nothing
+  }
+
+  // Stop counting
+  TIMER0->CMD = TIMER_CMD_STOP;
+
+  // Get TIMER0 timerCount;
+  timerCount = TIMER_CounterGet(TIMER0);
+  microseconds = (uint32_t)((tickLength * (float)timerCount) / 1000);
+  if (microseconds == 0) {
+    microseconds = 1;
+  }
+
+  app_log("\n[LDMA/GPCRC] %u regions, %u pages checked at %u MHz ",
+          3, (unsigned int)pages,
+          (unsigned int)(CMU_ClockFreqGet(cmuClock_GPCRC) / 1000000));
+  app_log("took %u microseconds, %u.%02u pages/ms.\n",
+          (unsigned int)microseconds,
+          (unsigned int)((pages * 1000) / microseconds),
+          (unsigned int)(((pages * 100000) / microseconds) % 100));
+
+  for (i = 0; i < 3; i++) {
+    app_log("%-12s %#010X, %u pages: ", names[i],
+            (unsigned int)regions[i].address, CRC_CHECK_PAGES);
+    if (results[i].passed) {
+      app_log("passed.\n");
+    } else {
+      app_log("failed at %#010X.\n", (unsigned int)results[i].failure);
+    }
+  }
+  app_log("%u regions failed.\n", (unsigned int)crcCheckFailed);
+}
+
 void app_init(void)
 {
   uint32_t timerCount;
@@ -380,6 +494,10 @@ void app_init(void)
 
   // Print blank state
   app_log("%s", pageBlank ? "blank.\n" : "not blank.\n");
+
+  // Blank check, CRC check and compare of several regions back to back
+  crc_check_init();
+  crcCheckBenchmark(tickLength);
   __BKPT(2);
 }
 
@@ -0,0 +1,373 @@
+/***************************************************************************//**
+ * @file
+ * @brief LDMA driven GPCRC check of a list of flash regions
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <stddef.h>
+#include "em_device.h"
+#include "em_gpcrc.h"
+#include "em_ldma.h"
+
+#include "crc_check.h"
+
+// Largest transfer count of one descriptor, in words
+#define XFER_MAX    ((_LDMA_CH_CTRL_XFERCNT_MASK >> _LDMA_CH_CTRL_XFERCNT_SHIFT) + 1)
+
+#define PAGE_WORDS  (FLASH_PAGE_SIZE >> 2)
+
+#if (PAGE_WORDS > XFER_MAX)
+#error "A flash page does not fit in one LDMA descriptor"
+#endif
+
+#if (CRC_CHECK_MAX_DESCRIPTORS < 3) || (CRC_CHECK_MAX_RESULTS < 1)
+#error "A batch must hold at least one page"
+#endif
+
+// What a stored CRC is checked against
+typedef enum {
+  resultBlank,          // Blank page CRC
+  resultExpected,       // CRC expected for the region
+  resultPage,           // Kept for the reference page that follows
+  resultReference,      // CRC of the page before
+} result_kind_t;
+
+typedef struct {
+  uint32_t region;
+  uint32_t address;     // Page reported on a failure
+  result_kind_t kind;
+} result_info_t;
+
+/*
+ * Descriptor list of a batch. Every page, or XFER_MAX words of a
+ * crcCheckExpected region, takes:
+ *
+ *   GPCRC init (WRI, first chunk only) -> words into GPCRC_INPUTDATA (M2M)
+ *   -> GPCRC_DATA into crcResults[] (M2M, last chunk only)
+ *
+ * Only the last descriptor of the list raises an interrupt.
+ */
+static LDMA_Descriptor_t crcDesc[CRC_CHECK_MAX_DESCRIPTORS];
+static LDMA_TransferCfg_t crcXferCfg;
+
+// CRCs stored by the LDMA during a batch and what they are checked against
+static uint32_t crcResults[CRC_CHECK_MAX_RESULTS];
+static result_info_t resultInfo[CRC_CHECK_MAX_RESULTS];
+static uint32_t resultCount;
+
+// GPCRC_DATA after a blank page
+static uint32_t blankCrc;
+
+// Region list being checked, and where the next batch starts
+static const crc_check_region_t *checkRegions;
+static crc_check_result_t *checkResults;
+static uint32_t checkCount;
+static uint32_t regionIndex;
+static uint32_t regionOffset;
+static bool referencePhase;
+static uint32_t pageCrc;
+
+static crc_check_callback_t checkCallback;
+static void *checkUser;
+static volatile bool checkBusy = false;
+
+/***************************************************************************//**
+ * Record a failure of a region.
+ ******************************************************************************/
+static void region_fail(uint32_t region, uint32_t address)
+{
+  checkResults[region].passed = false;
+  if (checkResults[region].failure == CRC_CHECK_NO_FAILURE) {
+    checkResults[region].failure = address;
+  }
+}
+
+/***************************************************************************//**
+ * Step to the next chunk of the region list.
+ ******************************************************************************/
+static void region_advance(uint32_t bytes)
+{
+  const crc_check_region_t *region = &checkRegions[regionIndex];
+
+  if (region->type == crcCheckCompare) {
+    // The page of the region, then the same page of the reference
+    referencePhase = !referencePhase;
+    if (referencePhase) {
+      return;
+    }
+  }
+  regionOffset += bytes;
+  if (regionOffset >= region->length) {
+    regionIndex++;
+    regionOffset = 0;
+  }
+}
+
+/***************************************************************************//**
+ * Build the descriptor list of the next batch.
+ *
+ * @return False if there is nothing left to check.
+ ******************************************************************************/
+static bool batch_build(void)
+{
+  const crc_check_region_t *region;
+  uint32_t desc = 0;
+  uint32_t words, bytes, source;
+  bool first, last;
+
+  resultCount = 0;
+  while (regionIndex < checkCount) {
+    region = &checkRegions[regionIndex];
+    if (region->length == 0) {
+      regionIndex++;
+      continue;
+    }
+
+    bytes = region->length - regionOffset;
+    if (region->type == crcCheckExpected) {
+      // One CRC over the whole region
+      if (bytes > (XFER_MAX << 2)) {
+        bytes = XFER_MAX << 2;
+      }
+      first = (regionOffset == 0);
+      last = ((regionOffset + bytes) == region->length);
+    } else {
+      // One CRC per page
+      if (bytes > FLASH_PAGE_SIZE) {
+        bytes = FLASH_PAGE_SIZE;
+      }
+      first = true;
+      last = true;
+    }
+    words = bytes >> 2;
+
+    if (((desc + first + 1 + last) > CRC_CHECK_MAX_DESCRIPTORS)
+        || (last && (resultCount == CRC_CHECK_MAX_RESULTS))) {
+      break;
+    }
+
+    source = (referencePhase ? region->reference : region->address)
+             + regionOffset;
+    if (first) {
+      crcDesc[desc] = (LDMA_Descriptor_t)
+                      LDMA_DESCRIPTOR_LINKREL_WRITE(GPCRC_CMD_INIT,
+                                                    &(GPCRC->CMD),
+                                                    1);
+      crcDesc[desc].wri.doneIfs = 0;
+      desc++;
+    }
+    crcDesc[desc] = (LDMA_Descriptor_t)
+                    LDMA_DESCRIPTOR_LINKREL_M2M_WORD(source,
+                                                     &(GPCRC->INPUTDATA),
+                                                     words,
+                                                     1);
+    crcDesc[desc].xfer.dstInc = ldmaCtrlDstIncNone;
+    crcDesc[desc].xfer.doneIfs = 0;
+    desc++;
+    if (last) {
+      crcDesc[desc] = (LDMA_Descriptor_t)
+                      LDMA_DESCRIPTOR_LINKREL_M2M_WORD(&(GPCRC->DATA),
+                                                       &crcResults[resultCount],
+                                                       1,
+                                                       1);
+      crcDesc[desc].xfer.doneIfs = 0;
+      desc++;
+
+      resultInfo[resultCount].region = regionIndex;
+      resultInfo[resultCount].address = region->address + regionOffset;
+      if (region->type == crcCheckBlank) {
+        resultInfo[resultCount].kind = resultBlank;
+      } else if (region->type == crcCheckExpected) {
+        resultInfo[resultCount].address = region->address;
+        resultInfo[resultCount].kind = resultExpected;
+      } else {
+        resultInfo[resultCount].kind = referencePhase ? resultReference
+                                       : resultPage;
+      }
+      resultCount++;
+    }
+
+    region_advance(bytes);
+  }
+
+  if (desc == 0) {
+    return false;
+  }
+  // The last descriptor is always a transfer, never the GPCRC init
+  crcDesc[desc - 1].xfer.link = 0;
+  crcDesc[desc - 1].xfer.doneIfs = 1;
+  return true;
+}
+
+/***************************************************************************//**
+ * Check the CRCs stored by a batch, in the order they were computed.
+ ******************************************************************************/
+static void batch_check(void)
+{
+  const result_info_t *info;
+  const crc_check_region_t *region;
+  uint32_t crc;
+
+  for (uint32_t i = 0; i < resultCount; i++) {
+    info = &resultInfo[i];
+    region = &checkRegions[info->region];
+    crc = crcResults[i];
+
+    switch (info->kind) {
+      case resultBlank:
+        if (crc != blankCrc) {
+          region_fail(info->region, info->address);
+        }
+        break;
+
+      case resultExpected:
+        // Invert the data register output to get the IEEE 802.3 result
+        checkResults[info->region].crc = ~crc;
+        if (~crc != region->expected) {
+          region_fail(info->region, info->address);
+        }
+        break;
+
+      case resultPage:
+        pageCrc = crc;
+        break;
+
+      case resultReference:
+        if (crc != pageCrc) {
+          region_fail(info->region, info->address);
+        }
+        break;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * End the check and report it.
+ ******************************************************************************/
+static void check_finish(void)
+{
+  uint32_t failed = 0;
+
+  for (uint32_t i = 0; i < checkCount; i++) {
+    if (!checkResults[i].passed) {
+      failed++;
+    }
+  }
+  checkBusy = false;
+  if (checkCallback != NULL) {
+    checkCallback(failed, checkUser);
+  }
+}
+
+/***************************************************************************//**
+ * LDMA interrupt handler: check the batch just done and start the next one.
+ ******************************************************************************/
+void LDMA_IRQHandler(void)
+{
+  uint32_t pending = LDMA_IntGetEnabled();
+
+  if (pending & LDMA_IF_ERROR) {
+    // Nothing computed can be trusted, fail what is not checked yet
+    LDMA_IntClear(LDMA_IF_ERROR);
+    if (checkBusy) {
+      for (uint32_t i = resultCount ? resultInfo[0].region : regionIndex;
+           i < checkCount; i++) {
+        region_fail(i, checkRegions[i].address);
+      }
+      check_finish();
+    }
+    return;
+  }
+
+  if (pending & (1UL << CRC_CHECK_LDMA_CHANNEL)) {
+    LDMA_IntClear(1UL << CRC_CHECK_LDMA_CHANNEL);
+    if (!checkBusy) {
+      return;
+    }
+    batch_check();
+    if (batch_build()) {
+      LDMA_StartTransfer(CRC_CHECK_LDMA_CHANNEL, &crcXferCfg, crcDesc);
+    } else {
+      check_finish();
+    }
+  }
+}
+
+/***************************************************************************//**
+ * Set up the service.
+ ******************************************************************************/
+void crc_check_init(void)
+{
+  // CRC of a blank page, as the GPCRC leaves it in GPCRC_DATA
+  GPCRC_Start(GPCRC);
+  for (uint32_t i = 0; i < PAGE_WORDS; i++) {
+    GPCRC_InputU32(GPCRC, 0xFFFFFFFF);
+  }
+  blankCrc = GPCRC_DataRead(GPCRC);
+
+  // Memory-to-memory transfers as fast as possible; halt during debug
+  crcXferCfg = (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_MEMORY();
+  crcXferCfg.ldmaDbgHalt = true;
+}
+
+/***************************************************************************//**
+ * Start checking a list of regions.
+ ******************************************************************************/
+bool crc_check_start(const crc_check_region_t *regions,
+                     crc_check_result_t *results,
+                     uint32_t count,
+                     crc_check_callback_t callback,
+                     void *user)
+{
+  if (checkBusy) {
+    return false;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    if ((regions[i].address & 3) || (regions[i].length & 3)
+        || ((regions[i].type == crcCheckBlank)
+            && (regions[i].length % FLASH_PAGE_SIZE))
+        || ((regions[i].type == crcCheckCompare)
+            && (regions[i].reference & 3))) {
+      return false;
+    }
+    results[i].passed = true;
+    results[i].failure = CRC_CHECK_NO_FAILURE;
+    results[i].crc = 0;
+  }
+
+  checkRegions = regions;
+  checkResults = results;
+  checkCount = count;
+  checkCallback = callback;
+  checkUser = user;
+  regionIndex = 0;
+  regionOffset = 0;
+  referencePhase = false;
+
+  if (!batch_build()) {
+    // Nothing to check
+    check_finish();
+    return true;
+  }
+  checkBusy = true;
+  LDMA_StartTransfer(CRC_CHECK_LDMA_CHANNEL, &crcXferCfg, crcDesc);
+  return true;
+}
+
+/***************************************************************************//**
+ * Check whether a list of regions is being checked.
+ ******************************************************************************/
+bool crc_check_busy(void)
+{
+  return checkBusy;
+}
@@ -63,6 +63,16 @@ int close_i2c(int i2c_handle);
 *******************************************************************************/
 int last_command_status(int i2c_handle, int address);
 
+/***************************************************************************//**
+* @brief gets the download progress from the slave
+* @param i2c_handle I2C handle
+* @param address 7-bit slave address
+* @param downloadStatus pointer to the download status structure
+* @return -1 on error, 0 on success
+*******************************************************************************/
+int get_download_status(int i2c_handle, int address,
+                        boot_download_status_t *downloadStatus);
+
 /***************************************************************************//**
 * @brief aborts slave's current operation (effective for DOWNLOAD)
 * @param i2c_handle I2C handle
@@ -82,6 +92,17 @@ int get_version_info(int i2c_handle,
                      int address,
                      btl_version_info_t *versionInfo);
 
+/***************************************************************************//**
+* @brief gets the download capabilities from the slave, if its version has
+*        them and the values are within the protocol limits
+* @param i2c_handle   I2C handle
+* @param address      7-bit slave address
+* @param capabilities pointer to the capabilities structure
+* @return -1 on error (slave without windowed download), 0 on success
+*******************************************************************************/
+int get_capabilities(int i2c_handle, int address,
+                     boot_capabilities_t *capabilities);
+
 /***************************************************************************//**
 * @brief boots the application on slave from the slot
 * @param i2c_handle       I2C handle
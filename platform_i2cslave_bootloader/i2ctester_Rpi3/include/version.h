@@ -37,6 +37,6 @@
 #define _VERSION_H
 
 /// i2ctester version string
-#define VERSION_STR "v0.1ß"
+#define VERSION_STR "v0.2ß"
 
 #endif
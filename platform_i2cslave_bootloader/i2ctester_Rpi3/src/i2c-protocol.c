@@ -35,6 +35,7 @@
  ******************************************************************************/
 
 #include "i2c-protocol-prototypes.h"
+#include "btl_i2c_crc16.h"
 #include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 
@@ -51,32 +52,8 @@
 #include <errno.h>
 #include <unistd.h>
 
-#define CRC16_INIT             0xFFFFU
-
-uint16_t crc16(const uint8_t newByte, uint16_t prevResult)
-{
-  prevResult = (prevResult >> 8) | (prevResult << 8);
-  prevResult ^= newByte;
-  prevResult ^= (prevResult & 0xFF) >> 4;
-  prevResult ^= (prevResult << 8) << 4;
-
-  prevResult ^= ((uint8_t) ((uint8_t) ((uint8_t) (prevResult & 0xFF)) << 5))
-                | ((uint16_t) ((uint8_t) ((uint8_t) (prevResult & 0xFF))
-                               >> 3) << 8);
-
-  return prevResult;
-}
-
-uint16_t crc16s(const uint8_t *buffer,
-                size_t        length,
-                uint16_t      prevResult)
-{
-  size_t position = 0;
-  for (; position < length; position++) {
-    prevResult = crc16(buffer[position], prevResult);
-  }
-  return prevResult;
-}
+/// delay between two download status requests in windowed mode
+#define DOWNLOAD_STATUS_POLL_US 100
 
 /***************************************************************************//**
 * @brief writes the I2C bus
@@ -209,6 +186,28 @@ int last_command_status(int i2c_handle, int address)
   return -1;
 }
 
+/***************************************************************************//**
+* @brief gets the download progress from the slave
+* @param i2c_handle I2C handle
+* @param address 7-bit slave address
+* @param downloadStatus pointer to the download status structure
+* @return -1 on error, 0 on success
+*******************************************************************************/
+int get_download_status(int i2c_handle, int address,
+                        boot_download_status_t *downloadStatus)
+{
+  uint8_t command = BOOT_GET_DOWNLOAD_STATUS;
+  uint8_t num_retries = BOOT_STATUS_REQUEST_MAX;
+  while (--num_retries) {
+    if (!i2c_read(i2c_handle, address, &command, 1,
+                  (uint8_t *)downloadStatus, sizeof(boot_download_status_t))) {
+      return 0;
+    }
+    usleep(1000);
+  }
+  return -1;
+}
+
 /***************************************************************************//**
 * @brief aborts slave's current operation (effective for DOWNLOAD)
 * @param i2c_handle I2C handle
@@ -242,6 +241,45 @@ int get_version_info(int i2c_handle, int address,
   return 0;
 }
 
+/***************************************************************************//**
+* @brief gets the download capabilities from the slave
+*        Bootloaders older than BOOT_WINDOWED_VERSION_xxx do not know the
+*        command and answer it from an empty transmit queue with 0xFF bytes,
+*        so the command is only sent to newer ones, and any value out of the
+*        protocol limits is taken as not supported.
+* @param i2c_handle   I2C handle
+* @param address      7-bit slave address
+* @param capabilities pointer to the capabilities structure
+* @return -1 on error (slave without windowed download), 0 on success
+*******************************************************************************/
+int get_capabilities(int i2c_handle, int address,
+                     boot_capabilities_t *capabilities)
+{
+  uint8_t command = BOOT_GET_CAPABILITIES;
+  btl_version_info_t versionInfo;
+
+  if (get_version_info(i2c_handle, address, &versionInfo)) {
+    return -1;
+  }
+  if ((((uint32_t)versionInfo.boot_version.major << 16)
+       | versionInfo.boot_version.minor)
+      < ((BOOT_WINDOWED_VERSION_MAJOR << 16) | BOOT_WINDOWED_VERSION_MINOR)) {
+    return -1;
+  }
+  if (i2c_read(i2c_handle, address, &command, 1,
+               (uint8_t *)capabilities, sizeof(boot_capabilities_t))) {
+    return -1;
+  }
+  if ((capabilities->max_frame_data_length == 0)
+      || (capabilities->max_frame_data_length
+          > BOOT_MAX_NEGOTIATED_FRAME_DATA_LENGTH)
+      || (capabilities->window_size == 0)
+      || (capabilities->window_size > BOOT_MAX_NEGOTIATED_WINDOW_SIZE)) {
+    return -1;
+  }
+  return 0;
+}
+
 /***************************************************************************//**
 * @brief boots the application on slave from the slot
 * @param i2c_handle       I2C handle
@@ -293,14 +331,13 @@ int verify_app(int i2c_handle, int address, uint8_t *verifyResult)
 * @param chunkSize             amount of data bytes
 * @return negative on error, 0 on success
 *******************************************************************************/
-static int send_chunk_of_stream(int i2c_handle,
-                                int address,
-                                uint32_t frame_sequence_number,
-                                uint8_t *chunkData,
-                                uint8_t chunkSize)
+static int write_chunk_of_stream(int i2c_handle,
+                                 int address,
+                                 uint32_t frame_sequence_number,
+                                 uint8_t *chunkData,
+                                 uint8_t chunkSize)
 {
   i2c_download_frame_data_t downloadData;
-  int status;
   downloadData.frame.frame_seq_nr = frame_sequence_number;
   downloadData.frame.crc16 = 0;
   downloadData.frame.length = chunkSize + BOOT_DOWNLOAD_FRAME_HEADER_SIZE;
@@ -309,14 +346,37 @@ static int send_chunk_of_stream(int i2c_handle,
     downloadData.frame.frame_data[k] = chunkData[k];
   }
 
-  downloadData.frame.crc16 = crc16s(downloadData.bytes,
-                                    downloadData.frame.length,
-                                    CRC16_INIT);
+  downloadData.frame.crc16 = btl_i2c_crc16(downloadData.bytes,
+                                            downloadData.frame.length,
+                                            BTL_I2C_CRC16_START);
 
   if (i2c_write(i2c_handle, address,
                 downloadData.bytes, downloadData.frame.length)) {
     return -1;
   }
+  return 0;
+}
+
+/***************************************************************************//**
+* @brief send a chunk frame to slave and wait for its result
+* @param i2c_handle            I2C handle
+* @param address               7-bit slave address
+* @param frame_sequence_number frame sequence number
+* @param chunkData             chunk data bytes
+* @param chunkSize             amount of data bytes
+* @return negative on error, 0 on success
+*******************************************************************************/
+static int send_chunk_of_stream(int i2c_handle,
+                                int address,
+                                uint32_t frame_sequence_number,
+                                uint8_t *chunkData,
+                                uint8_t chunkSize)
+{
+  int status;
+  if (write_chunk_of_stream(i2c_handle, address, frame_sequence_number,
+                            chunkData, chunkSize)) {
+    return -1;
+  }
   do {
     status = last_command_status(i2c_handle, address);
   } while (status == BOOT_OPERATION_DOWNLOAD_PENDING
@@ -336,29 +396,20 @@ static void progress_spinner()
 }
 
 /***************************************************************************//**
-* @brief send a file stream to slave
+* @brief send a file stream to slave, one frame at a time
 * @param i2c_handle   I2C handle
 * @param address      7-bit slave address
 * @param fhandle      file (stream) handle
 * @return negative value on error, 0 on success
 *******************************************************************************/
-static int send_stream_as_file(int i2c_handle, int address, int fhandle)
+static int send_stream_stop_and_wait(int i2c_handle, int address, int fhandle)
 {
   uint8_t chunk[BOOT_MAX_DOWNLOAD_FRAME_DATA_LENGTH];
   size_t readSize;
   int status = BOOT_REPLY_OK;
-  uint8_t command = BOOT_GBL_DOWNLOAD;
   uint32_t frame_sequence = 0;
   uint32_t repetitions = 0;
 
-  if (fhandle < 0) {
-    return -1;
-  }
-  if (i2c_write(i2c_handle, address, &command, 1)) {
-    return -2;
-  }
-  while (last_command_status(i2c_handle, address) != BOOT_REPLY_OK) {}
-  fprintf(stderr, "Download ... ");
   do {
     if (status == BOOT_REPLY_OK) {
       readSize = read(fhandle, chunk, BOOT_MAX_DOWNLOAD_FRAME_DATA_LENGTH);
@@ -378,6 +429,124 @@ static int send_stream_as_file(int i2c_handle, int address, int fhandle)
       }
     }
   } while (readSize);
+  return status;
+}
+
+/***************************************************************************//**
+* @brief send a file stream to slave, keeping a window of frames in flight.
+*        The slave receives the next frame while it parses the previous one.
+*        When all sent frames are processed but some of them were not
+*        acknowledged, the download goes back to the first unacknowledged
+*        frame.
+* @param i2c_handle   I2C handle
+* @param address      7-bit slave address
+* @param fhandle      file (stream) handle
+* @param capabilities frame length and window negotiated with the slave
+* @return negative value on error, 0 on success
+*******************************************************************************/
+static int send_stream_windowed(int i2c_handle, int address, int fhandle,
+                                const boot_capabilities_t *capabilities)
+{
+  uint8_t chunk[BOOT_MAX_NEGOTIATED_FRAME_DATA_LENGTH];
+  size_t frameSize = MIN(capabilities->max_frame_data_length,
+                         BOOT_MAX_NEGOTIATED_FRAME_DATA_LENGTH);
+  uint32_t window = capabilities->window_size;
+  boot_download_status_t downloadStatus;
+  struct stat fileStat;
+  uint32_t frame_count;
+  uint32_t next_sequence = 1;
+  uint32_t acked_sequence = 0;
+  uint32_t retry_sequence = 0;
+  uint8_t sent_frames = 0;
+  uint32_t repetitions = 0;
+  ssize_t readSize;
+
+  if (fstat(fhandle, &fileStat)) {
+    return -1;
+  }
+  frame_count = (fileStat.st_size + frameSize - 1) / frameSize;
+  fprintf(stderr, "(%zu byte frames, window %u) ", frameSize, window);
+
+  while (acked_sequence < frame_count) {
+    // fill up the window
+    while ((next_sequence <= frame_count)
+           && ((next_sequence - acked_sequence) <= window)) {
+      readSize = pread(fhandle, chunk, frameSize,
+                       (off_t)(next_sequence - 1) * frameSize);
+      if (readSize <= 0) {
+        return -1;
+      }
+      if (write_chunk_of_stream(i2c_handle, address, next_sequence,
+                                chunk, readSize)) {
+        return -1;
+      }
+      next_sequence++;
+      sent_frames++;
+      progress_spinner();
+    }
+
+    usleep(DOWNLOAD_STATUS_POLL_US);
+    if (get_download_status(i2c_handle, address, &downloadStatus)) {
+      return -1;
+    }
+    // the slave reports 16-bit sequence numbers
+    acked_sequence += (uint16_t)(downloadStatus.acked_seq_nr
+                                 - (uint16_t)acked_sequence);
+    if (downloadStatus.status == BOOT_REPLY_ERR_PARSE) {
+      return BOOT_REPLY_ERR_PARSE;
+    }
+    if ((downloadStatus.frame_count != sent_frames)
+        || (acked_sequence + 1 == next_sequence)) {
+      // frames are still in process or everything is acknowledged
+      continue;
+    }
+    // everything sent is processed, but not acknowledged: go back
+    if (acked_sequence + 1 == retry_sequence) {
+      if (++repetitions == BOOT_SEQUENCE_REPETITIONS_MAX) {
+        return downloadStatus.status ? downloadStatus.status : -1;
+      }
+    } else {
+      repetitions = 0;
+    }
+    retry_sequence = acked_sequence + 1;
+    fprintf(stderr, "chunk %d would be repeated (%02X)\n",
+            retry_sequence, downloadStatus.status);
+    next_sequence = retry_sequence;
+  }
+  return BOOT_REPLY_OK;
+}
+
+/***************************************************************************//**
+* @brief send a file stream to slave
+* @param i2c_handle   I2C handle
+* @param address      7-bit slave address
+* @param fhandle      file (stream) handle
+* @return negative value on error, 0 on success
+*******************************************************************************/
+static int send_stream_as_file(int i2c_handle, int address, int fhandle)
+{
+  int status;
+  uint8_t command = BOOT_GBL_DOWNLOAD;
+  boot_capabilities_t capabilities;
+  bool windowed;
+
+  if (fhandle < 0) {
+    return -1;
+  }
+  // slaves without the capabilities command are served one frame at a time,
+  // with BOOT_MAX_DOWNLOAD_FRAME_DATA_LENGTH bytes of data
+  windowed = !get_capabilities(i2c_handle, address, &capabilities);
+  if (i2c_write(i2c_handle, address, &command, 1)) {
+    return -2;
+  }
+  while (last_command_status(i2c_handle, address) != BOOT_REPLY_OK) {}
+  fprintf(stderr, "Download ... ");
+  if (windowed) {
+    status = send_stream_windowed(i2c_handle, address, fhandle,
+                                  &capabilities);
+  } else {
+    status = send_stream_stop_and_wait(i2c_handle, address, fhandle);
+  }
 
   command = status ? BOOT_ABORT_OPERATION: BOOT_DOWNLOAD_COMPLETE;
 
@@ -46,6 +46,7 @@
 #include <fcntl.h>
 #include <errno.h>
 #include "btl_i2c_communication.h"
+#include "btl_i2c_crc16.h"
 #include "i2c-protocol-prototypes.h"
 #include "version.h"
 #include <time.h>
@@ -88,6 +89,7 @@ void cmd_print_boot_version(int argc, char *argv[]);
 void cmd_download_file(int argc, char *argv[]);
 void cmd_boot_application(int argc, char *argv[]);
 void cmd_verify_application(int argc, char *argv[]);
+void cmd_crc_self_test(int argc, char *argv[]);
 void cmd_print_help(int argc, char *argv[]);
 
 /// main command table
@@ -96,6 +98,7 @@ static command_table_item_t main_command_table[] = {
   { .type = function, .command_id = 'B', .command.fx = cmd_boot_application },
   { .type = function, .command_id = 'V', .command.fx = cmd_verify_application },
   { .type = function, .command_id = 'I', .command.fx = cmd_print_boot_version },
+  { .type = function, .command_id = 'C', .command.fx = cmd_crc_self_test },
   { .type = function, .command_id = 'H', .command.fx = cmd_print_help },
   { .type = function, .command_id = 'h', .command.fx = cmd_print_help },
   END_OF_TABLE
@@ -124,6 +127,8 @@ void print_usage()
           "    I        - show boot version\n"
           "    V        - verify application\n"
           "    B        - Boot application\n"
+          "    C [n]    - CRC self test and benchmark on n random buffers\n"
+          "               (no I2C access)\n"
           "    (H or h) - this help\n",
           VERSION_STR
           );
@@ -308,6 +313,72 @@ void cmd_verify_application(int argc, char *argv[])
   exit(result);
 }
 
+/***************************************************************************//**
+* @brief measures one CRC16 implementation
+* @param name        printed name of the implementation
+* @param crc         the implementation
+* @param buffer      data bytes
+* @param length      number of data bytes
+* @param repeat      number of calculations
+*******************************************************************************/
+static void benchmark_crc(const char *name,
+                          uint16_t (*crc)(const uint8_t *, size_t, uint16_t),
+                          const uint8_t *buffer, size_t length, int repeat)
+{
+  struct timespec start, stop;
+  volatile uint16_t result = 0;
+  double elapsed;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < repeat; i++) {
+    result = crc(buffer, length, result);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  elapsed = (stop.tv_sec - start.tv_sec)
+            + (stop.tv_nsec - start.tv_nsec) / 1e9;
+  fprintf(stderr, "%-8s: %8.1f MB/s\n", name,
+          (double)length * repeat / elapsed / 1e6);
+}
+
+/***************************************************************************//**
+* @brief checks the CRC16 implementations against the bitwise one on random
+*        buffers and prints their speed
+*******************************************************************************/
+void cmd_crc_self_test(int argc, char *argv[])
+{
+  static uint8_t buffer[BOOT_MAX_DOWNLOAD_FRAME_SIZE + 3];
+  int count = 100000;
+  int errors = 0;
+  if (argc >= 2) {
+    count = atoi(argv[1]);
+  }
+  for (int i = 0; i < count; i++) {
+    // random length and alignment, covering the slice-by-4 tail handling
+    size_t offset = rand() % 4;
+    size_t length = rand() % (BOOT_MAX_DOWNLOAD_FRAME_SIZE + 1);
+    uint16_t start = (i & 1) ? BTL_I2C_CRC16_START : (uint16_t)rand();
+    for (size_t k = 0; k < length; k++) {
+      buffer[offset + k] = rand();
+    }
+    uint16_t expected = btl_i2c_crc16_bitwise(buffer + offset, length, start);
+    if ((btl_i2c_crc16_table(buffer + offset, length, start) != expected)
+        || (btl_i2c_crc16_slice4(buffer + offset, length, start)
+            != expected)) {
+      errors++;
+    }
+  }
+  fprintf(stderr, "CRC self test: %d buffers, %d errors\n", count, errors);
+  if (errors) {
+    exit(1);
+  }
+  benchmark_crc("bitwise", btl_i2c_crc16_bitwise,
+                buffer, BOOT_MAX_DOWNLOAD_FRAME_SIZE, count);
+  benchmark_crc("table", btl_i2c_crc16_table,
+                buffer, BOOT_MAX_DOWNLOAD_FRAME_SIZE, count);
+  benchmark_crc("slice4", btl_i2c_crc16_slice4,
+                buffer, BOOT_MAX_DOWNLOAD_FRAME_SIZE, count);
+  exit(0);
+}
+
 /***************************************************************************//**
 * @brief prints the usage
 *******************************************************************************/
@@ -38,7 +38,7 @@
 #define _BOOTLOADER_VERSION_H_
 
 #define _BOOTLOADER_VERSION_MAJOR  0
-#define _BOOTLOADER_VERSION_MINOR  2
-#define _BOOTLOADER_VERSION_PATCH  1
+#define _BOOTLOADER_VERSION_MINOR  3
+#define _BOOTLOADER_VERSION_PATCH  0
 
 #endif /* _BOOTLOADER_VERSION_H_ */
@@ -45,11 +45,13 @@ extern "C" {
 /// Bootloader command byte definitions
 #define BOOT_GBL_DOWNLOAD                   (0x10)
 #define BOOT_VERSION                        (0x20)
+#define BOOT_GET_CAPABILITIES               (0x21)
 #define BOOT_BOOT_APP                       (0x30)
 #define BOOT_VERIFY                         (0x60)
 #define BOOT_ACTIVATE_UPGRADE               (0xA9)
 
 #define BOOT_GET_LAST_CMD_STATUS            (0x55)
+#define BOOT_GET_DOWNLOAD_STATUS            (0x56)
 #define BOOT_ABORT_OPERATION                (0xAA)
 
 #define BOOT_DOWNLOAD_FRAME                 (0x11)
@@ -59,6 +61,7 @@ extern "C" {
 #define BOOT_REPLY_OK                       (0x00)
 #define BOOT_REPLY_PENDING                  (0x81)
 
+#define BOOT_REPLY_ERR_OVERFLOW             (0xF8)
 #define BOOT_REPLY_ERR_INCOMPLETE           (0xF9)
 #define BOOT_REPLY_ERR_FRAME_SEQUENCE       (0xFA)
 #define BOOT_REPLY_ERR_PARSE                (0xFB)
@@ -77,7 +80,19 @@ extern "C" {
 #define BOOT_OPERATION_DOWNLOAD_PENDING     (0x12)
 
 /// constants for protocol
+/// frame data length used when the capabilities are not negotiated
 #define BOOT_MAX_DOWNLOAD_FRAME_DATA_LENGTH (128)
+/// largest frame data length, limited by the 8-bit frame length field
+#define BOOT_MAX_NEGOTIATED_FRAME_DATA_LENGTH \
+  (255 - BOOT_DOWNLOAD_FRAME_HEADER_SIZE)
+/// number of download frames the slave can hold at once (window size)
+#define BOOT_DOWNLOAD_WINDOW_SIZE           (2)
+/// largest window size a master accepts from BOOT_GET_CAPABILITIES
+#define BOOT_MAX_NEGOTIATED_WINDOW_SIZE     (16)
+/// first bootloader version with BOOT_GET_CAPABILITIES and
+/// BOOT_GET_DOWNLOAD_STATUS, older ones answer them with 0xFF bytes
+#define BOOT_WINDOWED_VERSION_MAJOR         (0)
+#define BOOT_WINDOWED_VERSION_MINOR         (3)
 
 /// constants for master settings
 /// maximum number of repetitions on frame download fails
@@ -108,7 +123,25 @@ typedef struct __PACKED {
   (sizeof(i2c_download_frame_t))
 
 #define BOOT_MAX_DOWNLOAD_FRAME_SIZE \
-  (BOOT_MAX_DOWNLOAD_FRAME_DATA_LENGTH + BOOT_DOWNLOAD_FRAME_HEADER_SIZE)
+  (BOOT_MAX_NEGOTIATED_FRAME_DATA_LENGTH + BOOT_DOWNLOAD_FRAME_HEADER_SIZE)
+
+/// download capabilities of the slave (BOOT_GET_CAPABILITIES)
+typedef struct __PACKED {
+  /// largest accepted frame_data length
+  uint8_t  max_frame_data_length;
+  /// number of frames which can be sent without waiting for the result
+  uint8_t  window_size;
+} boot_capabilities_t;
+
+/// download progress of the slave (BOOT_GET_DOWNLOAD_STATUS)
+typedef struct __PACKED {
+  /// status of the last processed frame (BOOT_REPLY_xxx)
+  uint8_t  status;
+  /// number of received download frames modulo 256, incl. dropped ones
+  uint8_t  frame_count;
+  /// sequence number of the last frame parsed without error
+  uint16_t acked_seq_nr;
+} boot_download_status_t;
 
 /// version info data
 typedef struct __PACKED {
@@ -0,0 +1,140 @@
+/***************************************************************************//**
+ * @file
+ * @brief CRC16 of the Bootloader I2C download frames.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+#ifndef _I2C_CRC16_H_
+#define _I2C_CRC16_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// CRC16 implementations. All of them compute the same CRC-16/CCITT-FALSE
+/// (polynomial 0x1021, MSB first, no final XOR) used by the download frames.
+#define BTL_I2C_CRC16_BACKEND_BITWISE       (0)
+#define BTL_I2C_CRC16_BACKEND_TABLE         (1)
+#define BTL_I2C_CRC16_BACKEND_SLICE4        (2)
+#define BTL_I2C_CRC16_BACKEND_GPCRC         (3)
+
+/// Implementation used by btl_i2c_crc16(). GPCRC is only available on the
+/// slave, the host tool uses the slice-by-4 tables.
+#ifndef BTL_I2C_CRC16_BACKEND
+#define BTL_I2C_CRC16_BACKEND               BTL_I2C_CRC16_BACKEND_SLICE4
+#endif
+
+/// Start value of a CRC calculation
+#define BTL_I2C_CRC16_START                 (0xFFFFU)
+
+/// Random buffers checked by btl_i2c_crc16_self_test()
+#ifndef BTL_I2C_CRC16_SELF_TEST_COUNT
+#define BTL_I2C_CRC16_SELF_TEST_COUNT       (64)
+#endif
+
+/// Longest random buffer of btl_i2c_crc16_self_test(), odd on purpose
+#ifndef BTL_I2C_CRC16_SELF_TEST_LENGTH
+#define BTL_I2C_CRC16_SELF_TEST_LENGTH      (67)
+#endif
+
+/***************************************************************************//**
+* @brief calculates the CRC16 of a buffer with the selected backend
+* @param buffer      data bytes
+* @param length      number of data bytes
+* @param prevResult  BTL_I2C_CRC16_START or the result of the previous call
+* @return the CRC16 value
+*******************************************************************************/
+uint16_t btl_i2c_crc16(const uint8_t *buffer, size_t length,
+                       uint16_t prevResult);
+
+/***************************************************************************//**
+* @brief calculates the CRC16 of a buffer bit by bit (reference version)
+* @param buffer      data bytes
+* @param length      number of data bytes
+* @param prevResult  BTL_I2C_CRC16_START or the result of the previous call
+* @return the CRC16 value
+*******************************************************************************/
+uint16_t btl_i2c_crc16_bitwise(const uint8_t *buffer, size_t length,
+                               uint16_t prevResult);
+
+/***************************************************************************//**
+* @brief calculates the CRC16 of a buffer with one table lookup per byte
+* @param buffer      data bytes
+* @param length      number of data bytes
+* @param prevResult  BTL_I2C_CRC16_START or the result of the previous call
+* @return the CRC16 value
+*******************************************************************************/
+uint16_t btl_i2c_crc16_table(const uint8_t *buffer, size_t length,
+                             uint16_t prevResult);
+
+/***************************************************************************//**
+* @brief calculates the CRC16 of a buffer four bytes at a time
+* @param buffer      data bytes
+* @param length      number of data bytes
+* @param prevResult  BTL_I2C_CRC16_START or the result of the previous call
+* @return the CRC16 value
+*******************************************************************************/
+uint16_t btl_i2c_crc16_slice4(const uint8_t *buffer, size_t length,
+                              uint16_t prevResult);
+
+#if (BTL_I2C_CRC16_BACKEND == BTL_I2C_CRC16_BACKEND_GPCRC)
+/***************************************************************************//**
+* @brief calculates the CRC16 of a buffer with the GPCRC peripheral
+* @param buffer      data bytes
+* @param length      number of data bytes
+* @param prevResult  BTL_I2C_CRC16_START or the result of the previous call
+* @return the CRC16 value
+*******************************************************************************/
+uint16_t btl_i2c_crc16_gpcrc(const uint8_t *buffer, size_t length,
+                             uint16_t prevResult);
+
+/***************************************************************************//**
+* @brief compares the GPCRC with btl_crc16Stream() on random buffers
+*
+* Runs BTL_I2C_CRC16_SELF_TEST_COUNT buffers of 0 to
+* BTL_I2C_CRC16_SELF_TEST_LENGTH bytes, at every start alignment.
+* btl_i2c_crc16() only uses the GPCRC after this returned true, the
+* slice-by-4 tables before.
+* @return true if all the results matched
+*******************************************************************************/
+bool btl_i2c_crc16_self_test(void);
+#endif
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* _I2C_CRC16_H_ */
@@ -49,10 +49,10 @@
 #include "core/btl_reset.h"
 #include "debug/btl_debug.h"
 #include "btl_i2c_communication.h"
+#include "btl_i2c_crc16.h"
 #include "btl_i2c_queue.h"
 #include "btl_i2c_slave_driver.h"
 #include "bootloader-version.h"
-#include "security/btl_crc16.h"
 
 // Parser
 #include "parser/gbl/btl_gbl_parser.h"
@@ -60,9 +60,26 @@
 
 static volatile uint8_t i2c_comm_current_operation = BOOT_OPERATION_NONE;
 static volatile uint8_t i2c_comm_last_operation_status = BOOT_REPLY_OK;
-static volatile bool got_message = false;
-static uint8_t message[BOOT_MAX_DOWNLOAD_FRAME_SIZE];
-static uint8_t message_length;
+
+/* Received messages. The I2C interrupt fills the buffer at message_in while
+ * the communication main processes the one at message_out, so the next
+ * download frame is received while the previous one is parsed.
+ */
+static uint8_t message[BOOT_DOWNLOAD_WINDOW_SIZE]
+[BOOT_MAX_DOWNLOAD_FRAME_SIZE];
+static uint8_t message_length[BOOT_DOWNLOAD_WINDOW_SIZE];
+static volatile uint8_t message_in = 0;
+static volatile uint8_t message_out = 0;
+
+/// download progress reported by BOOT_GET_DOWNLOAD_STATUS
+static volatile uint16_t acked_frame_sequence_number = 0;
+static volatile uint8_t frames_processed = 0;
+static volatile uint8_t frames_dropped = 0;
+
+static const boot_capabilities_t boot_capabilities = {
+  .max_frame_data_length = BOOT_MAX_NEGOTIATED_FRAME_DATA_LENGTH,
+  .window_size = BOOT_DOWNLOAD_WINDOW_SIZE
+};
 
 static btl_version_info_t boot_version = {
   .boot_version = {
@@ -102,6 +119,22 @@ static bool handle_interrupt_level_commands(queue_t *rx_queue,
                                             queue_t *tx_queue);
 static void process_message(queue_t *rx_queue);
 
+/**
+ * @return true when a received message waits for the communication main.
+ */
+static inline bool got_message(void)
+{
+  return message_in != message_out;
+}
+
+/**
+ * releases the message processed by the communication main.
+ */
+static inline void release_message(void)
+{
+  message_out++;
+}
+
 /**
  * I2C communication handler callback.
  * @param rx_queue The receive queue from I2C driver where received bytes
@@ -123,21 +156,33 @@ static void  i2c_comm_read(queue_t *rx_queue, queue_t *tx_queue)
 static void process_message(queue_t *rx_queue)
 {
   uint16_t c;
-  if (!got_message) {
-    /* If the communication main is in idle state and has no message to process.
+  uint8_t index = message_in % BOOT_DOWNLOAD_WINDOW_SIZE;
+  uint8_t length;
+  if ((uint8_t)(message_in - message_out) < BOOT_DOWNLOAD_WINDOW_SIZE) {
+    /* There is a free message buffer.
      * The first important thing: set the response to pending to avoid
      * the master to see some incorrect result from the previously processed
      * message.
      */
     i2c_comm_last_operation_status = BOOT_REPLY_PENDING;
-    for (message_length = 0;
-         ((c = queue_pop(rx_queue)) != QUEUE_EOF);
-         message[message_length++] = c & 0xFF) {
+    for (length = 0;
+         ((c = queue_pop(rx_queue)) != QUEUE_EOF)
+         && (length < BOOT_MAX_DOWNLOAD_FRAME_SIZE);
+         message[index][length++] = c & 0xFF) {
       // get out all of received bytes
     }
+    message_length[index] = length;
     // notify the communication main about the message.
-    got_message = true;
+    message_in++;
+  } else {
+    // the master has exceeded the window, the message is dropped.
+    if (queue_peek(rx_queue) == (QUEUE_OK | BOOT_DOWNLOAD_FRAME)) {
+      frames_dropped++;
+    }
+    i2c_comm_last_operation_status = BOOT_REPLY_ERR_OVERFLOW;
   }
+  // never leave bytes behind, they would be prepended to the next message.
+  queue_init(rx_queue);
 }
 
 /**
@@ -187,6 +232,37 @@ static bool handle_interrupt_level_commands(queue_t *rx_queue,
       // the message considered to processed
       result = true;
       break;
+    case BOOT_GET_CAPABILITIES:
+      // gets the frame length and the window the master may use
+      // pop the command byte
+      queue_pop(rx_queue);
+
+      for (unsigned int i = 0; i < sizeof(boot_capabilities_t);
+           queue_push(tx_queue, ((const uint8_t *)&boot_capabilities)[i++])) {
+        // just copy the structure to the transmit queue
+      }
+      // the message considered to processed
+      result = true;
+      break;
+    case BOOT_GET_DOWNLOAD_STATUS:
+    {
+      // gets the download progress
+      boot_download_status_t download_status = {
+        .status = i2c_comm_last_operation_status,
+        .frame_count = frames_processed + frames_dropped,
+        .acked_seq_nr = acked_frame_sequence_number
+      };
+      // pop the command byte
+      queue_pop(rx_queue);
+
+      for (unsigned int i = 0; i < sizeof(boot_download_status_t);
+           queue_push(tx_queue, ((uint8_t *)&download_status)[i++])) {
+        // just copy the structure to the transmit queue
+      }
+      // the message considered to processed
+      result = true;
+      break;
+    }
     default:
       result = false;
       break;
@@ -197,6 +273,11 @@ static bool handle_interrupt_level_commands(queue_t *rx_queue,
 void communication_init(void)
 {
   BTL_DEBUG_PRINTLN("i2c slave initialization");
+#if (BTL_I2C_CRC16_BACKEND == BTL_I2C_CRC16_BACKEND_GPCRC)
+  if (!btl_i2c_crc16_self_test()) {
+    BTL_DEBUG_PRINTLN("GPCRC self test failed, using the CRC16 tables");
+  }
+#endif
   I2C_slave_init();
 }
 
@@ -213,10 +294,10 @@ int32_t communication_main(void)
   uint8_t command;
   while (true) {
     i2c_comm_current_operation = BOOT_OPERATION_NONE;
-    while (!got_message) {
+    while (!got_message()) {
       // wait for message
     }
-    command = message[0];
+    command = message[message_out % BOOT_DOWNLOAD_WINDOW_SIZE][0];
     switch (command) {
       case BOOT_GBL_DOWNLOAD:
         // software download
@@ -240,7 +321,9 @@ int32_t communication_main(void)
         break;
     }
     // done with the current message
-    got_message = false;
+    if (command != BOOT_GBL_DOWNLOAD) {
+      release_message();
+    }
   }
   return ret;
 }
@@ -312,13 +395,14 @@ static void verify(void)
 static uint8_t check_frame(i2c_download_frame_data_t *frame,
                            uint8_t received_length)
 {
-  if (frame->frame.length != received_length) {
+  if ((frame->frame.length != received_length)
+      || (received_length < BOOT_DOWNLOAD_FRAME_HEADER_SIZE)) {
     return BOOT_REPLY_ERR_LENGTH;
   }
   uint16_t crc16 = frame->frame.crc16;
   frame->frame.crc16 = 0;
-  uint16_t calc_crc16 = btl_crc16Stream(frame->bytes, frame->frame.length,
-                                        BTL_CRC16_START);
+  uint16_t calc_crc16 = btl_i2c_crc16(frame->bytes, frame->frame.length,
+                                      BTL_I2C_CRC16_START);
   frame->frame.crc16 = crc16;
   if (calc_crc16 != crc16) {
     return BOOT_REPLY_ERR_CRC;
@@ -332,12 +416,13 @@ static uint8_t check_frame(i2c_download_frame_data_t *frame,
 static void start_download(void)
 {
   uint8_t status;
+  uint8_t index;
   bool downloading = true;
-  got_message = false;
-  i2c_download_frame_data_t *downloadFrame =
-    (i2c_download_frame_data_t *)message;
-  uint32_t frame_sequence_number = 1;
+  i2c_download_frame_data_t *downloadFrame;
+  uint16_t frame_sequence_number = 1;
   BTL_DEBUG_PRINTLN("start_download()");
+  // the BOOT_GBL_DOWNLOAD message is done
+  release_message();
   // Initialize EBL parser
   parser_init(&parserContext,
               &decryptContext,
@@ -345,25 +430,32 @@ static void start_download(void)
               PARSER_FLAG_PARSE_CUSTOM_TAGS);
   memset(&imageProps, 0, sizeof(ImageProperties_t));
   imageProps.instructions = 0xFFU;
+  // reset the download progress
+  acked_frame_sequence_number = 0;
+  frames_processed = 0;
+  frames_dropped = 0;
   // set the current operation
   i2c_comm_current_operation = BOOT_OPERATION_DOWNLOAD;
   // update status
   i2c_comm_last_operation_status = BOOT_REPLY_OK;
   while (downloading) {
     i2c_comm_current_operation = BOOT_OPERATION_DOWNLOAD;
-    while (!got_message
+    while (!got_message()
            && i2c_comm_current_operation == BOOT_OPERATION_DOWNLOAD) {
       // wait for abort or message
     }
 
     // operation aborted
-    if (!got_message) {
+    if (!got_message()) {
       break;
     }
+    // the interrupt keeps receiving into the other buffer meanwhile
+    index = message_out % BOOT_DOWNLOAD_WINDOW_SIZE;
+    downloadFrame = (i2c_download_frame_data_t *)message[index];
     switch (downloadFrame->frame.command) {
       case BOOT_DOWNLOAD_FRAME:
         i2c_comm_current_operation = BOOT_OPERATION_DOWNLOAD_FRAME;
-        status = check_frame(downloadFrame, message_length);
+        status = check_frame(downloadFrame, message_length[index]);
         if (status) {
           // check_frame returned an error;
           i2c_comm_last_operation_status = status;
@@ -391,7 +483,13 @@ static void start_download(void)
           BTL_DEBUG_PRINT_LF();
           i2c_comm_last_operation_status = BOOT_REPLY_ERR_PARSE;
         } else {
-          i2c_comm_last_operation_status = BOOT_REPLY_OK;
+          acked_frame_sequence_number = downloadFrame->frame.frame_seq_nr;
+          // keep pending if the next frame has already arrived
+          __disable_irq();
+          if ((uint8_t)(message_in - message_out) == 1) {
+            i2c_comm_last_operation_status = BOOT_REPLY_OK;
+          }
+          __enable_irq();
         }
         break;
 
@@ -413,6 +511,9 @@ static void start_download(void)
         i2c_comm_last_operation_status = BOOT_REPLY_ERR_UNKNOWN;
         break;
     }
-    got_message = false;
+    if (downloadFrame->frame.command == BOOT_DOWNLOAD_FRAME) {
+      frames_processed++;
+    }
+    release_message();
   }
 }
@@ -0,0 +1,272 @@
+/***************************************************************************//**
+ * @file
+ * @brief CRC16 of the Bootloader I2C download frames.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#include "btl_i2c_crc16.h"
+
+#if (BTL_I2C_CRC16_BACKEND == BTL_I2C_CRC16_BACKEND_GPCRC)
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_gpcrc.h"
+#include "security/btl_crc16.h"
+#endif
+
+/* Remainders of x^n modulo the CCITT polynomial x^16 + x^12 + x^5 + 1, each
+ * one from the previous: a shift, and a reduction when x^16 comes out.
+ * Enum constants keep the chain a constant expression of fixed size.
+ */
+#define CRC16_NEXT(r) \
+  ((((r) << 1) & 0xFFFF) ^ (((r) & 0x8000) ? CRC16_X16 : 0))
+
+enum {
+  CRC16_X16 = 0x1021,
+  CRC16_X17 = CRC16_NEXT(CRC16_X16),
+  CRC16_X18 = CRC16_NEXT(CRC16_X17),
+  CRC16_X19 = CRC16_NEXT(CRC16_X18),
+  CRC16_X20 = CRC16_NEXT(CRC16_X19),
+  CRC16_X21 = CRC16_NEXT(CRC16_X20),
+  CRC16_X22 = CRC16_NEXT(CRC16_X21),
+  CRC16_X23 = CRC16_NEXT(CRC16_X22),
+  CRC16_X24 = CRC16_NEXT(CRC16_X23),
+  CRC16_X25 = CRC16_NEXT(CRC16_X24),
+  CRC16_X26 = CRC16_NEXT(CRC16_X25),
+  CRC16_X27 = CRC16_NEXT(CRC16_X26),
+  CRC16_X28 = CRC16_NEXT(CRC16_X27),
+  CRC16_X29 = CRC16_NEXT(CRC16_X28),
+  CRC16_X30 = CRC16_NEXT(CRC16_X29),
+  CRC16_X31 = CRC16_NEXT(CRC16_X30),
+  CRC16_X32 = CRC16_NEXT(CRC16_X31),
+  CRC16_X33 = CRC16_NEXT(CRC16_X32),
+  CRC16_X34 = CRC16_NEXT(CRC16_X33),
+  CRC16_X35 = CRC16_NEXT(CRC16_X34),
+  CRC16_X36 = CRC16_NEXT(CRC16_X35),
+  CRC16_X37 = CRC16_NEXT(CRC16_X36),
+  CRC16_X38 = CRC16_NEXT(CRC16_X37),
+  CRC16_X39 = CRC16_NEXT(CRC16_X38),
+  CRC16_X40 = CRC16_NEXT(CRC16_X39),
+  CRC16_X41 = CRC16_NEXT(CRC16_X40),
+  CRC16_X42 = CRC16_NEXT(CRC16_X41),
+  CRC16_X43 = CRC16_NEXT(CRC16_X42),
+  CRC16_X44 = CRC16_NEXT(CRC16_X43),
+  CRC16_X45 = CRC16_NEXT(CRC16_X44),
+  CRC16_X46 = CRC16_NEXT(CRC16_X45),
+  CRC16_X47 = CRC16_NEXT(CRC16_X46)
+};
+
+/* The CRC is linear: the CRC of the byte v followed by k zero bytes is the
+ * sum of x^(16 + 8k + i) over the bits i set in v.
+ */
+#define CRC16_BIT(v, i, xn)  ((((v) >> (i)) & 1) ? (xn) : 0)
+#define CRC16_BYTE(v, x0, x1, x2, x3, x4, x5, x6, x7)                \
+  (uint16_t)(CRC16_BIT(v, 0, x0) ^ CRC16_BIT(v, 1, x1)               \
+             ^ CRC16_BIT(v, 2, x2) ^ CRC16_BIT(v, 3, x3)             \
+             ^ CRC16_BIT(v, 4, x4) ^ CRC16_BIT(v, 5, x5)             \
+             ^ CRC16_BIT(v, 6, x6) ^ CRC16_BIT(v, 7, x7))
+#define CRC16_ZEROS0(v)                                              \
+  CRC16_BYTE(v, CRC16_X16, CRC16_X17, CRC16_X18, CRC16_X19,          \
+             CRC16_X20, CRC16_X21, CRC16_X22, CRC16_X23)
+#define CRC16_ZEROS1(v)                                              \
+  CRC16_BYTE(v, CRC16_X24, CRC16_X25, CRC16_X26, CRC16_X27,          \
+             CRC16_X28, CRC16_X29, CRC16_X30, CRC16_X31)
+#define CRC16_ZEROS2(v)                                              \
+  CRC16_BYTE(v, CRC16_X32, CRC16_X33, CRC16_X34, CRC16_X35,          \
+             CRC16_X36, CRC16_X37, CRC16_X38, CRC16_X39)
+#define CRC16_ZEROS3(v)                                              \
+  CRC16_BYTE(v, CRC16_X40, CRC16_X41, CRC16_X42, CRC16_X43,          \
+             CRC16_X44, CRC16_X45, CRC16_X46, CRC16_X47)
+
+#define CRC16_ENTRIES16(entry, v)                                    \
+  entry((v)), entry((v) + 1), entry((v) + 2), entry((v) + 3),        \
+  entry((v) + 4), entry((v) + 5), entry((v) + 6), entry((v) + 7),    \
+  entry((v) + 8), entry((v) + 9), entry((v) + 10), entry((v) + 11),  \
+  entry((v) + 12), entry((v) + 13), entry((v) + 14), entry((v) + 15)
+#define CRC16_TABLE(entry)                                           \
+  {                                                                  \
+    CRC16_ENTRIES16(entry, 0), CRC16_ENTRIES16(entry, 16),           \
+    CRC16_ENTRIES16(entry, 32), CRC16_ENTRIES16(entry, 48),          \
+    CRC16_ENTRIES16(entry, 64), CRC16_ENTRIES16(entry, 80),          \
+    CRC16_ENTRIES16(entry, 96), CRC16_ENTRIES16(entry, 112),         \
+    CRC16_ENTRIES16(entry, 128), CRC16_ENTRIES16(entry, 144),        \
+    CRC16_ENTRIES16(entry, 160), CRC16_ENTRIES16(entry, 176),        \
+    CRC16_ENTRIES16(entry, 192), CRC16_ENTRIES16(entry, 208),        \
+    CRC16_ENTRIES16(entry, 224), CRC16_ENTRIES16(entry, 240),        \
+  }
+
+/* CRC of every byte value, one table per byte position of a 32-bit word.
+ * crc16_table[0] is the classic 256 entry table, crc16_table[k][v] is the
+ * CRC of the byte v followed by k zero bytes. The tables are built by the
+ * compiler and kept constant, so they live in flash.
+ */
+static const uint16_t crc16_table[4][256] = {
+  CRC16_TABLE(CRC16_ZEROS0),
+  CRC16_TABLE(CRC16_ZEROS1),
+  CRC16_TABLE(CRC16_ZEROS2),
+  CRC16_TABLE(CRC16_ZEROS3),
+};
+
+uint16_t btl_i2c_crc16_bitwise(const uint8_t *buffer, size_t length,
+                               uint16_t prevResult)
+{
+  for (size_t position = 0; position < length; position++) {
+    prevResult = (prevResult >> 8) | (prevResult << 8);
+    prevResult ^= buffer[position];
+    prevResult ^= (prevResult & 0xFF) >> 4;
+    prevResult ^= (prevResult << 8) << 4;
+    prevResult ^= ((uint8_t) ((uint8_t) ((uint8_t) (prevResult & 0xFF)) << 5))
+                  | ((uint16_t) ((uint8_t) ((uint8_t) (prevResult & 0xFF))
+                                 >> 3) << 8);
+  }
+  return prevResult;
+}
+
+uint16_t btl_i2c_crc16_table(const uint8_t *buffer, size_t length,
+                             uint16_t prevResult)
+{
+  for (size_t position = 0; position < length; position++) {
+    prevResult = (uint16_t)(prevResult << 8)
+                 ^ crc16_table[0][(uint8_t)(prevResult >> 8)
+                                  ^ buffer[position]];
+  }
+  return prevResult;
+}
+
+uint16_t btl_i2c_crc16_slice4(const uint8_t *buffer, size_t length,
+                              uint16_t prevResult)
+{
+  /* The CRC register is only 16 bits wide, so it is folded into the first
+   * two bytes of every group; the last two bytes enter the tables directly.
+   */
+  while (length >= 4) {
+    uint16_t head = prevResult ^ (uint16_t)((buffer[0] << 8) | buffer[1]);
+    prevResult = crc16_table[3][head >> 8]
+                 ^ crc16_table[2][head & 0xFF]
+                 ^ crc16_table[1][buffer[2]]
+                 ^ crc16_table[0][buffer[3]];
+    buffer += 4;
+    length -= 4;
+  }
+  return btl_i2c_crc16_table(buffer, length, prevResult);
+}
+
+#if (BTL_I2C_CRC16_BACKEND == BTL_I2C_CRC16_BACKEND_GPCRC)
+uint16_t btl_i2c_crc16_gpcrc(const uint8_t *buffer, size_t length,
+                             uint16_t prevResult)
+{
+  GPCRC_Init_TypeDef init = GPCRC_INIT_DEFAULT;
+
+  /* The GPCRC shifts LSB first: reverse the input bits of every byte and
+   * read the result bit reversed to get the MSB first CCITT value. The start
+   * value is loaded into the LSB first register, so it is reversed too.
+   */
+  init.crcPoly = 0x1021;
+  init.initValue = __RBIT(prevResult) >> 16;
+  init.reverseBits = true;
+  CMU_ClockEnable(cmuClock_GPCRC, true);
+  GPCRC_Init(GPCRC, &init);
+  GPCRC_Start(GPCRC);
+
+  while ((length > 0) && ((uintptr_t)buffer & 3)) {
+    GPCRC_InputU8(GPCRC, *buffer++);
+    length--;
+  }
+  // Words are processed starting with their lowest addressed byte.
+  while (length >= 4) {
+    GPCRC_InputU32(GPCRC, *(const uint32_t *)buffer);
+    buffer += 4;
+    length -= 4;
+  }
+  while (length > 0) {
+    GPCRC_InputU8(GPCRC, *buffer++);
+    length--;
+  }
+  return (uint16_t)GPCRC_DataReadBitReversed(GPCRC);
+}
+
+/* Set by btl_i2c_crc16_self_test() when the GPCRC matches btl_crc16Stream(),
+ * until then btl_i2c_crc16() uses the slice-by-4 tables.
+ */
+static bool gpcrc_verified = false;
+
+bool btl_i2c_crc16_self_test(void)
+{
+  // Room for the longest buffer at any of the four alignments
+  static uint8_t buffer[BTL_I2C_CRC16_SELF_TEST_LENGTH + 3];
+  uint32_t random = 0x2545F491UL;
+  bool result = true;
+
+  for (uint32_t test = 0; test < BTL_I2C_CRC16_SELF_TEST_COUNT; test++) {
+    // xorshift32, the same sequence on every start
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+      random ^= random << 13;
+      random ^= random >> 17;
+      random ^= random << 5;
+      buffer[i] = (uint8_t)random;
+    }
+    /* Every start alignment, odd and even lengths from 0 up, and a start
+     * value with bits in both bytes: the result of the bit reversed read is
+     * truncated to 16 bits, so a wrong half shows up in every test.
+     */
+    size_t offset = test & 3;
+    size_t length = (test < 8) ? test
+                    : (random >> 8) % (BTL_I2C_CRC16_SELF_TEST_LENGTH + 1);
+    uint16_t start = (test & 4) ? (uint16_t)(random >> 16)
+                     : BTL_I2C_CRC16_START;
+    if (btl_i2c_crc16_gpcrc(buffer + offset, length, start)
+        != btl_crc16Stream(buffer + offset, length, start)) {
+      result = false;
+      break;
+    }
+  }
+  gpcrc_verified = result;
+  return result;
+}
+#endif
+
+uint16_t btl_i2c_crc16(const uint8_t *buffer, size_t length,
+                       uint16_t prevResult)
+{
+#if (BTL_I2C_CRC16_BACKEND == BTL_I2C_CRC16_BACKEND_GPCRC)
+  if (gpcrc_verified) {
+    return btl_i2c_crc16_gpcrc(buffer, length, prevResult);
+  }
+  return btl_i2c_crc16_slice4(buffer, length, prevResult);
+#elif (BTL_I2C_CRC16_BACKEND == BTL_I2C_CRC16_BACKEND_SLICE4)
+  return btl_i2c_crc16_slice4(buffer, length, prevResult);
+#elif (BTL_I2C_CRC16_BACKEND == BTL_I2C_CRC16_BACKEND_TABLE)
+  return btl_i2c_crc16_table(buffer, length, prevResult);
+#else
+  return btl_i2c_crc16_bitwise(buffer, length, prevResult);
+#endif
+}
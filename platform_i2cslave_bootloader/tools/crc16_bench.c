@@ -0,0 +1,308 @@
+/***************************************************************************//**
+ * @file
+ * @brief Equivalence test and benchmark of the CRC16 download frame backends
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ *******************************************************************************
+ *
+ * Compares every backend of ../src/btl_i2c_crc16.c with crc16s() as it was in
+ * i2c-protocol.c before the module existed, on random buffers of odd and even
+ * lengths, at every start alignment, with random start values and with the
+ * buffer split into chained calls. Then prints the throughput of each one.
+ *
+ * The GPCRC backend runs against a software model of the peripheral
+ * (stub/em_gpcrc.h, implemented below): LSB first register, input bits reversed per byte, and
+ * DATAREV reversing the low 16 bits in 16-bit mode. The model checks the
+ * reversal of the start value and of the input bytes, and that
+ * btl_i2c_crc16_self_test() notices a wrong bit reversed read: with DATAREV
+ * reversing all 32 bits, the truncated result is wrong, the self test has to
+ * fail and btl_i2c_crc16() has to fall back to the tables. The silicon itself
+ * is only checked by the self test on the target.
+ *
+ * Build, from the project directory:
+ *   cc -O2 -Wall -Wextra -Iinc/communication -Itools/stub \
+ *      -o crc16_bench tools/crc16_bench.c
+ *
+ * Usage:
+ *   ./crc16_bench [buffers]
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BTL_I2C_CRC16_BACKEND       BTL_I2C_CRC16_BACKEND_GPCRC
+#include "../src/btl_i2c_crc16.c"
+
+#define MAX_LENGTH                  260
+#define BENCH_LENGTH                1024
+#define BENCH_BYTES                 (64UL * 1024 * 1024)
+
+typedef uint16_t (*crc_function_t)(const uint8_t *, size_t, uint16_t);
+
+GPCRC_TypeDef sim_gpcrc;
+
+// Width of the bit reversed read of the model, 16 as documented
+static int datarev_width = 16;
+
+// Keeps the benchmarked results alive
+static volatile uint16_t sink;
+
+// -----------------------------------------------------------------------------
+//                           Reference, as it was
+// -----------------------------------------------------------------------------
+
+static uint16_t crc16(const uint8_t newByte, uint16_t prevResult)
+{
+  prevResult = (prevResult >> 8) | (prevResult << 8);
+  prevResult ^= newByte;
+  prevResult ^= (prevResult & 0xFF) >> 4;
+  prevResult ^= (prevResult << 8) << 4;
+
+  prevResult ^= ((uint8_t) ((uint8_t) ((uint8_t) (prevResult & 0xFF)) << 5))
+                | ((uint16_t) ((uint8_t) ((uint8_t) (prevResult & 0xFF))
+                               >> 3) << 8);
+
+  return prevResult;
+}
+
+static uint16_t crc16s(const uint8_t *buffer,
+                       size_t        length,
+                       uint16_t      prevResult)
+{
+  size_t position = 0;
+  for (; position < length; position++) {
+    prevResult = crc16(buffer[position], prevResult);
+  }
+  return prevResult;
+}
+
+// The bootloader core computes the same CRC
+uint16_t btl_crc16Stream(const uint8_t *buffer, size_t length,
+                         uint16_t prevResult)
+{
+  return crc16s(buffer, length, prevResult);
+}
+
+// -----------------------------------------------------------------------------
+//                                GPCRC model
+// -----------------------------------------------------------------------------
+
+void GPCRC_Init(GPCRC_TypeDef *gpcrc, const GPCRC_Init_TypeDef *init)
+{
+  gpcrc->crc16 = (init->crcPoly != 0x04C11DB7UL);
+  gpcrc->POLY = gpcrc->crc16 ? (__RBIT(init->crcPoly) >> 16) : 0xEDB88320UL;
+  gpcrc->INIT = init->initValue;
+  gpcrc->bitReverse = init->reverseBits;
+  gpcrc->byteReverse = init->reverseByteOrder;
+}
+
+void GPCRC_Start(GPCRC_TypeDef *gpcrc)
+{
+  gpcrc->DATA = gpcrc->INIT;
+}
+
+void GPCRC_InputU8(GPCRC_TypeDef *gpcrc, uint8_t data)
+{
+  if (gpcrc->bitReverse) {
+    data = (uint8_t)(__RBIT(data) >> 24);
+  }
+  gpcrc->DATA ^= data;
+  for (int bit = 0; bit < 8; bit++) {
+    gpcrc->DATA = (gpcrc->DATA & 1) ? (gpcrc->DATA >> 1) ^ gpcrc->POLY
+                  : gpcrc->DATA >> 1;
+  }
+  if (gpcrc->crc16) {
+    gpcrc->DATA &= 0xFFFF;
+  }
+}
+
+void GPCRC_InputU32(GPCRC_TypeDef *gpcrc, uint32_t data)
+{
+  for (int byte = 0; byte < 4; byte++) {
+    int shift = gpcrc->byteReverse ? 24 - 8 * byte : 8 * byte;
+    GPCRC_InputU8(gpcrc, (uint8_t)(data >> shift));
+  }
+}
+
+uint32_t GPCRC_DataReadBitReversed(GPCRC_TypeDef *gpcrc)
+{
+  return (datarev_width == 16) ? __RBIT(gpcrc->DATA) >> 16
+         : __RBIT(gpcrc->DATA);
+}
+
+// -----------------------------------------------------------------------------
+//                                   Tests
+// -----------------------------------------------------------------------------
+
+static const struct {
+  const char *name;
+  crc_function_t crc;
+} backends[] = {
+  { "bitwise", btl_i2c_crc16_bitwise },
+  { "table", btl_i2c_crc16_table },
+  { "slice4", btl_i2c_crc16_slice4 },
+  { "gpcrc", btl_i2c_crc16_gpcrc },
+  { "selected", btl_i2c_crc16 },
+};
+#define BACKENDS                    (sizeof(backends) / sizeof(backends[0]))
+
+static uint8_t buffer[MAX_LENGTH + 3];
+
+static void random_fill(uint8_t *data, size_t length)
+{
+  for (size_t i = 0; i < length; i++) {
+    data[i] = (uint8_t)rand();
+  }
+}
+
+/***************************************************************************//**
+ * Count the mismatches of every backend against crc16s(), in one call and in
+ * random chunks. Returns the total.
+ ******************************************************************************/
+static unsigned long compare(unsigned long count, unsigned long *mismatches)
+{
+  unsigned long total = 0;
+
+  for (unsigned long test = 0; test < count; test++) {
+    size_t offset = (size_t)rand() & 3;
+    size_t length = (size_t)rand() % (MAX_LENGTH + 1);
+    uint16_t start = (test & 1) ? (uint16_t)rand() : BTL_I2C_CRC16_START;
+    uint16_t expected;
+
+    random_fill(buffer, sizeof(buffer));
+    expected = crc16s(buffer + offset, length, start);
+
+    for (size_t b = 0; b < BACKENDS; b++) {
+      uint16_t result = start;
+      size_t done = 0;
+
+      if (test & 2) {
+        // Chained calls of random sizes, odd ones included
+        while (done < length) {
+          size_t chunk = 1 + (size_t)rand() % 13;
+          if (chunk > length - done) {
+            chunk = length - done;
+          }
+          result = backends[b].crc(buffer + offset + done, chunk, result);
+          done += chunk;
+        }
+      } else {
+        result = backends[b].crc(buffer + offset, length, start);
+      }
+      if (result != expected) {
+        mismatches[b]++;
+        total++;
+      }
+    }
+  }
+  return total;
+}
+
+/***************************************************************************//**
+ * MB/s of a backend over BENCH_BYTES in BENCH_LENGTH byte buffers.
+ ******************************************************************************/
+static double benchmark(crc_function_t crc)
+{
+  static uint8_t data[BENCH_LENGTH];
+  struct timespec begin, end;
+  uint16_t result = BTL_I2C_CRC16_START;
+
+  random_fill(data, sizeof(data));
+  clock_gettime(CLOCK_MONOTONIC, &begin);
+  for (unsigned long done = 0; done < BENCH_BYTES; done += BENCH_LENGTH) {
+    result = crc(data, BENCH_LENGTH, result);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  sink ^= result;
+  return BENCH_BYTES / 1e6
+         / ((end.tv_sec - begin.tv_sec) + (end.tv_nsec - begin.tv_nsec) / 1e9);
+}
+
+static uint16_t crc16s_buffer(const uint8_t *data, size_t length,
+                              uint16_t prevResult)
+{
+  return crc16s(data, length, prevResult);
+}
+
+int main(int argc, char **argv)
+{
+  unsigned long count = (argc > 1) ? strtoul(argv[1], NULL, 0) : 200000;
+  unsigned long mismatches[BACKENDS] = { 0 };
+  unsigned long total;
+  bool failed = false, selfTest;
+  double reference;
+
+  srand(1);
+
+  // The reference itself, against the CRC-16/CCITT-FALSE check value
+  if (crc16s((const uint8_t *)"123456789", 9, BTL_I2C_CRC16_START) != 0x29B1) {
+    printf("reference check value wrong\n");
+    return 1;
+  }
+
+  selfTest = btl_i2c_crc16_self_test();
+  total = compare(count, mismatches);
+  printf("%lu buffers of 0 to %d bytes, GPCRC self test %s\n\n", count,
+         MAX_LENGTH, selfTest ? "passed" : "failed");
+  printf("%-10s %10s %10s %10s\n", "backend", "mismatches", "MB/s", "speedup");
+  reference = benchmark(crc16s_buffer);
+  printf("%-10s %10s %10.1f %9.2fx\n", "crc16s", "-", reference, 1.0);
+  for (size_t b = 0; b < BACKENDS; b++) {
+    if (backends[b].crc == btl_i2c_crc16_gpcrc
+        || backends[b].crc == btl_i2c_crc16) {
+      // The speed of the model says nothing about the peripheral
+      printf("%-10s %10lu %10s %10s\n", backends[b].name, mismatches[b],
+             "model", "-");
+      continue;
+    }
+    double rate = benchmark(backends[b].crc);
+    printf("%-10s %10lu %10.1f %9.2fx\n", backends[b].name, mismatches[b],
+           rate, rate / reference);
+  }
+  failed = !selfTest || (total != 0);
+
+  // A bit reversed read of all 32 bits puts the CRC in the upper half
+  datarev_width = 32;
+  memset(mismatches, 0, sizeof(mismatches));
+  selfTest = btl_i2c_crc16_self_test();
+  compare(count / 10, mismatches);
+  printf("\nwith a 32-bit DATAREV: GPCRC self test %s, gpcrc mismatches %lu, "
+         "selected mismatches %lu\n", selfTest ? "passed" : "failed",
+         mismatches[3], mismatches[4]);
+  if (selfTest || (mismatches[3] == 0) || (mismatches[4] != 0)) {
+    failed = true;
+  }
+
+  printf("%s\n", failed ? "FAIL" : "PASS");
+  return failed ? 1 : 0;
+}
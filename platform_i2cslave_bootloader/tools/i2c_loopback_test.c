@@ -0,0 +1,496 @@
+/***************************************************************************//**
+ * @file
+ * @brief Loopback test of the i2ctester download against a simulated slave
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ *******************************************************************************
+ *
+ * Runs download_gbl_file() of the i2ctester against a simulated bootloader,
+ * with ioctl() and usleep() of i2c-protocol.c redirected to the simulation.
+ * The slave follows btl_i2c_communication.c and btl_i2c_slave_driver.c: the
+ * interrupt level commands are answered at once, the other messages are
+ * parsed by the communication main one after the other, and a read beyond
+ * the transmit queue returns 0xFF bytes.
+ *
+ * The time is simulated: the I2C bus time of every transfer, the sleeps of
+ * the master, and an assumed parse time per frame on the slave. The
+ * effective KB/s is the image size over the simulated download time.
+ *
+ * Build, from the project directory:
+ *   cc -O2 -Wall -Wextra -Ii2ctester_Rpi3/include -Iinc/communication \
+ *      -Dioctl=sim_ioctl -Dusleep=sim_usleep -o i2c_loopback_test \
+ *      tools/i2c_loopback_test.c i2ctester_Rpi3/src/i2c-protocol.c \
+ *      src/btl_i2c_crc16.c
+ *
+ * Usage:
+ *   ./i2c_loopback_test [image bytes] [I2C clock in Hz]
+ ******************************************************************************/
+#include <fcntl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "btl_i2c_communication.h"
+#include "btl_i2c_crc16.h"
+#include "i2c-protocol-prototypes.h"
+
+#define SLAVE_ADDRESS           0x50
+#define MAX_IMAGE_SIZE          (1024 * 1024)
+
+/// message buffer of the bootloaders before the windowed download
+#define OLD_MESSAGE_SIZE \
+  (BOOT_MAX_DOWNLOAD_FRAME_DATA_LENGTH + BOOT_DOWNLOAD_FRAME_HEADER_SIZE)
+#define MAX_BUFFERS             BOOT_DOWNLOAD_WINDOW_SIZE
+
+/// assumed slave times: GBL parsing and flash programming of a frame, and
+/// any other message
+#define PARSE_FRAME_NS          150000ULL
+#define PARSE_BYTE_NS           3000ULL
+#define COMMAND_NS              20000ULL
+
+/// every CORRUPT_PERIOD-th frame is received with a bad CRC, once
+#define CORRUPT_PERIOD          50
+
+typedef struct {
+  const char *name;
+  /// bootloader version, windowed download from 0.3
+  uint16_t major;
+  uint16_t minor;
+  /// answers BOOT_GET_CAPABILITIES from an empty transmit queue
+  bool noCapabilities;
+  bool corrupt;
+  /// expected master behaviour
+  bool expectWindowed;
+} scenario_t;
+
+typedef struct {
+  const scenario_t *scenario;
+  bool windowed;
+  uint8_t buffers;
+  // received messages, as message[] / message_in / message_out
+  uint8_t message[MAX_BUFFERS][256];
+  uint8_t length[MAX_BUFFERS];
+  uint64_t arrival[MAX_BUFFERS];
+  uint8_t in;
+  uint8_t out;
+  uint64_t mainFree;
+  // download state
+  bool downloading;
+  uint8_t status;
+  uint16_t nextSequence;
+  uint16_t acked;
+  uint8_t processed;
+  uint8_t dropped;
+  // transmit queue
+  uint8_t tx[8];
+  uint8_t txLength;
+  uint8_t txIndex;
+  // results
+  uint8_t image[MAX_IMAGE_SIZE];
+  uint32_t imageLength;
+  uint32_t framesReceived;
+  uint32_t framesRejected;
+  uint32_t largestFrame;
+  uint32_t statusReads;
+  uint32_t overruns;
+  uint32_t ignored;
+  bool corrupted[65536];
+} slave_t;
+
+static const scenario_t scenarios[] = {
+  { "bootloader 0.2.1", 0, 2, false, false, false },
+  { "bootloader 0.3.0", 0, 3, false, false, true },
+  { "0.3.0, bad CRC every 50 frames", 0, 3, false, true, true },
+  { "0.3.0, no capabilities", 0, 3, true, false, false },
+};
+
+static slave_t slave;
+static uint64_t simNs;
+static uint32_t i2cHz = 400000;
+static uint8_t original[MAX_IMAGE_SIZE];
+
+/***************************************************************************//**
+ * Bus time of a number of bytes, with the address byte, start and stop.
+ ******************************************************************************/
+static uint64_t bus_ns(uint32_t bytes)
+{
+  return ((uint64_t)(bytes + 1) * 9 + 2) * 1000000000ULL / i2cHz;
+}
+
+/***************************************************************************//**
+ * Time the communication main spends on a message.
+ ******************************************************************************/
+static uint64_t message_ns(const uint8_t *message, uint8_t length)
+{
+  if (slave.downloading && (message[0] == BOOT_DOWNLOAD_FRAME)) {
+    return PARSE_FRAME_NS + PARSE_BYTE_NS * length;
+  }
+  return COMMAND_NS;
+}
+
+/***************************************************************************//**
+ * Check a download frame as check_frame() does.
+ ******************************************************************************/
+static uint8_t frame_check(i2c_download_frame_data_t *frame, uint8_t length)
+{
+  uint16_t crc16 = frame->frame.crc16;
+  uint16_t computed;
+
+  if ((length < BOOT_DOWNLOAD_FRAME_HEADER_SIZE)
+      || (frame->frame.length != length)) {
+    return BOOT_REPLY_ERR_LENGTH;
+  }
+  frame->frame.crc16 = 0;
+  computed = btl_i2c_crc16_bitwise(frame->bytes, length, BTL_I2C_CRC16_START);
+  frame->frame.crc16 = crc16;
+  return (computed == crc16) ? BOOT_REPLY_OK : BOOT_REPLY_ERR_CRC;
+}
+
+/***************************************************************************//**
+ * The communication main is done with a message.
+ ******************************************************************************/
+static void message_done(uint8_t *message, uint8_t length)
+{
+  i2c_download_frame_data_t *frame = (i2c_download_frame_data_t *)message;
+  uint8_t status;
+  uint32_t dataLength;
+
+  if (!slave.downloading) {
+    if (message[0] == BOOT_GBL_DOWNLOAD) {
+      slave.downloading = true;
+      slave.nextSequence = 1;
+      slave.acked = 0;
+      slave.processed = 0;
+      slave.dropped = 0;
+      slave.imageLength = 0;
+      slave.status = BOOT_REPLY_OK;
+    }
+    // other messages are not supported, the status stays pending
+    return;
+  }
+
+  switch (message[0]) {
+    case BOOT_DOWNLOAD_FRAME:
+      slave.processed++;
+      status = frame_check(frame, length);
+      if ((status == BOOT_REPLY_OK)
+          && (frame->frame.frame_seq_nr != slave.nextSequence)) {
+        status = BOOT_REPLY_ERR_FRAME_SEQUENCE;
+      }
+      if (status != BOOT_REPLY_OK) {
+        slave.framesRejected++;
+        slave.status = status;
+        break;
+      }
+      dataLength = length - BOOT_DOWNLOAD_FRAME_HEADER_SIZE;
+      if (slave.imageLength + dataLength > MAX_IMAGE_SIZE) {
+        slave.status = BOOT_REPLY_ERR_PARSE;
+        break;
+      }
+      memcpy(&slave.image[slave.imageLength], frame->frame.frame_data,
+             dataLength);
+      slave.imageLength += dataLength;
+      slave.nextSequence++;
+      slave.acked = frame->frame.frame_seq_nr;
+      // keep pending if the next frame has already arrived
+      if (!slave.windowed || ((uint8_t)(slave.in - slave.out) == 1)) {
+        slave.status = BOOT_REPLY_OK;
+      }
+      break;
+    case BOOT_DOWNLOAD_COMPLETE:
+      // the parser would find the image complete and verified
+      slave.status = BOOT_REPLY_OK;
+      slave.downloading = false;
+      break;
+    default:
+      slave.status = BOOT_REPLY_ERR_UNKNOWN;
+      break;
+  }
+}
+
+/***************************************************************************//**
+ * Run the communication main up to the current time.
+ ******************************************************************************/
+static void slave_advance(void)
+{
+  uint8_t index;
+  uint64_t start, end;
+
+  while (slave.in != slave.out) {
+    index = slave.out % slave.buffers;
+    start = (slave.arrival[index] > slave.mainFree)
+            ? slave.arrival[index] : slave.mainFree;
+    end = start + message_ns(slave.message[index], slave.length[index]);
+    if (end > simNs) {
+      return;
+    }
+    message_done(slave.message[index], slave.length[index]);
+    slave.mainFree = end;
+    slave.out++;
+  }
+}
+
+/***************************************************************************//**
+ * Queue a reply of the interrupt level commands.
+ ******************************************************************************/
+static void tx_set(const void *reply, uint8_t length)
+{
+  memcpy(slave.tx, reply, length);
+  slave.txLength = length;
+  slave.txIndex = 0;
+}
+
+/***************************************************************************//**
+ * A message written by the master, at the stop or the repeated start.
+ ******************************************************************************/
+static void slave_receive(const uint8_t *bytes, uint16_t length)
+{
+  btl_version_info_t version = {
+    .boot_version = { slave.scenario->major, slave.scenario->minor, 0 }
+  };
+  boot_capabilities_t capabilities = {
+    .max_frame_data_length = BOOT_MAX_NEGOTIATED_FRAME_DATA_LENGTH,
+    .window_size = BOOT_DOWNLOAD_WINDOW_SIZE
+  };
+  boot_download_status_t downloadStatus;
+  uint8_t index;
+
+  slave_advance();
+  slave.txLength = 0;
+
+  // interrupt level commands
+  switch (bytes[0]) {
+    case BOOT_ABORT_OPERATION:
+      slave.downloading = false;
+      return;
+    case BOOT_GET_LAST_CMD_STATUS:
+      tx_set(&slave.status, 1);
+      return;
+    case BOOT_VERSION:
+      tx_set(&version, sizeof(version));
+      return;
+    case BOOT_GET_CAPABILITIES:
+      if (slave.windowed && !slave.scenario->noCapabilities) {
+        tx_set(&capabilities, sizeof(capabilities));
+        return;
+      }
+      break;
+    case BOOT_GET_DOWNLOAD_STATUS:
+      if (slave.windowed) {
+        downloadStatus.status = slave.status;
+        downloadStatus.frame_count = slave.processed + slave.dropped;
+        downloadStatus.acked_seq_nr = slave.acked;
+        tx_set(&downloadStatus, sizeof(downloadStatus));
+        slave.statusReads++;
+        return;
+      }
+      break;
+    default:
+      break;
+  }
+
+  // messages for the communication main
+  if (bytes[0] == BOOT_DOWNLOAD_FRAME) {
+    slave.framesReceived++;
+    if (length - BOOT_DOWNLOAD_FRAME_HEADER_SIZE > slave.largestFrame) {
+      slave.largestFrame = length - BOOT_DOWNLOAD_FRAME_HEADER_SIZE;
+    }
+  }
+  if ((uint8_t)(slave.in - slave.out) == slave.buffers) {
+    if (slave.windowed) {
+      if (bytes[0] == BOOT_DOWNLOAD_FRAME) {
+        slave.dropped++;
+      }
+      slave.status = BOOT_REPLY_ERR_OVERFLOW;
+    } else {
+      // left in the receive queue by the previous bootloaders
+      slave.ignored++;
+    }
+    return;
+  }
+  if (!slave.windowed && (length > OLD_MESSAGE_SIZE)) {
+    // beyond message[] of the previous bootloaders
+    slave.overruns++;
+    length = OLD_MESSAGE_SIZE;
+  }
+  index = slave.in % slave.buffers;
+  memcpy(slave.message[index], bytes, length);
+  slave.length[index] = (uint8_t)length;
+  slave.arrival[index] = simNs;
+  if (slave.scenario->corrupt && (bytes[0] == BOOT_DOWNLOAD_FRAME)
+      && slave.downloading) {
+    i2c_download_frame_t *frame = (i2c_download_frame_t *)slave.message[index];
+
+    if (((frame->frame_seq_nr % CORRUPT_PERIOD) == 0)
+        && !slave.corrupted[frame->frame_seq_nr]) {
+      slave.corrupted[frame->frame_seq_nr] = true;
+      slave.message[index][length - 1] ^= 0x5A;
+    }
+  }
+  slave.status = BOOT_REPLY_PENDING;
+  slave.in++;
+}
+
+/***************************************************************************//**
+ * ioctl() of i2c-protocol.c: I2C_RDWR transfers with the simulated slave.
+ ******************************************************************************/
+int sim_ioctl(int fd, unsigned long request, ...)
+{
+  struct i2c_rdwr_ioctl_data *transfer;
+  struct i2c_msg *msg;
+  va_list args;
+
+  (void)fd;
+  if (request != I2C_RDWR) {
+    return -1;
+  }
+  va_start(args, request);
+  transfer = va_arg(args, struct i2c_rdwr_ioctl_data *);
+  va_end(args);
+
+  for (uint32_t i = 0; i < transfer->nmsgs; i++) {
+    msg = &transfer->msgs[i];
+    simNs += bus_ns(msg->len);
+    if (msg->flags & I2C_M_RD) {
+      // an empty transmit queue is read as 0xFF
+      for (uint32_t k = 0; k < msg->len; k++) {
+        msg->buf[k] = (slave.txIndex < slave.txLength)
+                      ? slave.tx[slave.txIndex++] : 0xFF;
+      }
+    } else if (msg->len > 0) {
+      slave_receive(msg->buf, msg->len);
+    }
+  }
+  return (int)transfer->nmsgs;
+}
+
+/***************************************************************************//**
+ * usleep() of i2c-protocol.c: the time goes on, the slave works meanwhile.
+ ******************************************************************************/
+int sim_usleep(useconds_t us)
+{
+  simNs += (uint64_t)us * 1000;
+  slave_advance();
+  return 0;
+}
+
+/***************************************************************************//**
+ * Download an image to the slave of a scenario and report.
+ ******************************************************************************/
+static bool scenario_run(const scenario_t *scenario, const char *path,
+                         uint32_t size)
+{
+  int savedStderr, nullFd;
+  int result;
+  bool windowed, ok;
+  double seconds;
+
+  memset(&slave, 0, sizeof(slave));
+  slave.scenario = scenario;
+  slave.windowed = (scenario->major > BOOT_WINDOWED_VERSION_MAJOR)
+                   || ((scenario->major == BOOT_WINDOWED_VERSION_MAJOR)
+                       && (scenario->minor >= BOOT_WINDOWED_VERSION_MINOR));
+  slave.buffers = slave.windowed ? BOOT_DOWNLOAD_WINDOW_SIZE : 1;
+  simNs = 0;
+
+  // the progress of download_gbl_file() is not wanted here
+  fflush(stderr);
+  savedStderr = dup(STDERR_FILENO);
+  nullFd = open("/dev/null", O_WRONLY);
+  dup2(nullFd, STDERR_FILENO);
+  result = download_gbl_file(3, SLAVE_ADDRESS, path);
+  dup2(savedStderr, STDERR_FILENO);
+  close(savedStderr);
+  close(nullFd);
+
+  windowed = slave.statusReads > 0;
+  seconds = simNs / 1e9;
+  ok = (result == 0) && (slave.imageLength == size)
+       && (memcmp(slave.image, original, size) == 0)
+       && (slave.overruns == 0) && (slave.ignored == 0)
+       && (windowed == scenario->expectWindowed);
+
+  printf("%-32s %-13s %5u %8.1f %7u %7u %5u  %s\n", scenario->name,
+         windowed ? "windowed" : "stop-and-wait", slave.largestFrame,
+         size / 1024.0 / seconds, slave.framesReceived, slave.framesRejected,
+         slave.overruns, ok ? "ok" : "FAIL");
+  if (!ok) {
+    printf("  result %d, %u of %u bytes received\n", result,
+           slave.imageLength, size);
+  }
+  return ok;
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t size = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 65536;
+  char path[] = "/tmp/i2c_loopback_XXXXXX";
+  uint32_t failures = 0;
+  int fd;
+
+  if (argc > 2) {
+    i2cHz = (uint32_t)strtoul(argv[2], NULL, 0);
+  }
+  if ((size == 0) || (size > MAX_IMAGE_SIZE) || (i2cHz == 0) || (argc > 3)) {
+    fprintf(stderr, "usage: %s [image bytes] [I2C clock in Hz]\n", argv[0]);
+    return 2;
+  }
+
+  srand(1);
+  for (uint32_t i = 0; i < size; i++) {
+    original[i] = (uint8_t)rand();
+  }
+  fd = mkstemp(path);
+  if ((fd < 0) || (write(fd, original, size) != (ssize_t)size)) {
+    fprintf(stderr, "cannot write %s\n", path);
+    return 1;
+  }
+  close(fd);
+
+  printf("%u byte image, I2C at %u Hz\n\n", size, i2cHz);
+  printf("%-32s %-13s %5s %8s %7s %7s %5s\n", "slave", "download", "frame",
+         "KB/s", "frames", "errors", "overr");
+  for (uint32_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+    if (!scenario_run(&scenarios[i], path, size)) {
+      failures++;
+    }
+  }
+  unlink(path);
+  return failures ? 1 : 0;
+}
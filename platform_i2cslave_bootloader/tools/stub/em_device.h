@@ -0,0 +1,68 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for em_device.h, for the GPCRC model of crc16_bench.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef EM_DEVICE_H
+#define EM_DEVICE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Reverses the bits of a word, like the RBIT instruction
+static inline uint32_t __RBIT(uint32_t value)
+{
+  uint32_t result = 0;
+
+  for (int bit = 0; bit < 32; bit++) {
+    result = (result << 1) | (value & 1);
+    value >>= 1;
+  }
+  return result;
+}
+
+/// Registers of the GPCRC model, implemented in ../crc16_bench.c
+typedef struct {
+  uint32_t POLY;            ///< polynomial, LSB first
+  uint32_t INIT;            ///< start value, LSB first
+  uint32_t DATA;            ///< CRC register, LSB first
+  bool bitReverse;          ///< reverse the bits of every input byte
+  bool byteReverse;         ///< feed the bytes of a word MSB first
+  bool crc16;               ///< 16-bit polynomial, not the CRC-32 one
+} GPCRC_TypeDef;
+
+extern GPCRC_TypeDef sim_gpcrc;
+#define GPCRC                       (&sim_gpcrc)
+
+#endif // EM_DEVICE_H
@@ -0,0 +1,66 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for em_gpcrc.h, implemented in ../crc16_bench.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef EM_GPCRC_H
+#define EM_GPCRC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "em_device.h"
+
+typedef struct {
+  uint32_t crcPoly;
+  uint32_t initValue;
+  bool reverseByteOrder;
+  bool reverseBits;
+  bool enableByteMode;
+  bool autoInit;
+  bool enable;
+} GPCRC_Init_TypeDef;
+
+#define GPCRC_INIT_DEFAULT                                           \
+  {                                                                  \
+    0x04C11DB7UL, 0x00000000UL, false, false, false, false, true,    \
+  }
+
+void GPCRC_Init(GPCRC_TypeDef *gpcrc, const GPCRC_Init_TypeDef *init);
+void GPCRC_Start(GPCRC_TypeDef *gpcrc);
+void GPCRC_InputU8(GPCRC_TypeDef *gpcrc, uint8_t data);
+void GPCRC_InputU32(GPCRC_TypeDef *gpcrc, uint32_t data);
+uint32_t GPCRC_DataReadBitReversed(GPCRC_TypeDef *gpcrc);
+
+#endif // EM_GPCRC_H
@@ -0,0 +1,195 @@
+/***************************************************************************//**
+ * @file
+ * @brief Integer IADC statistics, CIC/FIR decimation and Allan deviation
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef IADC_STATS_H
+#define IADC_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+// Width of the two's complement IADC results
+#ifndef IADC_STATS_RESULT_BITS
+#define IADC_STATS_RESULT_BITS     20
+#endif
+
+// Fractional bits of means and variances
+#define IADC_STATS_FRAC_BITS       16
+
+// Samples an accumulator takes, so that the sum of squares of full-scale
+// swings fits 64 bits
+#define IADC_STATS_MAX_COUNT       (1UL << (63 - 2 * IADC_STATS_RESULT_BITS))
+
+// Fractional bits of the decimated samples
+#define IADC_DECIM_FRAC_BITS       8
+
+// Largest CIC order and FIR length
+#define IADC_DECIM_MAX_ORDER       4
+#define IADC_DECIM_MAX_TAPS        64
+
+// Averaging times of the Allan deviation, 1, 2, 4... samples
+#define IADC_ALLAN_LEVELS          16
+
+/*******************************************************************************
+ *******************************   TYPEDEFS   **********************************
+ ******************************************************************************/
+
+// Exact sums of results. Deviations from the first result are summed, which
+// keeps the sums small when the input is steady.
+typedef struct {
+  uint32_t count;
+  int32_t reference;        // First result
+  int64_t sum;              // Sum of deviations
+  uint64_t sumSquares;      // Sum of squared deviations
+  int32_t min;
+  int32_t max;
+} iadc_stats_acc_t;
+
+// Decimation: a CIC filter of cicOrder stages decimating by cicRatio, then
+// an optional FIR filter decimating by firRatio
+typedef struct {
+  uint32_t cicOrder;        // 1 to IADC_DECIM_MAX_ORDER
+  uint32_t cicRatio;        // At least 1
+  const int16_t *firTaps;   // Q15 taps, NULL for no FIR stage
+  uint32_t firLength;       // Up to IADC_DECIM_MAX_TAPS
+  uint32_t firRatio;        // At least 1
+} iadc_decim_config_t;
+
+// Decimator state
+typedef struct {
+  iadc_decim_config_t config;
+  int64_t cicGain;          // cicRatio ^ cicOrder
+  uint64_t integrator[IADC_DECIM_MAX_ORDER];
+  uint64_t comb[IADC_DECIM_MAX_ORDER];
+  uint32_t cicPhase;
+  int32_t history[IADC_DECIM_MAX_TAPS];
+  uint32_t historyIndex;
+  uint32_t firPhase;
+} iadc_decim_t;
+
+// Non-overlapping Allan variance at averaging times of 2^level samples. Each
+// level keeps sums of 2^level samples, pairs of them make the next level.
+typedef struct {
+  int64_t pending[IADC_ALLAN_LEVELS];   // First sum of a pair
+  int64_t previous[IADC_ALLAN_LEVELS];  // Last sum
+  uint32_t hasPending;                  // Bit per level
+  uint32_t hasPrevious;                 // Bit per level
+  float sumSquares[IADC_ALLAN_LEVELS];  // Squared differences of averages
+  uint32_t count[IADC_ALLAN_LEVELS];
+} iadc_allan_t;
+
+/*******************************************************************************
+ *****************************   PROTOTYPES   **********************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Sign extend a result of IADC_STATS_RESULT_BITS bits.
+ ******************************************************************************/
+int32_t iadc_stats_sign_extend(uint32_t result);
+
+/***************************************************************************//**
+ * Empty an accumulator.
+ ******************************************************************************/
+void iadc_stats_acc_reset(iadc_stats_acc_t *acc);
+
+/***************************************************************************//**
+ * Add results to an accumulator.
+ *
+ * @param[in] acc Accumulator.
+ * @param[in] results Raw IADC results.
+ * @param[in] count Number of results.
+ *
+ * @return False, and nothing added, if IADC_STATS_MAX_COUNT would be
+ *   exceeded.
+ ******************************************************************************/
+bool iadc_stats_acc_add(iadc_stats_acc_t *acc,
+                        const uint32_t *results,
+                        uint32_t count);
+
+/***************************************************************************//**
+ * Mean of the results, in LSB with IADC_STATS_FRAC_BITS fractional bits,
+ * rounded to nearest. Exact when the count is a power of two no larger than
+ * 2^IADC_STATS_FRAC_BITS.
+ ******************************************************************************/
+int64_t iadc_stats_mean(const iadc_stats_acc_t *acc);
+
+/***************************************************************************//**
+ * Sample variance of the results, in LSB^2 with IADC_STATS_FRAC_BITS
+ * fractional bits, rounded down. 0 for less than two results.
+ ******************************************************************************/
+uint64_t iadc_stats_variance(const iadc_stats_acc_t *acc);
+
+/***************************************************************************//**
+ * Noise density of white noise of a given variance.
+ *
+ * @param[in] variance From iadc_stats_variance().
+ * @param[in] sampleRateHz Sample rate.
+ * @param[in] lsbVolts Size of an LSB.
+ *
+ * @return Noise density in V/sqrt(Hz).
+ ******************************************************************************/
+float iadc_stats_noise_density(uint64_t variance,
+                               float sampleRateHz,
+                               float lsbVolts);
+
+/***************************************************************************//**
+ * Start a decimator.
+ *
+ * @return False if the configuration is out of range, the CIC gain must stay
+ *   below 2^(63 - IADC_DECIM_FRAC_BITS - IADC_STATS_RESULT_BITS).
+ ******************************************************************************/
+bool iadc_decim_init(iadc_decim_t *decim, const iadc_decim_config_t *config);
+
+/***************************************************************************//**
+ * Run raw IADC results through a decimator.
+ *
+ * @param[in] decim Decimator.
+ * @param[in] results Raw IADC results.
+ * @param[in] count Number of results.
+ * @param[out] output Decimated samples, in LSB with IADC_DECIM_FRAC_BITS
+ *   fractional bits. Room for count / (cicRatio * firRatio) + 1 of them.
+ *
+ * @return Number of decimated samples.
+ ******************************************************************************/
+uint32_t iadc_decim_run(iadc_decim_t *decim,
+                        const uint32_t *results,
+                        uint32_t count,
+                        int32_t *output);
+
+/***************************************************************************//**
+ * Empty an Allan deviation estimator.
+ ******************************************************************************/
+void iadc_allan_reset(iadc_allan_t *allan);
+
+/***************************************************************************//**
+ * Add decimated samples to an Allan deviation estimator.
+ ******************************************************************************/
+void iadc_allan_add(iadc_allan_t *allan,
+                    const int32_t *samples,
+                    uint32_t count);
+
+/***************************************************************************//**
+ * Allan deviation at an averaging time of 2^level samples, in LSB.
+ *
+ * @return 0 until two averages of the level are complete.
+ ******************************************************************************/
+float iadc_allan_deviation(const iadc_allan_t *allan, uint32_t level);
+
+#endif // IADC_STATS_H
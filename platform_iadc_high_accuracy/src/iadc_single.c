@@ -17,12 +17,14 @@
 
 #include <stdio.h>
 #include "em_cmu.h"
+#include "em_core.h"
 #include "em_emu.h"
 #include "em_iadc.h"
 #include "em_ldma.h"
 #include "em_gpio.h"
 #include "em_prs.h"
 #include "iadc_single.h"
+#include "iadc_stats.h"
 
 /*******************************************************************************
  *******************************   DEFINES   ***********************************
@@ -40,6 +42,21 @@
 #define CLK_ADC_FREQ               5000000 // CLK_ADC - 5MHz max in hiacc mode
 // This corresponds to a sample rate of ~3.8kSps with OSR = 256 and DIGAVG = 2
 
+// CLK_ADC cycles per conversion, see initIADC()
+#define CONVERSION_CYCLES          1287
+#define SAMPLE_RATE_HZ             ((float)CLK_ADC_FREQ / CONVERSION_CYCLES)
+
+// 20 bits over the 5.0V full scale differential range
+#define LSB_VOLTS                  (5.0f / 1048576)
+
+// Decimation: a 3rd order CIC filter decimating by 16, then a FIR low pass
+// decimating by 2, ~121 Sps out
+#define DECIM_CIC_ORDER            3
+#define DECIM_CIC_RATIO            16
+#define DECIM_FIR_RATIO            2
+#define DECIM_SAMPLES              (NUM_SAMPLES / (DECIM_CIC_RATIO        \
+                                                   * DECIM_FIR_RATIO) + 1)
+
 /*
  * Specify the IADC input using the IADC_PosInput_t typedef.  This
  * must be paired with a corresponding macro definition that allocates
@@ -84,13 +101,31 @@ uint32_t singleBuffer2[NUM_SAMPLES];
 // used to toggle which buffer to perform statistical analysis;
 uint32_t *dataBuffer = singleBuffer2;
 
-double meanV = 0.0;
+// Results of the most recent buffer, to be watched in the debugger
+int32_t meanUv = 0;                         // Mean input, uV
+float noiseDensityNv = 0.0f;                // Input noise, nV/sqrt(Hz)
+int32_t decimatedUv = 0;                    // Last decimated sample, uV
+
+// Allan deviation of the decimated samples in nV, at averaging times of
+// 2^index decimated samples
+float allanDeviationNv[IADC_ALLAN_LEVELS];
 
 /*******************************************************************************
  ***************************  LOCAL VARIABLES   ********************************
  ******************************************************************************/
 
-bool ldma_done = false;
+volatile bool ldma_done = false;
+
+// Windowed sinc low pass with its cutoff at half the FIR output Nyquist
+// frequency, Q15, unity DC gain
+static const int16_t firTaps[] = {
+  -56, 0, 96, 0, -221, 0, 462, 0, -878, 0, 1609, 0, -3176, 0, 10342, 16412,
+  10342, 0, -3176, 0, 1609, 0, -878, 0, 462, 0, -221, 0, 96, 0, -56
+};
+
+static iadc_decim_t decim;
+static iadc_allan_t allan;
+static int32_t decimated[DECIM_SAMPLES];
 
 /**************************************************************************//**
  * @brief  GPIO Initializer
@@ -279,23 +314,29 @@ void LDMA_IRQHandler(void)
 }
 
 /***************************************************************************//**
- * @brief   Computes mean and variance of data set using Welford's algorithm
+ * @brief   Start the decimation and the Allan deviation
  ******************************************************************************/
-void statsWelford(uint32_t *buffer, uint32_t size, double *mean, double *var)
+void initStats(void)
 {
-  uint32_t cnt;
-  double M, M2, delta1, delta2;
-
-  M = 0;
-  M2 = 0;
-  for (cnt = 1; cnt <= size; cnt++) {
-    delta1 = buffer[cnt - 1] - M;
-    M += delta1 / cnt;
-    delta2 = buffer[cnt - 1] - M;
-    M2 += delta1 * delta2;
-  }
-  *mean = M;
-  *var = M2 / (size - 1);
+  iadc_decim_config_t config = {
+    .cicOrder = DECIM_CIC_ORDER,
+    .cicRatio = DECIM_CIC_RATIO,
+    .firTaps = firTaps,
+    .firLength = sizeof(firTaps) / sizeof(firTaps[0]),
+    .firRatio = DECIM_FIR_RATIO,
+  };
+
+  iadc_decim_init(&decim, &config);
+  iadc_allan_reset(&allan);
+}
+
+/***************************************************************************//**
+ * @brief   Convert a value in LSB with fracBits fractional bits to uV
+ ******************************************************************************/
+static int32_t toMicroVolts(int64_t value, uint32_t fracBits)
+{
+  // 5.0V full scale over 2^20 LSB
+  return (int32_t)((value * 5000000) / (1LL << (20 + fracBits)));
 }
 
 /***************************************************************************//**
@@ -315,6 +356,9 @@ void iadc_single_init(void)
   // Initialize the IADC
   initIADC();
 
+  // Initialize the statistics
+  initStats();
+
   // Initialize LDMA
   initLDMA(singleBuffer1, singleBuffer2, NUM_SAMPLES);
 
@@ -327,19 +371,46 @@ void iadc_single_init(void)
  ******************************************************************************/
 void iadc_single_process_action(void)
 {
-  double mean, variance;
+  iadc_stats_acc_t acc;
+  uint64_t variance;
+  uint32_t count;
+  CORE_DECLARE_IRQ_STATE;
 
   if (ldma_done == true) {
-    // Process most recent buffer
-    statsWelford(dataBuffer, NUM_SAMPLES, &mean, &variance);
+    ldma_done = false;
+
+    // Process most recent buffer. The sums are exact integers, there is no
+    // double precision arithmetic per sample.
+    iadc_stats_acc_reset(&acc);
+    iadc_stats_acc_add(&acc, dataBuffer, NUM_SAMPLES);
+    variance = iadc_stats_variance(&acc);
 
     // Calculate input voltage:
     // For differential inputs, the resultant range is from -Vref to +Vref,
     //   i.e.,
     // with analog gain = 0.5 and Vref = 1.25V, 20 bits represents
     // 5.0V full scale IADC range (-2.5 <-> +2.5).
-    meanV = mean * 5 / 1048576;
+    meanUv = toMicroVolts(iadc_stats_mean(&acc), IADC_STATS_FRAC_BITS);
+    noiseDensityNv = iadc_stats_noise_density(variance, SAMPLE_RATE_HZ,
+                                              LSB_VOLTS) * 1e9f;
+
+    // The decimated samples carry on across buffers, and so does the Allan
+    // deviation computed from them
+    count = iadc_decim_run(&decim, dataBuffer, NUM_SAMPLES, decimated);
+    if (count > 0) {
+      decimatedUv = toMicroVolts(decimated[count - 1], IADC_DECIM_FRAC_BITS);
+      iadc_allan_add(&allan, decimated, count);
+      for (uint32_t level = 0; level < IADC_ALLAN_LEVELS; level++) {
+        allanDeviationNv[level] = iadc_allan_deviation(&allan, level)
+                                  * LSB_VOLTS * 1e9f;
+      }
+    }
+  }
 
-    ldma_done = false;
+  // Sleep until the next buffer is complete
+  CORE_ENTER_CRITICAL();
+  if (!ldma_done) {
+    EMU_EnterEM1();
   }
+  CORE_EXIT_CRITICAL();
 }
@@ -0,0 +1,361 @@
+/***************************************************************************//**
+ * @file
+ * @brief Integer IADC statistics, CIC/FIR decimation and Allan deviation
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <math.h>
+#include <string.h>
+
+#include "iadc_stats.h"
+
+#define RESULT_SIGN     (1UL << (IADC_STATS_RESULT_BITS - 1))
+#define RESULT_MASK     ((RESULT_SIGN << 1) - 1)
+
+// Largest CIC gain, so that a full-scale output scaled to the decimated
+// format fits 63 bits
+#define CIC_GAIN_LIMIT  (1ULL << (63 - IADC_DECIM_FRAC_BITS               \
+                                  - IADC_STATS_RESULT_BITS))
+
+// Unsigned 128-bit value, for the exact variance numerator
+typedef struct {
+  uint64_t high;
+  uint64_t low;
+} u128_t;
+
+/*******************************************************************************
+ ***************************   LOCAL FUNCTIONS   *******************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Divide rounding to nearest, halves away from zero. divisor > 0.
+ ******************************************************************************/
+static int64_t div_round(int64_t dividend, int64_t divisor)
+{
+  if (dividend >= 0) {
+    return (dividend + divisor / 2) / divisor;
+  }
+  return -((-dividend + divisor / 2) / divisor);
+}
+
+/***************************************************************************//**
+ * Full 128-bit product of two 64-bit values.
+ ******************************************************************************/
+static u128_t mul_64(uint64_t a, uint64_t b)
+{
+  uint64_t aLow = (uint32_t)a, aHigh = a >> 32;
+  uint64_t bLow = (uint32_t)b, bHigh = b >> 32;
+  uint64_t lowLow = aLow * bLow;
+  uint64_t highLow = aHigh * bLow;
+  uint64_t lowHigh = aLow * bHigh;
+  uint64_t middle = (lowLow >> 32) + (uint32_t)highLow + (uint32_t)lowHigh;
+  u128_t product;
+
+  product.low = (middle << 32) | (uint32_t)lowLow;
+  product.high = aHigh * bHigh + (highLow >> 32) + (lowHigh >> 32)
+                 + (middle >> 32);
+  return product;
+}
+
+/***************************************************************************//**
+ * a - b, with a >= b.
+ ******************************************************************************/
+static u128_t sub_128(u128_t a, u128_t b)
+{
+  u128_t difference;
+
+  difference.low = a.low - b.low;
+  difference.high = a.high - b.high - (a.low < b.low);
+  return difference;
+}
+
+/***************************************************************************//**
+ * Quotient of a 128-bit value by a 64-bit one, which must fit 64 bits.
+ ******************************************************************************/
+static uint64_t div_128(u128_t dividend, uint64_t divisor)
+{
+  uint64_t remainder = 0, quotient = 0;
+  bool carry;
+
+  // Long division, one bit at a time. The remainder stays below the
+  // divisor, so its carry out of bit 63 is tracked separately.
+  for (int bit = 127; bit >= 0; bit--) {
+    carry = (remainder >> 63) != 0;
+    remainder <<= 1;
+    if (bit >= 64) {
+      remainder |= (dividend.high >> (bit - 64)) & 1;
+    } else {
+      remainder |= (dividend.low >> bit) & 1;
+    }
+    quotient <<= 1;
+    if (carry || (remainder >= divisor)) {
+      remainder -= divisor;
+      quotient |= 1;
+    }
+  }
+  return quotient;
+}
+
+/*******************************************************************************
+ **************************   GLOBAL FUNCTIONS   *******************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Sign extend a result.
+ ******************************************************************************/
+int32_t iadc_stats_sign_extend(uint32_t result)
+{
+  return (int32_t)((result & RESULT_MASK) ^ RESULT_SIGN) - (int32_t)RESULT_SIGN;
+}
+
+/***************************************************************************//**
+ * Empty an accumulator.
+ ******************************************************************************/
+void iadc_stats_acc_reset(iadc_stats_acc_t *acc)
+{
+  memset(acc, 0, sizeof(*acc));
+}
+
+/***************************************************************************//**
+ * Add results to an accumulator.
+ ******************************************************************************/
+bool iadc_stats_acc_add(iadc_stats_acc_t *acc,
+                        const uint32_t *results,
+                        uint32_t count)
+{
+  int64_t sum = acc->sum;
+  uint64_t sumSquares = acc->sumSquares;
+  int32_t value, deviation;
+
+  if ((count == 0) || (count > (IADC_STATS_MAX_COUNT - acc->count))) {
+    return count == 0;
+  }
+  if (acc->count == 0) {
+    acc->reference = iadc_stats_sign_extend(results[0]);
+    acc->min = acc->reference;
+    acc->max = acc->reference;
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    value = iadc_stats_sign_extend(results[i]);
+    deviation = value - acc->reference;
+    sum += deviation;
+    sumSquares += (uint64_t)((int64_t)deviation * deviation);
+    if (value < acc->min) {
+      acc->min = value;
+    }
+    if (value > acc->max) {
+      acc->max = value;
+    }
+  }
+
+  acc->sum = sum;
+  acc->sumSquares = sumSquares;
+  acc->count += count;
+  return true;
+}
+
+/***************************************************************************//**
+ * Mean of the results.
+ ******************************************************************************/
+int64_t iadc_stats_mean(const iadc_stats_acc_t *acc)
+{
+  if (acc->count == 0) {
+    return 0;
+  }
+  return ((int64_t)acc->reference << IADC_STATS_FRAC_BITS)
+         + div_round(acc->sum * (1 << IADC_STATS_FRAC_BITS), acc->count);
+}
+
+/***************************************************************************//**
+ * Sample variance of the results.
+ ******************************************************************************/
+uint64_t iadc_stats_variance(const iadc_stats_acc_t *acc)
+{
+  uint64_t n = acc->count;
+  uint64_t absSum = (acc->sum < 0) ? (uint64_t)-acc->sum : (uint64_t)acc->sum;
+  u128_t numerator;
+
+  if (n < 2) {
+    return 0;
+  }
+
+  // (n * sum(d^2) - sum(d)^2) / (n * (n - 1)), exactly
+  numerator = sub_128(mul_64(n, acc->sumSquares), mul_64(absSum, absSum));
+  numerator.high = (numerator.high << IADC_STATS_FRAC_BITS)
+                   | (numerator.low >> (64 - IADC_STATS_FRAC_BITS));
+  numerator.low <<= IADC_STATS_FRAC_BITS;
+  return div_128(numerator, n * (n - 1));
+}
+
+/***************************************************************************//**
+ * Noise density of white noise of a given variance.
+ ******************************************************************************/
+float iadc_stats_noise_density(uint64_t variance,
+                               float sampleRateHz,
+                               float lsbVolts)
+{
+  // White noise spreads evenly from DC to half the sample rate
+  float varianceLsb = (float)variance / (1 << IADC_STATS_FRAC_BITS);
+
+  return sqrtf(varianceLsb * 2.0f / sampleRateHz) * lsbVolts;
+}
+
+/***************************************************************************//**
+ * Start a decimator.
+ ******************************************************************************/
+bool iadc_decim_init(iadc_decim_t *decim, const iadc_decim_config_t *config)
+{
+  uint64_t gain = 1;
+
+  if ((config->cicOrder == 0) || (config->cicOrder > IADC_DECIM_MAX_ORDER)
+      || (config->cicRatio == 0) || (config->firRatio == 0)
+      || ((config->firTaps != NULL)
+          && ((config->firLength == 0)
+              || (config->firLength > IADC_DECIM_MAX_TAPS)))) {
+    return false;
+  }
+  for (uint32_t stage = 0; stage < config->cicOrder; stage++) {
+    gain *= config->cicRatio;
+    if (gain >= CIC_GAIN_LIMIT) {
+      return false;
+    }
+  }
+
+  memset(decim, 0, sizeof(*decim));
+  decim->config = *config;
+  decim->cicGain = (int64_t)gain;
+  return true;
+}
+
+/***************************************************************************//**
+ * Run raw IADC results through a decimator.
+ ******************************************************************************/
+uint32_t iadc_decim_run(iadc_decim_t *decim,
+                        const uint32_t *results,
+                        uint32_t count,
+                        int32_t *output)
+{
+  const iadc_decim_config_t *config = &decim->config;
+  uint32_t order = config->cicOrder;
+  uint32_t written = 0, tap, index;
+  uint64_t value, previous;
+  int32_t sample;
+  int64_t acc;
+
+  for (uint32_t i = 0; i < count; i++) {
+    // Integrators at the input rate. They wrap around, which the combs undo
+    // as long as the output fits.
+    value = (uint64_t)(int64_t)iadc_stats_sign_extend(results[i]);
+    for (uint32_t stage = 0; stage < order; stage++) {
+      decim->integrator[stage] += value;
+      value = decim->integrator[stage];
+    }
+    if (++decim->cicPhase < config->cicRatio) {
+      continue;
+    }
+    decim->cicPhase = 0;
+
+    // Combs at the CIC output rate
+    for (uint32_t stage = 0; stage < order; stage++) {
+      previous = decim->comb[stage];
+      decim->comb[stage] = value;
+      value -= previous;
+    }
+    sample = (int32_t)div_round((int64_t)value * (1 << IADC_DECIM_FRAC_BITS),
+                                decim->cicGain);
+
+    if (config->firTaps == NULL) {
+      if (++decim->firPhase >= config->firRatio) {
+        decim->firPhase = 0;
+        output[written++] = sample;
+      }
+      continue;
+    }
+
+    decim->history[decim->historyIndex] = sample;
+    index = decim->historyIndex;
+    if (++decim->historyIndex == config->firLength) {
+      decim->historyIndex = 0;
+    }
+    // Only the samples kept are filtered
+    if (++decim->firPhase < config->firRatio) {
+      continue;
+    }
+    decim->firPhase = 0;
+    acc = 0;
+    for (tap = 0; tap < config->firLength; tap++) {
+      acc += (int64_t)config->firTaps[tap] * decim->history[index];
+      index = (index == 0) ? config->firLength - 1 : index - 1;
+    }
+    output[written++] = (int32_t)div_round(acc, 1 << 15);
+  }
+  return written;
+}
+
+/***************************************************************************//**
+ * Empty an Allan deviation estimator.
+ ******************************************************************************/
+void iadc_allan_reset(iadc_allan_t *allan)
+{
+  memset(allan, 0, sizeof(*allan));
+}
+
+/***************************************************************************//**
+ * Add decimated samples to an Allan deviation estimator.
+ ******************************************************************************/
+void iadc_allan_add(iadc_allan_t *allan,
+                    const int32_t *samples,
+                    uint32_t count)
+{
+  int64_t sum;
+  float difference;
+  uint32_t bit;
+
+  for (uint32_t i = 0; i < count; i++) {
+    sum = samples[i];
+    for (uint32_t level = 0; level < IADC_ALLAN_LEVELS; level++) {
+      bit = 1UL << level;
+
+      // Difference of two adjacent averages of 2^level samples, in LSB
+      if (allan->hasPrevious & bit) {
+        difference = (float)(sum - allan->previous[level])
+                     / (float)(1ULL << (level + IADC_DECIM_FRAC_BITS));
+        allan->sumSquares[level] += difference * difference;
+        allan->count[level]++;
+      }
+      allan->previous[level] = sum;
+      allan->hasPrevious |= bit;
+
+      // A pair of sums makes a sum of the next level
+      if (!(allan->hasPending & bit)) {
+        allan->pending[level] = sum;
+        allan->hasPending |= bit;
+        break;
+      }
+      allan->hasPending &= ~bit;
+      sum += allan->pending[level];
+    }
+  }
+}
+
+/***************************************************************************//**
+ * Allan deviation at an averaging time of 2^level samples.
+ ******************************************************************************/
+float iadc_allan_deviation(const iadc_allan_t *allan, uint32_t level)
+{
+  if ((level >= IADC_ALLAN_LEVELS) || (allan->count[level] == 0)) {
+    return 0.0f;
+  }
+  return sqrtf(allan->sumSquares[level] / (2.0f * allan->count[level]));
+}
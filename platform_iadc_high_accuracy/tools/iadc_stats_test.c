@@ -0,0 +1,338 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host test of the integer IADC statistics against double references
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ *******************************************************************************
+ *
+ * Checks ../src/iadc_stats.c against double precision references: the
+ * Welford mean and variance the example used to run on target, direct CIC
+ * and FIR filters and a direct Allan deviation.
+ *
+ * Build:
+ *   cc -O2 -I../inc -o iadc_stats_test iadc_stats_test.c ../src/iadc_stats.c \
+ *      -lm
+ ******************************************************************************/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iadc_stats.h"
+
+#define MAX_SAMPLES   65536
+
+// Default decimation FIR of the example, see iadc_single.c
+static const int16_t firTaps[] = {
+  -56, 0, 96, 0, -221, 0, 462, 0, -878, 0, 1609, 0, -3176, 0, 10342, 16412,
+  10342, 0, -3176, 0, 1609, 0, -878, 0, 462, 0, -221, 0, 96, 0, -56
+};
+
+static uint32_t results[MAX_SAMPLES];
+static int32_t decimated[MAX_SAMPLES];
+static double reference[MAX_SAMPLES];
+
+static uint64_t randomState = 0x9E3779B97F4A7C15ULL;
+static uint32_t failures;
+
+/***************************************************************************//**
+ * Uniform random number in (0, 1).
+ ******************************************************************************/
+static double uniform(void)
+{
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 7;
+  randomState ^= randomState << 17;
+  return ((randomState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/***************************************************************************//**
+ * Gaussian random number of unit variance.
+ ******************************************************************************/
+static double gaussian(void)
+{
+  return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+/***************************************************************************//**
+ * Fill results with 20-bit two's complement words of mean + sigma * noise,
+ * clamped to the result range.
+ ******************************************************************************/
+static void generate(uint32_t count, double mean, double sigma)
+{
+  double limit = (double)(1 << (IADC_STATS_RESULT_BITS - 1));
+  double value;
+
+  for (uint32_t i = 0; i < count; i++) {
+    value = floor(mean + sigma * gaussian() + 0.5);
+    if (value < -limit) {
+      value = -limit;
+    }
+    if (value > limit - 1) {
+      value = limit - 1;
+    }
+    results[i] = (uint32_t)(int32_t)value
+                 & ((1UL << IADC_STATS_RESULT_BITS) - 1);
+  }
+}
+
+/***************************************************************************//**
+ * Report a check.
+ ******************************************************************************/
+static void check(const char *what, bool ok, double value, double expected)
+{
+  printf("  %-28s %18.9f  ref %18.9f  %s\n", what, value, expected,
+         ok ? "ok" : "FAIL");
+  if (!ok) {
+    failures++;
+  }
+}
+
+/***************************************************************************//**
+ * The Welford mean and variance the example ran in double.
+ ******************************************************************************/
+static void welford(const uint32_t *buffer, uint32_t size, double *mean,
+                    double *var)
+{
+  double M = 0, M2 = 0, delta1, delta2, x;
+
+  for (uint32_t cnt = 1; cnt <= size; cnt++) {
+    x = iadc_stats_sign_extend(buffer[cnt - 1]);
+    delta1 = x - M;
+    M += delta1 / cnt;
+    delta2 = x - M;
+    M2 += delta1 * delta2;
+  }
+  *mean = M;
+  *var = M2 / (size - 1);
+}
+
+/***************************************************************************//**
+ * Compare the accumulator with exact 128-bit and Welford references.
+ ******************************************************************************/
+static void test_accumulator(const char *name, uint32_t count, double mean,
+                             double sigma)
+{
+  iadc_stats_acc_t acc;
+  __int128 sum = 0, sumSquares = 0, numerator, exactMean, exactVariance;
+  double welfordMean, welfordVariance, scale = 1 << IADC_STATS_FRAC_BITS;
+  int64_t meanQ;
+  uint64_t varianceQ;
+  int32_t x;
+
+  generate(count, mean, sigma);
+  iadc_stats_acc_reset(&acc);
+  // Added in uneven chunks, as buffers would be
+  for (uint32_t done = 0, chunk; done < count; done += chunk) {
+    chunk = (count - done < 777) ? count - done : 777;
+    iadc_stats_acc_add(&acc, &results[done], chunk);
+  }
+  meanQ = iadc_stats_mean(&acc);
+  varianceQ = iadc_stats_variance(&acc);
+
+  for (uint32_t i = 0; i < count; i++) {
+    x = iadc_stats_sign_extend(results[i]);
+    sum += x;
+    sumSquares += (__int128)x * x;
+  }
+  // Round to nearest, halves away from zero
+  numerator = sum * (1 << IADC_STATS_FRAC_BITS);
+  exactMean = (numerator >= 0) ? (numerator + count / 2) / count
+              : -((-numerator + count / 2) / count);
+  exactVariance = ((count * sumSquares - sum * sum) << IADC_STATS_FRAC_BITS)
+                  / ((__int128)count * (count - 1));
+  welford(results, count, &welfordMean, &welfordVariance);
+
+  printf("%s, %u results\n", name, count);
+  check("mean == exact", meanQ == (int64_t)exactMean, meanQ / scale,
+        (double)exactMean / scale);
+  check("variance == exact", varianceQ == (uint64_t)exactVariance,
+        varianceQ / scale, (double)exactVariance / scale);
+  check("mean vs Welford",
+        fabs(meanQ / scale - welfordMean)
+        <= 0.5 / scale + 1e-9 * fabs(welfordMean),
+        meanQ / scale, welfordMean);
+  check("variance vs Welford",
+        fabs(varianceQ / scale - welfordVariance)
+        <= 1.0 / scale + 1e-9 * welfordVariance,
+        varianceQ / scale, welfordVariance);
+}
+
+/***************************************************************************//**
+ * Compare the decimator with a direct double implementation: cascaded moving
+ * sums of cicRatio, then the FIR, each output rounded like the engine's.
+ ******************************************************************************/
+static void test_decimator(uint32_t order, uint32_t ratio, bool fir)
+{
+  iadc_decim_config_t config = {
+    .cicOrder = order,
+    .cicRatio = ratio,
+    .firTaps = fir ? firTaps : NULL,
+    .firLength = sizeof(firTaps) / sizeof(firTaps[0]),
+    .firRatio = fir ? 2 : 1,
+  };
+  static double stage[MAX_SAMPLES], cic[MAX_SAMPLES];
+  iadc_decim_t decim;
+  uint32_t count = 16384, written, cicCount, expectedCount = 0;
+  double gain = pow(ratio, order), sum, q = 1 << IADC_DECIM_FRAC_BITS;
+  double maxError = 0.0, outputVariance = 0.0, outputMean = 0.0;
+  uint32_t settled = 0;
+  char name[64];
+
+  generate(count, -123456.0, 20.0);
+  if (!iadc_decim_init(&decim, &config)) {
+    printf("decimator rejected  FAIL\n");
+    failures++;
+    return;
+  }
+  written = 0;
+  for (uint32_t done = 0; done < count; done += 1000) {
+    written += iadc_decim_run(&decim, &results[done],
+                              (count - done < 1000) ? count - done : 1000,
+                              &decimated[written]);
+  }
+
+  // Reference, starting from zero state like the engine
+  for (uint32_t i = 0; i < count; i++) {
+    reference[i] = iadc_stats_sign_extend(results[i]);
+  }
+  for (uint32_t s = 0; s < order; s++) {
+    sum = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+      sum += reference[i] - ((i >= ratio) ? reference[i - ratio] : 0.0);
+      stage[i] = sum;
+    }
+    memcpy(reference, stage, count * sizeof(double));
+  }
+  cicCount = 0;
+  for (uint32_t i = ratio - 1; i < count; i += ratio) {
+    cic[cicCount++] = round(reference[i] * q / gain);
+  }
+  for (uint32_t i = config.firRatio - 1; i < cicCount; i += config.firRatio) {
+    double value = cic[i];
+
+    if (fir) {
+      value = 0.0;
+      for (uint32_t t = 0; t < config.firLength; t++) {
+        value += firTaps[t] * ((i >= t) ? cic[i - t] : 0.0);
+      }
+      value = round(value / 32768.0);
+    }
+    if (expectedCount < written) {
+      double error = fabs(decimated[expectedCount] - value);
+
+      if (error > maxError) {
+        maxError = error;
+      }
+    }
+    // Statistics once the filters are full
+    if (expectedCount >= 32) {
+      outputMean += value / q;
+      settled++;
+    }
+    expectedCount++;
+  }
+  outputMean /= settled;
+  for (uint32_t i = 32; i < written; i++) {
+    outputVariance += pow(decimated[i] / q - outputMean, 2.0) / (settled - 1);
+  }
+
+  snprintf(name, sizeof(name), "CIC order %u / %u%s", order, ratio,
+           fir ? ", FIR / 2" : "");
+  printf("%s\n", name);
+  check("outputs", written == expectedCount, written, expectedCount);
+  check("max error, LSB/256", maxError <= 1.0, maxError, 0.0);
+  check("settled mean", fabs(outputMean + 123456.0) < 1.0, outputMean,
+        -123456.0);
+  // 20 LSB rms white noise, averaged over at least the CIC ratio
+  check("noise reduced", sqrt(outputVariance) < 20.0 / sqrt(ratio) * 1.2,
+        sqrt(outputVariance), 20.0 / sqrt(ratio));
+}
+
+/***************************************************************************//**
+ * Compare the Allan deviation with a direct computation, on white noise plus
+ * a slow drift.
+ ******************************************************************************/
+static void test_allan(void)
+{
+  static int32_t samples[MAX_SAMPLES];
+  iadc_allan_t allan;
+  uint32_t count = MAX_SAMPLES;
+  double q = 1 << IADC_DECIM_FRAC_BITS;
+  char name[64];
+
+  for (uint32_t i = 0; i < count; i++) {
+    samples[i] = (int32_t)lround((1000.0 + 3.0 * gaussian() + 1e-4 * i) * q);
+  }
+  iadc_allan_reset(&allan);
+  iadc_allan_add(&allan, samples, count / 3);
+  iadc_allan_add(&allan, &samples[count / 3], count - count / 3);
+
+  printf("Allan deviation, %u samples\n", count);
+  for (uint32_t level = 0; level < 12; level++) {
+    uint32_t m = 1U << level, blocks = count / m;
+    double previous = 0.0, average, sum = 0.0, deviation;
+
+    for (uint32_t b = 0; b < blocks; b++) {
+      average = 0.0;
+      for (uint32_t i = 0; i < m; i++) {
+        average += samples[b * m + i] / q;
+      }
+      average /= m;
+      if (b > 0) {
+        sum += (average - previous) * (average - previous);
+      }
+      previous = average;
+    }
+    deviation = sqrt(sum / (2.0 * (blocks - 1)));
+    snprintf(name, sizeof(name), "tau %u samples", m);
+    check(name,
+          fabs(iadc_allan_deviation(&allan, level) - deviation)
+          <= 1e-3 * deviation,
+          iadc_allan_deviation(&allan, level), deviation);
+  }
+}
+
+/***************************************************************************//**
+ * Check the noise density of a known variance.
+ ******************************************************************************/
+static void test_noise_density(void)
+{
+  // 4 LSB rms at 3885 Hz, 5 V / 2^20 LSB
+  uint64_t variance = 16ULL << IADC_STATS_FRAC_BITS;
+  double expected = 4.0 / sqrt(3885.0 / 2.0) * 5.0 / 1048576.0;
+  float density = iadc_stats_noise_density(variance, 3885.0f,
+                                           5.0f / 1048576.0f);
+
+  printf("noise density\n");
+  check("V/sqrt(Hz) x 1e9", fabs(density - expected) <= 1e-6 * expected,
+        density * 1e9, expected * 1e9);
+}
+
+int main(void)
+{
+  test_accumulator("quiet input", 1024, 312345.6, 2.5);
+  test_accumulator("negative input", 1000, -200000.3, 40.0);
+  test_accumulator("full-scale noise", 4096, 0.0, 400000.0);
+  test_accumulator("long run", MAX_SAMPLES, 77.7, 1.0);
+  test_decimator(3, 16, true);
+  test_decimator(4, 8, false);
+  test_decimator(1, 5, true);
+  test_allan();
+  test_noise_density();
+
+  printf("%s\n", failures ? "FAILED" : "all passed");
+  return failures ? 1 : 0;
+}
@@ -18,9 +18,59 @@
 #ifndef IADC_SINGLE_H
 #define IADC_SINGLE_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
+// Capture ring: NUM_SEGMENTS segments of SEGMENT_SAMPLES results each
+#define NUM_SEGMENTS              8
+#define SEGMENT_SAMPLES           256
+
+// Segments kept when the LDMA catches up with the consumer, the older ones
+// are dropped so the consumer gets segments with time left to process them
+#define OVERRUN_KEEP_SEGMENTS     (NUM_SEGMENTS / 2)
+
+/// A completed segment of the capture ring, owned by the consumer until it
+/// is released.
+typedef struct {
+  const uint32_t *samples;        ///< SEGMENT_SAMPLES IADC FIFO words
+  uint32_t sequence;              ///< number of the segment since start
+} iadc_segment_t;
+
+/// Called from the LDMA interrupt when the number of completed segments
+/// waiting for the consumer reaches the watermark.
+typedef void (*iadc_watermark_callback_t)(uint32_t available);
+
 /***************************************************************************//**
  * Initialize IADC for single high speed conversion.
  ******************************************************************************/
 void iadc_single_init(void);
 
+/***************************************************************************//**
+ * Set the callback called when `watermark` segments are waiting.
+ ******************************************************************************/
+void iadc_single_set_watermark(uint32_t watermark,
+                               iadc_watermark_callback_t callback);
+
+/***************************************************************************//**
+ * Get the oldest completed segment without copying it. Returns false if no
+ * segment is waiting. Capture continues into the other segments.
+ ******************************************************************************/
+bool iadc_single_get_segment(iadc_segment_t *segment);
+
+/***************************************************************************//**
+ * Give a segment back to the capture ring. Returns false if the LDMA
+ * overwrote the segment while the consumer was using it (overrun).
+ ******************************************************************************/
+bool iadc_single_release_segment(const iadc_segment_t *segment);
+
+/***************************************************************************//**
+ * Number of segments captured since start.
+ ******************************************************************************/
+uint32_t iadc_single_get_captured(void);
+
+/***************************************************************************//**
+ * Number of segments overwritten before the consumer released them.
+ ******************************************************************************/
+uint32_t iadc_single_get_overruns(void);
+
 #endif // IADC_SINGLE_H
@@ -16,11 +16,30 @@
  ******************************************************************************/
 #include "iadc_single.h"
 
+// Segments handed to the consumer, and segments overwritten while in use
+uint32_t segmentsConsumed = 0;
+uint32_t segmentsLost = 0;
+
+// Set by the watermark callback
+static volatile bool segmentsReady = false;
+
+/***************************************************************************//**
+ * Watermark callback, called from the LDMA interrupt.
+ ******************************************************************************/
+static void on_watermark(uint32_t available)
+{
+  (void)available;
+  segmentsReady = true;
+}
+
 /***************************************************************************//**
  * Initialize application.
  ******************************************************************************/
 void app_init(void)
 {
+  // drain the capture ring when half of it is filled
+  iadc_single_set_watermark(NUM_SEGMENTS / 2, on_watermark);
+
   // initialize IADC and start first converison
   iadc_single_init();
 }
@@ -30,4 +49,20 @@ void app_init(void)
  ******************************************************************************/
 void app_process_action(void)
 {
+  iadc_segment_t segment;
+
+  if (!segmentsReady) {
+    return;
+  }
+  segmentsReady = false;
+
+  while (iadc_single_get_segment(&segment)) {
+    // Hand segment.samples (SEGMENT_SAMPLES words) to the output link here,
+    // for example UART or USB. The capture continues into the other
+    // segments meanwhile.
+    segmentsConsumed++;
+    if (!iadc_single_release_segment(&segment)) {
+      segmentsLost++;
+    }
+  }
 }
@@ -43,13 +43,15 @@
 #include "em_iadc.h"
 #include "em_ldma.h"
 #include "em_gpio.h"
+#include "em_core.h"
+#include "iadc_single.h"
 
 /*******************************************************************************
  *******************************   DEFINES   ***********************************
  ******************************************************************************/
 
-// How many samples to capture
-#define NUM_SAMPLES               1024
+// How many samples to capture, the ring is split into NUM_SEGMENTS segments
+#define NUM_SAMPLES               (NUM_SEGMENTS * SEGMENT_SAMPLES)
 
 // Set CLK_ADC to 10 MHz
 #define CLK_SRC_ADC_FREQ          39000000 // CLK_SRC_ADC
@@ -59,7 +61,7 @@
 #define IADC_INPUT_0_PORT_PIN     iadcPosInputPadAna0;
 #define IADC_INPUT_1_PORT_PIN     iadcPosInputDvdd;
 
-// GPIO output toggle to notify LDMA transfer complete
+// GPIO output toggle to notify LDMA segment complete
 #define GPIO_OUTPUT_0_PORT        gpioPortB
 #define GPIO_OUTPUT_0_PIN         1
 
@@ -71,11 +73,23 @@
  ***************************     *******************************
  ******************************************************************************/
 
-/// Globally declared LDMA link descriptor
-LDMA_Descriptor_t descriptor;
+/// Globally declared LDMA link descriptors, one per segment
+LDMA_Descriptor_t descriptor[NUM_SEGMENTS];
 
 // Buffer to store IADC samples
-uint32_t singleBuffer[NUM_SAMPLES];
+uint32_t singleBuffer[NUM_SEGMENTS][SEGMENT_SAMPLES];
+
+// Segments completed by the LDMA and the oldest one not released by the
+// consumer, both counting since start
+static volatile uint32_t segmentsWritten = 0;
+static volatile uint32_t segmentsRead = 0;
+
+// Segments dropped because the LDMA caught up with the consumer
+static volatile uint32_t segmentsOverrun = 0;
+
+// Watermark notification
+static uint32_t watermarkLevel = NUM_SEGMENTS / 2;
+static iadc_watermark_callback_t watermarkCallback = NULL;
 
 /**************************************************************************//**
  * @brief  CMU initialization
@@ -187,11 +201,9 @@ void initIADC(void)
  *   LDMA initialization
  *
  * @param[in] buffer
- *   pointer to the array where ADC results will be stored.
- * @param[in] size
- *   size of the array
+ *   pointer to the ring where ADC results will be stored.
  *****************************************************************************/
-void initLDMA(uint32_t *buffer, uint32_t size)
+void initLDMA(uint32_t (*buffer)[SEGMENT_SAMPLES])
 {
   // Declare LDMA init structs
   LDMA_Init_t init = LDMA_INIT_DEFAULT;
@@ -204,24 +216,76 @@ void initLDMA(uint32_t *buffer, uint32_t size)
     LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_IADC0_IADC_SINGLE);
 
   /*
-   * Set up a linked descriptor to save scan results to the
-   * user-specified buffer.  By linking the descriptor to itself
-   * (the last argument is the relative jump in terms of the number of
-   * descriptors), transfers will run continuously until firmware
-   * otherwise stops them.
+   * Set up one linked descriptor per segment, each one linking to the
+   * next and the last one back to the first, so transfers run
+   * continuously around the ring until firmware otherwise stops them.
+   * Every descriptor interrupts when its segment is full.
    */
-  descriptor =
-    (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_WORD(
-      &(IADC0->SINGLEFIFODATA),
-      buffer,
-      size,
-      0);
+  for (int i = 0; i < NUM_SEGMENTS; i++) {
+    descriptor[i] =
+      (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_WORD(
+        &(IADC0->SINGLEFIFODATA),
+        buffer[i],
+        SEGMENT_SAMPLES,
+        (i == NUM_SEGMENTS - 1) ? (1 - NUM_SEGMENTS) : 1);
+  }
 
   /*
    * Start the transfer.  The LDMA request and interrupt after saving
    * the specified number of IADC conversion results.
    */
-  LDMA_StartTransfer(IADC_LDMA_CH, (void *)&transferCfg, (void *)&descriptor);
+  LDMA_StartTransfer(IADC_LDMA_CH, (void *)&transferCfg, (void *)descriptor);
+}
+
+/**************************************************************************//**
+ * @brief  Index of the segment the LDMA is currently filling
+ *****************************************************************************/
+static uint32_t ldmaSegment(void)
+{
+  uint32_t offset = LDMA->CH[IADC_LDMA_CH].DST - (uint32_t)singleBuffer;
+
+  // Right after the last segment the destination may still point to the
+  // end of the ring, before the first descriptor is reloaded
+  return (offset / sizeof(singleBuffer[0])) % NUM_SEGMENTS;
+}
+
+/**************************************************************************//**
+ * @brief  Catch up with the LDMA, call with interrupts disabled
+ *
+ * @return  Number of segments completed before the update and not read.
+ *****************************************************************************/
+static uint32_t ldmaUpdate(void)
+{
+  uint32_t writing;
+  uint32_t written;
+  uint32_t before;
+
+  /*
+   * The segment the LDMA is filling now is found from its destination
+   * address, so segments are not lost if the interrupt was late and
+   * several of them completed meanwhile.
+   */
+  writing = ldmaSegment();
+  written = segmentsWritten;
+  before = written - segmentsRead;
+  while ((written % NUM_SEGMENTS) != writing) {
+    written++;
+  }
+  segmentsWritten = written;
+
+  /*
+   * The segment being filled now held sequence written - NUM_SEGMENTS.
+   * If the consumer has not released it yet, it is lost. Older segments
+   * are dropped too, down to OVERRUN_KEEP_SEGMENTS: a consumer that fell
+   * behind would otherwise always work on the segment the LDMA overwrites
+   * next, and lose all of them.
+   */
+  if ((int32_t)(written - segmentsRead) >= NUM_SEGMENTS) {
+    segmentsOverrun += written - OVERRUN_KEEP_SEGMENTS - segmentsRead;
+    segmentsRead = written - OVERRUN_KEEP_SEGMENTS;
+  }
+
+  return before;
 }
 
 /**************************************************************************//**
@@ -229,16 +293,26 @@ void initLDMA(uint32_t *buffer, uint32_t size)
  *****************************************************************************/
 void LDMA_IRQHandler(void)
 {
+  uint32_t available;
+  uint32_t before;
+
   // Clear interrupt flags
   LDMA_IntClear(1 << IADC_LDMA_CH);
 
+  before = ldmaUpdate();
+
+  available = segmentsWritten - segmentsRead;
+  if ((watermarkCallback != NULL)
+      && (before < watermarkLevel) && (available >= watermarkLevel)) {
+    watermarkCallback(available);
+  }
+
   /*
-   * Toggle GPIO to signal LDMA transfer is complete.  The low/high
-   * time will be NUM_SAMPLES divided by the sampling rate, the
+   * Toggle GPIO to signal a segment is complete.  The low/high
+   * time will be SEGMENT_SAMPLES divided by the sampling rate, the
    * calculations for which are explained above.  For the example
-   * defaults (1024 samples and a sampling rate of 833 ksps), the
-   * low/high time will be around 1.23 ms, subject to FSRCO tuning
-   * accuracy.
+   * defaults (256 samples and a sampling rate of 1.95 Msps), the
+   * low/high time will be around 131 us.
    */
   GPIO_PinOutToggle(GPIO_OUTPUT_0_PORT, GPIO_OUTPUT_0_PIN);
 }
@@ -258,8 +332,82 @@ void iadc_single_init(void)
   initIADC();
 
   // Initialize the LDMA
-  initLDMA(singleBuffer, NUM_SAMPLES);
+  initLDMA(singleBuffer);
 
   // Start single conversion, IADC converts continuously after
   IADC_command(IADC0, iadcCmdStartSingle);
 }
+
+/***************************************************************************//**
+ * Set the callback called when `watermark` segments are waiting.
+ ******************************************************************************/
+void iadc_single_set_watermark(uint32_t watermark,
+                               iadc_watermark_callback_t callback)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  watermarkLevel = watermark;
+  watermarkCallback = callback;
+  CORE_EXIT_ATOMIC();
+}
+
+/***************************************************************************//**
+ * Get the oldest completed segment without copying it.
+ ******************************************************************************/
+bool iadc_single_get_segment(iadc_segment_t *segment)
+{
+  uint32_t sequence;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  // The interrupt may be pending, do not hand out an overwritten segment
+  ldmaUpdate();
+  sequence = segmentsRead;
+  if (sequence == segmentsWritten) {
+    CORE_EXIT_ATOMIC();
+    return false;
+  }
+  CORE_EXIT_ATOMIC();
+
+  segment->samples = singleBuffer[sequence % NUM_SEGMENTS];
+  segment->sequence = sequence;
+  return true;
+}
+
+/***************************************************************************//**
+ * Give a segment back to the capture ring.
+ ******************************************************************************/
+bool iadc_single_release_segment(const iadc_segment_t *segment)
+{
+  bool valid;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  // A segment is dropped from the ring when the LDMA starts overwriting it,
+  // the interrupt doing that may still be pending.
+  ldmaUpdate();
+  valid = (segmentsRead == segment->sequence);
+  if (valid) {
+    segmentsRead = segment->sequence + 1;
+  }
+  CORE_EXIT_ATOMIC();
+
+  return valid;
+}
+
+/***************************************************************************//**
+ * Number of segments captured since start.
+ ******************************************************************************/
+uint32_t iadc_single_get_captured(void)
+{
+  return segmentsWritten;
+}
+
+/***************************************************************************//**
+ * Number of segments overwritten before the consumer released them.
+ ******************************************************************************/
+uint32_t iadc_single_get_overruns(void)
+{
+  return segmentsOverrun;
+}
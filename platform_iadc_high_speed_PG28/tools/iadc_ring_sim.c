@@ -0,0 +1,259 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host simulation of the capture ring with a simulated LDMA producer
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ *******************************************************************************
+ *
+ * Runs ../src/iadc_single.c against a model of the LDMA filling the ring at
+ * the sample rate, and a consumer like the one of app.c that spends a given
+ * time on every segment. Each sample holds its number since start, so the
+ * consumer checks the content of every segment it gets.
+ *
+ * The model follows the linked descriptors set up by initLDMA(). After the
+ * last word of a descriptor, the destination address points past it until
+ * the next sample loads the next descriptor, at the end of the ring for the
+ * last one. The interrupt of a completed descriptor runs after a latency;
+ * descriptors completing meanwhile share one interrupt, as their flags do.
+ *
+ * For every consumer load (time per segment over the segment period),
+ * interrupt latency and periodic consumer stall, it reports the consumer
+ * throughput and the overrun rate, and checks that:
+ * - no segment the consumer released as valid was overwritten while in use,
+ * - segments are handed out in order, never twice,
+ * - every captured segment was either consumed, counted as overrun or is
+ *   still waiting.
+ *
+ * Build:
+ *   cd tools
+ *   cc -O2 -Wall -Wextra -Wno-pointer-to-int-cast -I../inc -Istub \
+ *      -o iadc_ring_sim iadc_ring_sim.c
+ *
+ *   iadc_single.c casts the ring address to 32 bits, like the LDMA registers
+ *   of the target; the model keeps the same low 32 bits.
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/iadc_single.c"
+
+// Sample rate of the example, 19.5 MHz CLK_ADC and 2x oversampling
+#define SAMPLE_RATE               1950000.0
+
+// Simulated segments per scenario
+#define SEGMENTS                  200000
+
+LDMA_TypeDef sim_ldma;
+IADC_TypeDef sim_iadc;
+
+// LDMA model
+static const LDMA_Descriptor_t *ldmaDescriptor;
+static uint32_t ldmaRemaining;
+static bool ldmaLoaded;
+static uint32_t ldmaSample;
+
+// Interrupt model, in samples
+static uint32_t now;
+static uint32_t latency;
+static bool irqPending;
+static uint32_t irqDue;
+static uint32_t interrupts;
+
+// Consumer, as in app.c
+static volatile bool segmentsReady;
+
+/***************************************************************************//**
+ * LDMA model.
+ ******************************************************************************/
+void LDMA_Init(const LDMA_Init_t *init)
+{
+  (void)init;
+}
+
+void LDMA_StartTransfer(int ch, const LDMA_TransferCfg_t *transfer,
+                        const LDMA_Descriptor_t *descriptor)
+{
+  (void)ch;
+  (void)transfer;
+  ldmaDescriptor = descriptor;
+  ldmaLoaded = false;
+}
+
+void LDMA_IntClear(uint32_t flags)
+{
+  (void)flags;
+}
+
+/***************************************************************************//**
+ * Advance the time by one sample: the LDMA stores it, and the interrupt runs
+ * when its latency has passed.
+ ******************************************************************************/
+static void sim_step(void)
+{
+  uint32_t *destination;
+
+  if (!ldmaLoaded) {
+    ldmaLoaded = true;
+    ldmaRemaining = ldmaDescriptor->xfer.xferCnt + 1;
+    LDMA->CH[IADC_LDMA_CH].DST =
+      (uint32_t)(uintptr_t)ldmaDescriptor->xfer.dstAddr;
+  }
+  destination = (uint32_t *)ldmaDescriptor->xfer.dstAddr
+                + (ldmaDescriptor->xfer.xferCnt + 1 - ldmaRemaining);
+  *destination = ldmaSample++;
+  LDMA->CH[IADC_LDMA_CH].DST += sizeof(uint32_t);
+  if (--ldmaRemaining == 0) {
+    ldmaDescriptor += ldmaDescriptor->xfer.linkJump;
+    ldmaLoaded = false;
+    if (!irqPending) {
+      irqPending = true;
+      irqDue = now + latency;
+    }
+  }
+
+  now++;
+  if (irqPending && ((int32_t)(now - irqDue) >= 0)) {
+    irqPending = false;
+    interrupts++;
+    LDMA_IRQHandler();
+  }
+}
+
+static void on_watermark(uint32_t available)
+{
+  (void)available;
+  segmentsReady = true;
+}
+
+/***************************************************************************//**
+ * Start the capture from a clean state.
+ ******************************************************************************/
+static void sim_start(uint32_t irqLatency)
+{
+  segmentsWritten = 0;
+  segmentsRead = 0;
+  segmentsOverrun = 0;
+  segmentsReady = false;
+  now = 0;
+  latency = irqLatency;
+  irqPending = false;
+  interrupts = 0;
+  ldmaSample = 0;
+
+  iadc_single_set_watermark(NUM_SEGMENTS / 2, on_watermark);
+  iadc_single_init();
+}
+
+/***************************************************************************//**
+ * Run the consumer of app.c for SEGMENTS segment periods, spending load
+ * segment periods on every segment, and stalling for stall segment periods
+ * every 64 segments it gets. Returns the number of failed checks.
+ ******************************************************************************/
+static uint32_t scenario(double load, uint32_t irqLatency, uint32_t stall)
+{
+  const uint32_t end = SEGMENTS * SEGMENT_SAMPLES;
+  double perSample = load, budget = 0;
+  uint32_t consumed = 0, lost = 0, corrupt = 0, order = 0, gotten = 0;
+  uint32_t nextSequence = 0, failures = 0, waiting;
+  iadc_segment_t segment;
+  bool intact;
+
+  sim_start(irqLatency);
+  while (now < end) {
+    if (!segmentsReady) {
+      sim_step();
+      continue;
+    }
+    segmentsReady = false;
+
+    while ((now < end) && iadc_single_get_segment(&segment)) {
+      if (segment.sequence < nextSequence) {
+        order++;
+      }
+      nextSequence = segment.sequence + 1;
+      gotten++;
+      if ((stall > 0) && ((gotten % 64) == 0)) {
+        for (uint32_t i = 0; i < stall * SEGMENT_SAMPLES; i++) {
+          sim_step();
+        }
+      }
+
+      // The consumer reads the segment in place, while the capture goes on
+      intact = true;
+      for (uint32_t i = 0; i < SEGMENT_SAMPLES; i++) {
+        for (budget += perSample; budget >= 1; budget--) {
+          sim_step();
+        }
+        if (segment.samples[i] != segment.sequence * SEGMENT_SAMPLES + i) {
+          intact = false;
+        }
+      }
+      if (iadc_single_release_segment(&segment)) {
+        consumed++;
+        if (!intact) {
+          corrupt++;
+        }
+      } else {
+        lost++;
+      }
+    }
+  }
+
+  waiting = segmentsWritten - segmentsRead;
+  if (corrupt || order
+      || (segmentsWritten != consumed + segmentsOverrun + waiting)
+      || (segmentsWritten + 2 + irqLatency / SEGMENT_SAMPLES < SEGMENTS)) {
+    failures++;
+  }
+  printf("%5.2f %8u %6u %9u %9u %8u %8.3f%% %8.2f %7u %5u%s\n",
+         load, irqLatency, stall, segmentsWritten, consumed, lost,
+         100.0 * segmentsOverrun / segmentsWritten,
+         consumed * SEGMENT_SAMPLES * sizeof(uint32_t) * SAMPLE_RATE
+         / now / 1e6, corrupt, order, failures ? "  FAIL" : "");
+  return failures;
+}
+
+int main(void)
+{
+  static const struct {
+    double load;
+    uint32_t latency;
+    uint32_t stall;
+  } cases[] = {
+    { 0.50, 4, 0 },
+    { 0.90, 4, 0 },
+    { 0.99, 4, 0 },
+    { 1.10, 4, 0 },
+    { 2.00, 4, 0 },
+    { 0.50, 3 * SEGMENT_SAMPLES + 17, 0 },
+    { 0.90, 3 * SEGMENT_SAMPLES + 17, 0 },
+    { 1.10, 3 * SEGMENT_SAMPLES + 17, 0 },
+    { 1.10, SEGMENT_SAMPLES - 1, 0 },
+    { 0.50, 4, 3 },
+    { 0.50, 4, 6 },
+    { 0.50, 4, 12 },
+  };
+  uint32_t failures = 0;
+
+  printf("segment period %.1f us, ring of %d segments, watermark %d\n\n",
+         SEGMENT_SAMPLES * 1e6 / SAMPLE_RATE, NUM_SEGMENTS, NUM_SEGMENTS / 2);
+  printf("%5s %8s %6s %9s %9s %8s %9s %8s %7s %5s\n", "load", "latency",
+         "stall", "captured", "consumed", "in use", "overrun", "MB/s",
+         "corrupt", "order");
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    failures += scenario(cases[c].load, cases[c].latency, cases[c].stall);
+  }
+
+  printf("\n%s\n", failures ? "FAIL" : "PASS");
+  return failures ? 1 : 0;
+}
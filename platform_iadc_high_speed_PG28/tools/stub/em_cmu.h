@@ -0,0 +1,48 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for em_cmu.h, the clocks of the IADC example
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef EM_CMU_H
+#define EM_CMU_H
+
+#include <stdbool.h>
+
+typedef enum {
+  cmuClock_EM01GRPACLK,
+  cmuClock_IADCCLK,
+  cmuClock_IADC0,
+  cmuClock_GPIO
+} CMU_Clock_TypeDef;
+
+typedef enum {
+  cmuSelect_HFXO,
+  cmuSelect_EM01GRPACLK
+} CMU_Select_TypeDef;
+
+static inline void CMU_ClockSelectSet(CMU_Clock_TypeDef clock,
+                                      CMU_Select_TypeDef ref)
+{
+  (void)clock;
+  (void)ref;
+}
+
+static inline void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable)
+{
+  (void)clock;
+  (void)enable;
+}
+
+#endif // EM_CMU_H
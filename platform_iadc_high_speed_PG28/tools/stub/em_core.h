@@ -0,0 +1,27 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for em_core.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef EM_CORE_H
+#define EM_CORE_H
+
+// Interrupts only run between the steps of the simulation, so the atomic
+//   sections need no locking.
+#define CORE_DECLARE_IRQ_STATE
+#define CORE_ENTER_ATOMIC()
+#define CORE_EXIT_ATOMIC()
+
+#endif // EM_CORE_H
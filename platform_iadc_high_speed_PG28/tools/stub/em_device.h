@@ -0,0 +1,54 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for em_device.h, the IADC and LDMA registers used
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef EM_DEVICE_H
+#define EM_DEVICE_H
+
+#include <stdint.h>
+
+typedef struct {
+  volatile uint32_t DST;
+} LDMA_CH_TypeDef;
+
+typedef struct {
+  LDMA_CH_TypeDef CH[8];
+} LDMA_TypeDef;
+
+typedef struct {
+  volatile uint32_t SCHED;
+} IADC_CFG_TypeDef;
+
+typedef struct {
+  volatile uint32_t STATUS;
+  volatile uint32_t EN;
+  volatile uint32_t EN_SET;
+  volatile uint32_t EN_CLR;
+  volatile uint32_t CTRL_CLR;
+  volatile uint32_t SINGLEFIFODATA;
+  IADC_CFG_TypeDef CFG[2];
+} IADC_TypeDef;
+
+extern LDMA_TypeDef sim_ldma;
+extern IADC_TypeDef sim_iadc;
+#define LDMA                        (&sim_ldma)
+#define IADC0                       (&sim_iadc)
+
+#define IADC_STATUS_SYNCBUSY        (1UL << 0)
+#define IADC_EN_EN                  (1UL << 0)
+#define _IADC_EN_DISABLING_MASK     (1UL << 1)
+
+#endif // EM_DEVICE_H
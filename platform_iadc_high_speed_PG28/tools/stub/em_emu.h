@@ -0,0 +1,23 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for em_emu.h
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef EM_EMU_H
+#define EM_EMU_H
+
+// iadc_single.c uses nothing of em_emu.h.
+
+#endif // EM_EMU_H
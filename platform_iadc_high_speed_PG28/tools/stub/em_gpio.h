@@ -0,0 +1,44 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for em_gpio.h, the segment toggle output
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef EM_GPIO_H
+#define EM_GPIO_H
+
+typedef enum {
+  gpioPortB = 1
+} GPIO_Port_TypeDef;
+
+typedef enum {
+  gpioModePushPull
+} GPIO_Mode_TypeDef;
+
+static inline void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin,
+                                   GPIO_Mode_TypeDef mode, unsigned int out)
+{
+  (void)port;
+  (void)pin;
+  (void)mode;
+  (void)out;
+}
+
+static inline void GPIO_PinOutToggle(GPIO_Port_TypeDef port, unsigned int pin)
+{
+  (void)port;
+  (void)pin;
+}
+
+#endif // EM_GPIO_H
@@ -0,0 +1,152 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for em_iadc.h, the high speed single configuration
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef EM_IADC_H
+#define EM_IADC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "em_device.h"
+
+typedef enum {
+  iadcWarmupNormal,
+  iadcWarmupKeepWarm
+} IADC_Warmup_t;
+
+typedef enum {
+  iadcCfgReferenceVddx
+} IADC_CfgReference_t;
+
+typedef enum {
+  iadcCfgModeHighSpeed
+} IADC_CfgAdcMode_t;
+
+typedef enum {
+  iadcCfgOsrHighSpeed2x
+} IADC_CfgOsrHighSpeed_t;
+
+typedef enum {
+  iadcCfgAnalogGain1x
+} IADC_CfgAnalogGain_t;
+
+typedef enum {
+  iadcTriggerActionOnce,
+  iadcTriggerActionContinuous
+} IADC_TriggerAction_t;
+
+typedef enum {
+  iadcFifoCfgDvl1,
+  iadcFifoCfgDvl2
+} IADC_FifoCfgDvl_t;
+
+typedef enum {
+  iadcPosInputPadAna0,
+  iadcPosInputDvdd
+} IADC_PosInput_t;
+
+typedef enum {
+  iadcNegInputGnd
+} IADC_NegInput_t;
+
+typedef enum {
+  iadcCmdStartSingle
+} IADC_Cmd_t;
+
+typedef struct {
+  IADC_Warmup_t warmup;
+  uint8_t srcClkPrescale;
+} IADC_Init_t;
+
+typedef struct {
+  IADC_CfgAdcMode_t adcMode;
+  IADC_CfgOsrHighSpeed_t osrHighSpeed;
+  IADC_CfgAnalogGain_t analogGain;
+  IADC_CfgReference_t reference;
+  uint32_t vRef;
+  uint32_t adcClkPrescale;
+} IADC_Config_t;
+
+typedef struct {
+  IADC_Config_t configs[2];
+} IADC_AllConfigs_t;
+
+typedef struct {
+  IADC_TriggerAction_t triggerAction;
+  IADC_FifoCfgDvl_t dataValidLevel;
+  bool fifoDmaWakeup;
+} IADC_InitSingle_t;
+
+typedef struct {
+  IADC_PosInput_t posInput;
+  IADC_NegInput_t negInput;
+} IADC_SingleInput_t;
+
+#define IADC_INIT_DEFAULT           { iadcWarmupNormal, 0 }
+#define IADC_ALLCONFIGS_DEFAULT     { { { 0 } } }
+#define IADC_INITSINGLE_DEFAULT     { iadcTriggerActionOnce, iadcFifoCfgDvl1, \
+                                      false }
+#define IADC_SINGLEINPUT_DEFAULT    { iadcPosInputPadAna0, iadcNegInputGnd }
+
+static inline uint8_t IADC_calcSrcClkPrescale(IADC_TypeDef *iadc,
+                                              uint32_t srcClkFreq,
+                                              uint32_t cmuClkFreq)
+{
+  (void)iadc;
+  (void)srcClkFreq;
+  (void)cmuClkFreq;
+  return 0;
+}
+
+static inline uint32_t IADC_calcAdcClkPrescale(IADC_TypeDef *iadc,
+                                               uint32_t adcClkFreq,
+                                               uint32_t cmuClkFreq,
+                                               IADC_CfgAdcMode_t adcMode,
+                                               uint8_t srcClkPrescaler)
+{
+  (void)iadc;
+  (void)adcClkFreq;
+  (void)cmuClkFreq;
+  (void)adcMode;
+  (void)srcClkPrescaler;
+  return 1;
+}
+
+static inline void IADC_init(IADC_TypeDef *iadc, const IADC_Init_t *init,
+                             const IADC_AllConfigs_t *allConfigs)
+{
+  (void)iadc;
+  (void)init;
+  (void)allConfigs;
+}
+
+static inline void IADC_initSingle(IADC_TypeDef *iadc,
+                                   const IADC_InitSingle_t *init,
+                                   const IADC_SingleInput_t *input)
+{
+  (void)iadc;
+  (void)init;
+  (void)input;
+}
+
+static inline void IADC_command(IADC_TypeDef *iadc, IADC_Cmd_t cmd)
+{
+  (void)iadc;
+  (void)cmd;
+}
+
+#endif // EM_IADC_H
@@ -0,0 +1,71 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for em_ldma.h, driven by the model of ../iadc_ring_sim.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2023 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef EM_LDMA_H
+#define EM_LDMA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * The LDMA is a model driven by ../iadc_ring_sim.c: it follows the
+ * descriptors passed to LDMA_StartTransfer() and raises the interrupt of a
+ * channel when a descriptor completes.
+ */
+
+typedef struct {
+  int dummy;
+} LDMA_Init_t;
+
+typedef enum {
+  ldmaPeripheralSignal_IADC0_IADC_SINGLE
+} LDMA_PeripheralSignal_t;
+
+typedef struct {
+  LDMA_PeripheralSignal_t ldmaReqSel;
+} LDMA_TransferCfg_t;
+
+// Only the fields the model follows; the link is counted in descriptors
+typedef struct {
+  struct {
+    const volatile void *srcAddr;
+    void *dstAddr;
+    uint32_t xferCnt;               ///< words to transfer, less one
+    int32_t linkJump;               ///< next descriptor, relative
+    bool link;
+  } xfer;
+} LDMA_Descriptor_t;
+
+#define LDMA_INIT_DEFAULT           { 0 }
+#define LDMA_TRANSFER_CFG_PERIPHERAL(signal) { (signal) }
+#define LDMA_DESCRIPTOR_LINKREL_P2M_WORD(src, dest, count, linkjmp) \
+  {                                                                 \
+    .xfer = {                                                       \
+      .srcAddr = (src),                                             \
+      .dstAddr = (dest),                                            \
+      .xferCnt = (count) - 1,                                       \
+      .linkJump = (linkjmp),                                        \
+      .link = true,                                                 \
+    }                                                               \
+  }
+
+void LDMA_Init(const LDMA_Init_t *init);
+void LDMA_StartTransfer(int ch, const LDMA_TransferCfg_t *transfer,
+                        const LDMA_Descriptor_t *descriptor);
+void LDMA_IntClear(uint32_t flags);
+
+#endif // EM_LDMA_H
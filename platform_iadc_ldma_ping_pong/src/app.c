@@ -22,6 +22,7 @@
 #include "em_ldma.h"
 #include "em_prs.h"
 #include "sl_simple_led_instances.h"
+#include "iadc_stats.h"
 
 /*******************************************************************************
  *******************************   DEFINES   ***********************************
@@ -61,6 +62,16 @@ uint32_t singleBuffer2[NUM_SAMPLES];
 // used to toggle which buffer to perform statistical analysis;
 uint32_t *dataBuffer = singleBuffer2;
 
+// buffers completed by the LDMA and buffers analyzed by the application
+volatile uint32_t buffersFilled = 0;
+uint32_t buffersProcessed = 0;
+
+// buffers that were overwritten before their analysis started
+uint32_t buffersMissed = 0;
+
+// statistics of the most recently analyzed buffer
+iadcStats_t stats;
+
 /**************************************************************************//**
  * @brief  IADC Initializer
  *****************************************************************************/
@@ -195,6 +206,7 @@ void LDMA_IRQHandler(void)
   } else {
     dataBuffer = singleBuffer2;
   }
+  buffersFilled++;
 
   // Toggle GPIO to notify that transfer is complete
   sl_led_toggle(&sl_led_led0);
@@ -298,26 +310,6 @@ void em_EM2_RTCC(CMU_Select_TypeDef osc, bool powerdownRam)
   EMU_EnterEM2(true);
 }
 
-/***************************************************************************//**
- * @brief   Computes mean and variance of data set using Welford's algorithm
- ******************************************************************************/
-void statsWelford(uint32_t *buffer, uint32_t size, double *mean, double *var)
-{
-  uint32_t cnt;
-  double M, M2, delta1, delta2;
-
-  M = 0;
-  M2 = 0;
-  for (cnt = 1; cnt <= size; cnt++) {
-    delta1 = buffer[cnt - 1] - M;
-    M += delta1 / cnt;
-    delta2 = buffer[cnt - 1] - M;
-    M2 += delta1 * delta2;
-  }
-  *mean = M;
-  *var = M2 / (size - 1);
-}
-
 /***************************************************************************//**
  * Initialize application.
  ******************************************************************************/
@@ -332,6 +324,9 @@ void app_init(void)
   // Set clock frequency to defined value
   CMU_HFRCOEM23BandSet(HFRCOEM23_FREQ);
 
+  // Clear the statistics
+  iadcStatsReset();
+
   // Initialize the IADC
   initIADC();
 
@@ -347,14 +342,24 @@ void app_init(void)
  ******************************************************************************/
 void app_process_action(void)
 {
-  double mean, variance;
+  uint32_t filled;
 
   // Sleep CPU until LDMA transfer completes
   // EM2 with RTCC running off LFRCO is a documented current mode in the DS
   em_EM2_RTCC(cmuSelect_LFRCO, false);
 
-  // Process most recent buffer
-  statsWelford(dataBuffer, NUM_SAMPLES, &mean, &variance);
+  filled = buffersFilled;
+  if (filled == buffersProcessed) {
+    return;
+  }
+  // The analysis has to finish before the LDMA completes the next buffer,
+  // otherwise the older buffers have been overwritten
+  buffersMissed += filled - buffersProcessed - 1;
+  buffersProcessed = filled;
+
+  // Process most recent buffer in a single pass and publish the results
+  iadcStatsProcess(dataBuffer, NUM_SAMPLES);
+  iadcStatsGet(&stats);
 
   // Toggle GPIO to notify that stats are complete
   sl_led_toggle(&sl_led_led1);
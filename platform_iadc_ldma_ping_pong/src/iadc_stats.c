@@ -0,0 +1,159 @@
+/***************************************************************************//**
+ * @file
+ * @brief Streaming statistics of IADC sample buffers
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <string.h>
+
+#include "em_device.h"
+#include "iadc_stats.h"
+
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+#define HIST_SHIFT                (IADC_STATS_RESOLUTION - IADC_STATS_HIST_BITS)
+
+// Accumulate one FIFO word, stripping the FIFO ID bits
+#define ACCUMULATE(word)                            \
+  do {                                              \
+    uint32_t code = (word) & IADC_STATS_DATA_MASK;  \
+    sum += code;                                    \
+    sumSq += code * code;                           \
+    if (code < min) {                               \
+      min = code;                                   \
+    }                                               \
+    if (code > max) {                               \
+      max = code;                                   \
+    }                                               \
+    histogram[code >> HIST_SHIFT]++;                \
+  } while (0)
+
+/*******************************************************************************
+ ***************************   LOCAL VARIABLES   *******************************
+ ******************************************************************************/
+
+// Published statistics. The writer fills the slot that is not published and
+// then advances publishCount, so a reader always copies a complete slot and
+// only has to retry if the writer published again meanwhile.
+static iadcStats_t snapshot[2];
+static volatile uint32_t publishCount = 0;
+
+// Running statistics of all buffers (Welford/Chan update per buffer)
+static uint32_t totalBuffers = 0;
+static double totalSamples = 0;
+static double totalMean = 0;
+static double totalM2 = 0;
+
+/***************************************************************************//**
+ * @brief
+ *   Clear the running statistics and the published snapshot.
+ ******************************************************************************/
+void iadcStatsReset(void)
+{
+  totalBuffers = 0;
+  totalSamples = 0;
+  totalMean = 0;
+  totalM2 = 0;
+  publishCount = 0;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Compute the statistics of a buffer of IADC FIFO words and publish them.
+ *
+ * @details
+ *   The buffer is read once. Sum and sum of squares are kept as integers, so
+ *   the buffer mean and variance are exact; floating point is only used once
+ *   per buffer to merge them into the running statistics.
+ ******************************************************************************/
+void iadcStatsProcess(const uint32_t *buffer, uint32_t size)
+{
+  iadcStats_t *stats = &snapshot[(publishCount + 1) & 1];
+  uint16_t *histogram = stats->histogram;
+  uint32_t sum = 0;
+  uint64_t sumSq = 0;
+  uint32_t min = IADC_STATS_DATA_MASK;
+  uint32_t max = 0;
+  uint32_t i;
+  double n, m2, delta;
+
+  memset(histogram, 0, sizeof(stats->histogram));
+
+  for (i = 0; i + 4 <= size; i += 4) {
+    ACCUMULATE(buffer[i]);
+    ACCUMULATE(buffer[i + 1]);
+    ACCUMULATE(buffer[i + 2]);
+    ACCUMULATE(buffer[i + 3]);
+  }
+  for (; i < size; i++) {
+    ACCUMULATE(buffer[i]);
+  }
+
+  // n * sumSq and sum^2 both fit in 64 bits for 65535 12-bit samples
+  n = size;
+  m2 = (double)((uint64_t)size * sumSq - (uint64_t)sum * sum) / n;
+
+  totalBuffers++;
+  stats->buffers = totalBuffers;
+  stats->samples = size;
+  stats->min = (uint16_t)min;
+  stats->max = (uint16_t)max;
+  stats->mean = (float)(sum / n);
+  stats->variance = (float)(m2 / (n - 1));
+  stats->rms = sqrtf((float)(sumSq / n));
+
+  // Noise of a DC input relative to the quantization noise (1/sqrt(12) LSB)
+  if (stats->variance * 12.0f <= 1.0f) {
+    stats->enob = IADC_STATS_RESOLUTION;
+  } else {
+    stats->enob = IADC_STATS_RESOLUTION
+                  - 0.5f * log2f(stats->variance * 12.0f);
+  }
+
+  // Merge the buffer into the running statistics
+  delta = sum / n - totalMean;
+  totalM2 += m2 + delta * delta * totalSamples * n / (totalSamples + n);
+  totalSamples += n;
+  totalMean += delta * n / totalSamples;
+  stats->totalMean = (float)totalMean;
+  stats->totalVariance = (float)(totalM2 / (totalSamples - 1));
+
+  // Publish only after the slot is completely written
+  __DMB();
+  publishCount++;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Copy the most recently published statistics.
+ ******************************************************************************/
+bool iadcStatsGet(iadcStats_t *stats)
+{
+  uint32_t count;
+
+  do {
+    count = publishCount;
+    if (count == 0) {
+      return false;
+    }
+    __DMB();
+    *stats = snapshot[count & 1];
+    __DMB();
+  } while (count != publishCount);
+
+  return true;
+}
@@ -0,0 +1,93 @@
+/***************************************************************************//**
+ * @file
+ * @brief Streaming statistics of IADC sample buffers
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef IADC_STATS_H
+#define IADC_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+// Resolution of the conversion results (right justified, 12-bit alignment).
+// The bits above it hold the FIFO ID when SHOWID is enabled and are masked.
+#define IADC_STATS_RESOLUTION     12
+#define IADC_STATS_DATA_MASK      ((1UL << IADC_STATS_RESOLUTION) - 1)
+
+// Number of histogram bins, a power of two not above 2^IADC_STATS_RESOLUTION
+#define IADC_STATS_HIST_BITS      6
+#define IADC_STATS_HIST_BINS      (1UL << IADC_STATS_HIST_BITS)
+
+/*******************************************************************************
+ *******************************   TYPEDEFS   **********************************
+ ******************************************************************************/
+
+// Statistics of one buffer, plus the running mean/variance of all buffers
+typedef struct {
+  uint32_t buffers;         // number of buffers processed so far
+  uint32_t samples;         // number of samples in the buffer
+  uint16_t min;             // smallest code in the buffer
+  uint16_t max;             // largest code in the buffer
+  float mean;               // mean code of the buffer
+  float variance;           // sample variance of the buffer (codes^2)
+  float rms;                // root mean square of the codes
+  float enob;               // effective bits from the noise of a DC input
+  float totalMean;          // mean code of all buffers
+  float totalVariance;      // sample variance of all buffers (codes^2)
+  uint16_t histogram[IADC_STATS_HIST_BINS];
+} iadcStats_t;
+
+/*******************************************************************************
+ **************************   FUNCTION PROTOTYPES   ****************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @brief
+ *   Clear the running statistics and the published snapshot.
+ ******************************************************************************/
+void iadcStatsReset(void);
+
+/***************************************************************************//**
+ * @brief
+ *   Compute the statistics of a buffer of IADC FIFO words and publish them.
+ *
+ * @param[in] buffer
+ *   IADC FIFO words as transferred by the LDMA.
+ * @param[in] size
+ *   Number of words, at least 2 and at most 65535.
+ ******************************************************************************/
+void iadcStatsProcess(const uint32_t *buffer, uint32_t size);
+
+/***************************************************************************//**
+ * @brief
+ *   Copy the most recently published statistics.
+ *
+ * @details
+ *   Lock-free: can be called from any context, including an interrupt that
+ *   preempts iadcStatsProcess().
+ *
+ * @param[out] stats
+ *   Copy of the statistics.
+ *
+ * @return
+ *   false if nothing has been published yet.
+ ******************************************************************************/
+bool iadcStatsGet(iadcStats_t *stats);
+
+#endif // IADC_STATS_H
@@ -0,0 +1,274 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host benchmark of the streaming statistics on synthetic buffers
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ *******************************************************************************
+ *
+ * Runs ../src/iadc_stats.c on synthetic 12-bit buffers with the FIFO ID bits
+ * set, as the LDMA transfers them with SHOWID, and checks every published
+ * statistic against a double precision reference: the statsWelford() the
+ * example ran before, a direct histogram, and the mean and variance of all
+ * samples so far. Then prints the cycles per sample of iadcStatsProcess() and
+ * of statsWelford() for buffers of the example size and larger ones.
+ *
+ * Cycles are read with the time stamp counter on x86 hosts, elsewhere the
+ * nanoseconds per sample are printed. They compare the two algorithms, the
+ * figure on a Cortex-M33 without a double precision FPU is higher.
+ *
+ * Build:
+ *   cd tools
+ *   cc -O2 -Wall -Wextra -I../src -Istub -o iadc_stats_bench \
+ *      iadc_stats_bench.c ../src/iadc_stats.c -lm
+ ******************************************************************************/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "iadc_stats.h"
+
+#define MAX_SAMPLES   65535
+#define BUFFERS       64
+#define RUNS          200
+
+// FIFO ID bits above the 12-bit result, as with SHOWID
+#define FIFO_ID       (0x5UL << 28)
+
+static uint32_t buffer[MAX_SAMPLES];
+
+static uint64_t randomState = 0x9E3779B97F4A7C15ULL;
+static uint32_t failures;
+
+/***************************************************************************//**
+ * Uniform random number in (0, 1).
+ ******************************************************************************/
+static double uniform(void)
+{
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 7;
+  randomState ^= randomState << 17;
+  return ((randomState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/***************************************************************************//**
+ * Gaussian random number of unit variance.
+ ******************************************************************************/
+static double gaussian(void)
+{
+  return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+/***************************************************************************//**
+ * Fill buffer with FIFO words of mean + sigma * noise, clamped to 12 bits.
+ ******************************************************************************/
+static void generate(uint32_t count, double mean, double sigma)
+{
+  double value;
+
+  for (uint32_t i = 0; i < count; i++) {
+    value = floor(mean + sigma * gaussian() + 0.5);
+    if (value < 0) {
+      value = 0;
+    } else if (value > IADC_STATS_DATA_MASK) {
+      value = IADC_STATS_DATA_MASK;
+    }
+    buffer[i] = FIFO_ID | (uint32_t)value;
+  }
+}
+
+/***************************************************************************//**
+ * Welford mean and variance, as the example computed them before, with the
+ * FIFO ID bits masked.
+ ******************************************************************************/
+static void statsWelford(uint32_t *buffer, uint32_t size, double *mean,
+                         double *var)
+{
+  uint32_t cnt;
+  double M, M2, delta1, delta2;
+
+  M = 0;
+  M2 = 0;
+  for (cnt = 1; cnt <= size; cnt++) {
+    delta1 = (buffer[cnt - 1] & IADC_STATS_DATA_MASK) - M;
+    M += delta1 / cnt;
+    delta2 = (buffer[cnt - 1] & IADC_STATS_DATA_MASK) - M;
+    M2 += delta1 * delta2;
+  }
+  *mean = M;
+  *var = M2 / (size - 1);
+}
+
+/***************************************************************************//**
+ * Count a failure if value is not within tolerance of reference.
+ ******************************************************************************/
+static void check(const char *name, double value, double reference,
+                  double tolerance)
+{
+  if (fabs(value - reference) > tolerance) {
+    printf("  %s: %.6f, expected %.6f\n", name, value, reference);
+    failures++;
+  }
+}
+
+/***************************************************************************//**
+ * Process BUFFERS buffers of a size and compare the results.
+ ******************************************************************************/
+static void test(uint32_t size, double mean, double sigma)
+{
+  uint16_t histogram[IADC_STATS_HIST_BINS];
+  double totalSum = 0, totalSumSq = 0, totalN = 0;
+  double refMean, refVar, rms;
+  uint32_t min, max, code;
+  iadcStats_t stats;
+
+  iadcStatsReset();
+  if (iadcStatsGet(&stats)) {
+    printf("  published before the first buffer\n");
+    failures++;
+  }
+  for (uint32_t b = 0; b < BUFFERS; b++) {
+    // The input drifts a little from buffer to buffer
+    generate(size, mean + b * sigma / 8, sigma);
+    iadcStatsProcess(buffer, size);
+    if (!iadcStatsGet(&stats)) {
+      printf("  nothing published\n");
+      failures++;
+      return;
+    }
+
+    statsWelford(buffer, size, &refMean, &refVar);
+    memset(histogram, 0, sizeof(histogram));
+    min = IADC_STATS_DATA_MASK;
+    max = 0;
+    rms = 0;
+    for (uint32_t i = 0; i < size; i++) {
+      code = buffer[i] & IADC_STATS_DATA_MASK;
+      histogram[code >> (IADC_STATS_RESOLUTION - IADC_STATS_HIST_BITS)]++;
+      min = (code < min) ? code : min;
+      max = (code > max) ? code : max;
+      rms += (double)code * code;
+      totalSum += code;
+      totalSumSq += (double)code * code;
+    }
+    totalN += size;
+
+    // The buffer results are exact, only rounded to float
+    check("buffers", stats.buffers, b + 1, 0);
+    check("samples", stats.samples, size, 0);
+    check("min", stats.min, min, 0);
+    check("max", stats.max, max, 0);
+    check("mean", stats.mean, refMean, 1e-6 * refMean + 1e-6);
+    check("variance", stats.variance, refVar, 1e-5 * refVar + 1e-6);
+    check("rms", stats.rms, sqrt(rms / size), 1e-6 * sqrt(rms / size));
+    check("enob", stats.enob,
+          (refVar * 12 <= 1) ? IADC_STATS_RESOLUTION
+          : IADC_STATS_RESOLUTION - 0.5 * log2(refVar * 12), 1e-4);
+    if (memcmp(histogram, stats.histogram, sizeof(histogram)) != 0) {
+      printf("  histogram differs\n");
+      failures++;
+    }
+    check("totalMean", stats.totalMean, totalSum / totalN,
+          1e-6 * totalSum / totalN);
+    refVar = (totalSumSq - totalSum * totalSum / totalN) / (totalN - 1);
+    check("totalVariance", stats.totalVariance, refVar, 1e-4 * refVar + 1e-6);
+  }
+}
+
+/***************************************************************************//**
+ * Time stamp, in cycles where the host has a counter.
+ ******************************************************************************/
+static uint64_t now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (uint64_t)time.tv_sec * 1000000000ULL + (uint64_t)time.tv_nsec;
+#endif
+}
+
+/***************************************************************************//**
+ * Best of RUNS per sample times of both algorithms on one buffer.
+ ******************************************************************************/
+static void benchmark(uint32_t size)
+{
+  volatile double sink;
+  double mean, var;
+  uint64_t start, ticks, bestStats = UINT64_MAX, bestWelford = UINT64_MAX;
+  iadcStats_t stats;
+
+  generate(size, 2048, 4);
+  iadcStatsReset();
+  for (int run = 0; run < RUNS; run++) {
+    start = now();
+    iadcStatsProcess(buffer, size);
+    ticks = now() - start;
+    bestStats = (ticks < bestStats) ? ticks : bestStats;
+
+    start = now();
+    statsWelford(buffer, size, &mean, &var);
+    ticks = now() - start;
+    bestWelford = (ticks < bestWelford) ? ticks : bestWelford;
+    sink = mean + var;
+  }
+  iadcStatsGet(&stats);
+  (void)sink;
+  printf("%8u %14.2f %14.2f\n", size, (double)bestStats / size,
+         (double)bestWelford / size);
+}
+
+int main(void)
+{
+  static const struct {
+    uint32_t size;
+    double mean;
+    double sigma;
+  } cases[] = {
+    { 2, 2048, 3 },
+    { 7, 100, 1 },
+    { 1024, 2048, 0.2 },
+    { 1024, 1500, 4 },
+    { 1023, 4000, 40 },
+    { 4093, 30, 20 },
+    { MAX_SAMPLES, 2048, 600 },
+  };
+
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    uint32_t before = failures;
+
+    test(cases[c].size, cases[c].mean, cases[c].sigma);
+    printf("%5u samples, mean %6.1f, sigma %5.1f: %s\n", cases[c].size,
+           cases[c].mean, cases[c].sigma, (failures == before) ? "ok" : "FAIL");
+  }
+
+#if defined(__x86_64__) || defined(__i386__)
+  printf("\n%8s %14s %14s\n", "samples", "cycles/sample", "welford");
+#else
+  printf("\n%8s %14s %14s\n", "samples", "ns/sample", "welford");
+#endif
+  benchmark(1024);
+  benchmark(16384);
+  benchmark(MAX_SAMPLES);
+
+  printf("\n%s\n", failures ? "FAIL" : "PASS");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,24 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for em_device.h, for tools/iadc_stats_bench.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef EM_DEVICE_H
+#define EM_DEVICE_H
+
+// Only the memory barrier of iadc_stats.c, as a compiler barrier
+#define __DMB()                   __asm__ volatile ("" ::: "memory")
+
+#endif // EM_DEVICE_H
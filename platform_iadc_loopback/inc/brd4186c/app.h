@@ -41,6 +41,13 @@
 // Timer frequency in Hertz
 #define TIMER_FREQ                5
 
+// Loopback analyzer: samples per block, harmonics in the THD and the
+// nominal sine of the VDAC, against which DC offset and gain errors are given
+#define LOOPBACK_POINTS           1024
+#define LOOPBACK_HARMONICS        5
+#define LOOPBACK_SINE_OFFSET_UV   625000
+#define LOOPBACK_SINE_AMPLITUDE_UV 625000
+
 // Initialize application
 void app_init(void);
 
@@ -0,0 +1,159 @@
+/***************************************************************************//**
+ * @file
+ * @brief Loopback dynamic performance metrics and coherent sampling plan
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef LOOPBACK_METRICS_H
+#define LOOPBACK_METRICS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+// VDAC clock cycles per period of the VDAC sine mode output
+#define LOOPBACK_VDAC_SINE_CLOCKS   32
+
+// Largest VDAC prescaler divider
+#define LOOPBACK_VDAC_MAX_DIVIDER   128
+
+// Size of an encoded report, in bytes
+#define LOOPBACK_REPORT_SIZE        50
+
+/*******************************************************************************
+ *******************************   TYPEDEFS   **********************************
+ ******************************************************************************/
+
+// Clocks of a loopback capture. The VDAC and the IADC run off the same clock,
+// so that a whole number of sine periods fits in a block.
+typedef struct {
+  uint32_t clockHz;         // Common clock
+  uint32_t maxVdacHz;       // Fastest VDAC clock
+  uint32_t srcDivider;      // CLK_SRC_ADC = clockHz / srcDivider
+  uint32_t minTimerCycles;  // Shortest IADC timer period, in CLK_SRC_ADC
+  uint32_t points;          // Samples per block, a power of two
+} loopback_clock_t;
+
+// Coherent capture settings
+typedef struct {
+  uint32_t vdacDivider;     // VDAC clock = clockHz / vdacDivider
+  uint32_t timerCycles;     // IADC timer period, in CLK_SRC_ADC cycles
+  uint32_t cycles;          // Sine periods in the block
+  uint32_t sampleRateHz;    // Rounded
+  uint32_t toneMilliHz;     // Rounded
+} loopback_plan_t;
+
+// Metrics computation settings
+typedef struct {
+  uint32_t points;          // Samples, a power of two, at least 8
+  uint32_t cycles;          // Sine periods in the block, 0 to use the peak
+  uint32_t codeFullScale;   // Largest result, 4095 for 12-bit results
+  uint32_t fullScaleUv;     // Input at codeFullScale, in uV
+  uint32_t expectedDcUv;    // Nominal sine offset, in uV
+  uint32_t expectedAmplitudeUv; // Nominal sine amplitude, 0 if unknown
+  uint32_t harmonics;       // Harmonics in the THD, from the 2nd on
+  uint32_t leakageBins;     // Bins on each side of a tone counted with it
+} loopback_metrics_config_t;
+
+// Dynamic performance of a block, dB values in hundredths of a dB
+typedef struct {
+  int32_t snrCdb;
+  int32_t thdCdb;           // Negative, harmonics below the fundamental
+  int32_t sinadCdb;
+  int32_t sfdrCdb;
+  int32_t enobCentiBits;
+  uint32_t fundamentalBin;
+  int32_t dcUv;             // Mean input
+  uint32_t amplitudeUv;     // Sine amplitude
+  int32_t dcErrorUv;        // Mean input minus the nominal offset
+  int32_t gainErrorPpm;     // Amplitude relative to the nominal one
+} loopback_metrics_t;
+
+// One measured configuration, as sent by the device
+typedef struct {
+  uint8_t configIndex;
+  uint8_t reference;        // IADC_CfgReference_t
+  uint8_t osr;              // IADC_CfgOsrHighSpeed_t
+  uint8_t gain;             // IADC_CfgAnalogGain_t
+  uint16_t points;
+  uint16_t cycles;
+  uint32_t sampleRateHz;
+  uint32_t toneMilliHz;
+  loopback_metrics_t metrics;
+} loopback_report_t;
+
+/*******************************************************************************
+ *****************************   PROTOTYPES   **********************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Find the fastest coherent sample rate.
+ *
+ * The sine period is LOOPBACK_VDAC_SINE_CLOCKS VDAC clocks. A block of
+ * points samples then holds an odd number of sine periods, below points / 2,
+ * so that every sample falls on a different phase of the sine.
+ *
+ * @param[in] clock Capture clocks.
+ * @param[out] plan Settings found.
+ *
+ * @return False if no VDAC divider and IADC timer period fit.
+ ******************************************************************************/
+bool loopback_plan(const loopback_clock_t *clock, loopback_plan_t *plan);
+
+/***************************************************************************//**
+ * Compute the dynamic performance of a block of coherent samples.
+ *
+ * The block is transformed with a rectangular window, which leaves all the
+ * power of a coherent sine in its bin. Harmonics above Nyquist are folded
+ * back.
+ *
+ * @param[in] config Settings.
+ * @param[in] samples Results, config->points of them.
+ * @param[out] work Scratch, 2 * config->points floats.
+ * @param[out] metrics Results.
+ *
+ * @return False if points is not a power of two of at least 8.
+ ******************************************************************************/
+bool loopback_metrics_compute(const loopback_metrics_config_t *config,
+                              const uint32_t *samples,
+                              float *work,
+                              loopback_metrics_t *metrics);
+
+/***************************************************************************//**
+ * Encode a report: "LB", version, payload length, payload in little endian
+ * and a CRC-16/CCITT of all that.
+ *
+ * @param[in] report Report.
+ * @param[out] buffer LOOPBACK_REPORT_SIZE bytes.
+ ******************************************************************************/
+void loopback_report_encode(const loopback_report_t *report, uint8_t *buffer);
+
+/***************************************************************************//**
+ * Decode a report.
+ *
+ * @param[in] buffer Encoded report.
+ * @param[in] length Bytes available at buffer.
+ * @param[out] report Report.
+ *
+ * @return False if there is no valid report at buffer.
+ ******************************************************************************/
+bool loopback_report_decode(const uint8_t *buffer,
+                            size_t length,
+                            loopback_report_t *report);
+
+#endif // LOOPBACK_METRICS_H
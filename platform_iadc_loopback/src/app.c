@@ -20,32 +20,72 @@
 #include "em_device.h"
 #include "em_chip.h"
 #include "em_cmu.h"
+#include "em_core.h"
 #include "em_emu.h"
 #include "em_timer.h"
 #include "em_vdac.h"
 #include "em_gpio.h"
 #include "em_iadc.h"
+#include "em_ldma.h"
 #include "app_log.h"
+#include "sl_iostream.h"
+#include "loopback_metrics.h"
 
 #include "stdbool.h"
 
+// LDMA channel of the block capture
+#define LDMA_CHANNEL              0
+
+// An IADC configuration to characterise
+typedef struct {
+  IADC_CfgReference_t reference;
+  uint32_t vRef;                    // Reference voltage in mV
+  IADC_CfgOsrHighSpeed_t osr;
+  IADC_CfgAnalogGain_t gain;
+} loopback_config_t;
+
+// Configurations measured after reset, one report each. The sine reaches
+// 1.25 V, so the 1.21 V reference needs the 0.5x gain.
+static const loopback_config_t configs[] = {
+  { iadcCfgReferenceInt1V2, 1210, iadcCfgOsrHighSpeed2x,
+    iadcCfgAnalogGain0P5x },
+  { iadcCfgReferenceInt1V2, 1210, iadcCfgOsrHighSpeed8x,
+    iadcCfgAnalogGain0P5x },
+  { iadcCfgReferenceInt1V2, 1210, iadcCfgOsrHighSpeed32x,
+    iadcCfgAnalogGain0P5x },
+  { iadcCfgReferenceVddx, 3300, iadcCfgOsrHighSpeed2x,
+    iadcCfgAnalogGain1x },
+  { iadcCfgReferenceVddx, 3300, iadcCfgOsrHighSpeed8x,
+    iadcCfgAnalogGain1x },
+};
+
+#define CONFIG_COUNT  (sizeof(configs) / sizeof(configs[0]))
+
+// Analog gain times two, indexed by IADC_CfgAnalogGain_t
+static const uint8_t gainTimes2[] = { 1, 2, 4, 6, 8 };
+
 // Local variables
 
-// Enable the IADCs measurement logging
-static volatile bool IADC_measurement_completed = false;
+// Next configuration to measure
+static uint32_t configIndex = 0;
+
+// VDAC clock divider in use, 0 before the VDAC is started
+static uint32_t vdacDivider = 0;
 
-// Raw IADC conversion result
-static volatile IADC_Result_t sample;
+// Block of raw IADC results, then the scratch of the metrics
+static uint32_t samples[LOOPBACK_POINTS];
+static float work[2 * LOOPBACK_POINTS];
 
-// Result converted to volts
-static volatile float single_result;
+// Set by the LDMA interrupt when the block is complete
+static volatile bool captureDone = false;
 
 // CMU initialization
 static void initCMU(void)
 {
   CMU_ClockEnable(cmuClock_GPIO, true);
   // The EM01GRPACLK is chosen as VDAC clock source since the VDAC will be
-  // operating in EM1
+  // operating in EM1. The IADC runs off the same clock, so that a block
+  // can hold a whole number of sine periods.
   CMU_ClockSelectSet(cmuClock_VDAC0, cmuSelect_EM01GRPACLK);
   // Enable the VDAC clocks
   CMU_ClockEnable(cmuClock_VDAC0, true);
@@ -53,17 +93,28 @@ static void initCMU(void)
 
   CMU_ClockSelectSet(cmuClock_IADCCLK, cmuSelect_EM01GRPACLK);
   CMU_ClockEnable(cmuClock_IADC0, true);
+  CMU_ClockEnable(cmuClock_LDMA, true);
 }
 
-// VDAC initialization
-void initVDAC(void)
+// VDAC initialization, the VDAC clock is the EM01GRPACLK divided by divider
+static void initVDAC(uint32_t divider)
 {
   // Use default settings
   VDAC_Init_TypeDef        init = VDAC_INIT_DEFAULT;
   VDAC_InitChannel_TypeDef initChannel = VDAC_INITCHANNEL_DEFAULT;
 
-  // Calculate the VDAC clock prescaler value resulting in a 1 MHz VDAC clock.
-  init.prescaler = VDAC_PrescaleCalc(VDAC0, (uint32_t)VDAC_CLK_FREQ);
+  if (divider == vdacDivider) {
+    return;
+  }
+  if (vdacDivider != 0) {
+    // Stop the sine before changing its frequency
+    VDAC_Reset(VDAC0);
+  }
+  vdacDivider = divider;
+
+  // The sine frequency is the VDAC clock divided by 32, at most 1 MHz
+  // (VDAC_CLK_FREQ) of VDAC clock.
+  init.prescaler = divider - 1;
 
   // Set reference to internal 1.25V low noise reference
   init.reference = vdacRef1V25;
@@ -98,6 +149,9 @@ void initVDAC(void)
 
   // Enable the VDAC
   VDAC_Enable(VDAC0, VDAC_CHANNEL_NUM, true);
+
+  // Start Sine Wave generation
+  VDAC_SineModeStart(VDAC0, true);
 }
 
 // TIMER0 initialization
@@ -132,49 +186,21 @@ static void initTIMER(void)
   TIMER_Enable(TIMER0, true);
 }
 
-// IADC initialization
-void initIADC(void)
+// IADC initialization, conversions are triggered by the IADC local timer
+// and their results moved by the LDMA
+static void initIADC(const IADC_Init_t *init,
+                     const IADC_AllConfigs_t *initAllConfigs)
 {
-  // Declare initialization structures
-  IADC_Init_t init = IADC_INIT_DEFAULT;
-  IADC_AllConfigs_t initAllConfigs = IADC_ALLCONFIGS_DEFAULT;
   IADC_InitSingle_t initSingle = IADC_INITSINGLE_DEFAULT;
 
   // Single input structure
   IADC_SingleInput_t singleInput = IADC_SINGLEINPUT_DEFAULT;
 
-  // Set the prescaler needed for the intended IADC clock frequency
-  init.srcClkPrescale = IADC_calcSrcClkPrescale(IADC0, IADC_CLK_SRC_FREQ, 0);
-
-  // Shutdown between conversions to reduce current
-  init.warmup = iadcWarmupNormal;
-
-  // Configuration 0 is used by both scan and single conversions by
-  // default.  Use internal bandgap as the reference and specify the
-  // reference voltage in mV.
-
-  // Resolution is not configurable directly but is based on the
-  // selected oversampling ratio (osrHighSpeed), which defaults to
-  // 2x and generates 12-bit results.
-
-  initAllConfigs.configs[0].reference = iadcCfgReferenceInt1V2;
-  initAllConfigs.configs[0].vRef = 1210;
-  initAllConfigs.configs[0].osrHighSpeed = iadcCfgOsrHighSpeed2x;
-  initAllConfigs.configs[0].analogGain = iadcCfgAnalogGain0P5x;
-
-  // CLK_SRC_ADC must be prescaled by some value greater than 1 to
-  // derive the intended CLK_ADC frequency.
-
-  // Based on the default 2x oversampling rate (OSRHS)...
-  // conversion time = ((4 * OSRHS) + 2) / fCLK_ADC
-  // ...which results in a maximum sampling rate of 833 ksps with the
-  // 2-clock input multiplexer switching time is included.
-
-  initAllConfigs.configs[0].adcClkPrescale = IADC_calcAdcClkPrescale(IADC0,
-                                                                     IADC_CLK_FREQ,
-                                                                     0,
-                                                                     iadcCfgModeNormal,
-                                                                     init.srcClkPrescale);
+  // One conversion per timer period, each result requests the LDMA
+  initSingle.triggerSelect = iadcTriggerSelTimer;
+  initSingle.triggerAction = iadcTriggerActionOnce;
+  initSingle.dataValidLevel = iadcFifoCfgDvl1;
+  initSingle.fifoDmaWakeup = true;
 
   // Specify the input channel.  When negInput = iadcNegInputGnd, the
   // conversion is single-ended.
@@ -185,26 +211,134 @@ void initIADC(void)
   // Allocate the analog bus for ADC0 inputs
   GPIO->IADC0_BUSALLOC |= IADC0_BUS_REGISTER;
 
+  // Start over from the previous configuration
+  IADC_reset(IADC0);
+
   // Initialize IADC
-  IADC_init(IADC0, &init, &initAllConfigs);
+  IADC_init(IADC0, init, initAllConfigs);
 
   // Initialize a single-channel conversion
   IADC_initSingle(IADC0, &initSingle, &singleInput);
+}
+
+// Capture a block of LOOPBACK_POINTS results at the IADC timer rate
+static void captureBlock(void)
+{
+  static LDMA_Descriptor_t descriptor;
+  LDMA_TransferCfg_t transferCfg =
+    LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_IADC0_IADC_SINGLE);
+  CORE_DECLARE_IRQ_STATE;
+
+  descriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_P2M_WORD(
+    &IADC0->SINGLEFIFODATA, samples, LOOPBACK_POINTS);
 
-  // Clear any previous interrupt flags
-  IADC_clearInt(IADC0, _IADC_IF_MASK);
+  captureDone = false;
+  LDMA_StartTransfer(LDMA_CHANNEL, &transferCfg, &descriptor);
+  IADC_command(IADC0, iadcCmdStartSingle);
+  IADC_command(IADC0, iadcCmdEnableTimer);
+
+  // Sleep until the block is complete
+  while (!captureDone) {
+    CORE_ENTER_CRITICAL();
+    if (!captureDone) {
+      EMU_EnterEM1();
+    }
+    CORE_EXIT_CRITICAL();
+  }
 
-  // Enable single-channel done interrupts
-  IADC_enableInt(IADC0, IADC_IEN_SINGLEDONE);
+  IADC_command(IADC0, iadcCmdDisableTimer);
+  IADC_command(IADC0, iadcCmdStopSingle);
 
-  // Enable IADC interrupts
-  NVIC_ClearPendingIRQ(IADC_IRQn);
-  NVIC_EnableIRQ(IADC_IRQn);
+  // Drop a conversion that completed after the block
+  while (IADC_getSingleFifoCnt(IADC0) > 0) {
+    IADC_pullSingleFifoResult(IADC0);
+  }
+}
+
+// Measure a configuration and send its report
+static void measureConfig(uint32_t index)
+{
+  const loopback_config_t *config = &configs[index];
+  IADC_Init_t init = IADC_INIT_DEFAULT;
+  IADC_AllConfigs_t initAllConfigs = IADC_ALLCONFIGS_DEFAULT;
+  loopback_clock_t clock;
+  loopback_plan_t plan;
+  loopback_metrics_config_t metricsConfig;
+  loopback_report_t report;
+  uint8_t buffer[LOOPBACK_REPORT_SIZE];
+  uint32_t osr = 2 << config->osr;
+
+  // Set the prescaler needed for the intended IADC clock frequency
+  init.srcClkPrescale = IADC_calcSrcClkPrescale(IADC0, IADC_CLK_SRC_FREQ, 0);
+
+  // Stay warm, conversions follow each other at the full rate
+  init.warmup = iadcWarmupKeepWarm;
+
+  initAllConfigs.configs[0].reference = config->reference;
+  initAllConfigs.configs[0].vRef = config->vRef;
+  initAllConfigs.configs[0].osrHighSpeed = config->osr;
+  initAllConfigs.configs[0].analogGain = config->gain;
+  initAllConfigs.configs[0].adcClkPrescale = IADC_calcAdcClkPrescale(IADC0,
+                                                                     IADC_CLK_FREQ,
+                                                                     0,
+                                                                     iadcCfgModeNormal,
+                                                                     init.srcClkPrescale);
+
+  // A conversion takes ((4 * OSRHS) + 2) CLK_ADC cycles, plus 2 for the
+  // input multiplexer. The timer counts CLK_SRC_ADC cycles.
+  clock.clockHz = CMU_ClockFreqGet(cmuClock_IADCCLK);
+  clock.maxVdacHz = VDAC_CLK_FREQ;
+  clock.srcDivider = init.srcClkPrescale + 1;
+  clock.minTimerCycles = (4 * osr + 4)
+                         * (initAllConfigs.configs[0].adcClkPrescale + 1);
+  clock.points = LOOPBACK_POINTS;
+  if (!loopback_plan(&clock, &plan)) {
+    app_log_error("Config %lu: no coherent sample rate\n", index);
+    return;
+  }
+  init.timerCycles = (uint16_t)plan.timerCycles;
+
+  initVDAC(plan.vdacDivider);
+  initIADC(&init, &initAllConfigs);
+
+  // The first block lets the VDAC and the reference settle
+  captureBlock();
+  captureBlock();
+
+  metricsConfig.points = LOOPBACK_POINTS;
+  metricsConfig.cycles = plan.cycles;
+  metricsConfig.codeFullScale = 0xFFF;
+  metricsConfig.fullScaleUv = config->vRef * 2000 / gainTimes2[config->gain];
+  metricsConfig.expectedDcUv = LOOPBACK_SINE_OFFSET_UV;
+  metricsConfig.expectedAmplitudeUv = LOOPBACK_SINE_AMPLITUDE_UV;
+  metricsConfig.harmonics = LOOPBACK_HARMONICS;
+  metricsConfig.leakageBins = 0;
+  loopback_metrics_compute(&metricsConfig, samples, work, &report.metrics);
+
+  report.configIndex = (uint8_t)index;
+  report.reference = (uint8_t)config->reference;
+  report.osr = (uint8_t)config->osr;
+  report.gain = (uint8_t)config->gain;
+  report.points = LOOPBACK_POINTS;
+  report.cycles = (uint16_t)plan.cycles;
+  report.sampleRateHz = plan.sampleRateHz;
+  report.toneMilliHz = plan.toneMilliHz;
+  loopback_report_encode(&report, buffer);
+  sl_iostream_write(SL_IOSTREAM_STDOUT, buffer, sizeof(buffer));
+
+  // Readable summary, dB and bits in hundredths
+  app_log_info("Config %lu: %lu sps, SNR %ld, THD %ld, SINAD %ld, "
+               "ENOB %ld, DC error %ld uV, gain error %ld ppm\n",
+               index, plan.sampleRateHz, report.metrics.snrCdb,
+               report.metrics.thdCdb, report.metrics.sinadCdb,
+               report.metrics.enobCentiBits, report.metrics.dcErrorUv,
+               report.metrics.gainErrorPpm);
 }
 
 // Initializing the application
 void app_init(void)
 {
+  LDMA_Init_t ldmaInit = LDMA_INIT_DEFAULT;
   EMU_DCDCInit_TypeDef dcdcInit = EMU_DCDCINIT_DEFAULT;
   // Enable DC-DC converter
   EMU_DCDCInit(&dcdcInit);
@@ -215,46 +349,30 @@ void app_init(void)
   // Initialize Timer
   initTIMER();
 
-  // Initialize VDAC
-  initVDAC();
-
-  // Initialize IADC
-  initIADC();
-
-  // Start Sine Wave generation
-  VDAC_SineModeStart(VDAC0, true);
-  IADC_command(IADC0, iadcCmdStartSingle);
+  // Initialize LDMA
+  LDMA_Init(&ldmaInit);
 }
 
 // App ticking function
 void app_process_action(void)
 {
-  if (IADC_measurement_completed) {
-    app_log_info("IADC0's measured value is %f\n", single_result);
-    IADC_measurement_completed = false;
-    IADC_command(IADC0, iadcCmdStartSingle);
+  // Go through the configurations once, a report each
+  if (configIndex < CONFIG_COUNT) {
+    measureConfig(configIndex++);
+    return;
   }
   // Enter Sleep mode
   EMU_EnterEM1();
 }
 
-// IADC interrupt handler
-// It will negate a flag that will enable the logging
-// in the app_process_action()
-void IADC_IRQHandler(void)
+// LDMA interrupt handler
+// It will set a flag that ends the capture in captureBlock()
+void LDMA_IRQHandler(void)
 {
-  // Read a result from the FIFO
-  sample = IADC_pullSingleFifoResult(IADC0);
+  uint32_t pending = LDMA_IntGet();
 
-  // Calculate the voltage converted as follows:
-  // For single-ended conversions, the result can range from 0 to
-  // +Vref, i.e., for Vref = VBGR = 1.21V, and with analog gain = 0.5
-  // 0xFFF represents the full scale value of 2.42V.
-  single_result = sample.data * 2.42 / 0xFFF;
-  IADC_measurement_completed = true;
-
-  // Clear the single conversion complete interrupt.  Reading FIFO
-  // results does not do this automatically.
-
-  IADC_clearInt(IADC0, IADC_IF_SINGLEDONE);
+  LDMA_IntClear(pending);
+  if (pending & (1 << LDMA_CHANNEL)) {
+    captureDone = true;
+  }
 }
@@ -0,0 +1,405 @@
+/***************************************************************************//**
+ * @file
+ * @brief Loopback dynamic performance metrics and coherent sampling plan
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <math.h>
+#include <string.h>
+
+#include "loopback_metrics.h"
+
+#define REPORT_VERSION  1
+#define REPORT_PAYLOAD  (LOOPBACK_REPORT_SIZE - 6)
+
+// Largest ratio, in hundredths of a dB, so that it fits a report
+#define CDB_LIMIT       32767
+
+#define PI              3.14159265358979f
+
+/*******************************************************************************
+ ***************************   LOCAL FUNCTIONS   *******************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * In-place radix-2 FFT of points complex values, real and imaginary parts
+ * interleaved.
+ ******************************************************************************/
+static void fft(float *x, uint32_t points)
+{
+  uint32_t i, j, bit, len, half, k, a, b;
+  float t, wr, wi, tr, ti;
+
+  // Bit reversed order
+  for (i = 1, j = 0; i < points; i++) {
+    for (bit = points >> 1; j & bit; bit >>= 1) {
+      j ^= bit;
+    }
+    j ^= bit;
+    if (i < j) {
+      t = x[2 * i];
+      x[2 * i] = x[2 * j];
+      x[2 * j] = t;
+      t = x[2 * i + 1];
+      x[2 * i + 1] = x[2 * j + 1];
+      x[2 * j + 1] = t;
+    }
+  }
+
+  // Each twiddle factor is computed once per stage, rather than by
+  // recurrence, so that rounding errors do not pile up over a large block.
+  for (len = 2; len <= points; len <<= 1) {
+    half = len >> 1;
+    for (k = 0; k < half; k++) {
+      wr = cosf(-2.0f * PI * (float)k / (float)len);
+      wi = sinf(-2.0f * PI * (float)k / (float)len);
+      for (a = k; a < points; a += len) {
+        b = a + half;
+        tr = x[2 * b] * wr - x[2 * b + 1] * wi;
+        ti = x[2 * b] * wi + x[2 * b + 1] * wr;
+        x[2 * b] = x[2 * a] - tr;
+        x[2 * b + 1] = x[2 * a + 1] - ti;
+        x[2 * a] += tr;
+        x[2 * a + 1] += ti;
+      }
+    }
+  }
+}
+
+/***************************************************************************//**
+ * Take the power of the bins within leakage of a bin, leaving the DC bins
+ * out, and clear them so that they are not counted twice.
+ ******************************************************************************/
+static double take_bins(float *power, uint32_t bin, uint32_t leakage,
+                        uint32_t half)
+{
+  uint32_t first, last, k;
+  double sum = 0.0;
+
+  first = (bin > (2 * leakage)) ? bin - leakage : leakage + 1;
+  last = bin + leakage;
+  if (last > half) {
+    last = half;
+  }
+  for (k = first; k <= last; k++) {
+    sum += power[k];
+    power[k] = 0.0f;
+  }
+  return sum;
+}
+
+/***************************************************************************//**
+ * Ratio of two powers, in hundredths of a dB.
+ ******************************************************************************/
+static int32_t ratio_cdb(double numerator, double denominator)
+{
+  double cdb;
+
+  if (numerator <= 0.0) {
+    return -CDB_LIMIT;
+  }
+  if (denominator <= 0.0) {
+    return CDB_LIMIT;
+  }
+  cdb = 1000.0 * log10(numerator / denominator);
+  if (cdb > CDB_LIMIT) {
+    return CDB_LIMIT;
+  }
+  if (cdb < -CDB_LIMIT) {
+    return -CDB_LIMIT;
+  }
+  return (int32_t)lround(cdb);
+}
+
+/***************************************************************************//**
+ * Clamp a value to a signed 16-bit report field.
+ ******************************************************************************/
+static int16_t clamp16(int32_t value)
+{
+  if (value > INT16_MAX) {
+    return INT16_MAX;
+  }
+  if (value < INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (int16_t)value;
+}
+
+/***************************************************************************//**
+ * CRC-16/CCITT, polynomial 0x1021, initial value 0xFFFF.
+ ******************************************************************************/
+static uint16_t crc16(const uint8_t *data, size_t length)
+{
+  uint16_t crc = 0xFFFF;
+
+  while (length-- > 0) {
+    crc ^= (uint16_t)(*data++ << 8);
+    for (uint32_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021)
+            : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+/***************************************************************************//**
+ * Little endian field accessors of the report.
+ ******************************************************************************/
+static uint8_t *put16(uint8_t *buffer, uint16_t value)
+{
+  buffer[0] = (uint8_t)value;
+  buffer[1] = (uint8_t)(value >> 8);
+  return buffer + 2;
+}
+
+static uint8_t *put32(uint8_t *buffer, uint32_t value)
+{
+  buffer = put16(buffer, (uint16_t)value);
+  return put16(buffer, (uint16_t)(value >> 16));
+}
+
+static uint16_t get16(const uint8_t **buffer)
+{
+  uint16_t value = (uint16_t)((*buffer)[0] | ((*buffer)[1] << 8));
+
+  *buffer += 2;
+  return value;
+}
+
+static uint32_t get32(const uint8_t **buffer)
+{
+  uint32_t value = get16(buffer);
+
+  return value | ((uint32_t)get16(buffer) << 16);
+}
+
+/*******************************************************************************
+ **************************   GLOBAL FUNCTIONS   *******************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Find the fastest coherent sample rate.
+ ******************************************************************************/
+bool loopback_plan(const loopback_clock_t *clock, loopback_plan_t *plan)
+{
+  uint64_t clocks, period;
+  uint32_t divider, step, cycles;
+  bool found = false;
+
+  // A divider that is a multiple of points / 32 makes the block a whole
+  // number of sine periods for any timer period that is a multiple of the
+  // remaining factor.
+  step = clock->points / LOOPBACK_VDAC_SINE_CLOCKS;
+  if (step == 0) {
+    step = 1;
+  }
+  divider = (clock->clockHz + clock->maxVdacHz - 1) / clock->maxVdacHz;
+  divider = ((divider + step - 1) / step) * step;
+
+  for (; divider <= LOOPBACK_VDAC_MAX_DIVIDER; divider += step) {
+    period = (uint64_t)LOOPBACK_VDAC_SINE_CLOCKS * divider;
+    for (uint32_t timer = clock->minTimerCycles; timer <= 0xFFFF; timer++) {
+      // Common clocks in a block
+      clocks = (uint64_t)clock->points * clock->srcDivider * timer;
+      cycles = (uint32_t)(clocks / period);
+      if (cycles >= (clock->points / 2)) {
+        break;
+      }
+      if (((clocks % period) != 0) || ((cycles & 1) == 0)) {
+        continue;
+      }
+      if (!found || (timer < plan->timerCycles)) {
+        plan->vdacDivider = divider;
+        plan->timerCycles = timer;
+        plan->cycles = cycles;
+        found = true;
+      }
+      break;
+    }
+  }
+
+  if (found) {
+    period = (uint64_t)clock->srcDivider * plan->timerCycles;
+    plan->sampleRateHz = (uint32_t)((clock->clockHz + period / 2) / period);
+    period = (uint64_t)LOOPBACK_VDAC_SINE_CLOCKS * plan->vdacDivider;
+    plan->toneMilliHz =
+      (uint32_t)(((uint64_t)clock->clockHz * 1000 + period / 2) / period);
+  }
+  return found;
+}
+
+/***************************************************************************//**
+ * Compute the dynamic performance of a block of coherent samples.
+ ******************************************************************************/
+bool loopback_metrics_compute(const loopback_metrics_config_t *config,
+                              const uint32_t *samples,
+                              float *work,
+                              loopback_metrics_t *metrics)
+{
+  uint32_t points = config->points;
+  uint32_t half = points / 2;
+  uint32_t leakage = config->leakageBins;
+  uint32_t fundamental, bin, k;
+  uint64_t sum = 0;
+  double mean, total = 0.0, signal, harmonics = 0.0, noise, spur = 0.0;
+  double uvPerCode, amplitude, sinad;
+
+  if ((points < 8) || (points & (points - 1)) || ((2 * leakage + 2) > half)) {
+    return false;
+  }
+
+  // The mean is taken out before the transform, so that large codes do not
+  // eat into the float precision of the small bins.
+  for (k = 0; k < points; k++) {
+    sum += samples[k];
+  }
+  mean = (double)sum / points;
+  for (k = 0; k < points; k++) {
+    work[2 * k] = (float)((double)samples[k] - mean);
+    work[2 * k + 1] = 0.0f;
+  }
+  fft(work, points);
+
+  // Single-sided power spectrum, in place: bin k only reads entries 2k and
+  // 2k + 1, which are not overwritten yet.
+  for (k = 0; k <= half; k++) {
+    work[k] = (work[2 * k] * work[2 * k] + work[2 * k + 1] * work[2 * k + 1])
+              * ((k == half) ? 1.0f : 2.0f);
+  }
+  for (k = leakage + 1; k <= half; k++) {
+    total += work[k];
+  }
+
+  fundamental = config->cycles;
+  if ((fundamental == 0) || (fundamental > half)) {
+    fundamental = leakage + 1;
+    for (k = leakage + 2; k <= half; k++) {
+      if (work[k] > work[fundamental]) {
+        fundamental = k;
+      }
+    }
+  }
+  signal = take_bins(work, fundamental, leakage, half);
+
+  // Largest remaining bin, harmonic or not
+  for (k = leakage + 1; k <= half; k++) {
+    if (work[k] > spur) {
+      spur = work[k];
+    }
+  }
+
+  // Harmonics above Nyquist show up folded back
+  for (uint32_t h = 2; h < (config->harmonics + 2); h++) {
+    bin = (uint32_t)(((uint64_t)h * fundamental) % points);
+    if (bin > half) {
+      bin = points - bin;
+    }
+    if (bin > leakage) {
+      harmonics += take_bins(work, bin, leakage, half);
+    }
+  }
+  noise = total - signal - harmonics;
+
+  metrics->fundamentalBin = fundamental;
+  metrics->snrCdb = ratio_cdb(signal, noise);
+  metrics->thdCdb = ratio_cdb(harmonics, signal);
+  metrics->sinadCdb = ratio_cdb(signal, noise + harmonics);
+  metrics->sfdrCdb = ratio_cdb(signal, spur);
+  sinad = metrics->sinadCdb / 100.0;
+  metrics->enobCentiBits = (int32_t)lround((sinad - 1.76) / 6.02 * 100.0);
+
+  uvPerCode = (double)config->fullScaleUv / config->codeFullScale;
+  amplitude = sqrt(2.0 * signal) / points * uvPerCode;
+  metrics->dcUv = (int32_t)lround(mean * uvPerCode);
+  metrics->amplitudeUv = (uint32_t)lround(amplitude);
+  metrics->dcErrorUv = metrics->dcUv - (int32_t)config->expectedDcUv;
+  metrics->gainErrorPpm = 0;
+  if (config->expectedAmplitudeUv != 0) {
+    metrics->gainErrorPpm =
+      (int32_t)lround((amplitude / config->expectedAmplitudeUv - 1.0) * 1e6);
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * Encode a report.
+ ******************************************************************************/
+void loopback_report_encode(const loopback_report_t *report, uint8_t *buffer)
+{
+  const loopback_metrics_t *metrics = &report->metrics;
+  uint8_t *p = buffer;
+
+  *p++ = 'L';
+  *p++ = 'B';
+  *p++ = REPORT_VERSION;
+  *p++ = REPORT_PAYLOAD;
+  *p++ = report->configIndex;
+  *p++ = report->reference;
+  *p++ = report->osr;
+  *p++ = report->gain;
+  p = put16(p, report->points);
+  p = put16(p, report->cycles);
+  p = put32(p, report->sampleRateHz);
+  p = put32(p, report->toneMilliHz);
+  p = put16(p, (uint16_t)clamp16(metrics->snrCdb));
+  p = put16(p, (uint16_t)clamp16(metrics->thdCdb));
+  p = put16(p, (uint16_t)clamp16(metrics->sinadCdb));
+  p = put16(p, (uint16_t)clamp16(metrics->sfdrCdb));
+  p = put16(p, (uint16_t)clamp16(metrics->enobCentiBits));
+  p = put16(p, (uint16_t)metrics->fundamentalBin);
+  p = put32(p, (uint32_t)metrics->dcUv);
+  p = put32(p, metrics->amplitudeUv);
+  p = put32(p, (uint32_t)metrics->dcErrorUv);
+  p = put32(p, (uint32_t)metrics->gainErrorPpm);
+  put16(p, crc16(buffer, LOOPBACK_REPORT_SIZE - 2));
+}
+
+/***************************************************************************//**
+ * Decode a report.
+ ******************************************************************************/
+bool loopback_report_decode(const uint8_t *buffer,
+                            size_t length,
+                            loopback_report_t *report)
+{
+  loopback_metrics_t *metrics = &report->metrics;
+  const uint8_t *p = &buffer[LOOPBACK_REPORT_SIZE - 2];
+
+  if ((length < LOOPBACK_REPORT_SIZE)
+      || (buffer[0] != 'L') || (buffer[1] != 'B')
+      || (buffer[2] != REPORT_VERSION) || (buffer[3] != REPORT_PAYLOAD)
+      || (get16(&p) != crc16(buffer, LOOPBACK_REPORT_SIZE - 2))) {
+    return false;
+  }
+
+  memset(report, 0, sizeof(*report));
+  p = &buffer[4];
+  report->configIndex = *p++;
+  report->reference = *p++;
+  report->osr = *p++;
+  report->gain = *p++;
+  report->points = get16(&p);
+  report->cycles = get16(&p);
+  report->sampleRateHz = get32(&p);
+  report->toneMilliHz = get32(&p);
+  metrics->snrCdb = (int16_t)get16(&p);
+  metrics->thdCdb = (int16_t)get16(&p);
+  metrics->sinadCdb = (int16_t)get16(&p);
+  metrics->sfdrCdb = (int16_t)get16(&p);
+  metrics->enobCentiBits = (int16_t)get16(&p);
+  metrics->fundamentalBin = get16(&p);
+  metrics->dcUv = (int32_t)get32(&p);
+  metrics->amplitudeUv = get32(&p);
+  metrics->dcErrorUv = (int32_t)get32(&p);
+  metrics->gainErrorPpm = (int32_t)get32(&p);
+  return true;
+}
@@ -0,0 +1,341 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host test of the loopback metrics engine with synthetic tones
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ *******************************************************************************
+ *
+ * Runs ../src/loopback_metrics.c on synthetic sine blocks of known distortion,
+ * noise, offset and amplitude and checks the results, and decodes the binary
+ * reports sent by the device.
+ *
+ * Build:
+ *   cc -O2 -I../inc -o loopback_metrics_test loopback_metrics_test.c \
+ *      ../src/loopback_metrics.c -lm
+ *
+ * Usage:
+ *   loopback_metrics_test              Run the tests
+ *   loopback_metrics_test --decode F   Print the reports found in capture F,
+ *                                      the raw bytes read from the VCOM port
+ ******************************************************************************/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "loopback_metrics.h"
+
+#define MAX_POINTS    4096
+#define MAX_HARMONICS 4
+
+typedef struct {
+  const char *name;
+  uint32_t points;
+  uint32_t cycles;          // Sine periods, also given to the engine
+  uint32_t codeFullScale;
+  uint32_t fullScaleUv;
+  double offsetUv;
+  double amplitudeUv;
+  double harmonicDbc[MAX_HARMONICS];  // 2nd harmonic on, 0 for none
+  double noiseDb;           // Noise power below the sine, 0 for none
+  bool peakSearch;          // Let the engine find the fundamental
+  // Expected results, NAN when not checked
+  double snrDb;
+  double thdDb;
+  double sinadDb;
+  double sfdrDb;
+  double enobBits;
+  double dbTolerance;
+  double dcErrorUv;
+  double gainErrorPpm;
+} test_tone_t;
+
+static const test_tone_t tones[] = {
+  {
+    .name = "12-bit quantized sine",
+    .points = 1024, .cycles = 25,
+    .codeFullScale = 4095, .fullScaleUv = 2420000,
+    .offsetUv = 1210000, .amplitudeUv = 1209700,
+    .snrDb = NAN, .thdDb = NAN, .sinadDb = 74.0, .sfdrDb = NAN,
+    .enobBits = 12.0, .dbTolerance = 1.0,
+    .dcErrorUv = NAN, .gainErrorPpm = NAN,
+  },
+  {
+    .name = "harmonics, folded 4th, 70 dB SNR",
+    .points = 1024, .cycles = 201,
+    .codeFullScale = 1048575, .fullScaleUv = 2420000,
+    .offsetUv = 1210000, .amplitudeUv = 1100000,
+    .harmonicDbc = { -60.0, -66.0, -80.0 }, .noiseDb = 70.0,
+    .snrDb = 70.0, .thdDb = -58.99, .sinadDb = 58.68, .sfdrDb = 60.0,
+    .enobBits = 9.45, .dbTolerance = 0.4,
+    .dcErrorUv = NAN, .gainErrorPpm = NAN,
+  },
+  {
+    .name = "offset and gain error",
+    .points = 2048, .cycles = 51,
+    .codeFullScale = 65535, .fullScaleUv = 2420000,
+    .offsetUv = 630000, .amplitudeUv = 624000,
+    .snrDb = NAN, .thdDb = NAN, .sinadDb = NAN, .sfdrDb = NAN,
+    .enobBits = NAN,
+    .dcErrorUv = 5000, .gainErrorPpm = -1600,
+  },
+  {
+    .name = "fundamental search",
+    .points = 512, .cycles = 77,
+    .codeFullScale = 1048575, .fullScaleUv = 2420000,
+    .offsetUv = 1210000, .amplitudeUv = 1000000,
+    .harmonicDbc = { -70.0 }, .noiseDb = 80.0, .peakSearch = true,
+    .snrDb = 80.0, .thdDb = -70.0, .sinadDb = 69.59, .sfdrDb = 70.0,
+    .enobBits = NAN, .dbTolerance = 0.5,
+    .dcErrorUv = NAN, .gainErrorPpm = NAN,
+  },
+};
+
+static uint32_t samples[MAX_POINTS];
+static float work[2 * MAX_POINTS];
+
+static uint64_t randomState = 0x2545F4914F6CDD1DULL;
+static uint32_t failures;
+
+/***************************************************************************//**
+ * Uniform random number in (0, 1).
+ ******************************************************************************/
+static double uniform(void)
+{
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 7;
+  randomState ^= randomState << 17;
+  return ((randomState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/***************************************************************************//**
+ * Gaussian random number of unit variance.
+ ******************************************************************************/
+static double gaussian(void)
+{
+  return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+/***************************************************************************//**
+ * Check a value against its expected value, unless that is NAN.
+ ******************************************************************************/
+static void check(const char *what, double value, double expected,
+                  double tolerance)
+{
+  bool ok;
+
+  if (isnan(expected)) {
+    return;
+  }
+  ok = fabs(value - expected) <= tolerance;
+  printf("  %-8s %12.2f  expected %12.2f +/- %.2f  %s\n",
+         what, value, expected, tolerance, ok ? "ok" : "FAIL");
+  if (!ok) {
+    failures++;
+  }
+}
+
+/***************************************************************************//**
+ * Generate a tone and check the metrics of it.
+ ******************************************************************************/
+static void test_tone(const test_tone_t *tone)
+{
+  loopback_metrics_config_t config = {
+    .points = tone->points,
+    .cycles = tone->peakSearch ? 0 : tone->cycles,
+    .codeFullScale = tone->codeFullScale,
+    .fullScaleUv = tone->fullScaleUv,
+    .expectedDcUv = 625000,
+    .expectedAmplitudeUv = 625000,
+    .harmonics = 5,
+    .leakageBins = 0,
+  };
+  loopback_metrics_t metrics;
+  double codesPerUv = (double)tone->codeFullScale / tone->fullScaleUv;
+  double amplitude = tone->amplitudeUv * codesPerUv;
+  double sigma = 0.0, phase, value;
+
+  if (tone->noiseDb != 0.0) {
+    sigma = amplitude / sqrt(2.0) * pow(10.0, -tone->noiseDb / 20.0);
+  }
+  for (uint32_t n = 0; n < tone->points; n++) {
+    phase = 2.0 * M_PI * tone->cycles * n / tone->points;
+    value = tone->offsetUv * codesPerUv + amplitude * sin(phase + 0.3);
+    for (uint32_t h = 0; h < MAX_HARMONICS; h++) {
+      if (tone->harmonicDbc[h] != 0.0) {
+        value += amplitude * pow(10.0, tone->harmonicDbc[h] / 20.0)
+                 * sin((h + 2) * phase + 1.1 * h);
+      }
+    }
+    value += sigma * gaussian();
+    if (value < 0.0) {
+      value = 0.0;
+    }
+    if (value > tone->codeFullScale) {
+      value = tone->codeFullScale;
+    }
+    samples[n] = (uint32_t)lround(value);
+  }
+
+  printf("%s\n", tone->name);
+  if (!loopback_metrics_compute(&config, samples, work, &metrics)) {
+    printf("  rejected  FAIL\n");
+    failures++;
+    return;
+  }
+  check("bin", metrics.fundamentalBin, tone->cycles, 0.0);
+  check("SNR", metrics.snrCdb / 100.0, tone->snrDb, tone->dbTolerance);
+  check("THD", metrics.thdCdb / 100.0, tone->thdDb, tone->dbTolerance);
+  check("SINAD", metrics.sinadCdb / 100.0, tone->sinadDb, tone->dbTolerance);
+  check("SFDR", metrics.sfdrCdb / 100.0, tone->sfdrDb, tone->dbTolerance);
+  check("ENOB", metrics.enobCentiBits / 100.0, tone->enobBits,
+        tone->dbTolerance / 6.02);
+  check("DC err", metrics.dcErrorUv, tone->dcErrorUv, 40.0);
+  check("gain ppm", metrics.gainErrorPpm, tone->gainErrorPpm, 60.0);
+}
+
+/***************************************************************************//**
+ * Check a coherent sampling plan.
+ ******************************************************************************/
+static void test_plan(uint32_t minTimerCycles, uint32_t divider,
+                      uint32_t timerCycles, uint32_t cycles)
+{
+  loopback_clock_t clock = {
+    .clockHz = 19000000,
+    .maxVdacHz = 1000000,
+    .srcDivider = 1,
+    .minTimerCycles = minTimerCycles,
+    .points = 1024,
+  };
+  loopback_plan_t plan;
+  bool ok;
+
+  ok = loopback_plan(&clock, &plan)
+       && (plan.vdacDivider == divider)
+       && (plan.timerCycles == timerCycles)
+       && (plan.cycles == cycles);
+  printf("plan from %u cycles: divider %u, timer %u, %u periods, "
+         "%u Hz, %u mHz  %s\n",
+         minTimerCycles, plan.vdacDivider, plan.timerCycles, plan.cycles,
+         plan.sampleRateHz, plan.toneMilliHz, ok ? "ok" : "FAIL");
+  if (!ok) {
+    failures++;
+  }
+}
+
+/***************************************************************************//**
+ * Check that a report survives encoding and that corruption is caught.
+ ******************************************************************************/
+static void test_report(void)
+{
+  loopback_report_t report = {
+    .configIndex = 3, .reference = 1, .osr = 4, .gain = 2,
+    .points = 1024, .cycles = 25,
+    .sampleRateHz = 760000, .toneMilliHz = 18554688,
+    .metrics = {
+      .snrCdb = 7012, .thdCdb = -6543, .sinadCdb = 6401, .sfdrCdb = 6620,
+      .enobCentiBits = 1034, .fundamentalBin = 25,
+      .dcUv = 624321, .amplitudeUv = 612345, .dcErrorUv = -679,
+      .gainErrorPpm = -20248,
+    },
+  };
+  loopback_report_t decoded;
+  uint8_t buffer[LOOPBACK_REPORT_SIZE];
+  bool ok;
+
+  loopback_report_encode(&report, buffer);
+  ok = loopback_report_decode(buffer, sizeof(buffer), &decoded)
+       && (memcmp(&report, &decoded, sizeof(report)) == 0);
+  buffer[20] ^= 0x04;
+  ok = ok && !loopback_report_decode(buffer, sizeof(buffer), &decoded);
+  printf("report round trip and CRC  %s\n", ok ? "ok" : "FAIL");
+  if (!ok) {
+    failures++;
+  }
+}
+
+/***************************************************************************//**
+ * Print the reports found in a capture file.
+ ******************************************************************************/
+static int decode_file(const char *path)
+{
+  FILE *file = fopen(path, "rb");
+  uint8_t *data;
+  long length;
+  uint32_t count = 0;
+  loopback_report_t report;
+  const loopback_metrics_t *m = &report.metrics;
+
+  if (file == NULL) {
+    fprintf(stderr, "cannot read %s\n", path);
+    return 1;
+  }
+  fseek(file, 0, SEEK_END);
+  length = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  data = malloc(length > 0 ? (size_t)length : 1);
+  if ((data == NULL) || (fread(data, 1, (size_t)length, file) != (size_t)length)) {
+    fprintf(stderr, "cannot read %s\n", path);
+    fclose(file);
+    free(data);
+    return 1;
+  }
+  fclose(file);
+
+  printf("%3s %3s %3s %4s %8s %10s %7s %7s %7s %7s %6s %9s %8s %9s\n",
+         "cfg", "ref", "osr", "gain", "rate Hz", "tone Hz", "SNR", "THD",
+         "SINAD", "SFDR", "ENOB", "DC uV", "DCerr", "gain ppm");
+  // Text logging shares the port, so reports are looked for at every offset.
+  for (long i = 0; (i + LOOPBACK_REPORT_SIZE) <= length; i++) {
+    if (!loopback_report_decode(&data[i], (size_t)(length - i), &report)) {
+      continue;
+    }
+    printf("%3u %3u %3u %4u %8u %10.3f %7.2f %7.2f %7.2f %7.2f %6.2f "
+           "%9d %8d %9d\n",
+           report.configIndex, report.reference, report.osr, report.gain,
+           report.sampleRateHz, report.toneMilliHz / 1000.0,
+           m->snrCdb / 100.0, m->thdCdb / 100.0, m->sinadCdb / 100.0,
+           m->sfdrCdb / 100.0, m->enobCentiBits / 100.0,
+           m->dcUv, m->dcErrorUv, m->gainErrorPpm);
+    count++;
+    i += LOOPBACK_REPORT_SIZE - 1;
+  }
+  free(data);
+  printf("%u reports\n", count);
+  return count ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+  if ((argc == 3) && (strcmp(argv[1], "--decode") == 0)) {
+    return decode_file(argv[2]);
+  }
+  if (argc != 1) {
+    fprintf(stderr, "usage: %s [--decode capture]\n", argv[0]);
+    return 2;
+  }
+
+  for (uint32_t i = 0; i < sizeof(tones) / sizeof(tones[0]); i++) {
+    test_tone(&tones[i]);
+  }
+  // OSR 2x at CLK_ADC = CLK_SRC_ADC / 2, then a conversion too slow for
+  // the shortest VDAC divider
+  test_plan(24, 32, 25, 25);
+  test_plan(520, 64, 522, 261);
+  test_report();
+
+  printf("%s\n", failures ? "FAILED" : "all passed");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,157 @@
+/***************************************************************************//**
+ * @file
+ * @brief Paced IADC scan acquisition with LDMA and per block results
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#ifndef IADC_SCAN_ACQ_H
+#define IADC_SCAN_ACQ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "em_iadc.h"
+
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+// Scan table entries, one per input
+#define IADC_SCAN_ACQ_MAX_INPUTS  16
+
+// FIFO words in each of the two block buffers. A block of scansPerBlock scans
+// of inputCount inputs must fit.
+#ifndef IADC_SCAN_ACQ_BLOCK_WORDS
+#define IADC_SCAN_ACQ_BLOCK_WORDS 512
+#endif
+
+// LDMA channel moving the scan results
+#ifndef IADC_SCAN_ACQ_LDMA_CH
+#define IADC_SCAN_ACQ_LDMA_CH     0
+#endif
+
+// Input and raw 12-bit result of a FIFO word tagged with its scan table entry
+#define IADC_SCAN_ACQ_WORD_ID(word)    ((word) >> 24)
+#define IADC_SCAN_ACQ_WORD_CODE(word)  ((word) & 0xFFF)
+
+/*******************************************************************************
+ *******************************   TYPEDEFS   **********************************
+ ******************************************************************************/
+
+// What starts each scan
+typedef enum {
+  iadcScanAcqTimer,         // IADC local timer, at scanRateHz
+  iadcScanAcqPrs            // Rising edges of a PRS channel
+} iadc_scan_acq_pacing_t;
+
+// An input, converted in every scan
+typedef struct {
+  IADC_PosInput_t posInput;
+  IADC_NegInput_t negInput;
+} iadc_scan_acq_input_t;
+
+// Results of a block of scans
+typedef struct {
+  uint32_t sequence;        // Block number, counts from 0
+  uint32_t lostBlocks;      // Blocks overwritten before they were handled
+  uint32_t inputCount;
+  uint32_t scans;           // Scans in the block
+  // Per input mean, minimum and maximum over the block, in mV
+  uint32_t mv[IADC_SCAN_ACQ_MAX_INPUTS];
+  uint32_t minMv[IADC_SCAN_ACQ_MAX_INPUTS];
+  uint32_t maxMv[IADC_SCAN_ACQ_MAX_INPUTS];
+  // Words whose tag did not match their position in the block. The results
+  // above use the tags, so they stay right, but the raw layout does not.
+  uint32_t tagErrors;
+  // Raw FIFO words of the block, scan after scan: input i of scan s is
+  // raw[s * inputCount + i]. Valid until the callback returns.
+  const uint32_t *raw;
+} iadc_scan_acq_block_t;
+
+/***************************************************************************//**
+ * Block completion callback, called from the LDMA interrupt.
+ ******************************************************************************/
+typedef void (*iadc_scan_acq_callback_t)(const iadc_scan_acq_block_t *block,
+                                         void *user);
+
+// Acquisition settings
+typedef struct {
+  const iadc_scan_acq_input_t *inputs;
+  uint32_t inputCount;      // 1 to IADC_SCAN_ACQ_MAX_INPUTS
+  iadc_scan_acq_pacing_t pacing;
+  uint32_t scanRateHz;      // iadcScanAcqTimer: scans per second
+  uint32_t prsChannel;      // iadcScanAcqPrs: channel starting the scans
+  uint32_t scansPerBlock;   // Scans per callback
+  iadc_scan_acq_callback_t callback;
+  void *user;
+} iadc_scan_acq_config_t;
+
+/*******************************************************************************
+ *****************************   PROTOTYPES   **********************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Start a paced scan acquisition.
+ *
+ * The IADC is initialized with init and allConfigs, all inputs use
+ * configuration 0. The inputs fill the scan table in order, and each scan is
+ * started by the IADC timer or by the PRS channel. The LDMA moves the FIFO
+ * words, tagged with their scan table entry, into one of two block buffers
+ * and wakes the CPU once per block, in EM2 as well. The block is then sorted
+ * by tag into per input results in mV, and handed to the callback while the
+ * LDMA fills the other buffer.
+ *
+ * With PRS pacing, the producer of the PRS channel is set up by the caller.
+ *
+ * @param[in] init IADC initialization, the timer cycles are set here.
+ * @param[in] allConfigs IADC configurations.
+ * @param[in] config Acquisition settings, copied.
+ *
+ * @return False if the settings cannot be met: no or too many inputs, a
+ *   block larger than IADC_SCAN_ACQ_BLOCK_WORDS, a scan rate out of the IADC
+ *   timer range or faster than the scan conversion time.
+ ******************************************************************************/
+bool iadc_scan_acq_start(IADC_Init_t *init,
+                         const IADC_AllConfigs_t *allConfigs,
+                         const iadc_scan_acq_config_t *config);
+
+/***************************************************************************//**
+ * Stop the acquisition. The block in progress is dropped.
+ ******************************************************************************/
+void iadc_scan_acq_stop(void);
+
+/***************************************************************************//**
+ * Convert a raw result to mV, in fixed point.
+ ******************************************************************************/
+uint32_t iadc_scan_acq_to_mv(uint32_t code);
+
+#endif // IADC_SCAN_ACQ_H
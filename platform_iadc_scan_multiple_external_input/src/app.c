@@ -44,20 +44,28 @@
 
 #include "sl_sleeptimer.h"
 #include "app.h"
+#include "iadc_scan_acq.h"
 #include "printf.h"
 
 /*******************************************************************************
  *******************************   DEFINES   ***********************************
  ******************************************************************************/
-// Sleeptimer period
+// Sleeptimer period, results are printed at this rate
 #define TIMER_TIMEOUT             5000
 
 // Set CLK_ADC to 10MHz
 #define CLK_SRC_ADC_FREQ          20000000 // CLK_SRC_ADC
 #define CLK_ADC_FREQ              10000000 // CLK_ADC - 10 MHz max in normal mode
 
-// Number of scan channels
-#define NUM_INPUTS                3
+// Scans per second, paced by the IADC timer, and scans per block of results
+#define SCAN_RATE_HZ              1000
+#define SCANS_PER_BLOCK           100
+
+// Number of scan channels: the three external inputs, AVDD and DVDD
+#define NUM_INPUTS                5
+
+// AVDD and DVDD are converted divided by 4
+#define SUPPLY_DIVIDER            4
 
 /*
  * Specify the IADC input using the IADC_PosInput_t typedef.  This
@@ -89,7 +97,23 @@
 
 sl_sleeptimer_timer_handle_t my_timer;  // Sleeptimer
 volatile bool timer_expired = false; // Sleeptimer flag
-static volatile double scanResult[NUM_INPUTS];  // Volts
+
+// Scan table, all inputs single-ended
+static const iadc_scan_acq_input_t scanInputs[NUM_INPUTS] = {
+  { IADC_INPUT_0_PORT_PIN, iadcNegInputGnd },
+  { IADC_INPUT_1_PORT_PIN, iadcNegInputGnd },
+  { IADC_INPUT_2_PORT_PIN, iadcNegInputGnd },
+  { iadcPosInputAvdd, iadcNegInputGnd },
+  { iadcPosInputDvdd, iadcNegInputGnd },
+};
+
+// Latest block of results, written by the block callback
+static volatile uint32_t scanMv[NUM_INPUTS];
+static volatile uint32_t scanMinMv[NUM_INPUTS];
+static volatile uint32_t scanMaxMv[NUM_INPUTS];
+static volatile uint32_t blocks = 0;
+static volatile uint32_t lostBlocks = 0;
+static volatile uint32_t tagErrors = 0;
 
 // Sleeptimer callback
 void my_timer_callback(sl_sleeptimer_timer_handle_t *handle, void *data)
@@ -99,6 +123,24 @@ void my_timer_callback(sl_sleeptimer_timer_handle_t *handle, void *data)
   timer_expired = true;
 }
 
+/**************************************************************************//**
+ * @brief  Block callback, from the LDMA interrupt once per SCANS_PER_BLOCK
+ *         scans
+ *****************************************************************************/
+static void scan_block_callback(const iadc_scan_acq_block_t *block, void *user)
+{
+  (void) user;
+
+  for (uint32_t i = 0; i < block->inputCount; i++) {
+    scanMv[i] = block->mv[i];
+    scanMinMv[i] = block->minMv[i];
+    scanMaxMv[i] = block->maxMv[i];
+  }
+  blocks = block->sequence + 1;
+  lostBlocks = block->lostBlocks;
+  tagErrors += block->tagErrors;
+}
+
 /**************************************************************************//**
  * @brief  IADC Initializer
  *****************************************************************************/
@@ -107,8 +149,15 @@ void initIADC(void)
   // Declare init structs
   IADC_Init_t init = IADC_INIT_DEFAULT;
   IADC_AllConfigs_t initAllConfigs = IADC_ALLCONFIGS_DEFAULT;
-  IADC_InitScan_t initScan = IADC_INITSCAN_DEFAULT;
-  IADC_ScanTable_t initScanTable = IADC_SCANTABLE_DEFAULT;  // Scan Table
+  iadc_scan_acq_config_t acqConfig = {
+    .inputs = scanInputs,
+    .inputCount = NUM_INPUTS,
+    .pacing = iadcScanAcqTimer,
+    .scanRateHz = SCAN_RATE_HZ,
+    .scansPerBlock = SCANS_PER_BLOCK,
+    .callback = scan_block_callback,
+    .user = NULL,
+  };
 
   /*
    * Enable IADC0 and GPIO clock branches.
@@ -120,6 +169,7 @@ void initIADC(void)
    */
   CMU_ClockEnable(cmuClock_IADC0, true);
   CMU_ClockEnable(cmuClock_GPIO, true);
+  CMU_ClockEnable(cmuClock_LDMA, true);
 
   // Select clock for IADC
   CMU_ClockSelectSet(cmuClock_IADCCLK, cmuSelect_FSRCO);
@@ -151,83 +201,20 @@ void initIADC(void)
                                                                      iadcCfgModeNormal,
                                                                      init.srcClkPrescale);
 
-  /*
-   * Similarly, the fifoDmaWakeup member of the initScan structure
-   * is left at its default setting of false, so LDMA service is not
-   * requested when the FIFO holds the specified number of samples.
-   */
-  initScan.dataValidLevel = _IADC_SCANFIFOCFG_DVL_VALID3;
-
-  // Tag FIFO entry with scan table entry id.
-  initScan.showId = true;
-
-  /*
-   * Configure entries in scan table.  All channels are measured
-   * as single-ended.
-   */
-  initScanTable.entries[0].posInput = IADC_INPUT_0_PORT_PIN;
-  initScanTable.entries[0].negInput = iadcNegInputGnd;
-  initScanTable.entries[0].includeInScan = true;
-
-  initScanTable.entries[1].posInput = IADC_INPUT_1_PORT_PIN;
-  initScanTable.entries[1].negInput = iadcNegInputGnd;
-  initScanTable.entries[1].includeInScan = true;
-
-  initScanTable.entries[2].posInput = IADC_INPUT_2_PORT_PIN;
-  initScanTable.entries[2].negInput = iadcNegInputGnd;
-  initScanTable.entries[2].includeInScan = true;
-
-  // Initialize IADC
-  IADC_init(IADC0, &init, &initAllConfigs);
-
-  // Initialize scan
-  IADC_initScan(IADC0, &initScan, &initScanTable);
-
   // Allocate the analog bus for ADC0 inputs
   GPIO->IADC_INPUT_0_BUS |= IADC_INPUT_0_BUSALLOC;
   GPIO->IADC_INPUT_1_BUS |= IADC_INPUT_1_BUSALLOC;
   GPIO->IADC_INPUT_2_BUS |= IADC_INPUT_2_BUSALLOC;
   GPIO->IADC_INPUT_3_BUS |= IADC_INPUT_3_BUSALLOC;
 
-  // Clear any previous interrupt flags
-  IADC_clearInt(IADC0, _IADC_IF_MASK);
-
-  // Enable Scan interrupts
-  IADC_enableInt(IADC0, IADC_IEN_SCANTABLEDONE);
-
-  // Enable ADC interrupts
-  NVIC_ClearPendingIRQ(IADC_IRQn);
-  NVIC_EnableIRQ(IADC_IRQn);
-}
-
-/**************************************************************************//**
- * @brief  IADC interrupt handler
- *****************************************************************************/
-void IADC_IRQHandler(void)
-{
-  IADC_Result_t result = { 0, 0 };
-
-  // While the FIFO count is non-zero...
-  while (IADC_getScanFifoCnt(IADC0))
-  {
-    // Pull a scan result from the FIFO
-    result = IADC_pullScanFifoResult(IADC0);
-
-    /*
-     * Calculate the voltage converted as follows:
-     *
-     * For single-ended conversions, the result can range from 0 to
-     * +Vref, i.e., for Vref = VBGR = 3.3V, and with analog gain = 1
-     * 0xFFF represents the full scale value of 3.3V.
-     */
-    scanResult[result.id] = result.data * 3.3 / 0xFFF;
-  }
-
   /*
-   * Clear the scan table complete interrupt.  Reading FIFO results
-   * does not do this automatically.
+   * The IADC timer starts a scan of the whole table every 1 / SCAN_RATE_HZ
+   * seconds, and the LDMA moves the tagged results into a block buffer. The
+   * CPU only wakes up at the end of each block.
    */
-  IADC_clearInt(IADC0, IADC_IF_SCANTABLEDONE);
+  if (!iadc_scan_acq_start(&init, &initAllConfigs, &acqConfig)) {
+    printf("Scan acquisition settings out of range\r\n");
+  }
 }
 
 void app_init(void)
@@ -249,13 +236,29 @@ void app_init(void)
  ******************************************************************************/
 void app_process_action(void)
 {
+  uint32_t mv[NUM_INPUTS], minMv[NUM_INPUTS], maxMv[NUM_INPUTS];
+  uint32_t count;
+
   if (timer_expired == true) {
     timer_expired = false;
-    IADC_command(IADC0, iadcCmdStartScan);
-    // delay for the command
-    for (volatile uint32_t i = 0; i < 100000; i++) {}
-    printf("\r\nData1: %f \r\n", scanResult[0]);
-    printf("Data2: %f \r\n", scanResult[1]);
-    printf("Data3: %f \r\n", scanResult[2]);
+
+    // Copy a consistent block, the callback may run in between
+    do {
+      count = blocks;
+      for (uint32_t i = 0; i < NUM_INPUTS; i++) {
+        mv[i] = scanMv[i];
+        minMv[i] = scanMinMv[i];
+        maxMv[i] = scanMaxMv[i];
+      }
+    } while (count != blocks);
+
+    printf("\r\nBlock %lu (%lu lost, %lu tag errors)\r\n",
+           count, lostBlocks, tagErrors);
+    for (uint32_t i = 0; i < 3; i++) {
+      printf("Data%lu: %lu mV (%lu..%lu)\r\n",
+             i + 1, mv[i], minMv[i], maxMv[i]);
+    }
+    printf("AVDD: %lu mV\r\n", mv[3] * SUPPLY_DIVIDER);
+    printf("DVDD: %lu mV\r\n", mv[4] * SUPPLY_DIVIDER);
   }
 }
@@ -0,0 +1,337 @@
+/***************************************************************************//**
+ * @file
+ * @brief Paced IADC scan acquisition with LDMA and per block results
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Evaluation Quality
+ * This code has been minimally tested to ensure that it builds and is suitable
+ * as a demonstration for evaluation purposes only. This code will be maintained
+ * at the sole discretion of Silicon Labs.
+ ******************************************************************************/
+
+#include "em_cmu.h"
+#include "em_core.h"
+#include "em_iadc.h"
+#include "em_ldma.h"
+#include "em_prs.h"
+
+#include "iadc_scan_acq.h"
+
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+#define CH_MASK       (1UL << IADC_SCAN_ACQ_LDMA_CH)
+
+// Largest code of a scan word
+#define CODE_MAX      IADC_SCAN_ACQ_WORD_CODE(0xFFFFFFFFUL)
+
+// IADC warm-up from shutdown, before each scan unless kept warm
+#define WARMUP_NS     5000
+
+/*******************************************************************************
+ ***************************   GLOBAL VARIABLES  *******************************
+ ******************************************************************************/
+
+static iadc_scan_acq_config_t acq;
+static bool running = false;
+
+// Two block buffers, one filled by the LDMA while the other is handled
+static uint32_t blockBuffer[2][IADC_SCAN_ACQ_BLOCK_WORDS];
+static LDMA_Descriptor_t blockDesc[2];
+static uint32_t blockWords;
+
+// Block handed to the callback, and number of the next one
+static iadc_scan_acq_block_t block;
+static uint32_t sequence;
+static uint32_t lostBlocks;
+
+static uint32_t fullScaleMv;
+
+/*******************************************************************************
+ *********************   STATIC FUNCTION DEFINATION ****************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Time from a timer trigger to the last result of a scan of all inputs.
+ *
+ * Each scan table entry takes ((4 * OSR) + 2) * averages CLK_ADC cycles, plus
+ * 2 to switch to its input. Unless kept warm, the IADC warms up first.
+ ******************************************************************************/
+static uint32_t scan_ns(const IADC_Init_t *init,
+                        const IADC_AllConfigs_t *allConfigs,
+                        uint32_t inputCount)
+{
+  const IADC_Config_t *config = &allConfigs->configs[0];
+  uint32_t clkAdc, cycles;
+
+  clkAdc = CMU_ClockFreqGet(cmuClock_IADCCLK)
+           / (init->srcClkPrescale + 1)
+           / (config->adcClkPrescale + 1);
+  cycles = inputCount * ((4 * (2UL << config->osrHighSpeed) + 2)
+                         * (1UL << config->digAvg) + 2);
+  return (uint32_t)(((uint64_t)cycles * 1000000000ULL + clkAdc - 1) / clkAdc)
+         + ((init->warmup == iadcWarmupNormal) ? WARMUP_NS : 0);
+}
+
+/***************************************************************************//**
+ * Start the LDMA on the two block buffers, one after the other, forever.
+ ******************************************************************************/
+static void ldma_start(void)
+{
+  LDMA_Init_t init = LDMA_INIT_DEFAULT;
+  LDMA_TransferCfg_t cfg =
+    LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_IADC0_IADC_SCAN);
+
+  LDMA_Init(&init);
+
+  blockDesc[0] = (LDMA_Descriptor_t)
+                 LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(&IADC0->SCANFIFODATA,
+                                                  blockBuffer[0],
+                                                  blockWords,
+                                                  1);
+  blockDesc[1] = (LDMA_Descriptor_t)
+                 LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(&IADC0->SCANFIFODATA,
+                                                  blockBuffer[1],
+                                                  blockWords,
+                                                  -1);
+  for (uint32_t i = 0; i < 2; i++) {
+    blockDesc[i].xfer.size = ldmaCtrlSizeWord;
+    blockDesc[i].xfer.doneIfs = 1;
+  }
+  LDMA_StartTransfer(IADC_SCAN_ACQ_LDMA_CH, &cfg, blockDesc);
+}
+
+/***************************************************************************//**
+ * Mean of count raw results, in mV.
+ ******************************************************************************/
+static uint32_t mean_mv(uint32_t sum, uint32_t count)
+{
+  uint64_t scale = (uint64_t)count * CODE_MAX;
+
+  return (uint32_t)(((uint64_t)sum * fullScaleMv + scale / 2) / scale);
+}
+
+/***************************************************************************//**
+ * Sort the words of a full block buffer by tag and call back.
+ ******************************************************************************/
+static void block_handle(const uint32_t *raw)
+{
+  uint32_t sum[IADC_SCAN_ACQ_MAX_INPUTS] = { 0 };
+  uint32_t count[IADC_SCAN_ACQ_MAX_INPUTS] = { 0 };
+  uint32_t minCode[IADC_SCAN_ACQ_MAX_INPUTS];
+  uint32_t maxCode[IADC_SCAN_ACQ_MAX_INPUTS] = { 0 };
+  uint32_t entry = 0, id, code, i;
+
+  block.tagErrors = 0;
+  for (i = 0; i < acq.inputCount; i++) {
+    minCode[i] = CODE_MAX;
+  }
+
+  for (i = 0; i < blockWords; i++) {
+    id = IADC_SCAN_ACQ_WORD_ID(raw[i]);
+    code = IADC_SCAN_ACQ_WORD_CODE(raw[i]);
+    if (id != entry) {
+      block.tagErrors++;
+    }
+    if (++entry == acq.inputCount) {
+      entry = 0;
+    }
+    if (id >= acq.inputCount) {
+      continue;
+    }
+    sum[id] += code;
+    count[id]++;
+    if (code < minCode[id]) {
+      minCode[id] = code;
+    }
+    if (code > maxCode[id]) {
+      maxCode[id] = code;
+    }
+  }
+
+  for (i = 0; i < acq.inputCount; i++) {
+    if (count[i] == 0) {
+      block.mv[i] = 0;
+      block.minMv[i] = 0;
+      block.maxMv[i] = 0;
+      continue;
+    }
+    block.mv[i] = mean_mv(sum[i], count[i]);
+    block.minMv[i] = iadc_scan_acq_to_mv(minCode[i]);
+    block.maxMv[i] = iadc_scan_acq_to_mv(maxCode[i]);
+  }
+
+  block.sequence = sequence;
+  block.lostBlocks = lostBlocks;
+  block.raw = raw;
+  acq.callback(&block, acq.user);
+}
+
+/*******************************************************************************
+ **************************   GLOBAL FUNCTIONS   *******************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Start a paced scan acquisition.
+ ******************************************************************************/
+bool iadc_scan_acq_start(IADC_Init_t *init,
+                         const IADC_AllConfigs_t *allConfigs,
+                         const iadc_scan_acq_config_t *config)
+{
+  IADC_InitScan_t initScan = IADC_INITSCAN_DEFAULT;
+  IADC_ScanTable_t scanTable = IADC_SCANTABLE_DEFAULT;
+  uint32_t srcClk, cycles, gain, i;
+
+  if ((config->inputCount == 0)
+      || (config->inputCount > IADC_SCAN_ACQ_MAX_INPUTS)
+      || (config->scansPerBlock == 0)
+      || (config->scansPerBlock
+          > (IADC_SCAN_ACQ_BLOCK_WORDS / config->inputCount))
+      || (config->callback == NULL)) {
+    return false;
+  }
+
+  if (config->pacing == iadcScanAcqTimer) {
+    // The IADC timer counts CLK_SRC_ADC cycles in 16 bits, and a scan has
+    // to be over before the next trigger.
+    if (config->scanRateHz == 0) {
+      return false;
+    }
+    srcClk = CMU_ClockFreqGet(cmuClock_IADCCLK) / (init->srcClkPrescale + 1);
+    cycles = srcClk / config->scanRateHz;
+    if ((cycles == 0) || (cycles > 0xFFFF)
+        || (scan_ns(init, allConfigs, config->inputCount)
+            >= (1000000000UL / config->scanRateHz))) {
+      return false;
+    }
+    init->timerCycles = (uint16_t)cycles;
+  }
+
+  iadc_scan_acq_stop();
+  acq = *config;
+  blockWords = acq.scansPerBlock * acq.inputCount;
+  block.inputCount = acq.inputCount;
+  block.scans = acq.scansPerBlock;
+  sequence = 0;
+  lostBlocks = 0;
+
+  // The analog gain of 0.5x doubles the full scale, the others divide it
+  gain = allConfigs->configs[0].analogGain;
+  fullScaleMv = (gain == iadcCfgAnalogGain0P5x)
+                ? allConfigs->configs[0].vRef * 2
+                : allConfigs->configs[0].vRef / gain;
+
+  IADC_init(IADC0, init, allConfigs);
+
+  // One scan of all inputs per trigger, each result tagged with its entry,
+  // and an LDMA request per result, EM2 included
+  if (acq.pacing == iadcScanAcqTimer) {
+    initScan.triggerSelect = iadcTriggerSelTimer;
+  } else {
+    initScan.triggerSelect = iadcTriggerSelPrs0PosEdge;
+    PRS_ConnectConsumer(acq.prsChannel, prsTypeAsync,
+                        prsConsumerIADC0_SCANTRIGGER);
+  }
+  initScan.dataValidLevel = iadcFifoCfgDvl1;
+  initScan.fifoDmaWakeup = true;
+  initScan.showId = true;
+  for (i = 0; i < acq.inputCount; i++) {
+    scanTable.entries[i].posInput = acq.inputs[i].posInput;
+    scanTable.entries[i].negInput = acq.inputs[i].negInput;
+    scanTable.entries[i].includeInScan = true;
+  }
+  IADC_initScan(IADC0, &initScan, &scanTable);
+
+  ldma_start();
+  running = true;
+
+  // Arm the scan queue, the triggers start the scans from now on
+  IADC_command(IADC0, iadcCmdStartScan);
+  if (acq.pacing == iadcScanAcqTimer) {
+    IADC_command(IADC0, iadcCmdEnableTimer);
+  }
+
+  return true;
+}
+
+/***************************************************************************//**
+ * Stop the acquisition.
+ ******************************************************************************/
+void iadc_scan_acq_stop(void)
+{
+  if (!running) {
+    return;
+  }
+  running = false;
+  IADC_command(IADC0, iadcCmdDisableTimer);
+  IADC_command(IADC0, iadcCmdStopScan);
+  LDMA_StopTransfer(IADC_SCAN_ACQ_LDMA_CH);
+  LDMA_IntClear(CH_MASK);
+  while (IADC_getScanFifoCnt(IADC0)) {
+    (void)IADC_pullScanFifoResult(IADC0);
+  }
+}
+
+/***************************************************************************//**
+ * Convert a raw result to mV, in fixed point.
+ ******************************************************************************/
+uint32_t iadc_scan_acq_to_mv(uint32_t code)
+{
+  return (code * fullScaleMv + CODE_MAX / 2) / CODE_MAX;
+}
+
+/**************************************************************************//**
+ * @brief  LDMA interrupt handler, one per block
+ *****************************************************************************/
+void LDMA_IRQHandler(void)
+{
+  uint32_t pending = LDMA_IntGetEnabled();
+  uint32_t writing, done;
+
+  // LDMA_Init() enables the error interrupt, left set it would fire again and
+  // again
+  if (pending & LDMA_IF_ERROR) {
+    LDMA_IntClear(LDMA_IF_ERROR);
+  }
+  if (!(pending & CH_MASK)) {
+    return;
+  }
+  LDMA_IntClear(CH_MASK);
+
+  // The LDMA has gone on to the other buffer. Buffers are handled in turn,
+  // if the one due is being written again, the handler is late by a block.
+  writing = ((LDMA->CH[IADC_SCAN_ACQ_LDMA_CH].DST - (uint32_t)blockBuffer[1])
+             < sizeof(blockBuffer[1])) ? 1 : 0;
+  done = writing ^ 1;
+  if (done != (sequence & 1)) {
+    lostBlocks++;
+    sequence++;
+  }
+  block_handle(blockBuffer[done]);
+  sequence++;
+}
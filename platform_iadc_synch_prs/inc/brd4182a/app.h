@@ -37,6 +37,20 @@
 // Configured PRS channel
 #define PRS_CHANNEL                0
 
+// Asynchronous PRS channel carrying the conversion done pulses to the
+// TIMER0 CC1 capture
+#define PRS_DONE_CHANNEL           1
+
+// Measure the trigger to conversion latency of both trigger modes at start-up
+// and print it with the raw captures, at TIMING_TIMER_FREQ, over
+// TIMING_SAMPLES samples each
+#define TIMING_CAPTURE             1
+#define TIMING_TIMER_FREQ          500
+#define TIMING_SAMPLES             256
+
+// Move the samples of singleBuffer onto the ideal trigger grid
+#define TIMING_RESAMPLE            1
+
 // Set CLK_ADC to 10MHz
 #define CLK_SRC_ADC_FREQ           20000000 // CLK_SRC_ADC
 #define CLK_ADC_FREQ               10000000 // CLK_ADC - 10 MHz max
@@ -0,0 +1,107 @@
+/***************************************************************************//**
+ * @file
+ * @brief Trigger to conversion latency and jitter of the IADC, and resampling
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef IADC_TIMING_H
+#define IADC_TIMING_H
+
+#include <stdint.h>
+
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+// Latency histogram bins, the last one also counts everything above it
+#define IADC_TIMING_HIST_BINS           32
+
+// Fractional bits of the resampled results
+#define IADC_TIMING_RESAMPLE_FRAC_BITS  4
+
+/*******************************************************************************
+ *******************************   TYPEDEFS   **********************************
+ ******************************************************************************/
+
+// Timer running the triggers and capturing the conversion done instants
+typedef struct {
+  uint32_t clockHz;         // Timer counter clock
+  uint32_t periodTicks;     // Trigger period, TOP + 1
+  uint32_t triggerTicks;    // Counter value at which the trigger fires
+} iadc_timing_clock_t;
+
+// Latency statistics of a capture run
+typedef struct {
+  uint32_t count;           // Captures
+  uint32_t minTicks;
+  uint32_t maxTicks;
+  uint32_t meanNs;
+  uint32_t minNs;
+  uint32_t maxNs;
+  uint32_t rmsJitterPs;     // Standard deviation of the latency
+  // Bin i counts the latencies from minTicks + i * binTicks on
+  uint32_t binTicks;
+  uint32_t hist[IADC_TIMING_HIST_BINS];
+} iadc_timing_stats_t;
+
+/*******************************************************************************
+ *****************************   PROTOTYPES   **********************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Latency from the trigger to a captured conversion done instant.
+ *
+ * @param[in] clock Trigger timer.
+ * @param[in] capture Counter value captured at conversion done.
+ *
+ * @return Latency in timer ticks, modulo the trigger period.
+ ******************************************************************************/
+uint32_t iadc_timing_latency(const iadc_timing_clock_t *clock,
+                             uint32_t capture);
+
+/***************************************************************************//**
+ * Compute the latency statistics and histogram of a capture run.
+ *
+ * @param[in] clock Trigger timer.
+ * @param[in] captures Counter values captured at conversion done.
+ * @param[in] count Number of captures, at least 1.
+ * @param[out] stats Statistics.
+ ******************************************************************************/
+void iadc_timing_analyze(const iadc_timing_clock_t *clock,
+                         const uint32_t *captures,
+                         uint32_t count,
+                         iadc_timing_stats_t *stats);
+
+/***************************************************************************//**
+ * Resample results onto the ideal grid.
+ *
+ * Sample k was taken latency(k) after trigger k. It is moved to the mean
+ * latency after trigger k, by linear interpolation with its neighbour on that
+ * side. The first and the last sample are only interpolated inwards.
+ *
+ * @param[in] clock Trigger timer.
+ * @param[in] samples Results, one per trigger.
+ * @param[in] captures Counter values captured at conversion done, in step
+ *   with the samples.
+ * @param[in] count Number of samples, at least 1.
+ * @param[out] out Resampled results, with IADC_TIMING_RESAMPLE_FRAC_BITS
+ *   fractional bits. May not be samples.
+ ******************************************************************************/
+void iadc_timing_resample(const iadc_timing_clock_t *clock,
+                          const uint32_t *samples,
+                          const uint32_t *captures,
+                          uint32_t count,
+                          uint32_t *out);
+
+#endif // IADC_TIMING_H
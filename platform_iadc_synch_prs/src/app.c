@@ -19,6 +19,7 @@
 #include "em_device.h"
 #include "em_chip.h"
 #include "em_cmu.h"
+#include "em_core.h"
 #include "em_emu.h"
 #include "em_timer.h"
 #include "em_prs.h"
@@ -30,16 +31,43 @@
 #include "sl_emlib_gpio_simple_init.h"
 #include "sl_emlib_gpio_init_timer_config.h"
 
+#include "iadc_timing.h"
+#include "printf.h"
+
 /*******************************************************************************
  *******************************   Local variables   ***************************
  ******************************************************************************/
-// Globally declared LDMA link descriptor
+// Globally declared LDMA link descriptors
 LDMA_Descriptor_t descriptor;
+LDMA_Descriptor_t captureDescriptor;
 
 // Buffer for IADC samples
 uint32_t singleBuffer[NUM_SAMPLES];
 
+// TIMER0 counter at the end of each conversion of singleBuffer
+uint32_t captureBuffer[NUM_SAMPLES];
+
+#if TIMING_RESAMPLE
+// singleBuffer moved onto the trigger grid, with
+// IADC_TIMING_RESAMPLE_FRAC_BITS fractional bits
+uint32_t resampledBuffer[NUM_SAMPLES];
+#endif
+
 static unsigned int iadc_channel;
+static unsigned int capture_channel;
+
+// Trigger timing of TIMER0
+static iadc_timing_clock_t timingClock;
+
+#if TIMING_CAPTURE
+// Samples and captures of a timing run, and the run completion flags
+static uint32_t timingSamples[TIMING_SAMPLES];
+static uint32_t timingCaptures[TIMING_SAMPLES];
+static volatile uint32_t timingDone;
+
+#define TIMING_SAMPLES_DONE   0x1
+#define TIMING_CAPTURES_DONE  0x2
+#endif
 
 // Callback triggered when DMA transfer on reception channel is complete
 static bool dma_transfer_finished_cb(unsigned int channel,
@@ -53,10 +81,34 @@ static bool dma_transfer_finished_cb(unsigned int channel,
   // Toggle LED1 to notify that transfers are complete
   GPIO_PinOutToggle(LDMA_GPIO_LED1_PORT, LDMA_GPIO_LED1_PIN);
 
+#if TIMING_RESAMPLE
+  // Each capture is moved as soon as its conversion is done, before the
+  // sample itself, so the captures of this buffer are all there.
+  iadc_timing_resample(&timingClock,
+                       singleBuffer,
+                       captureBuffer,
+                       NUM_SAMPLES,
+                       resampledBuffer);
+#endif
+
   // return value is not used for simple (non ping-pong) transfers
   return true;
 }
 
+#if TIMING_CAPTURE
+// Callback triggered when a transfer of a timing run is complete
+static bool timing_transfer_finished_cb(unsigned int channel,
+                                        unsigned int sequence_no,
+                                        void *user_param)
+{
+  (void)channel;
+  (void)sequence_no;
+
+  timingDone |= (uint32_t)(uintptr_t)user_param;
+  return true;
+}
+#endif
+
 /**************************************************************************//**
  * @brief CMU initialization
  *****************************************************************************/
@@ -77,8 +129,11 @@ static void initCMU(void)
 
 /**************************************************************************//**
  * @brief   Timer initialization
+ *
+ * @param[in] freq - Frequency of the CC0 output, the IADC is triggered on
+ *                   each of its edges.
  *****************************************************************************/
-static void initTIMER(void)
+static void initTIMER(uint32_t freq)
 {
   uint32_t timerFreq;
   uint32_t topValue;
@@ -86,6 +141,7 @@ static void initTIMER(void)
   // Initialize TIMER0
   TIMER_Init_TypeDef init = TIMER_INIT_DEFAULT;
   TIMER_InitCC_TypeDef timer_CCInit = TIMER_INITCC_DEFAULT;
+  TIMER_InitCC_TypeDef captureInit = TIMER_INITCC_DEFAULT;
 
   init.enable = false;
 
@@ -96,6 +152,13 @@ static void initTIMER(void)
   // Configure the output to create PRS pulses
   timer_CCInit.prsOutput = timerPrsOutputPulse;
 
+  // Capture the counter at the end of each conversion, signaled over PRS
+  captureInit.mode = timerCCModeCapture;
+  captureInit.edge = timerEdgeRising;
+  captureInit.prsInput = true;
+  captureInit.prsSel = PRS_DONE_CHANNEL;
+  captureInit.prsInputType = timerPrsInputAsyncPulse;
+
   TIMER_Init(TIMER0, &init);
 
 #if TIMER_DEBUG
@@ -109,21 +172,34 @@ static void initTIMER(void)
   // Timer Compare/Capture channel 0 initialization
   TIMER_InitCC(TIMER0, 0, &timer_CCInit);
 
+  // Timer Compare/Capture channel 1 initialization
+  TIMER_InitCC(TIMER0, 1, &captureInit);
+
   // Set compare (reload) value for the timer
   // Note: the timer runs off of the EM01GRPACLK clock
   timerFreq = CMU_ClockFreqGet(cmuClock_TIMER0) / (init.prescale + 1);
 
-  topValue = timerFreq / (2 * TIMER_FREQ) - 1;
+  topValue = timerFreq / (2 * freq) - 1;
   TIMER_TopSet(TIMER0, topValue);
 
+  // The trigger fires when the counter reloads
+  TIMER_CompareSet(TIMER0, 0, 0);
+
+  timingClock.clockHz = timerFreq;
+  timingClock.periodTicks = topValue + 1;
+  timingClock.triggerTicks = 0;
+
   // Enable TIMER0
   TIMER_Enable(TIMER0, true);
 }
 
 /**************************************************************************//**
  * @brief  IADC Initialization
+ *
+ * @param[in] sync - Trigger on the synchronous PRS channel, instead of the
+ *                   rising edges of the asynchronous one.
  *****************************************************************************/
-static void initIADC(void)
+static void initIADC(bool sync)
 {
   // Declare initialization structures
   IADC_Init_t init = IADC_INIT_DEFAULT;
@@ -133,6 +209,9 @@ static void initIADC(void)
   // Single input structure
   IADC_SingleInput_t singleInput = IADC_SINGLEINPUT_DEFAULT;
 
+  // Back to the reset state if the trigger mode is changed
+  IADC_reset(IADC0);
+
   // Select clock for the IADC
   CMU_ClockSelectSet(cmuClock_IADCCLK, cmuSelect_EM01GRPACLK);
 
@@ -160,11 +239,11 @@ static void initIADC(void)
                                                                      iadcCfgModeNormal,
                                                                      init.srcClkPrescale);
 
-#if SYNC_MODE
-  initSingle.triggerSelect = iadcTriggerSelPrs0SameClk;
-#else
-  initSingle.triggerSelect = iadcTriggerSelPrs0PosEdge;
-#endif
+  if (sync) {
+    initSingle.triggerSelect = iadcTriggerSelPrs0SameClk;
+  } else {
+    initSingle.triggerSelect = iadcTriggerSelPrs0PosEdge;
+  }
   initSingle.dataValidLevel = iadcFifoCfgDvl2;
   initSingle.fifoDmaWakeup = true;
   initSingle.start = true;
@@ -197,64 +276,204 @@ static void initGPIO(void)
  *****************************************************************************/
 static void initPRS(void)
 {
-  // Set up PRS to connect the TIMER0 CC0 to IADC single trigger
-#if SYNC_MODE
+  /*
+   * Set up PRS to connect the TIMER0 CC0 to IADC single trigger, over both
+   * a synchronous and an asynchronous channel. The trigger selection of the
+   * IADC picks one of them.
+   */
   PRS_SourceSignalSet(PRS_CHANNEL,
                       PRS_SYNC_CH_CTRL_SOURCESEL_TIMER0,
                       PRS_SYNC_TIMER0_CC0,
                       prsEdgePos);
   PRS_ConnectConsumer(PRS_CHANNEL, prsTypeSync,
                       prsConsumerIADC0_SINGLETRIGGER);
-#else
   PRS_SourceAsyncSignalSet(PRS_CHANNEL,
                            PRS_ASYNC_CH_CTRL_SOURCESEL_TIMER0,
                            PRS_TIMER0_CC0);
   PRS_ConnectConsumer(PRS_CHANNEL,
                       prsTypeAsync,
                       prsConsumerIADC0_SINGLETRIGGER);
-#endif
+
+  // Set up PRS to connect the IADC single conversion done to TIMER0 CC1
+  PRS_SourceAsyncSignalSet(PRS_DONE_CHANNEL,
+                           PRS_ASYNC_CH_CTRL_SOURCESEL_IADC0,
+                           PRS_IADC0_SINGLEDONE);
+  PRS_ConnectConsumer(PRS_DONE_CHANNEL,
+                      prsTypeAsync,
+                      prsConsumerTIMER0_CC1);
 }
 
 /**************************************************************************//**
  * @brief  LDMA initialization
- *
- * @param[in] buffer - Pointer to the array where ADC results will be stored.
- * @param[in] size - Size of the array
  *****************************************************************************/
-static void initLDMA(uint32_t *buffer, uint32_t size)
+static void initLDMA(void)
 {
   sl_status_t status;
 
   // Initialize DMA with default parameters
   DMADRV_Init();
 
-  // Allocate DMA channel
+  // Allocate DMA channels for the samples and for their captures
   status = DMADRV_AllocateChannel(&iadc_channel, NULL);
   EFM_ASSERT(status == ECODE_EMDRV_DMADRV_OK);
+  status = DMADRV_AllocateChannel(&capture_channel, NULL);
+  EFM_ASSERT(status == ECODE_EMDRV_DMADRV_OK);
+}
+
+/**************************************************************************//**
+ * @brief  Wait for the middle of a trigger period and empty the IADC FIFO
+ *         and the capture FIFO, so that the next sample and capture are
+ *         those of the next trigger.
+ *****************************************************************************/
+static void alignToTrigger(void)
+{
+  uint32_t half = timingClock.periodTicks / 2;
+
+  while (TIMER_CounterGet(TIMER0) >= half) {
+  }
+  while (TIMER_CounterGet(TIMER0) < half) {
+  }
+
+  while (IADC_getSingleFifoCnt(IADC0)) {
+    (void)IADC_pullSingleFifoResult(IADC0);
+  }
+  while (!(TIMER0->STATUS & TIMER_STATUS_ICFEMPTY1)) {
+    (void)TIMER_CaptureGet(TIMER0, 1);
+  }
+}
 
-  // Trigger LDMA transfer on IADC scan completion
+/**************************************************************************//**
+ * @brief  Start the LDMA transfers of the samples and of their captures
+ *
+ * @param[in] buffer - Pointer to the array where ADC results will be stored.
+ * @param[in] captures - Pointer to the array where the captures will be
+ *                       stored.
+ * @param[in] size - Size of the arrays
+ * @param[in] loop - Run continuously, or once with timing run callbacks.
+ *****************************************************************************/
+static void startLDMA(uint32_t *buffer,
+                      uint32_t *captures,
+                      uint32_t size,
+                      bool loop)
+{
+  // Trigger LDMA transfer on IADC single conversion
   LDMA_TransferCfg_t transferCfg = LDMA_TRANSFER_CFG_PERIPHERAL(
     ldmaPeripheralSignal_IADC0_IADC_SINGLE);
 
-  /*
-   * Set up a linked descriptor to save scan results to the
-   * user-specified buffer. By linking the descriptor to itself
-   * (the last argument is the relative jump in terms of the number of
-   * descriptors), transfers will run continuously.
-   */
-  descriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_WORD(
+  // Trigger LDMA transfer on TIMER0 CC1 capture
+  LDMA_TransferCfg_t captureCfg = LDMA_TRANSFER_CFG_PERIPHERAL(
+    ldmaPeripheralSignal_TIMER0_CC1);
+
+  DMADRV_StopTransfer(iadc_channel);
+  DMADRV_StopTransfer(capture_channel);
+  alignToTrigger();
+
+  if (loop) {
+    /*
+     * Set up a linked descriptor to save scan results to the
+     * user-specified buffer. By linking the descriptor to itself
+     * (the last argument is the relative jump in terms of the number of
+     * descriptors), transfers will run continuously.
+     */
+    descriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_WORD(
+      &(IADC0->SINGLEFIFODATA),
+      buffer,
+      size,
+      0);
+
+    // The captures go to a parallel buffer, in step with the samples
+    captureDescriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_WORD(
+      &(TIMER0->CC[1].ICF),
+      captures,
+      size,
+      0);
+
+    DMADRV_LdmaStartTransfer(capture_channel,
+                             &captureCfg,
+                             &captureDescriptor,
+                             NULL,
+                             NULL);
+    DMADRV_LdmaStartTransfer(iadc_channel,
+                             &transferCfg,
+                             &descriptor,
+                             dma_transfer_finished_cb,
+                             NULL);
+    return;
+  }
+
+#if TIMING_CAPTURE
+  // Timing run, once only
+  descriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_P2M_WORD(
     &(IADC0->SINGLEFIFODATA),
     buffer,
-    size,
-    0);
-
+    size);
+  captureDescriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_P2M_WORD(
+    &(TIMER0->CC[1].ICF),
+    captures,
+    size);
+
+  timingDone = 0;
+  DMADRV_LdmaStartTransfer(capture_channel,
+                           &captureCfg,
+                           &captureDescriptor,
+                           timing_transfer_finished_cb,
+                           (void *)TIMING_CAPTURES_DONE);
   DMADRV_LdmaStartTransfer(iadc_channel,
                            &transferCfg,
                            &descriptor,
-                           dma_transfer_finished_cb,
-                           NULL);
+                           timing_transfer_finished_cb,
+                           (void *)TIMING_SAMPLES_DONE);
+#endif
 }
 
+#if TIMING_CAPTURE
+/**************************************************************************//**
+ * @brief  Measure the trigger to conversion latency of a trigger mode and
+ *         print it, followed by the raw captures for the host report
+ *         (tools/iadc_timing_report.c).
+ *
+ * @param[in] sync - Synchronous or asynchronous trigger.
+ *****************************************************************************/
+static void timingRun(bool sync)
+{
+  const char *name = sync ? "sync" : "async";
+  iadc_timing_stats_t stats;
+  uint32_t bin, last = 0;
+
+  initIADC(sync);
+  startLDMA(timingSamples, timingCaptures, TIMING_SAMPLES, false);
+
+  // Sleep until both transfers are done
+  CORE_DECLARE_IRQ_STATE;
+  while (timingDone != (TIMING_SAMPLES_DONE | TIMING_CAPTURES_DONE)) {
+    CORE_ENTER_CRITICAL();
+    if (timingDone != (TIMING_SAMPLES_DONE | TIMING_CAPTURES_DONE)) {
+      EMU_EnterEM1();
+    }
+    CORE_EXIT_CRITICAL();
+  }
+
+  iadc_timing_analyze(&timingClock, timingCaptures, TIMING_SAMPLES, &stats);
+
+  printf("%s: latency min %lu ns, mean %lu ns, max %lu ns, "
+         "jitter %lu.%03lu ns rms\r\n",
+         name, stats.minNs, stats.meanNs, stats.maxNs,
+         stats.rmsJitterPs / 1000, stats.rmsJitterPs % 1000);
+  for (bin = 0; bin < IADC_TIMING_HIST_BINS; bin++) {
+    if (stats.hist[bin] != 0) {
+      last = bin;
+    }
+  }
+  for (bin = 0; bin <= last; bin++) {
+    printf("hist %s %lu %lu\r\n",
+           name, stats.minTicks + bin * stats.binTicks, stats.hist[bin]);
+  }
+  for (uint32_t i = 0; i < TIMING_SAMPLES; i++) {
+    printf("cap %s %lu %lu\r\n", name, timingSamples[i], timingCaptures[i]);
+  }
+}
+#endif
+
 void app_init(void)
 {
   // Initialize clocks
@@ -266,14 +485,27 @@ void app_init(void)
   // Initialize PRS
   initPRS();
 
-  // Initialize IADC
-  initIADC();
-
   // Initialize LDMA
-  initLDMA(singleBuffer, NUM_SAMPLES);
+  initLDMA();
+
+#if TIMING_CAPTURE
+  // Measure both trigger modes before settling on SYNC_MODE
+  initTIMER(TIMING_TIMER_FREQ);
+  printf("timing %lu %lu %lu\r\n",
+         timingClock.clockHz, timingClock.periodTicks,
+         timingClock.triggerTicks);
+  timingRun(false);
+  timingRun(true);
+#endif
 
   // Initialize TIMER
-  initTIMER();
+  initTIMER(TIMER_FREQ);
+
+  // Initialize IADC
+  initIADC(SYNC_MODE);
+
+  // Start LDMA
+  startLDMA(singleBuffer, captureBuffer, NUM_SAMPLES, true);
 }
 
 void app_process_action(void)
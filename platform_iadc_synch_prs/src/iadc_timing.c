@@ -0,0 +1,188 @@
+/***************************************************************************//**
+ * @file
+ * @brief Trigger to conversion latency and jitter of the IADC, and resampling
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include "iadc_timing.h"
+
+/***************************************************************************//**
+ * Integer square root.
+ ******************************************************************************/
+static uint32_t isqrt64(uint64_t value)
+{
+  uint64_t root = 0, bit = 1ULL << 62;
+
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
+
+/***************************************************************************//**
+ * Timer ticks to ns.
+ ******************************************************************************/
+static uint32_t ticks_to_ns(const iadc_timing_clock_t *clock, uint32_t ticks)
+{
+  return (uint32_t)(((uint64_t)ticks * 1000000000ULL + clock->clockHz / 2)
+                    / clock->clockHz);
+}
+
+/***************************************************************************//**
+ * Latency from the trigger to a captured conversion done instant.
+ ******************************************************************************/
+uint32_t iadc_timing_latency(const iadc_timing_clock_t *clock,
+                             uint32_t capture)
+{
+  uint32_t ticks = capture - clock->triggerTicks;
+
+  if (capture < clock->triggerTicks) {
+    ticks += clock->periodTicks;
+  }
+  return ticks % clock->periodTicks;
+}
+
+/***************************************************************************//**
+ * Compute the latency statistics and histogram of a capture run.
+ ******************************************************************************/
+void iadc_timing_analyze(const iadc_timing_clock_t *clock,
+                         const uint32_t *captures,
+                         uint32_t count,
+                         iadc_timing_stats_t *stats)
+{
+  uint64_t sum = 0, sumSquares = 0, meanQ8, varianceQ16;
+  uint32_t ticks, offset, bin, i;
+
+  stats->count = count;
+  stats->minTicks = UINT32_MAX;
+  stats->maxTicks = 0;
+  for (i = 0; i < count; i++) {
+    ticks = iadc_timing_latency(clock, captures[i]);
+    if (ticks < stats->minTicks) {
+      stats->minTicks = ticks;
+    }
+    if (ticks > stats->maxTicks) {
+      stats->maxTicks = ticks;
+    }
+  }
+
+  // Bins of whole ticks, wide enough for the spread to fit
+  stats->binTicks = (stats->maxTicks - stats->minTicks) / IADC_TIMING_HIST_BINS
+                    + 1;
+  for (bin = 0; bin < IADC_TIMING_HIST_BINS; bin++) {
+    stats->hist[bin] = 0;
+  }
+
+  // Moments of the offsets from the minimum, which stay small
+  for (i = 0; i < count; i++) {
+    offset = iadc_timing_latency(clock, captures[i]) - stats->minTicks;
+    sum += offset;
+    sumSquares += (uint64_t)offset * offset;
+    bin = offset / stats->binTicks;
+    if (bin >= IADC_TIMING_HIST_BINS) {
+      bin = IADC_TIMING_HIST_BINS - 1;
+    }
+    stats->hist[bin]++;
+  }
+
+  meanQ8 = ((sum << 8) + count / 2) / count;
+  varianceQ16 = (sumSquares << 16) / count;
+  varianceQ16 = (varianceQ16 > meanQ8 * meanQ8) ? varianceQ16 - meanQ8 * meanQ8
+                : 0;
+
+  stats->minNs = ticks_to_ns(clock, stats->minTicks);
+  stats->maxNs = ticks_to_ns(clock, stats->maxTicks);
+  stats->meanNs = (uint32_t)((((uint64_t)stats->minTicks << 8) + meanQ8)
+                             * 1000000000ULL / clock->clockHz
+                             + 128) >> 8;
+  // Standard deviation in ticks with 8 fractional bits, times ps per tick
+  stats->rmsJitterPs = (uint32_t)(((uint64_t)isqrt64(varianceQ16)
+                                   * 1000000000000ULL / clock->clockHz
+                                   + 128) >> 8);
+}
+
+/***************************************************************************//**
+ * Signed division rounded to the nearest, halves away from zero.
+ ******************************************************************************/
+static int64_t div_round(int64_t numerator, int64_t denominator)
+{
+  return (numerator >= 0) ? (numerator + denominator / 2) / denominator
+         : (numerator - denominator / 2) / denominator;
+}
+
+/***************************************************************************//**
+ * Resample results onto the ideal grid.
+ ******************************************************************************/
+void iadc_timing_resample(const iadc_timing_clock_t *clock,
+                          const uint32_t *samples,
+                          const uint32_t *captures,
+                          uint32_t count,
+                          uint32_t *out)
+{
+  const int64_t one = 1 << IADC_TIMING_RESAMPLE_FRAC_BITS;
+  uint64_t sum = 0;
+  int64_t mean, latency, late, span, value;
+  uint32_t i, other;
+
+  for (i = 0; i < count; i++) {
+    sum += iadc_timing_latency(clock, captures[i]);
+  }
+  // Mean latency, in ticks with the fractional bits of the results
+  mean = (int64_t)(((sum << IADC_TIMING_RESAMPLE_FRAC_BITS) + count / 2)
+                   / count);
+
+  for (i = 0; i < count; i++) {
+    // How much later than the ideal instant sample i was taken. A late
+    // sample is pulled towards the previous one, an early one towards the
+    // next one.
+    latency = (int64_t)iadc_timing_latency(clock, captures[i]) * one;
+    late = latency - mean;
+    value = (int64_t)samples[i] * one;
+
+    if ((late > 0) && (i > 0)) {
+      other = i - 1;
+    } else if ((late < 0) && ((i + 1) < count)) {
+      other = i + 1;
+    } else {
+      out[i] = (uint32_t)value;
+      continue;
+    }
+
+    // Time between the two samples
+    span = (int64_t)clock->periodTicks * one;
+    if (other < i) {
+      span += latency
+              - (int64_t)iadc_timing_latency(clock, captures[other]) * one;
+    } else {
+      span += (int64_t)iadc_timing_latency(clock, captures[other]) * one
+              - latency;
+    }
+    if (late < 0) {
+      late = -late;
+    }
+
+    value += div_round(((int64_t)samples[other] - (int64_t)samples[i])
+                       * one * late,
+                       span);
+    out[i] = (value > 0) ? (uint32_t)value : 0;
+  }
+}
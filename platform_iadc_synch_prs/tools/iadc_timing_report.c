@@ -0,0 +1,224 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host report of recorded IADC trigger to conversion timing captures
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ *******************************************************************************
+ *
+ * Reads the log printed by the example when TIMING_CAPTURE is enabled, and
+ * prints the trigger to conversion latency statistics and histogram of each
+ * trigger mode, with the same code as the device (../src/iadc_timing.c).
+ *
+ * Build:
+ *   cc -O2 -I../inc -o iadc_timing_report iadc_timing_report.c \
+ *      ../src/iadc_timing.c
+ *
+ * Usage:
+ *   iadc_timing_report [--resample] log
+ *
+ *   The log lines used are, everything else is ignored:
+ *     timing <clock Hz> <period ticks> <trigger ticks>
+ *     cap <mode> <result> <captured ticks>
+ *
+ *   --resample   Also print the results of each mode moved onto the ideal
+ *                trigger grid, next to the raw ones.
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iadc_timing.h"
+
+#define MAX_MODES     4
+#define MODE_NAME     16
+
+typedef struct {
+  char name[MODE_NAME];
+  uint32_t *samples;
+  uint32_t *captures;
+  uint32_t count;
+  uint32_t capacity;
+} capture_mode_t;
+
+static capture_mode_t modes[MAX_MODES];
+static uint32_t modeCount;
+
+/***************************************************************************//**
+ * Find a mode by name, adding it if needed.
+ ******************************************************************************/
+static capture_mode_t *mode_get(const char *name)
+{
+  for (uint32_t i = 0; i < modeCount; i++) {
+    if (strcmp(modes[i].name, name) == 0) {
+      return &modes[i];
+    }
+  }
+  if (modeCount == MAX_MODES) {
+    return NULL;
+  }
+  snprintf(modes[modeCount].name, MODE_NAME, "%s", name);
+  return &modes[modeCount++];
+}
+
+/***************************************************************************//**
+ * Add a capture to a mode.
+ ******************************************************************************/
+static bool mode_add(capture_mode_t *mode, uint32_t sample, uint32_t capture)
+{
+  if (mode->count == mode->capacity) {
+    mode->capacity = mode->capacity ? mode->capacity * 2 : 256;
+    mode->samples = realloc(mode->samples, mode->capacity * sizeof(uint32_t));
+    mode->captures = realloc(mode->captures,
+                             mode->capacity * sizeof(uint32_t));
+    if ((mode->samples == NULL) || (mode->captures == NULL)) {
+      return false;
+    }
+  }
+  mode->samples[mode->count] = sample;
+  mode->captures[mode->count] = capture;
+  mode->count++;
+  return true;
+}
+
+/***************************************************************************//**
+ * Print the statistics and histogram of a mode.
+ ******************************************************************************/
+static void mode_report(const iadc_timing_clock_t *clock,
+                        const capture_mode_t *mode,
+                        iadc_timing_stats_t *stats)
+{
+  uint32_t peak = 0, last = 0, bin, width;
+
+  iadc_timing_analyze(clock, mode->captures, mode->count, stats);
+
+  printf("%s: %u captures\n", mode->name, stats->count);
+  printf("  latency min %u ns, mean %u ns, max %u ns\n",
+         stats->minNs, stats->meanNs, stats->maxNs);
+  printf("  jitter %u ns peak to peak, %u.%03u ns rms\n",
+         stats->maxNs - stats->minNs,
+         stats->rmsJitterPs / 1000, stats->rmsJitterPs % 1000);
+
+  for (bin = 0; bin < IADC_TIMING_HIST_BINS; bin++) {
+    if (stats->hist[bin] > peak) {
+      peak = stats->hist[bin];
+    }
+    if (stats->hist[bin] != 0) {
+      last = bin;
+    }
+  }
+  for (bin = 0; bin <= last; bin++) {
+    width = (uint32_t)(((uint64_t)stats->hist[bin] * 50 + peak - 1) / peak);
+    printf("  %8u ticks %6u |%.*s\n",
+           stats->minTicks + bin * stats->binTicks, stats->hist[bin],
+           (int)width,
+           "##################################################");
+  }
+}
+
+/***************************************************************************//**
+ * Print the raw and resampled results of a mode.
+ ******************************************************************************/
+static void mode_resample(const iadc_timing_clock_t *clock, const capture_mode_t *mode)
+{
+  const uint32_t one = 1 << IADC_TIMING_RESAMPLE_FRAC_BITS;
+  uint32_t *out = malloc(mode->count * sizeof(uint32_t));
+
+  if (out == NULL) {
+    return;
+  }
+  iadc_timing_resample(clock, mode->samples, mode->captures, mode->count, out);
+  printf("%s resampled: index, latency ticks, raw, resampled\n", mode->name);
+  for (uint32_t i = 0; i < mode->count; i++) {
+    printf("  %6u %8u %6u %6u.%04u\n", i,
+           iadc_timing_latency(clock, mode->captures[i]), mode->samples[i],
+           out[i] / one, (out[i] % one) * 10000 / one);
+  }
+  free(out);
+}
+
+int main(int argc, char **argv)
+{
+  iadc_timing_clock_t clock = { 0 };
+  iadc_timing_stats_t stats, best = { 0 };
+  const char *path = NULL, *bestName = NULL;
+  bool resample = false;
+  char line[256], name[MODE_NAME];
+  unsigned long a, b, c;
+  capture_mode_t *mode;
+  FILE *file;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--resample") == 0) {
+      resample = true;
+    } else if (path == NULL) {
+      path = argv[i];
+    } else {
+      path = NULL;
+      break;
+    }
+  }
+  if (path == NULL) {
+    fprintf(stderr, "usage: %s [--resample] log\n", argv[0]);
+    return 2;
+  }
+
+  file = fopen(path, "r");
+  if (file == NULL) {
+    fprintf(stderr, "cannot read %s\n", path);
+    return 1;
+  }
+  while (fgets(line, sizeof(line), file) != NULL) {
+    if (sscanf(line, "timing %lu %lu %lu", &a, &b, &c) == 3) {
+      clock.clockHz = (uint32_t)a;
+      clock.periodTicks = (uint32_t)b;
+      clock.triggerTicks = (uint32_t)c;
+    } else if (sscanf(line, "cap %15s %lu %lu", name, &a, &b) == 3) {
+      mode = mode_get(name);
+      if ((mode == NULL) || !mode_add(mode, (uint32_t)a, (uint32_t)b)) {
+        fprintf(stderr, "too many modes or out of memory\n");
+        fclose(file);
+        return 1;
+      }
+    }
+  }
+  fclose(file);
+
+  if ((clock.clockHz == 0) || (clock.periodTicks == 0) || (modeCount == 0)) {
+    fprintf(stderr, "no timing line or no captures in %s\n", path);
+    return 1;
+  }
+
+  printf("timer %u Hz, trigger period %u ticks\n",
+         clock.clockHz, clock.periodTicks);
+  for (uint32_t i = 0; i < modeCount; i++) {
+    mode_report(&clock, &modes[i], &stats);
+    if ((bestName == NULL) || (stats.rmsJitterPs < best.rmsJitterPs)) {
+      best = stats;
+      bestName = modes[i].name;
+    }
+    if (resample) {
+      mode_resample(&clock, &modes[i]);
+    }
+  }
+  if (modeCount > 1) {
+    printf("lowest jitter: %s\n", bestName);
+  }
+
+  for (uint32_t i = 0; i < modeCount; i++) {
+    free(modes[i].samples);
+    free(modes[i].captures);
+  }
+  return 0;
+}
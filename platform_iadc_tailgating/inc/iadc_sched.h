@@ -0,0 +1,114 @@
+/***************************************************************************//**
+ * @file
+ * @brief IADC conversion scheduler on scan and tailgated single conversions
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef IADC_SCHED_H
+#define IADC_SCHED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "em_iadc.h"
+
+#include "iadc_sched_plan.h"
+
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+// Frames of results kept for each channel. A channel has to be read at least
+// once every IADC_SCHED_RING_FRAMES frames to miss nothing. Must be a multiple
+// of IADC_SCHED_MAX_FRAMES, and the scan ring of IADC_SCHED_RING_FRAMES *
+// IADC_SCHED_SCAN_ENTRIES words must fit in one LDMA transfer (2048 words).
+#ifndef IADC_SCHED_RING_FRAMES
+#define IADC_SCHED_RING_FRAMES    IADC_SCHED_MAX_FRAMES
+#endif
+
+// LDMA channels moving the scan results and running the single slots
+#ifndef IADC_SCHED_SCAN_LDMA_CH
+#define IADC_SCHED_SCAN_LDMA_CH   0
+#endif
+#ifndef IADC_SCHED_SINGLE_LDMA_CH
+#define IADC_SCHED_SINGLE_LDMA_CH 1
+#endif
+
+// IADC warm-up from shutdown, before the first conversion of each frame
+#define IADC_SCHED_WARMUP_NS      5000
+
+/*******************************************************************************
+ *******************************   TYPEDEFS   **********************************
+ ******************************************************************************/
+
+// A logical channel
+typedef struct {
+  IADC_PosInput_t posInput;
+  IADC_NegInput_t negInput;
+  uint32_t rateHz;          // Conversions per second
+  uint8_t priority;         // Higher priorities are placed first
+} iadc_sched_channel_t;
+
+/*******************************************************************************
+ *****************************   PROTOTYPES   **********************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Compute the schedule of a set of channels and start converting.
+ *
+ * The IADC is initialized with init and allConfigs, all conversions use
+ * configuration 0. The IADC timer is set to the frame rate of the schedule,
+ * the scan table holds the channels converted every frame, and the LDMA
+ * reprograms and starts the tailgated single conversion of each frame. The
+ * raw results go to per channel rings without any CPU involvement, apart from
+ * an LDMA interrupt each time the rings wrap.
+ *
+ * @param[in] init IADC initialization, the timer cycles are set here.
+ * @param[in] allConfigs IADC configurations.
+ * @param[in] channels Logical channels, the index is the channel number.
+ * @param[in] count Number of channels.
+ *
+ * @return Status of the schedule. Nothing is started if it is an error.
+ ******************************************************************************/
+iadc_sched_status_t iadc_sched_start(IADC_Init_t *init,
+                                     const IADC_AllConfigs_t *allConfigs,
+                                     const iadc_sched_channel_t *channels,
+                                     uint32_t count);
+
+/***************************************************************************//**
+ * Take the oldest unread result of a channel.
+ *
+ * @param[in] channel Channel number.
+ * @param[out] code Raw 12-bit result.
+ *
+ * @return False if there is no new result.
+ ******************************************************************************/
+bool iadc_sched_read(uint32_t channel, uint32_t *code);
+
+/***************************************************************************//**
+ * Number of results of a channel overwritten before they were read.
+ ******************************************************************************/
+uint32_t iadc_sched_overruns(uint32_t channel);
+
+/***************************************************************************//**
+ * Convert a raw result to mV, in fixed point.
+ ******************************************************************************/
+uint32_t iadc_sched_to_mv(uint32_t code);
+
+/***************************************************************************//**
+ * Get the schedule computed by iadc_sched_start().
+ ******************************************************************************/
+const iadc_sched_plan_t *iadc_sched_plan_get(void);
+
+#endif // IADC_SCHED_H
@@ -0,0 +1,129 @@
+/***************************************************************************//**
+ * @file
+ * @brief Conversion schedule of the IADC scheduler
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef IADC_SCHED_PLAN_H
+#define IADC_SCHED_PLAN_H
+
+#include <stdint.h>
+
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+// Logical channels of one schedule
+#ifndef IADC_SCHED_MAX_CHANNELS
+#define IADC_SCHED_MAX_CHANNELS   16
+#endif
+
+// Entries of the IADC scan table
+#define IADC_SCHED_SCAN_ENTRIES   16
+
+// Longest schedule, in frames. Channels in single slots are converted at
+// least once every IADC_SCHED_MAX_FRAMES frames. Must be a power of two.
+#ifndef IADC_SCHED_MAX_FRAMES
+#define IADC_SCHED_MAX_FRAMES     32
+#endif
+
+// Slot table value of a frame whose single conversion belongs to no channel
+#define IADC_SCHED_SLOT_FREE      0xFF
+
+/*******************************************************************************
+ *******************************   TYPEDEFS   **********************************
+ ******************************************************************************/
+
+typedef enum {
+  iadcSchedOk,              // Every channel gets at least its rate
+  iadcSchedDemoted,         // Some channels get less than their rate
+  iadcSchedErrChannels,     // No channel, or more than the maximum
+  iadcSchedErrFrame,        // A frame is too short for the conversions
+  iadcSchedErrPlace,        // Some channels could not be placed at all
+} iadc_sched_status_t;
+
+typedef enum {
+  iadcSchedNone,            // Not converted
+  iadcSchedScan,            // Scan table entry, converted every frame
+  iadcSchedSingle,          // Tailgated single slot, every period frames
+} iadc_sched_queue_t;
+
+// What a channel asks for
+typedef struct {
+  uint32_t rateHz;          // Conversions per second
+  uint8_t priority;         // Higher priorities are placed first
+} iadc_sched_request_t;
+
+// IADC timing the schedule has to fit in
+typedef struct {
+  uint32_t minFrameRateHz;  // Slowest rate of the IADC timer
+  uint32_t conversionNs;    // One conversion, input switching included
+  uint32_t warmupNs;        // Warm-up before the first conversion of a frame
+} iadc_sched_timing_t;
+
+// Where a channel ended up
+typedef struct {
+  iadc_sched_queue_t queue;
+  uint8_t index;            // Scan table entry, or first single slot
+  uint8_t period;           // Frames between two conversions
+} iadc_sched_place_t;
+
+/*
+ * The IADC timer starts a scan of the scan table every frame, and the
+ * tailgated single conversion of the frame follows it. Frame n converts the
+ * single slot channel slotChannel[n % frames].
+ */
+typedef struct {
+  uint32_t frameRateHz;
+  uint32_t frames;          // Length of the slot table, a power of two
+  uint32_t busyNs;          // Conversion time of one frame
+  uint32_t scanCount;
+  uint8_t scanChannel[IADC_SCHED_SCAN_ENTRIES];
+  uint32_t singleCount;     // Channels in single slots
+  uint8_t slotChannel[IADC_SCHED_MAX_FRAMES];
+  iadc_sched_place_t place[IADC_SCHED_MAX_CHANNELS];
+} iadc_sched_plan_t;
+
+/*******************************************************************************
+ *****************************   PROTOTYPES   **********************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Compute the schedule of a set of channels.
+ *
+ * The frame rate is the highest requested rate. Each channel gets a period of
+ * a power of two frames, the longest one that still meets its rate. Channels
+ * converted every frame go in the scan table, as long as the frame has time
+ * for them, the others share the single slots. Channels are placed by
+ * decreasing priority: when the IADC is oversubscribed, the lower priorities
+ * get their period doubled until they fit, or are left out.
+ *
+ * @param[in] requests Requested rates and priorities, one per channel.
+ * @param[in] count Number of channels.
+ * @param[in] timing IADC conversion timing.
+ * @param[out] plan Computed schedule.
+ *
+ * @return Status of the schedule.
+ ******************************************************************************/
+iadc_sched_status_t iadc_sched_plan(const iadc_sched_request_t *requests,
+                                    uint32_t count,
+                                    const iadc_sched_timing_t *timing,
+                                    iadc_sched_plan_t *plan);
+
+/***************************************************************************//**
+ * Rate a channel gets from a schedule, in mHz.
+ ******************************************************************************/
+uint32_t iadc_sched_rate_mhz(const iadc_sched_plan_t *plan, uint32_t channel);
+
+#endif // IADC_SCHED_PLAN_H
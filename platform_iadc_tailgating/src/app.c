@@ -23,27 +23,47 @@
 #include "stdio.h"
 
 #include "app.h"
+#include "iadc_sched.h"
 
 #include "sl_simple_button.h"
 #include "sl_simple_button_instances.h"
 
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+// Logical channels of the scheduler
+#define CH_INPUT_0                0
+#define CH_INPUT_1                1
+#define CH_INPUT_2                2
+#define CH_AVDD                   3
+#define CH_DVDD                   4
+#define NUM_CHANNELS              5
+
+// Supplies are measured divided by 4
+#define SUPPLY_SCALE              4
+
 /*******************************************************************************
  ***************************   GLOBAL VARIABLES  *******************************
  ******************************************************************************/
 
-static volatile double scanResult[NUM_INPUTS] = { 0 };
-static volatile double singleResult = 0;
+static iadc_sched_channel_t channels[NUM_CHANNELS];
+
+// Latest result of each channel in mV, and results of CH_INPUT_0 since the
+// last printout
+static uint32_t latestMv[NUM_CHANNELS];
+static uint32_t printCount = 0;
 
-// if has a new ADC measurement printout
-static volatile uint8_t newvalue = false;
+// print the schedule on the next app_process_action()
+static volatile bool printPlan = false;
 
 /*******************************************************************************
  *********************   STATIC FUNCTION DEFINATION ****************************
  ******************************************************************************/
 
 static void app_initIADC(void);
-static void app_initIADCScan(void);
-static void app_initIADCSingle(void);
+static void app_initChannels(void);
+static void app_printPlan(void);
 
 static void app_debugSignalSetup(void);
 
@@ -56,11 +76,9 @@ void app_init(void)
 
   // init prs signal for debugging
   app_debugSignalSetup();
-  // init IADC
+  // init IADC, compute the schedule and start converting
   app_initIADC();
-
-  // Start scan
-  IADC_command(IADC0, iadcCmdStartScan);
+  app_printPlan();
 }
 
 /***************************************************************************//**
@@ -68,81 +86,99 @@ void app_init(void)
  ******************************************************************************/
 void app_process_action(void)
 {
-  if (newvalue) {
-    // printout the latest ADC values from the register
-    printf("ch0: %f\t ch1: %f\t single: %f\r\n",
-           scanResult[0],
-           scanResult[1],
-           singleResult);
-    newvalue = false;
+  uint32_t code;
+
+  // Drain the result rings, scaling in fixed point
+  for (uint32_t channel = 0; channel < NUM_CHANNELS; channel++) {
+    while (iadc_sched_read(channel, &code)) {
+      latestMv[channel] = iadc_sched_to_mv(code);
+      if (channel == CH_INPUT_0) {
+        printCount++;
+      }
+    }
+  }
+
+  // printout the latest values about once a second
+  if (printCount >= CLK_TIMER) {
+    printCount = 0;
+    printf("in0: %lu mV\t in1: %lu mV\t in2: %lu mV\t "
+           "avdd: %lu mV\t dvdd: %lu mV\t overruns: %lu\r\n",
+           (unsigned long)latestMv[CH_INPUT_0],
+           (unsigned long)latestMv[CH_INPUT_1],
+           (unsigned long)latestMv[CH_INPUT_2],
+           (unsigned long)(latestMv[CH_AVDD] * SUPPLY_SCALE),
+           (unsigned long)(latestMv[CH_DVDD] * SUPPLY_SCALE),
+           (unsigned long)(iadc_sched_overruns(CH_INPUT_0)
+                           + iadc_sched_overruns(CH_INPUT_2)));
+  }
+
+  if (printPlan) {
+    printPlan = false;
+    app_printPlan();
   }
 }
 
 /**************************************************************************//**
- * @brief  IADC SCAN mode initialization
+ * @brief  Logical channels: the two scan inputs of the original example at
+ *         the IADC timer rate, the single input at a quarter of it, and the
+ *         supplies at 10 Hz
  *****************************************************************************/
-static void app_initIADCScan(void)
+static void app_initChannels(void)
 {
-  // Declare initialization structures
-  IADC_InitScan_t initScan = IADC_INITSCAN_DEFAULT;
+  channels[CH_INPUT_0].posInput = IADC_INPUT_0_PORT_PIN;
+  channels[CH_INPUT_0].rateHz = CLK_TIMER;
+  channels[CH_INPUT_0].priority = 3;
 
-  // Scan table structure
-  IADC_ScanTable_t scanTable = IADC_SCANTABLE_DEFAULT;
+  channels[CH_INPUT_1].posInput = IADC_INPUT_1_PORT_PIN;
+  channels[CH_INPUT_1].rateHz = CLK_TIMER;
+  channels[CH_INPUT_1].priority = 3;
 
-  /*
-   * The IADC local timer triggers conversions.
-   *
-   * Set the SCANFIFODVL flag when scan FIFO holds 2 entries.  In this
-   * example, the interrupt associated with the SCANFIFODVL flag in
-   * the IADC_IF register is not used.
-   *
-   * Tag each FIFO entry with scan table entry ID.
-   */
-  initScan.triggerSelect = iadcTriggerSelTimer;
-  initScan.dataValidLevel = iadcFifoCfgDvl2;
-  initScan.showId = true;
+  channels[CH_INPUT_2].posInput = IADC_INPUT_2_PORT_PIN;
+  channels[CH_INPUT_2].rateHz = CLK_TIMER / 4;
+  channels[CH_INPUT_2].priority = 2;
 
-  /*
-   * Configure entries in the scan table.  CH0 is single-ended from
-   * input 0; CH1 is single-ended from input 1.
-   */
-  scanTable.entries[0].posInput = IADC_INPUT_0_PORT_PIN;
-  scanTable.entries[0].negInput = iadcNegInputGnd;
-  scanTable.entries[0].includeInScan = true;
+  channels[CH_AVDD].posInput = iadcPosInputAvdd;
+  channels[CH_AVDD].rateHz = 10;
+  channels[CH_AVDD].priority = 1;
 
-  scanTable.entries[1].posInput = IADC_INPUT_1_PORT_PIN;
-  scanTable.entries[1].negInput = iadcNegInputGnd;
-  scanTable.entries[1].includeInScan = true;
+  channels[CH_DVDD].posInput = iadcPosInputDvdd;
+  channels[CH_DVDD].rateHz = 10;
+  channels[CH_DVDD].priority = 1;
 
-  // Initialize scan
-  IADC_initScan(IADC0, &initScan, &scanTable);
+  // All conversions are single-ended
+  for (uint32_t i = 0; i < NUM_CHANNELS; i++) {
+    channels[i].negInput = iadcNegInputGnd;
+  }
 }
 
 /**************************************************************************//**
- * @brief  IADC SINGLE mode initialization
+ * @brief  Print the schedule computed for the channels
  *****************************************************************************/
-static void app_initIADCSingle(void)
+static void app_printPlan(void)
 {
-  // Declare initialization structures
-  IADC_InitSingle_t initSingle = IADC_INITSINGLE_DEFAULT;
-
-  // Single input structure
-  IADC_SingleInput_t singleInput = IADC_SINGLEINPUT_DEFAULT;
-
-  /*
-   * Enable tailgating function
-   */
-  initSingle.singleTailgate = true;
-
-  /*
-   * Specify the input channel.  When negInput = iadcNegInputGnd, the
-   * conversion is single-ended.
-   */
-  singleInput.posInput = IADC_INPUT_2_PORT_PIN;
-  singleInput.negInput = iadcNegInputGnd;
-
-  // Initialize a single-channel conversion
-  IADC_initSingle(IADC0, &initSingle, &singleInput);
+  const iadc_sched_plan_t *plan = iadc_sched_plan_get();
+  const iadc_sched_place_t *place;
+  uint32_t rate;
+
+  printf("frame rate %lu Hz, %lu scan entries, %lu single channels "
+         "over %lu frames\r\n",
+         (unsigned long)plan->frameRateHz,
+         (unsigned long)plan->scanCount,
+         (unsigned long)plan->singleCount,
+         (unsigned long)plan->frames);
+  for (uint32_t i = 0; i < NUM_CHANNELS; i++) {
+    place = &plan->place[i];
+    rate = iadc_sched_rate_mhz(plan, i);
+    printf("ch%lu: %s %lu, every %lu frames, %lu.%03lu Hz (asked %lu Hz)\r\n",
+           (unsigned long)i,
+           place->queue == iadcSchedScan ? "scan entry"
+           : place->queue == iadcSchedSingle ? "single slot" : "not placed",
+           (unsigned long)place->index,
+           (unsigned long)place->period,
+           (unsigned long)(rate / 1000),
+           (unsigned long)(rate % 1000),
+           (unsigned long)channels[i].rateHz);
+  }
 }
 
 /**************************************************************************//**
@@ -153,6 +189,7 @@ static void app_initIADC(void)
   // Declare initialization structures
   IADC_Init_t init = IADC_INIT_DEFAULT;
   IADC_AllConfigs_t initAllConfigs = IADC_ALLCONFIGS_DEFAULT;
+  iadc_sched_status_t status;
 
   CMU_ClockEnable(cmuClock_IADC0, true);
 
@@ -170,15 +207,10 @@ static void app_initIADC(void)
 
   /*
    * The IADC local timer runs at CLK_SRC_ADC_FREQ, which is at least
-   * 2x CLK_ADC_FREQ. CLK_SRC_ADC_FREQ in this example is equal to the
-   * HFXO frequency. Dividing the frequency of the HFXO by 1000 will give
-   * the tick count for 1 ms trigger rate.
-   * For example - if HFXO freq = 38.4 MHz,
-   *
-   * ticks for 1 ms trigger = 38400000 / 1000
-   * ticks =  38400
+   * 2x CLK_ADC_FREQ. The scheduler sets the timer cycles to the frame
+   * rate of the schedule, the rate of the fastest channel (CLK_TIMER in
+   * this example).
    */
-  init.timerCycles = (uint16_t)(CLK_SRC_ADC_FREQ / CLK_TIMER);
 
   /*
    * Configuration 0 is used by both scan and single conversions by
@@ -212,36 +244,25 @@ static void app_initIADC(void)
                                                                      init.
                                                                      srcClkPrescale);
 
-  // Initialize IADC
-  IADC_init(IADC0, &init, &initAllConfigs);
-
-  // Initialize scan
-  app_initIADCScan();
-
-  // Initialize a single-channel conversion
-  app_initIADCSingle();
-
-  // Enable the IADC timer (must be after the IADC is initialized)
-  IADC_command(IADC0, iadcCmdEnableTimer);
-
   // Allocate the analog bus for ADC0 inputs
 #ifndef EFM32PG23B310F512IM48
   GPIO->IADC_INPUT_0_BUS |= IADC_INPUT_0_BUSALLOC;
 #endif
   GPIO->IADC_INPUT_1_BUS |= IADC_INPUT_1_BUSALLOC;
   GPIO->IADC_INPUT_2_BUS |= IADC_INPUT_2_BUSALLOC;
-  // Clear any previous interrupt flags
-  IADC_clearInt(IADC0, _IADC_IF_MASK);
-
-  // Enable scan interrupts
-  IADC_enableInt(IADC0, IADC_IEN_SCANFIFODVL);
-
-  // Enable single-channel done interrupts
-  IADC_enableInt(IADC0, IADC_IEN_SINGLEDONE);
 
-  // Enable ADC interrupts
-  NVIC_ClearPendingIRQ(IADC_IRQn);
-  NVIC_EnableIRQ(IADC_IRQn);
+  /*
+   * Initialize the IADC, place the channels in the scan table and in the
+   * tailgated single slots, and start. From now on the LDMA moves the raw
+   * results to the rings, the IADC interrupt is not used.
+   */
+  app_initChannels();
+  status = iadc_sched_start(&init, &initAllConfigs, channels, NUM_CHANNELS);
+  if (status == iadcSchedDemoted) {
+    printf("Not enough conversion time, some channels are slower\r\n");
+  } else if (status != iadcSchedOk) {
+    printf("No schedule for the channels (%d)\r\n", (int)status);
+  }
 }
 
 /**************************************************************************//**
@@ -274,65 +295,12 @@ static void app_debugSignalSetup(void)
                   0);
 }
 
-/**************************************************************************//**
- * @brief  IADC interrupt handler
- *****************************************************************************/
-void IADC_IRQHandler(void)
-{
-  IADC_Result_t sample;
-  uint32_t event = IADC_getInt(IADC0);
-
-  if (event & IADC_IF_SCANFIFODVL) {
-    // While the FIFO count is non-zero...
-    while (IADC_getScanFifoCnt(IADC0))
-    {
-      // Pull a scan result from the FIFO
-      sample = IADC_pullScanFifoResult(IADC0);
-
-      /*
-       * Calculate the voltage converted as follows:
-       *
-       * For single-ended conversions, the result can range from 0 to
-       * +Vref, i.e., for Vref = VBGR = 1.21V, and with analog gain = 0.5,
-       * 0xFFF represents the full scale value of 2.42V.
-       */
-      scanResult[sample.id] = sample.data * 2.42 / 0xFFF;
-    }
-    newvalue = true;
-
-    /*
-     * Clear the scan table complete interrupt.  Reading from the FIFO
-     * does not do this automatically.
-     */
-    IADC_clearInt(IADC0, IADC_IF_SCANFIFODVL);
-  }
-  if (event & IADC_IF_SINGLEDONE) {
-    sample = IADC_pullSingleFifoResult(IADC0);
-
-    /*
-     * Calculate the voltage converted as follows:
-     *
-     * For single-ended conversions, the result can range from 0 to
-     * +Vref, i.e., for Vref = VBGR = 1.21V, and with analog gain = 0.5
-     * 0xFFF represents the full scale value of 2.42V.
-     */
-    singleResult = sample.data * 2.42 / 0xFFF;
-
-    /*
-     * Clear the single conversion complete interrupt.  Reading FIFO
-     * results does not do this automatically.
-     */
-    IADC_clearInt(IADC0, IADC_IF_SINGLEDONE);
-    newvalue = true;
-  }
-}
-
 void sl_button_on_change(const sl_button_t *handle)
 {
   (void)handle;
 
   if (sl_button_get_state(&sl_button_btn0) == SL_SIMPLE_BUTTON_PRESSED) {
-    // Start Single conversion on button press
-    IADC_command(IADC0, iadcCmdStartSingle);
+    // The single queue belongs to the scheduler, print its schedule instead
+    printPlan = true;
   }
 }
@@ -0,0 +1,433 @@
+/***************************************************************************//**
+ * @file
+ * @brief IADC conversion scheduler on scan and tailgated single conversions
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include "em_cmu.h"
+#include "em_core.h"
+#include "em_iadc.h"
+#include "em_ldma.h"
+
+#include "iadc_sched.h"
+
+#if IADC_SCHED_RING_FRAMES % IADC_SCHED_MAX_FRAMES
+#error "IADC_SCHED_RING_FRAMES must be a multiple of IADC_SCHED_MAX_FRAMES"
+#endif
+
+// The scan ring is one LDMA transfer of up to scanCount words per frame
+#if (IADC_SCHED_RING_FRAMES * IADC_SCHED_SCAN_ENTRIES) \
+  > ((_LDMA_CH_CTRL_XFERCNT_MASK >> _LDMA_CH_CTRL_XFERCNT_SHIFT) + 1)
+#error "IADC_SCHED_RING_FRAMES * IADC_SCHED_SCAN_ENTRIES exceeds one LDMA transfer"
+#endif
+
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+#define RING          IADC_SCHED_RING_FRAMES
+
+#define SCAN_CH_MASK    (1UL << IADC_SCHED_SCAN_LDMA_CH)
+#define SINGLE_CH_MASK  (1UL << IADC_SCHED_SINGLE_LDMA_CH)
+
+// Descriptors of one single slot: result, next input, start, slot counter
+#define SLOT_DESCRIPTORS  4
+
+// Largest raw result, results are right aligned 12-bit
+#define CODE_MAX      0xFFF
+
+/*******************************************************************************
+ ***************************   GLOBAL VARIABLES  *******************************
+ ******************************************************************************/
+
+static iadc_sched_plan_t plan;
+static uint32_t channelCount;
+
+// Scan results, frame after frame, scanCount words each
+static uint32_t scanRing[RING * IADC_SCHED_SCAN_ENTRIES];
+static LDMA_Descriptor_t scanDesc;
+
+// Single results, one word per frame
+static uint32_t singleRing[RING];
+static LDMA_Descriptor_t singleDesc[RING * SLOT_DESCRIPTORS];
+
+// SINGLE register value of each channel in the single slots, and the channel
+// converted in the free slots
+static uint32_t singleInput[IADC_SCHED_MAX_CHANNELS];
+static uint32_t fillerChannel;
+
+// Next single slot, written by the LDMA after each single result
+static volatile uint32_t singleSlot;
+
+// Ring passes, counted by the LDMA interrupt
+static volatile uint32_t scanWraps;
+static volatile uint32_t singleWraps;
+
+// Frame (scan) or slot (single) of the next result of each channel
+static uint32_t nextResult[IADC_SCHED_MAX_CHANNELS];
+static uint32_t overruns[IADC_SCHED_MAX_CHANNELS];
+
+static uint32_t fullScaleMv;
+
+/*******************************************************************************
+ *********************   STATIC FUNCTION DEFINATION ****************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Scan frames completed since the start.
+ ******************************************************************************/
+static uint32_t scan_frames(void)
+{
+  uint32_t flags, words, wraps;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  do {
+    flags = LDMA_IntGet();
+    words = (LDMA->CH[IADC_SCHED_SCAN_LDMA_CH].DST - (uint32_t)scanRing)
+            / sizeof(uint32_t);
+  } while ((flags ^ LDMA_IntGet()) & SCAN_CH_MASK);
+  wraps = scanWraps;
+  // Pass completed and descriptor reloaded, interrupt not handled yet
+  if ((flags & SCAN_CH_MASK) && (words < (RING * plan.scanCount))) {
+    wraps++;
+  }
+  CORE_EXIT_ATOMIC();
+
+  return wraps * RING + words / plan.scanCount;
+}
+
+/***************************************************************************//**
+ * Single slots completed since the start.
+ ******************************************************************************/
+static uint32_t single_slots(void)
+{
+  uint32_t flags, slot, wraps;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  do {
+    flags = LDMA_IntGet();
+    slot = singleSlot;
+  } while ((flags ^ LDMA_IntGet()) & SINGLE_CH_MASK);
+  wraps = singleWraps;
+  if (flags & SINGLE_CH_MASK) {
+    wraps++;
+  }
+  CORE_EXIT_ATOMIC();
+
+  return wraps * RING + slot;
+}
+
+/***************************************************************************//**
+ * SINGLE register value of a slot.
+ ******************************************************************************/
+static uint32_t slot_input(uint32_t slot)
+{
+  uint32_t channel = plan.slotChannel[slot % plan.frames];
+
+  if (channel == IADC_SCHED_SLOT_FREE) {
+    channel = fillerChannel;
+  }
+  return singleInput[channel];
+}
+
+/***************************************************************************//**
+ * Conversion time of configuration 0, input switching included.
+ *
+ * conversion time = ((4 * OSRHS) + 2) * averages / fCLK_ADC, plus 2 CLK_ADC
+ * cycles of input multiplexer switching.
+ ******************************************************************************/
+static uint32_t conversion_ns(const IADC_Init_t *init,
+                              const IADC_AllConfigs_t *allConfigs)
+{
+  const IADC_Config_t *config = &allConfigs->configs[0];
+  uint32_t clkAdc, cycles;
+
+  clkAdc = CMU_ClockFreqGet(cmuClock_IADCCLK)
+           / (init->srcClkPrescale + 1)
+           / (config->adcClkPrescale + 1);
+  // The high speed oversampling ratios are 2x << osrHighSpeed
+  cycles = (4 * (2UL << config->osrHighSpeed) + 2) * (1UL << config->digAvg)
+           + 2;
+  return (uint32_t)(((uint64_t)cycles * 1000000000ULL + clkAdc - 1) / clkAdc);
+}
+
+/***************************************************************************//**
+ * Start the LDMA channels of the scan results and of the single slots.
+ ******************************************************************************/
+static void ldma_start(void)
+{
+  LDMA_Init_t init = LDMA_INIT_DEFAULT;
+  LDMA_TransferCfg_t scanCfg =
+    LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_IADC0_IADC_SCAN);
+  LDMA_TransferCfg_t singleCfg =
+    LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_IADC0_IADC_SINGLE);
+  LDMA_Descriptor_t *desc;
+  uint32_t slot, next;
+  int32_t link;
+
+  LDMA_Init(&init);
+
+  // One descriptor looping on itself over the whole scan ring
+  scanDesc = (LDMA_Descriptor_t)
+             LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(&IADC0->SCANFIFODATA,
+                                              scanRing,
+                                              RING * plan.scanCount,
+                                              0);
+  scanDesc.xfer.size = ldmaCtrlSizeWord;
+  scanDesc.xfer.doneIfs = 1;
+  LDMA_StartTransfer(IADC_SCHED_SCAN_LDMA_CH, &scanCfg, &scanDesc);
+
+  if (plan.singleCount == 0) {
+    return;
+  }
+
+  /*
+   * Each single result is followed by three writes: the input of the next
+   * slot to the SINGLE register, the start of the next single conversion,
+   * which the tailgating holds until after the next scan, and the slot
+   * counter. The list loops over the whole single ring.
+   */
+  for (slot = 0; slot < RING; slot++) {
+    desc = &singleDesc[slot * SLOT_DESCRIPTORS];
+    next = (slot + 1) % RING;
+    // Back to the start of the list, with an interrupt, after the last slot
+    link = next ? 1 : 1 - (int32_t)(RING * SLOT_DESCRIPTORS);
+
+    desc[0] = (LDMA_Descriptor_t)
+              LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(&IADC0->SINGLEFIFODATA,
+                                               &singleRing[slot],
+                                               1,
+                                               1);
+    desc[0].xfer.size = ldmaCtrlSizeWord;
+    desc[0].xfer.doneIfs = 0;
+    desc[1] = (LDMA_Descriptor_t)
+              LDMA_DESCRIPTOR_LINKREL_WRITE(slot_input(next),
+                                            &IADC0->SINGLE,
+                                            1);
+    desc[1].wri.doneIfs = 0;
+    desc[2] = (LDMA_Descriptor_t)
+              LDMA_DESCRIPTOR_LINKREL_WRITE(IADC_CMD_SINGLESTART,
+                                            &IADC0->CMD,
+                                            1);
+    desc[2].wri.doneIfs = 0;
+    desc[3] = (LDMA_Descriptor_t)
+              LDMA_DESCRIPTOR_LINKREL_WRITE(next, &singleSlot, link);
+    desc[3].wri.doneIfs = (next == 0);
+  }
+  LDMA_StartTransfer(IADC_SCHED_SINGLE_LDMA_CH, &singleCfg, singleDesc);
+}
+
+/*******************************************************************************
+ **************************   GLOBAL FUNCTIONS   *******************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Compute the schedule of a set of channels and start converting.
+ ******************************************************************************/
+iadc_sched_status_t iadc_sched_start(IADC_Init_t *init,
+                                     const IADC_AllConfigs_t *allConfigs,
+                                     const iadc_sched_channel_t *channels,
+                                     uint32_t count)
+{
+  // Full scale in mV is vRef / analog gain, indexed by the gain, times 2
+  static const uint8_t gainTimes2[] = { 1, 2, 4, 6, 8 };
+  iadc_sched_request_t requests[IADC_SCHED_MAX_CHANNELS];
+  iadc_sched_timing_t timing;
+  iadc_sched_status_t status;
+  IADC_InitScan_t initScan = IADC_INITSCAN_DEFAULT;
+  IADC_ScanTable_t scanTable = IADC_SCANTABLE_DEFAULT;
+  IADC_InitSingle_t initSingle = IADC_INITSINGLE_DEFAULT;
+  IADC_SingleInput_t singleInputInit = IADC_SINGLEINPUT_DEFAULT;
+  uint32_t srcClk, channel, i;
+
+  if ((count == 0) || (count > IADC_SCHED_MAX_CHANNELS)) {
+    return iadcSchedErrChannels;
+  }
+  for (i = 0; i < count; i++) {
+    requests[i].rateHz = channels[i].rateHz;
+    requests[i].priority = channels[i].priority;
+  }
+
+  // The IADC timer counts CLK_SRC_ADC cycles in 16 bits
+  srcClk = CMU_ClockFreqGet(cmuClock_IADCCLK) / (init->srcClkPrescale + 1);
+  timing.minFrameRateHz = (srcClk + 0xFFFE) / 0xFFFF;
+  timing.conversionNs = conversion_ns(init, allConfigs);
+  timing.warmupNs = (init->warmup == iadcWarmupNormal)
+                    ? IADC_SCHED_WARMUP_NS : 0;
+
+  status = iadc_sched_plan(requests, count, &timing, &plan);
+  if ((status != iadcSchedOk) && (status != iadcSchedDemoted)) {
+    return status;
+  }
+  channelCount = count;
+
+  init->timerCycles = (uint16_t)(srcClk / plan.frameRateHz);
+  IADC_init(IADC0, init, allConfigs);
+
+  // Channels converted every frame, paced by the IADC timer
+  initScan.triggerSelect = iadcTriggerSelTimer;
+  initScan.dataValidLevel = iadcFifoCfgDvl1;
+  initScan.fifoDmaWakeup = true;
+  initScan.showId = false;
+  for (i = 0; i < plan.scanCount; i++) {
+    channel = plan.scanChannel[i];
+    scanTable.entries[i].posInput = channels[channel].posInput;
+    scanTable.entries[i].negInput = channels[channel].negInput;
+    scanTable.entries[i].includeInScan = true;
+  }
+  IADC_initScan(IADC0, &initScan, &scanTable);
+
+  // One single conversion after each scan, started by the LDMA
+  initSingle.singleTailgate = true;
+  initSingle.dataValidLevel = iadcFifoCfgDvl1;
+  initSingle.fifoDmaWakeup = true;
+  singleInputInit.negInput = iadcNegInputGnd;
+  IADC_initSingle(IADC0, &initSingle, &singleInputInit);
+
+  // Let emlib encode the inputs, the LDMA writes them to SINGLE later on.
+  // Free slots convert any single channel, their results are not read.
+  for (channel = 0; channel < count; channel++) {
+    if (plan.place[channel].queue == iadcSchedSingle) {
+      singleInputInit.posInput = channels[channel].posInput;
+      singleInputInit.negInput = channels[channel].negInput;
+      IADC_updateSingleInput(IADC0, &singleInputInit);
+      singleInput[channel] = IADC0->SINGLE;
+      fillerChannel = channel;
+    }
+  }
+
+  for (channel = 0; channel < count; channel++) {
+    nextResult[channel] = plan.place[channel].index;
+    if (plan.place[channel].queue == iadcSchedScan) {
+      nextResult[channel] = 0;
+    }
+    overruns[channel] = 0;
+  }
+  scanWraps = 0;
+  singleWraps = 0;
+  singleSlot = 0;
+
+  i = allConfigs->configs[0].analogGain;
+  fullScaleMv = allConfigs->configs[0].vRef * 2
+                / gainTimes2[i < sizeof(gainTimes2) ? i : 1];
+
+  ldma_start();
+
+  if (plan.singleCount > 0) {
+    // Slot 0, converted after the first scan
+    IADC0->SINGLE = slot_input(0);
+    IADC_command(IADC0, iadcCmdStartSingle);
+  }
+  IADC_command(IADC0, iadcCmdStartScan);
+  IADC_command(IADC0, iadcCmdEnableTimer);
+
+  return status;
+}
+
+/***************************************************************************//**
+ * Take the oldest unread result of a channel.
+ ******************************************************************************/
+bool iadc_sched_read(uint32_t channel, uint32_t *code)
+{
+  const iadc_sched_place_t *place;
+  uint32_t produced, next, first, value;
+
+  if (channel >= channelCount) {
+    return false;
+  }
+  place = &plan.place[channel];
+  if (place->queue == iadcSchedNone) {
+    return false;
+  }
+
+  for (;;) {
+    produced = (place->queue == iadcSchedScan) ? scan_frames() : single_slots();
+    next = nextResult[channel];
+    if ((int32_t)(produced - next) <= 0) {
+      return false;
+    }
+
+    // The ring entry of result "produced" is being written, the oldest one
+    // left is produced - RING + 1.
+    if ((produced - next) >= RING) {
+      first = produced - RING + 1;
+      first += (place->index - first) & (place->period - 1U);
+      overruns[channel] += (first - next) / place->period;
+      nextResult[channel] = first;
+      continue;
+    }
+
+    if (place->queue == iadcSchedScan) {
+      value = scanRing[(next % RING) * plan.scanCount + place->index];
+      produced = scan_frames();
+    } else {
+      value = singleRing[next % RING];
+      produced = single_slots();
+    }
+    // Overwritten while it was read
+    if ((int32_t)(produced - next) >= RING) {
+      continue;
+    }
+
+    nextResult[channel] = next + place->period;
+    *code = value & CODE_MAX;
+    return true;
+  }
+}
+
+/***************************************************************************//**
+ * Number of results of a channel overwritten before they were read.
+ ******************************************************************************/
+uint32_t iadc_sched_overruns(uint32_t channel)
+{
+  return (channel < channelCount) ? overruns[channel] : 0;
+}
+
+/***************************************************************************//**
+ * Convert a raw result to mV, in fixed point.
+ ******************************************************************************/
+uint32_t iadc_sched_to_mv(uint32_t code)
+{
+  return (code * fullScaleMv + CODE_MAX / 2) / CODE_MAX;
+}
+
+/***************************************************************************//**
+ * Get the schedule computed by iadc_sched_start().
+ ******************************************************************************/
+const iadc_sched_plan_t *iadc_sched_plan_get(void)
+{
+  return &plan;
+}
+
+/**************************************************************************//**
+ * @brief  LDMA interrupt handler, counts the passes over the rings
+ *****************************************************************************/
+void LDMA_IRQHandler(void)
+{
+  uint32_t pending = LDMA_IntGetEnabled();
+
+  if (pending & SCAN_CH_MASK) {
+    LDMA_IntClear(SCAN_CH_MASK);
+    scanWraps++;
+  }
+  if (pending & SINGLE_CH_MASK) {
+    LDMA_IntClear(SINGLE_CH_MASK);
+    singleWraps++;
+  }
+  if (pending & LDMA_IF_ERROR) {
+    LDMA_IntClear(LDMA_IF_ERROR);
+  }
+}
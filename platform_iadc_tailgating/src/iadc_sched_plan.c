@@ -0,0 +1,239 @@
+/***************************************************************************//**
+ * @file
+ * @brief Conversion schedule of the IADC scheduler
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "iadc_sched_plan.h"
+
+#if (IADC_SCHED_MAX_FRAMES & (IADC_SCHED_MAX_FRAMES - 1)) \
+  || (IADC_SCHED_MAX_FRAMES > 128)
+#error "IADC_SCHED_MAX_FRAMES must be a power of two up to 128"
+#endif
+
+#if IADC_SCHED_MAX_CHANNELS >= IADC_SCHED_SLOT_FREE
+#error "IADC_SCHED_MAX_CHANNELS too large"
+#endif
+
+/*******************************************************************************
+ *********************   STATIC FUNCTION DEFINATION ****************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Longest period, a power of two frames, still meeting a rate.
+ ******************************************************************************/
+static uint32_t period_of(uint32_t frameRateHz, uint32_t rateHz)
+{
+  uint32_t period = 1;
+
+  while ((period < IADC_SCHED_MAX_FRAMES)
+         && ((uint64_t)rateHz * period * 2 <= frameRateHz)) {
+    period *= 2;
+  }
+  return period;
+}
+
+/***************************************************************************//**
+ * Reverse the low bits of a value.
+ ******************************************************************************/
+static uint32_t bit_reverse(uint32_t value, uint32_t period)
+{
+  uint32_t reversed = 0;
+
+  for (uint32_t bit = 1; bit < period; bit *= 2) {
+    reversed = (reversed << 1) | ((value & bit) ? 1 : 0);
+  }
+  return reversed;
+}
+
+/***************************************************************************//**
+ * Find a free class of single slots (frames equal to offset modulo period).
+ *
+ * The offsets are tried in bit reversed order, so that the channels fill the
+ * slots like a buddy allocator: a channel of period p takes half of what a
+ * channel of period p/2 would, and the free slots stay in large classes.
+ *
+ * @return The offset, or -1 if all classes are taken.
+ ******************************************************************************/
+static int32_t single_fit(const uint8_t *slots, uint32_t period)
+{
+  uint32_t offset, frame;
+
+  for (uint32_t i = 0; i < period; i++) {
+    offset = bit_reverse(i, period);
+    for (frame = offset; frame < IADC_SCHED_MAX_FRAMES; frame += period) {
+      if (slots[frame] != IADC_SCHED_SLOT_FREE) {
+        break;
+      }
+    }
+    if (frame >= IADC_SCHED_MAX_FRAMES) {
+      return (int32_t)offset;
+    }
+  }
+  return -1;
+}
+
+/*******************************************************************************
+ **************************   GLOBAL FUNCTIONS   *******************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Compute the schedule of a set of channels.
+ ******************************************************************************/
+iadc_sched_status_t iadc_sched_plan(const iadc_sched_request_t *requests,
+                                    uint32_t count,
+                                    const iadc_sched_timing_t *timing,
+                                    iadc_sched_plan_t *plan)
+{
+  iadc_sched_status_t status = iadcSchedOk;
+  uint8_t order[IADC_SCHED_MAX_CHANNELS];
+  uint32_t frameNs, scanMax, period, wanted, channel, i, j;
+  int32_t offset;
+  uint8_t tmp;
+
+  memset(plan, 0, sizeof(*plan));
+  memset(plan->slotChannel, IADC_SCHED_SLOT_FREE, sizeof(plan->slotChannel));
+  plan->frames = 1;
+  if ((count == 0) || (count > IADC_SCHED_MAX_CHANNELS)) {
+    return iadcSchedErrChannels;
+  }
+
+  // One frame for the fastest channel
+  plan->frameRateHz = timing->minFrameRateHz;
+  for (i = 0; i < count; i++) {
+    if (requests[i].rateHz > plan->frameRateHz) {
+      plan->frameRateHz = requests[i].rateHz;
+    }
+  }
+  if (plan->frameRateHz == 0) {
+    return iadcSchedErrChannels;
+  }
+
+  // Scan entries the frame has time for, the single slot always counted
+  frameNs = 1000000000UL / plan->frameRateHz;
+  if (frameNs < (timing->warmupNs + 2 * timing->conversionNs)) {
+    return iadcSchedErrFrame;
+  }
+  scanMax = (frameNs - timing->warmupNs) / timing->conversionNs - 1;
+  if (scanMax > IADC_SCHED_SCAN_ENTRIES) {
+    scanMax = IADC_SCHED_SCAN_ENTRIES;
+  }
+
+  // Placement order: priority, then rate, then channel number
+  for (i = 0; i < count; i++) {
+    order[i] = (uint8_t)i;
+  }
+  for (i = 1; i < count; i++) {
+    for (j = i; j > 0; j--) {
+      const iadc_sched_request_t *a = &requests[order[j - 1]];
+      const iadc_sched_request_t *b = &requests[order[j]];
+
+      if ((a->priority > b->priority)
+          || ((a->priority == b->priority) && (a->rateHz >= b->rateHz))) {
+        break;
+      }
+      tmp = order[j - 1];
+      order[j - 1] = order[j];
+      order[j] = tmp;
+    }
+  }
+
+  for (i = 0; i < count; i++) {
+    iadc_sched_place_t *place;
+
+    channel = order[i];
+    place = &plan->place[channel];
+    wanted = period_of(plan->frameRateHz, requests[channel].rateHz);
+
+    if ((wanted == 1) && (plan->scanCount < scanMax)) {
+      place->queue = iadcSchedScan;
+      place->index = (uint8_t)plan->scanCount;
+      place->period = 1;
+      plan->scanChannel[plan->scanCount++] = (uint8_t)channel;
+      continue;
+    }
+
+    for (period = wanted; period <= IADC_SCHED_MAX_FRAMES; period *= 2) {
+      offset = single_fit(plan->slotChannel, period);
+      if (offset >= 0) {
+        place->queue = iadcSchedSingle;
+        place->index = (uint8_t)offset;
+        place->period = (uint8_t)period;
+        for (j = (uint32_t)offset; j < IADC_SCHED_MAX_FRAMES; j += period) {
+          plan->slotChannel[j] = (uint8_t)channel;
+        }
+        plan->singleCount++;
+        break;
+      }
+      // A scan entry gives more than asked, but before demoting the channel
+      if ((period == wanted) && (plan->scanCount < scanMax)) {
+        place->queue = iadcSchedScan;
+        place->index = (uint8_t)plan->scanCount;
+        place->period = 1;
+        plan->scanChannel[plan->scanCount++] = (uint8_t)channel;
+        break;
+      }
+    }
+
+    if (place->queue == iadcSchedNone) {
+      status = iadcSchedErrPlace;
+    } else if ((place->period > wanted) && (status == iadcSchedOk)) {
+      status = iadcSchedDemoted;
+    }
+  }
+
+  // Tailgated single conversions only run after a scan. Without any scan
+  // entry, the first channel placed, alone in its slots, takes one.
+  if ((plan->scanCount == 0) && (plan->singleCount > 0)) {
+    channel = order[0];
+    for (j = 0; j < IADC_SCHED_MAX_FRAMES; j++) {
+      if (plan->slotChannel[j] == channel) {
+        plan->slotChannel[j] = IADC_SCHED_SLOT_FREE;
+      }
+    }
+    plan->singleCount--;
+    plan->place[channel].queue = iadcSchedScan;
+    plan->place[channel].index = 0;
+    plan->place[channel].period = 1;
+    plan->scanChannel[plan->scanCount++] = (uint8_t)channel;
+  }
+
+  for (i = 0; i < count; i++) {
+    if ((plan->place[i].queue == iadcSchedSingle)
+        && (plan->place[i].period > plan->frames)) {
+      plan->frames = plan->place[i].period;
+    }
+  }
+
+  plan->busyNs = timing->warmupNs
+                 + (plan->scanCount + (plan->singleCount ? 1 : 0))
+                 * timing->conversionNs;
+  return status;
+}
+
+/***************************************************************************//**
+ * Rate a channel gets from a schedule, in mHz.
+ ******************************************************************************/
+uint32_t iadc_sched_rate_mhz(const iadc_sched_plan_t *plan, uint32_t channel)
+{
+  const iadc_sched_place_t *place = &plan->place[channel];
+
+  if (place->queue == iadcSchedNone) {
+    return 0;
+  }
+  return (uint32_t)(((uint64_t)plan->frameRateHz * 1000) / place->period);
+}
@@ -0,0 +1,222 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host model of the IADC conversion scheduler
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ *******************************************************************************
+ *
+ * Computes the schedule of a channel set with ../src/iadc_sched_plan.c, then
+ * plays it frame by frame on a model of the IADC timer, the scan and the
+ * tailgated single conversion, and checks that:
+ *
+ * - every frame ends before the next timer trigger,
+ * - every channel gets the rate it was given, with no gap between two of its
+ *   conversions longer than its period,
+ * - channels that were not demoted get at least their requested rate.
+ *
+ * Build:
+ *   cc -O2 -I../inc -o iadc_sched_model iadc_sched_model.c \
+ *      ../src/iadc_sched_plan.c
+ *
+ * Usage:
+ *   iadc_sched_model [options] [rate[:priority] ...]
+ *
+ *   Without channels, runs the channel set of the example and a few
+ *   oversubscribed ones.
+ *
+ *   --conversion-ns N  One conversion (default 120000, 12 CLK_ADC cycles at
+ *                      100 kHz as in the example)
+ *   --warmup-ns N      Warm-up at the start of each frame (default 5000)
+ *   --min-rate N       Slowest IADC timer rate (default 150)
+ *   --frames N         Frames to play (default 1024)
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iadc_sched_plan.h"
+
+static iadc_sched_timing_t timing = {
+  .minFrameRateHz = 150,
+  .conversionNs = 120000,
+  .warmupNs = 5000,
+};
+
+static uint32_t playFrames = 1024;
+
+static const char *statusNames[] = {
+  "ok", "demoted", "bad channel count", "frame too short", "not placed"
+};
+
+/***************************************************************************//**
+ * Play a schedule and check it.
+ *
+ * @return Number of failed checks.
+ ******************************************************************************/
+static uint32_t play(const iadc_sched_request_t *requests, uint32_t count,
+                     const iadc_sched_plan_t *plan)
+{
+  uint64_t frameNs = 1000000000ULL / plan->frameRateHz;
+  uint64_t last[IADC_SCHED_MAX_CHANNELS], maxGap[IADC_SCHED_MAX_CHANNELS];
+  uint32_t samples[IADC_SCHED_MAX_CHANNELS];
+  uint32_t overflows = 0, failures = 0;
+  uint64_t now, end;
+  uint32_t channel, rate;
+
+  memset(samples, 0, sizeof(samples));
+  memset(maxGap, 0, sizeof(maxGap));
+
+  for (uint32_t frame = 0; frame < playFrames; frame++) {
+    now = frame * frameNs + timing.warmupNs;
+    end = (frame + 1) * frameNs;
+
+    for (uint32_t entry = 0; entry < plan->scanCount; entry++) {
+      now += timing.conversionNs;
+      channel = plan->scanChannel[entry];
+      if (samples[channel]++ && ((now - last[channel]) > maxGap[channel])) {
+        maxGap[channel] = now - last[channel];
+      }
+      last[channel] = now;
+    }
+    if (plan->singleCount > 0) {
+      // Free slots convert a filler whose result nobody reads
+      now += timing.conversionNs;
+      channel = plan->slotChannel[frame % plan->frames];
+      if (channel != IADC_SCHED_SLOT_FREE) {
+        if (samples[channel]++ && ((now - last[channel]) > maxGap[channel])) {
+          maxGap[channel] = now - last[channel];
+        }
+        last[channel] = now;
+      }
+    }
+    if (now > end) {
+      overflows++;
+    }
+  }
+
+  printf("frame rate %u Hz, %u frames, %u scan entries, %u single channels, "
+         "busy %u of %llu us\n",
+         plan->frameRateHz, plan->frames, plan->scanCount, plan->singleCount,
+         plan->busyNs / 1000, (unsigned long long)(frameNs / 1000));
+  printf("  ch  asked Hz  prio  queue   idx  period  given Hz   played Hz  "
+         "max gap us\n");
+  for (channel = 0; channel < count; channel++) {
+    const iadc_sched_place_t *place = &plan->place[channel];
+    double played = (double)samples[channel] * plan->frameRateHz / playFrames;
+    const char *verdict = "";
+
+    rate = iadc_sched_rate_mhz(plan, channel);
+    if (place->queue == iadcSchedNone) {
+      verdict = "NOT PLACED";
+    } else if (maxGap[channel] > (uint64_t)place->period * frameNs) {
+      verdict = "FAIL gap";
+      failures++;
+    } else if ((samples[channel] + 1) * (uint64_t)place->period < playFrames) {
+      verdict = "FAIL count";
+      failures++;
+    } else if ((uint64_t)rate < (uint64_t)requests[channel].rateHz * 1000) {
+      verdict = "demoted";
+    }
+    printf("  %2u  %8u  %4u  %-6s  %3u  %6u  %8.3f  %10.3f  %10.1f  %s\n",
+           channel, requests[channel].rateHz, requests[channel].priority,
+           place->queue == iadcSchedScan ? "scan"
+           : place->queue == iadcSchedSingle ? "single" : "-",
+           place->index, place->period, rate / 1000.0, played,
+           maxGap[channel] / 1000.0, verdict);
+  }
+  if (overflows) {
+    printf("  FAIL: %u frames overran the next trigger\n", overflows);
+    failures++;
+  }
+  return failures;
+}
+
+/***************************************************************************//**
+ * Plan, print and play one channel set.
+ ******************************************************************************/
+static uint32_t run(const char *name, const iadc_sched_request_t *requests,
+                    uint32_t count)
+{
+  static iadc_sched_plan_t plan;
+  iadc_sched_status_t status;
+
+  status = iadc_sched_plan(requests, count, &timing, &plan);
+  printf("%s: %s\n", name, statusNames[status]);
+  if ((status != iadcSchedOk) && (status != iadcSchedDemoted)
+      && (status != iadcSchedErrPlace)) {
+    return 0;
+  }
+  return play(requests, count, &plan);
+}
+
+int main(int argc, char **argv)
+{
+  iadc_sched_request_t requests[IADC_SCHED_MAX_CHANNELS];
+  uint32_t count = 0, failures = 0;
+  char *end;
+
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "--conversion-ns") == 0) && (i + 1 < argc)) {
+      timing.conversionNs = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if ((strcmp(argv[i], "--warmup-ns") == 0) && (i + 1 < argc)) {
+      timing.warmupNs = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if ((strcmp(argv[i], "--min-rate") == 0) && (i + 1 < argc)) {
+      timing.minFrameRateHz = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if ((strcmp(argv[i], "--frames") == 0) && (i + 1 < argc)) {
+      playFrames = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if ((argv[i][0] != '-') && (count < IADC_SCHED_MAX_CHANNELS)) {
+      requests[count].rateHz = (uint32_t)strtoul(argv[i], &end, 0);
+      requests[count].priority = (*end == ':')
+                                 ? (uint8_t)strtoul(end + 1, NULL, 0) : 0;
+      count++;
+    } else {
+      fprintf(stderr, "usage: %s [--conversion-ns N] [--warmup-ns N] "
+              "[--min-rate N] [--frames N] [rate[:priority] ...]\n", argv[0]);
+      return 2;
+    }
+  }
+  if ((timing.conversionNs == 0) || (playFrames == 0)) {
+    return 2;
+  }
+
+  if (count > 0) {
+    failures += run("channels", requests, count);
+  } else {
+    // Channel set of app.c
+    static const iadc_sched_request_t example[] = {
+      { 200, 3 }, { 200, 3 }, { 50, 2 }, { 10, 1 }, { 10, 1 },
+    };
+    // More single channels than slots: the last ones take scan entries
+    static const iadc_sched_request_t crowded[] = {
+      { 1000, 4 }, { 500, 3 }, { 250, 3 }, { 250, 2 }, { 125, 1 },
+      { 100, 1 }, { 60, 0 },
+    };
+    // More full rate channels than the frame has time for
+    static const iadc_sched_request_t full[] = {
+      { 1000, 2 }, { 1000, 2 }, { 1000, 2 }, { 1000, 2 }, { 1000, 1 },
+      { 1000, 1 }, { 1000, 1 }, { 1000, 1 }, { 1000, 0 }, { 1000, 0 },
+      { 20, 3 },
+    };
+
+    failures += run("example", example, sizeof(example) / sizeof(example[0]));
+    timing.conversionNs = 12000;
+    failures += run("crowded", crowded, sizeof(crowded) / sizeof(crowded[0]));
+    timing.conversionNs = 100000;
+    failures += run("full", full, sizeof(full) / sizeof(full[0]));
+  }
+
+  printf("%s\n", failures ? "FAILED" : "all schedules meet their rates");
+  return failures ? 1 : 0;
+}
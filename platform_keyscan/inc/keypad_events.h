@@ -0,0 +1,143 @@
+/***************************************************************************//**
+ * @file
+ * @brief Debounced key event queue with repeat and chord detection
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef KEYPAD_EVENTS_H
+#define KEYPAD_EVENTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "keyscan_driver_config.h"
+
+/*******************************************************************************
+ ******************************  DEFINES **************************************
+ ******************************************************************************/
+
+// Number of entries in the event queue between the keyscan callback and the
+//   application. Must be a power of two.
+#ifndef KEYPAD_EVENTS_QUEUE_SIZE
+#define KEYPAD_EVENTS_QUEUE_SIZE      32
+#endif
+
+// Minimum time between two accepted state changes of the same key.
+#ifndef KEYPAD_EVENTS_DEBOUNCE_MS
+#define KEYPAD_EVENTS_DEBOUNCE_MS     20
+#endif
+
+// Time a key has to be held before it starts to repeat.
+#ifndef KEYPAD_EVENTS_REPEAT_DELAY_MS
+#define KEYPAD_EVENTS_REPEAT_DELAY_MS 500
+#endif
+
+// Period of the repeat events once the key repeats.
+#ifndef KEYPAD_EVENTS_REPEAT_RATE_MS
+#define KEYPAD_EVENTS_REPEAT_RATE_MS  150
+#endif
+
+// Period of the matrix scans while a key is held.
+#ifndef KEYPAD_EVENTS_SCAN_PERIOD_MS
+#define KEYPAD_EVENTS_SCAN_PERIOD_MS  10
+#endif
+
+// Time for the rows to follow a column driven low, in microseconds.
+#ifndef KEYPAD_EVENTS_SETTLE_US
+#define KEYPAD_EVENTS_SETTLE_US       5
+#endif
+
+// Number of keys in the matrix. Every key is one bit of a 32-bit state map.
+#define KEYPAD_EVENTS_KEY_COUNT \
+  (SL_KEYSCAN_DRIVER_ROW_NUMBER * SL_KEYSCAN_DRIVER_COLUMN_NUMBER)
+
+// Key index of a matrix position.
+#define KEYPAD_EVENTS_KEY(row, column) \
+  ((column) * SL_KEYSCAN_DRIVER_ROW_NUMBER + (row))
+
+// Bit of a key in a state map or a chord mask.
+#define KEYPAD_EVENTS_KEY_MASK(row, column) \
+  (1UL << KEYPAD_EVENTS_KEY(row, column))
+
+/*******************************************************************************
+ ********************************   ENUMS   ************************************
+ ******************************************************************************/
+
+typedef enum {
+  KEYPAD_EVENT_PRESS,   // key went down, key field is the key index
+  KEYPAD_EVENT_RELEASE, // key went up, key field is the key index
+  KEYPAD_EVENT_REPEAT,  // key is still held, key field is the key index
+  KEYPAD_EVENT_CHORD,   // chord completed, key field is the chord index
+} keypad_event_type_t;
+
+/*******************************************************************************
+ *******************************   STRUCTS   ***********************************
+ ******************************************************************************/
+
+typedef struct {
+  uint32_t timestamp;           // sleeptimer tick of the event
+  uint8_t type;                 // keypad_event_type_t
+  uint8_t key;                  // key or chord index
+} keypad_event_t;
+
+/*******************************************************************************
+ *********************  GLOBAL FUNCTION DECLARATION ****************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @brief Initialize the event queue.
+ *
+ * @param[in] chords Table of key masks, each one built from at least two
+ *                   KEYPAD_EVENTS_KEY_MASK() bits. The table is not copied.
+ * @param[in] chord_count Number of entries in the chord table.
+ ******************************************************************************/
+void keypad_events_init(const uint32_t *chords, uint8_t chord_count);
+
+/***************************************************************************//**
+ * @brief Feed a keyscan report into the queue and scan the whole matrix.
+ *
+ * @note Called from the keyscan driver callback (interrupt context) when a
+ *       key press is reported. Until every key is released, the column pins
+ *       are then driven through the GPIO and the whole matrix is read every
+ *       KEYPAD_EVENTS_SCAN_PERIOD_MS from a sleeptimer callback. The keyscan
+ *       callback and the scan timer are the only producers of the queue, and
+ *       never run at the same time.
+ *
+ * @param[in] matrix Keyscan matrix, one byte of row bits per column.
+ ******************************************************************************/
+void keypad_events_on_scan(const uint8_t *matrix);
+
+/***************************************************************************//**
+ * @brief Get the next key event.
+ *
+ * @note Called from the application loop. This is the only consumer of the
+ *       queue.
+ *
+ * @param[out] event The next event.
+ *
+ * @return True if an event was returned, false if there is nothing to do.
+ ******************************************************************************/
+bool keypad_events_get(keypad_event_t *event);
+
+/***************************************************************************//**
+ * @brief Check whether keypad_events_get() has work to do.
+ ******************************************************************************/
+bool keypad_events_pending(void);
+
+/***************************************************************************//**
+ * @brief Number of events lost because the queue was full.
+ ******************************************************************************/
+uint32_t keypad_events_dropped(void);
+
+#endif // KEYPAD_EVENTS_H
@@ -16,6 +16,7 @@
  ******************************************************************************/
 #include "keyscan_driver.h"
 #include "keyscan_driver_config.h"
+#include "keypad_events.h"
 
 #include "glib.h"
 #include "dmd.h"
@@ -24,11 +25,6 @@
 #include "sl_board_control.h"
 #include "sl_power_manager.h"
 
-/*******************************************************************************
- ******************************  DEFINES **************************************
- ******************************************************************************/
-#define FIFO_BUFFER_SIZE 24
-
 /*******************************************************************************
  **************************  GLOBAL VARIABLES   ********************************
  ******************************************************************************/
@@ -41,17 +37,17 @@ static const char keypad[SL_KEYSCAN_DRIVER_ROW_NUMBER][
   { '3', '6', '9', '#' },
 };
 
-// Store the pressed keys in a FIFO buffer
-static char pressed_key[FIFO_BUFFER_SIZE] = { 0 };
-// buffer index
-static uint8_t write_index = 0;
-static uint8_t read_index = 0;
+// Key chords: pressing '*' and '#' together clears the screen.
+static const uint32_t chords[] = {
+  KEYPAD_EVENTS_KEY_MASK(0, 3) | KEYPAD_EVENTS_KEY_MASK(2, 3),
+};
 
 // Variables for the visualisation:
 static GLIB_Context_t glibContext;
 
-// flag to enable the sleep mode
-static volatile bool ok_to_sleep = true;
+// Cursor position on the screen
+static int32_t cursor_x = 6;
+static int32_t cursor_y = 40;
 
 /*******************************************************************************
  *********************   STATIC FUNCTION DEFINITION ****************************
@@ -64,19 +60,19 @@ static void on_event(uint8_t *p_keyscan_matrix,
                      sl_keyscan_driver_status_t status);
 
 /***************************************************************************//**
- * @brief Map the pushed key and load in to the buffer
+ * @brief GLIB and DMD initialization
  ******************************************************************************/
-static void map_key(uint8_t *scan_result);
+static void init_display(void);
 
 /***************************************************************************//**
- * @brief GLIB and DMD initialization
+ * @brief Draw a pressed key on the display
  ******************************************************************************/
-static void init_display(void);
+static void draw_key(char key);
 
 /***************************************************************************//**
- * @brief Update the display with the pressed keys
+ * @brief Clear the pressed keys from the display
  ******************************************************************************/
-static void update_display(char key);
+static void clear_keys(void);
 
 /***************************************************************************//**
  * @brief PowerManager initialization
@@ -109,6 +105,9 @@ void app_init(void)
   // Initialize the display
   init_display();
 
+  // Initialize the key event queue
+  keypad_events_init(chords, sizeof(chords) / sizeof(chords[0]));
+
   // Register the keyscan handle.
   static sl_keyscan_driver_process_keyscan_event_handle_t handle =
   {
@@ -129,23 +128,31 @@ void app_init(void)
  ******************************************************************************/
 void app_process_action(void)
 {
-  static uint8_t performed_writing = false;
-
-  // If the two index is equal, then the buffer is empty
-  if (write_index != read_index) {
-    // Update the display with the pressed key
-    update_display(pressed_key[read_index]);
-    read_index++;
-    if (read_index >= FIFO_BUFFER_SIZE) {
-      read_index = 0;
+  keypad_event_t event;
+  bool redraw = false;
+  uint8_t row;
+  uint8_t column;
+
+  // Drain every pending event and refresh the display only once.
+  while (keypad_events_get(&event)) {
+    switch (event.type) {
+      case KEYPAD_EVENT_PRESS:
+      case KEYPAD_EVENT_REPEAT:
+        row = event.key % SL_KEYSCAN_DRIVER_ROW_NUMBER;
+        column = event.key / SL_KEYSCAN_DRIVER_ROW_NUMBER;
+        draw_key(keypad[row][column]);
+        redraw = true;
+        break;
+      case KEYPAD_EVENT_CHORD:
+        clear_keys();
+        redraw = true;
+        break;
+      default:
+        break;
     }
-    // The key was written out so I could go to sleep.
-    performed_writing = true;
   }
-  if (performed_writing) {
-    // All the keys I pressed were written out so I could go to sleep.
-    ok_to_sleep = true;
-    performed_writing = false;
+  if (redraw) {
+    DMD_updateDisplay();
   }
 }
 
@@ -154,7 +161,9 @@ void app_process_action(void)
  ******************************************************************************/
 bool app_is_ok_to_sleep(void)
 {
-  return ok_to_sleep;
+  // The power manager calls this in a critical section, so an event queued
+  //   by the keyscan interrupt after this check wakes the core up again.
+  return !keypad_events_pending();
 }
 
 /*******************************************************************************
@@ -167,70 +176,9 @@ bool app_is_ok_to_sleep(void)
 static void on_event(uint8_t *p_keyscan_matrix,
                      sl_keyscan_driver_status_t status)
 {
-#if (SL_KEYSCAN_DRIVER_SINGLEPRESS) // When the SinglePress feature is enabled
-  static uint8_t press = false;
-  // If a key is pressed and not being pressed, then map the key and set the
-  //   press flag to true.
-  if ((status == SL_KEYSCAN_STATUS_KEYPRESS_VALID) && (!press)) {
-    map_key(p_keyscan_matrix);
-    press = true;
-  }
-  // If a key is released and being pressed, then reset the press flag to false.
-  if ((status == SL_KEYSCAN_STATUS_KEYPRESS_RELEASED) && (press)) {
-    press = false;
-    // The key released so I can go back to sleep.
-    ok_to_sleep = true;
-  }
-#else
-  if (status == SL_KEYSCAN_STATUS_KEYPRESS_RELEASED) {
-    map_key(p_keyscan_matrix);
-  }
-#endif
-}
-
-/***************************************************************************//**
- * @brief Map the pushed key and load in to the buffer
- ******************************************************************************/
-static void map_key(uint8_t *scan_result)
-{
-  uint8_t offset_fix = 0;
-  uint8_t i = 0;
-  uint8_t j = 0;
-  while (i < SL_KEYSCAN_DRIVER_COLUMN_NUMBER) {
-    while (j < SL_KEYSCAN_DRIVER_ROW_NUMBER)
-    {
-      if (scan_result[i] & (1 << j)) {
-#if (SL_KEYSCAN_DRIVER_SINGLEPRESS) // When the SinglePress feature is enabled
-        offset_fix = i;
-#else
-        // The returned column number contains a fix offset error.
-        // So I use the offset_fix to fix the column number error.
-        offset_fix = i - 1;
-        // I checked for the 0xFF because I used the uint_8 type.
-        if (offset_fix == 0xFF) {
-          offset_fix = SL_KEYSCAN_DRIVER_COLUMN_NUMBER - 1;
-        }
-#endif
-        // Load the pressed key in to the buffer and increment the write index.
-        // The buffer size is 24, so if there are more than 24 pressed keys, the
-        //   oldest key will be overwritten.
-        pressed_key[write_index] = keypad[j][offset_fix];
-        write_index++;
-        if (write_index >= FIFO_BUFFER_SIZE) {
-          write_index = 0;
-        }
-// The single press feature is enabled, so after saving a key, it will return
-//   immediately.
-// If the SinglePress feature is disabled, it will write all the keys and then
-//   return.
-#if (SL_KEYSCAN_DRIVER_SINGLEPRESS)
-        return;
-#endif
-      }
-      j++;
-    }
-    j = 0;
-    i++;
+  // The event queue scans the whole matrix from here on, releases included.
+  if (status == SL_KEYSCAN_STATUS_KEYPRESS_VALID) {
+    keypad_events_on_scan(p_keyscan_matrix);
   }
 }
 
@@ -290,33 +238,50 @@ static void init_display(void)
 }
 
 /***************************************************************************//**
- * @brief Update the display with the pressed keys
+ * @brief Draw a pressed key on the display
  ******************************************************************************/
-static void update_display(char key)
+static void draw_key(char key)
 {
-  static int32_t x = 6;
-  static int32_t y = 40;
   // Write out a space to the screen
-  GLIB_drawChar(&glibContext, ' ', x, y, true);
+  GLIB_drawChar(&glibContext, ' ', cursor_x, cursor_y, true);
   // Write out the pressed key to the screen
-  GLIB_drawChar(&glibContext, key, x + 6, y, true);
+  GLIB_drawChar(&glibContext, key, cursor_x + 6, cursor_y, true);
   // Move the pointer to the next position in the screen
-  x += 12;
-  if (x > 110) {
+  cursor_x += 12;
+  if (cursor_x > 110) {
     // Remove the cursor from the actual line
-    GLIB_drawChar(&glibContext, ' ', 0, y, true);
-    GLIB_drawChar(&glibContext, ' ', x, y, true);
+    GLIB_drawChar(&glibContext, ' ', 0, cursor_y, true);
+    GLIB_drawChar(&glibContext, ' ', cursor_x, cursor_y, true);
     // Move the pointers to the next position in the screen
-    y += 15;
-    x = 5;
-    if (y > 120) {
-      y = 40;
+    cursor_y += 15;
+    cursor_x = 5;
+    if (cursor_y > 120) {
+      cursor_y = 40;
     }
     // Move the cursor line to the next line in the screen
-    GLIB_Rectangle_t rect = { 0, y, 115, y + 7 };
+    GLIB_Rectangle_t rect = { 0, cursor_y, 115, cursor_y + 7 };
     GLIB_drawRectFilled(&glibContext, &rect);
   }
-  DMD_updateDisplay();
+}
+
+/***************************************************************************//**
+ * @brief Clear the pressed keys from the display
+ ******************************************************************************/
+static void clear_keys(void)
+{
+  GLIB_Rectangle_t rect = { 0, 40, 127, 127 };
+
+  // Erase the key area with the background color
+  glibContext.foregroundColor = White;
+  GLIB_drawRectFilled(&glibContext, &rect);
+  glibContext.foregroundColor = Black;
+
+  // Put the cursor back to the first line
+  cursor_x = 6;
+  cursor_y = 40;
+  rect.xMax = 115;
+  rect.yMax = 47;
+  GLIB_drawRectFilled(&glibContext, &rect);
 }
 
 /***************************************************************************//**
@@ -342,7 +307,5 @@ void sleep_mode_transition(sl_power_manager_em_t from,
   if (to == SL_POWER_MANAGER_EM0) {
     sl_board_enable_display();
     GLIB_displayWakeUp();
-    // I don't go back to sleep, while the button pressed is not processed
-    ok_to_sleep = false;
   }
 }
@@ -0,0 +1,490 @@
+/***************************************************************************//**
+ * @file
+ * @brief Debounced key event queue with repeat and chord detection
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <stddef.h>
+
+#include "keypad_events.h"
+
+#include "em_device.h"
+#include "em_gpio.h"
+#include "keyscan_driver.h"
+#include "sl_sleeptimer.h"
+#include "sl_udelay.h"
+
+/*******************************************************************************
+ ******************************  DEFINES **************************************
+ ******************************************************************************/
+#if (KEYPAD_EVENTS_KEY_COUNT > 32)
+#error "The keypad state map supports at most 32 keys"
+#endif
+
+#if (KEYPAD_EVENTS_QUEUE_SIZE & (KEYPAD_EVENTS_QUEUE_SIZE - 1))
+#error "KEYPAD_EVENTS_QUEUE_SIZE must be a power of two"
+#endif
+
+#define QUEUE_MASK    (KEYPAD_EVENTS_QUEUE_SIZE - 1)
+#define ROW_MASK      ((1U << SL_KEYSCAN_DRIVER_ROW_NUMBER) - 1)
+#define NO_KEY        0xFF
+
+// Pin of the keyscan configuration, kind is COL_OUT or ROW_SENSE
+#define KEYSCAN_PIN(kind, n)                           \
+  { SL_KEYSCAN_DRIVER_KEYSCAN_##kind##_##n##_PORT,     \
+    SL_KEYSCAN_DRIVER_KEYSCAN_##kind##_##n##_PIN }
+
+/*******************************************************************************
+ *******************************   STRUCTS   ***********************************
+ ******************************************************************************/
+
+typedef struct {
+  GPIO_Port_TypeDef port;
+  uint8_t pin;
+} keypad_pin_t;
+
+/*******************************************************************************
+ **************************  GLOBAL VARIABLES   ********************************
+ ******************************************************************************/
+
+// Event queue. The head index is only written by the producer (keyscan
+//   interrupt, then scan timer), the tail index only by the consumer
+//   (application loop), so no critical section is needed. Both indices run
+//   freely and wrap at 2^32.
+static keypad_event_t queue[KEYPAD_EVENTS_QUEUE_SIZE];
+static volatile uint32_t queue_head = 0;
+static volatile uint32_t queue_tail = 0;
+static volatile uint32_t dropped_events = 0;
+
+// Producer state: debounced key map and tick of the last accepted change.
+static uint32_t debounced_keys = 0;
+static uint32_t last_change[KEYPAD_EVENTS_KEY_COUNT];
+static uint32_t debounce_ticks;
+
+// Matrix scan: while a key is held, the column pins are taken from the
+//   keyscan peripheral and the whole matrix is read through the GPIO.
+static const keypad_pin_t column_pins[SL_KEYSCAN_DRIVER_COLUMN_NUMBER] = {
+  KEYSCAN_PIN(COL_OUT, 0),
+#if (SL_KEYSCAN_DRIVER_COLUMN_NUMBER > 1)
+  KEYSCAN_PIN(COL_OUT, 1),
+#endif
+#if (SL_KEYSCAN_DRIVER_COLUMN_NUMBER > 2)
+  KEYSCAN_PIN(COL_OUT, 2),
+#endif
+#if (SL_KEYSCAN_DRIVER_COLUMN_NUMBER > 3)
+  KEYSCAN_PIN(COL_OUT, 3),
+#endif
+#if (SL_KEYSCAN_DRIVER_COLUMN_NUMBER > 4)
+  KEYSCAN_PIN(COL_OUT, 4),
+#endif
+#if (SL_KEYSCAN_DRIVER_COLUMN_NUMBER > 5)
+  KEYSCAN_PIN(COL_OUT, 5),
+#endif
+#if (SL_KEYSCAN_DRIVER_COLUMN_NUMBER > 6)
+  KEYSCAN_PIN(COL_OUT, 6),
+#endif
+#if (SL_KEYSCAN_DRIVER_COLUMN_NUMBER > 7)
+  KEYSCAN_PIN(COL_OUT, 7),
+#endif
+};
+static const keypad_pin_t row_pins[SL_KEYSCAN_DRIVER_ROW_NUMBER] = {
+  KEYSCAN_PIN(ROW_SENSE, 0),
+  KEYSCAN_PIN(ROW_SENSE, 1),
+  KEYSCAN_PIN(ROW_SENSE, 2),
+#if (SL_KEYSCAN_DRIVER_ROW_NUMBER > 3)
+  KEYSCAN_PIN(ROW_SENSE, 3),
+#endif
+#if (SL_KEYSCAN_DRIVER_ROW_NUMBER > 4)
+  KEYSCAN_PIN(ROW_SENSE, 4),
+#endif
+#if (SL_KEYSCAN_DRIVER_ROW_NUMBER > 5)
+  KEYSCAN_PIN(ROW_SENSE, 5),
+#endif
+};
+static GPIO_Mode_TypeDef column_modes[SL_KEYSCAN_DRIVER_COLUMN_NUMBER];
+static uint32_t keyscan_route;
+static bool matrix_owned = false;
+static sl_sleeptimer_timer_handle_t scan_timer;
+
+// Consumer state: keys held as seen by the application, chords and repeat.
+static uint32_t held_keys = 0;
+static const uint32_t *chord_table = NULL;
+static uint8_t chord_table_size = 0;
+static uint8_t repeat_key = NO_KEY;
+static sl_sleeptimer_timer_handle_t repeat_timer;
+static volatile bool repeat_due = false;
+
+/*******************************************************************************
+ *********************   STATIC FUNCTION DEFINITION ****************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @brief Convert the keyscan matrix into a key map.
+ ******************************************************************************/
+static uint32_t matrix_to_keys(const uint8_t *matrix);
+
+/***************************************************************************//**
+ * @brief Read every key of the matrix through the GPIO.
+ ******************************************************************************/
+static uint32_t matrix_read(void);
+
+/***************************************************************************//**
+ * @brief Take the column pins from the keyscan peripheral.
+ ******************************************************************************/
+static void matrix_acquire(void);
+
+/***************************************************************************//**
+ * @brief Give the column pins back to the keyscan peripheral.
+ ******************************************************************************/
+static void matrix_release(void);
+
+/***************************************************************************//**
+ * @brief Turn a key map into press and release events.
+ ******************************************************************************/
+static void keys_update(uint32_t keys);
+
+/***************************************************************************//**
+ * @brief Scan timer callback, reads the matrix while a key is held.
+ ******************************************************************************/
+static void on_scan_timeout(sl_sleeptimer_timer_handle_t *handle,
+                            void *data);
+
+/***************************************************************************//**
+ * @brief Put an event in the queue (producer side).
+ ******************************************************************************/
+static void queue_push(uint8_t type, uint8_t key, uint32_t timestamp);
+
+/***************************************************************************//**
+ * @brief Take an event from the queue (consumer side).
+ ******************************************************************************/
+static bool queue_pop(keypad_event_t *event);
+
+/***************************************************************************//**
+ * @brief Arm the repeat timer.
+ ******************************************************************************/
+static void repeat_start(uint8_t key, uint32_t timeout_ms);
+
+/***************************************************************************//**
+ * @brief Disarm the repeat timer.
+ ******************************************************************************/
+static void repeat_stop(void);
+
+/***************************************************************************//**
+ * @brief Repeat timer callback, only wakes up the application loop.
+ ******************************************************************************/
+static void on_repeat_timeout(sl_sleeptimer_timer_handle_t *handle,
+                              void *data);
+
+/*******************************************************************************
+ *********************  GLOBAL FUNCTION DECLARATION ****************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @brief Initialize the event queue.
+ ******************************************************************************/
+void keypad_events_init(const uint32_t *chords, uint8_t chord_count)
+{
+  debounce_ticks = sl_sleeptimer_ms_to_tick(KEYPAD_EVENTS_DEBOUNCE_MS);
+  chord_table = chords;
+  chord_table_size = chord_count;
+
+  // Make every key accept its first change immediately.
+  uint32_t now = sl_sleeptimer_get_tick_count();
+  for (uint8_t i = 0; i < KEYPAD_EVENTS_KEY_COUNT; i++) {
+    last_change[i] = now - debounce_ticks;
+  }
+}
+
+/***************************************************************************//**
+ * @brief Feed a keyscan report into the queue and scan the whole matrix.
+ ******************************************************************************/
+void keypad_events_on_scan(const uint8_t *matrix)
+{
+  // The report only holds the first column with a pressed key. It gives the
+  //   first press without delay, the scan timer finds the other keys.
+  keys_update(debounced_keys | matrix_to_keys(matrix));
+  if (!matrix_owned) {
+    sl_sleeptimer_restart_periodic_timer_ms(&scan_timer,
+                                            KEYPAD_EVENTS_SCAN_PERIOD_MS,
+                                            on_scan_timeout,
+                                            NULL,
+                                            0,
+                                            0);
+  }
+}
+
+/***************************************************************************//**
+ * @brief Get the next key event.
+ ******************************************************************************/
+bool keypad_events_get(keypad_event_t *event)
+{
+  if (queue_pop(event)) {
+    uint32_t mask = 1UL << event->key;
+
+    if (event->type == KEYPAD_EVENT_PRESS) {
+      held_keys |= mask;
+      for (uint8_t i = 0; i < chord_table_size; i++) {
+        if (held_keys == chord_table[i]) {
+          // The press completing a chord is reported as the chord itself.
+          event->type = KEYPAD_EVENT_CHORD;
+          event->key = i;
+          repeat_stop();
+          return true;
+        }
+      }
+      // Only the most recently pressed key repeats.
+      repeat_start(event->key, KEYPAD_EVENTS_REPEAT_DELAY_MS);
+    } else {
+      held_keys &= ~mask;
+      if (event->key == repeat_key) {
+        repeat_stop();
+      }
+    }
+    return true;
+  }
+
+  if (repeat_due) {
+    repeat_due = false;
+    if (repeat_key != NO_KEY) {
+      event->timestamp = sl_sleeptimer_get_tick_count();
+      event->type = KEYPAD_EVENT_REPEAT;
+      event->key = repeat_key;
+      repeat_start(repeat_key, KEYPAD_EVENTS_REPEAT_RATE_MS);
+      return true;
+    }
+  }
+  return false;
+}
+
+/***************************************************************************//**
+ * @brief Check whether keypad_events_get() has work to do.
+ ******************************************************************************/
+bool keypad_events_pending(void)
+{
+  return (queue_head != queue_tail) || repeat_due;
+}
+
+/***************************************************************************//**
+ * @brief Number of events lost because the queue was full.
+ ******************************************************************************/
+uint32_t keypad_events_dropped(void)
+{
+  return dropped_events;
+}
+
+/*******************************************************************************
+ *********************  STATIC FUNCTION DECLARATION ****************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @brief Convert the keyscan matrix into a key map.
+ ******************************************************************************/
+static uint32_t matrix_to_keys(const uint8_t *matrix)
+{
+  uint32_t keys = 0;
+  uint8_t column;
+
+  for (uint8_t i = 0; i < SL_KEYSCAN_DRIVER_COLUMN_NUMBER; i++) {
+#if (SL_KEYSCAN_DRIVER_SINGLEPRESS) // When the SinglePress feature is enabled
+    column = i;
+#else
+    // The returned column number contains a fix offset error.
+    column = (i == 0) ? (SL_KEYSCAN_DRIVER_COLUMN_NUMBER - 1) : (i - 1);
+#endif
+    keys |= (uint32_t)(matrix[i] & ROW_MASK)
+            << (column * SL_KEYSCAN_DRIVER_ROW_NUMBER);
+  }
+  return keys;
+}
+
+/***************************************************************************//**
+ * @brief Read every key of the matrix through the GPIO.
+ ******************************************************************************/
+static uint32_t matrix_read(void)
+{
+  uint32_t keys = 0;
+
+  for (uint8_t column = 0; column < SL_KEYSCAN_DRIVER_COLUMN_NUMBER;
+       column++) {
+    GPIO_PinOutClear(column_pins[column].port, column_pins[column].pin);
+    sl_udelay_wait(KEYPAD_EVENTS_SETTLE_US);
+    // A pressed key pulls its row low
+    for (uint8_t row = 0; row < SL_KEYSCAN_DRIVER_ROW_NUMBER; row++) {
+      if (GPIO_PinInGet(row_pins[row].port, row_pins[row].pin) == 0) {
+        keys |= KEYPAD_EVENTS_KEY_MASK(row, column);
+      }
+    }
+    GPIO_PinOutSet(column_pins[column].port, column_pins[column].pin);
+  }
+  return keys;
+}
+
+/***************************************************************************//**
+ * @brief Take the column pins from the keyscan peripheral.
+ ******************************************************************************/
+static void matrix_acquire(void)
+{
+  sl_keyscan_driver_stop_scan();
+
+  // Without the route, the pins follow the GPIO. The columns are open
+  //   drain so that two keys of a row in different columns cannot short
+  //   two driven outputs.
+  keyscan_route = GPIO->KEYSCANROUTE.ROUTEEN;
+  for (uint8_t column = 0; column < SL_KEYSCAN_DRIVER_COLUMN_NUMBER;
+       column++) {
+    column_modes[column] = GPIO_PinModeGet(column_pins[column].port,
+                                           column_pins[column].pin);
+    GPIO_PinModeSet(column_pins[column].port, column_pins[column].pin,
+                    gpioModeWiredAnd, 1);
+  }
+  GPIO->KEYSCANROUTE.ROUTEEN = 0;
+  matrix_owned = true;
+}
+
+/***************************************************************************//**
+ * @brief Give the column pins back to the keyscan peripheral.
+ ******************************************************************************/
+static void matrix_release(void)
+{
+  for (uint8_t column = 0; column < SL_KEYSCAN_DRIVER_COLUMN_NUMBER;
+       column++) {
+    GPIO_PinModeSet(column_pins[column].port, column_pins[column].pin,
+                    column_modes[column], 0);
+  }
+  GPIO->KEYSCANROUTE.ROUTEEN = keyscan_route;
+  matrix_owned = false;
+
+  // Back to waiting in EM2 for the next key press.
+  sl_keyscan_driver_start_scan();
+}
+
+/***************************************************************************//**
+ * @brief Turn a key map into press and release events.
+ ******************************************************************************/
+static void keys_update(uint32_t keys)
+{
+  uint32_t now = sl_sleeptimer_get_tick_count();
+  uint32_t changed = keys ^ debounced_keys;
+  uint8_t key;
+
+  // A change within the debounce time of the previous one is left for a
+  //   later scan: the scan timer reads the matrix again until the map
+  //   settles, so no press or release is lost.
+  while (changed != 0) {
+    key = (uint8_t)__CLZ(__RBIT(changed));
+    changed &= changed - 1;
+    if ((now - last_change[key]) < debounce_ticks) {
+      continue;
+    }
+    last_change[key] = now;
+    debounced_keys ^= 1UL << key;
+    queue_push((debounced_keys & (1UL << key)) ? KEYPAD_EVENT_PRESS
+               : KEYPAD_EVENT_RELEASE,
+               key, now);
+  }
+}
+
+/***************************************************************************//**
+ * @brief Scan timer callback, reads the matrix while a key is held.
+ ******************************************************************************/
+static void on_scan_timeout(sl_sleeptimer_timer_handle_t *handle,
+                            void *data)
+{
+  uint32_t keys;
+
+  (void)data;
+  if (!matrix_owned) {
+    matrix_acquire();
+  }
+  keys = matrix_read();
+  keys_update(keys);
+
+  // Stop once every key is up and every release was accepted.
+  if ((keys == 0) && (debounced_keys == 0)) {
+    sl_sleeptimer_stop_timer(handle);
+    matrix_release();
+  }
+}
+
+/***************************************************************************//**
+ * @brief Put an event in the queue (producer side).
+ ******************************************************************************/
+static void queue_push(uint8_t type, uint8_t key, uint32_t timestamp)
+{
+  uint32_t head = queue_head;
+
+  if ((head - queue_tail) >= KEYPAD_EVENTS_QUEUE_SIZE) {
+    dropped_events++;
+    return;
+  }
+  queue[head & QUEUE_MASK].timestamp = timestamp;
+  queue[head & QUEUE_MASK].type = type;
+  queue[head & QUEUE_MASK].key = key;
+  // Publish the entry only after it is completely written.
+  __DMB();
+  queue_head = head + 1;
+}
+
+/***************************************************************************//**
+ * @brief Take an event from the queue (consumer side).
+ ******************************************************************************/
+static bool queue_pop(keypad_event_t *event)
+{
+  uint32_t tail = queue_tail;
+
+  if (tail == queue_head) {
+    return false;
+  }
+  __DMB();
+  *event = queue[tail & QUEUE_MASK];
+  // Release the slot only after it is completely read.
+  __DMB();
+  queue_tail = tail + 1;
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief Arm the repeat timer.
+ ******************************************************************************/
+static void repeat_start(uint8_t key, uint32_t timeout_ms)
+{
+  repeat_key = key;
+  repeat_due = false;
+  sl_sleeptimer_restart_timer_ms(&repeat_timer,
+                                 timeout_ms,
+                                 on_repeat_timeout,
+                                 NULL,
+                                 0,
+                                 0);
+}
+
+/***************************************************************************//**
+ * @brief Disarm the repeat timer.
+ ******************************************************************************/
+static void repeat_stop(void)
+{
+  repeat_key = NO_KEY;
+  repeat_due = false;
+  sl_sleeptimer_stop_timer(&repeat_timer);
+}
+
+/***************************************************************************//**
+ * @brief Repeat timer callback, only wakes up the application loop.
+ ******************************************************************************/
+static void on_repeat_timeout(sl_sleeptimer_timer_handle_t *handle,
+                              void *data)
+{
+  (void)handle;
+  (void)data;
+  repeat_due = true;
+}
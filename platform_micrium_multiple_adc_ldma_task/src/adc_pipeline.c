@@ -0,0 +1,156 @@
+/***************************************************************************//**
+ * @file adc_pipeline.c
+ * @brief ADC sample block pool and pipeline instrumentation
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include "adc_pipeline.h"
+#include "em_device.h"
+
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+#if (ADC_BLOCK_COUNT & (ADC_BLOCK_COUNT - 1))
+#error "ADC_BLOCK_COUNT must be a power of two"
+#endif
+
+#define FREE_MASK   (ADC_BLOCK_COUNT - 1)
+
+/*******************************************************************************
+ ***************************  LOCAL VARIABLES   ********************************
+ ******************************************************************************/
+
+static adc_block_t blocks[ADC_BLOCK_COUNT];
+
+// Free list. The print task returns blocks at free_head through
+// adc_pool_release(), the LDMA callback takes them at free_tail through
+// adc_pool_get(). Each side writes only its own index, so the callback never
+// waits for the task. The indices count blocks since start and only their low
+// bits select a slot, so free_head - free_tail is the number of free blocks.
+static adc_block_t *free_list[ADC_BLOCK_COUNT];
+static volatile uint32_t free_head;
+static volatile uint32_t free_tail;
+
+// Timestamp frequency, for the conversion to microseconds.
+static CPU_TS_TMR_FREQ ts_freq;
+
+/*******************************************************************************
+ **************************   GLOBAL FUNCTIONS   *******************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Put every block of the pool in the free list.
+ ******************************************************************************/
+void adc_pool_init(void)
+{
+  RTOS_ERR err;
+
+  for (uint32_t i = 0; i < ADC_BLOCK_COUNT; i++)
+  {
+    free_list[i] = &blocks[i];
+  }
+  free_tail = 0;
+  free_head = ADC_BLOCK_COUNT;
+
+  ts_freq = CPU_TS_TmrFreqGet(&err);
+  EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
+}
+
+/***************************************************************************//**
+ * Take a free block from the pool.
+ ******************************************************************************/
+adc_block_t *adc_pool_get(void)
+{
+  uint32_t tail = free_tail;
+  adc_block_t *block;
+
+  if (tail == free_head) {
+    return NULL;
+  }
+  __DMB();
+  block = free_list[tail & FREE_MASK];
+  // The task may refill this slot as soon as it sees the new tail.
+  __DMB();
+  free_tail = tail + 1;
+  return block;
+}
+
+/***************************************************************************//**
+ * Return a block to the pool.
+ ******************************************************************************/
+void adc_pool_release(adc_block_t *block)
+{
+  uint32_t head = free_head;
+
+  // The list holds every block, so it can never overflow.
+  free_list[head & FREE_MASK] = block;
+  // The LDMA callback may take the block as soon as it sees the new head.
+  __DMB();
+  free_head = head + 1;
+}
+
+/***************************************************************************//**
+ * Record the start of processing of a block by a stage.
+ ******************************************************************************/
+CPU_TS adc_stage_begin(adc_stage_stats_t *stats, CPU_TS posted)
+{
+  CPU_TS start = OS_TS_GET();
+
+  stats->latency = (uint32_t)(start - posted);
+  if (stats->latency > stats->latency_max) {
+    stats->latency_max = stats->latency;
+  }
+  return start;
+}
+
+/***************************************************************************//**
+ * Record the end of processing of a block by a stage.
+ ******************************************************************************/
+void adc_stage_end(adc_stage_stats_t *stats, CPU_TS start)
+{
+  stats->busy += (uint32_t)(OS_TS_GET() - start);
+  stats->blocks++;
+}
+
+/***************************************************************************//**
+ * Convert a duration in timestamp ticks to microseconds.
+ ******************************************************************************/
+uint32_t adc_ts_to_us(uint32_t ticks)
+{
+  if (ts_freq == 0) {
+    return 0;
+  }
+  return (uint32_t)(((uint64_t)ticks * 1000000u) / ts_freq);
+}
@@ -0,0 +1,128 @@
+/***************************************************************************//**
+ * @file adc_pipeline.h
+ * @brief ADC sample block pool and pipeline instrumentation
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef ADC_PIPELINE_H_
+#define ADC_PIPELINE_H_
+
+#include <stdint.h>
+#include "os.h"
+
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+// Number of ADCs sampled into each block.
+#define ADC_CHANNEL_COUNT     (2)
+
+// Samples per ADC in one block. Larger blocks mean fewer kernel calls per
+// sample.
+#ifndef ADC_BLOCK_SAMPLES
+#define ADC_BLOCK_SAMPLES     (4)
+#endif
+
+// Number of blocks in the pool, must be a power of two.
+#ifndef ADC_BLOCK_COUNT
+#define ADC_BLOCK_COUNT       (4)
+#endif
+
+/*******************************************************************************
+ *******************************   STRUCTS   ***********************************
+ ******************************************************************************/
+
+// One block of samples. It is filled by the LDMA and then handed from stage to
+// stage by pointer until the last stage returns it to the pool.
+typedef struct {
+  uint32_t data[ADC_CHANNEL_COUNT][ADC_BLOCK_SAMPLES]; // samples, then mV
+  uint32_t sequence;                                   // block number
+  CPU_TS filled;                                       // LDMA completion time
+} adc_block_t;
+
+// Statistics of one pipeline stage, in timestamp ticks. Each stage only
+// updates its own statistics; the free-running counters can be read from any
+// task and differenced over a reporting window.
+typedef struct {
+  uint32_t blocks;        // blocks processed
+  uint32_t busy;          // time spent processing, wraps
+  uint32_t latency;       // last time from post to start of processing
+  uint32_t latency_max;   // longest time from post to start of processing
+} adc_stage_stats_t;
+
+/*******************************************************************************
+ **************************   GLOBAL FUNCTIONS   *******************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Put every block of the pool in the free list.
+ ******************************************************************************/
+void adc_pool_init(void);
+
+/***************************************************************************//**
+ * Take a free block from the pool.
+ *
+ * Only called by the producer (LDMA interrupt).
+ *
+ * @return The block or NULL if all blocks are in use.
+ ******************************************************************************/
+adc_block_t *adc_pool_get(void);
+
+/***************************************************************************//**
+ * Return a block to the pool.
+ *
+ * Only called by the last stage of the pipeline.
+ ******************************************************************************/
+void adc_pool_release(adc_block_t *block);
+
+/***************************************************************************//**
+ * Record the start of processing of a block by a stage.
+ *
+ * @param[in] stats Statistics of the stage.
+ * @param[in] posted Time the block was posted to the stage.
+ *
+ * @return Start time, to pass to adc_stage_end().
+ ******************************************************************************/
+CPU_TS adc_stage_begin(adc_stage_stats_t *stats, CPU_TS posted);
+
+/***************************************************************************//**
+ * Record the end of processing of a block by a stage.
+ ******************************************************************************/
+void adc_stage_end(adc_stage_stats_t *stats, CPU_TS start);
+
+/***************************************************************************//**
+ * Convert a duration in timestamp ticks to microseconds.
+ ******************************************************************************/
+uint32_t adc_ts_to_us(uint32_t ticks);
+
+#endif /* ADC_PIPELINE_H_ */
@@ -51,88 +51,127 @@
  ******************************************************************************/
 #define ADC_FREQ          (4000000)
 
-// Change this to increase or decrease number of samples.
-#define ADC_BUFFER_SIZE   4
-
 // Change this to set how many samples get sent at once
 #define ADC_DVL           (1)
 
+// Bits of fill_done, one per ADC.
+#define ADC0_DONE         (1u << 0)
+#define ADC1_DONE         (1u << 1)
+#define ADC_ALL_DONE      (ADC0_DONE | ADC1_DONE)
+
 /*******************************************************************************
  ***************************  LOCAL VARIABLES   ********************************
  ******************************************************************************/
 
-// Buffer for ADC single conversion
-static uint32_t adcBuffer1[ADC_BUFFER_SIZE];
-static uint32_t adcBuffer0[ADC_BUFFER_SIZE];
-
 static LDMA_TransferCfg_t ADC0Transfer =
   (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_PERIPHERAL(
     ldmaPeripheralSignal_ADC0_SINGLE);
 
-static LDMA_Descriptor_t ADC0_MemLoop =
+// The destination is set to the block being filled when the transfer starts.
+static LDMA_Descriptor_t ADC0_Block =
   LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(ADC0->SINGLEDATA),
-                                   &adcBuffer0[0],
-                                   ADC_BUFFER_SIZE,
+                                   NULL,
+                                   ADC_BLOCK_SAMPLES,
                                    0);
 
 static LDMA_TransferCfg_t ADC1Transfer =
   (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_PERIPHERAL(
     ldmaPeripheralSignal_ADC1_SINGLE);
 
-static LDMA_Descriptor_t ADC1_MemLoop =
+static LDMA_Descriptor_t ADC1_Block =
   LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(ADC1->SINGLEDATA),
-                                   &adcBuffer1[0],
-                                   ADC_BUFFER_SIZE,
+                                   NULL,
+                                   ADC_BLOCK_SAMPLES,
                                    0);
 
 static unsigned int DMA_ADC0_CH = 0;
 static unsigned int DMA_ADC1_CH = 1;
 
-extern OS_SEM sem_adc0;
-extern OS_SEM sem_adc1;
+// Block being filled by the LDMA and the ADCs that have completed it.
+static adc_block_t *fill_block;
+static uint32_t fill_done;
+static uint32_t fill_sequence;
+
+// Blocks dropped because the pool was empty, and time spent in the interrupt.
+static volatile uint32_t dma_overruns;
+static adc_stage_stats_t dma_stats;
+
+extern OS_Q q_adc_raw;
 
 /*******************************************************************************
  **************************    LOCAL FUNCTIONS   *******************************
  ******************************************************************************/
 
+static bool dma_adc_callback(unsigned int channel,
+                             unsigned int sequenceNo,
+                             void *userParam);
+
 /***************************************************************************//**
- *  DMA channel 0 callback function.
+ *  Start filling a block with both ADCs.
  ******************************************************************************/
-static bool dma_adc0_callback(unsigned int channel,
-                              unsigned int sequenceNo,
-                              void *userParam)
+static void dma_start(adc_block_t *block)
 {
-  (void)channel;
-  (void)sequenceNo;
-  (void)userParam;
+  fill_block = block;
+  ADC0_Block.xfer.dstAddr = (uint32_t)&block->data[0][0];
+  ADC1_Block.xfer.dstAddr = (uint32_t)&block->data[1][0];
 
-  RTOS_ERR err;
-
-  OSSemPost(&sem_adc0,
-            OS_OPT_POST_ALL,
-            &err);
-  EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
-
-  return false;
+  DMADRV_LdmaStartTransfer(DMA_ADC0_CH,
+                           &ADC0Transfer,
+                           &ADC0_Block,
+                           dma_adc_callback,
+                           (void *)ADC0_DONE);
+  DMADRV_LdmaStartTransfer(DMA_ADC1_CH,
+                           &ADC1Transfer,
+                           &ADC1_Block,
+                           dma_adc_callback,
+                           (void *)ADC1_DONE);
 }
 
 /***************************************************************************//**
- *  DMA channel 1 callback function.
+ *  DMA callback function of both channels.
+ *
+ *  Once both ADCs have filled their part of the block, the block is posted to
+ *  the first task by pointer and the LDMA starts on a free block. The ADC FIFOs
+ *  hold the samples converted in between.
  ******************************************************************************/
-static bool dma_adc1_callback(unsigned int channel,
-                              unsigned int sequenceNo,
-                              void *userParam)
+static bool dma_adc_callback(unsigned int channel,
+                             unsigned int sequenceNo,
+                             void *userParam)
 {
   (void)channel;
   (void)sequenceNo;
-  (void)userParam;
 
   RTOS_ERR err;
+  CPU_TS start;
+  adc_block_t *next;
 
-  OSSemPost(&sem_adc1,
-            OS_OPT_POST_ALL,
+  fill_done |= (uint32_t)userParam;
+  if (fill_done != ADC_ALL_DONE) {
+    return false;
+  }
+  fill_done = 0;
+
+  start = OS_TS_GET();
+  fill_block->sequence = fill_sequence++;
+  fill_block->filled = start;
+
+  next = adc_pool_get();
+  if (next == NULL) {
+    // Every block is still in the pipeline: drop this one and refill it.
+    // The consumers see the gap in the sequence numbers.
+    dma_overruns++;
+    next = fill_block;
+  } else {
+    OSQPost(&q_adc_raw,
+            fill_block,
+            sizeof(adc_block_t),
+            OS_OPT_POST_FIFO,
             &err);
-  EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
+    EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
+  }
+  dma_start(next);
+
+  adc_stage_end(&dma_stats, start);
 
   return false;
 }
@@ -220,9 +259,9 @@ void adc_init(void)
  * Initialize DMADRV
  *
  * The LDMA is configured to start reading data from the ADC0 and ADC1 FIFO,
- * one sample from each FIFO. The samples are then stored in their individual
- * buffers. Currently it is configured to store 4 such samples and then print
- * them before overwriting the individual buffers in memory.
+ * one sample from each FIFO. The samples are stored directly in a block of the
+ * pool, ADC_BLOCK_SAMPLES per ADC, and every full block is handed over to
+ * task 1 without copying.
  ******************************************************************************/
 void dma_init(void)
 {
@@ -234,7 +273,9 @@ void dma_init(void)
     return;
   }
 
-  ADC0_MemLoop.xfer.decLoopCnt = true;
+  // One block per transfer, the next block is chosen by the callback.
+  ADC0_Block.xfer.link = 0;
+  ADC1_Block.xfer.link = 0;
 
   ecode = DMADRV_AllocateChannel(&DMA_ADC0_CH, NULL);
   if (ecode != ECODE_EMDRV_DMADRV_OK) {
@@ -246,35 +287,8 @@ void dma_init(void)
     return;
   }
 
-  // Initialize LDMA transfers
-  DMADRV_LdmaStartTransfer(DMA_ADC0_CH,
-                           &ADC0Transfer,
-                           &ADC0_MemLoop,
-                           dma_adc0_callback,
-                           NULL);
-  DMADRV_LdmaStartTransfer(DMA_ADC1_CH,
-                           &ADC1Transfer,
-                           &ADC1_MemLoop,
-                           dma_adc1_callback,
-                           NULL);
-}
-
-/***************************************************************************//**
- * Initialize DMA transfers
- ******************************************************************************/
-void dma_tx(void)
-{
-  // Initialize LDMA transfers
-  DMADRV_LdmaStartTransfer(DMA_ADC0_CH,
-                           &ADC0Transfer,
-                           &ADC0_MemLoop,
-                           dma_adc0_callback,
-                           NULL);
-  DMADRV_LdmaStartTransfer(DMA_ADC1_CH,
-                           &ADC1Transfer,
-                           &ADC1_MemLoop,
-                           dma_adc1_callback,
-                           NULL);
+  adc_pool_init();
+  dma_start(adc_pool_get());
 }
 
 /***************************************************************************//**
@@ -300,17 +314,17 @@ void gpio_init(void)
 }
 
 /***************************************************************************//**
- * Wrapper function to access array
+ * Number of blocks dropped because no free block was available.
  ******************************************************************************/
-uint32_t *get_adc_data1(void)
+uint32_t get_dma_overruns(void)
 {
-  return (&adcBuffer1[0]);
+  return dma_overruns;
 }
 
 /***************************************************************************//**
- * Wrapper function to access array
+ * Statistics of the LDMA interrupt stage.
  ******************************************************************************/
-uint32_t *get_adc_data0(void)
+const adc_stage_stats_t *get_dma_stats(void)
 {
-  return (&adcBuffer0[0]);
+  return &dma_stats;
 }
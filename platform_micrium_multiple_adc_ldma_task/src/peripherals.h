@@ -38,6 +38,7 @@
 #define PERIPHERALS_H_
 
 #include <stdint.h>
+#include "adc_pipeline.h"
 
 /***************************************************************************//**
  * Initialize ADC
@@ -53,9 +54,9 @@ void adc_init(void);
  * Initialize LDMA
  *
  * The LDMA is configured to start reading data from the ADC0 and ADC1 FIFO,
- * one sample from each FIFO. The samples are then stored in their individual
- * buffers. Currently it is configured to store 4 such samples and then print
- * them before overwriting the individual buffers in memory.
+ * one sample from each FIFO. The samples are stored directly in a block of the
+ * pool, ADC_BLOCK_SAMPLES per ADC, and every full block is handed over to
+ * task 1 without copying.
  ******************************************************************************/
 void dma_init(void);
 
@@ -67,18 +68,13 @@ void dma_init(void);
 void gpio_init(void);
 
 /***************************************************************************//**
- * Initialize LDMA transfers
+ * Number of blocks dropped because no free block was available.
  ******************************************************************************/
-void dma_tx(void);
+uint32_t get_dma_overruns(void);
 
 /***************************************************************************//**
- * Wrapper function to access array
+ * Statistics of the LDMA interrupt stage.
  ******************************************************************************/
-uint32_t *get_adc_data1(void);
-
-/***************************************************************************//**
- * Wrapper function to access array
- ******************************************************************************/
-uint32_t *get_adc_data0(void);
+const adc_stage_stats_t *get_dma_stats(void);
 
 #endif /* PERIPHERALS_H_ */
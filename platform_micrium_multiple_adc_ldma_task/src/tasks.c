@@ -36,6 +36,7 @@
 
 #include "tasks.h"
 #include "peripherals.h"
+#include "adc_pipeline.h"
 #include "os.h"
 #include <stdio.h>
 #include "em_ldma.h"
@@ -53,6 +54,11 @@
 #define TASK_PRIO            (20)
 #endif
 
+// Print the pipeline statistics every ADC_STATS_BLOCKS blocks.
+#ifndef ADC_STATS_BLOCKS
+#define ADC_STATS_BLOCKS     (4)
+#endif
+
 /*******************************************************************************
  ***************************  LOCAL VARIABLES   ********************************
  ******************************************************************************/
@@ -64,24 +70,31 @@ static OS_TCB tcb_task2;
 static CPU_STK stack[TASK_STACK_SIZE];
 static CPU_STK stack_task2[TASK_STACK_SIZE];
 
-// Create Mutex, Semaphores, event flags to use in tasks.
-static OS_MUTEX mutex_vol_val;
-OS_SEM sem_adc0;
-OS_SEM sem_adc1;
-static OS_FLAG_GRP array_full_flag;
+// Message queues of the pipeline. Blocks are passed by pointer: the LDMA
+// interrupt posts full blocks to q_adc_raw, task 1 converts them in place and
+// posts them to q_adc_volt, task 2 prints them and returns them to the pool.
+OS_Q q_adc_raw;
+static OS_Q q_adc_volt;
 
-// Arrays to store voltage values.
-uint32_t arr_voltage0[4];
-uint32_t arr_voltage1[4];
-int val = 0;
+// Statistics of the two tasks, and the latency from the end of the LDMA
+// transfer to the end of task 2.
+static adc_stage_stats_t convert_stats;
+static adc_stage_stats_t print_stats;
+static uint32_t total_latency;
+static uint32_t total_latency_max;
+
+/*******************************************************************************
+ *********************   LOCAL FUNCTION PROTOTYPES   ***************************
+ ******************************************************************************/
+
+static void print_pipeline_stats(void);
 
 /*******************************************************************************
  **************************   GLOBAL FUNCTIONS   *******************************
  ******************************************************************************/
 
 /***************************************************************************//**
- * Initialize task 1 and other RTOS objects such as semaphores, mutex and
- * event flags.
+ * Initialize task 1 and the message queues of the pipeline.
  ******************************************************************************/
 void task_init(void)
 {
@@ -103,49 +116,39 @@ void task_init(void)
                &err);
   EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
 
-  // Create Mutex
-  OSMutexCreate(&mutex_vol_val,
-                "MutexVolVal",
-                &err);
-  EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
-
-  // Create Semaphore
-  OSSemCreate(&sem_adc0,
-              "SemADC0",
-              0,
-              &err);
-  EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
-
-  // Create Semaphore
-  OSSemCreate(&sem_adc1,
-              "SemADC1",
-              0,
-              &err);
+  // Create the queues. Each one can hold every block of the pool, so a post
+  // never fails.
+  OSQCreate(&q_adc_raw,
+            "QueueADCRaw",
+            ADC_BLOCK_COUNT,
+            &err);
   EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
 
-  // Create Event Flag
-  OSFlagCreate(&array_full_flag,
-               "RawValArr_Full",
-               0,
-               &err);
+  OSQCreate(&q_adc_volt,
+            "QueueADCVolt",
+            ADC_BLOCK_COUNT,
+            &err);
   EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
 }
 
 /***************************************************************************//**
  * Task 1 function
  *
- * It waits for the individual buffers to be filled with samples. Once that is
- * done, the function converts the samples to voltage values and stores them in
- * a different set of buffers.
+ * It waits for blocks of samples filled by the LDMA. Each block is converted
+ * to voltage values in place and passed on to task 2.
  *
- * The GPIO triggers ADC0 and ADC1. Once all the data samples are written to
- * individual buffers by LDMA, the LDMA interrupt occurs and triggers task 1.
+ * The GPIO triggers ADC0 and ADC1. Once both ADCs have filled a block, the
+ * LDMA interrupt posts a pointer to the block to task 1.
  ******************************************************************************/
 void consumer_task_1(void *p_arg)
 {
   (void)p_arg;
 
   RTOS_ERR err;
+  adc_block_t *block;
+  OS_MSG_SIZE size;
+  CPU_TS posted;
+  CPU_TS start;
 
   // Create Task
   OSTaskCreate(&tcb_task2,
@@ -168,58 +171,34 @@ void consumer_task_1(void *p_arg)
   gpio_init();
   dma_init();
 
-  uint32_t *data1 = NULL;
-  uint32_t *data0 = NULL;
-  data1 = get_adc_data1();
-  data0 = get_adc_data0();
-
   while (1)
   {
-    /*Wait for Semaphores to pend. Until then the task is blocked.
-     * Sempahores are posted when enough values are sampled from the ADC
-     */
-    OSSemPend(&sem_adc0,
-              0,
-              OS_OPT_PEND_BLOCKING,
-              (CPU_TS *)0,
-              &err);
+    // Wait for a full block. Until then the task is blocked.
+    block = (adc_block_t *)OSQPend(&q_adc_raw,
+                                   0,
+                                   OS_OPT_PEND_BLOCKING,
+                                   &size,
+                                   &posted,
+                                   &err);
     EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
 
-    OSSemPend(&sem_adc1,
-              0,
-              OS_OPT_PEND_BLOCKING,
-              (CPU_TS *)0,
-              &err);
-    EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
+    start = adc_stage_begin(&convert_stats, posted);
 
-    // Pend mutex to lock access to arr_voltage arrays
-    OSMutexPend(&mutex_vol_val,
-                0,
-                OS_OPT_PEND_BLOCKING,
-                (CPU_TS *)0,
-                &err);
-    EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
-
-    for (uint8_t i = 0; i < 4; i++)
+    for (uint32_t ch = 0; ch < ADC_CHANNEL_COUNT; ch++)
     {
-      arr_voltage0[i] = ((data0[i] * 2500) / 4095);
-
-      arr_voltage1[i] = ((data1[i] * 2500) / 4095);
+      for (uint32_t i = 0; i < ADC_BLOCK_SAMPLES; i++)
+      {
+        block->data[ch][i] = ((block->data[ch][i] * 2500) / 4095);
+      }
     }
 
-    dma_tx();
-
-    // Post flag indicating that voltages have been calculated
-    OSFlagPost(&array_full_flag,
-               0x01,
-               OS_OPT_POST_FLAG_SET,
-               &err);
-    EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
+    adc_stage_end(&convert_stats, start);
 
-    // post mutex to unlock access to arr_voltage array
-    OSMutexPost(&mutex_vol_val,
-                OS_OPT_POST_NONE,
-                &err);
+    OSQPost(&q_adc_volt,
+            block,
+            size,
+            OS_OPT_POST_FIFO,
+            &err);
     EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
   }
 }
@@ -227,51 +206,128 @@ void consumer_task_1(void *p_arg)
 /***************************************************************************//**
  * Task 2 function
  *
- * It waits for task 1 to be completed before executing. Once all the samples
- * are converted into voltage by task 1, they will be printed on the serial
- * terminal or device console in this function.
+ * It waits for blocks converted by task 1, prints the voltages on the serial
+ * terminal or device console and returns the blocks to the pool. The pipeline
+ * statistics are printed every ADC_STATS_BLOCKS blocks.
  ******************************************************************************/
 void consumer_task_2(void *p_arg)
 {
   (void)p_arg;
 
   RTOS_ERR err;
+  adc_block_t *block;
+  OS_MSG_SIZE size;
+  CPU_TS posted;
+  CPU_TS start;
+  uint32_t latency;
 
   while (1)
   {
-    if (OSFlagPend(&array_full_flag,
-                   0x01,
-                   0,
-                   OS_OPT_PEND_FLAG_SET_ANY,
-                   (CPU_TS *)0,
-                   &err) == 0x01) {
-      // Clear event flag
-      OSFlagPost(&array_full_flag,
-                 0x01,
-                 OS_OPT_POST_FLAG_CLR,
-                 &err);
-      EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
-
-      OSMutexPend(&mutex_vol_val,
-                  0,
-                  OS_OPT_PEND_BLOCKING,
-                  (CPU_TS *)0,
-                  &err);
-      EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
-
-      // print voltages
-      printf(" Voltages\n\r");
-      printf("Ch10    Ch11 \n\r");
-
-      for (uint8_t i = 0; i < 4; i++)
-      {
-        printf("%lumV    %lumV\n\r", arr_voltage0[i], arr_voltage1[i]);
-      }
+    block = (adc_block_t *)OSQPend(&q_adc_volt,
+                                   0,
+                                   OS_OPT_PEND_BLOCKING,
+                                   &size,
+                                   &posted,
+                                   &err);
+    EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
 
-      OSMutexPost(&mutex_vol_val,
-                  OS_OPT_POST_NONE,
-                  &err);
-      EFM_ASSERT((RTOS_ERR_CODE_GET(err) == RTOS_ERR_NONE));
+    start = adc_stage_begin(&print_stats, posted);
+
+    // print voltages
+    printf(" Voltages (block %lu)\n\r", block->sequence);
+    printf("Ch10    Ch11 \n\r");
+
+    for (uint32_t i = 0; i < ADC_BLOCK_SAMPLES; i++)
+    {
+      printf("%lumV    %lumV\n\r", block->data[0][i], block->data[1][i]);
     }
+
+    latency = (uint32_t)(OS_TS_GET() - block->filled);
+    adc_pool_release(block);
+    adc_stage_end(&print_stats, start);
+
+    total_latency = latency;
+    if (latency > total_latency_max) {
+      total_latency_max = latency;
+    }
+
+    if ((print_stats.blocks % ADC_STATS_BLOCKS) == 0) {
+      print_pipeline_stats();
+    }
+  }
+}
+
+/*******************************************************************************
+ **************************    LOCAL FUNCTIONS   *******************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Share of a window spent busy, in 0.1 %.
+ ******************************************************************************/
+static uint32_t load_permille(uint32_t busy, uint32_t window)
+{
+  return (uint32_t)(((uint64_t)busy * 1000u) / window);
+}
+
+/***************************************************************************//**
+ * Print one line of task statistics.
+ ******************************************************************************/
+static void print_stage(const char *name,
+                        const adc_stage_stats_t *stats,
+                        uint32_t busy,
+                        uint32_t window)
+{
+  uint32_t load = load_permille(busy, window);
+
+  printf("%s latency %lu us (max %lu us), load %lu.%lu %%\n\r",
+         name,
+         adc_ts_to_us(stats->latency),
+         adc_ts_to_us(stats->latency_max),
+         load / 10,
+         load % 10);
+}
+
+/***************************************************************************//**
+ * Print the pipeline statistics.
+ *
+ * Latencies are measured from the OS timestamp of each post to the start of
+ * processing. Loads are computed over the time since the previous report,
+ * which must stay below the timestamp wrap period (2^32 timestamp ticks).
+ ******************************************************************************/
+static void print_pipeline_stats(void)
+{
+  static CPU_TS window_start;
+  static uint32_t dma_busy;
+  static uint32_t convert_busy;
+  static uint32_t print_busy;
+
+  const adc_stage_stats_t *dma_stats = get_dma_stats();
+  CPU_TS now = OS_TS_GET();
+  uint32_t window = (uint32_t)(now - window_start);
+  uint32_t load;
+
+  if ((window_start != 0) && (window != 0)) {
+    printf("Pipeline, %lu blocks of %u samples per ADC, %lu dropped\n\r",
+           print_stats.blocks,
+           ADC_BLOCK_SAMPLES,
+           get_dma_overruns());
+    load = load_permille(dma_stats->busy - dma_busy, window);
+    printf(" LDMA IRQ: load %lu.%lu %%\n\r", load / 10, load % 10);
+    print_stage(" Task 1:  ",
+                &convert_stats,
+                convert_stats.busy - convert_busy,
+                window);
+    print_stage(" Task 2:  ",
+                &print_stats,
+                print_stats.busy - print_busy,
+                window);
+    printf(" LDMA to end of task 2: %lu us (max %lu us)\n\r",
+           adc_ts_to_us(total_latency),
+           adc_ts_to_us(total_latency_max));
   }
+
+  window_start = now;
+  dma_busy = dma_stats->busy;
+  convert_busy = convert_stats.busy;
+  print_busy = print_stats.busy;
 }
@@ -38,29 +38,27 @@
 #define TASKS_H_
 
 /***************************************************************************//**
- * Initialize task 1 and other RTOS objects such as semaphores, mutex and
- * event flags.
+ * Initialize task 1 and the message queues of the pipeline.
  ******************************************************************************/
 void task_init(void);
 
 /***************************************************************************//**
  * Task 1 function
  *
- * It waits for the individual buffers to be filled with samples. Once that is
- * done, the function converts the samples to voltage values and stores them in
- * a different set of buffers.
+ * It waits for blocks of samples filled by the LDMA. Each block is converted
+ * to voltage values in place and passed on to task 2.
  *
- * The GPIO triggers ADC0 and ADC1. Once all the data samples are written to
- * individual buffers by LDMA, the LDMA interrupt occurs and triggers task 1.
+ * The GPIO triggers ADC0 and ADC1. Once both ADCs have filled a block, the
+ * LDMA interrupt posts a pointer to the block to task 1.
  ******************************************************************************/
 void consumer_task_1(void *p_arg);
 
 /***************************************************************************//**
  * Task 2 function
  *
- * It waits for task 1 to be completed before executing. Once all the samples
- * are converted into voltage by task 1, they will be printed on the serial
- * terminal or device console in this function.
+ * It waits for blocks converted by task 1, prints the voltages on the serial
+ * terminal or device console and returns the blocks to the pool. The pipeline
+ * statistics are printed every ADC_STATS_BLOCKS blocks.
  ******************************************************************************/
 void consumer_task_2(void *p_arg);
 
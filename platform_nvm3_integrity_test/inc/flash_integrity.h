@@ -0,0 +1,124 @@
+/***************************************************************************//**
+ * @file flash_integrity.h
+ * @brief Incremental per-page CRC check of the main flash
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef FLASH_INTEGRITY_H
+#define FLASH_INTEGRITY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "nvm3.h"
+
+// NVM3 keys: a header describing the checked region, the verify position,
+//   then the page CRCs, FLASH_INTEGRITY_CRCS_PER_OBJECT per object.
+#ifndef FLASH_INTEGRITY_NVM3_KEY_BASE
+#define FLASH_INTEGRITY_NVM3_KEY_BASE   0x100
+#endif
+#define FLASH_INTEGRITY_KEY_HEADER      (FLASH_INTEGRITY_NVM3_KEY_BASE)
+#define FLASH_INTEGRITY_KEY_CURSOR      (FLASH_INTEGRITY_NVM3_KEY_BASE + 1)
+#define FLASH_INTEGRITY_KEY_CRC         (FLASH_INTEGRITY_NVM3_KEY_BASE + 0x10)
+
+#ifndef FLASH_INTEGRITY_CRCS_PER_OBJECT
+#define FLASH_INTEGRITY_CRCS_PER_OBJECT 32
+#endif
+
+// Pages verified at boot, before the application starts.
+#ifndef FLASH_INTEGRITY_BOOT_PAGES
+#define FLASH_INTEGRITY_BOOT_PAGES      8
+#endif
+
+// LDMA channel feeding the GPCRC
+#ifndef FLASH_INTEGRITY_LDMA_CHANNEL
+#define FLASH_INTEGRITY_LDMA_CHANNEL    0
+#endif
+
+#define FLASH_INTEGRITY_NO_FAILURE      0xFFFFFFFFUL
+
+/***************************************************************************//**
+ * @brief Set up the GPCRC and LDMA and look for a stored baseline.
+ *
+ * @param[in] handle NVM3 instance holding the page CRCs, already open.
+ * @param[in] base, end Checked region, page aligned.
+ *
+ * @return True if the stored page CRCs describe this region, false if
+ *         flash_integrity_baseline() must be called.
+ ******************************************************************************/
+bool flash_integrity_init(nvm3_Handle_t *handle, uint32_t base, uint32_t end);
+
+/***************************************************************************//**
+ * @brief Compute and store the CRC of every page of the region.
+ *
+ * This reads the whole region once, it is only needed on first use or when
+ *   the whole image was replaced.
+ ******************************************************************************/
+Ecode_t flash_integrity_baseline(void);
+
+/***************************************************************************//**
+ * @brief Recompute and store the CRC of one page after it was reprogrammed.
+ *
+ * If this page was the failure reported, it is cleared.
+ *
+ * @param[in] address Any address in the page.
+ ******************************************************************************/
+Ecode_t flash_integrity_page_update(uint32_t address);
+
+/***************************************************************************//**
+ * @brief Verify a bounded number of pages, waiting for each of them.
+ *
+ * Verification continues from where the previous call, on this or an earlier
+ *   boot, stopped, so successive boots cover the whole region.
+ *
+ * @param[in] pages Number of pages to verify.
+ *
+ * @return Address of the first failing page, see flash_integrity_failure().
+ ******************************************************************************/
+uint32_t flash_integrity_verify(uint32_t pages);
+
+/***************************************************************************//**
+ * @brief Verify pages in the background, call from the main loop.
+ *
+ * Each call collects the result of the page being checked, if the LDMA is
+ *   done with it, and starts the next one. It never waits.
+ ******************************************************************************/
+void flash_integrity_process(void);
+
+/***************************************************************************//**
+ * @brief Address of the lowest failing page found so far, or
+ *        FLASH_INTEGRITY_NO_FAILURE.
+ ******************************************************************************/
+uint32_t flash_integrity_failure(void);
+
+#endif // FLASH_INTEGRITY_H
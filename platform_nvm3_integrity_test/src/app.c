@@ -37,9 +37,6 @@
 #include "em_device.h"
 #include "em_chip.h"
 
-#include "em_cmu.h"
-#include "em_gpcrc.h"
-
 #include "nvm3.h"
 #include "nvm3_hal_flash.h"
 #include "nvm3_default.h"
@@ -52,6 +49,8 @@
 #include "sl_simple_button_instances.h"
 #include "sl_simple_button.h"
 
+#include "flash_integrity.h"
+
 #define led0_on()  sl_simple_led_turn_on(sl_led_led0.context)
 #define led0_off() sl_simple_led_turn_off(sl_led_led0.context)
 #ifdef SL_CATALOG_SIMPLE_LED_LED1_PRESENT
@@ -107,10 +106,11 @@ void fail(uint32_t code)
   }
 }
 
-void nvm3_init(uint32_t crc)
+void nvm3_init(void)
 {
   Ecode_t status;
   size_t numberOfObjects;
+  bool baseline;
 
   status = nvm3_open(&nvm3_handle, &nvm3_init_data);
   if (status != ECODE_NVM3_OK) {
@@ -118,9 +118,12 @@ void nvm3_init(uint32_t crc)
   }
   // Get the number of valid keys already in NVM3
   numberOfObjects = nvm3_countObjects(&nvm3_handle);
-  // Skip if we have initial keys. If not, generate objects and store
-  // persistently in NVM3 before proceeding.
-  if (numberOfObjects < 3) {
+  baseline = flash_integrity_init(&nvm3_handle,
+                                  (uint32_t)MAIN_FLASH_BASE,
+                                  (uint32_t)MAIN_FLASH_END);
+  // Skip if we have initial keys and page CRCs. If not, generate objects and
+  // store persistently in NVM3 before proceeding.
+  if ((numberOfObjects < 3) || !baseline) {
     // Wait for PB0 press
     while (sl_simple_button_get_state(&sl_button_btn0)
            == SL_SIMPLE_BUTTON_RELEASED)
@@ -134,18 +137,20 @@ void nvm3_init(uint32_t crc)
     nvm3_eraseAll(&nvm3_handle);
     nvm3_writeData(&nvm3_handle, 1, &keys[0], sizeof(uint32_t));
     nvm3_writeData(&nvm3_handle, 2, &keys[1], sizeof(uint32_t));
-    nvm3_writeData(&nvm3_handle, 3, &crc, sizeof(uint32_t));
+    // Store the CRC of every page of the program space
+    if (flash_integrity_baseline() != ECODE_NVM3_OK) {
+      fail(6);
+    }
   }
 }
 
-void nvm3_check(uint32_t crc)
+void nvm3_check(void)
 {
   Ecode_t status;
   size_t numberOfObjects;
   uint32_t objectType;
   uint32_t data1;
   uint32_t data2;
-  uint32_t stored_crc;
   size_t dataLen1;
   size_t dataLen2;
   status = nvm3_open(&nvm3_handle, &nvm3_init_data);
@@ -188,16 +193,6 @@ void nvm3_check(uint32_t crc)
     fail(3);
   }
 
-  nvm3_getObjectInfo(&nvm3_handle, 3, &objectType, &dataLen2);
-  if (objectType == NVM3_OBJECTTYPE_DATA) {
-    nvm3_readData(&nvm3_handle, 3, &stored_crc, dataLen2);
-  } else {
-    fail(2);
-  }
-  if (stored_crc != crc) {
-    fail(4);
-  }
-
   led1_on();
   nvm3_writeData(&nvm3_handle, 1, &data1, sizeof(uint32_t));
   nvm3_writeData(&nvm3_handle, 2, &data2, sizeof(uint32_t));
@@ -211,42 +206,18 @@ void nvm3_check(uint32_t crc)
   led1_off();
 }
 
-void initGpcrc(void)
-{
-  // Enable clocks required
-  CMU_ClockEnable(cmuClock_GPCRC, true);
-
-  // Declare init structs
-  GPCRC_Init_TypeDef init = GPCRC_INIT_DEFAULT;
-
-  init.initValue = 0xFFFFFFFF;  // Starting value in GPCRC_DATA
-  init.autoInit = true;     // Reset GPCRC_DATA to 0xFFFF_FFFF after every read
-  init.reverseBits = true;  // Reverse all bits of the incoming message
-
-  // Initialize GPCRC
-  GPCRC_Init(GPCRC, &init);
-
-  // Prepare GPCRC_DATA for inputs
-  GPCRC_Start(GPCRC);
-}
-
 /***************************************************************************//**
  * Initialize application.
  ******************************************************************************/
 void app_init(void)
 {
-  uint32_t *p_start = (uint32_t *)MAIN_FLASH_BASE;
-  uint32_t *p_end = (uint32_t *)MAIN_FLASH_END;
-  uint32_t crc;
+  nvm3_init();
 
-  initGpcrc();
-
-  for (uint32_t *i = p_start; i < p_end; i++)
-  {
-    GPCRC_InputU32(GPCRC, *i);
+  // Verify a bounded number of pages now, the others in the background
+  if (flash_integrity_verify(FLASH_INTEGRITY_BOOT_PAGES)
+      != FLASH_INTEGRITY_NO_FAILURE) {
+    fail(4);
   }
-  crc = GPCRC_DataReadBitReversed(GPCRC);
-  nvm3_init(crc);
 }
 
 /***************************************************************************//**
@@ -254,15 +225,12 @@ void app_init(void)
  ******************************************************************************/
 void app_process_action(void)
 {
-  uint32_t crc;
-  uint32_t *p_start = (uint32_t *)MAIN_FLASH_BASE;
-  uint32_t *p_end = (uint32_t *)MAIN_FLASH_END;
-
-  for (uint32_t *i = p_start; i < p_end; i++)
-  {
-    GPCRC_InputU32(GPCRC, *i);
+  // Check the result of the page verified since the last call, if the LDMA
+  // is done, and start the next one
+  flash_integrity_process();
+  if (flash_integrity_failure() != FLASH_INTEGRITY_NO_FAILURE) {
+    fail(4);
   }
-  crc = GPCRC_DataReadBitReversed(GPCRC);
-  nvm3_check(crc);
+  nvm3_check();
   sl_sleeptimer_delay_millisecond(100);
 }
@@ -0,0 +1,340 @@
+/***************************************************************************//**
+ * @file flash_integrity.c
+ * @brief Incremental per-page CRC check of the main flash
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_gpcrc.h"
+#include "em_ldma.h"
+
+#include "flash_integrity.h"
+
+#if ((FLASH_PAGE_SIZE / 4) > ((_LDMA_CH_CTRL_XFERCNT_MASK >> _LDMA_CH_CTRL_XFERCNT_SHIFT) + 1))
+#error "A flash page does not fit in one LDMA descriptor"
+#endif
+
+#define NO_PAGE 0xFFFFFFFFUL
+
+// Region described by the stored page CRCs
+typedef struct {
+  uint32_t base;
+  uint32_t pageCount;
+  uint32_t pageSize;
+} integrity_header_t;
+
+static nvm3_Handle_t *integrityHandle;
+static integrity_header_t region;
+
+// Next page to verify, and page whose CRC the LDMA is computing
+static uint32_t cursor = 0;
+static uint32_t pageInFlight = NO_PAGE;
+
+static uint32_t firstFailure = FLASH_INTEGRITY_NO_FAILURE;
+
+// WRI descriptor disabling the channel interrupt, then the page transfer
+static LDMA_Descriptor_t crcDesc[2];
+static LDMA_TransferCfg_t crcXferCfg;
+
+/***************************************************************************//**
+ * @brief Start feeding a page to the GPCRC.
+ ******************************************************************************/
+static void crc_start(uint32_t page)
+{
+  GPCRC_Start(GPCRC);
+
+  // As in the GPCRC blank check example, the first descriptor clears the
+  //   channel interrupt enabled by LDMA_StartTransfer(), the result is polled.
+  crcDesc[0] = (LDMA_Descriptor_t)
+               LDMA_DESCRIPTOR_LINKREL_WRITE((1 << FLASH_INTEGRITY_LDMA_CHANNEL),
+                                             &(LDMA->IEN_CLR), 1);
+  crcDesc[1] = (LDMA_Descriptor_t)
+               LDMA_DESCRIPTOR_SINGLE_M2M_WORD(region.base
+                                               + page * region.pageSize,
+                                               &(GPCRC->INPUTDATA),
+                                               region.pageSize >> 2);
+  crcDesc[1].xfer.dstInc = ldmaCtrlDstIncNone;
+
+  LDMA_StartTransfer(FLASH_INTEGRITY_LDMA_CHANNEL,
+                     (void *)&crcXferCfg,
+                     (void *)&crcDesc);
+}
+
+/***************************************************************************//**
+ * @brief Check whether the page transfer is done.
+ ******************************************************************************/
+static bool crc_busy(void)
+{
+  return !LDMA_TransferDone(FLASH_INTEGRITY_LDMA_CHANNEL);
+}
+
+/***************************************************************************//**
+ * @brief CRC of a page, waiting for the LDMA.
+ ******************************************************************************/
+static uint32_t page_crc(uint32_t page)
+{
+  crc_start(page);
+  while (crc_busy()) {
+  }
+  return GPCRC_DataReadBitReversed(GPCRC);
+}
+
+/***************************************************************************//**
+ * @brief Compare the CRC of a page with the stored one, recording a failure.
+ ******************************************************************************/
+static void page_check(uint32_t page, uint32_t crc)
+{
+  uint32_t stored;
+  uint32_t address = region.base + page * region.pageSize;
+
+  if ((nvm3_readPartialData(integrityHandle,
+                            FLASH_INTEGRITY_KEY_CRC
+                            + page / FLASH_INTEGRITY_CRCS_PER_OBJECT,
+                            &stored,
+                            (page % FLASH_INTEGRITY_CRCS_PER_OBJECT)
+                            * sizeof(uint32_t),
+                            sizeof(uint32_t)) != ECODE_NVM3_OK)
+      || (stored != crc)) {
+    if ((firstFailure == FLASH_INTEGRITY_NO_FAILURE)
+        || (address < firstFailure)) {
+      firstFailure = address;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief Move the cursor on, saving it when a pass over the region is done.
+ ******************************************************************************/
+static void cursor_advance(void)
+{
+  cursor++;
+  if (cursor >= region.pageCount) {
+    cursor = 0;
+    nvm3_writeData(integrityHandle, FLASH_INTEGRITY_KEY_CURSOR,
+                   &cursor, sizeof(cursor));
+  }
+}
+
+/***************************************************************************//**
+ * @brief Collect the result of the page in flight, waiting for it if needed.
+ ******************************************************************************/
+static void page_in_flight_finish(void)
+{
+  if (pageInFlight == NO_PAGE) {
+    return;
+  }
+  while (crc_busy()) {
+  }
+  page_check(pageInFlight, GPCRC_DataReadBitReversed(GPCRC));
+  pageInFlight = NO_PAGE;
+  cursor_advance();
+}
+
+/***************************************************************************//**
+ * @brief Set up the GPCRC and LDMA and look for a stored baseline.
+ ******************************************************************************/
+bool flash_integrity_init(nvm3_Handle_t *handle, uint32_t base, uint32_t end)
+{
+  integrity_header_t stored;
+  LDMA_Init_t ldmaInit = LDMA_INIT_DEFAULT;
+  GPCRC_Init_TypeDef init = GPCRC_INIT_DEFAULT;
+
+  integrityHandle = handle;
+  region.base = base;
+  region.pageCount = (end - base) / FLASH_PAGE_SIZE;
+  region.pageSize = FLASH_PAGE_SIZE;
+  cursor = 0;
+  pageInFlight = NO_PAGE;
+  firstFailure = FLASH_INTEGRITY_NO_FAILURE;
+
+  CMU_ClockEnable(cmuClock_GPCRC, true);
+  LDMA_Init(&ldmaInit);
+
+  // Same CRC as the whole-image check this replaces: IEEE 802.3, bit
+  //   reversed input
+  init.initValue = 0xFFFFFFFF;
+  init.reverseBits = true;
+  GPCRC_Init(GPCRC, &init);
+
+  // Memory to memory transfers, the GPCRC has no DMA request
+  crcXferCfg = (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_MEMORY();
+  crcXferCfg.ldmaDbgHalt = true;
+
+  if ((nvm3_readData(handle, FLASH_INTEGRITY_KEY_HEADER,
+                     &stored, sizeof(stored)) != ECODE_NVM3_OK)
+      || (stored.base != region.base)
+      || (stored.pageCount != region.pageCount)
+      || (stored.pageSize != region.pageSize)) {
+    return false;
+  }
+
+  if ((nvm3_readData(handle, FLASH_INTEGRITY_KEY_CURSOR,
+                     &cursor, sizeof(cursor)) != ECODE_NVM3_OK)
+      || (cursor >= region.pageCount)) {
+    cursor = 0;
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief Compute and store the CRC of every page of the region.
+ ******************************************************************************/
+Ecode_t flash_integrity_baseline(void)
+{
+  uint32_t crcs[FLASH_INTEGRITY_CRCS_PER_OBJECT];
+  uint32_t page = 0, count;
+  Ecode_t status;
+
+  page_in_flight_finish();
+
+  // The header goes last, so that an interrupted baseline is redone.
+  nvm3_deleteObject(integrityHandle, FLASH_INTEGRITY_KEY_HEADER);
+
+  while (page < region.pageCount) {
+    count = 0;
+    while ((count < FLASH_INTEGRITY_CRCS_PER_OBJECT)
+           && (page < region.pageCount)) {
+      crcs[count++] = page_crc(page++);
+    }
+    status = nvm3_writeData(integrityHandle,
+                            FLASH_INTEGRITY_KEY_CRC
+                            + (page - 1) / FLASH_INTEGRITY_CRCS_PER_OBJECT,
+                            crcs,
+                            count * sizeof(uint32_t));
+    if (status != ECODE_NVM3_OK) {
+      return status;
+    }
+  }
+
+  cursor = 0;
+  firstFailure = FLASH_INTEGRITY_NO_FAILURE;
+  status = nvm3_writeData(integrityHandle, FLASH_INTEGRITY_KEY_CURSOR,
+                          &cursor, sizeof(cursor));
+  if (status != ECODE_NVM3_OK) {
+    return status;
+  }
+  return nvm3_writeData(integrityHandle, FLASH_INTEGRITY_KEY_HEADER,
+                        &region, sizeof(region));
+}
+
+/***************************************************************************//**
+ * @brief Recompute and store the CRC of one page after it was reprogrammed.
+ ******************************************************************************/
+Ecode_t flash_integrity_page_update(uint32_t address)
+{
+  uint32_t crcs[FLASH_INTEGRITY_CRCS_PER_OBJECT];
+  uint32_t page = (address - region.base) / region.pageSize;
+  uint32_t key = FLASH_INTEGRITY_KEY_CRC
+                 + page / FLASH_INTEGRITY_CRCS_PER_OBJECT;
+  size_t length;
+  uint32_t type;
+  Ecode_t status;
+
+  if ((address < region.base) || (page >= region.pageCount)) {
+    return ECODE_NVM3_ERR_PARAMETER;
+  }
+  page_in_flight_finish();
+
+  // NVM3 objects are written whole, so the object is read, patched and
+  //   written back.
+  status = nvm3_getObjectInfo(integrityHandle, key, &type, &length);
+  if (status != ECODE_NVM3_OK) {
+    return status;
+  }
+  if (length > sizeof(crcs)) {
+    return ECODE_NVM3_ERR_READ_DATA_SIZE;
+  }
+  status = nvm3_readData(integrityHandle, key, crcs, length);
+  if (status != ECODE_NVM3_OK) {
+    return status;
+  }
+  crcs[page % FLASH_INTEGRITY_CRCS_PER_OBJECT] = page_crc(page);
+  status = nvm3_writeData(integrityHandle, key, crcs, length);
+  if (status != ECODE_NVM3_OK) {
+    return status;
+  }
+
+  // The page is good again. Other failing pages are found on the next pass.
+  if (firstFailure == region.base + page * region.pageSize) {
+    firstFailure = FLASH_INTEGRITY_NO_FAILURE;
+  }
+  return ECODE_NVM3_OK;
+}
+
+/***************************************************************************//**
+ * @brief Verify a bounded number of pages, waiting for each of them.
+ ******************************************************************************/
+uint32_t flash_integrity_verify(uint32_t pages)
+{
+  page_in_flight_finish();
+  if (region.pageCount == 0) {
+    return firstFailure;
+  }
+
+  while (pages-- > 0) {
+    page_check(cursor, page_crc(cursor));
+    cursor_advance();
+  }
+
+  // Let the next boot carry on from here.
+  nvm3_writeData(integrityHandle, FLASH_INTEGRITY_KEY_CURSOR,
+                 &cursor, sizeof(cursor));
+  return firstFailure;
+}
+
+/***************************************************************************//**
+ * @brief Verify pages in the background, call from the main loop.
+ ******************************************************************************/
+void flash_integrity_process(void)
+{
+  if (pageInFlight != NO_PAGE) {
+    if (crc_busy()) {
+      return;
+    }
+    page_in_flight_finish();
+  }
+
+  if (region.pageCount > 0) {
+    pageInFlight = cursor;
+    crc_start(cursor);
+  }
+}
+
+/***************************************************************************//**
+ * @brief Address of the lowest failing page found so far.
+ ******************************************************************************/
+uint32_t flash_integrity_failure(void)
+{
+  return firstFailure;
+}
@@ -0,0 +1,553 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host test of the per-page flash check with a simulated flash and NVM3
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ *******************************************************************************
+ *
+ * Runs ../src/flash_integrity.c against a simulated flash region of
+ * SIM_PAGES pages, a model of the LDMA feeding the GPCRC, and an NVM3 stub
+ * holding objects in RAM. The LDMA model takes LDMA_LATENCY polls of
+ * LDMA_TransferDone() to finish a page, and the NVM3 stub can fail its
+ * writes after a given count, as on a power loss. Every reboot calls
+ * flash_integrity_init() again, as nvm3_init() of app.c does.
+ *
+ * The scenarios check:
+ * - the first boot, without a baseline, then the baseline and a clean pass,
+ * - the boot page budget and the resume of verification on the next boot,
+ * - corrupted flash pages, reported as the lowest failing page, at boot and
+ *   in the background,
+ * - page CRCs in NVM3 that do not match, or are missing,
+ * - the repair paths: flash_integrity_page_update() after a page is
+ *   reprogrammed, and a new baseline after an interrupted one or a change of
+ *   the region,
+ * - flash_integrity_process() never waiting for the LDMA.
+ *
+ * Build:
+ *   cd tools
+ *   cc -O2 -Wall -Wextra -I../inc -Istub -o flash_integrity_test \
+ *      flash_integrity_test.c
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/flash_integrity.c"
+
+// Simulated flash region, not a multiple of the CRCs per NVM3 object
+#define SIM_FLASH_BASE    0x00008000UL
+#define SIM_PAGES         70
+#define SIM_FLASH_END     (SIM_FLASH_BASE + SIM_PAGES * FLASH_PAGE_SIZE)
+
+// Polls of LDMA_TransferDone() before a page is done
+#define LDMA_LATENCY      3
+
+#define NVM3_OBJECTS      16
+#define NVM3_OBJECT_SIZE  (FLASH_INTEGRITY_CRCS_PER_OBJECT * sizeof(uint32_t))
+#define NO_FAIL           0xFFFFFFFFUL
+
+#define PAGE_ADDRESS(page) (SIM_FLASH_BASE + (page) * FLASH_PAGE_SIZE)
+
+typedef struct {
+  bool used;
+  nvm3_ObjectKey_t key;
+  size_t length;
+  uint8_t data[NVM3_OBJECT_SIZE];
+} sim_object_t;
+
+LDMA_TypeDef sim_ldma;
+GPCRC_TypeDef sim_gpcrc;
+
+static uint8_t simFlash[SIM_PAGES * FLASH_PAGE_SIZE];
+
+// LDMA and GPCRC models
+static uint32_t crcInit;
+static uint32_t crcValue;
+static uint32_t ldmaPolls;
+static uint32_t ldmaPollsTotal;
+static uint32_t pagesRead[SIM_PAGES];
+
+// NVM3 stub, and writes left before they fail
+static nvm3_Handle_t simHandle;
+static sim_object_t objects[NVM3_OBJECTS];
+static uint32_t writesLeft = NO_FAIL;
+
+static uint32_t failures;
+
+/***************************************************************************//**
+ * Count a failure if a condition does not hold.
+ ******************************************************************************/
+#define CHECK(condition)                                         \
+  do {                                                           \
+    if (!(condition)) {                                          \
+      printf("  line %d: %s\n", __LINE__, #condition);           \
+      failures++;                                                \
+    }                                                            \
+  } while (0)
+
+// -----------------------------------------------------------------------------
+//                              GPCRC and LDMA
+// -----------------------------------------------------------------------------
+
+void GPCRC_Init(GPCRC_TypeDef *gpcrc, const GPCRC_Init_TypeDef *init)
+{
+  (void)gpcrc;
+  crcInit = init->initValue;
+}
+
+void GPCRC_Start(GPCRC_TypeDef *gpcrc)
+{
+  (void)gpcrc;
+  crcValue = crcInit;
+}
+
+/***************************************************************************//**
+ * IEEE 802.3 CRC of one word, bit reversed, least significant byte first.
+ ******************************************************************************/
+static void gpcrc_input(uint32_t word)
+{
+  crcValue ^= word;
+  for (int bit = 0; bit < 32; bit++) {
+    crcValue = (crcValue >> 1) ^ ((crcValue & 1) ? 0xEDB88320UL : 0);
+  }
+}
+
+uint32_t GPCRC_DataReadBitReversed(GPCRC_TypeDef *gpcrc)
+{
+  (void)gpcrc;
+  return crcValue;
+}
+
+void LDMA_Init(const LDMA_Init_t *init)
+{
+  (void)init;
+}
+
+/***************************************************************************//**
+ * Run the descriptors at once, the channel reports done after LDMA_LATENCY
+ * polls.
+ ******************************************************************************/
+void LDMA_StartTransfer(int ch, const LDMA_TransferCfg_t *transfer,
+                        const LDMA_Descriptor_t *descriptor)
+{
+  uint32_t offset, word;
+
+  (void)transfer;
+  while (true) {
+    if (descriptor->xfer.structType == ldmaCtrlStructTypeWrite) {
+      *(volatile uint32_t *)descriptor->xfer.dstAddr = descriptor->xfer.srcAddr;
+    } else {
+      offset = descriptor->xfer.srcAddr - SIM_FLASH_BASE;
+      if ((descriptor->xfer.srcAddr < SIM_FLASH_BASE)
+          || (offset + (descriptor->xfer.xferCnt + 1) * 4 > sizeof(simFlash))
+          || (descriptor->xfer.dstAddr != &GPCRC->INPUTDATA)
+          || (descriptor->xfer.dstInc != ldmaCtrlDstIncNone)) {
+        printf("  bad transfer from 0x%08lx\n",
+               (unsigned long)descriptor->xfer.srcAddr);
+        failures++;
+        return;
+      }
+      pagesRead[offset / FLASH_PAGE_SIZE]++;
+      for (uint32_t i = 0; i <= descriptor->xfer.xferCnt; i++) {
+        memcpy(&word, &simFlash[offset + i * 4], sizeof(word));
+        gpcrc_input(word);
+      }
+    }
+    if (!descriptor->xfer.link) {
+      break;
+    }
+    descriptor += descriptor->xfer.linkJump;
+  }
+  CHECK(LDMA->IEN_CLR == (1UL << ch));
+  ldmaPolls = 0;
+}
+
+bool LDMA_TransferDone(int ch)
+{
+  (void)ch;
+  ldmaPollsTotal++;
+  return ++ldmaPolls > LDMA_LATENCY;
+}
+
+// -----------------------------------------------------------------------------
+//                                   NVM3
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ * Stored object of a key, or NULL.
+ ******************************************************************************/
+static sim_object_t *object_find(nvm3_ObjectKey_t key)
+{
+  for (int i = 0; i < NVM3_OBJECTS; i++) {
+    if (objects[i].used && (objects[i].key == key)) {
+      return &objects[i];
+    }
+  }
+  return NULL;
+}
+
+Ecode_t nvm3_readData(nvm3_Handle_t *h, nvm3_ObjectKey_t key, void *value,
+                      size_t len)
+{
+  return nvm3_readPartialData(h, key, value, 0, len);
+}
+
+Ecode_t nvm3_readPartialData(nvm3_Handle_t *h, nvm3_ObjectKey_t key,
+                             void *value, size_t ofs, size_t len)
+{
+  sim_object_t *object = object_find(key);
+
+  CHECK(h == &simHandle);
+  if (object == NULL) {
+    return ECODE_NVM3_ERR_KEY_NOT_FOUND;
+  }
+  if (ofs + len > object->length) {
+    return ECODE_NVM3_ERR_READ_DATA_SIZE;
+  }
+  memcpy(value, &object->data[ofs], len);
+  return ECODE_NVM3_OK;
+}
+
+Ecode_t nvm3_writeData(nvm3_Handle_t *h, nvm3_ObjectKey_t key,
+                       const void *value, size_t len)
+{
+  sim_object_t *object = object_find(key);
+
+  CHECK(h == &simHandle);
+  if (len > NVM3_OBJECT_SIZE) {
+    return ECODE_NVM3_ERR_PARAMETER;
+  }
+  if (writesLeft != NO_FAIL) {
+    if (writesLeft == 0) {
+      return ECODE_NVM3_ERR_WRITE_FAILED;
+    }
+    writesLeft--;
+  }
+  for (int i = 0; (object == NULL) && (i < NVM3_OBJECTS); i++) {
+    if (!objects[i].used) {
+      object = &objects[i];
+    }
+  }
+  if (object == NULL) {
+    return ECODE_NVM3_ERR_WRITE_FAILED;
+  }
+  object->used = true;
+  object->key = key;
+  object->length = len;
+  memcpy(object->data, value, len);
+  return ECODE_NVM3_OK;
+}
+
+Ecode_t nvm3_deleteObject(nvm3_Handle_t *h, nvm3_ObjectKey_t key)
+{
+  sim_object_t *object = object_find(key);
+
+  CHECK(h == &simHandle);
+  if (object == NULL) {
+    return ECODE_NVM3_ERR_KEY_NOT_FOUND;
+  }
+  object->used = false;
+  return ECODE_NVM3_OK;
+}
+
+Ecode_t nvm3_getObjectInfo(nvm3_Handle_t *h, nvm3_ObjectKey_t key,
+                           uint32_t *type, size_t *len)
+{
+  sim_object_t *object = object_find(key);
+
+  CHECK(h == &simHandle);
+  if (object == NULL) {
+    return ECODE_NVM3_ERR_KEY_NOT_FOUND;
+  }
+  *type = NVM3_OBJECTTYPE_DATA;
+  *len = object->length;
+  return ECODE_NVM3_OK;
+}
+
+// -----------------------------------------------------------------------------
+//                                 Scenarios
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ * Restart as on a reset: the statics of the module are set again by init.
+ ******************************************************************************/
+static bool reboot(uint32_t end)
+{
+  memset(pagesRead, 0, sizeof(pagesRead));
+  return flash_integrity_init(&simHandle, SIM_FLASH_BASE, end);
+}
+
+/***************************************************************************//**
+ * Verify cursor stored in NVM3.
+ ******************************************************************************/
+static uint32_t stored_cursor(void)
+{
+  uint32_t value = NO_FAIL;
+
+  nvm3_readData(&simHandle, FLASH_INTEGRITY_KEY_CURSOR, &value, sizeof(value));
+  return value;
+}
+
+/***************************************************************************//**
+ * Check that every page was read exactly a number of times.
+ ******************************************************************************/
+static bool all_pages_read(uint32_t times)
+{
+  for (uint32_t page = 0; page < SIM_PAGES; page++) {
+    if (pagesRead[page] != times) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * Fill the flash with a pseudo-random image.
+ ******************************************************************************/
+static void image_write(uint32_t seed)
+{
+  for (uint32_t i = 0; i < sizeof(simFlash); i++) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    simFlash[i] = (uint8_t)seed;
+  }
+}
+
+static void first_boot(void)
+{
+  CHECK(!reboot(SIM_FLASH_END));
+  CHECK(flash_integrity_baseline() == ECODE_NVM3_OK);
+  CHECK(all_pages_read(1));
+  // One CRC object per 32 pages, the last one partial
+  CHECK(object_find(FLASH_INTEGRITY_KEY_CRC + 2) != NULL);
+  CHECK(object_find(FLASH_INTEGRITY_KEY_CRC + 2)->length
+        == (SIM_PAGES - 64) * sizeof(uint32_t));
+  CHECK(object_find(FLASH_INTEGRITY_KEY_CRC + 3) == NULL);
+
+  CHECK(reboot(SIM_FLASH_END));
+  CHECK(flash_integrity_verify(SIM_PAGES) == FLASH_INTEGRITY_NO_FAILURE);
+  CHECK(all_pages_read(1));
+}
+
+static void boot_budget(void)
+{
+  uint32_t start = stored_cursor();
+  uint32_t covered[SIM_PAGES] = { 0 };
+  uint32_t boots = (SIM_PAGES + FLASH_INTEGRITY_BOOT_PAGES - 1)
+                   / FLASH_INTEGRITY_BOOT_PAGES;
+
+  for (uint32_t boot = 0; boot < boots; boot++) {
+    CHECK(reboot(SIM_FLASH_END));
+    CHECK(flash_integrity_verify(FLASH_INTEGRITY_BOOT_PAGES)
+          == FLASH_INTEGRITY_NO_FAILURE);
+    for (uint32_t page = 0; page < SIM_PAGES; page++) {
+      covered[page] += pagesRead[page];
+    }
+    // Only the budget is read, from where the previous boot stopped
+    CHECK(pagesRead[(start + boot * FLASH_INTEGRITY_BOOT_PAGES) % SIM_PAGES]
+          == 1);
+    CHECK(stored_cursor()
+          == (start + (boot + 1) * FLASH_INTEGRITY_BOOT_PAGES) % SIM_PAGES);
+  }
+  for (uint32_t page = 0; page < SIM_PAGES; page++) {
+    CHECK(covered[page] >= 1);
+  }
+}
+
+static void corrupted_pages(void)
+{
+  uint32_t calls;
+
+  // A bit flip at the end of a page, the lowest failing page is reported
+  //   even when the cursor reaches a higher one first
+  simFlash[PAGE_ADDRESS(65) - SIM_FLASH_BASE + 17] ^= 0x10;
+  simFlash[PAGE_ADDRESS(41) - SIM_FLASH_BASE - 1] ^= 0x01;
+  CHECK(reboot(SIM_FLASH_END));
+  flash_integrity_verify((SIM_PAGES - stored_cursor() + 60) % SIM_PAGES);
+  CHECK(reboot(SIM_FLASH_END));
+  CHECK(stored_cursor() == 60);
+  CHECK(flash_integrity_verify(SIM_PAGES) == PAGE_ADDRESS(40));
+  CHECK(flash_integrity_failure() == PAGE_ADDRESS(40));
+
+  // Same in the background
+  CHECK(reboot(SIM_FLASH_END));
+  for (calls = 0; !all_pages_read(1) && (calls < 10 * SIM_PAGES); calls++) {
+    flash_integrity_process();
+  }
+  flash_integrity_verify(0);
+  CHECK(flash_integrity_failure() == PAGE_ADDRESS(40));
+
+  simFlash[PAGE_ADDRESS(65) - SIM_FLASH_BASE + 17] ^= 0x10;
+  simFlash[PAGE_ADDRESS(41) - SIM_FLASH_BASE - 1] ^= 0x01;
+  CHECK(reboot(SIM_FLASH_END));
+  CHECK(flash_integrity_verify(SIM_PAGES) == FLASH_INTEGRITY_NO_FAILURE);
+}
+
+static void crc_mismatch(void)
+{
+  sim_object_t *object = object_find(FLASH_INTEGRITY_KEY_CRC + 1);
+  sim_object_t saved;
+
+  // Stored CRC of page 33 altered
+  object->data[1 * sizeof(uint32_t) + 2] ^= 0x80;
+  CHECK(reboot(SIM_FLASH_END));
+  CHECK(flash_integrity_verify(SIM_PAGES) == PAGE_ADDRESS(33));
+  object->data[1 * sizeof(uint32_t) + 2] ^= 0x80;
+
+  // CRCs of pages 64 and up missing
+  object = object_find(FLASH_INTEGRITY_KEY_CRC + 2);
+  saved = *object;
+  object->used = false;
+  CHECK(reboot(SIM_FLASH_END));
+  CHECK(flash_integrity_verify(SIM_PAGES) == PAGE_ADDRESS(64));
+  CHECK(flash_integrity_page_update(PAGE_ADDRESS(64))
+        == ECODE_NVM3_ERR_KEY_NOT_FOUND);
+  *object = saved;
+
+  // CRC object shorter than its pages
+  object = object_find(FLASH_INTEGRITY_KEY_CRC);
+  object->length -= sizeof(uint32_t);
+  CHECK(reboot(SIM_FLASH_END));
+  CHECK(flash_integrity_verify(SIM_PAGES) == PAGE_ADDRESS(31));
+  object->length += sizeof(uint32_t);
+
+  CHECK(reboot(SIM_FLASH_END));
+  CHECK(flash_integrity_verify(SIM_PAGES) == FLASH_INTEGRITY_NO_FAILURE);
+}
+
+static void repair(void)
+{
+  // The application reprograms page 50, then updates its CRC
+  memset(&simFlash[PAGE_ADDRESS(50) - SIM_FLASH_BASE + 100], 0x5A, 300);
+  CHECK(reboot(SIM_FLASH_END));
+  memset(pagesRead, 0, sizeof(pagesRead));
+  CHECK(flash_integrity_page_update(PAGE_ADDRESS(50) + 1234)
+        == ECODE_NVM3_OK);
+  CHECK(pagesRead[50] == 1);
+  CHECK(flash_integrity_verify(SIM_PAGES) == FLASH_INTEGRITY_NO_FAILURE);
+
+  // Reprogrammed without an update, found, then repaired
+  memset(&simFlash[PAGE_ADDRESS(12) - SIM_FLASH_BASE], 0xA5, 8);
+  CHECK(flash_integrity_verify(SIM_PAGES) == PAGE_ADDRESS(12));
+  CHECK(flash_integrity_page_update(PAGE_ADDRESS(12)) == ECODE_NVM3_OK);
+  CHECK(flash_integrity_failure() == FLASH_INTEGRITY_NO_FAILURE);
+  CHECK(flash_integrity_verify(SIM_PAGES) == FLASH_INTEGRITY_NO_FAILURE);
+
+  // Outside the region
+  CHECK(flash_integrity_page_update(SIM_FLASH_BASE - 4)
+        == ECODE_NVM3_ERR_PARAMETER);
+  CHECK(flash_integrity_page_update(SIM_FLASH_END)
+        == ECODE_NVM3_ERR_PARAMETER);
+
+  // A new image: the baseline is taken again
+  image_write(0x1234567);
+  CHECK(reboot(SIM_FLASH_END));
+  CHECK(flash_integrity_verify(SIM_PAGES) == PAGE_ADDRESS(0));
+  CHECK(flash_integrity_baseline() == ECODE_NVM3_OK);
+  CHECK(flash_integrity_failure() == FLASH_INTEGRITY_NO_FAILURE);
+  CHECK(flash_integrity_verify(SIM_PAGES) == FLASH_INTEGRITY_NO_FAILURE);
+}
+
+static void interrupted_baseline(void)
+{
+  // Power lost after the first CRC object
+  image_write(0xBEEF);
+  CHECK(reboot(SIM_FLASH_END));
+  writesLeft = 1;
+  CHECK(flash_integrity_baseline() != ECODE_NVM3_OK);
+  writesLeft = NO_FAIL;
+
+  // Without the header the next boot takes the baseline again
+  CHECK(!reboot(SIM_FLASH_END));
+  CHECK(flash_integrity_baseline() == ECODE_NVM3_OK);
+  CHECK(reboot(SIM_FLASH_END));
+  CHECK(flash_integrity_verify(SIM_PAGES) == FLASH_INTEGRITY_NO_FAILURE);
+
+  // A smaller region, as after a change of the NVM3 size
+  CHECK(!reboot(SIM_FLASH_END - 2 * FLASH_PAGE_SIZE));
+  CHECK(flash_integrity_baseline() == ECODE_NVM3_OK);
+  CHECK(reboot(SIM_FLASH_END - 2 * FLASH_PAGE_SIZE));
+  CHECK(flash_integrity_verify(SIM_PAGES) == FLASH_INTEGRITY_NO_FAILURE);
+  CHECK(pagesRead[SIM_PAGES - 1] == 0);
+  CHECK(!reboot(SIM_FLASH_END));
+  CHECK(flash_integrity_baseline() == ECODE_NVM3_OK);
+}
+
+static void background(void)
+{
+  uint32_t polls, maxPolls = 0, calls;
+
+  CHECK(reboot(SIM_FLASH_END));
+  for (calls = 0; calls < (LDMA_LATENCY + 1) * SIM_PAGES * 2; calls++) {
+    polls = ldmaPollsTotal;
+    flash_integrity_process();
+    polls = ldmaPollsTotal - polls;
+    maxPolls = (polls > maxPolls) ? polls : maxPolls;
+  }
+  // At most one poll to see the page is done, one more in the collection
+  CHECK(maxPolls <= 2);
+  for (uint32_t page = 0; page < SIM_PAGES; page++) {
+    CHECK(pagesRead[page] >= 1);
+  }
+  CHECK(flash_integrity_failure() == FLASH_INTEGRITY_NO_FAILURE);
+  // A pass over the region saves the cursor
+  CHECK(stored_cursor() == 0);
+}
+
+int main(void)
+{
+  static const struct {
+    const char *name;
+    void (*run)(void);
+  } scenarios[] = {
+    { "first boot and baseline", first_boot },
+    { "boot page budget and resume", boot_budget },
+    { "corrupted flash pages", corrupted_pages },
+    { "page CRC mismatch in NVM3", crc_mismatch },
+    { "page update and new image", repair },
+    { "interrupted baseline", interrupted_baseline },
+    { "background verification", background },
+  };
+
+  image_write(0xC0FFEE);
+  for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+    uint32_t before = failures;
+
+    scenarios[s].run();
+    printf("%-30s %s\n", scenarios[s].name,
+           (failures == before) ? "ok" : "FAIL");
+  }
+
+  printf("\n%s\n", failures ? "FAIL" : "PASS");
+  return failures ? 1 : 0;
+}
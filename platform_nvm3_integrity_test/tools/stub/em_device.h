@@ -0,0 +1,62 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for em_device.h, the flash, LDMA and GPCRC used
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef EM_DEVICE_H
+#define EM_DEVICE_H
+
+#include <stdint.h>
+
+// Flash addresses are those of the device, the LDMA model of
+//   ../flash_integrity_test.c reads them from the simulated flash.
+#define FLASH_PAGE_SIZE               8192
+
+#define _LDMA_CH_CTRL_XFERCNT_SHIFT   4
+#define _LDMA_CH_CTRL_XFERCNT_MASK    0x7FF0UL
+
+typedef struct {
+  volatile uint32_t IEN_CLR;
+} LDMA_TypeDef;
+
+typedef struct {
+  volatile uint32_t INPUTDATA;
+} GPCRC_TypeDef;
+
+extern LDMA_TypeDef sim_ldma;
+extern GPCRC_TypeDef sim_gpcrc;
+#define LDMA                          (&sim_ldma)
+#define GPCRC                         (&sim_gpcrc)
+
+#endif // EM_DEVICE_H
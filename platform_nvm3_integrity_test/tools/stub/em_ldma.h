@@ -0,0 +1,102 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for em_ldma.h, modeled by ../flash_integrity_test.c
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef EM_LDMA_H
+#define EM_LDMA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+  int dummy;
+} LDMA_Init_t;
+
+typedef struct {
+  bool ldmaDbgHalt;
+} LDMA_TransferCfg_t;
+
+typedef enum {
+  ldmaCtrlDstIncOne,
+  ldmaCtrlDstIncNone
+} LDMA_CtrlDstInc_t;
+
+typedef enum {
+  ldmaCtrlStructTypeXfer,
+  ldmaCtrlStructTypeWrite
+} LDMA_CtrlStructType_t;
+
+// Only the fields the model follows; the link is counted in descriptors
+typedef struct {
+  struct {
+    LDMA_CtrlStructType_t structType;
+    uint32_t srcAddr;               ///< flash address, or value written
+    volatile void *dstAddr;
+    uint32_t xferCnt;               ///< words to transfer, less one
+    LDMA_CtrlDstInc_t dstInc;
+    int32_t linkJump;               ///< next descriptor, relative
+    bool link;
+  } xfer;
+} LDMA_Descriptor_t;
+
+#define LDMA_INIT_DEFAULT             { 0 }
+#define LDMA_TRANSFER_CFG_MEMORY()    { false }
+#define LDMA_DESCRIPTOR_LINKREL_WRITE(value, address, linkjmp) \
+  {                                                            \
+    .xfer = {                                                  \
+      .structType = ldmaCtrlStructTypeWrite,                   \
+      .srcAddr = (value),                                      \
+      .dstAddr = (address),                                    \
+      .linkJump = (linkjmp),                                   \
+      .link = true,                                            \
+    }                                                          \
+  }
+#define LDMA_DESCRIPTOR_SINGLE_M2M_WORD(src, dest, count) \
+  {                                                       \
+    .xfer = {                                             \
+      .structType = ldmaCtrlStructTypeXfer,               \
+      .srcAddr = (src),                                   \
+      .dstAddr = (dest),                                  \
+      .xferCnt = (count) - 1,                             \
+      .dstInc = ldmaCtrlDstIncOne,                        \
+    }                                                     \
+  }
+
+void LDMA_Init(const LDMA_Init_t *init);
+void LDMA_StartTransfer(int ch, const LDMA_TransferCfg_t *transfer,
+                        const LDMA_Descriptor_t *descriptor);
+bool LDMA_TransferDone(int ch);
+
+#endif // EM_LDMA_H
@@ -0,0 +1,69 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for nvm3.h, objects held in RAM by the test
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef NVM3_H
+#define NVM3_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t Ecode_t;
+
+#define ECODE_NVM3_OK                   0
+#define ECODE_NVM3_ERR_KEY_NOT_FOUND    0xF000E01AUL
+#define ECODE_NVM3_ERR_PARAMETER        0xF000E02AUL
+#define ECODE_NVM3_ERR_READ_DATA_SIZE   0xF000E02CUL
+#define ECODE_NVM3_ERR_WRITE_FAILED     0xF000E02DUL
+
+#define NVM3_OBJECTTYPE_DATA            0
+
+typedef uint32_t nvm3_ObjectKey_t;
+
+typedef struct {
+  int dummy;
+} nvm3_Handle_t;
+
+Ecode_t nvm3_readData(nvm3_Handle_t *h, nvm3_ObjectKey_t key, void *value,
+                      size_t len);
+Ecode_t nvm3_readPartialData(nvm3_Handle_t *h, nvm3_ObjectKey_t key,
+                             void *value, size_t ofs, size_t len);
+Ecode_t nvm3_writeData(nvm3_Handle_t *h, nvm3_ObjectKey_t key,
+                       const void *value, size_t len);
+Ecode_t nvm3_deleteObject(nvm3_Handle_t *h, nvm3_ObjectKey_t key);
+Ecode_t nvm3_getObjectInfo(nvm3_Handle_t *h, nvm3_ObjectKey_t key,
+                           uint32_t *type, size_t *len);
+
+#endif // NVM3_H
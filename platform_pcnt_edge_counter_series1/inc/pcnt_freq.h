@@ -0,0 +1,152 @@
+/***************************************************************************//**
+ * @file pcnt_freq.h
+ *
+ * @brief Frequency and speed measurement from pulse counter snapshots
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef PCNT_FREQ_H
+#define PCNT_FREQ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * The measurement works on snapshots taken at the end of each gate window:
+ * the overflow-extended count, the clock tick the count was taken at and the
+ * clock tick of the last counted edge, as captured by hardware. Between two
+ * snapshots the rate is either
+ *
+ *  - gated: counts / gate time, good to one count, or
+ *  - reciprocal: counts / time between the last edges, good to one tick,
+ *
+ * whichever is finer. The gate window is stretched until the resolution
+ * reaches the target or the window reaches its maximum.
+ */
+
+/***************************************************************************//**
+ * Measurement settings.
+ ******************************************************************************/
+typedef struct {
+  uint32_t clockHz;           // Tick rate of the gate and edge timestamps
+  uint32_t targetPpm;         // Resolution to hold
+  uint32_t minWindowTicks;    // Shortest gate window
+  uint32_t maxWindowTicks;    // Longest gate window, no count in it: stopped
+  uint32_t reciprocalMaxHz;   // Highest count rate the edge capture follows
+  uint32_t countsPerRev;      // Counts per revolution for speed, 0 for none
+} pcnt_freq_config_t;
+
+/***************************************************************************//**
+ * Snapshot taken at the end of a gate window.
+ ******************************************************************************/
+typedef struct {
+  int32_t count;              // Overflow-extended count
+  uint32_t gateTime;          // Tick the count was taken at
+  uint32_t edgeTime;          // Tick of the edge that gave the count
+} pcnt_freq_snapshot_t;
+
+typedef enum {
+  pcntFreqGated,
+  pcntFreqReciprocal,
+  pcntFreqStopped
+} pcnt_freq_method_t;
+
+/***************************************************************************//**
+ * Measurement result.
+ ******************************************************************************/
+typedef struct {
+  pcnt_freq_method_t method;
+  uint32_t frequencyMilliHz;  // Count rate
+  int32_t speedMilliRpm;      // Negative when counting down
+  uint32_t resolutionPpm;     // One count or one tick of the measurement
+  uint32_t durationTicks;     // Time the measurement took
+  int32_t count;              // Count at the end of the measurement
+} pcnt_freq_result_t;
+
+/***************************************************************************//**
+ * Measurement state.
+ ******************************************************************************/
+typedef struct {
+  pcnt_freq_config_t config;
+  pcnt_freq_snapshot_t start; // Start of the measurement in progress
+  bool started;
+  bool edgeValid;             // start.edgeTime is the time of start.count
+  bool reciprocal;            // Count rate low enough for the edge capture
+  uint32_t windowTicks;       // Length of the next gate window
+} pcnt_freq_t;
+
+/***************************************************************************//**
+ * Initialize a measurement. The first snapshot only starts it.
+ ******************************************************************************/
+void pcnt_freq_init(pcnt_freq_t *freq, const pcnt_freq_config_t *config);
+
+/***************************************************************************//**
+ * Extend a hardware count to 32 bits.
+ *
+ * @param[in] wraps Overflows minus underflows handled so far.
+ * @param[in] hwCount Counter value.
+ * @param[in] top Counter top value, the counter counts modulo top + 1.
+ * @param[in] overflowPending Overflow flag read after the counter value and
+ *   not handled yet.
+ * @param[in] underflowPending Same for underflow.
+ *
+ * A pending flag only counts when the counter value is in the lower half
+ * (overflow) or upper half (underflow) of its range, i.e. when the counter
+ * value was read after the wrap.
+ ******************************************************************************/
+int32_t pcnt_freq_extend(int32_t wraps,
+                         uint32_t hwCount,
+                         uint32_t top,
+                         bool overflowPending,
+                         bool underflowPending);
+
+/***************************************************************************//**
+ * Process the snapshot taken at the end of a gate window.
+ *
+ * @return True if a result is available, false if the measurement goes on.
+ ******************************************************************************/
+bool pcnt_freq_update(pcnt_freq_t *freq,
+                      const pcnt_freq_snapshot_t *snapshot,
+                      pcnt_freq_result_t *result);
+
+/***************************************************************************//**
+ * Length of the next gate window in ticks, after pcnt_freq_update().
+ ******************************************************************************/
+uint32_t pcnt_freq_window(const pcnt_freq_t *freq);
+
+/***************************************************************************//**
+ * True if edge times are in use, so that snapshots need a coherent capture.
+ ******************************************************************************/
+bool pcnt_freq_reciprocal(const pcnt_freq_t *freq);
+
+#endif // PCNT_FREQ_H
@@ -1,12 +1,15 @@
 /***************************************************************************//**
  * @file app.c
  *
- * @brief This example demonstrates the single input externally clocked
- * mode but with the input coming via the PRS such that each GPIO
- * rising or falling edge (provided by button 0) generates an event.
- * In this way, the PCNT counts edges instead of pulses.  An interrupt
- * is requested whenever the count increases above the threshold
- * specified by PCNT_EDGE_COUNT and LED0 is toggled.
+ * @brief This example measures the frequency of the signal on the button 0
+ * pin with the PCNT in single input externally clocked mode, the input
+ * coming via the PRS. The same PRS channel also drives an RTCC input
+ * capture, which timestamps the last counted edge. The RTCC wakes the
+ * device at the end of each gate window to take a snapshot of the count
+ * and of the edge time, from which pcnt_freq.c computes the rate either
+ * as counts per gate time or, at low rates, as counts per time between
+ * the first and the last edge. LED0 is toggled on each result. All of
+ * this runs in EM2.
  *******************************************************************************
  * # License
  * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
@@ -44,28 +47,78 @@
 #include <stdbool.h>
 
 #include "em_cmu.h"
+#include "em_core.h"
 #include "em_emu.h"
+#include "em_gpio.h"
 #include "em_pcnt.h"
 #include "em_prs.h"
+#include "em_rtcc.h"
 
 #include "sl_emlib_gpio_init_pin_config.h"
 #include "sl_simple_led_instances.h"
 
-// Number of pulses (edges) to count before overflowing
-#define PCNT_EDGE_COUNT   5
+#include "pcnt_freq.h"
 
-// PRS channel to route the input events to the PCNT
+// PRS channel to route the input events to the PCNT and to the RTCC
 #define PCNT_PRS_CH       4
 
+// The PCNT counts modulo 2^16, wraps are counted by the overflow and
+// underflow interrupts.
+#define PCNT_TOP          0xFFFF
+
+/*
+ * Optional direction input, for instance channel B of a quadrature encoder
+ * whose channel A is on the button 0 pin. The PCNT counts down while it is
+ * high. Its pin number must differ from the button 0 pin number, both use
+ * the external interrupt line of that number to reach the PRS.
+ */
+// #define PCNT_DIR_PORT     gpioPortF
+// #define PCNT_DIR_PIN      7
+#define PCNT_DIR_PRS_CH   5
+
+// RTCC channels: gate window compare and edge capture
+#define RTCC_GATE_CH      0
+#define RTCC_EDGE_CH      1
+
+// Ticks an edge takes to reach the RTCC capture register
+#define RTCC_EDGE_TICKS   2
+
+// Measurement settings, in 32768 Hz RTCC ticks
+#define FREQ_TARGET_PPM         1000
+#define FREQ_MIN_WINDOW_TICKS   328     // 10 ms
+#define FREQ_MAX_WINDOW_TICKS   65536   // 2 s
+#define FREQ_RECIPROCAL_MAX_HZ  4096
+#define FREQ_COUNTS_PER_REV     2       // Fan tachometer, 2 pulses per turn
+
 static void initPCNT(void);
 static void initPRS(void);
 static void initGPIO(void);
+static void initRTCC(void);
+
+static pcnt_freq_t freq;
+
+// Overflows minus underflows of the PCNT
+static volatile int32_t pcntWraps = 0;
+
+// Latest measurement, check it with the debugger
+pcnt_freq_result_t freqResult;
 
 /***************************************************************************//**
  * Initialize application.
  ******************************************************************************/
 void app_init(void)
 {
+  static const pcnt_freq_config_t freqConfig = {
+    .clockHz = 32768,
+    .targetPpm = FREQ_TARGET_PPM,
+    .minWindowTicks = FREQ_MIN_WINDOW_TICKS,
+    .maxWindowTicks = FREQ_MAX_WINDOW_TICKS,
+    .reciprocalMaxHz = FREQ_RECIPROCAL_MAX_HZ,
+    .countsPerRev = FREQ_COUNTS_PER_REV,
+  };
+
+  pcnt_freq_init(&freq, &freqConfig);
+
   initGPIO();
   initPCNT();
   initPRS();
@@ -76,14 +129,15 @@ void app_init(void)
    * because they are needed to synchronize the PCNT registers with the
    * HFCLKLE domain.
    *
-   * To get around this such that each button push is recognized, the
+   * To get around this such that the first edges are counted, the
    * PRS software pulse triggering mechanism can be used to generate
-   * those first three pulses.  This allows the first button press (and
-   * the two edge events it creates) to be counted.
+   * those first three pulses.
    */
   for (uint32_t i = 0; i < 3; i++) {
     PRS_PulseTrigger(1 << PCNT_PRS_CH);
   }
+
+  initRTCC();
 }
 
 /***************************************************************************//**
@@ -91,14 +145,13 @@ void app_init(void)
  ******************************************************************************/
 void app_process_action(void)
 {
-  EMU_EnterEM1();
+  EMU_EnterEM2(true);
 }
 
 /***************************************************************************//**
  * @brief PCNT0 setup
- *        This function sets up PCNT0 with oversampling single mode
- *        Top value default to 5
- *        Event triggering when counting up
+ *        This function sets up PCNT0 with externally clocked single mode
+ *        Top value 0xFFFF, interrupts on overflow and underflow
  ******************************************************************************/
 static void initPCNT(void)
 {
@@ -113,11 +166,11 @@ static void initPCNT(void)
    *
    * It is not possible to use the single input oversampling mode to do
    * this because the maximum PCNT input frequency is limited to 8 kHz
-   * in this case, and the PRS pulses are too short to be detected.
+   * in this case.
    *
    * In addition to selecting the specified PRS channel as its input,
    * the PCNT_S1IN is ignored such that counting is always in the up
-   * direction.
+   * direction, unless a direction input is configured.
    *
    * IMPORTANT NOTE: Because S0IN clocks the PCNT in externally clocked
    * mode the first three pulses are effectively ignored because they
@@ -125,72 +178,232 @@ static void initPCNT(void)
    * counter will not update until the fourth pulse has been received.
    */
   pcntInit.mode = pcntModeExtSingle;
-  pcntInit.top = PCNT_EDGE_COUNT;
-  pcntInit.s1CntDir = false;
+  pcntInit.top = PCNT_TOP;
   pcntInit.s0PRS = PCNT_PRS_CH;
   pcntInit.filter = false;
+#if defined(PCNT_DIR_PORT)
+  pcntInit.s1CntDir = true;
+  pcntInit.s1PRS = PCNT_DIR_PRS_CH;
+#else
+  pcntInit.s1CntDir = false;
+#endif
 
   PCNT_Init(PCNT0, &pcntInit);
 
   // Enable the PCNT0_S0IN PRS input
   PCNT_PRSInputEnable(PCNT0, pcntPRSInputS0, true);
+#if defined(PCNT_DIR_PORT)
+  PCNT_PRSInputEnable(PCNT0, pcntPRSInputS1, true);
+#endif
 
-  // Clear pending interrupts and enable overflow interrupt
+  // Clear pending interrupts and enable the wrap interrupts
   PCNT_IntClear(PCNT0, _PCNT_IF_MASK);
-  PCNT_IntEnable(PCNT0, PCNT_IEN_OF);
+  PCNT_IntEnable(PCNT0, PCNT_IEN_OF | PCNT_IEN_UF);
 
   // Clear NVIC sources and enable
   NVIC_ClearPendingIRQ(PCNT0_IRQn);
   NVIC_EnableIRQ(PCNT0_IRQn);
 }
 
-static void initPRS(void)
+/***************************************************************************//**
+ * @brief Route the level of a pin to a PRS channel
+ ******************************************************************************/
+static void routePin(unsigned int ch, uint32_t pin)
 {
   uint32_t source, signal;
 
-  CMU_ClockEnable(cmuClock_PRS, true);
-
-  // Select the PRS source/signal depending on the button 0 port/pin
-  if (SL_EMLIB_GPIO_INIT_PIN_PIN >= 8) {
+  // Select the PRS source/signal depending on the pin
+  if (pin >= 8) {
     source = PRS_CH_CTRL_SOURCESEL_GPIOH;
-    signal = (uint32_t)(SL_EMLIB_GPIO_INIT_PIN_PIN - 8);
+    signal = pin - 8;
   } else {
     source = PRS_CH_CTRL_SOURCESEL_GPIOL;
-    signal = SL_EMLIB_GPIO_INIT_PIN_PIN;
+    signal = pin;
   }
 
-  // Select GPIO as PRS source and signal for both falling edges
-  PRS_SourceSignalSet(PCNT_PRS_CH, source, signal, prsEdgeBoth);
+  /*
+   * The pin level goes through the PRS asynchronously, so that the PCNT
+   * and the RTCC see it in EM2. The edge detector and pulse stretching
+   * of the PRS would need the HF clock.
+   */
+  PRS_SourceAsyncSignalSet(ch, source, signal);
+}
 
-  // Enable pulse stretching between domains
-  PRS->CH[PCNT_PRS_CH].CTRL |= PRS_CH_CTRL_STRETCH;
+static void initPRS(void)
+{
+  CMU_ClockEnable(cmuClock_PRS, true);
+
+  routePin(PCNT_PRS_CH, SL_EMLIB_GPIO_INIT_PIN_PIN);
+#if defined(PCNT_DIR_PORT)
+  routePin(PCNT_DIR_PRS_CH, PCNT_DIR_PIN);
+#endif
 }
 
 static void initGPIO(void)
 {
   /*
-   * Configure rising/falling GPIO edge detection on button 0 pin.
-   * Note that this call to GPIO_ExtIntConfig() almost looks the same
-   * as enabling a GPIO interrupt on the given pin, except that this
-   * case only the edge detection logic is enabled, not the interrupt
-   * itself.  This allows rising and falling edges on the pin to
-   * produce PRS events.
+   * Connect the button 0 pin to its external interrupt line, which is
+   * where the PRS GPIO producer takes it from. Only the routing is
+   * needed, neither edge is enabled and neither is the interrupt.
    */
   GPIO_ExtIntConfig(SL_EMLIB_GPIO_INIT_PIN_PORT,
                     SL_EMLIB_GPIO_INIT_PIN_PIN,
                     SL_EMLIB_GPIO_INIT_PIN_PIN,
-                    true, true, false);
+                    false, false, false);
+
+#if defined(PCNT_DIR_PORT)
+  GPIO_PinModeSet(PCNT_DIR_PORT, PCNT_DIR_PIN, gpioModeInput, 0);
+  GPIO_ExtIntConfig(PCNT_DIR_PORT, PCNT_DIR_PIN, PCNT_DIR_PIN,
+                    false, false, false);
+#endif
+}
+
+/***************************************************************************//**
+ * @brief RTCC setup
+ *        Counter at 32768 Hz from the LFXO, channel 0 compares for the end
+ *        of the gate window, channel 1 captures the time of each rising
+ *        edge on the PRS channel
+ ******************************************************************************/
+static void initRTCC(void)
+{
+  RTCC_Init_TypeDef rtccInit = RTCC_INIT_DEFAULT;
+  RTCC_CCChConf_TypeDef gate = RTCC_CH_INIT_COMPARE_DEFAULT;
+  RTCC_CCChConf_TypeDef edge = RTCC_CH_INIT_CAPTURE_DEFAULT;
+
+  CMU_ClockEnable(cmuClock_HFLE, true);
+  CMU_ClockSelectSet(cmuClock_LFE, cmuSelect_LFXO);
+  CMU_ClockEnable(cmuClock_RTCC, true);
+
+  rtccInit.enable = false;
+  rtccInit.presc = rtccCntPresc_1;
+  RTCC_Init(&rtccInit);
+
+  edge.prsSel = (RTCC_PRSSel_TypeDef)PCNT_PRS_CH;
+  edge.inputEdgeSel = rtccInEdgeRising;
+  RTCC_ChannelInit(RTCC_EDGE_CH, &edge);
+
+  RTCC_ChannelInit(RTCC_GATE_CH, &gate);
+  RTCC_ChannelCCVSet(RTCC_GATE_CH, pcnt_freq_window(&freq));
+
+  RTCC_IntClear(_RTCC_IF_MASK);
+  RTCC_IntEnable(RTCC_IEN_CC0);
+  NVIC_ClearPendingIRQ(RTCC_IRQn);
+  NVIC_EnableIRQ(RTCC_IRQn);
+
+  RTCC_Enable(true);
+}
+
+/***************************************************************************//**
+ * @brief Read the count, extended to 32 bits
+ ******************************************************************************/
+static int32_t pcntCount(void)
+{
+  uint32_t count, flags;
+
+  // The counter runs on the input clock, read it until two reads agree.
+  do {
+    count = PCNT_CounterGet(PCNT0);
+  } while (PCNT_CounterGet(PCNT0) != count);
+  flags = PCNT_IntGet(PCNT0);
+
+  return pcnt_freq_extend(pcntWraps, count, PCNT_TOP,
+                          (flags & PCNT_IF_OF) != 0,
+                          (flags & PCNT_IF_UF) != 0);
+}
+
+/***************************************************************************//**
+ * @brief Wait for the next RTCC tick
+ *
+ * @return The new counter value
+ ******************************************************************************/
+static uint32_t waitTick(void)
+{
+  uint32_t tick = RTCC_CounterGet();
+  uint32_t next;
+
+  while ((next = RTCC_CounterGet()) == tick) {
+  }
+  return next;
+}
+
+/***************************************************************************//**
+ * @brief Take the snapshot at the end of a gate window
+ *
+ * The count is read right after a tick, so that the gate time is that tick
+ * and all gates see the same latency. When the edge times are in use, the
+ * capture is read RTCC_EDGE_TICKS later and only kept if no edge came in
+ * the meantime: the captured edge is then the one that gave the count.
+ ******************************************************************************/
+static void snapshotTake(pcnt_freq_snapshot_t *snapshot)
+{
+  CORE_DECLARE_IRQ_STATE;
+  uint32_t tick, tries, i;
+
+  CORE_ENTER_ATOMIC();
+  snapshot->gateTime = waitTick();
+  snapshot->count = pcntCount();
+  snapshot->edgeTime = RTCC_ChannelCCVGet(RTCC_EDGE_CH);
+
+  // A sudden jump to a high rate would keep the loop going, the measurement
+  // stops using the edge times at the next update then.
+  tries = pcnt_freq_reciprocal(&freq) ? 4 : 0;
+  while (tries-- > 0) {
+    tick = snapshot->gateTime;
+    for (i = 0; i < RTCC_EDGE_TICKS; i++) {
+      tick = waitTick();
+    }
+    snapshot->edgeTime = RTCC_ChannelCCVGet(RTCC_EDGE_CH);
+    if (pcntCount() == snapshot->count) {
+      break;
+    }
+    // An edge came, start over from this tick.
+    snapshot->gateTime = tick;
+    snapshot->count = pcntCount();
+  }
+  CORE_EXIT_ATOMIC();
+}
+
+/***************************************************************************//**
+ * @brief RTCC interrupt handler
+ *        End of a gate window: take the snapshot, update the measurement
+ *        and set the end of the next window
+ ******************************************************************************/
+void RTCC_IRQHandler(void)
+{
+  pcnt_freq_snapshot_t snapshot;
+  pcnt_freq_result_t result;
+  uint32_t window;
+
+  RTCC_IntClear(RTCC_IF_CC0);
+
+  snapshotTake(&snapshot);
+  if (pcnt_freq_update(&freq, &snapshot, &result)) {
+    freqResult = result;
+    sl_led_toggle(&sl_led_led0);
+  }
+
+  // The interrupt comes one tick early, the snapshot waits for the tick.
+  window = pcnt_freq_window(&freq);
+  if (window < 2) {
+    window = 2;
+  }
+  RTCC_ChannelCCVSet(RTCC_GATE_CH, snapshot.gateTime + window - 1);
 }
 
 /***************************************************************************//**
  * @brief PCNT0 interrupt handler
- *        This function acknowledges the interrupt and toggles LED0
+ *        This function counts the counter wraps
  ******************************************************************************/
 void PCNT0_IRQHandler(void)
 {
-  // Clear overflow interrupt
-  PCNT_IntClear(PCNT0, PCNT_IFC_OF);
+  uint32_t flags = PCNT_IntGet(PCNT0);
+
+  PCNT_IntClear(PCNT0, flags);
 
-  // Toggle LED0
-  sl_led_toggle(&sl_led_led0);
+  if (flags & PCNT_IF_OF) {
+    pcntWraps++;
+  }
+  if (flags & PCNT_IF_UF) {
+    pcntWraps--;
+  }
 }
@@ -0,0 +1,262 @@
+/***************************************************************************//**
+ * @file pcnt_freq.c
+ *
+ * @brief Frequency and speed measurement from pulse counter snapshots
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "pcnt_freq.h"
+
+/***************************************************************************//**
+ * @brief Relative resolution of a measurement over n counts or ticks, in ppm
+ ******************************************************************************/
+static uint32_t resolution_ppm(uint32_t n)
+{
+  return (uint32_t)((1000000ULL + n - 1) / n);
+}
+
+/***************************************************************************//**
+ * @brief Start the next measurement at a snapshot
+ ******************************************************************************/
+static void restart(pcnt_freq_t *freq,
+                    const pcnt_freq_snapshot_t *snapshot,
+                    bool edgeValid)
+{
+  freq->start = *snapshot;
+  freq->edgeValid = edgeValid;
+}
+
+/***************************************************************************//**
+ * @brief Fit the time left until the next gate into the window limits
+ *
+ * @param[in] remaining Ticks wanted until the next gate.
+ * @param[in] sinceStart Ticks since the start of the measurement.
+ ******************************************************************************/
+static void window_set(pcnt_freq_t *freq, uint64_t remaining,
+                       uint32_t sinceStart)
+{
+  const pcnt_freq_config_t *config = &freq->config;
+  uint32_t limit = 1;
+
+  if (sinceStart < config->maxWindowTicks) {
+    limit = config->maxWindowTicks - sinceStart;
+  }
+  if (remaining < config->minWindowTicks) {
+    remaining = config->minWindowTicks;
+  }
+  if (remaining > limit) {
+    remaining = limit;
+  }
+  freq->windowTicks = remaining ? (uint32_t)remaining : 1;
+}
+
+/***************************************************************************//**
+ * @brief Plan the next gate for a count rate of counts per rateTicks
+ *
+ * The measurement needs 1 / target counts (gated) or 1 / target ticks between
+ * edges (reciprocal), whichever comes first.
+ ******************************************************************************/
+static void window_plan(pcnt_freq_t *freq, uint32_t counts,
+                        uint32_t rateTicks, uint32_t sinceStart)
+{
+  uint32_t need = resolution_ppm(freq->config.targetPpm);
+  uint64_t total, reciprocal;
+
+  total = ((uint64_t)need * rateTicks) / counts;
+  if (freq->reciprocal) {
+    // One more period for the edge that ends the measurement
+    reciprocal = need + rateTicks / counts;
+    if (reciprocal < total) {
+      total = reciprocal;
+    }
+  }
+  window_set(freq, (total > sinceStart) ? (total - sinceStart) : 0,
+             sinceStart);
+}
+
+/***************************************************************************//**
+ * @brief Initialize a measurement
+ ******************************************************************************/
+void pcnt_freq_init(pcnt_freq_t *freq, const pcnt_freq_config_t *config)
+{
+  memset(freq, 0, sizeof(*freq));
+  freq->config = *config;
+  freq->windowTicks = config->minWindowTicks ? config->minWindowTicks : 1;
+}
+
+/***************************************************************************//**
+ * @brief Extend a hardware count to 32 bits
+ ******************************************************************************/
+int32_t pcnt_freq_extend(int32_t wraps,
+                         uint32_t hwCount,
+                         uint32_t top,
+                         bool overflowPending,
+                         bool underflowPending)
+{
+  uint32_t modulus = top + 1;
+
+  if (overflowPending && (hwCount < (modulus / 2))) {
+    wraps++;
+  } else if (underflowPending && (hwCount >= (modulus / 2))) {
+    wraps--;
+  }
+  return (int32_t)((uint32_t)wraps * modulus + hwCount);
+}
+
+/***************************************************************************//**
+ * @brief Process the snapshot taken at the end of a gate window
+ ******************************************************************************/
+bool pcnt_freq_update(pcnt_freq_t *freq,
+                      const pcnt_freq_snapshot_t *snapshot,
+                      pcnt_freq_result_t *result)
+{
+  const pcnt_freq_config_t *config = &freq->config;
+  bool wasReciprocal = freq->reciprocal;
+  uint32_t elapsed, counts, span = 0, rateHz, denominator;
+  uint32_t gatedPpm, reciprocalPpm = UINT32_MAX, bestPpm;
+  uint64_t rate, milliHz;
+  int64_t speed;
+  int32_t delta;
+
+  if (!freq->started) {
+    freq->started = true;
+    restart(freq, snapshot, false);
+    window_set(freq, config->minWindowTicks, 0);
+    return false;
+  }
+
+  elapsed = snapshot->gateTime - freq->start.gateTime;
+  delta = (int32_t)((uint32_t)snapshot->count - (uint32_t)freq->start.count);
+  counts = (delta < 0) ? (0U - (uint32_t)delta) : (uint32_t)delta;
+
+  if (elapsed == 0) {
+    window_set(freq, config->minWindowTicks, 0);
+    return false;
+  }
+
+  if (counts == 0) {
+    if (elapsed < config->maxWindowTicks) {
+      window_set(freq, config->maxWindowTicks - elapsed, elapsed);
+      return false;
+    }
+    memset(result, 0, sizeof(*result));
+    result->method = pcntFreqStopped;
+    result->durationTicks = elapsed;
+    result->count = snapshot->count;
+    // The next edge may come much later, it cannot end a period.
+    restart(freq, snapshot, false);
+    window_set(freq, config->maxWindowTicks, 0);
+    return true;
+  }
+
+  // The edge capture only follows low rates; switch with 1/8 hysteresis.
+  rate = ((uint64_t)counts * config->clockHz) / elapsed;
+  rateHz = (rate > UINT32_MAX) ? UINT32_MAX : (uint32_t)rate;
+  if (freq->reciprocal && (rateHz > config->reciprocalMaxHz)) {
+    freq->reciprocal = false;
+  } else if (!freq->reciprocal
+             && (rateHz < (config->reciprocalMaxHz
+                           - config->reciprocalMaxHz / 8))) {
+    freq->reciprocal = true;
+  }
+
+  gatedPpm = resolution_ppm(counts);
+  if (freq->reciprocal && !freq->edgeValid && (gatedPpm > config->targetPpm)) {
+    // Too few counts for a gated result, start over from this edge. Its time
+    // is only coherent with the count if the port was capturing already.
+    restart(freq, snapshot, wasReciprocal);
+    window_plan(freq, counts, elapsed, 0);
+    return false;
+  }
+
+  if (freq->reciprocal && freq->edgeValid) {
+    span = snapshot->edgeTime - freq->start.edgeTime;
+    if (span != 0) {
+      reciprocalPpm = resolution_ppm(span);
+    }
+  }
+  bestPpm = (reciprocalPpm < gatedPpm) ? reciprocalPpm : gatedPpm;
+
+  if ((bestPpm > config->targetPpm) && (elapsed < config->maxWindowTicks)) {
+    window_plan(freq, counts, elapsed, elapsed);
+    return false;
+  }
+
+  if (reciprocalPpm < gatedPpm) {
+    result->method = pcntFreqReciprocal;
+    denominator = span;
+  } else {
+    result->method = pcntFreqGated;
+    denominator = elapsed;
+  }
+  milliHz = ((uint64_t)counts * config->clockHz * 1000 + denominator / 2)
+            / denominator;
+  result->frequencyMilliHz = (milliHz > UINT32_MAX)
+                             ? UINT32_MAX : (uint32_t)milliHz;
+  speed = 0;
+  if (config->countsPerRev != 0) {
+    speed = (int64_t)((milliHz * 60) / config->countsPerRev);
+    if (speed > INT32_MAX) {
+      speed = INT32_MAX;
+    }
+    if (delta < 0) {
+      speed = -speed;
+    }
+  }
+  result->speedMilliRpm = (int32_t)speed;
+  result->resolutionPpm = bestPpm;
+  result->durationTicks = elapsed;
+  result->count = snapshot->count;
+
+  restart(freq, snapshot, wasReciprocal && freq->reciprocal);
+  window_plan(freq, counts, elapsed, 0);
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief Length of the next gate window in ticks
+ ******************************************************************************/
+uint32_t pcnt_freq_window(const pcnt_freq_t *freq)
+{
+  return freq->windowTicks;
+}
+
+/***************************************************************************//**
+ * @brief True if edge times are in use
+ ******************************************************************************/
+bool pcnt_freq_reciprocal(const pcnt_freq_t *freq)
+{
+  return freq->reciprocal;
+}
@@ -0,0 +1,375 @@
+/***************************************************************************//**
+ * @file pcnt_freq_sim.c
+ *
+ * @brief Host edge stream simulator for the frequency measurement
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ *******************************************************************************
+ *
+ * Runs ../src/pcnt_freq.c against simulated edge streams the way app.c runs
+ * it: a 16-bit counter extended by overflow interrupts that may still be
+ * pending, gate snapshots taken on RTCC tick boundaries and an RTCC capture
+ * of the last edge. Every result is checked against the true rate and the
+ * resolution it claims.
+ *
+ * Build:
+ *   cc -O2 -I../inc -o pcnt_freq_sim pcnt_freq_sim.c ../src/pcnt_freq.c -lm
+ *
+ * Usage:
+ *   pcnt_freq_sim [options]
+ *
+ *   --target-ppm N     Resolution to hold (default 1000)
+ *   --jitter-ns N      Peak edge jitter (default 0)
+ *   --latency-ns N     Peak variation of the snapshot latency (default 100)
+ *   --seconds N        Simulated time per frequency (default 20)
+ *   --freq HZ          Run one frequency and print every result
+ *
+ * Without --freq, sweeps 1 Hz to 1 MHz, then checks a stopped input, counting
+ * down and the count extension. The exit status is 1 if any check failed.
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pcnt_freq.h"
+
+#define CLOCK_HZ          32768
+#define MIN_WINDOW_TICKS  328
+#define MAX_WINDOW_TICKS  65536
+#define RECIPROCAL_MAX_HZ 4096
+#define COUNTS_PER_REV    2
+#define PCNT_TOP          0xFFFF
+
+// RTCC start value, so that the tick counter wraps during each run
+#define TICK_OFFSET       0xFFFF0000UL
+
+static uint32_t targetPpm = 1000;
+static double jitterS = 0.0;
+static double latencyS = 100e-9;
+static double seconds = 20.0;
+
+/***************************************************************************//**
+ * Edge stream: edge k at phase + k / frequency + jitter(k), edges stop at
+ * stopTime. Jitter is a hash of k so that any edge can be looked up again.
+ ******************************************************************************/
+typedef struct {
+  double frequency;
+  double phase;
+  double stopTime;
+  int direction;
+} stream_t;
+
+static uint32_t hash(uint64_t k)
+{
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return (uint32_t)k;
+}
+
+static double edge_time(const stream_t *stream, int64_t k)
+{
+  double jitter = jitterS * (2.0 * hash((uint64_t)k) / 4294967295.0 - 1.0);
+
+  return stream->phase + (double)k / stream->frequency + jitter;
+}
+
+/***************************************************************************//**
+ * Number of edges up to time t, and the index of the last one.
+ ******************************************************************************/
+static int64_t edges_before(const stream_t *stream, double t)
+{
+  int64_t k;
+
+  if (t > stream->stopTime) {
+    t = stream->stopTime;
+  }
+  if (t < stream->phase - jitterS) {
+    return 0;
+  }
+  k = (int64_t)floor((t - stream->phase) * stream->frequency) + 2;
+  while ((k > 0) && (edge_time(stream, k - 1) > t)) {
+    k--;
+  }
+  return k;
+}
+
+static double uniform(void)
+{
+  return rand() / (double)RAND_MAX;
+}
+
+/***************************************************************************//**
+ * Snapshot as the port takes it: extended count, gate tick and capture.
+ ******************************************************************************/
+static void snapshot_take(const stream_t *stream, const pcnt_freq_t *freq,
+                          uint32_t gateTicks, pcnt_freq_snapshot_t *snapshot,
+                          uint32_t *extendErrors)
+{
+  double t = gateTicks / (double)CLOCK_HZ + 1e-6
+             + latencyS * (2.0 * uniform() - 1.0);
+  int64_t edges = edges_before(stream, t);
+  int32_t count = (int32_t)(edges * stream->direction);
+  int32_t wraps = (int32_t)floor(count / (double)(PCNT_TOP + 1));
+  uint32_t hw = (uint32_t)count & PCNT_TOP;
+  bool overflow = false, underflow = false;
+
+  // The wrap interrupt of the last wrap may not have run yet.
+  if ((edges > 0) && (uniform() < 0.5)) {
+    if ((stream->direction > 0) && (hw < 0x100)) {
+      wraps--;
+      overflow = true;
+    } else if ((stream->direction < 0) && (hw > PCNT_TOP - 0x100)) {
+      wraps++;
+      underflow = true;
+    }
+  }
+  snapshot->count = pcnt_freq_extend(wraps, hw, PCNT_TOP, overflow, underflow);
+  if (snapshot->count != count) {
+    (*extendErrors)++;
+  }
+
+  snapshot->gateTime = (uint32_t)(gateTicks + TICK_OFFSET);
+  if (pcnt_freq_reciprocal(freq) && (edges > 0)) {
+    // RTCC capture, a constant synchronization delay of one tick
+    snapshot->edgeTime = (uint32_t)((uint64_t)floor(edge_time(stream, edges - 1)
+                                                    * CLOCK_HZ)
+                                    + 1 + TICK_OFFSET);
+  } else {
+    // Capture not followed, anything goes
+    snapshot->edgeTime = (uint32_t)rand();
+  }
+}
+
+typedef struct {
+  uint32_t results;
+  uint32_t gated;
+  uint32_t reciprocal;
+  uint32_t stopped;
+  uint32_t failures;
+  uint32_t extendErrors;
+  uint32_t gates;
+  double maxErrorPpm;
+  double maxResolutionPpm;
+  double durationTicks;
+  int32_t lastSpeed;
+} run_t;
+
+/***************************************************************************//**
+ * Run the measurement on a stream.
+ ******************************************************************************/
+static void run(const stream_t *stream, bool verbose, run_t *stats)
+{
+  pcnt_freq_config_t config = {
+    .clockHz = CLOCK_HZ,
+    .targetPpm = targetPpm,
+    .minWindowTicks = MIN_WINDOW_TICKS,
+    .maxWindowTicks = MAX_WINDOW_TICKS,
+    .reciprocalMaxHz = RECIPROCAL_MAX_HZ,
+    .countsPerRev = COUNTS_PER_REV,
+  };
+  pcnt_freq_t freq;
+  pcnt_freq_snapshot_t snapshot;
+  pcnt_freq_result_t result;
+  uint32_t gate = 0, end = (uint32_t)(seconds * CLOCK_HZ);
+  double measured, error, bound;
+
+  memset(stats, 0, sizeof(*stats));
+  pcnt_freq_init(&freq, &config);
+  while (gate < end) {
+    stats->gates++;
+    snapshot_take(stream, &freq, gate, &snapshot, &stats->extendErrors);
+    if (pcnt_freq_update(&freq, &snapshot, &result)) {
+      stats->results++;
+      stats->durationTicks += result.durationTicks;
+      stats->lastSpeed = result.speedMilliRpm;
+      if (result.method == pcntFreqStopped) {
+        stats->stopped++;
+      } else {
+        if (result.method == pcntFreqGated) {
+          stats->gated++;
+        } else {
+          stats->reciprocal++;
+        }
+        measured = result.frequencyMilliHz / 1000.0;
+        error = fabs(measured - stream->frequency) / stream->frequency * 1e6;
+        // Claimed resolution, rounding to 1 mHz, and the jitter of the edges
+        // and snapshots at both ends
+        bound = result.resolutionPpm + 0.5e6 / result.frequencyMilliHz
+                + 2.0 * (jitterS + latencyS) * CLOCK_HZ
+                / result.durationTicks * 1e6 + 1.0;
+        if (error > stats->maxErrorPpm) {
+          stats->maxErrorPpm = error;
+        }
+        if (result.resolutionPpm > stats->maxResolutionPpm) {
+          stats->maxResolutionPpm = result.resolutionPpm;
+        }
+        if (error > bound) {
+          stats->failures++;
+        }
+        if (verbose) {
+          printf("%9.3f s  %-10s %14.3f Hz  %10.1f ppm  res %6u ppm  "
+                 "%8.1f ms  %9d mrpm\n",
+                 gate / (double)CLOCK_HZ,
+                 (result.method == pcntFreqGated) ? "gated" : "reciprocal",
+                 measured, error, result.resolutionPpm,
+                 result.durationTicks * 1000.0 / CLOCK_HZ,
+                 result.speedMilliRpm);
+        }
+      }
+    }
+    gate += pcnt_freq_window(&freq);
+  }
+}
+
+/***************************************************************************//**
+ * Sweep the range and print one line per frequency.
+ ******************************************************************************/
+static uint32_t sweep(void)
+{
+  stream_t stream = { .stopTime = 1e9, .direction = 1 };
+  uint32_t failures = 0;
+  run_t stats;
+
+  printf("target %u ppm, jitter %.0f ns, latency %.0f ns\n",
+         targetPpm, jitterS * 1e9, latencyS * 1e9);
+  printf("%12s %7s %7s %7s %12s %12s %10s %8s\n", "freq Hz", "gated",
+         "recip", "gates", "max err ppm", "max res ppm", "avg ms", "status");
+  for (double f = 1.0; f <= 1.0001e6; f *= sqrt(10.0)) {
+    stream.frequency = f;
+    stream.phase = uniform() / f;
+    run(&stream, false, &stats);
+    printf("%12.3f %7u %7u %7u %12.1f %12.0f %10.1f %8s\n", f, stats.gated,
+           stats.reciprocal, stats.gates, stats.maxErrorPpm,
+           stats.maxResolutionPpm,
+           stats.results ? stats.durationTicks * 1000.0 / CLOCK_HZ
+           / stats.results : 0.0,
+           (stats.failures || stats.extendErrors || stats.stopped
+            || !stats.results) ? "FAIL" : "ok");
+    failures += stats.failures + stats.extendErrors + stats.stopped
+                + (stats.results ? 0 : 1);
+  }
+  return failures;
+}
+
+/***************************************************************************//**
+ * Stopped input, counting down and count extension.
+ ******************************************************************************/
+static uint32_t checks(void)
+{
+  stream_t stream = { .frequency = 150.0, .phase = 0.01, .direction = 1 };
+  uint32_t failures = 0;
+  run_t stats;
+
+  stream.stopTime = seconds / 2;
+  run(&stream, false, &stats);
+  printf("stop after %.0f s: %u stopped results, %s\n", seconds / 2,
+         stats.stopped,
+         (stats.stopped >= 1) && (stats.lastSpeed == 0) ? "ok" : "FAIL");
+  failures += ((stats.stopped >= 1) && (stats.lastSpeed == 0)) ? 0 : 1;
+  failures += stats.failures;
+
+  stream.stopTime = 1e9;
+  stream.direction = -1;
+  stream.frequency = 40000.0;
+  run(&stream, false, &stats);
+  printf("counting down at %.0f Hz: %d mrpm, %s\n", stream.frequency,
+         stats.lastSpeed,
+         ((stats.lastSpeed < -1190000000) && !stats.failures
+          && !stats.extendErrors) ? "ok" : "FAIL");
+  failures += ((stats.lastSpeed < -1190000000) && !stats.failures
+               && !stats.extendErrors) ? 0 : 1;
+
+  // Every pending flag combination around the wrap
+  for (int32_t wraps = -3; wraps <= 3; wraps++) {
+    for (uint32_t hw = 0; hw <= PCNT_TOP; hw += 0x1111) {
+      int32_t base = (int32_t)((uint32_t)wraps * (PCNT_TOP + 1) + hw);
+      if ((pcnt_freq_extend(wraps, hw, PCNT_TOP, false, false) != base)
+          || (pcnt_freq_extend(wraps, hw, PCNT_TOP, true, false)
+              != base + ((hw < 0x8000) ? (PCNT_TOP + 1) : 0))
+          || (pcnt_freq_extend(wraps, hw, PCNT_TOP, false, true)
+              != base - ((hw >= 0x8000) ? (PCNT_TOP + 1) : 0))) {
+        failures++;
+      }
+    }
+  }
+  printf("count extension: %s\n", failures ? "FAIL" : "ok");
+  return failures;
+}
+
+int main(int argc, char **argv)
+{
+  double single = 0.0;
+  uint32_t failures;
+  run_t stats;
+
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "--target-ppm") == 0) && (i + 1 < argc)) {
+      targetPpm = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if ((strcmp(argv[i], "--jitter-ns") == 0) && (i + 1 < argc)) {
+      jitterS = atof(argv[++i]) * 1e-9;
+    } else if ((strcmp(argv[i], "--latency-ns") == 0) && (i + 1 < argc)) {
+      latencyS = atof(argv[++i]) * 1e-9;
+    } else if ((strcmp(argv[i], "--seconds") == 0) && (i + 1 < argc)) {
+      seconds = atof(argv[++i]);
+    } else if ((strcmp(argv[i], "--freq") == 0) && (i + 1 < argc)) {
+      single = atof(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: %s [--target-ppm N] [--jitter-ns N] "
+              "[--latency-ns N] [--seconds N] [--freq HZ]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (targetPpm == 0) {
+    fprintf(stderr, "target must be at least 1 ppm\n");
+    return 2;
+  }
+
+  srand(1);
+  if (single > 0.0) {
+    stream_t stream = { .frequency = single, .phase = 0.5 / single,
+                        .stopTime = 1e9, .direction = 1 };
+    run(&stream, true, &stats);
+    return stats.failures ? 1 : 0;
+  }
+
+  failures = sweep();
+  failures += checks();
+  printf("%s\n", failures ? "FAILED" : "all checks passed");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,100 @@
+/***************************************************************************//**
+ * @file
+ * @brief Placement of hot functions and interrupt handlers in RAM
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef RAM_EXEC_H
+#define RAM_EXEC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * With linkerfile.ld, the whole code but the startup runs from RAM and is
+ * copied by the startup code with .data. The functions marked RAM_TEXT go
+ * with it, and the .ram_text section of this file spans all the code in RAM.
+ *
+ * With linkerfile_ram_text.ld, functions marked RAM_TEXT are linked to the
+ * .ram_text section, which runs from RAM and is loaded in flash after .data.
+ * ram_exec_init() copies it at start-up, before anything in it can run.
+ * The rest of the code stays in flash.
+ *
+ * Interrupts go through the RAM vector table of the RAM interrupt vector
+ * initialization component, so no flash access is needed to take them.
+ * Each vector can then be pointed at a handler in RAM.
+ */
+
+/*******************************************************************************
+ *******************************   DEFINES   ***********************************
+ ******************************************************************************/
+
+// Mark a function, on its declaration and definition, to run from RAM. The
+// long call lets code in flash reach it, the RAM being out of branch range.
+#define RAM_TEXT  __attribute__((section(".ram_text"), noinline, long_call))
+
+/*******************************************************************************
+ *******************************   TYPEDEFS   **********************************
+ ******************************************************************************/
+
+typedef void (*ram_exec_handler_t)(void);
+
+/*******************************************************************************
+ *****************************   PROTOTYPES   **********************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Copy the .ram_text section from flash to RAM.
+ *
+ * Called first thing in main(), before the interrupts are enabled: the
+ * vectors of handlers marked RAM_TEXT already point to RAM.
+ ******************************************************************************/
+void ram_exec_init(void);
+
+/***************************************************************************//**
+ * True if the code at an address, a function pointer for instance, is in the
+ * .ram_text section.
+ ******************************************************************************/
+bool ram_exec_contains(const void *code);
+
+/***************************************************************************//**
+ * Point an interrupt, or an exception with a negative number, at a handler.
+ *
+ * @return false if the RAM vector table is not the active one, or if irq is
+ *   out of the table. The vector is then not changed.
+ ******************************************************************************/
+bool ram_exec_vector_set(int32_t irq, ram_exec_handler_t handler);
+
+/***************************************************************************//**
+ * Handler of an interrupt, or an exception with a negative number, in the
+ * active vector table.
+ ******************************************************************************/
+ram_exec_handler_t ram_exec_vector_get(int32_t irq);
+
+/***************************************************************************//**
+ * Point the vectors going to a handler at another one, the Default_Handler
+ * in flash at one in RAM for instance.
+ *
+ * @return Vectors changed, 0 if the RAM vector table is not the active one.
+ ******************************************************************************/
+uint32_t ram_exec_vector_replace(ram_exec_handler_t from,
+                                 ram_exec_handler_t to);
+
+/***************************************************************************//**
+ * Vectors of the interrupts enabled in the NVIC that still point to code in
+ * flash.
+ ******************************************************************************/
+uint32_t ram_exec_vectors_in_flash(void);
+
+#endif // RAM_EXEC_H
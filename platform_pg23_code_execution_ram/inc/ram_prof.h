@@ -0,0 +1,78 @@
+/***************************************************************************//**
+ * @file
+ * @brief Cycles per call of code in flash and in RAM, from the DWT counter
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef RAM_PROF_H
+#define RAM_PROF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Each call is timed on its own with the DWT cycle counter, the instruction
+ * cache flushed before it for a cold run. The dump printed by
+ * ram_prof_dump() is read by tools/ram_prof_report.c:
+ *
+ *   prof begin <core clock Hz> <flash wait states> <overhead cycles>
+ *   prof <name> <flash|ram> <warm|cold> <calls> <cycles> <min> <max>
+ *   prof end
+ *
+ * The overhead is the time of an empty call in flash, included in the
+ * cycles, min and max of each entry.
+ */
+
+/*******************************************************************************
+ *******************************   TYPEDEFS   **********************************
+ ******************************************************************************/
+
+// Code to time, called with the index of the call
+typedef uint32_t (*ram_prof_function_t)(uint32_t call);
+
+// Results of some code
+typedef struct {
+  const char *name;         // Same for the flash and RAM copies of the code
+  const void *code;         // Code timed, tells the placement
+  bool cold;                // Instruction cache flushed before each call
+  uint32_t calls;
+  uint32_t cycles;          // All calls
+  uint32_t minCycles;
+  uint32_t maxCycles;
+} ram_prof_entry_t;
+
+/*******************************************************************************
+ *****************************   PROTOTYPES   **********************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * Start the cycle counter and measure the overhead of a call.
+ ******************************************************************************/
+void ram_prof_init(void);
+
+/***************************************************************************//**
+ * Time calls of a function, adding to an entry.
+ *
+ * entry->code is set to the function if NULL. It is given apart when the
+ * function only leads to the code to time, an interrupt handler for instance.
+ ******************************************************************************/
+void ram_prof_measure(ram_prof_entry_t *entry, ram_prof_function_t function,
+                      uint32_t calls);
+
+/***************************************************************************//**
+ * Print the results of entries.
+ ******************************************************************************/
+void ram_prof_dump(const ram_prof_entry_t *entries, uint32_t count);
+
+#endif // RAM_PROF_H
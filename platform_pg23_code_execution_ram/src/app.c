@@ -18,7 +18,9 @@
 #include "em_cmu.h"
 #include "em_core.h"
 
-#define IRQ_TABLE_SIZE      (EXT_IRQ_COUNT + 16)
+#include "printf.h"
+#include "ram_exec.h"
+#include "ram_prof.h"
 
 #define BSP_GPIO_PB0_PORT   gpioPortA
 #define BSP_GPIO_PB0_PIN    5
@@ -32,22 +34,134 @@
 #define BSP_GPIO_LED1_PORT  gpioPortC
 #define BSP_GPIO_LED1_PIN   9
 
-typedef void (*vectors_irq_func_ptr)(void);
+// Interrupt not used otherwise, set pending by software to time the entry to
+// a handler and its return
+#define PROFILE_IRQn        TIMER4_IRQn
 
-extern vectors_irq_func_ptr gecko_vector_table[IRQ_TABLE_SIZE];
+// Calls timed per entry
+#define PROFILE_CALLS       1000
+
+#define CRC_BYTES           64
+#define FIR_TAPS            16
+#define FIR_SAMPLES         32
+
+// Same body in flash and in RAM: name##_flash() and name##_ram(). With the
+// whole image in RAM (linkerfile.ld), both are in RAM.
+#define HOT_FUNCTION_PAIR(name)                                  \
+  __attribute__((noinline))                                      \
+  static uint32_t name##_flash(uint32_t call)                    \
+  {                                                              \
+    return name##_body(call);                                    \
+  }                                                              \
+  RAM_TEXT static uint32_t name##_ram(uint32_t call)             \
+  {                                                              \
+    return name##_body(call);                                    \
+  }
 
 extern void Default_Handler(void);
-void RAM_Default_Handler(void);
-void ram_interrupt_vector_update(void);
+RAM_TEXT void RAM_Default_Handler(void);
+RAM_TEXT void GPIO_ODD_IRQHandler(void);
 void gpio_setup(void);
+void profile_run(void);
+
+static uint8_t crcData[CRC_BYTES];
+// Not const, to keep the data of both copies in RAM: only the code moves
+static int16_t firTaps[FIR_TAPS] = {
+  -120, -310, -420, 0, 1210, 3060, 4830, 5750,
+  5750, 4830, 3060, 1210, 0, -420, -310, -120
+};
+static int16_t firInput[FIR_SAMPLES + FIR_TAPS - 1];
+static int16_t firOutput[FIR_SAMPLES];
+
+static volatile uint32_t profileIrqs;
+
+/***************************************************************************//**
+ * Hot code: CRC-16-CCITT of a buffer, bit by bit.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) uint32_t crc_body(uint32_t call)
+{
+  uint16_t crc = 0xFFFF;
+
+  for (uint32_t i = 0; i < CRC_BYTES; i++) {
+    crc ^= (uint16_t)((crcData[i] ^ call) << 8);
+    for (uint32_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021)
+            : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+/***************************************************************************//**
+ * Hot code: low pass FIR filter of a block of samples, Q15.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) uint32_t fir_body(uint32_t call)
+{
+  for (uint32_t n = 0; n < FIR_SAMPLES; n++) {
+    int32_t sum = 0;
+
+    for (uint32_t k = 0; k < FIR_TAPS; k++) {
+      sum += firTaps[k] * firInput[n + k];
+    }
+    firOutput[n] = (int16_t)(sum >> 15);
+  }
+  return (uint32_t)firOutput[call % FIR_SAMPLES];
+}
+
+/***************************************************************************//**
+ * Hot interrupt: count, and keep a moving sum of the cycle counter.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) uint32_t irq_body(uint32_t call)
+{
+  static uint32_t history[8];
+  static uint32_t sum;
+
+  sum += call - history[profileIrqs % 8];
+  history[profileIrqs % 8] = call;
+  profileIrqs++;
+  return sum;
+}
+
+HOT_FUNCTION_PAIR(crc)
+HOT_FUNCTION_PAIR(fir)
+HOT_FUNCTION_PAIR(irq)
+
+/***************************************************************************//**
+ * Handlers of PROFILE_IRQn, in flash and in RAM.
+ ******************************************************************************/
+static void profile_irq_flash(void)
+{
+  irq_flash(DWT->CYCCNT);
+}
+
+RAM_TEXT static void profile_irq_ram(void)
+{
+  irq_ram(DWT->CYCCNT);
+}
+
+/***************************************************************************//**
+ * Take PROFILE_IRQn once, with the handler in its vector.
+ ******************************************************************************/
+static uint32_t irq_trip(uint32_t call)
+{
+  uint32_t count = profileIrqs;
+
+  (void)call;
+  NVIC_SetPendingIRQ(PROFILE_IRQn);
+  while (profileIrqs == count) {
+  }
+  return count;
+}
 
 /***************************************************************************//**
  * Initialize application.
  ******************************************************************************/
 void app_init(void)
 {
-  ram_interrupt_vector_update();
+  // Exceptions and interrupts without a handler go to the one in RAM
+  ram_exec_vector_replace(Default_Handler, RAM_Default_Handler);
   gpio_setup();
+  profile_run();
 }
 
 /***************************************************************************//**
@@ -57,6 +171,64 @@ void app_process_action(void)
 {
 }
 
+/***************************************************************************//**
+ * Time the hot code in flash and in RAM, then print the results.
+ ******************************************************************************/
+void profile_run(void)
+{
+  static ram_prof_entry_t entries[] = {
+    { .name = "crc16", .cold = false },
+    { .name = "crc16", .cold = false },
+    { .name = "crc16", .cold = true },
+    { .name = "crc16", .cold = true },
+    { .name = "fir", .cold = false },
+    { .name = "fir", .cold = false },
+    { .name = "fir", .cold = true },
+    { .name = "fir", .cold = true },
+    { .name = "irq", .cold = false },
+    { .name = "irq", .cold = false },
+    { .name = "irq", .cold = true },
+    { .name = "irq", .cold = true },
+  };
+  const ram_prof_function_t functions[] = {
+    crc_flash, crc_ram, crc_flash, crc_ram,
+    fir_flash, fir_ram, fir_flash, fir_ram,
+  };
+  const ram_exec_handler_t handlers[] = {
+    profile_irq_flash, profile_irq_ram, profile_irq_flash, profile_irq_ram,
+  };
+  uint32_t i, j;
+
+  for (i = 0; i < CRC_BYTES; i++) {
+    crcData[i] = (uint8_t)(i * 37 + 11);
+  }
+  for (i = 0; i < FIR_SAMPLES + FIR_TAPS - 1; i++) {
+    firInput[i] = (int16_t)((i * 2654435761UL) >> 17);
+  }
+
+  ram_prof_init();
+
+  for (i = 0; i < sizeof(functions) / sizeof(functions[0]); i++) {
+    ram_prof_measure(&entries[i], functions[i], PROFILE_CALLS);
+  }
+
+  NVIC_ClearPendingIRQ(PROFILE_IRQn);
+  NVIC_EnableIRQ(PROFILE_IRQn);
+  for (j = 0; j < sizeof(handlers) / sizeof(handlers[0]); i++, j++) {
+    // Time the handler in the vector, not the function taking the interrupt
+    entries[i].code = (const void *)handlers[j];
+    ram_exec_vector_set(PROFILE_IRQn, handlers[j]);
+    ram_prof_measure(&entries[i], irq_trip, PROFILE_CALLS);
+  }
+
+  ram_prof_dump(entries, sizeof(entries) / sizeof(entries[0]));
+  printf("code in RAM: %s\r\n",
+         ram_exec_contains((const void *)app_init) ? "whole image"
+         : "RAM_TEXT functions");
+  printf("enabled interrupts with a handler in flash: %lu\r\n",
+         (unsigned long)ram_exec_vectors_in_flash());
+}
+
 /**************************************************************************//**
  * @brief
  *   Setup GPIO for pushbuttons and LEDs
@@ -95,9 +267,9 @@ void gpio_setup(void)
 
 /**************************************************************************//**
  * @brief
- *   GPIO Interrupt handler for odd pins.
+ *   GPIO Interrupt handler for odd pins, runs from RAM.
  *****************************************************************************/
-void GPIO_ODD_IRQHandler(void)
+RAM_TEXT void GPIO_ODD_IRQHandler(void)
 {
   // Get and clear all pending GPIO interrupts
   uint32_t interruptMask = GPIO_IntGet();
@@ -113,26 +285,9 @@ void GPIO_ODD_IRQHandler(void)
  * @brief
  *   Place Default Handler for Exceptions / Interrupts in RAM
  ******************************************************************************/
-void RAM_Default_Handler(void)
+RAM_TEXT void RAM_Default_Handler(void)
 {
   GPIO_PinOutSet(BSP_GPIO_LED1_PORT, BSP_GPIO_LED1_PIN);
   while (true) {
   }
 }
-
-/***************************************************************************//**
- * @brief
- *   Configures the vector table in RAM to point to the new Default handler
- *   address that is located in RAM.
- *   The new Default handler can be used to catch exceptions
- *   and external interrupts which are not handled by specific ISRs.
- ******************************************************************************/
-void ram_interrupt_vector_update(void)
-{
-  for (uint32_t i = 0; i < IRQ_TABLE_SIZE; i++) {
-    // Overwrite target entries.
-    if (gecko_vector_table[i] == Default_Handler) {
-      gecko_vector_table[i] = RAM_Default_Handler;
-    }
-  }
-}
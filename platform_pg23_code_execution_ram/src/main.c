@@ -17,6 +17,7 @@
 #include "sl_component_catalog.h"
 #include "sl_system_init.h"
 #include "app.h"
+#include "ram_exec.h"
 #if defined(SL_CATALOG_POWER_MANAGER_PRESENT)
 #include "sl_power_manager.h"
 #endif
@@ -28,6 +29,9 @@
 
 int main(void)
 {
+  // Copy the code marked RAM_TEXT to RAM, before any of it can run
+  ram_exec_init();
+
   // Initialize Silicon Labs device, system, service(s) and protocol stack(s).
   // Note that if the kernel is present, processing task(s) will be created by
   // this call.
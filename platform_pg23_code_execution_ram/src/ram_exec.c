@@ -0,0 +1,136 @@
+/***************************************************************************//**
+ * @file
+ * @brief Placement of hot functions and interrupt handlers in RAM
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include "em_device.h"
+
+#include "ram_exec.h"
+
+#define IRQ_TABLE_SIZE      (EXT_IRQ_COUNT + 16)
+
+// RAM vector table of the RAM interrupt vector initialization component
+extern ram_exec_handler_t gecko_vector_table[IRQ_TABLE_SIZE];
+
+// .ram_text, in RAM and its copy in flash (linkerfile_ram_text.ld), or all
+// the code in RAM (linkerfile.ld)
+extern uint32_t __ram_text_start__[];
+extern uint32_t __ram_text_end__[];
+extern uint32_t __ram_text_load__[];
+
+/***************************************************************************//**
+ * True when the RAM vector table is the one in use.
+ ******************************************************************************/
+static bool ram_vectors_active(void)
+{
+  return SCB->VTOR == (uint32_t)gecko_vector_table;
+}
+
+/***************************************************************************//**
+ * Copy the .ram_text section from flash to RAM.
+ ******************************************************************************/
+void ram_exec_init(void)
+{
+  const uint32_t *from = __ram_text_load__;
+  uint32_t *to = __ram_text_start__;
+
+  // With the whole image in RAM, the startup code has copied it already
+  while ((from != to) && (to < __ram_text_end__)) {
+    *to++ = *from++;
+  }
+
+  // The copy must be done before the first instruction fetch from it
+  __DSB();
+  __ISB();
+}
+
+/***************************************************************************//**
+ * True if the code at an address is in the .ram_text section.
+ ******************************************************************************/
+bool ram_exec_contains(const void *code)
+{
+  // Clear the Thumb bit of function pointers
+  uint32_t address = (uint32_t)code & ~1UL;
+
+  return (address >= (uint32_t)__ram_text_start__)
+         && (address < (uint32_t)__ram_text_end__);
+}
+
+/***************************************************************************//**
+ * Point an interrupt, or an exception with a negative number, at a handler.
+ ******************************************************************************/
+bool ram_exec_vector_set(int32_t irq, ram_exec_handler_t handler)
+{
+  int32_t index = irq + 16;
+
+  if (!ram_vectors_active() || (index < 1) || (index >= IRQ_TABLE_SIZE)) {
+    return false;
+  }
+  gecko_vector_table[index] = handler;
+
+  // Taken with the new vector from now on
+  __DSB();
+  return true;
+}
+
+/***************************************************************************//**
+ * Handler of an interrupt, or an exception with a negative number.
+ ******************************************************************************/
+ram_exec_handler_t ram_exec_vector_get(int32_t irq)
+{
+  int32_t index = irq + 16;
+
+  if ((index < 1) || (index >= IRQ_TABLE_SIZE)) {
+    return 0;
+  }
+  return ((const ram_exec_handler_t *)SCB->VTOR)[index];
+}
+
+/***************************************************************************//**
+ * Point the vectors going to a handler at another one.
+ ******************************************************************************/
+uint32_t ram_exec_vector_replace(ram_exec_handler_t from,
+                                 ram_exec_handler_t to)
+{
+  uint32_t count = 0;
+
+  if (!ram_vectors_active()) {
+    return 0;
+  }
+  // From 1, the first word is the initial stack pointer
+  for (uint32_t i = 1; i < IRQ_TABLE_SIZE; i++) {
+    if (gecko_vector_table[i] == from) {
+      gecko_vector_table[i] = to;
+      count++;
+    }
+  }
+  __DSB();
+  return count;
+}
+
+/***************************************************************************//**
+ * Vectors of the interrupts enabled in the NVIC still pointing to flash.
+ ******************************************************************************/
+uint32_t ram_exec_vectors_in_flash(void)
+{
+  uint32_t count = 0;
+
+  for (int32_t irq = 0; irq < EXT_IRQ_COUNT; irq++) {
+    if (NVIC_GetEnableIRQ((IRQn_Type)irq)
+        && !ram_exec_contains((const void *)ram_exec_vector_get(irq))) {
+      count++;
+    }
+  }
+  return count;
+}
@@ -0,0 +1,113 @@
+/***************************************************************************//**
+ * @file
+ * @brief Cycles per call of code in flash and in RAM, from the DWT counter
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include "em_device.h"
+
+#include "printf.h"
+#include "ram_exec.h"
+#include "ram_prof.h"
+
+#define OVERHEAD_CALLS      16
+
+static uint32_t overheadCycles;
+
+/***************************************************************************//**
+ * Empty call, in flash, to measure the overhead.
+ ******************************************************************************/
+__attribute__((noinline))
+static uint32_t empty_call(uint32_t call)
+{
+  return call;
+}
+
+/***************************************************************************//**
+ * Start the cycle counter and measure the overhead of a call.
+ ******************************************************************************/
+void ram_prof_init(void)
+{
+  ram_prof_entry_t entry = { 0 };
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  ram_prof_measure(&entry, empty_call, OVERHEAD_CALLS);
+  overheadCycles = entry.minCycles;
+}
+
+/***************************************************************************//**
+ * Time calls of a function, adding to an entry.
+ ******************************************************************************/
+void ram_prof_measure(ram_prof_entry_t *entry, ram_prof_function_t function,
+                      uint32_t calls)
+{
+  volatile uint32_t sink;
+  uint32_t start, cycles;
+
+  if (entry->code == NULL) {
+    entry->code = (const void *)function;
+  }
+  if (entry->calls == 0) {
+    entry->minCycles = UINT32_MAX;
+    entry->maxCycles = 0;
+  }
+
+  for (uint32_t call = 0; call < calls; call++) {
+#if defined(ICACHE0)
+    if (entry->cold) {
+      ICACHE0->CMD = ICACHE_CMD_FLUSH;
+      __DSB();
+      __ISB();
+    }
+#endif
+    start = DWT->CYCCNT;
+    sink = function(call);
+    cycles = DWT->CYCCNT - start;
+
+    entry->calls++;
+    entry->cycles += cycles;
+    if (cycles < entry->minCycles) {
+      entry->minCycles = cycles;
+    }
+    if (cycles > entry->maxCycles) {
+      entry->maxCycles = cycles;
+    }
+  }
+  (void)sink;
+}
+
+/***************************************************************************//**
+ * Print the results of entries.
+ ******************************************************************************/
+void ram_prof_dump(const ram_prof_entry_t *entries, uint32_t count)
+{
+  printf("prof begin %lu %lu %lu\r\n",
+         (unsigned long)SystemCoreClockGet(),
+         (unsigned long)((MSC->READCTRL & _MSC_READCTRL_MODE_MASK)
+                         >> _MSC_READCTRL_MODE_SHIFT),
+         (unsigned long)overheadCycles);
+  for (uint32_t i = 0; i < count; i++) {
+    printf("prof %s %s %s %lu %lu %lu %lu\r\n",
+           entries[i].name,
+           ram_exec_contains(entries[i].code) ? "ram" : "flash",
+           entries[i].cold ? "cold" : "warm",
+           (unsigned long)entries[i].calls,
+           (unsigned long)entries[i].cycles,
+           (unsigned long)entries[i].minCycles,
+           (unsigned long)entries[i].maxCycles);
+  }
+  printf("prof end\r\n");
+}
@@ -0,0 +1,224 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host report of the flash and RAM cycles per call profile
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ *******************************************************************************
+ *
+ * Reads the profile printed by the example on the virtual COM port, and
+ * prints the cycles and time per call of each code in flash and in RAM, side
+ * by side, with the call overhead taken out.
+ *
+ * Build:
+ *   cc -O2 -o ram_prof_report ram_prof_report.c
+ *
+ * Usage:
+ *   ram_prof_report [--raw] log
+ *
+ *   The log lines used are, everything else is ignored (../inc/ram_prof.h):
+ *     prof begin <core clock Hz> <flash wait states> <overhead cycles>
+ *     prof <name> <flash|ram> <warm|cold> <calls> <cycles> <min> <max>
+ *     prof end
+ *
+ *   Only the last profile of the log is reported. Lines of the same code,
+ *   placement and cache state are added up, as when the whole image runs
+ *   from RAM.
+ *
+ *   --raw   Keep the call overhead in the results.
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_CODES     32
+#define NAME_SIZE     24
+
+// Placements, in the columns of the report
+enum {
+  PLACE_FLASH,
+  PLACE_RAM,
+  PLACES
+};
+
+typedef struct {
+  bool valid;
+  uint32_t calls;
+  double totalCycles;
+  double meanCycles;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+} placement_result_t;
+
+typedef struct {
+  char name[NAME_SIZE];
+  bool cold;
+  placement_result_t results[PLACES];
+} code_result_t;
+
+static code_result_t codes[MAX_CODES];
+static uint32_t codeCount;
+
+/***************************************************************************//**
+ * Find a code by name and cache state, adding it if needed.
+ ******************************************************************************/
+static code_result_t *code_get(const char *name, bool cold)
+{
+  for (uint32_t i = 0; i < codeCount; i++) {
+    if ((strcmp(codes[i].name, name) == 0) && (codes[i].cold == cold)) {
+      return &codes[i];
+    }
+  }
+  if (codeCount == MAX_CODES) {
+    return NULL;
+  }
+  memset(&codes[codeCount], 0, sizeof(codes[codeCount]));
+  snprintf(codes[codeCount].name, NAME_SIZE, "%s", name);
+  codes[codeCount].cold = cold;
+  return &codes[codeCount++];
+}
+
+/***************************************************************************//**
+ * Cycles less the overhead, not below 0.
+ ******************************************************************************/
+static uint32_t cycles_net(uint32_t cycles, uint32_t overhead)
+{
+  return (cycles > overhead) ? cycles - overhead : 0;
+}
+
+/***************************************************************************//**
+ * Print the mean, min and max of one placement, or blanks.
+ ******************************************************************************/
+static void result_print(const placement_result_t *result, uint32_t clockHz)
+{
+  if (!result->valid) {
+    printf(" %34s", "-");
+    return;
+  }
+  printf(" %8.1f %8.2f us %5u..%-5u", result->meanCycles,
+         result->meanCycles * 1e6 / clockHz, result->minCycles,
+         result->maxCycles);
+}
+
+int main(int argc, char **argv)
+{
+  const char *path = NULL;
+  bool raw = false, ended = false;
+  uint32_t clockHz = 0, waitStates = 0, overhead = 0;
+  char line[256], name[NAME_SIZE], place[8], cache[8];
+  unsigned long a, b, c, d;
+  code_result_t *code;
+  placement_result_t *result;
+  FILE *file;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--raw") == 0) {
+      raw = true;
+    } else if (path == NULL) {
+      path = argv[i];
+    } else {
+      path = NULL;
+      break;
+    }
+  }
+  if (path == NULL) {
+    fprintf(stderr, "usage: %s [--raw] log\n", argv[0]);
+    return 2;
+  }
+
+  file = fopen(path, "r");
+  if (file == NULL) {
+    fprintf(stderr, "cannot read %s\n", path);
+    return 1;
+  }
+  while (fgets(line, sizeof(line), file) != NULL) {
+    if (sscanf(line, "prof begin %lu %lu %lu", &a, &b, &c) == 3) {
+      // A new profile, after a reset of the device
+      clockHz = (uint32_t)a;
+      waitStates = (uint32_t)b;
+      overhead = (uint32_t)c;
+      codeCount = 0;
+      ended = false;
+    } else if (strncmp(line, "prof end", 8) == 0) {
+      ended = true;
+    } else if (sscanf(line, "prof %23s %7s %7s %lu %lu %lu %lu", name, place,
+                      cache, &a, &b, &c, &d) == 7) {
+      code = code_get(name, strcmp(cache, "cold") == 0);
+      if (code == NULL) {
+        fprintf(stderr, "more than %d codes\n", MAX_CODES);
+        fclose(file);
+        return 1;
+      }
+      if ((a == 0) || (strcmp(place, "flash") && strcmp(place, "ram"))) {
+        continue;
+      }
+      result = &code->results[strcmp(place, "ram") ? PLACE_FLASH : PLACE_RAM];
+      if (!result->valid) {
+        result->valid = true;
+        result->minCycles = UINT32_MAX;
+      }
+      // With the whole image in RAM, both copies of a code are in RAM
+      result->calls += (uint32_t)a;
+      result->totalCycles += (double)b;
+      result->meanCycles = result->totalCycles / result->calls;
+      if (c < result->minCycles) {
+        result->minCycles = (uint32_t)c;
+      }
+      if (d > result->maxCycles) {
+        result->maxCycles = (uint32_t)d;
+      }
+    }
+  }
+  fclose(file);
+
+  if ((clockHz == 0) || (codeCount == 0)) {
+    fprintf(stderr, "no profile in %s\n", path);
+    return 1;
+  }
+  if (!ended) {
+    fprintf(stderr, "warning: the last profile is not complete\n");
+  }
+
+  printf("core clock %u Hz, flash wait states %u, call overhead %u cycles%s"
+         "\n\n", clockHz, waitStates, overhead, raw ? " (included)" : "");
+  printf("%-12s %-5s %34s %34s %9s\n", "code", "cache",
+         "flash cycles, time, min..max", "ram cycles, time, min..max",
+         "ram gain");
+
+  for (uint32_t i = 0; i < codeCount; i++) {
+    code = &codes[i];
+    if (!raw) {
+      for (uint32_t p = 0; p < PLACES; p++) {
+        result = &code->results[p];
+        result->meanCycles = (result->meanCycles > overhead)
+                             ? result->meanCycles - overhead : 0;
+        result->minCycles = cycles_net(result->minCycles, overhead);
+        result->maxCycles = cycles_net(result->maxCycles, overhead);
+      }
+    }
+
+    printf("%-12s %-5s", code->name, code->cold ? "cold" : "warm");
+    result_print(&code->results[PLACE_FLASH], clockHz);
+    result_print(&code->results[PLACE_RAM], clockHz);
+    if (code->results[PLACE_FLASH].valid && code->results[PLACE_RAM].valid
+        && (code->results[PLACE_FLASH].meanCycles > 0)) {
+      // Positive when RAM is faster
+      printf(" %+8.1f%%", 100.0 * (code->results[PLACE_FLASH].meanCycles
+                                   - code->results[PLACE_RAM].meanCycles)
+             / code->results[PLACE_FLASH].meanCycles);
+    }
+    printf("\n");
+  }
+  return 0;
+}
@@ -39,7 +39,6 @@
  ******************************************************************************/
 #include <stdlib.h>
 #include <stdio.h>
-#include "em_emu.h"
 
 #include "qi.h"
 
@@ -47,124 +46,150 @@
 //                                   Defines
 // -----------------------------------------------------------------------------
 
-#define MSG_BUFSIZE 32
+#define MSG_MAXLEN              32
+
+// one byte is 11 bits (start, 8 data, parity, stop), each bit is 2 SPI bits
+#define QI_FRAME_BITS           (2 * 11)
+#define QI_FRAME_MASK           ((1UL << QI_FRAME_BITS) - 1)
+
+// preamble bits are ones, coded as "10" each
+#define QI_PREAMBLE_PATTERN     0xAAAAAAUL
+#define QI_PREAMBLE_CHUNK       12
 
 // -----------------------------------------------------------------------------
-//                            Local function prototypes
+//                                Local types
 // -----------------------------------------------------------------------------
 
-static qi_status_t qi_create_packet(uint16_t *buffer,
-                                    const qi_message_t *message);
+// Output stream, collecting SPI bits until a whole byte can be written.
+typedef struct {
+  uint8_t *out;
+  uint16_t index;   // next byte to write in out
+  uint32_t bits;    // pending bits, the last one in bit 0
+  uint8_t count;    // number of pending bits, less than 8 between calls
+} qi_spi_stream_t;
 
-static qi_status_t qi_add_to_spi_stream(uint8_t *out,
-                                        uint8_t *curbyte,
-                                        uint8_t *curbit,
-                                        const uint16_t in,
-                                        uint16_t len);
+// -----------------------------------------------------------------------------
+//                            Local variables
+// -----------------------------------------------------------------------------
 
-static uint16_t qi_code_byte(uint8_t);
+/* SPI bits of every byte value, coded as per QI spec: the 11-bit word of
+ * par 3.3 (start bit, data LSB first, odd parity, stop bit) in differential
+ * bi-phase, MSB first, for a stream that is at low level before the word.
+ * For a stream at high level every bit is inverted. Bit 0 is the level at
+ * the end of the word.
+ */
+static const uint32_t qi_frame_bits[256] = {
+  0x333335, 0x34CCCD, 0x32CCCD, 0x353335,
+  0x334CCD, 0x34B335, 0x32B335, 0x354CCD,
+  0x332CCD, 0x34D335, 0x32D335, 0x352CCD,
+  0x335335, 0x34ACCD, 0x32ACCD, 0x355335,
+  0x3334CD, 0x34CB35, 0x32CB35, 0x3534CD,
+  0x334B35, 0x34B4CD, 0x32B4CD, 0x354B35,
+  0x332B35, 0x34D4CD, 0x32D4CD, 0x352B35,
+  0x3354CD, 0x34AB35, 0x32AB35, 0x3554CD,
+  0x3332CD, 0x34CD35, 0x32CD35, 0x3532CD,
+  0x334D35, 0x34B2CD, 0x32B2CD, 0x354D35,
+  0x332D35, 0x34D2CD, 0x32D2CD, 0x352D35,
+  0x3352CD, 0x34AD35, 0x32AD35, 0x3552CD,
+  0x333535, 0x34CACD, 0x32CACD, 0x353535,
+  0x334ACD, 0x34B535, 0x32B535, 0x354ACD,
+  0x332ACD, 0x34D535, 0x32D535, 0x352ACD,
+  0x335535, 0x34AACD, 0x32AACD, 0x355535,
+  0x33334D, 0x34CCB5, 0x32CCB5, 0x35334D,
+  0x334CB5, 0x34B34D, 0x32B34D, 0x354CB5,
+  0x332CB5, 0x34D34D, 0x32D34D, 0x352CB5,
+  0x33534D, 0x34ACB5, 0x32ACB5, 0x35534D,
+  0x3334B5, 0x34CB4D, 0x32CB4D, 0x3534B5,
+  0x334B4D, 0x34B4B5, 0x32B4B5, 0x354B4D,
+  0x332B4D, 0x34D4B5, 0x32D4B5, 0x352B4D,
+  0x3354B5, 0x34AB4D, 0x32AB4D, 0x3554B5,
+  0x3332B5, 0x34CD4D, 0x32CD4D, 0x3532B5,
+  0x334D4D, 0x34B2B5, 0x32B2B5, 0x354D4D,
+  0x332D4D, 0x34D2B5, 0x32D2B5, 0x352D4D,
+  0x3352B5, 0x34AD4D, 0x32AD4D, 0x3552B5,
+  0x33354D, 0x34CAB5, 0x32CAB5, 0x35354D,
+  0x334AB5, 0x34B54D, 0x32B54D, 0x354AB5,
+  0x332AB5, 0x34D54D, 0x32D54D, 0x352AB5,
+  0x33554D, 0x34AAB5, 0x32AAB5, 0x35554D,
+  0x33332D, 0x34CCD5, 0x32CCD5, 0x35332D,
+  0x334CD5, 0x34B32D, 0x32B32D, 0x354CD5,
+  0x332CD5, 0x34D32D, 0x32D32D, 0x352CD5,
+  0x33532D, 0x34ACD5, 0x32ACD5, 0x35532D,
+  0x3334D5, 0x34CB2D, 0x32CB2D, 0x3534D5,
+  0x334B2D, 0x34B4D5, 0x32B4D5, 0x354B2D,
+  0x332B2D, 0x34D4D5, 0x32D4D5, 0x352B2D,
+  0x3354D5, 0x34AB2D, 0x32AB2D, 0x3554D5,
+  0x3332D5, 0x34CD2D, 0x32CD2D, 0x3532D5,
+  0x334D2D, 0x34B2D5, 0x32B2D5, 0x354D2D,
+  0x332D2D, 0x34D2D5, 0x32D2D5, 0x352D2D,
+  0x3352D5, 0x34AD2D, 0x32AD2D, 0x3552D5,
+  0x33352D, 0x34CAD5, 0x32CAD5, 0x35352D,
+  0x334AD5, 0x34B52D, 0x32B52D, 0x354AD5,
+  0x332AD5, 0x34D52D, 0x32D52D, 0x352AD5,
+  0x33552D, 0x34AAD5, 0x32AAD5, 0x35552D,
+  0x333355, 0x34CCAD, 0x32CCAD, 0x353355,
+  0x334CAD, 0x34B355, 0x32B355, 0x354CAD,
+  0x332CAD, 0x34D355, 0x32D355, 0x352CAD,
+  0x335355, 0x34ACAD, 0x32ACAD, 0x355355,
+  0x3334AD, 0x34CB55, 0x32CB55, 0x3534AD,
+  0x334B55, 0x34B4AD, 0x32B4AD, 0x354B55,
+  0x332B55, 0x34D4AD, 0x32D4AD, 0x352B55,
+  0x3354AD, 0x34AB55, 0x32AB55, 0x3554AD,
+  0x3332AD, 0x34CD55, 0x32CD55, 0x3532AD,
+  0x334D55, 0x34B2AD, 0x32B2AD, 0x354D55,
+  0x332D55, 0x34D2AD, 0x32D2AD, 0x352D55,
+  0x3352AD, 0x34AD55, 0x32AD55, 0x3552AD,
+  0x333555, 0x34CAAD, 0x32CAAD, 0x353555,
+  0x334AAD, 0x34B555, 0x32B555, 0x354AAD,
+  0x332AAD, 0x34D555, 0x32D555, 0x352AAD,
+  0x335555, 0x34AAAD, 0x32AAAD, 0x355555
+};
 
 // -----------------------------------------------------------------------------
-//                            Local functions
+//                            Local function prototypes
 // -----------------------------------------------------------------------------
 
-/**************************************************************************//**
- * This function takes the QI header + message and creates a full QI data packet
- * structure as per Qi-v1.3-comms-physical.pdf par 3.4 adding checksum and will
- * code it as bit array representing the byte encoded words by adding start bit,
- * parity bit and stop bit for each byte from the data packet.
- *
- * The result is returned in a uint16_t buffer array which has
- * message->msglen + 2 elements due to adding header and checksum.
- *****************************************************************************/
-static qi_status_t qi_create_packet(uint16_t *buffer,
-                                    const qi_message_t *message)
-{
-  uint8_t curbyte = 0;
-  uint8_t chksum = 0;
-  uint8_t len = message->msglen;
-
-  if ((buffer == NULL) || (message == NULL)) {
-    return (QI_ERR_PARAM);
-  }
+static inline void qi_put_bits(qi_spi_stream_t *stream,
+                               uint32_t bits,
+                               uint8_t count);
 
-  // add all bytes, we will maintain checksum along the way
-  // start by adding the header
-  buffer[curbyte++] = qi_code_byte(message->header);
-  chksum ^= message->header;
-  // add payload
-  for (int i = 0; i < len; i++) {
-    buffer[curbyte++] = qi_code_byte(message->message[i]);
-    chksum ^= message->message[i];
-  }
-  // add checksum
-  buffer[curbyte] = qi_code_byte(chksum);
+static inline uint32_t qi_put_byte(qi_spi_stream_t *stream,
+                                   uint8_t u8data,
+                                   uint32_t level);
 
-  return (QI_OK);
-}
+// -----------------------------------------------------------------------------
+//                            Local functions
+// -----------------------------------------------------------------------------
 
 /**************************************************************************//**
- * This function adds the <len> LSbits of <in> to <out> starting at
- * <curbyte>:<curbit>, coded as per QI spec.
+ * This function adds the <count> (max 24) LSbits of <bits> to the stream and
+ * writes every completed byte to the output buffer.
  *****************************************************************************/
-static qi_status_t qi_add_to_spi_stream(uint8_t *out,
-                                        uint8_t *curbyte,
-                                        uint8_t *curbit,
-                                        const uint16_t in,
-                                        uint16_t len)
+static inline void qi_put_bits(qi_spi_stream_t *stream,
+                               uint32_t bits,
+                               uint8_t count)
 {
-  uint8_t cby = *curbyte; // set start byte
-  uint8_t cbi = *curbit;  // set start bit
-
-  // check for validity of input to prevent memory corruption
-  if ((out == NULL) || (len <= 0)) {
-    return (QI_ERR_PARAM);
+  stream->bits = (stream->bits << count) | bits;
+  stream->count += count;
+  while (stream->count >= 8) {
+    stream->count -= 8;
+    stream->out[stream->index++] = (uint8_t)(stream->bits >> stream->count);
   }
-
-  for (int i = len - 1; i >= 0; i--) {
-    out[cby] |= ((in & (0x0001 << i)) ? (1 << cbi) : 0);
-    if (cbi == 0) {
-      cbi = 7;
-      cby++;
-    } else {
-      cbi--;
-    }
-  }
-  *curbyte = cby;
-  *curbit = cbi;
-  return (QI_OK);
 }
 
 /**************************************************************************//**
- * This function performs the Byte encoding scheme as specified in par 3.3 of
- * the QI-v1.3-comms-physical.pdf.
+ * This function adds one byte of a data packet to the stream, coded as per QI
+ * spec. <level> is 0 if the stream is at low level, QI_FRAME_MASK if it is
+ * at high level. Returns the level after the byte in the same format.
  *****************************************************************************/
-static uint16_t qi_code_byte(uint8_t u8data)
+static inline uint32_t qi_put_byte(qi_spi_stream_t *stream,
+                                   uint8_t u8data,
+                                   uint32_t level)
 {
-  uint8_t parity = 0;
-  // init "result" with start bit zero
-  uint16_t result = 0;
-
-  // next we need to shift the u8Data with LSB first
-  // (see Qi-v1.3-comms-physical.pdf, par 3.3 fig 8)
-  // we will keep track of parity along the way
-  for (int i = 0; i < 8; i++) {
-    result <<= 1;
-    if (u8data & (1 << i)) {
-      result++; // add a 1
-      parity++; // update parity
-    }
-  }
-
-  // add parity bit
-  result <<= 1;
-  result += ((parity & 0x1) ? 0 : 1);
-
-  // add stop bit
-  result <<= 1;
-  result++;
+  uint32_t bits = qi_frame_bits[u8data] ^ level;
 
-  return (result);
+  qi_put_bits(stream, bits, QI_FRAME_BITS);
+  return (bits & 0x1) ? QI_FRAME_MASK : 0;
 }
 
 // -----------------------------------------------------------------------------
@@ -178,65 +203,65 @@ qi_status_t qi_create_spi_stream_buffer(uint8_t *outbuffer,
                                         uint16_t *index,
                                         const qi_message_t *qi_message)
 {
-  qi_status_t qi_status = QI_OK;
-  uint8_t curbyte = *index; // continue in case of multiple calls
-  uint8_t curbit = 7;
-  uint8_t last_level;
-  uint16_t bitbuf;
-  uint16_t msgbuf[MSG_BUFSIZE]; // use fixed length buffer, to be optimized
+  qi_spi_stream_t stream;
+  uint32_t level;
+  uint8_t chksum;
+  uint8_t preamble;
 
-  if ((outbuffer == NULL) || (qi_message == NULL)
-      || (qi_message->msglen > MSG_BUFSIZE)) {
+  if ((outbuffer == NULL) || (index == NULL) || (qi_message == NULL)
+      || (qi_message->msglen > MSG_MAXLEN)) {
     return (QI_ERR_PARAM);
   }
 
+  // every message starts on a byte boundary, continue in case of multiple
+  // calls
+  stream.out = outbuffer;
+  stream.index = *index;
+  stream.bits = 0;
+  stream.count = 0;
+
   // we use 8 bits transfer in SPI at 4kHz transfer rate
   // start with pre delay in ms
-  // we need to add 4 "1" bits per ms
-  bitbuf = 0x000f;
-  for (uint8_t i = 0; i < (qi_message->pre_delay); i++) {
-    qi_status = qi_add_to_spi_stream(outbuffer, &curbyte, &curbit, bitbuf, 4);
-    EFM_ASSERT(qi_status == QI_OK);
+  // we need to add 4 "1" bits per ms, so two ms are a whole byte
+  for (uint16_t i = 0; i < (qi_message->pre_delay / 2); i++) {
+    stream.out[stream.index++] = 0xFF;
+  }
+  if (qi_message->pre_delay & 0x1) {
+    qi_put_bits(&stream, 0xF, 4);
   }
 
   // preamble: add 10 sequence per preamble bit
-  bitbuf = 0x0002;
-  for (int i = 0; i < qi_message->preamble_bits; i++) {
-    qi_status = qi_add_to_spi_stream(outbuffer, &curbyte, &curbit, bitbuf, 2);
-    EFM_ASSERT(qi_status == QI_OK);
+  preamble = qi_message->preamble_bits;
+  while (preamble > QI_PREAMBLE_CHUNK) {
+    qi_put_bits(&stream, QI_PREAMBLE_PATTERN, 2 * QI_PREAMBLE_CHUNK);
+    preamble -= QI_PREAMBLE_CHUNK;
   }
-  last_level = 0;
+  if (preamble > 0) {
+    qi_put_bits(&stream,
+                QI_PREAMBLE_PATTERN >> (2 * (QI_PREAMBLE_CHUNK - preamble)),
+                2 * preamble);
+  }
+  level = 0;
 
-  // now code the message first
-  qi_status = qi_create_packet(msgbuf, qi_message);
-  EFM_ASSERT(qi_status == QI_OK);
-  // add every bit to the outbuffer
-  for (int i = 0; i < qi_message->msglen + 2; i++) {
-    for (int j = 10; j >= 0; j--) {
-      if (msgbuf[i] & (1 << j)) {
-        // bit is a 1 so change
-        bitbuf = (last_level ? 0x1 : 0x2);
-      } else {
-        bitbuf = (last_level ? 0x0 : 0x3);
-        last_level = (last_level ? 0 : 1);
-      }
-      qi_status = qi_add_to_spi_stream(outbuffer, &curbyte, &curbit, bitbuf, 2);
-      EFM_ASSERT(qi_status == QI_OK);
-    }
+  // data packet as per Qi-v1.3-comms-physical.pdf par 3.4: header, message
+  // and checksum, we will maintain checksum along the way
+  level = qi_put_byte(&stream, qi_message->header, level);
+  chksum = qi_message->header;
+  for (int i = 0; i < qi_message->msglen; i++) {
+    level = qi_put_byte(&stream, qi_message->message[i], level);
+    chksum ^= qi_message->message[i];
   }
+  level = qi_put_byte(&stream, chksum, level);
 
-  if ((curbit != 7) || (last_level != 1)) {
+  if ((stream.count != 0) || (level == 0)) {
     // we want to be sure to end with high level so add 1s until the end
-    bitbuf = 0x0001;
-    for (int i = curbit; i >= 0; i--) {
-      qi_status = qi_add_to_spi_stream(outbuffer, &curbyte, &curbit, bitbuf, 1);
-      EFM_ASSERT(qi_status == QI_OK);
-    }
-    curbyte++;
+    // of the byte, followed by one byte at low level
+    qi_put_bits(&stream, 0xFF >> stream.count, 8 - stream.count);
+    stream.out[stream.index++] = 0x00;
   }
 
   // after this index is pointing to first non used byte
-  *index = curbyte;
+  *index = stream.index;
 
   return QI_OK;
 }
@@ -72,6 +72,14 @@ typedef struct {
   uint8_t              message[];      // message
 } qi_message_t;
 
+// Worst case number of SPI stream bytes qi_create_spi_stream_buffer() adds
+// for a message, usable to size buffers of fixed messages at compile time:
+// 4 bits per ms of pre-delay, 2 bits per preamble bit, 22 bits per byte of
+// header, message and checksum, plus up to one byte to end at high level and
+// the low level byte after it.
+#define QI_SPI_STREAM_SIZE(pre_delay, preamble_bits, msglen) \
+  (((4 * (pre_delay)) + (2 * (preamble_bits)) + (22 * ((msglen) + 2))) / 8 + 2)
+
 /**************************************************************************//**
  * Creates SPI stream from a Qi message and adds it to a buffer.
  *
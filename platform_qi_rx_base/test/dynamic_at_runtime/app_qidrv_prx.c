@@ -174,7 +174,7 @@ static volatile uint8_t qi_step = 0;
 static uint8_t tx_buffer[QI_TX_BUFFER_SIZE];
 
 #if (QI_GENERATE_CODE)
-uint8_t temp_buffer[QI_TX_BUFFER_SIZE];
+uint8_t temp_buffer[QI_SPI_STREAM_SIZE(QI_CE_INTERVAL, QI_PREAMBLE_BITS, 1)];
 #endif
 
 // -----------------------------------------------------------------------------
@@ -291,7 +291,7 @@ void qi_drv_app_process_action(void)
                                                   &qi_predelay_control_error_message);
           EFM_ASSERT(qi_status == QI_OK);
           qi_generate_c_code("QI_control_error_PREDELAY",
-                             emp_buffer,
+                             temp_buffer,
                              temp_index);
         }
 #endif
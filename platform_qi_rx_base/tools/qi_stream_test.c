@@ -0,0 +1,386 @@
+/***************************************************************************//**
+ * @file
+ * @brief Equivalence test and cycle benchmark of the Qi SPI stream builder
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ *******************************************************************************
+ *
+ * Compares qi_create_spi_stream_buffer() of ../src/qi.c with the bit by bit
+ * builder it replaced, kept below as it was apart from the old_ prefix, on
+ * random messages concatenated into one zeroed buffer. Both outputs and the
+ * returned indexes have to be identical, including the low level byte after
+ * a message that did not end byte aligned at high level. Then prints the
+ * cycles per message of both.
+ *
+ * The old builder keeps the stream index in 8 bits, overflows its packet
+ * buffer above 30 message bytes and loops forever above 255 ms pre-delay, so
+ * the messages are kept within those limits.
+ *
+ * Build, from the project directory:
+ *   cc -O2 -Wall -Wextra -Isrc -o qi_stream_test tools/qi_stream_test.c \
+ *      src/qi.c
+ *
+ * Usage:
+ *   ./qi_stream_test [streams]
+ ******************************************************************************/
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "qi.h"
+
+#define EFM_ASSERT(expr)            assert(expr)
+
+#define STREAM_SIZE                 256
+#define MAX_MSGLEN                  30
+#define MAX_PRE_DELAY               100
+#define BENCH_MESSAGES              200000
+
+// -----------------------------------------------------------------------------
+//                          Old builder, as it was
+// -----------------------------------------------------------------------------
+
+#define MSG_BUFSIZE 32
+
+static qi_status_t old_qi_create_packet(uint16_t *buffer,
+                                        const qi_message_t *message);
+
+static qi_status_t old_qi_add_to_spi_stream(uint8_t *out,
+                                            uint8_t *curbyte,
+                                            uint8_t *curbit,
+                                            const uint16_t in,
+                                            uint16_t len);
+
+static uint16_t old_qi_code_byte(uint8_t);
+
+/**************************************************************************//**
+ * This function takes the QI header + message and creates a full QI data packet
+ * structure as per Qi-v1.3-comms-physical.pdf par 3.4 adding checksum and will
+ * code it as bit array representing the byte encoded words by adding start bit,
+ * parity bit and stop bit for each byte from the data packet.
+ *
+ * The result is returned in a uint16_t buffer array which has
+ * message->msglen + 2 elements due to adding header and checksum.
+ *****************************************************************************/
+static qi_status_t old_qi_create_packet(uint16_t *buffer,
+                                        const qi_message_t *message)
+{
+  uint8_t curbyte = 0;
+  uint8_t chksum = 0;
+  uint8_t len = message->msglen;
+
+  if ((buffer == NULL) || (message == NULL)) {
+    return (QI_ERR_PARAM);
+  }
+
+  // add all bytes, we will maintain checksum along the way
+  // start by adding the header
+  buffer[curbyte++] = old_qi_code_byte(message->header);
+  chksum ^= message->header;
+  // add payload
+  for (int i = 0; i < len; i++) {
+    buffer[curbyte++] = old_qi_code_byte(message->message[i]);
+    chksum ^= message->message[i];
+  }
+  // add checksum
+  buffer[curbyte] = old_qi_code_byte(chksum);
+
+  return (QI_OK);
+}
+
+/**************************************************************************//**
+ * This function adds the <len> LSbits of <in> to <out> starting at
+ * <curbyte>:<curbit>, coded as per QI spec.
+ *****************************************************************************/
+static qi_status_t old_qi_add_to_spi_stream(uint8_t *out,
+                                            uint8_t *curbyte,
+                                            uint8_t *curbit,
+                                            const uint16_t in,
+                                            uint16_t len)
+{
+  uint8_t cby = *curbyte; // set start byte
+  uint8_t cbi = *curbit;  // set start bit
+
+  // check for validity of input to prevent memory corruption
+  if ((out == NULL) || (len <= 0)) {
+    return (QI_ERR_PARAM);
+  }
+
+  for (int i = len - 1; i >= 0; i--) {
+    out[cby] |= ((in & (0x0001 << i)) ? (1 << cbi) : 0);
+    if (cbi == 0) {
+      cbi = 7;
+      cby++;
+    } else {
+      cbi--;
+    }
+  }
+  *curbyte = cby;
+  *curbit = cbi;
+  return (QI_OK);
+}
+
+/**************************************************************************//**
+ * This function performs the Byte encoding scheme as specified in par 3.3 of
+ * the QI-v1.3-comms-physical.pdf.
+ *****************************************************************************/
+static uint16_t old_qi_code_byte(uint8_t u8data)
+{
+  uint8_t parity = 0;
+  // init "result" with start bit zero
+  uint16_t result = 0;
+
+  // next we need to shift the u8Data with LSB first
+  // (see Qi-v1.3-comms-physical.pdf, par 3.3 fig 8)
+  // we will keep track of parity along the way
+  for (int i = 0; i < 8; i++) {
+    result <<= 1;
+    if (u8data & (1 << i)) {
+      result++; // add a 1
+      parity++; // update parity
+    }
+  }
+
+  // add parity bit
+  result <<= 1;
+  result += ((parity & 0x1) ? 0 : 1);
+
+  // add stop bit
+  result <<= 1;
+  result++;
+
+  return (result);
+}
+
+/**************************************************************************//**
+ * Creates SPI stream from a Qi message and adds it to a buffer
+ *****************************************************************************/
+static qi_status_t
+old_qi_create_spi_stream_buffer(uint8_t *outbuffer,
+                                uint16_t *index,
+                                const qi_message_t *qi_message)
+{
+  qi_status_t qi_status = QI_OK;
+  uint8_t curbyte = *index; // continue in case of multiple calls
+  uint8_t curbit = 7;
+  uint8_t last_level;
+  uint16_t bitbuf;
+  uint16_t msgbuf[MSG_BUFSIZE]; // use fixed length buffer, to be optimized
+
+  if ((outbuffer == NULL) || (qi_message == NULL)
+      || (qi_message->msglen > MSG_BUFSIZE)) {
+    return (QI_ERR_PARAM);
+  }
+
+  // we use 8 bits transfer in SPI at 4kHz transfer rate
+  // start with pre delay in ms
+  // we need to add 4 "1" bits per ms
+  bitbuf = 0x000f;
+  for (uint8_t i = 0; i < (qi_message->pre_delay); i++) {
+    qi_status = old_qi_add_to_spi_stream(outbuffer, &curbyte, &curbit,
+                                          bitbuf, 4);
+    EFM_ASSERT(qi_status == QI_OK);
+  }
+
+  // preamble: add 10 sequence per preamble bit
+  bitbuf = 0x0002;
+  for (int i = 0; i < qi_message->preamble_bits; i++) {
+    qi_status = old_qi_add_to_spi_stream(outbuffer, &curbyte, &curbit,
+                                          bitbuf, 2);
+    EFM_ASSERT(qi_status == QI_OK);
+  }
+  last_level = 0;
+
+  // now code the message first
+  qi_status = old_qi_create_packet(msgbuf, qi_message);
+  EFM_ASSERT(qi_status == QI_OK);
+  // add every bit to the outbuffer
+  for (int i = 0; i < qi_message->msglen + 2; i++) {
+    for (int j = 10; j >= 0; j--) {
+      if (msgbuf[i] & (1 << j)) {
+        // bit is a 1 so change
+        bitbuf = (last_level ? 0x1 : 0x2);
+      } else {
+        bitbuf = (last_level ? 0x0 : 0x3);
+        last_level = (last_level ? 0 : 1);
+      }
+      qi_status = old_qi_add_to_spi_stream(outbuffer, &curbyte, &curbit,
+                                            bitbuf, 2);
+      EFM_ASSERT(qi_status == QI_OK);
+    }
+  }
+
+  if ((curbit != 7) || (last_level != 1)) {
+    // we want to be sure to end with high level so add 1s until the end
+    bitbuf = 0x0001;
+    for (int i = curbit; i >= 0; i--) {
+      qi_status = old_qi_add_to_spi_stream(outbuffer, &curbyte, &curbit,
+                                            bitbuf, 1);
+      EFM_ASSERT(qi_status == QI_OK);
+    }
+    curbyte++;
+  }
+
+  // after this index is pointing to first non used byte
+  *index = curbyte;
+
+  return QI_OK;
+}
+
+// -----------------------------------------------------------------------------
+//                                   Tests
+// -----------------------------------------------------------------------------
+
+typedef qi_status_t (*builder_t)(uint8_t *, uint16_t *, const qi_message_t *);
+
+static uint8_t newStream[STREAM_SIZE];
+static uint8_t oldStream[STREAM_SIZE];
+
+/***************************************************************************//**
+ * Fill a message with random content, the given upper limits included.
+ ******************************************************************************/
+static void random_message(qi_message_t *message, uint16_t maxPreDelay,
+                           uint8_t maxMsglen)
+{
+  message->pre_delay = (uint16_t)(rand() % (maxPreDelay + 1));
+  message->preamble_bits = (uint8_t)(11 + rand() % 15);
+  message->header = (qi_ll_prx_header_t)(rand() & 0xFF);
+  message->msglen = (uint8_t)(rand() % (maxMsglen + 1));
+  for (int i = 0; i < message->msglen; i++) {
+    message->message[i] = (uint8_t)rand();
+  }
+}
+
+/***************************************************************************//**
+ * Time calls of a builder, in cycles where the host has a counter.
+ ******************************************************************************/
+static uint64_t now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (uint64_t)time.tv_sec * 1000000000ULL + (uint64_t)time.tv_nsec;
+#endif
+}
+
+static double benchmark(builder_t builder, qi_message_t *const *messages,
+                        int count)
+{
+  uint64_t start, cycles = 0;
+  uint16_t index;
+
+  for (int i = 0; i < BENCH_MESSAGES; i++) {
+    const qi_message_t *message = messages[i % count];
+
+    // The old builder relies on a zeroed buffer, clear it outside the timing
+    memset(newStream, 0, sizeof(newStream));
+    index = 0;
+    start = now();
+    builder(newStream, &index, message);
+    cycles += now() - start;
+  }
+  return (double)cycles / BENCH_MESSAGES;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned long count = (argc > 1) ? strtoul(argv[1], NULL, 0) : 200000;
+  unsigned long mismatches = 0, padded = 0, messages = 0;
+  qi_message_t *message = malloc(sizeof(qi_message_t) + MSG_BUFSIZE);
+  qi_message_t *typical[16];
+
+  srand(1);
+  for (unsigned long test = 0; test < count; test++) {
+    uint16_t newIndex = 0, oldIndex = 0;
+
+    memset(newStream, 0, sizeof(newStream));
+    memset(oldStream, 0, sizeof(oldStream));
+    // Concatenate messages while the largest one still fits
+    while (newIndex + QI_SPI_STREAM_SIZE(MAX_PRE_DELAY, 25, MAX_MSGLEN)
+           < STREAM_SIZE) {
+      random_message(message, MAX_PRE_DELAY, MAX_MSGLEN);
+      if ((qi_create_spi_stream_buffer(newStream, &newIndex, message) != QI_OK)
+          || (old_qi_create_spi_stream_buffer(oldStream, &oldIndex, message)
+              != QI_OK)) {
+        printf("builder failed\n");
+        return 1;
+      }
+      messages++;
+      // The old builder skips a byte after the padding
+      if ((newIndex > 0) && (newStream[newIndex - 1] == 0x00)) {
+        padded++;
+      }
+      if (newIndex != oldIndex) {
+        break;
+      }
+    }
+    if ((newIndex != oldIndex)
+        || (memcmp(newStream, oldStream, sizeof(newStream)) != 0)) {
+      mismatches++;
+    }
+  }
+  printf("%lu streams of %lu messages: %lu mismatches, %.1f%% of the "
+         "messages padded\n\n", count, messages, mismatches,
+         100.0 * padded / messages);
+
+  // Typical messages: no pre-delay, up to 8 message bytes
+  for (int i = 0; i < 16; i++) {
+    typical[i] = malloc(sizeof(qi_message_t) + MSG_BUFSIZE);
+    random_message(typical[i], 0, 8);
+  }
+  double oldCycles = benchmark(old_qi_create_spi_stream_buffer, typical, 16);
+  double newCycles = benchmark(qi_create_spi_stream_buffer, typical, 16);
+#if defined(__x86_64__) || defined(__i386__)
+  const char *unit = "cycles";
+#else
+  const char *unit = "ns";
+#endif
+  printf("%-10s %12s\n", "builder", unit);
+  printf("%-10s %12.1f\n", "old", oldCycles);
+  printf("%-10s %12.1f %.1fx faster\n", "table", newCycles,
+         oldCycles / newCycles);
+
+  for (int i = 0; i < 16; i++) {
+    free(typical[i]);
+  }
+  free(message);
+  printf("%s\n", mismatches ? "FAIL" : "PASS");
+  return mismatches ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+/***************************************************************************//**
+ * @file
+ * @brief Set-associative SPI flash page cache with sequential prefetch
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef SPI_FLASH_CACHE_H
+#define SPI_FLASH_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Cache geometry. The cache holds SETS * WAYS pages of PAGE_SIZE bytes. A
+// flash page can only be held by the ways of set (page % SETS).
+#ifndef SPI_FLASH_CACHE_PAGE_SIZE
+#define SPI_FLASH_CACHE_PAGE_SIZE         256
+#endif
+#ifndef SPI_FLASH_CACHE_SETS
+#define SPI_FLASH_CACHE_SETS              8
+#endif
+#ifndef SPI_FLASH_CACHE_WAYS
+#define SPI_FLASH_CACHE_WAYS              4
+#endif
+
+// Number of reads in a row, each starting where the previous one ended, after
+// which the page following the last read is prefetched.
+#ifndef SPI_FLASH_CACHE_SEQUENTIAL_READS
+#define SPI_FLASH_CACHE_SEQUENTIAL_READS  2
+#endif
+
+/***************************************************************************//**
+ * Read completion callback of the port, see spi_flash_cache_port_t.
+ ******************************************************************************/
+typedef void (*spi_flash_cache_done_t)(void *user);
+
+/***************************************************************************//**
+ * Flash access functions used by the cache.
+ ******************************************************************************/
+typedef struct {
+  // Start reading length bytes at address into buffer and call done(user),
+  // possibly from an interrupt, once they are there. Only one read is
+  // started at a time.
+  bool (*read_start)(uint32_t address,
+                     uint8_t *buffer,
+                     uint32_t length,
+                     spi_flash_cache_done_t done,
+                     void *user);
+  // Called repeatedly while the cache waits for a read, may be NULL.
+  void (*wait)(void);
+  // Flash size in bytes, nothing is prefetched beyond it.
+  uint32_t size;
+} spi_flash_cache_port_t;
+
+/***************************************************************************//**
+ * Cache counters, in pages.
+ ******************************************************************************/
+typedef struct {
+  uint32_t hits;            // Pages found in the cache
+  uint32_t misses;          // Pages read on demand
+  uint32_t prefetches;      // Pages read ahead
+  uint32_t prefetchHits;    // Hits on pages read ahead, counted once each
+  uint32_t stalls;          // Waits for a read already in progress
+  uint32_t evictions;       // Valid pages replaced
+} spi_flash_cache_stats_t;
+
+/***************************************************************************//**
+ * Initialize the cache. All pages are invalid.
+ *
+ * @param[in] port Flash access functions, must stay valid.
+ ******************************************************************************/
+void spi_flash_cache_init(const spi_flash_cache_port_t *port);
+
+/***************************************************************************//**
+ * Read through the cache.
+ *
+ * Missing pages are read on demand. When the reads follow each other through
+ * consecutive addresses, the page after the last one read is prefetched and
+ * the function returns without waiting for it.
+ *
+ * @param[in] address Flash address of the first byte.
+ * @param[out] buffer Destination.
+ * @param[in] length Number of bytes.
+ *
+ * @return False if the port failed to start a read.
+ ******************************************************************************/
+bool spi_flash_cache_read(uint32_t address, uint8_t *buffer, uint32_t length);
+
+/***************************************************************************//**
+ * Drop all cached pages, for instance after the flash was written. Waits for
+ * a prefetch in progress.
+ ******************************************************************************/
+void spi_flash_cache_invalidate(void);
+
+/***************************************************************************//**
+ * Get the cache counters.
+ ******************************************************************************/
+void spi_flash_cache_stats_get(spi_flash_cache_stats_t *stats);
+
+/***************************************************************************//**
+ * Clear the cache counters.
+ ******************************************************************************/
+void spi_flash_cache_stats_clear(void);
+
+#endif // SPI_FLASH_CACHE_H
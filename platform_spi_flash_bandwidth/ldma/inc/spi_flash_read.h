@@ -0,0 +1,104 @@
+/***************************************************************************//**
+ * @file
+ * @brief LDMA driven SPI flash read engine
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef SPI_FLASH_READ_H
+#define SPI_FLASH_READ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// SPI flash pins. MOSI, MISO and CLK are routed to USART2, CS is a GPIO
+// driven by the LDMA.
+#define SPIPORT   gpioPortC
+#define MOSIPIN   0
+#define MISOPIN   1
+#define SCLKPIN   2
+#define CSPORT    gpioPortC
+#define CSPIN     3
+
+// SPI flash commands
+#define M25X_READ       0x03
+#define M25X_FAST_READ  0x0B
+
+// Descriptors available to each LDMA channel for one read. A read uses
+// 2 TX descriptors plus one per 2048 bytes, and 2 RX descriptors plus one per
+// 2048 bytes of each segment.
+#ifndef SPI_FLASH_READ_MAX_DESCRIPTORS
+#define SPI_FLASH_READ_MAX_DESCRIPTORS  16
+#endif
+
+/***************************************************************************//**
+ * Read command. The USART has a single data line in each direction, so the
+ * dual and quad output commands are not available.
+ ******************************************************************************/
+typedef enum {
+  spiFlashRead,       // READ, no dummy byte, up to 50 MHz on M25P40 parts
+  spiFlashFastRead,   // FAST_READ, one dummy byte after the address
+} spi_flash_read_mode_t;
+
+/***************************************************************************//**
+ * One destination buffer of a scatter list.
+ ******************************************************************************/
+typedef struct {
+  uint8_t *buffer;
+  uint32_t length;
+} spi_flash_segment_t;
+
+/***************************************************************************//**
+ * Read completion callback, called from the LDMA interrupt once CS is
+ * deasserted.
+ ******************************************************************************/
+typedef void (*spi_flash_read_callback_t)(void *user);
+
+/***************************************************************************//**
+ * Allocate the LDMA channels of the read engine.
+ *
+ * USART2 and the pins must already be configured for SPI, with CS high.
+ ******************************************************************************/
+void spi_flash_read_init(void);
+
+/***************************************************************************//**
+ * Start a read.
+ *
+ * The whole read, including CS assertion, command, address, dummy byte, data
+ * and CS deassertion, is done by two chained LDMA channels without the CPU.
+ * The segments are filled in order from consecutive flash addresses.
+ *
+ * @param[in] address Flash address of the first byte.
+ * @param[in] segments Scatter list. Only the buffers have to stay valid until
+ *                     the read completes.
+ * @param[in] segmentCount Number of entries in the scatter list.
+ * @param[in] mode Read command.
+ * @param[in] callback Called when the read completes, may be NULL.
+ * @param[in] user Passed to the callback.
+ *
+ * @return False if a read is in progress or the scatter list needs more than
+ *         SPI_FLASH_READ_MAX_DESCRIPTORS descriptors.
+ ******************************************************************************/
+bool spi_flash_read_start(uint32_t address,
+                          const spi_flash_segment_t *segments,
+                          uint32_t segmentCount,
+                          spi_flash_read_mode_t mode,
+                          spi_flash_read_callback_t callback,
+                          void *user);
+
+/***************************************************************************//**
+ * Check whether a read is in progress.
+ ******************************************************************************/
+bool spi_flash_read_busy(void);
+
+#endif // SPI_FLASH_READ_H
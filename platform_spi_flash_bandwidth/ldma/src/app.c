@@ -18,175 +18,131 @@
 /***************************************************************************//**
  * Initialize application.
  ******************************************************************************/
-#include "dmadrv.h"
-#include "em_ldma.h"
 #include "em_usart.h"
 #include "stddef.h"
-#include "sl_sleeptimer.h"
 #include "em_cmu.h"
-#include "em_emu.h"
+#include "em_gpio.h"
 #include "app_log.h"
 
-#define SPIPORT gpioPortC
-#define MOSIPIN   0
-#define MISOPIN   1
-#define SCLKPIN   2
-#define CSPORT    gpioPortC
-#define CSPIN     3
-
-// SPI flash command
-#define M25X_READ 0x03
+#include "spi_flash_read.h"
+#include "spi_flash_cache.h"
 
 // Transfer count
 #define BYTECOUNT 1024
 #define LOOPCOUNT 1024
 
-static unsigned int spiRxChan;
-static unsigned int spiTxChan;
-
-// Block receive completion flag
-static volatile bool rxDone = false;
-static volatile bool txDone = false;
-
-// Dummy buffers for SPI transmit/receive
-static uint8_t dummyOut[1] = { 0x0 };
-static uint8_t dummyIn[BYTECOUNT] = { 0x0 };
-
-// Globals for tick count
-static volatile uint32_t msTicks;
-static uint32_t msTicks_start, msTicks_end;
-
-static sl_sleeptimer_timer_handle_t app_timer;
-
-static LDMA_Descriptor_t ldmaTXdesc;
-static LDMA_TransferCfg_t ldmaTXcfg;
-
-static LDMA_Descriptor_t ldmaRXdesc;
-static LDMA_TransferCfg_t ldmaRXcfg;
-
-
-static void app_timer_callback(sl_sleeptimer_timer_handle_t *timer, void* data);
-static bool dma_rx_callback(unsigned int channel,
-                              unsigned int sequenceNo,
-                              void *userParam);
-static bool dma_tx_callback(unsigned int channel,
-                              unsigned int sequenceNo,
-                              void *userParam);
+// Scatter list length of the scatter benchmark
+#define SEGMENTCOUNT 4
+
+// Idle loop iterations used to measure the cost of one iteration
+#define IDLE_CALIBRATION_LOOPS 100000
+
+// Cache benchmark: groups of small records read at random from a hot area,
+// interleaved with a stream of larger sequential reads.
+#define CACHE_GROUPCOUNT    256
+#define CACHE_RECORDS       8
+#define CACHE_RECORD_MAX    64
+#define CACHE_HOT_BYTES     6144
+#define CACHE_STREAM_READS  8
+#define CACHE_STREAM_BYTES  128
+#define CACHE_STREAM_START  0x40000
+
+// Size of the M25P40 flash
+#define FLASH_SIZE          0x80000
+
+// Read completion flag, set from the LDMA interrupt
+static volatile bool readDone = false;
+
+// Read buffer
+static uint8_t readBuffer[BYTECOUNT];
+
+// Core clock cycles of one idle loop iteration, in 1/256 cycles
+static uint32_t idleLoopCycles;
+
+typedef struct {
+  const char *name;
+  spi_flash_read_mode_t mode;
+  uint32_t segmentCount;
+} benchmark_t;
+
+static const benchmark_t benchmarks[] = {
+  { "READ", spiFlashRead, 1 },
+  { "FAST_READ", spiFlashFastRead, 1 },
+  { "READ scatter", spiFlashRead, SEGMENTCOUNT },
+  { "FAST_READ scatter", spiFlashFastRead, SEGMENTCOUNT },
+};
+
+static void read_callback(void *user);
+static bool cache_read_start(uint32_t address,
+                             uint8_t *buffer,
+                             uint32_t length,
+                             spi_flash_cache_done_t done,
+                             void *user);
+
+static const spi_flash_cache_port_t cachePort = {
+  .read_start = cache_read_start,
+  .wait = NULL,
+  .size = FLASH_SIZE,
+};
 
 /***************************************************************************//**
- * DMA RX complete function.
+ * Read complete callback function.
  ******************************************************************************/
-bool dma_rx_callback(unsigned int channel,
-                              unsigned int sequenceNo,
-                              void *userParam)
+static void read_callback(void *user)
 {
-  (void)channel;
-  (void)sequenceNo;
-  (void)userParam;
-
-  rxDone = true;
+  (void)user;
 
-  return true;
+  readDone = true;
 }
 
 /***************************************************************************//**
- * DMA TX complete callback function.
+ * Cache port: start a FAST_READ of one buffer.
  ******************************************************************************/
-bool dma_tx_callback(unsigned int channel,
-                              unsigned int sequenceNo,
-                              void *userParam)
+static bool cache_read_start(uint32_t address,
+                             uint8_t *buffer,
+                             uint32_t length,
+                             spi_flash_cache_done_t done,
+                             void *user)
 {
-  (void)channel;
-  (void)sequenceNo;
-  (void)userParam;
+  spi_flash_segment_t segment = { buffer, length };
 
-  txDone = true;
-
-  return true;
+  return spi_flash_read_start(address, &segment, 1, spiFlashFastRead,
+                              done, user);
 }
 
 /***************************************************************************//**
- * App timer callback function.
- ******************************************************************************/
-static void app_timer_callback(sl_sleeptimer_timer_handle_t *timer, void* data)
-{
-  (void)timer;
-  (void)data;
-
-  msTicks++;  // Increment milliseconds tick counter
-
-}
-
-/***************************************************************************//**
- * Set start point function.
+ * Spin until done is set or limit iterations have passed.
+ *
+ * The iteration count tells how much of the waiting time the CPU was free:
+ * interrupt handlers running in the meantime reduce it.
  ******************************************************************************/
-void app_time_sync(void)
+static uint32_t idle_spin(const volatile bool *done, uint32_t limit)
 {
-  msTicks_end = msTicks;
+  uint32_t count = 0;
 
-  while(msTicks_end == msTicks);    //msTicks Sync
+  while (!*done && (count < limit)) {
+    count++;
+  }
 
-  msTicks_start = msTicks;
+  return count;
 }
 
 /***************************************************************************//**
- * App DMA initialization function.
+ * App cycle counter initialization function.
  ******************************************************************************/
-void app_dma_init(void)
+void app_cycle_counter_init(void)
 {
-  Ecode_t ecode;
-
-  ecode = DMADRV_Init();
-  if ((ecode != ECODE_OK)
-      && (ecode != ECODE_EMDRV_DMADRV_ALREADY_INITIALIZED)) {
-      app_log("DMA initalized failed!\n");
-    return;
-  }
-  /*
-   * If transmitting an actual block, dummyOut would be replaced with
-   * an array with actual transmit data.  Further, there would be no
-   * need to change the transfer source increment to none.  We'd want
-   * the LDMA to increment the source pointer by one with each byte,
-   * which is the default when the LDMA_DESCRIPTOR_SINGLE_M2P_BYTE()
-   * initializer is used.
-   *
-   * In the case of reading from a SPI flash, ldmaCtrlSrcIncNone is
-   * useful because we just want to pump dummy data into the TX buffer
-   * to clock in the READ data.  Sending the READ command and the
-   * address are done separately.
-   *
-   * It's probably not worth using the LDMA to transfer just those four
-   * bytes, although it can be done with its own descriptor and then
-   * linked to the descriptor that generates the dummy transfers as a
-   * means of using LDMA for the entire READ operation.
-   */
-  ldmaTXdesc = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(dummyOut, &(USART2->TXDATA), BYTECOUNT);
-  ldmaTXdesc.xfer.srcInc = ldmaCtrlSrcIncNone;
-  ldmaTXcfg = (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_USART2_TXBL);
+  bool never = false;
+  uint32_t start;
 
-  /*
-   * This descriptor setup is the reverse of what was used above.
-   * Of course, when reading actual data from the SPI flash, the input
-   * buffer would have some pre-allocated size, and there would be no
-   * reason to change the destination increment to none because
-   * LDMA_DESCRIPTOR_SINGLE_P2M_BYTE() defaults to increment by one for
-   * peripheral to memory byte transfers.
-   */
-  ldmaRXdesc = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_P2M_BYTE(&(USART2->RXDATA), dummyIn, BYTECOUNT);
-  ldmaRXdesc.xfer.dstInc = ldmaCtrlDstIncNone;
-  ldmaRXcfg = (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_USART2_RXDATAV);
-
-  // Allocate DMA channel for TX
-  ecode = DMADRV_AllocateChannel(&spiTxChan, NULL);
-  if (ecode != ECODE_EMDRV_DMADRV_OK) {
-    return;
-  }
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 
-  // Allocate DMA channel for RX
-  ecode = DMADRV_AllocateChannel(&spiRxChan, NULL);
-  if (ecode != ECODE_EMDRV_DMADRV_OK) {
-    return;
-  }
+  start = DWT->CYCCNT;
+  idle_spin(&never, IDLE_CALIBRATION_LOOPS);
+  idleLoopCycles = (uint32_t)((((uint64_t)(DWT->CYCCNT - start)) << 8)
+                              / IDLE_CALIBRATION_LOOPS);
 }
 
 /***************************************************************************//**
@@ -235,54 +191,161 @@ void app_spi_init(void)
 }
 
 /***************************************************************************//**
- * App main task function.
+ * Run one benchmark and display bandwidth, CPU idle time and latency.
  ******************************************************************************/
-void app_main_task(void)
+static void app_benchmark(const benchmark_t *benchmark)
 {
-  int flashAddr = 0, rate;
-  int blkCount = 0;
-
-  sl_sleeptimer_start_periodic_timer_ms(&app_timer,
-                                        1,
-                                        app_timer_callback,
-                                        NULL,
-                                        0,
-                                        0);
-  app_time_sync();
-  USART_Tx(USART2, M25X_READ);
+  spi_flash_segment_t segments[SEGMENTCOUNT];
+  uint32_t segmentLength = BYTECOUNT / benchmark->segmentCount;
+  uint32_t flashAddr = 0;
+  uint32_t coreMHz = SystemCoreClockGet() / 1000000;
+  uint32_t start, cycles, latencyMin = UINT32_MAX, latencyMax = 0;
+  uint64_t total = 0, idle = 0;
+  uint32_t rate, idlePermille, blkCount;
+
   /*
-   * Send bytes 1, 2, and 3 of 32-bit address.  Byte 0 should always
-   * be 0 unless the device in question has a 32-bit address space, in
-   * which case byte 0 needs to be sent, too.
+   * The segments are filled from the end of the buffer towards the
+   * start, so a scatter read lands in the buffer in reverse block
+   * order.
    */
-  USART_Tx(USART2, *((uint8_t *)&flashAddr + 1));
-  USART_Tx(USART2, *((uint8_t *)&flashAddr + 2));
-  USART_Tx(USART2, *((uint8_t *)&flashAddr + 3));
-
-  for (blkCount = LOOPCOUNT; blkCount > 0; blkCount--)
-  {
-    // Set the receive state to not done
-    rxDone = false;
-    txDone = false;
-
-    // Start both channels
-    DMADRV_LdmaStartTransfer(spiTxChan, &ldmaTXcfg, &ldmaTXdesc, dma_tx_callback, NULL);
-    DMADRV_LdmaStartTransfer(spiRxChan, &ldmaRXcfg, &ldmaRXdesc, dma_rx_callback, NULL);
-
-    // Wait in EM1 until all data is received
-    while (!rxDone && !txDone) {
-            EMU_EnterEM1();
+  for (uint32_t i = 0; i < benchmark->segmentCount; i++) {
+    segments[i].buffer = &readBuffer[BYTECOUNT - (i + 1) * segmentLength];
+    segments[i].length = segmentLength;
+  }
+
+  for (blkCount = LOOPCOUNT; blkCount > 0; blkCount--) {
+    readDone = false;
+
+    start = DWT->CYCCNT;
+    if (!spi_flash_read_start(flashAddr,
+                              segments,
+                              benchmark->segmentCount,
+                              benchmark->mode,
+                              read_callback,
+                              NULL)) {
+      app_log("%s: read could not be started\n", benchmark->name);
+      return;
     }
+    /*
+     * A real application would do useful work or enter EM1 here. The
+     * benchmark spins instead to measure how much of the transfer time
+     * the CPU had free.
+     */
+    idle += idle_spin(&readDone, UINT32_MAX);
+    cycles = DWT->CYCCNT - start;
+
+    total += cycles;
+    if (cycles < latencyMin) {
+      latencyMin = cycles;
+    }
+    if (cycles > latencyMax) {
+      latencyMax = cycles;
+    }
+    flashAddr += BYTECOUNT;
   }
 
-  // End timing
-  msTicks_end = msTicks;
-  sl_sleeptimer_stop_timer(&app_timer);
+  // Bandwidth in 10 KB/s (1 KB = 1000 bytes), printed as MB/s
+  rate = (uint32_t)(((uint64_t)LOOPCOUNT * BYTECOUNT * coreMHz * 100)
+                    / total);
+  idlePermille = (uint32_t)(((idle * idleLoopCycles) >> 8) * 1000 / total);
+  if (idlePermille > 1000) {
+    idlePermille = 1000;
+  }
 
-  // Display transfer rate
-  rate = ((LOOPCOUNT * BYTECOUNT) / (msTicks_end - msTicks_start));
+  app_log("%-18s %3u.%02u MB/s, CPU idle %3u.%u %%, "
+          "latency min/avg/max %u/%u/%u us\n",
+          benchmark->name,
+          (unsigned int)(rate / 100), (unsigned int)(rate % 100),
+          (unsigned int)(idlePermille / 10), (unsigned int)(idlePermille % 10),
+          (unsigned int)(latencyMin / coreMHz),
+          (unsigned int)(total / LOOPCOUNT / coreMHz),
+          (unsigned int)(latencyMax / coreMHz));
+}
+
+/***************************************************************************//**
+ * Replay the cache benchmark reads, directly or through the cache.
+ *
+ * @return Core clock cycles spent reading.
+ ******************************************************************************/
+static uint64_t app_cache_replay(bool cached)
+{
+  uint32_t seed = 1, streamAddr = CACHE_STREAM_START;
+  uint32_t address, length, start;
+  uint64_t total = 0;
+  spi_flash_segment_t segment = { readBuffer, 0 };
+
+  for (uint32_t group = 0; group < CACHE_GROUPCOUNT; group++) {
+    for (uint32_t i = 0; i < CACHE_RECORDS + CACHE_STREAM_READS; i++) {
+      if (i < CACHE_RECORDS) {
+        // Numerical Recipes LCG, the same sequence for both runs
+        seed = seed * 1664525 + 1013904223;
+        address = (seed >> 8) % CACHE_HOT_BYTES;
+        length = 8 + (seed >> 26) % (CACHE_RECORD_MAX - 7);
+      } else {
+        address = streamAddr;
+        length = CACHE_STREAM_BYTES;
+        streamAddr += CACHE_STREAM_BYTES;
+      }
+
+      start = DWT->CYCCNT;
+      if (cached) {
+        spi_flash_cache_read(address, readBuffer, length);
+      } else {
+        readDone = false;
+        segment.length = length;
+        spi_flash_read_start(address, &segment, 1, spiFlashFastRead,
+                             read_callback, NULL);
+        while (!readDone) {
+        }
+      }
+      total += DWT->CYCCNT - start;
+    }
+  }
+  return total;
+}
+
+/***************************************************************************//**
+ * Compare small scattered reads with and without the cache.
+ ******************************************************************************/
+static void app_cache_benchmark(void)
+{
+  uint32_t coreMHz = SystemCoreClockGet() / 1000000;
+  uint32_t reads = CACHE_GROUPCOUNT * (CACHE_RECORDS + CACHE_STREAM_READS);
+  uint64_t uncached, cached;
+  spi_flash_cache_stats_t stats;
+  uint32_t lookups, hitPermille;
+
+  spi_flash_cache_init(&cachePort);
+  uncached = app_cache_replay(false);
+  cached = app_cache_replay(true);
+  spi_flash_cache_stats_get(&stats);
+
+  lookups = stats.hits + stats.misses;
+  hitPermille = lookups ? (stats.hits * 1000 / lookups) : 0;
+
+  app_log("\nCache, %u reads: %u page hits, %u misses (%u.%u %%), "
+          "%u prefetched, %u used\n",
+          (unsigned int)reads,
+          (unsigned int)stats.hits, (unsigned int)stats.misses,
+          (unsigned int)(hitPermille / 10), (unsigned int)(hitPermille % 10),
+          (unsigned int)stats.prefetches, (unsigned int)stats.prefetchHits);
+  app_log("Average read latency uncached %u us, cached %u us\n",
+          (unsigned int)(uncached / reads / coreMHz),
+          (unsigned int)(cached / reads / coreMHz));
+}
+
+/***************************************************************************//**
+ * App main task function.
+ ******************************************************************************/
+void app_main_task(void)
+{
+  app_log("%u reads of %u bytes per benchmark\n", LOOPCOUNT, BYTECOUNT);
+
+  for (uint32_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+    app_benchmark(&benchmarks[i]);
+  }
+  app_cache_benchmark();
 
-  app_log("Done: %u bytes in %u ms = %u KB/sec\n", (LOOPCOUNT * BYTECOUNT), (unsigned int)(msTicks_end - msTicks_start), rate);
   app_log("USART2 clock = %u MHz\n", (unsigned int)(CMU_ClockFreqGet(cmuClock_USART2) / 1000000));
   app_log("LDMA clock = %u MHz\n", (unsigned int)(CMU_ClockFreqGet(cmuClock_LDMA) / 1000000));
 
@@ -297,7 +360,8 @@ void app_init(void)
   app_log("\nPlatform - SPI LDMA Throughput Example\n\n");
 
   app_spi_init();
-  app_dma_init();
+  spi_flash_read_init();
+  app_cycle_counter_init();
   app_main_task();
 }
 
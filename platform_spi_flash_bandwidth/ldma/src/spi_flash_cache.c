@@ -0,0 +1,303 @@
+/***************************************************************************//**
+ * @file
+ * @brief Set-associative SPI flash page cache with sequential prefetch
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <stddef.h>
+#include <string.h>
+
+#include "spi_flash_cache.h"
+
+#if (SPI_FLASH_CACHE_SETS & (SPI_FLASH_CACHE_SETS - 1))
+#error "SPI_FLASH_CACHE_SETS must be a power of two"
+#endif
+
+#if (SPI_FLASH_CACHE_PAGE_SIZE & (SPI_FLASH_CACHE_PAGE_SIZE - 1))
+#error "SPI_FLASH_CACHE_PAGE_SIZE must be a power of two"
+#endif
+
+#define SET_MASK  (SPI_FLASH_CACHE_SETS - 1)
+
+// Line states. Only the read completion callback moves a line from
+// LINE_PENDING to LINE_VALID, everything else is done by the reader.
+#define LINE_INVALID  0
+#define LINE_PENDING  1
+#define LINE_VALID    2
+
+typedef struct {
+  uint8_t data[SPI_FLASH_CACHE_PAGE_SIZE];
+  uint32_t page;            // Flash page number
+  uint32_t stamp;           // Access counter value of the last use
+  volatile uint8_t state;
+  bool prefetched;          // Read ahead and not used yet
+} cache_line_t;
+
+static cache_line_t lines[SPI_FLASH_CACHE_SETS][SPI_FLASH_CACHE_WAYS];
+
+static const spi_flash_cache_port_t *cachePort;
+
+// Line of the read in progress, if any
+static cache_line_t *pendingLine = NULL;
+
+// Access counter, the least recently used line has the oldest stamp
+static uint32_t accessCount = 0;
+
+// Sequential stream detection: end address of the last read and number of
+// reads in a row that continued the previous one.
+static uint32_t nextAddress = UINT32_MAX;
+static uint32_t sequentialRun = 0;
+
+static spi_flash_cache_stats_t cacheStats;
+
+/***************************************************************************//**
+ * Read completion callback, possibly called from an interrupt.
+ ******************************************************************************/
+static void line_done(void *user)
+{
+  cache_line_t *line = (cache_line_t *)user;
+
+  line->state = LINE_VALID;
+}
+
+/***************************************************************************//**
+ * Wait for the read in progress, if any.
+ ******************************************************************************/
+static void wait_pending(void)
+{
+  if (pendingLine == NULL) {
+    return;
+  }
+  while (pendingLine->state == LINE_PENDING) {
+    if (cachePort->wait != NULL) {
+      cachePort->wait();
+    }
+  }
+  pendingLine = NULL;
+}
+
+/***************************************************************************//**
+ * Find the line holding a page, valid or being read.
+ ******************************************************************************/
+static cache_line_t *line_find(uint32_t page)
+{
+  cache_line_t *set = lines[page & SET_MASK];
+
+  for (uint32_t way = 0; way < SPI_FLASH_CACHE_WAYS; way++) {
+    if ((set[way].state != LINE_INVALID) && (set[way].page == page)) {
+      return &set[way];
+    }
+  }
+  return NULL;
+}
+
+/***************************************************************************//**
+ * Choose the line of a set to replace: an invalid line if there is one,
+ * otherwise the least recently used one. The line being read is never chosen.
+ ******************************************************************************/
+static cache_line_t *line_victim(uint32_t page)
+{
+  cache_line_t *set = lines[page & SET_MASK];
+  cache_line_t *victim = NULL;
+  uint32_t age, oldest = 0;
+
+  for (uint32_t way = 0; way < SPI_FLASH_CACHE_WAYS; way++) {
+    if (set[way].state == LINE_INVALID) {
+      return &set[way];
+    }
+    if (&set[way] == pendingLine) {
+      continue;
+    }
+    // Ages stay correct when the access counter wraps.
+    age = accessCount - set[way].stamp;
+    if ((victim == NULL) || (age > oldest)) {
+      victim = &set[way];
+      oldest = age;
+    }
+  }
+  if (victim->state == LINE_VALID) {
+    cacheStats.evictions++;
+  }
+  return victim;
+}
+
+/***************************************************************************//**
+ * Start reading a page into a line.
+ ******************************************************************************/
+static bool line_fill(cache_line_t *line, uint32_t page)
+{
+  line->page = page;
+  line->state = LINE_PENDING;
+  pendingLine = line;
+  if (!cachePort->read_start(page * SPI_FLASH_CACHE_PAGE_SIZE,
+                             line->data,
+                             SPI_FLASH_CACHE_PAGE_SIZE,
+                             line_done,
+                             line)) {
+    line->state = LINE_INVALID;
+    pendingLine = NULL;
+    return false;
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * Get the line holding a page, reading the page if needed.
+ ******************************************************************************/
+static cache_line_t *line_get(uint32_t page)
+{
+  cache_line_t *line = line_find(page);
+
+  if (line != NULL) {
+    if (line->state == LINE_PENDING) {
+      // Prefetch still in progress
+      cacheStats.stalls++;
+      wait_pending();
+    }
+    cacheStats.hits++;
+    if (line->prefetched) {
+      line->prefetched = false;
+      cacheStats.prefetchHits++;
+    }
+  } else {
+    if (pendingLine != NULL) {
+      // Only one read at a time, let the prefetch complete first.
+      cacheStats.stalls++;
+      wait_pending();
+    }
+    line = line_victim(page);
+    line->prefetched = false;
+    if (!line_fill(line, page)) {
+      return NULL;
+    }
+    wait_pending();
+    cacheStats.misses++;
+  }
+
+  line->stamp = accessCount++;
+  return line;
+}
+
+/***************************************************************************//**
+ * Start reading a page ahead, unless it is cached or a read is in progress.
+ ******************************************************************************/
+static void prefetch(uint32_t page)
+{
+  cache_line_t *line;
+
+  if ((pendingLine != NULL)
+      || (page >= (cachePort->size / SPI_FLASH_CACHE_PAGE_SIZE))
+      || (line_find(page) != NULL)) {
+    return;
+  }
+
+  line = line_victim(page);
+  line->prefetched = true;
+  // Make the page the most recently used one, so that it stays in the cache
+  // until the reader gets to it.
+  line->stamp = accessCount++;
+  if (line_fill(line, page)) {
+    cacheStats.prefetches++;
+  }
+}
+
+/***************************************************************************//**
+ * Initialize the cache.
+ ******************************************************************************/
+void spi_flash_cache_init(const spi_flash_cache_port_t *port)
+{
+  cachePort = port;
+  pendingLine = NULL;
+  spi_flash_cache_invalidate();
+  spi_flash_cache_stats_clear();
+}
+
+/***************************************************************************//**
+ * Read through the cache.
+ ******************************************************************************/
+bool spi_flash_cache_read(uint32_t address, uint8_t *buffer, uint32_t length)
+{
+  cache_line_t *line;
+  uint32_t page, offset, chunk;
+
+  // Two pages read by one call do not make a stream, only reads continuing
+  // each other do.
+  if (address == nextAddress) {
+    sequentialRun++;
+  } else {
+    sequentialRun = 0;
+  }
+  nextAddress = address + length;
+
+  while (length > 0) {
+    page = address / SPI_FLASH_CACHE_PAGE_SIZE;
+    offset = address % SPI_FLASH_CACHE_PAGE_SIZE;
+    chunk = SPI_FLASH_CACHE_PAGE_SIZE - offset;
+    if (chunk > length) {
+      chunk = length;
+    }
+
+    line = line_get(page);
+    if (line == NULL) {
+      return false;
+    }
+    memcpy(buffer, &line->data[offset], chunk);
+    if ((sequentialRun > 0) && ((offset + chunk) == SPI_FLASH_CACHE_PAGE_SIZE)) {
+      // A stream is done with this page. Make it the least recently used one,
+      // so that streams do not flush the pages other reads keep coming back to.
+      line->stamp = accessCount - (UINT32_MAX >> 1);
+    }
+
+    address += chunk;
+    buffer += chunk;
+    length -= chunk;
+  }
+
+  // The next page is read while the caller works on this data.
+  if ((sequentialRun + 1) >= SPI_FLASH_CACHE_SEQUENTIAL_READS) {
+    prefetch((nextAddress - 1) / SPI_FLASH_CACHE_PAGE_SIZE + 1);
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * Drop all cached pages.
+ ******************************************************************************/
+void spi_flash_cache_invalidate(void)
+{
+  wait_pending();
+  for (uint32_t set = 0; set < SPI_FLASH_CACHE_SETS; set++) {
+    for (uint32_t way = 0; way < SPI_FLASH_CACHE_WAYS; way++) {
+      lines[set][way].state = LINE_INVALID;
+      lines[set][way].prefetched = false;
+    }
+  }
+  nextAddress = UINT32_MAX;
+  sequentialRun = 0;
+}
+
+/***************************************************************************//**
+ * Get the cache counters.
+ ******************************************************************************/
+void spi_flash_cache_stats_get(spi_flash_cache_stats_t *stats)
+{
+  *stats = cacheStats;
+}
+
+/***************************************************************************//**
+ * Clear the cache counters.
+ ******************************************************************************/
+void spi_flash_cache_stats_clear(void)
+{
+  memset(&cacheStats, 0, sizeof(cacheStats));
+}
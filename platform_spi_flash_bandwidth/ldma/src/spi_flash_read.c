@@ -0,0 +1,251 @@
+/***************************************************************************//**
+ * @file
+ * @brief LDMA driven SPI flash read engine
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <stddef.h>
+#include "dmadrv.h"
+#include "em_gpio.h"
+#include "em_ldma.h"
+#include "em_usart.h"
+#include "app_log.h"
+
+#include "spi_flash_read.h"
+
+// Largest transfer count of one descriptor
+#define XFER_MAX  ((_LDMA_CH_CTRL_XFERCNT_MASK >> _LDMA_CH_CTRL_XFERCNT_SHIFT) + 1)
+
+static unsigned int spiRxChan;
+static unsigned int spiTxChan;
+
+static LDMA_TransferCfg_t ldmaTXcfg;
+static LDMA_TransferCfg_t ldmaRXcfg;
+
+/*
+ * Descriptor lists of the current read:
+ *
+ * TX: CS low (WRI) -> command/address/dummy -> dummy bytes ... (no IRQ)
+ * RX: header discard -> segment 0 ... segment n -> CS high (WRI, IRQ)
+ *
+ * CS is released by the RX channel because the last byte is only received
+ * once it has been completely shifted out, while the TX channel is done as
+ * soon as the last byte is in the USART transmit buffer.
+ */
+static LDMA_Descriptor_t ldmaTXdesc[SPI_FLASH_READ_MAX_DESCRIPTORS];
+static LDMA_Descriptor_t ldmaRXdesc[SPI_FLASH_READ_MAX_DESCRIPTORS];
+
+// Command, 24-bit address and optional dummy byte
+static uint8_t header[5];
+
+// Dummy data clocked out during the data phase, and sink for the bytes
+// received during the header
+static uint8_t dummyOut = 0x0;
+static uint8_t dummyIn;
+
+static volatile bool readBusy = false;
+static spi_flash_read_callback_t readCallback;
+static void *readUser;
+
+static bool dma_rx_callback(unsigned int channel,
+                            unsigned int sequenceNo,
+                            void *userParam);
+
+/***************************************************************************//**
+ * DMA RX complete callback function, called once CS is high again.
+ ******************************************************************************/
+static bool dma_rx_callback(unsigned int channel,
+                            unsigned int sequenceNo,
+                            void *userParam)
+{
+  (void)channel;
+  (void)sequenceNo;
+  (void)userParam;
+
+  readBusy = false;
+  if (readCallback != NULL) {
+    readCallback(readUser);
+  }
+
+  return true;
+}
+
+/***************************************************************************//**
+ * Append linked transfers of up to XFER_MAX bytes each, either clocking out
+ * dummy bytes (buffer NULL) or receiving into a buffer.
+ *
+ * @return Number of descriptors used, 0 if the list is too short.
+ ******************************************************************************/
+static uint32_t append_bytes(LDMA_Descriptor_t *desc,
+                             uint32_t free,
+                             uint8_t *buffer,
+                             uint32_t length)
+{
+  uint32_t count = 0;
+  uint32_t chunk;
+
+  while (length > 0) {
+    if (count == free) {
+      return 0;
+    }
+    chunk = (length > XFER_MAX) ? XFER_MAX : length;
+    if (buffer == NULL) {
+      desc[count] = (LDMA_Descriptor_t)
+                    LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(&dummyOut,
+                                                     &(USART2->TXDATA),
+                                                     chunk,
+                                                     1);
+      desc[count].xfer.srcInc = ldmaCtrlSrcIncNone;
+    } else {
+      desc[count] = (LDMA_Descriptor_t)
+                    LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(&(USART2->RXDATA),
+                                                     buffer,
+                                                     chunk,
+                                                     1);
+      buffer += chunk;
+    }
+    desc[count].xfer.doneIfs = 0;
+    count++;
+    length -= chunk;
+  }
+  return count;
+}
+
+/***************************************************************************//**
+ * Allocate the LDMA channels of the read engine.
+ ******************************************************************************/
+void spi_flash_read_init(void)
+{
+  Ecode_t ecode;
+
+  ecode = DMADRV_Init();
+  if ((ecode != ECODE_OK)
+      && (ecode != ECODE_EMDRV_DMADRV_ALREADY_INITIALIZED)) {
+    app_log("DMA initalized failed!\n");
+    return;
+  }
+
+  ldmaTXcfg = (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_USART2_TXBL);
+  ldmaRXcfg = (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_USART2_RXDATAV);
+
+  // Allocate DMA channel for TX
+  ecode = DMADRV_AllocateChannel(&spiTxChan, NULL);
+  if (ecode != ECODE_EMDRV_DMADRV_OK) {
+    return;
+  }
+
+  // Allocate DMA channel for RX
+  ecode = DMADRV_AllocateChannel(&spiRxChan, NULL);
+  if (ecode != ECODE_EMDRV_DMADRV_OK) {
+    return;
+  }
+}
+
+/***************************************************************************//**
+ * Start a read.
+ ******************************************************************************/
+bool spi_flash_read_start(uint32_t address,
+                          const spi_flash_segment_t *segments,
+                          uint32_t segmentCount,
+                          spi_flash_read_mode_t mode,
+                          spi_flash_read_callback_t callback,
+                          void *user)
+{
+  uint32_t headerLength = 4;
+  uint32_t total = 0;
+  uint32_t tx = 0, rx = 0;
+  uint32_t count;
+
+  if (readBusy) {
+    return false;
+  }
+
+  header[0] = (mode == spiFlashFastRead) ? M25X_FAST_READ : M25X_READ;
+  header[1] = (uint8_t)(address >> 16);
+  header[2] = (uint8_t)(address >> 8);
+  header[3] = (uint8_t)address;
+  if (mode == spiFlashFastRead) {
+    header[4] = 0x0;
+    headerLength = 5;
+  }
+
+  // RX: discard the bytes received during the header, then fill the segments
+  ldmaRXdesc[rx] = (LDMA_Descriptor_t)
+                   LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(&(USART2->RXDATA),
+                                                    &dummyIn,
+                                                    headerLength,
+                                                    1);
+  ldmaRXdesc[rx].xfer.dstInc = ldmaCtrlDstIncNone;
+  ldmaRXdesc[rx].xfer.doneIfs = 0;
+  rx++;
+  for (uint32_t i = 0; i < segmentCount; i++) {
+    count = append_bytes(&ldmaRXdesc[rx],
+                         SPI_FLASH_READ_MAX_DESCRIPTORS - 1 - rx,
+                         segments[i].buffer,
+                         segments[i].length);
+    if ((count == 0) && (segments[i].length > 0)) {
+      return false;
+    }
+    rx += count;
+    total += segments[i].length;
+  }
+  // Release CS once the last byte is in, and raise the only interrupt
+  ldmaRXdesc[rx] = (LDMA_Descriptor_t)
+                   LDMA_DESCRIPTOR_SINGLE_WRITE(1UL << CSPIN,
+                                                &(GPIO->P_SET[CSPORT].DOUT));
+  ldmaRXdesc[rx].wri.doneIfs = 1;
+
+  // TX: assert CS, send the header, then clock the data in with dummy bytes
+  ldmaTXdesc[tx] = (LDMA_Descriptor_t)
+                   LDMA_DESCRIPTOR_LINKREL_WRITE(1UL << CSPIN,
+                                                 &(GPIO->P_CLR[CSPORT].DOUT),
+                                                 1);
+  ldmaTXdesc[tx].wri.doneIfs = 0;
+  tx++;
+  ldmaTXdesc[tx] = (LDMA_Descriptor_t)
+                   LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(header,
+                                                    &(USART2->TXDATA),
+                                                    headerLength,
+                                                    1);
+  ldmaTXdesc[tx].xfer.doneIfs = 0;
+  tx++;
+  count = append_bytes(&ldmaTXdesc[tx],
+                       SPI_FLASH_READ_MAX_DESCRIPTORS - tx,
+                       NULL,
+                       total);
+  if ((count == 0) && (total > 0)) {
+    return false;
+  }
+  tx += count;
+  ldmaTXdesc[tx - 1].xfer.link = 0;
+
+  readCallback = callback;
+  readUser = user;
+  readBusy = true;
+
+  // Drop anything left in the USART buffers, then start the receiver first so
+  // that it is ready for the first byte.
+  USART2->CMD = USART_CMD_CLEARRX | USART_CMD_CLEARTX;
+  DMADRV_LdmaStartTransfer(spiRxChan, &ldmaRXcfg, ldmaRXdesc, dma_rx_callback, NULL);
+  DMADRV_LdmaStartTransfer(spiTxChan, &ldmaTXcfg, ldmaTXdesc, NULL, NULL);
+
+  return true;
+}
+
+/***************************************************************************//**
+ * Check whether a read is in progress.
+ ******************************************************************************/
+bool spi_flash_read_busy(void)
+{
+  return readBusy;
+}
@@ -19,7 +19,6 @@
  * Initialize application.
  ******************************************************************************/
 #include "em_cmu.h"
-#include "sl_sleeptimer.h"
 #include "app_log.h"
 #include "stdint.h"
 #include "em_usart.h"
@@ -33,39 +32,34 @@
 #define CSPIN     3
 
 // SPI flash commands
-#define M25X_READ 0x3
+#define M25X_READ       0x3
+#define M25X_FAST_READ  0xB
 
 // Transfer count
-#define BYTECOUNT 1048576
+#define BYTECOUNT 1024
+#define LOOPCOUNT 1024
 
-// Globals for tick count
-static volatile uint32_t msTicks;
-static uint32_t msTicks_start, msTicks_end;
+// Read buffer
+static uint8_t readBuffer[BYTECOUNT];
 
-static sl_sleeptimer_timer_handle_t app_timer;
-static void app_timer_callback(sl_sleeptimer_timer_handle_t *timer, void *data);
+typedef struct {
+  const char *name;
+  bool fast;
+} benchmark_t;
 
-/***************************************************************************//**
- * App timer callback function.
- ******************************************************************************/
-static void app_timer_callback(sl_sleeptimer_timer_handle_t *timer, void *data)
-{
-  (void)timer;
-  (void)data;
-
-  msTicks++;  // Increment milliseconds tick counter
-}
+static const benchmark_t benchmarks[] = {
+  { "READ", false },
+  { "FAST_READ", true },
+};
 
 /***************************************************************************//**
- * App capture start time function.
+ * App cycle counter initialization function.
  ******************************************************************************/
-void app_time_sync(void)
+void app_cycle_counter_init(void)
 {
-  msTicks_end = msTicks;
-
-  while (msTicks_end == msTicks) {  // msTicks Sync
-  }
-  msTicks_start = msTicks;
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 
 /***************************************************************************//**
@@ -120,48 +114,83 @@ void app_spi_init(void)
 }
 
 /***************************************************************************//**
- * App main task function.
+ * Read a block: CS low, command, 24-bit address, dummy byte for FAST_READ,
+ * data, CS high.
  ******************************************************************************/
-void app_main_task(void)
+static void app_read(uint32_t flashAddr, uint8_t *buffer, uint32_t length,
+                     bool fast)
 {
-  int readCount, flashAddr = 0, rate;
-  uint32_t data;
+  GPIO_PinOutClear(CSPORT, CSPIN);
+
+  USART_SpiTransfer(USART2, fast ? M25X_FAST_READ : M25X_READ);
+  USART_SpiTransfer(USART2, (uint8_t)(flashAddr >> 16));
+  USART_SpiTransfer(USART2, (uint8_t)(flashAddr >> 8));
+  USART_SpiTransfer(USART2, (uint8_t)flashAddr);
+  if (fast) {
+    USART_SpiTransfer(USART2, 0x0);
+  }
 
-  app_log("Start transfer data ... \n");
-  sl_sleeptimer_start_periodic_timer_ms(&app_timer,
-                                        1,
-                                        app_timer_callback,
-                                        NULL,
-                                        0,
-                                        0);
-  app_time_sync();
-  USART_Tx(USART2, M25X_READ);
+  for (uint32_t i = 0; i < length; i++) {
+    buffer[i] = USART_SpiTransfer(USART2, 0x0);
+  }
 
-  /*
-   * Send bytes 1, 2, and 3 of 32-bit address.  Byte 0 should always
-   * be 0 unless the device in question has a 32-bit address space, in
-   * which case byte 0 needs to be sent, too.
-   */
-  USART_Tx(USART2, *((uint8_t *)&flashAddr + 1));
-  USART_Tx(USART2, *((uint8_t *)&flashAddr + 2));
-  USART_Tx(USART2, *((uint8_t *)&flashAddr + 3));
+  GPIO_PinOutSet(CSPORT, CSPIN);
+}
 
-  for (readCount = BYTECOUNT; readCount > 0; readCount--) {
-    data = USART_SpiTransfer(USART2, 0x0);
+/***************************************************************************//**
+ * Run one benchmark and display bandwidth, CPU idle time and latency.
+ ******************************************************************************/
+static void app_benchmark(const benchmark_t *benchmark)
+{
+  uint32_t flashAddr = 0;
+  uint32_t coreMHz = SystemCoreClockGet() / 1000000;
+  uint32_t start, cycles, latencyMin = UINT32_MAX, latencyMax = 0;
+  uint64_t total = 0;
+  uint32_t rate, blkCount;
+
+  for (blkCount = LOOPCOUNT; blkCount > 0; blkCount--) {
+    start = DWT->CYCCNT;
+    app_read(flashAddr, readBuffer, BYTECOUNT, benchmark->fast);
+    cycles = DWT->CYCCNT - start;
+
+    total += cycles;
+    if (cycles < latencyMin) {
+      latencyMin = cycles;
+    }
+    if (cycles > latencyMax) {
+      latencyMax = cycles;
+    }
+    flashAddr += BYTECOUNT;
   }
 
-  (void)data;
+  // Bandwidth in 10 KB/s (1 KB = 1000 bytes), printed as MB/s. The CPU
+  //   moves every byte itself, so it is never idle during a read.
+  rate = (uint32_t)(((uint64_t)LOOPCOUNT * BYTECOUNT * coreMHz * 100)
+                    / total);
+
+  app_log("%-18s %3u.%02u MB/s, CPU idle   0.0 %%, "
+          "latency min/avg/max %u/%u/%u us\n",
+          benchmark->name,
+          (unsigned int)(rate / 100), (unsigned int)(rate % 100),
+          (unsigned int)(latencyMin / coreMHz),
+          (unsigned int)(total / LOOPCOUNT / coreMHz),
+          (unsigned int)(latencyMax / coreMHz));
+}
 
-  // End timing
-  msTicks_end = msTicks;
-  sl_sleeptimer_stop_timer(&app_timer);
+/***************************************************************************//**
+ * App main task function.
+ ******************************************************************************/
+void app_main_task(void)
+{
+  app_log("Start transfer data ... \n");
+  app_log("%u reads of %u bytes per benchmark\n", LOOPCOUNT, BYTECOUNT);
+
+  for (uint32_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+    app_benchmark(&benchmarks[i]);
+  }
 
-  // Display transfer rate
-  rate = (BYTECOUNT / (msTicks_end - msTicks_start));
   app_log("USART2 clock = %u MHz\n",
           (unsigned int)(CMU_ClockFreqGet(cmuClock_USART2) / 1000000));
-  app_log("Done: %u bytes in %u ms = %u KB/sec\n", BYTECOUNT,
-          (unsigned int)(msTicks_end - msTicks_start), rate);
 }
 
 /***************************************************************************//**
@@ -172,6 +201,7 @@ void app_init(void)
   app_log("\nPlatform - EFR32xG21 Polled SPI Throughput Example\n\n");
 
   app_spi_init();
+  app_cycle_counter_init();
   app_main_task();
 }
 
@@ -0,0 +1,371 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host trace replay benchmark of the SPI flash page cache
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ *******************************************************************************
+ *
+ * Replays a read trace against a flash image file, once through the cache of
+ * ../ldma/src/spi_flash_cache.c and once uncached, and compares hit rate and
+ * read latency.
+ *
+ * Build:
+ *   cc -O2 -I../ldma/inc -o cache_replay cache_replay.c \
+ *      ../ldma/src/spi_flash_cache.c
+ *
+ * The cache geometry can be changed with -DSPI_FLASH_CACHE_SETS=... etc.
+ *
+ * Usage:
+ *   cache_replay [options] image trace
+ *
+ *   The trace has one read per line, "address length", in decimal or 0x hex.
+ *   Empty lines and lines starting with # are ignored.
+ *
+ *   --sclk-hz N        SPI clock (default 20000000)
+ *   --overhead-ns N    Fixed cost of each flash read, for setting up the LDMA
+ *                      and handling the interrupt (default 2000)
+ *   --consume-ns N     Time the reader spends on each byte it got, during
+ *                      which a prefetch can proceed (default 20)
+ *
+ * Time is simulated: a flash read takes the overhead plus 8 SPI clocks for
+ * each command, address, dummy and data byte of a FAST_READ.
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "spi_flash_cache.h"
+
+// Command, address and dummy bytes of a FAST_READ
+#define READ_HEADER_BYTES 5
+
+static uint8_t *image;
+static uint32_t imageSize;
+
+static uint64_t sclkHz = 20000000;
+static uint64_t overheadNs = 2000;
+static uint64_t consumeNs = 20;
+
+// Simulated time and the read in progress
+static uint64_t now;
+static struct {
+  bool busy;
+  uint64_t completeAt;
+  uint32_t address;
+  uint8_t *buffer;
+  uint32_t length;
+  spi_flash_cache_done_t done;
+  void *user;
+} flashRead;
+
+static uint32_t flashReads;
+
+typedef struct {
+  uint64_t total;
+  uint64_t max;
+} latency_t;
+
+/***************************************************************************//**
+ * Time taken by a flash read of length data bytes.
+ ******************************************************************************/
+static uint64_t read_time(uint32_t length)
+{
+  return overheadNs
+         + ((uint64_t)(READ_HEADER_BYTES + length) * 8 * 1000000000) / sclkHz;
+}
+
+/***************************************************************************//**
+ * Copy the data of a flash read, clamped to the image.
+ ******************************************************************************/
+static void image_read(uint32_t address, uint8_t *buffer, uint32_t length)
+{
+  memset(buffer, 0xFF, length);
+  if (address < imageSize) {
+    if (length > (imageSize - address)) {
+      length = imageSize - address;
+    }
+    memcpy(buffer, &image[address], length);
+  }
+}
+
+/***************************************************************************//**
+ * Complete the read in progress, as the LDMA interrupt would.
+ ******************************************************************************/
+static void flash_complete(void)
+{
+  flashRead.busy = false;
+  image_read(flashRead.address, flashRead.buffer, flashRead.length);
+  flashRead.done(flashRead.user);
+}
+
+/***************************************************************************//**
+ * Complete the read in progress if its time has come.
+ ******************************************************************************/
+static void flash_poll(void)
+{
+  if (flashRead.busy && (flashRead.completeAt <= now)) {
+    flash_complete();
+  }
+}
+
+/***************************************************************************//**
+ * Port: start a read.
+ ******************************************************************************/
+static bool flash_read_start(uint32_t address,
+                             uint8_t *buffer,
+                             uint32_t length,
+                             spi_flash_cache_done_t done,
+                             void *user)
+{
+  if (flashRead.busy) {
+    return false;
+  }
+  flashRead.busy = true;
+  flashRead.completeAt = now + read_time(length);
+  flashRead.address = address;
+  flashRead.buffer = buffer;
+  flashRead.length = length;
+  flashRead.done = done;
+  flashRead.user = user;
+  flashReads++;
+  return true;
+}
+
+/***************************************************************************//**
+ * Port: wait, moves time on to the end of the read in progress.
+ ******************************************************************************/
+static void flash_wait(void)
+{
+  if (flashRead.busy) {
+    if (now < flashRead.completeAt) {
+      now = flashRead.completeAt;
+    }
+    flash_complete();
+  }
+}
+
+/***************************************************************************//**
+ * Load a whole file.
+ ******************************************************************************/
+static uint8_t *file_load(const char *path, uint32_t *size)
+{
+  FILE *file = fopen(path, "rb");
+  uint8_t *data;
+  long length;
+
+  if (file == NULL) {
+    return NULL;
+  }
+  fseek(file, 0, SEEK_END);
+  length = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  data = malloc(length > 0 ? (size_t)length : 1);
+  if ((data == NULL) || (fread(data, 1, (size_t)length, file) != (size_t)length)) {
+    free(data);
+    fclose(file);
+    return NULL;
+  }
+  fclose(file);
+  *size = (uint32_t)length;
+  return data;
+}
+
+/***************************************************************************//**
+ * Load a trace.
+ ******************************************************************************/
+static uint32_t trace_load(const char *path, uint32_t **trace)
+{
+  FILE *file = fopen(path, "r");
+  char line[128];
+  uint32_t count = 0, capacity = 0;
+  long address, length;
+
+  *trace = NULL;
+  if (file == NULL) {
+    return 0;
+  }
+  while (fgets(line, sizeof(line), file) != NULL) {
+    if ((line[0] == '#')
+        || (sscanf(line, "%li %li", &address, &length) != 2)
+        || (address < 0) || (length <= 0)) {
+      continue;
+    }
+    if (count == capacity) {
+      capacity = capacity ? capacity * 2 : 1024;
+      *trace = realloc(*trace, capacity * 2 * sizeof(uint32_t));
+    }
+    (*trace)[2 * count] = (uint32_t)address;
+    (*trace)[2 * count + 1] = (uint32_t)length;
+    count++;
+  }
+  fclose(file);
+  return count;
+}
+
+/***************************************************************************//**
+ * Replay a trace, through the cache or directly.
+ *
+ * @return Number of reads returning wrong data.
+ ******************************************************************************/
+static uint32_t replay(const uint32_t *trace, uint32_t count, bool cached,
+                       latency_t *latency)
+{
+  static const spi_flash_cache_port_t port = {
+    .read_start = flash_read_start,
+    .wait = flash_wait,
+  };
+  static spi_flash_cache_port_t sizedPort;
+  uint8_t *buffer = NULL, *expected = NULL;
+  uint32_t capacity = 0, errors = 0;
+  uint64_t start, elapsed;
+
+  now = 0;
+  flashReads = 0;
+  memset(&flashRead, 0, sizeof(flashRead));
+  memset(latency, 0, sizeof(*latency));
+  if (cached) {
+    sizedPort = port;
+    sizedPort.size = imageSize;
+    spi_flash_cache_init(&sizedPort);
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t address = trace[2 * i];
+    uint32_t length = trace[2 * i + 1];
+
+    if (length > capacity) {
+      capacity = length;
+      buffer = realloc(buffer, capacity);
+      expected = realloc(expected, capacity);
+    }
+
+    flash_poll();
+    start = now;
+    if (cached) {
+      spi_flash_cache_read(address, buffer, length);
+    } else {
+      now += read_time(length);
+      flashReads++;
+      image_read(address, buffer, length);
+    }
+    elapsed = now - start;
+    latency->total += elapsed;
+    if (elapsed > latency->max) {
+      latency->max = elapsed;
+    }
+
+    image_read(address, expected, length);
+    if (memcmp(buffer, expected, length) != 0) {
+      errors++;
+    }
+
+    // The reader works on the data, a prefetch runs in the meantime.
+    now += consumeNs * length;
+  }
+
+  if (cached) {
+    flash_wait();
+  }
+  free(buffer);
+  free(expected);
+  return errors;
+}
+
+/***************************************************************************//**
+ * Print usage.
+ ******************************************************************************/
+static void usage(const char *name)
+{
+  fprintf(stderr,
+          "usage: %s [--sclk-hz N] [--overhead-ns N] [--consume-ns N] "
+          "image trace\n",
+          name);
+}
+
+int main(int argc, char **argv)
+{
+  const char *imagePath = NULL, *tracePath = NULL;
+  uint32_t *trace, count, errors, uncachedReads;
+  uint64_t uncachedTime, cachedTime;
+  latency_t uncached, cached;
+  spi_flash_cache_stats_t stats;
+  uint32_t lookups;
+
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "--sclk-hz") == 0) && (i + 1 < argc)) {
+      sclkHz = strtoull(argv[++i], NULL, 0);
+    } else if ((strcmp(argv[i], "--overhead-ns") == 0) && (i + 1 < argc)) {
+      overheadNs = strtoull(argv[++i], NULL, 0);
+    } else if ((strcmp(argv[i], "--consume-ns") == 0) && (i + 1 < argc)) {
+      consumeNs = strtoull(argv[++i], NULL, 0);
+    } else if (imagePath == NULL) {
+      imagePath = argv[i];
+    } else if (tracePath == NULL) {
+      tracePath = argv[i];
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if ((imagePath == NULL) || (tracePath == NULL) || (sclkHz == 0)) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  image = file_load(imagePath, &imageSize);
+  if (image == NULL) {
+    fprintf(stderr, "cannot read %s\n", imagePath);
+    return 1;
+  }
+  count = trace_load(tracePath, &trace);
+  if (count == 0) {
+    fprintf(stderr, "no reads in %s\n", tracePath);
+    return 1;
+  }
+
+  errors = replay(trace, count, false, &uncached);
+  uncachedTime = now;
+  uncachedReads = flashReads;
+  errors += replay(trace, count, true, &cached);
+  cachedTime = now;
+  spi_flash_cache_stats_get(&stats);
+  lookups = stats.hits + stats.misses;
+
+  printf("cache: %u sets x %u ways x %u bytes, prefetch after %u reads\n",
+         SPI_FLASH_CACHE_SETS, SPI_FLASH_CACHE_WAYS,
+         SPI_FLASH_CACHE_PAGE_SIZE, SPI_FLASH_CACHE_SEQUENTIAL_READS);
+  printf("trace: %u reads, image %u bytes, SCLK %llu Hz\n",
+         count, imageSize, (unsigned long long)sclkHz);
+  printf("pages: %u hits, %u misses, hit rate %.1f %%\n",
+         stats.hits, stats.misses,
+         lookups ? 100.0 * stats.hits / lookups : 0.0);
+  printf("prefetch: %u pages, %u used, %u stalls, %u evictions\n",
+         stats.prefetches, stats.prefetchHits, stats.stalls, stats.evictions);
+  printf("%-9s %10s %12s %12s %12s\n",
+         "", "flash rd", "avg lat us", "max lat us", "total ms");
+  printf("%-9s %10u %12.2f %12.2f %12.3f\n", "uncached", uncachedReads,
+         uncached.total / 1000.0 / count, uncached.max / 1000.0,
+         uncachedTime / 1000000.0);
+  printf("%-9s %10u %12.2f %12.2f %12.3f\n", "cached", flashReads,
+         cached.total / 1000.0 / count, cached.max / 1000.0,
+         cachedTime / 1000000.0);
+  if (errors != 0) {
+    printf("%u reads returned wrong data\n", errors);
+  }
+
+  free(trace);
+  free(image);
+  return errors ? 1 : 0;
+}
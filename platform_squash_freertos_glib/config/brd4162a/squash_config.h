@@ -67,6 +67,10 @@ extern "C"
 // <d> 128
 #define LCD_HEIGHT 128
 
+// <o BALL_TASK_DLY> Ball movement period (ms)
+// <d> 50
+#define BALL_TASK_DLY 50
+
 #if (LED_DEMO == 1)
 // <o BLINK_TASK_DLY> Blinky task delay (ms)
 // <d> 2000
@@ -75,7 +79,26 @@ extern "C"
 // </h>
 
 
+// <h> Render
+// <q RENDER_PARTIAL_UPDATE> Send only the changed LCD lines
+// <i> Default: 1
+#define RENDER_PARTIAL_UPDATE 1
+
+// <o RENDER_FRAME_MS> Frame period (ms)
+// <d> 50
+#define RENDER_FRAME_MS 50
+
+// <o RENDER_QUEUE_LENGTH> Number of position updates queued per frame
+// <d> 8
+#define RENDER_QUEUE_LENGTH 8
+// </h>
+
+
 // <h> Stack Size
+// <o STACK_RENDER_SIZE> STACK_RENDER_SIZE
+// <d> 256
+#define STACK_RENDER_SIZE 256
+
 // <o STACK_ROCKET_DOWN_SIZE> STACK_ROCKET_DOWN_STACK_SIZE
 // <d> 256
 #define STACK_ROCKET_DOWN_SIZE 256
@@ -97,6 +120,10 @@ extern "C"
 
 
 // <h> Task Priority
+// <o TASK_RENDER_PRIORITY> TASK_RENDER_PRIORITY
+// <d> 3
+#define TASK_RENDER_PRIORITY 3
+
 // <o TASK_ROCKET_DOWN_PRIORITY> TASK_ROCKET_DOWN_PRIORITY
 // <d> 2
 #define TASK_ROCKET_DOWN_PRIORITY 2
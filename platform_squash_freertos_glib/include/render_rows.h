@@ -0,0 +1,82 @@
+/***************************************************************************//**
+ * @file
+ * @brief Range of LCD lines changed by a frame
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef RENDER_ROWS_H
+#define RENDER_ROWS_H
+
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+//                                Data Types
+// -----------------------------------------------------------------------------
+
+/*  Lines to send to the LCD, empty while last is before first  */
+typedef struct {
+  int32_t first;
+  int32_t last;
+} render_rows_t;
+
+// -----------------------------------------------------------------------------
+//                          Public Function Declarations
+// -----------------------------------------------------------------------------
+
+/***************************************************************************//**
+ * Empty a line range.
+ *
+ * @param[out] rows Line range
+ * @param[in] height Number of lines of the LCD
+ ******************************************************************************/
+void render_rows_reset(render_rows_t *rows, int32_t height);
+
+/***************************************************************************//**
+ * Extend a line range to the lines of a rectangle.
+ *
+ * @param[in,out] rows Line range
+ * @param[in] y_min First line of the rectangle
+ * @param[in] y_max Last line of the rectangle
+ ******************************************************************************/
+void render_rows_add(render_rows_t *rows, int32_t y_min, int32_t y_max);
+
+/***************************************************************************//**
+ * Clip a line range to the LCD.
+ *
+ * @param[in,out] rows Line range
+ * @param[in] height Number of lines of the LCD
+ *
+ * @return Number of lines to send, 0 if the range is empty or off the LCD
+ ******************************************************************************/
+uint32_t render_rows_clip(render_rows_t *rows, int32_t height);
+
+#endif // RENDER_ROWS_H
@@ -36,10 +36,13 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "semphr.h"
+#include "queue.h"
 #include "glib.h"
 #include "dmd.h"
+#include "sl_memlcd.h"
 #include "gpiointerrupt.h"
 #include "squash_config.h"
+#include "render_rows.h"
 #include "app.h"
 #if (LED_DEMO == 1)
 #include "sl_simple_led_instances.h"
@@ -52,16 +55,39 @@
 /*  Greeting text  */
 static const char *msg = "Hello SQUASH!";
 #define GTEXT_L 14
+#define GTEXT_H 8
 
-/*  LCD context variable  */
+/*  Entities drawn by the render task  */
+#define ENTITY_RACKET 0
+#define ENTITY_BALL   1
+#define ENTITY_COUNT  2
+
+/*  Position update sent to the render task  */
+typedef struct {
+  uint8_t entity;
+  GLIB_Rectangle_t rect;
+} render_msg_t;
+
+/*  LCD context variable, only used by the render task  */
 static GLIB_Context_t g_context;
 
-/*  Racket entity structure  */
+/*  Frame buffer selected for GLIB drawing  */
+static uint8_t *frame_buffer;
+static uint32_t row_bytes;
+
+/*  Entity positions as drawn on the LCD, only used by the render task  */
+static GLIB_Rectangle_t drawn[ENTITY_COUNT];
+
+/*  Racket entity structure, only written by the racket tasks  */
 static GLIB_Rectangle_t g_racket = { 10, 10, 13, 29 };
 
-/*  Ball entity structure  */
+/*  Ball entity structure, only written by the ball task  */
 static GLIB_Rectangle_t g_ball = { 50, 50, 51, 51 };
 
+/*  Frame statistics, can be watched from the debugger  */
+volatile uint32_t render_frames = 0;
+volatile uint32_t render_lines_flushed = 0;
+
 /*  Task creation returns  */
 BaseType_t rtask;
 
@@ -70,11 +96,14 @@ TaskHandle_t taskBlinkh = NULL;
 TaskHandle_t taskRDownh = NULL;
 TaskHandle_t taskRUph = NULL;
 TaskHandle_t taskBallh = NULL;
+TaskHandle_t taskRenderh = NULL;
 
 /*  Semaphore declarations for button tasks  */
 xSemaphoreHandle xBSemaphore;
 xSemaphoreHandle xBSemaphoreUp;
-xSemaphoreHandle xMutex;
+
+/*  Queue of position updates for the render task  */
+QueueHandle_t xRenderQueue;
 
 /*  Save colors  */
 uint32_t fg_color;
@@ -87,25 +116,37 @@ void vBlink(void *pvParameters);
 void vBall(void *pvParameters);
 void vRacket_up(void *pvParameters);
 void vRacket_down(void *pvParameters);
+void vRender(void *pvParameters);
+static void render_post(uint8_t entity, const GLIB_Rectangle_t *rect);
+static void render_flush(render_rows_t *rows);
 static void app_gpio_button0_int_cb(uint8_t intNo);
 static void app_gpio_button1_int_cb(uint8_t intNo);
 
 void app_init(void)
 {
   EMSTATUS gstatus = GLIB_OK;
+  const sl_memlcd_t *device;
 
-  /*  Creating semaphores for button tasks  */
+  /*  Creating semaphores for button tasks and the render queue  */
   vSemaphoreCreateBinary(xBSemaphore);
   vSemaphoreCreateBinary(xBSemaphoreUp);
-  xMutex = xSemaphoreCreateMutex();
+  xRenderQueue = xQueueCreate(RENDER_QUEUE_LENGTH, sizeof(render_msg_t));
 
   /* Creating tasks */
-  rtask = xTaskCreate(vRacket_down,
-                      "Racket down task",
-                      STACK_ROCKET_DOWN_SIZE,
+  rtask = xTaskCreate(vRender,
+                      "Render task",
+                      STACK_RENDER_SIZE,
                       NULL,
-                      TASK_ROCKET_DOWN_PRIORITY,
-                      &taskRDownh);
+                      TASK_RENDER_PRIORITY,
+                      &taskRenderh);
+  if (rtask == pdTRUE) {
+    rtask = xTaskCreate(vRacket_down,
+                        "Racket down task",
+                        STACK_ROCKET_DOWN_SIZE,
+                        NULL,
+                        TASK_ROCKET_DOWN_PRIORITY,
+                        &taskRDownh);
+  }
   if (rtask == pdTRUE) {
     rtask = xTaskCreate(vRacket_up,
                         "Racket up task",
@@ -132,16 +173,23 @@ void app_init(void)
   }
 #endif
 
-  /*  Halt program if any of the task and Mutex creation functions failed  */
-  if ((rtask == pdFAIL) || (xMutex == NULL)) {
+  /*  Halt program if any of the task and queue creation functions failed  */
+  if ((rtask == pdFAIL) || (xRenderQueue == NULL)) {
     while (1) {
       /* Error here */
     }
   }
 
-  /*  Initializing Dot Matrix Display and outputting greeting text  */
+  /*  Initializing Dot Matrix Display with a frame buffer owned by the
+   *  render task, and outputting greeting text  */
   DMD_init(0);
-  gstatus = GLIB_contextInit(&g_context);
+  gstatus = DMD_allocateFramebuffer((void **)&frame_buffer);
+  if (DMD_OK == gstatus) {
+    gstatus = DMD_selectFramebuffer(frame_buffer);
+  }
+  if (DMD_OK == gstatus) {
+    gstatus = GLIB_contextInit(&g_context);
+  }
 
   if (GLIB_OK != gstatus) {
     while (1) {
@@ -149,8 +197,15 @@ void app_init(void)
     }
   }
 
+  device = sl_memlcd_get();
+  row_bytes = (device->width * device->bpp) / 8;
+
+  GLIB_clear(&g_context);
   GLIB_drawString(&g_context, msg, GTEXT_L, GTEXT_X, GTEXT_Y, true);
+  drawn[ENTITY_RACKET] = g_racket;
+  drawn[ENTITY_BALL] = g_ball;
   GLIB_drawRectFilled(&g_context, &g_racket);
+  GLIB_drawRectFilled(&g_context, &g_ball);
   DMD_updateDisplay();
 
   fg_color = g_context.foregroundColor;
@@ -225,6 +280,63 @@ void vBlink(void *pvParameters)
 
 #endif
 
+/*****************************************************************************
+ * @brief
+ *   Render task owns the frame buffer. Once per frame it applies every
+ *   pending position update, then sends only the LCD lines covered by the
+ *   union of the old and new entity rectangles.
+ *
+ * @param[in] Not used
+ *
+ ******************************************************************************/
+void vRender(void *pvParameters)
+{
+  (void)&pvParameters;
+
+  TickType_t last_wake = xTaskGetTickCount();
+  GLIB_Rectangle_t next[ENTITY_COUNT];
+  render_msg_t update;
+  render_rows_t rows;
+  uint8_t changed;
+  uint8_t i;
+
+  while (1) {
+    vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(RENDER_FRAME_MS));
+
+    /*  Keep only the latest position of each entity  */
+    changed = 0;
+    while (xQueueReceive(xRenderQueue, &update, 0) == pdTRUE) {
+      next[update.entity] = update.rect;
+      changed |= 1 << update.entity;
+    }
+    if (changed == 0) {
+      continue;
+    }
+
+    /*  Remove the changed entities from their old position  */
+    render_rows_reset(&rows, LCD_HEIGHT);
+    g_context.foregroundColor = bg_color;
+    for (i = 0; i < ENTITY_COUNT; i++) {
+      if (changed & (1 << i)) {
+        GLIB_drawRectFilled(&g_context, &drawn[i]);
+        render_rows_add(&rows, drawn[i].yMin, drawn[i].yMax);
+        drawn[i] = next[i];
+        render_rows_add(&rows, drawn[i].yMin, drawn[i].yMax);
+      }
+    }
+    g_context.foregroundColor = fg_color;
+
+    /*  Redraw everything that may have been erased, then flush once  */
+    if (rows.first < (GTEXT_Y + GTEXT_H)) {
+      GLIB_drawString(&g_context, msg, GTEXT_L, GTEXT_X, GTEXT_Y, true);
+    }
+    for (i = 0; i < ENTITY_COUNT; i++) {
+      GLIB_drawRectFilled(&g_context, &drawn[i]);
+    }
+    render_flush(&rows);
+  }
+}
+
 /*****************************************************************************
  * @brief
  *   Task execution is triggered by BUTTON0 press and move down the racket.
@@ -236,27 +348,20 @@ void vRacket_down(void *pvParameters)
 {
   (void)&pvParameters;
 
-  xSemaphoreTake(xMutex, portMAX_DELAY);
-  GLIB_drawRectFilled(&g_context, &g_racket);
-  DMD_updateDisplay();
-  xSemaphoreGive(xMutex);
+  GLIB_Rectangle_t racket;
 
   while (1) {
     xSemaphoreTake(xBSemaphore, portMAX_DELAY);
 
+    taskENTER_CRITICAL();
     if ((g_racket.yMax + MOV_STEP_Y) < LCD_HEIGHT) {
-      xSemaphoreTake(xMutex, portMAX_DELAY);
-      g_context.foregroundColor = bg_color;
-
-      /*  Remove Racket from the old position  */
-      GLIB_drawRectFilled(&g_context, &g_racket);
       g_racket.yMin += MOV_STEP_Y;
       g_racket.yMax += MOV_STEP_Y;
-      g_context.foregroundColor = fg_color;
-      GLIB_drawRectFilled(&g_context, &g_racket);
-      DMD_updateDisplay();
-      xSemaphoreGive(xMutex);
     }
+    racket = g_racket;
+    taskEXIT_CRITICAL();
+
+    render_post(ENTITY_RACKET, &racket);
   }
 }
 
@@ -271,22 +376,20 @@ void vRacket_up(void *pvParameters)
 {
   (void)&pvParameters;
 
+  GLIB_Rectangle_t racket;
+
   while (1) {
     xSemaphoreTake(xBSemaphoreUp, portMAX_DELAY);
 
+    taskENTER_CRITICAL();
     if (g_racket.yMin - MOV_STEP_Y >= 0) {
-      xSemaphoreTake(xMutex, portMAX_DELAY);
-      g_context.foregroundColor = bg_color;
-
-      /*  Remove Racket from the old position  */
-      GLIB_drawRectFilled(&g_context, &g_racket);
       g_racket.yMin -= MOV_STEP_Y;
       g_racket.yMax -= MOV_STEP_Y;
-      g_context.foregroundColor = fg_color;
-      GLIB_drawRectFilled(&g_context, &g_racket);
-      DMD_updateDisplay();
-      xSemaphoreGive(xMutex);
     }
+    racket = g_racket;
+    taskEXIT_CRITICAL();
+
+    render_post(ENTITY_RACKET, &racket);
   }
 }
 
@@ -306,32 +409,23 @@ void vBall(void *pvParameters)
   int32_t lbarrier = g_racket.xMax + 1;
   int8_t movballx = MOV_BALL_X;
   int8_t movbally = MOV_BALL_Y;
-
-  /*  Initial Ball position  */
-  xSemaphoreTake(xMutex, portMAX_DELAY);
-  GLIB_drawRectFilled(&g_context, &g_ball);
-  DMD_updateDisplay();
-  xSemaphoreGive(xMutex);
+  TickType_t last_wake = xTaskGetTickCount();
+  GLIB_Rectangle_t racket;
 
   while (1) {
-    vTaskDelay(50);
+    vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(BALL_TASK_DLY));
 
-    xSemaphoreTake(xMutex, portMAX_DELAY);
-
-    /*  Removing Ball in previous position   */
-    g_context.foregroundColor = bg_color;
-    GLIB_drawRectFilled(&g_context, &g_ball);
-    DMD_updateDisplay();
-    g_context.foregroundColor = fg_color;
-    xSemaphoreGive(xMutex);
+    taskENTER_CRITICAL();
+    racket = g_racket;
+    taskEXIT_CRITICAL();
 
     /*  Check whether Ball's right edge exceeds the end of the screen */
     if ((g_ball.xMax) >= (LCD_WIDTH - 1)) {
       movballx *= -1;
 
       /*  Check whether the ball touches the Racket  */
-    } else if ((g_ball.xMin <= lbarrier) && ((g_racket.yMin <= g_ball.yMin)
-                                             && (g_racket.yMax
+    } else if ((g_ball.xMin <= lbarrier) && ((racket.yMin <= g_ball.yMin)
+                                             && (racket.yMax
                                                  >= g_ball.yMax))) {
       movballx *= -1;
 
@@ -354,11 +448,55 @@ void vBall(void *pvParameters)
     g_ball.yMin += movbally;
     g_ball.yMax += movbally;
 
-    xSemaphoreTake(xMutex, portMAX_DELAY);
-    GLIB_drawRectFilled(&g_context, &g_ball);
-    DMD_updateDisplay();
-    xSemaphoreGive(xMutex);
+    render_post(ENTITY_BALL, &g_ball);
+  }
+}
+
+/*****************************************************************************
+ * @brief
+ *   Send the new position of an entity to the render task.
+ *
+ * @param[in] entity Entity index
+ * @param[in] rect New position of the entity
+ *
+ ******************************************************************************/
+static void render_post(uint8_t entity, const GLIB_Rectangle_t *rect)
+{
+  render_msg_t update;
+
+  update.entity = entity;
+  update.rect = *rect;
+
+  /*  Blocks only if the render task is more than a queue behind  */
+  xQueueSend(xRenderQueue, &update, portMAX_DELAY);
+}
+
+/*****************************************************************************
+ * @brief
+ *   Send a range of lines of the frame buffer to the LCD.
+ *
+ * @param[in] rows Lines to send
+ *
+ ******************************************************************************/
+static void render_flush(render_rows_t *rows)
+{
+  uint32_t count = render_rows_clip(rows, LCD_HEIGHT);
+
+  if (count == 0) {
+    return;
   }
+
+#if (RENDER_PARTIAL_UPDATE == 1)
+  sl_memlcd_draw(sl_memlcd_get(),
+                 frame_buffer + (rows->first * row_bytes),
+                 rows->first,
+                 count);
+  render_lines_flushed += count;
+#else
+  DMD_updateDisplay();
+  render_lines_flushed += LCD_HEIGHT;
+#endif
+  render_frames++;
 }
 
 static void app_gpio_button0_int_cb(uint8_t intNo)
@@ -0,0 +1,331 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host test of the lines sent by the squash render task
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ *******************************************************************************
+ *
+ * Plays the game of ../src/app.c on a host frame buffer, frame by frame: the
+ * ball moves every BALL_TASK_DLY ms as vBall() moves it, and a button press
+ * moves the racket at a fixed period. Each frame erases and redraws the
+ * changed entities as vRender() does, and sends only the lines given by
+ * ../src/render_rows.c to a simulated LCD.
+ *
+ * After each frame the LCD must match the scene drawn from scratch: a line
+ * changed but not sent is counted as a mismatch. The lines sent per second
+ * are compared with a full screen per frame and with the tasks before the
+ * render task, which sent two full screens per position update.
+ *
+ * Build, from the project directory:
+ *   cc -O2 -Wall -Wextra -Iinclude -Iconfig/brd4162a -o render_rows_test \
+ *      tools/render_rows_test.c src/render_rows.c
+ *
+ * Usage:
+ *   ./render_rows_test [seconds] [button period in ms, 0 for none]
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "render_rows.h"
+#include "squash_config.h"
+
+#define LCD_ROW_BYTES       (LCD_WIDTH / 8)
+
+// Greeting text of ../src/app.c, drawn as a fixed pattern per character
+#define GTEXT               "Hello SQUASH!"
+#define FONT_WIDTH          6
+#define FONT_HEIGHT         8
+
+// Presses in one direction before the racket turns back
+#define PRESSES_PER_SWEEP   20
+
+#define ENTITY_RACKET       0
+#define ENTITY_BALL         1
+#define ENTITY_COUNT        2
+
+typedef struct {
+  int32_t xMin;
+  int32_t yMin;
+  int32_t xMax;
+  int32_t yMax;
+} rect_t;
+
+static uint8_t framebuffer[LCD_HEIGHT * LCD_ROW_BYTES];
+static uint8_t lcd[LCD_HEIGHT * LCD_ROW_BYTES];
+static uint8_t scene[LCD_HEIGHT * LCD_ROW_BYTES];
+
+static uint32_t failures;
+
+/***************************************************************************//**
+ * Set or clear a pixel, clipped to the LCD as GLIB does.
+ ******************************************************************************/
+static void pixel_set(uint8_t *buffer, int32_t x, int32_t y, bool on)
+{
+  uint8_t *byte;
+
+  if ((x < 0) || (x >= LCD_WIDTH) || (y < 0) || (y >= LCD_HEIGHT)) {
+    return;
+  }
+  byte = &buffer[y * LCD_ROW_BYTES + x / 8];
+  if (on) {
+    *byte |= (uint8_t)(1 << (x % 8));
+  } else {
+    *byte &= (uint8_t)~(1 << (x % 8));
+  }
+}
+
+static void rect_fill(uint8_t *buffer, const rect_t *rect, bool on)
+{
+  for (int32_t y = rect->yMin; y <= rect->yMax; y++) {
+    for (int32_t x = rect->xMin; x <= rect->xMax; x++) {
+      pixel_set(buffer, x, y, on);
+    }
+  }
+}
+
+/***************************************************************************//**
+ * Opaque text: a fixed pattern per character, not a real font.
+ ******************************************************************************/
+static void text_draw(uint8_t *buffer)
+{
+  const char *text = GTEXT;
+
+  for (int32_t i = 0; text[i] != '\0'; i++) {
+    for (int32_t y = 0; y < FONT_HEIGHT; y++) {
+      for (int32_t x = 0; x < FONT_WIDTH; x++) {
+        pixel_set(buffer, GTEXT_X + i * FONT_WIDTH + x, GTEXT_Y + y,
+                  ((text[i] * 31 + y * 7 + x * 3) % 5) < 2);
+      }
+    }
+  }
+}
+
+/***************************************************************************//**
+ * Line ranges: empty, union and clipping to the LCD.
+ ******************************************************************************/
+static void rows_check(void)
+{
+  render_rows_t rows;
+
+  render_rows_reset(&rows, LCD_HEIGHT);
+  if (render_rows_clip(&rows, LCD_HEIGHT) != 0) {
+    printf("  empty range sends lines\n");
+    failures++;
+  }
+
+  render_rows_reset(&rows, LCD_HEIGHT);
+  render_rows_add(&rows, 40, 45);
+  render_rows_add(&rows, 10, 12);
+  if ((render_rows_clip(&rows, LCD_HEIGHT) != 36) || (rows.first != 10)
+      || (rows.last != 45)) {
+    printf("  union of 10..12 and 40..45 is %ld..%ld\n", (long)rows.first,
+           (long)rows.last);
+    failures++;
+  }
+
+  // Rectangles one step apart, as an entity moving by one line
+  for (int32_t step = -1; step <= 1; step += 2) {
+    render_rows_reset(&rows, LCD_HEIGHT);
+    render_rows_add(&rows, 11, 13);
+    render_rows_add(&rows, 11 + step, 13 + step);
+    if ((render_rows_clip(&rows, LCD_HEIGHT) != 4)
+        || (rows.first != ((step < 0) ? 10 : 11))) {
+      printf("  union of 11..13 and %ld..%ld is %ld..%ld\n",
+             (long)(11 + step), (long)(13 + step), (long)rows.first,
+             (long)rows.last);
+      failures++;
+    }
+  }
+
+  render_rows_reset(&rows, LCD_HEIGHT);
+  render_rows_add(&rows, -3, 2);
+  render_rows_add(&rows, LCD_HEIGHT - 2, LCD_HEIGHT + 4);
+  if ((render_rows_clip(&rows, LCD_HEIGHT) != LCD_HEIGHT) || (rows.first != 0)
+      || (rows.last != LCD_HEIGHT - 1)) {
+    printf("  range not clipped to the LCD: %ld..%ld\n", (long)rows.first,
+           (long)rows.last);
+    failures++;
+  }
+
+  render_rows_reset(&rows, LCD_HEIGHT);
+  render_rows_add(&rows, LCD_HEIGHT, LCD_HEIGHT + 3);
+  if (render_rows_clip(&rows, LCD_HEIGHT) != 0) {
+    printf("  range below the LCD sends lines\n");
+    failures++;
+  }
+}
+
+/***************************************************************************//**
+ * Move the ball one step, as vBall() does.
+ ******************************************************************************/
+static void ball_move(rect_t *ball, const rect_t *racket, int32_t *dx,
+                      int32_t *dy)
+{
+  int32_t lbarrier = racket->xMax + 1;
+
+  if (ball->xMax >= (LCD_WIDTH - 1)) {
+    *dx = -*dx;
+  } else if ((ball->xMin <= lbarrier) && (racket->yMin <= ball->yMin)
+             && (racket->yMax >= ball->yMax)) {
+    *dx = -*dx;
+  } else if (ball->xMin < lbarrier) {
+    *ball = (rect_t){ 50, 50, 51, 51 };
+  }
+  if ((ball->yMax >= (LCD_HEIGHT - 1)) || (ball->yMin <= 0)) {
+    *dy = -*dy;
+  }
+  ball->xMin += *dx;
+  ball->xMax += *dx;
+  ball->yMin += *dy;
+  ball->yMax += *dy;
+}
+
+/***************************************************************************//**
+ * Move the racket one step, as vRacket_down() and vRacket_up() do.
+ ******************************************************************************/
+static void racket_move(rect_t *racket, bool down)
+{
+  if (down && ((racket->yMax + MOV_STEP_Y) < LCD_HEIGHT)) {
+    racket->yMin += MOV_STEP_Y;
+    racket->yMax += MOV_STEP_Y;
+  } else if (!down && (racket->yMin - MOV_STEP_Y >= 0)) {
+    racket->yMin -= MOV_STEP_Y;
+    racket->yMax -= MOV_STEP_Y;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t seconds = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 60;
+  uint32_t pressMs = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 100;
+  rect_t racket = { 10, 10, 13, 29 };
+  rect_t ball = { 50, 50, 51, 51 };
+  rect_t drawn[ENTITY_COUNT], next[ENTITY_COUNT];
+  int32_t dx = MOV_BALL_X, dy = MOV_BALL_Y;
+  uint32_t presses = 0, updates = 0, frames = 0, mismatches = 0, count;
+  uint64_t lines = 0;
+  uint8_t changed = 0;
+  render_rows_t rows;
+  double partial, full, previous;
+
+  if ((seconds == 0) || (argc > 3)) {
+    fprintf(stderr, "usage: %s [seconds] [button period in ms]\n", argv[0]);
+    return 2;
+  }
+
+  rows_check();
+
+  // Start screen, sent whole by DMD_updateDisplay()
+  drawn[ENTITY_RACKET] = racket;
+  drawn[ENTITY_BALL] = ball;
+  text_draw(framebuffer);
+  rect_fill(framebuffer, &racket, true);
+  rect_fill(framebuffer, &ball, true);
+  memcpy(lcd, framebuffer, sizeof(lcd));
+
+  for (uint32_t now = 1; now <= seconds * 1000; now++) {
+    if ((pressMs != 0) && (now % pressMs == 0)) {
+      racket_move(&racket, ((presses++ / PRESSES_PER_SWEEP) % 2) == 0);
+      next[ENTITY_RACKET] = racket;
+      changed |= 1 << ENTITY_RACKET;
+      updates++;
+    }
+    if (now % BALL_TASK_DLY == 0) {
+      ball_move(&ball, &racket, &dx, &dy);
+      next[ENTITY_BALL] = ball;
+      changed |= 1 << ENTITY_BALL;
+      updates++;
+    }
+    if ((now % RENDER_FRAME_MS != 0) || (changed == 0)) {
+      continue;
+    }
+
+    // The frame of vRender()
+    render_rows_reset(&rows, LCD_HEIGHT);
+    for (uint32_t i = 0; i < ENTITY_COUNT; i++) {
+      if (changed & (1 << i)) {
+        rect_fill(framebuffer, &drawn[i], false);
+        render_rows_add(&rows, drawn[i].yMin, drawn[i].yMax);
+        drawn[i] = next[i];
+        render_rows_add(&rows, drawn[i].yMin, drawn[i].yMax);
+      }
+    }
+    changed = 0;
+    if (rows.first < (GTEXT_Y + FONT_HEIGHT)) {
+      text_draw(framebuffer);
+    }
+    for (uint32_t i = 0; i < ENTITY_COUNT; i++) {
+      rect_fill(framebuffer, &drawn[i], true);
+    }
+    count = render_rows_clip(&rows, LCD_HEIGHT);
+    if (count != 0) {
+      memcpy(&lcd[rows.first * LCD_ROW_BYTES],
+             &framebuffer[rows.first * LCD_ROW_BYTES],
+             count * LCD_ROW_BYTES);
+      lines += count;
+      frames++;
+    }
+
+    memset(scene, 0, sizeof(scene));
+    text_draw(scene);
+    for (uint32_t i = 0; i < ENTITY_COUNT; i++) {
+      rect_fill(scene, &drawn[i], true);
+    }
+    if (memcmp(lcd, scene, sizeof(lcd)) != 0) {
+      mismatches++;
+    }
+  }
+
+  partial = (double)lines / seconds;
+  full = (double)frames * LCD_HEIGHT / seconds;
+  previous = 2.0 * updates * LCD_HEIGHT / seconds;
+
+  printf("%u s, %u button presses, %u position updates, %u frames sent, "
+         "%.1f lines per frame\n", seconds, presses, updates, frames,
+         frames ? (double)lines / frames : 0.0);
+  printf("\n%-44s %10s\n", "flow", "lines/s");
+  printf("%-44s %10.0f\n", "render task, changed lines", partial);
+  printf("%-44s %10.0f\n", "render task, full screen per frame", full);
+  printf("%-44s %10.0f\n", "previous tasks, 2 full screens per update",
+         previous);
+  printf("\nreduction from the previous tasks: %.1fx\n",
+         (partial > 0) ? previous / partial : 0.0);
+  printf("LCD different from the scene: %u frames\n", mismatches);
+  if (mismatches != 0) {
+    failures++;
+  }
+
+  printf("\n%s\n", failures ? "FAIL" : "PASS");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,119 @@
+/***************************************************************************//**
+ * @file cascade_ts.h
+ * @brief 64-bit timestamps from two cascaded timers
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#ifndef CASCADE_TS_H
+#define CASCADE_TS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * The low timer counts the timer clock, the high timer counts the wraps of
+ * the low timer. If the high timer is narrower than 32 bits, its wraps are
+ * counted in software up to 64 bits.
+ *
+ * The high timer may count a wrap of the low timer a few clocks late, for
+ * instance when the wraps reach it through the PRS. Within carryGuard counts
+ * after a wrap, the high count is not trusted.
+ */
+
+/***************************************************************************//**
+ * Timer access functions used by the service.
+ ******************************************************************************/
+typedef struct {
+  uint32_t (*low_get)(void);          // Low timer count
+  uint32_t (*high_get)(void);         // High timer count
+  // True while a wrap of the high timer waits for cascade_ts_high_wrapped().
+  // May be NULL if both timers together are 64 bits wide.
+  bool (*high_wrap_pending)(void);
+  uint32_t lowTop;                    // Low timer top, a power of 2 minus 1
+  uint32_t highTop;                   // High timer top, a power of 2 minus 1
+  uint32_t carryGuard;                // Low counts the carry may take
+} cascade_ts_port_t;
+
+/***************************************************************************//**
+ * Capture FIFO filled by the LDMA: for each event, one low timer capture
+ * and one high timer capture, at the same index of two rings.
+ ******************************************************************************/
+typedef struct {
+  const volatile uint32_t *low;       // Low timer captures
+  const volatile uint32_t *high;      // High timer captures
+  uint32_t size;                      // Entries in each ring, a power of 2
+  // Number of events written to both rings so far, wrapping at 2^32
+  uint32_t (*head_get)(void);
+  uint32_t tail;                      // Number of events read so far
+  uint32_t lost;                      // Events overwritten before read
+} cascade_ts_fifo_t;
+
+/***************************************************************************//**
+ * Initialize the service.
+ *
+ * @param[in] port Timer access functions, must stay valid.
+ ******************************************************************************/
+void cascade_ts_init(const cascade_ts_port_t *port);
+
+/***************************************************************************//**
+ * Count a wrap of the high timer, from its overflow interrupt.
+ ******************************************************************************/
+void cascade_ts_high_wrapped(void);
+
+/***************************************************************************//**
+ * Read the current time.
+ *
+ * Lock-free: never blocks interrupts, retries instead when a carry or a wrap
+ * interrupt comes in the middle of the read. May be called from interrupts
+ * up to the priority of the high timer wrap interrupt.
+ *
+ * @return Timer clocks since the timers started.
+ ******************************************************************************/
+uint64_t cascade_ts_now(void);
+
+/***************************************************************************//**
+ * Build the timestamp of a captured event.
+ *
+ * The timestamp is the latest one matching the captures and not after now.
+ * Events captured within carryGuard after a low timer wrap must be resolved
+ * within one low timer period, the others within the period of both timers.
+ *
+ * @param[in] low Low timer capture.
+ * @param[in] high High timer capture of the same event.
+ * @param[in] now Time read after the capture.
+ ******************************************************************************/
+uint64_t cascade_ts_capture(uint32_t low, uint32_t high, uint64_t now);
+
+/***************************************************************************//**
+ * Initialize a capture FIFO, empty.
+ ******************************************************************************/
+void cascade_ts_fifo_init(cascade_ts_fifo_t *fifo,
+                          const volatile uint32_t *low,
+                          const volatile uint32_t *high,
+                          uint32_t size,
+                          uint32_t (*head_get)(void));
+
+/***************************************************************************//**
+ * Read event timestamps from a capture FIFO, oldest first.
+ *
+ * The FIFO holds size - 2 events. Events the LDMA overwrote before they were
+ * read are skipped and counted in fifo->lost.
+ *
+ * @return Number of timestamps written.
+ ******************************************************************************/
+uint32_t cascade_ts_fifo_read(cascade_ts_fifo_t *fifo,
+                              uint64_t *timestamps,
+                              uint32_t max);
+
+#endif // CASCADE_TS_H
@@ -17,6 +17,7 @@
 #include "em_device.h"
 #include "em_emu.h"
 #include "em_gpio.h"
+#include "em_ldma.h"
 #include "em_prs.h"
 #include "em_timer.h"
 
@@ -24,34 +25,79 @@
 #include "sl_emlib_gpio_init_timer0_config.h"
 #include "sl_emlib_gpio_init_timer1_config.h"
 
+#include "cascade_ts.h"
+
 /*******************************************************************************
  *******************************   DEFINES   ***********************************
  ******************************************************************************/
 
 #define PRS_MODE                  1
 
-#define TIMER0_OUT_FREQ           1
-
-#define TIMER1_TOP                2
-
 #if (PRS_MODE)
 #define TIMER0_PRS_CHANNEL        0
 #define TIMER1_PRS_CHANNEL        1
+
+// TIMER1 counts the TIMER0 wraps a few clocks late through the PRS
+#define CARRY_GUARD               16
+#else
+#define CARRY_GUARD               2
 #endif
 
+// PRS channel of the events captured by both timers. Any PRS producer can
+// drive it, the example pulses it from software.
+#define EVENT_PRS_CHANNEL         2
+
+// Timer clocks to wait for the captures of an event
+#define EVENT_TIMEOUT_TICKS       100000
+
+// LDMA channels moving the captures to the FIFO rings
+#define CAPTURE_LOW_LDMA_CH       0
+#define CAPTURE_HIGH_LDMA_CH      1
+
+// Entries in each capture ring, a power of 2
+#define CAPTURE_FIFO_SIZE         16
+
+/*******************************************************************************
+ ***************************   LOCAL VARIABLES   *******************************
+ ******************************************************************************/
+
+static cascade_ts_port_t timestampPort;
+
+static uint32_t captureLow[CAPTURE_FIFO_SIZE];
+static uint32_t captureHigh[CAPTURE_FIFO_SIZE];
+static LDMA_Descriptor_t captureLowDescriptor;
+static LDMA_Descriptor_t captureHighDescriptor;
+
+// Completed passes of each LDMA channel through its ring
+static volatile uint32_t captureLaps[2];
+
+static cascade_ts_fifo_t captureFifo;
+
+/*******************************************************************************
+ ***************************   GLOBAL VARIABLES   ******************************
+ ******************************************************************************/
+
+// Results of the self test, to watch in the debugger
+volatile uint64_t lastTimestamp;
+volatile uint32_t eventsCaptured;
+volatile uint32_t eventsLost;
+volatile uint32_t eventErrors;      // Timestamps outside their event window
+volatile uint32_t nowErrors;        // Time read going backwards
+volatile uint32_t captureLatencyMax;
+
 /**************************************************************************//**
  * @brief CMU initialization
  *****************************************************************************/
 static void initCMU(void)
 {
   // Enable peripheral clocks
-#if (PRS_MODE)
   CMU_ClockEnable(cmuClock_PRS, true);
-#endif
 
   CMU_ClockEnable(cmuClock_TIMER0, true);
 
   CMU_ClockEnable(cmuClock_TIMER1, true);
+
+  CMU_ClockEnable(cmuClock_LDMA, true);
 }
 
 #if (PRS_MODE)
@@ -74,12 +120,27 @@ static void initPRS(void)
 
 #endif
 
+/**************************************************************************//**
+ * @brief Capture the events on channel 2 of a timer
+ *****************************************************************************/
+static void initCapture(TIMER_TypeDef *timer)
+{
+  TIMER_InitCC_TypeDef captureInit = TIMER_INITCC_DEFAULT;
+
+  captureInit.mode = timerCCModeCapture;
+  captureInit.edge = timerEdgeRising;
+  captureInit.prsSel = EVENT_PRS_CHANNEL;
+  captureInit.prsInput = true;
+  captureInit.prsInputType = timerPrsInputAsyncPulse;
+
+  TIMER_InitCC(timer, 2, &captureInit);
+}
+
 /**************************************************************************//**
  * @brief TIMER0 initialization
  *****************************************************************************/
 static void initTIMER0(void)
 {
-  uint32_t timerFreq, topValue;
   TIMER_Init_TypeDef timer0_Init = TIMER_INIT_DEFAULT;
   TIMER_InitCC_TypeDef timer0_CCInit = TIMER_INITCC_DEFAULT;
 
@@ -108,18 +169,13 @@ static void initTIMER0(void)
   // Timer Compare/Capture channel 0 initialization
   TIMER_InitCC(TIMER0, 0, &timer0_CCInit);
 
-  /*
-   * Set the TOP register value.  Each time the counter overflows TOP
-   * is one half of the signal period.
-   */
-  timerFreq = CMU_ClockFreqGet(cmuClock_TIMER0) / (timer0_Init.prescale + 1);
-  topValue = timerFreq / (2 * TIMER0_OUT_FREQ) - 1;
-  TIMER_TopSet(TIMER0, topValue);
+  // The compare value stays 0 from reset: the match, and the PRS pulse, come
+  // right after each wrap.
 
-  // Enable TIMER0 interrupts
-  TIMER_IntEnable(TIMER0, TIMER_IEN_CC0 | TIMER_IEN_OF);
-  NVIC_ClearPendingIRQ(TIMER0_IRQn);
-  NVIC_EnableIRQ(TIMER0_IRQn);
+  initCapture(TIMER0);
+
+  // Count the full range, TIMER1 counts the wraps
+  TIMER_TopSet(TIMER0, TIMER_MaxCount(TIMER0));
 
   // Now start the TIMER
   TIMER_Enable(TIMER0, true);
@@ -173,12 +229,13 @@ static void initTIMER1(void)
   // Timer Compare/Capture channel 0 initialization
   TIMER_InitCC(TIMER1, 0, &timer1_CC0Init);
 
-  // Set the TOP register value.
+  initCapture(TIMER1);
 
-  TIMER_TopSet(TIMER1, TIMER1_TOP - 1);
+  // Count the full range, the wraps are counted in software if it is 16-bit
+  TIMER_TopSet(TIMER1, TIMER_MaxCount(TIMER1));
 
   // Enable TIMER1 interrupts
-  TIMER_IntEnable(TIMER1, TIMER_IEN_CC0 | TIMER_IEN_CC1 | TIMER_IEN_OF);
+  TIMER_IntEnable(TIMER1, TIMER_IEN_OF);
   NVIC_ClearPendingIRQ(TIMER1_IRQn);
   NVIC_EnableIRQ(TIMER1_IRQn);
 
@@ -186,22 +243,150 @@ static void initTIMER1(void)
   TIMER_Enable(TIMER1, true);
 }
 
-void TIMER0_IRQHandler(void)
+void TIMER1_IRQHandler(void)
 {
   // Acknowledge the interrupt
-  uint32_t flags = TIMER_IntGet(TIMER0);
+  uint32_t flags = TIMER_IntGet(TIMER1);
 
   // Clear interrupt flags
-  TIMER_IntClear(TIMER0, flags);
+  TIMER_IntClear(TIMER1, flags);
+
+  if (flags & TIMER_IF_OF) {
+    cascade_ts_high_wrapped();
+  }
 }
 
-void TIMER1_IRQHandler(void)
+/**************************************************************************//**
+ * @brief Timer access functions of the timestamp service
+ *****************************************************************************/
+static uint32_t lowGet(void)
 {
-  // Acknowledge the interrupt
-  uint32_t flags = TIMER_IntGet(TIMER1);
+  return TIMER_CounterGet(TIMER0);
+}
 
-  // Clear interrupt flags
-  TIMER_IntClear(TIMER1, flags);
+static uint32_t highGet(void)
+{
+  return TIMER_CounterGet(TIMER1);
+}
+
+static bool highWrapPending(void)
+{
+  return (TIMER_IntGet(TIMER1) & TIMER_IF_OF) != 0;
+}
+
+/**************************************************************************//**
+ * @brief Timestamp service initialization
+ *****************************************************************************/
+static void initTimestamps(void)
+{
+  timestampPort.low_get = lowGet;
+  timestampPort.high_get = highGet;
+  timestampPort.lowTop = TIMER_MaxCount(TIMER0);
+  timestampPort.highTop = TIMER_MaxCount(TIMER1);
+  timestampPort.carryGuard = CARRY_GUARD;
+
+  // A 32-bit TIMER1 makes 64 bits, no wraps to count
+  timestampPort.high_wrap_pending = NULL;
+  if (timestampPort.highTop != UINT32_MAX) {
+    timestampPort.high_wrap_pending = highWrapPending;
+  }
+
+  cascade_ts_init(&timestampPort);
+}
+
+/**************************************************************************//**
+ * @brief LDMA interrupt handler, counts the passes through the rings
+ *****************************************************************************/
+void LDMA_IRQHandler(void)
+{
+  // Clear interrupt flags and handle LDMA errors
+  uint32_t flags = LDMA_IntGet();
+  LDMA_IntClear(flags);
+  if (flags & LDMA_IF_ERROR) {
+    while (1) {}
+  }
+
+  if (flags & (1 << CAPTURE_LOW_LDMA_CH)) {
+    captureLaps[CAPTURE_LOW_LDMA_CH]++;
+  }
+  if (flags & (1 << CAPTURE_HIGH_LDMA_CH)) {
+    captureLaps[CAPTURE_HIGH_LDMA_CH]++;
+  }
+}
+
+/**************************************************************************//**
+ * @brief Number of captures an LDMA channel wrote to its ring so far
+ *
+ * The ring position comes from the channel destination address. A pass that
+ * just ended may not be counted by the interrupt yet: then its flag is still
+ * pending and the position is back at the start of the ring.
+ *****************************************************************************/
+static uint32_t capturesWritten(uint32_t channel, const uint32_t *ring)
+{
+  uint32_t laps, position;
+  bool pending;
+
+  do {
+    laps = captureLaps[channel];
+    position = (LDMA->CH[channel].DST - (uint32_t)ring) / sizeof(uint32_t);
+    pending = (LDMA_IntGet() & (1 << channel)) != 0;
+  } while (laps != captureLaps[channel]);
+
+  if (position >= CAPTURE_FIFO_SIZE) {
+    // End of a pass, before the descriptor is loaded again
+    position = 0;
+    if (pending) {
+      laps++;
+    }
+  } else if (pending && (position < (CAPTURE_FIFO_SIZE / 2))) {
+    laps++;
+  }
+  return laps * CAPTURE_FIFO_SIZE + position;
+}
+
+/**************************************************************************//**
+ * @brief Number of events with both captures in the rings
+ *****************************************************************************/
+static uint32_t captureHeadGet(void)
+{
+  uint32_t low = capturesWritten(CAPTURE_LOW_LDMA_CH, captureLow);
+  uint32_t high = capturesWritten(CAPTURE_HIGH_LDMA_CH, captureHigh);
+
+  return ((int32_t)(low - high) < 0) ? low : high;
+}
+
+/**************************************************************************//**
+ * @brief LDMA initialization
+ *
+ * Each timer's channel 2 captures go to a ring through a descriptor linked
+ * to itself, which raises an interrupt at the end of each pass.
+ *****************************************************************************/
+static void initLDMA(void)
+{
+  LDMA_Init_t init = LDMA_INIT_DEFAULT;
+  LDMA_TransferCfg_t lowCfg =
+    LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_TIMER0_CC2);
+  LDMA_TransferCfg_t highCfg =
+    LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_TIMER1_CC2);
+
+  LDMA_Init(&init);
+
+  captureLowDescriptor =
+    (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(TIMER0->CC[2].ICF),
+                                                        captureLow,
+                                                        CAPTURE_FIFO_SIZE,
+                                                        0);
+  captureHighDescriptor =
+    (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(TIMER1->CC[2].ICF),
+                                                        captureHigh,
+                                                        CAPTURE_FIFO_SIZE,
+                                                        0);
+
+  LDMA_StartTransfer(CAPTURE_LOW_LDMA_CH, &lowCfg, &captureLowDescriptor);
+  LDMA_StartTransfer(CAPTURE_HIGH_LDMA_CH, &highCfg, &captureHighDescriptor);
+
+  cascade_ts_fifo_init(&captureFifo, captureLow, captureHigh,
+                       CAPTURE_FIFO_SIZE, captureHeadGet);
 }
 
 /*******************************************************************************
@@ -222,12 +407,47 @@ void app_init(void)
   // Initialize the TIMERs
   initTIMER0();
   initTIMER1();
+
+  // Initialize the timestamps and their capture FIFO
+  initTimestamps();
+  initLDMA();
 }
 
 /***************************************************************************//**
  * App ticking function.
+ *
+ * Self test: pulse the event channel between two time reads and check that
+ * the captured timestamp falls in between.
  ******************************************************************************/
 void app_process_action(void)
 {
-  // Nothing
+  static uint64_t lastNow;
+  uint64_t before, after, timestamp;
+  uint32_t count;
+
+  before = cascade_ts_now();
+  if (before < lastNow) {
+    nowErrors++;
+  }
+  PRS_PulseTrigger(1 << EVENT_PRS_CHANNEL);
+
+  // Wait for the LDMA to move both captures
+  do {
+    count = cascade_ts_fifo_read(&captureFifo, &timestamp, 1);
+    after = cascade_ts_now();
+  } while ((count == 0) && ((after - before) < EVENT_TIMEOUT_TICKS));
+  lastNow = after;
+
+  if (count == 0) {
+    eventErrors++;
+    return;
+  }
+  if ((timestamp < before) || (timestamp > after)) {
+    eventErrors++;
+  } else if ((timestamp - before) > captureLatencyMax) {
+    captureLatencyMax = (uint32_t)(timestamp - before);
+  }
+  lastTimestamp = timestamp;
+  eventsCaptured++;
+  eventsLost = captureFifo.lost;
 }
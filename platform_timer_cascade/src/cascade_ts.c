@@ -0,0 +1,182 @@
+/***************************************************************************//**
+ * @file cascade_ts.c
+ * @brief 64-bit timestamps from two cascaded timers
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+
+#include "cascade_ts.h"
+
+static const cascade_ts_port_t *tsPort;
+
+// Widths of the counters, the hardware part is lowBits + highBits wide
+static uint32_t lowBits;
+static uint32_t hardwareBits;
+
+// Wraps of the high timer, only used when the hardware part is narrower
+// than 64 bits
+static volatile uint32_t highWraps;
+
+/***************************************************************************//**
+ * Number of bits of a counter counting up to top.
+ ******************************************************************************/
+static uint32_t counter_bits(uint32_t top)
+{
+  uint32_t bits = 0;
+
+  while ((bits < 32) && ((top >> bits) != 0)) {
+    bits++;
+  }
+  return bits;
+}
+
+/***************************************************************************//**
+ * Mask of the hardware part of a timestamp.
+ ******************************************************************************/
+static uint64_t hardware_mask(void)
+{
+  return (hardwareBits >= 64) ? UINT64_MAX : ((1ULL << hardwareBits) - 1);
+}
+
+/***************************************************************************//**
+ * Initialize the service.
+ ******************************************************************************/
+void cascade_ts_init(const cascade_ts_port_t *port)
+{
+  tsPort = port;
+  lowBits = counter_bits(port->lowTop);
+  hardwareBits = lowBits + counter_bits(port->highTop);
+  highWraps = 0;
+}
+
+/***************************************************************************//**
+ * Count a wrap of the high timer.
+ ******************************************************************************/
+void cascade_ts_high_wrapped(void)
+{
+  highWraps++;
+}
+
+/***************************************************************************//**
+ * Read the current time.
+ ******************************************************************************/
+uint64_t cascade_ts_now(void)
+{
+  uint32_t wraps, high, low, check;
+  bool pending;
+  uint64_t now;
+
+  /*
+   * The high count read before and after the low count must agree, or a
+   * carry came in between. A low count within the carry guard means the
+   * carry may still be on its way: then wait for it to pass. The wrap count
+   * must not change either, a pending wrap is taken into account if the
+   * high count is past it.
+   */
+  do {
+    wraps = highWraps;
+    high = tsPort->high_get();
+    low = tsPort->low_get();
+    check = tsPort->high_get();
+    pending = (tsPort->high_wrap_pending != NULL)
+              && tsPort->high_wrap_pending();
+  } while ((check != high) || (low < tsPort->carryGuard)
+           || (wraps != highWraps));
+
+  if (pending && (high <= (tsPort->highTop >> 1))) {
+    wraps++;
+  }
+
+  now = ((uint64_t)high << lowBits) | low;
+  if (hardwareBits < 64) {
+    now |= (uint64_t)wraps << hardwareBits;
+  }
+  return now;
+}
+
+/***************************************************************************//**
+ * Build the timestamp of a captured event.
+ ******************************************************************************/
+uint64_t cascade_ts_capture(uint32_t low, uint32_t high, uint64_t now)
+{
+  uint64_t mask = hardware_mask();
+  uint64_t period = 1ULL << lowBits;
+  uint64_t age;
+
+  // Time from the event to now, modulo the width of the hardware counters
+  age = (now - (((uint64_t)high << lowBits) | low)) & mask;
+
+  // Right after a low timer wrap, the high capture may miss the carry. The
+  // event is then one low period later than the captures say, unless that
+  // is after now.
+  if ((low < tsPort->carryGuard) && (age >= period)) {
+    age -= period;
+  }
+  return now - age;
+}
+
+/***************************************************************************//**
+ * Initialize a capture FIFO.
+ ******************************************************************************/
+void cascade_ts_fifo_init(cascade_ts_fifo_t *fifo,
+                          const volatile uint32_t *low,
+                          const volatile uint32_t *high,
+                          uint32_t size,
+                          uint32_t (*head_get)(void))
+{
+  fifo->low = low;
+  fifo->high = high;
+  fifo->size = size;
+  fifo->head_get = head_get;
+  fifo->tail = head_get();
+  fifo->lost = 0;
+}
+
+/***************************************************************************//**
+ * Read event timestamps from a capture FIFO.
+ ******************************************************************************/
+uint32_t cascade_ts_fifo_read(cascade_ts_fifo_t *fifo,
+                              uint64_t *timestamps,
+                              uint32_t max)
+{
+  uint32_t head = fifo->head_get();
+  uint32_t count = 0, index, low, high;
+  uint32_t usable = fifo->size - 2;
+  uint64_t now;
+
+  // The LDMA may be writing the next event already, and the ring ahead one
+  // more, so only size - 2 events behind the head are safe to read.
+  if ((head - fifo->tail) > usable) {
+    fifo->lost += head - fifo->tail - usable;
+    fifo->tail = head - usable;
+  }
+
+  // All events up to head were captured before this.
+  now = cascade_ts_now();
+
+  while ((fifo->tail != head) && (count < max)) {
+    index = fifo->tail & (fifo->size - 1);
+    low = fifo->low[index];
+    high = fifo->high[index];
+    // The entry may have been overwritten while it was read.
+    if ((fifo->head_get() - fifo->tail) > usable) {
+      fifo->lost++;
+    } else {
+      timestamps[count++] = cascade_ts_capture(low, high, now);
+    }
+    fifo->tail++;
+  }
+  return count;
+}
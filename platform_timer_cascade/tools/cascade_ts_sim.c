@@ -0,0 +1,347 @@
+/***************************************************************************//**
+ * @file cascade_ts_sim.c
+ * @brief Host test of the cascaded timer timestamps against racing counters
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ *******************************************************************************
+ *
+ * Runs ../src/cascade_ts.c against simulated timers that keep counting while
+ * they are read. Every register access takes a few clocks, interrupts come
+ * between accesses at random and run the high timer wrap handler late, and
+ * the high timer counts the low timer wraps a few clocks late. Narrow timers
+ * make the wraps frequent.
+ *
+ * Checks that:
+ *  - each cascade_ts_now() value is the count at some point of the call, and
+ *    the values only go up,
+ *  - captures resolve to their event time, including right after a wrap,
+ *  - the capture FIFO returns each event once and in order, with the LDMA
+ *    writing the rings while they are read, and counts the overwritten ones.
+ *
+ * A plain high-low read is run on the same counters for comparison.
+ *
+ * Build:
+ *   cc -O2 -I../inc -o cascade_ts_sim cascade_ts_sim.c ../src/cascade_ts.c
+ *
+ * Usage:
+ *   cascade_ts_sim [reads]
+ *
+ * The exit status is 1 if any check failed.
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cascade_ts.h"
+
+#define FIFO_SIZE 16
+
+// Simulated timers
+static uint64_t now;            // Clocks since start
+static uint32_t lowBits;
+static uint32_t highBits;
+static uint32_t carryLag;       // Clocks the high timer counts a wrap late
+static uint64_t wrapsHandled;   // High timer wraps the handler counted
+static uint64_t preemptMax;     // Longest interrupt, in clocks
+
+// Simulated LDMA
+static uint32_t ringLow[FIFO_SIZE];
+static uint32_t ringHigh[FIFO_SIZE];
+#define MAX_EVENTS (1u << 17)
+static uint64_t eventTimes[MAX_EVENTS];
+static uint32_t eventCount;     // Events captured
+static uint32_t lowWritten;     // Events the low ring got
+static uint32_t highWritten;    // Events the high ring got
+static bool ldmaRunning;
+
+static uint32_t random32(void)
+{
+  return ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+}
+
+static uint64_t random64(void)
+{
+  return ((uint64_t)random32() << 32) | random32();
+}
+
+static uint64_t mask(uint32_t bits)
+{
+  return (bits >= 64) ? UINT64_MAX : ((1ULL << bits) - 1);
+}
+
+/***************************************************************************//**
+ * Number of low timer wraps the high timer has counted at time t.
+ ******************************************************************************/
+static uint64_t high_counted(uint64_t t)
+{
+  return (t < carryLag) ? 0 : ((t - carryLag) >> lowBits);
+}
+
+/***************************************************************************//**
+ * High timer wrap interrupt: count the wraps not handled yet.
+ ******************************************************************************/
+static void high_wrap_irq(void)
+{
+  uint64_t wraps = high_counted(now) >> highBits;
+
+  if (lowBits + highBits >= 64) {
+    return;
+  }
+  while (wrapsHandled < wraps) {
+    wrapsHandled++;
+    cascade_ts_high_wrapped();
+  }
+}
+
+/***************************************************************************//**
+ * LDMA: move the captures of the next events to the rings, one ring at a
+ * time so that the reader sees them half done.
+ ******************************************************************************/
+static void ldma_step(void)
+{
+  uint32_t writes = ldmaRunning ? (random32() % 5) : 0;
+
+  while (writes-- > 0) {
+    if ((lowWritten == highWritten) && (lowWritten < eventCount)) {
+      uint64_t t = eventTimes[lowWritten];
+      ringLow[lowWritten % FIFO_SIZE] = (uint32_t)(t & mask(lowBits));
+      lowWritten++;
+    } else if (highWritten < lowWritten) {
+      uint64_t t = eventTimes[highWritten];
+      ringHigh[highWritten % FIFO_SIZE] =
+        (uint32_t)(high_counted(t) & mask(highBits));
+      highWritten++;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * Time passes during a register access, and an interrupt may come.
+ ******************************************************************************/
+static void access(void)
+{
+  now += 1 + (random32() % 3);
+  if ((random32() % 8) == 0) {
+    // Interrupted for a while
+    now += random64() % preemptMax;
+    high_wrap_irq();
+  }
+  ldma_step();
+}
+
+static uint32_t low_get(void)
+{
+  uint32_t low = (uint32_t)(now & mask(lowBits));
+
+  access();
+  return low;
+}
+
+static uint32_t high_get(void)
+{
+  uint32_t high = (uint32_t)(high_counted(now) & mask(highBits));
+
+  access();
+  return high;
+}
+
+static bool high_wrap_pending(void)
+{
+  bool pending = (high_counted(now) >> highBits) > wrapsHandled;
+
+  access();
+  return pending;
+}
+
+static uint32_t head_get(void)
+{
+  uint32_t head = (lowWritten < highWritten) ? lowWritten : highWritten;
+
+  access();
+  return head;
+}
+
+/***************************************************************************//**
+ * Set up the simulated timers and the service.
+ ******************************************************************************/
+static cascade_ts_port_t port;
+
+static void setup(uint32_t low, uint32_t high, uint32_t lag, uint32_t guard)
+{
+  lowBits = low;
+  highBits = high;
+  carryLag = lag;
+  now = random32();
+  wrapsHandled = high_counted(now) >> highBits;
+  eventCount = lowWritten = highWritten = 0;
+  ldmaRunning = false;
+  preemptMax = 4ULL << lowBits;
+
+  port.low_get = low_get;
+  port.high_get = high_get;
+  port.high_wrap_pending = (low + high < 64) ? high_wrap_pending : NULL;
+  port.lowTop = (uint32_t)mask(low);
+  port.highTop = (uint32_t)mask(high);
+  port.carryGuard = guard;
+  cascade_ts_init(&port);
+  // The service starts counting wraps from where the handler is now.
+  now &= mask(low + high);
+  wrapsHandled = 0;
+}
+
+/***************************************************************************//**
+ * Coherent reads against the racing counter, and plain ones for comparison.
+ ******************************************************************************/
+static uint32_t check_reads(uint32_t reads, uint32_t *plainErrors)
+{
+  uint32_t errors = 0;
+  uint64_t start, value, last = 0, high;
+
+  *plainErrors = 0;
+  for (uint32_t i = 0; i < reads; i++) {
+    start = now;
+    value = cascade_ts_now();
+    if ((value < start) || (value > now) || (value < last)) {
+      errors++;
+    }
+    last = value;
+
+    // Plain read: high, then low
+    start = now;
+    high = high_get();
+    value = (high << lowBits) | low_get();
+    if ((lowBits + highBits) < 64) {
+      value |= wrapsHandled << (lowBits + highBits);
+    }
+    if ((value < start) || (value > now)) {
+      (*plainErrors)++;
+    }
+  }
+  return errors;
+}
+
+/***************************************************************************//**
+ * Captures at random times and right after wraps, resolved a little later.
+ ******************************************************************************/
+static uint32_t check_captures(uint32_t count)
+{
+  uint32_t errors = 0;
+  uint64_t event, later, period = 1ULL << lowBits;
+
+  for (uint32_t i = 0; i < count; i++) {
+    event = now + random32() % (4 * period);
+    if (i & 1) {
+      // Right after a wrap, within the carry lag
+      event = (event & ~(period - 1)) + period + random32() % (carryLag + 1);
+    }
+    // Read within one low timer period
+    later = event + random32() % period;
+    if (cascade_ts_capture((uint32_t)(event & mask(lowBits)),
+                           (uint32_t)(high_counted(event) & mask(highBits)),
+                           later) != event) {
+      errors++;
+    }
+    now = later;
+    high_wrap_irq();
+  }
+  return errors;
+}
+
+/***************************************************************************//**
+ * Events captured by the LDMA while the FIFO is read, with overruns.
+ *
+ * The events are close enough for the FIFO to hold less than one low timer
+ * period, as captures right after a wrap need.
+ ******************************************************************************/
+static uint32_t check_fifo(uint32_t rounds, uint32_t *lost)
+{
+  cascade_ts_fifo_t fifo;
+  uint64_t timestamps[FIFO_SIZE];
+  uint32_t errors = 0, matched = 0, next, read = 0, n, burst;
+  uint32_t spacing = (1u << lowBits) / (16 * FIFO_SIZE);
+
+  ldmaRunning = true;
+  preemptMax = 4;
+  cascade_ts_fifo_init(&fifo, ringLow, ringHigh, FIFO_SIZE, head_get);
+  for (uint32_t round = 0; ; round++) {
+    if (round < rounds) {
+      // A burst of events, sometimes more than the FIFO holds
+      burst = random32() % ((round % 16) ? 6 : 3 * FIFO_SIZE);
+      for (uint32_t i = 0; (i < burst) && (eventCount < MAX_EVENTS); i++) {
+        now += 1 + random32() % (spacing + 1);
+        eventTimes[eventCount++] = now;
+      }
+    } else if (fifo.tail == eventCount) {
+      break;
+    }
+    // Each timestamp must be a later event than the one before
+    n = cascade_ts_fifo_read(&fifo, timestamps, FIFO_SIZE);
+    for (uint32_t i = 0; i < n; i++) {
+      next = matched;
+      while ((next < eventCount) && (eventTimes[next] != timestamps[i])) {
+        next++;
+      }
+      if (next < eventCount) {
+        matched = next + 1;
+      } else {
+        errors++;
+      }
+    }
+    read += n;
+  }
+  if ((read + fifo.lost) != eventCount) {
+    errors++;
+  }
+  *lost = fifo.lost;
+  return errors;
+}
+
+int main(int argc, char **argv)
+{
+  static const struct {
+    uint32_t lowBits, highBits, lag, guard;
+    const char *name;
+  } configs[] = {
+    { 32, 32, 0, 1, "32+32 bits, cascade" },
+    { 32, 16, 0, 1, "32+16 bits, cascade (xG21)" },
+    { 32, 32, 3, 16, "32+32 bits, PRS" },
+    { 8, 8, 0, 1, "8+8 bits, cascade" },
+    { 8, 8, 3, 16, "8+8 bits, PRS" },
+    { 8, 4, 5, 8, "8+4 bits, PRS" },
+  };
+  uint32_t reads = 200000, failures = 0;
+  uint32_t errors, plain, captureErrors, fifoErrors, lost;
+
+  if (argc > 1) {
+    reads = (uint32_t)strtoul(argv[1], NULL, 0);
+  }
+  srand(1);
+
+  printf("%-28s %10s %10s %10s %10s %8s\n", "timers", "read err",
+         "plain err", "capt err", "fifo err", "lost");
+  for (uint32_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+    setup(configs[c].lowBits, configs[c].highBits, configs[c].lag,
+          configs[c].guard);
+    errors = check_reads(reads, &plain);
+    captureErrors = check_captures(reads / 4);
+    fifoErrors = check_fifo(reads / 16, &lost);
+    printf("%-28s %10u %10u %10u %10u %8u\n", configs[c].name, errors, plain,
+           captureErrors, fifoErrors, lost);
+    failures += errors + captureErrors + fifoErrors;
+  }
+  printf("%s\n", failures ? "FAILED" : "all checks passed");
+  return failures ? 1 : 0;
+}
@@ -46,6 +46,7 @@
 #include "em_ldma.h"
 #include "em_prs.h"
 #include "em_rtcc.h"
+#include "em_usart.h"
 
 // EFP
 #include "sl_efp_instance_config_brd4179b.h"
@@ -105,6 +106,16 @@ static sl_efp_handle_t      efp = &efp_handle_data;
 uint32_t valbuf[NUM_SAMPLES];
 uint32_t timebuf[NUM_SAMPLES];
 
+/*
+ * Set STREAM_MODE to 1 to capture continuously instead of halting
+ * after NUM_SAMPLES conversions.  The LDMA then fills valbuf and
+ * timebuf in two halves, and each completed half is appended to a
+ * ring of stream blocks (see "Stream mode" below) while the next one
+ * is being captured.  Completed blocks are sent on a USART (see
+ * "Stream output" below).
+ */
+#define STREAM_MODE   0
+
 /*
  * PRS and LDMA channel assignments.
  *
@@ -123,10 +134,88 @@ uint32_t timebuf[NUM_SAMPLES];
 #define PRS_IADC_CH   1
 
 // Global LDMA structures
+#if (STREAM_MODE)
+LDMA_TransferCfg_t iadcXferCfg;
+LDMA_Descriptor_t  iadcXferDesc[2];
+LDMA_TransferCfg_t rtccXferCfg;
+LDMA_Descriptor_t  rtccXferDesc[2];
+#else
 LDMA_TransferCfg_t iadcXferCfg;
 LDMA_Descriptor_t  iadcXferDesc;
 LDMA_TransferCfg_t rtccXferCfg;
 LDMA_Descriptor_t  rtccXferDesc;
+#endif
+
+#if (STREAM_MODE)
+/*
+ * Stream mode
+ *
+ * The (timestamp, sample) pairs are stored in a ring of fixed size
+ * blocks.  Each block starts with the absolute 64-bit time of its
+ * first pair, so it can be decoded on its own once older blocks have
+ * been overwritten.  Each record in a block is
+ *
+ *   uint16_t  header     bits 11:0 sample, bits 14:12 number of time
+ *                        delta bytes (0 to 4), bit 15 zero
+ *   uint8_t   delta[n]   RTCC ticks since the previous pair, little
+ *                        endian (the first record of a block has none)
+ *
+ * so a pair takes 3 bytes while the triggers are less than 256 ticks
+ * (7.8 ms) apart.  The RTCC counter wraps after 2^32 ticks (36 hours);
+ * the unsigned delta is correct across the wrap and the block time
+ * keeps counting, as long as two triggers are less than 36 hours apart.
+ */
+#define STREAM_BLOCK_SIZE   256
+#define STREAM_BLOCKS       32
+#define STREAM_RECORD_MAX   (2 + 4)
+#define STREAM_SAMPLE_MASK  0x0FFF
+
+typedef struct {
+  uint32_t sequence;    // block number since start
+  uint32_t timeHigh;    // RTCC wraps before the first pair
+  uint32_t timeLow;     // RTCC count of the first pair
+  uint16_t records;     // number of records in data
+  uint16_t length;      // number of bytes used in data
+  uint8_t  data[STREAM_BLOCK_SIZE - 16];
+} streamBlock_t;
+
+// Block ring, the block being filled is streamRing[streamBlocks % STREAM_BLOCKS]
+streamBlock_t streamRing[STREAM_BLOCKS];
+volatile uint32_t streamBlocks = 0;
+
+// Halves of valbuf/timebuf completed by the LDMA and appended to the ring
+volatile uint32_t halvesCaptured = 0;
+uint32_t halvesStreamed = 0;
+
+// Halves overwritten by the LDMA before they were appended
+uint32_t halvesMissed = 0;
+
+// Absolute time of the last pair in RTCC ticks
+static uint64_t streamTime = 0;
+
+/*
+ * Stream output
+ *
+ * Each completed block is sent on USART0 TX as a frame of
+ *
+ *   uint16_t  sync       STREAM_SYNC, little endian
+ *   uint8_t   block[n]   the 16-byte block header and the length
+ *                        bytes of data used
+ *   uint16_t  checksum   sum of the block bytes, little endian
+ *
+ * PA5, the VCOM TX pin of these radio boards, is the trigger input
+ * here, so the frames go out on EXP header pin 4 (PC0) instead, to a
+ * USB to serial adapter at VDDX levels.  The ring only has to hold the
+ * blocks until they are sent.
+ */
+#define STREAM_TX_PORT      gpioPortC
+#define STREAM_TX_PIN       0
+#define STREAM_BAUDRATE     115200
+#define STREAM_SYNC         0x5AA5
+
+// Blocks sent on the USART, the next one is streamRing[streamSent % STREAM_BLOCKS]
+uint32_t streamSent = 0;
+#endif
 
 /*
  * These are the frequencies of the two IADC clocks related to
@@ -269,6 +358,142 @@ void rtccInit()
   RTCC_Init(&init);
 }
 
+#if (STREAM_MODE)
+void ldmaInit()
+{
+  LDMA_Init_t init = LDMA_INIT_DEFAULT;
+
+  /*
+   * Each channel loops over two descriptors, one per half of its
+   * buffer.  Only the IADC channel interrupts: its transfer always
+   * follows the timestamp transfer of the same trigger, so both halves
+   * are complete at that point.
+   */
+  LDMA_TransferCfg_t rtccXferCfg = (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_LDMAXBAR_PRSREQ0);
+
+  rtccXferDesc[0] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_WORD(
+      &(RTCC->CNT),               // source
+      timebuf,                    // destination
+      NUM_SAMPLES / 2,            // data transfer size
+      1);                         // link to the second half
+  rtccXferDesc[1] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_WORD(
+      &(RTCC->CNT),               // source
+      &timebuf[NUM_SAMPLES / 2],  // destination
+      NUM_SAMPLES / 2,            // data transfer size
+      -1);                        // link back to the first half
+  rtccXferDesc[0].xfer.doneIfs = 0;
+  rtccXferDesc[1].xfer.doneIfs = 0;
+
+  LDMA_TransferCfg_t iadcXferCfg = (LDMA_TransferCfg_t)LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_IADC0_IADC_SINGLE);
+
+  iadcXferDesc[0] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_WORD(
+      &(IADC0->SINGLEFIFODATA),   // source
+      valbuf,                     // destination
+      NUM_SAMPLES / 2,            // data transfer size
+      1);                         // link to the second half
+  iadcXferDesc[1] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_WORD(
+      &(IADC0->SINGLEFIFODATA),   // source
+      &valbuf[NUM_SAMPLES / 2],   // destination
+      NUM_SAMPLES / 2,            // data transfer size
+      -1);                        // link back to the first half
+
+  // Initialize LDMA with default configuration
+  LDMA_Init(&init);
+
+  LDMA_StartTransfer(LDMA_RTCC_CH, &rtccXferCfg, rtccXferDesc);
+  LDMA_StartTransfer(LDMA_IADC_CH, &iadcXferCfg, iadcXferDesc);
+}
+
+void LDMA_IRQHandler(void)
+{
+  // Clear interrupt flags and let main() stream the completed half
+  LDMA_IntClear(1 << LDMA_IADC_CH);
+  halvesCaptured++;
+}
+
+// Start the next block of the ring, overwriting the oldest one
+static void streamNewBlock(void)
+{
+  streamBlock_t *block;
+
+  streamBlocks++;
+  block = &streamRing[streamBlocks % STREAM_BLOCKS];
+  block->sequence = streamBlocks;
+  block->records = 0;
+  block->length = 0;
+}
+
+// Append a half of the capture buffers to the ring
+static void streamAppend(const uint32_t *times, const uint32_t *samples, uint32_t count)
+{
+  streamBlock_t *block = &streamRing[streamBlocks % STREAM_BLOCKS];
+  uint32_t delta;
+  uint32_t bytes;
+  uint8_t *record;
+
+  for (uint32_t i = 0; i < count; i++) {
+    // Unsigned difference, correct across the RTCC wrap
+    delta = times[i] - (uint32_t)streamTime;
+    streamTime += delta;
+
+    if ((block->length + STREAM_RECORD_MAX) > sizeof(block->data)) {
+      streamNewBlock();
+      block = &streamRing[streamBlocks % STREAM_BLOCKS];
+    }
+    if (block->records == 0) {
+      // The block header holds the time of its first pair
+      block->timeHigh = (uint32_t)(streamTime >> 32);
+      block->timeLow = (uint32_t)streamTime;
+      delta = 0;
+    }
+
+    bytes = (delta == 0) ? 0 : ((32 - __CLZ(delta) + 7) / 8);
+    record = &block->data[block->length];
+    record[0] = (uint8_t)samples[i];
+    record[1] = (uint8_t)(((samples[i] & STREAM_SAMPLE_MASK) >> 8) | (bytes << 4));
+    for (uint32_t k = 0; k < bytes; k++) {
+      record[2 + k] = (uint8_t)(delta >> (8 * k));
+    }
+    block->length += 2 + bytes;
+    block->records++;
+  }
+}
+
+void streamInit(void)
+{
+  USART_InitAsync_TypeDef init = USART_INITASYNC_DEFAULT;
+
+  init.baudrate = STREAM_BAUDRATE;
+  init.enable = usartEnableTx;
+
+  GPIO_PinModeSet(STREAM_TX_PORT, STREAM_TX_PIN, gpioModePushPull, 1);
+  USART_InitAsync(USART0, &init);
+
+  GPIO->USARTROUTE[0].TXROUTE = (STREAM_TX_PORT << _GPIO_USART_TXROUTE_PORT_SHIFT)
+                                | (STREAM_TX_PIN << _GPIO_USART_TXROUTE_PIN_SHIFT);
+  GPIO->USARTROUTE[0].ROUTEEN = GPIO_USART_ROUTEEN_TXPEN;
+}
+
+// Send a completed block as one frame
+static void streamSend(const streamBlock_t *block)
+{
+  const uint8_t *bytes = (const uint8_t *)block;
+  uint32_t count = offsetof(streamBlock_t, data) + block->length;
+  uint16_t checksum = 0;
+
+  USART_Tx(USART0, (uint8_t)STREAM_SYNC);
+  USART_Tx(USART0, (uint8_t)(STREAM_SYNC >> 8));
+  for (uint32_t i = 0; i < count; i++) {
+    checksum += bytes[i];
+    USART_Tx(USART0, bytes[i]);
+  }
+  USART_Tx(USART0, (uint8_t)checksum);
+  USART_Tx(USART0, (uint8_t)(checksum >> 8));
+
+  // The USART stops in EM2, let the frame go out before sleeping again
+  while (!(USART0->STATUS & USART_STATUS_TXC));
+}
+#else
 void ldmaInit()
 {
   LDMA_Init_t init = LDMA_INIT_DEFAULT;
@@ -309,6 +534,7 @@ void LDMA_IRQHandler(void)
   IADC_command(IADC0, iadcCmdStopSingle);
 __BKPT(0);
 }
+#endif
 
 void iadcInit(void)
 {
@@ -407,7 +633,39 @@ int main(void)
 
   triggerInit();
 
+#if (STREAM_MODE)
+  streamInit();
+
+  // Stream each completed half while the LDMA captures the other one
+  while(1)
+  {
+    EMU_EnterEM2(true);
+
+    while (halvesStreamed != halvesCaptured)
+    {
+      uint32_t captured = halvesCaptured;
+
+      // Only the last completed half is still intact
+      if ((captured - halvesStreamed) > 1)
+      {
+        halvesMissed += captured - halvesStreamed - 1;
+        halvesStreamed = captured - 1;
+      }
+      uint32_t offset = (halvesStreamed & 1) * (NUM_SAMPLES / 2);
+      streamAppend(&timebuf[offset], &valbuf[offset], NUM_SAMPLES / 2);
+      halvesStreamed++;
+    }
+
+    // The LDMA keeps capturing in EM1 while the completed blocks are sent
+    while (streamSent != streamBlocks)
+    {
+      streamSend(&streamRing[streamSent % STREAM_BLOCKS]);
+      streamSent++;
+    }
+  }
+#else
   // Infinite loop
   while(1)
     EMU_EnterEM2(true);
+#endif
 }
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""
+Decoder for the stream mode blocks of main_adc_timestamp_prsx2.c.
+
+Reads a capture of the frames sent on the USART, or a binary dump of the
+streamRing array, reconstructs the absolute time of every (timestamp,
+sample) pair and estimates the jitter of the trigger intervals.
+
+Usage: decode_stream.py stream.bin [--ring] [--csv out.csv] [--tick-hz 32768]
+"""
+
+import argparse
+import math
+import struct
+import sys
+
+STREAM_BLOCK_SIZE = 256
+STREAM_SYNC = b"\xa5\x5a"
+BLOCK_HEADER = struct.Struct("<IIIHH")
+CHECKSUM = struct.Struct("<H")
+DATA_SIZE = STREAM_BLOCK_SIZE - BLOCK_HEADER.size
+
+
+def read_frames(data):
+    """Return the blocks of a USART capture with a valid checksum, and the
+    number of frames dropped."""
+    blocks = []
+    dropped = 0
+    offset = data.find(STREAM_SYNC)
+    while offset >= 0:
+        start = offset + len(STREAM_SYNC)
+        if start + BLOCK_HEADER.size > len(data):
+            break
+        sequence, time_high, time_low, records, length = \
+            BLOCK_HEADER.unpack_from(data, start)
+        end = start + BLOCK_HEADER.size + length
+        if (length <= DATA_SIZE and 0 < records <= length // 2
+                and end + CHECKSUM.size <= len(data)
+                and CHECKSUM.unpack_from(data, end)[0]
+                == sum(data[start:end]) & 0xFFFF):
+            payload = data[start + BLOCK_HEADER.size:end]
+            blocks.append((sequence, (time_high << 32) | time_low, records,
+                           payload))
+            offset = data.find(STREAM_SYNC, end + CHECKSUM.size)
+        else:
+            # Not a frame, or a corrupted one: resynchronize on the next sync
+            dropped += 1
+            offset = data.find(STREAM_SYNC, offset + 1)
+    blocks.sort(key=lambda block: block[0])
+    return blocks, dropped
+
+
+def read_ring(data):
+    """Return the used blocks of the dump, oldest first."""
+    blocks = []
+    for offset in range(0, len(data) - STREAM_BLOCK_SIZE + 1, STREAM_BLOCK_SIZE):
+        sequence, time_high, time_low, records, length = \
+            BLOCK_HEADER.unpack_from(data, offset)
+        if records == 0:
+            continue
+        start = offset + BLOCK_HEADER.size
+        payload = data[start:start + length]
+        blocks.append((sequence, (time_high << 32) | time_low, records, payload))
+    blocks.sort(key=lambda block: block[0])
+    return blocks
+
+
+def decode_block(time, records, payload):
+    """Yield (time in ticks, sample) for every record of a block."""
+    position = 0
+    for _ in range(records):
+        header = payload[position] | (payload[position + 1] << 8)
+        count = (header >> 12) & 0x7
+        delta = int.from_bytes(payload[position + 2:position + 2 + count],
+                               "little")
+        position += 2 + count
+        time += delta
+        yield time, header & 0x0FFF
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("dump", help="capture of the USART frames")
+    parser.add_argument("--ring", action="store_true",
+                        help="the file is a binary dump of streamRing")
+    parser.add_argument("--csv", help="write time (s) and sample to this file")
+    parser.add_argument("--tick-hz", type=float, default=32768.0,
+                        help="RTCC tick frequency (default 32768)")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as dump:
+        data = dump.read()
+    dropped = 0
+    if args.ring:
+        blocks = read_ring(data)
+    else:
+        blocks, dropped = read_frames(data)
+    if not blocks:
+        sys.exit("no data in " + args.dump)
+
+    pairs = []
+    intervals = []
+    gaps = 0
+    previous_sequence = None
+    for sequence, time, records, payload in blocks:
+        block_pairs = list(decode_block(time, records, payload))
+        # Intervals are only valid between blocks that follow each other
+        if previous_sequence is not None and sequence != previous_sequence + 1:
+            gaps += 1
+        elif pairs:
+            intervals.append(block_pairs[0][0] - pairs[-1][0])
+        intervals.extend(b[0] - a[0] for a, b in zip(block_pairs, block_pairs[1:]))
+        pairs.extend(block_pairs)
+        previous_sequence = sequence
+
+    if args.csv:
+        with open(args.csv, "w") as out:
+            out.write("time_s,sample\n")
+            for time, sample in pairs:
+                out.write("%.6f,%d\n" % (time / args.tick_hz, sample))
+
+    tick_us = 1e6 / args.tick_hz
+    print("blocks %d (%d to %d), gaps %d, pairs %d"
+          % (len(blocks), blocks[0][0], blocks[-1][0], gaps, len(pairs)))
+    if dropped:
+        print("%d corrupted frames dropped" % dropped)
+    print("time %.6f s to %.6f s"
+          % (pairs[0][0] / args.tick_hz, pairs[-1][0] / args.tick_hz))
+    if len(intervals) > 1:
+        mean = sum(intervals) / len(intervals)
+        variance = sum((i - mean) ** 2 for i in intervals) / (len(intervals) - 1)
+        print("interval mean %.3f us, min %.3f us, max %.3f us"
+              % (mean * tick_us, min(intervals) * tick_us,
+                 max(intervals) * tick_us))
+        # One tick of timestamp quantization alone gives tick/sqrt(6) rms
+        # on the difference of two timestamps
+        print("interval jitter %.3f us rms (quantization %.3f us rms)"
+              % (math.sqrt(variance) * tick_us, tick_us / math.sqrt(6)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,85 @@
+/***************************************************************************//**
+ * @file chacha_drbg.h
+ * @brief ChaCha20 deterministic random bit generator
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef CHACHA_DRBG_H
+#define CHACHA_DRBG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CHACHA_DRBG_SEED_WORDS  8
+
+/*
+ * ChaCha20 keystream generator. After every request the key is replaced by
+ * keystream that was not output, so that a captured state does not reveal
+ * earlier output. Seeding and reseeding mix entropy into the key.
+ */
+typedef struct {
+  uint32_t key[8];
+  uint32_t nonce[3];        // Request counter
+  bool seeded;
+  uint32_t reseeds;
+} chacha_drbg_t;
+
+/***************************************************************************//**
+ * Compute a ChaCha20 block (RFC 8439).
+ *
+ * @param[in] key 256-bit key.
+ * @param[in] counter Block counter.
+ * @param[in] nonce 96-bit nonce.
+ * @param[out] block Keystream block.
+ ******************************************************************************/
+void chacha20_block(const uint32_t key[8],
+                    uint32_t counter,
+                    const uint32_t nonce[3],
+                    uint32_t block[16]);
+
+/***************************************************************************//**
+ * Mix seed material into the key. The first call seeds the generator.
+ *
+ * @param[in] seed CHACHA_DRBG_SEED_WORDS words of full entropy.
+ ******************************************************************************/
+void chacha_drbg_reseed(chacha_drbg_t *drbg, const uint32_t *seed);
+
+/***************************************************************************//**
+ * Generate random bytes.
+ *
+ * @return False if the generator was never seeded.
+ ******************************************************************************/
+bool chacha_drbg_generate(chacha_drbg_t *drbg, uint8_t *buffer, size_t length);
+
+#endif // CHACHA_DRBG_H
@@ -0,0 +1,94 @@
+/***************************************************************************//**
+ * @file entropy_health.h
+ * @brief SP 800-90B continuous health tests
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef ENTROPY_HEALTH_H
+#define ENTROPY_HEALTH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Continuous health tests of NIST SP 800-90B section 4.4 on byte samples.
+ *
+ * The TRNG tests its noise source itself; these tests watch the conditioned
+ * output, assessed at full entropy (8 bits per byte), for faults such as a
+ * stuck or biased FIFO. The cutoffs are for a false positive probability of
+ * 2^-40 per sample:
+ *
+ *   repetition count     C = 1 + ceil(40 / 8)                       = 6
+ *   adaptive proportion  C = 1 + CRITBINOM(512, 2^-8, 1 - 2^-40)    = 19
+ */
+#ifndef ENTROPY_HEALTH_RCT_CUTOFF
+#define ENTROPY_HEALTH_RCT_CUTOFF   6
+#endif
+#ifndef ENTROPY_HEALTH_APT_CUTOFF
+#define ENTROPY_HEALTH_APT_CUTOFF   19
+#endif
+#ifndef ENTROPY_HEALTH_APT_WINDOW
+#define ENTROPY_HEALTH_APT_WINDOW   512
+#endif
+
+typedef struct {
+  bool started;
+  uint8_t rctSample;        // Sample being repeated
+  uint32_t rctCount;        // Times in a row it was seen
+  uint8_t aptSample;        // First sample of the window
+  uint32_t aptCount;        // Times it was seen in the window
+  uint32_t aptIndex;        // Samples of the window so far
+  uint32_t rctFailures;
+  uint32_t aptFailures;
+} entropy_health_t;
+
+/***************************************************************************//**
+ * Start the tests over, keeping the failure counters.
+ ******************************************************************************/
+void entropy_health_reset(entropy_health_t *health);
+
+/***************************************************************************//**
+ * Test one sample.
+ *
+ * @return False if a test failed with this sample. The tests start over.
+ ******************************************************************************/
+bool entropy_health_sample(entropy_health_t *health, uint8_t sample);
+
+/***************************************************************************//**
+ * Test the four bytes of a word, least significant first.
+ *
+ * @return False if a test failed.
+ ******************************************************************************/
+bool entropy_health_word(entropy_health_t *health, uint32_t word);
+
+#endif // ENTROPY_HEALTH_H
@@ -0,0 +1,104 @@
+/***************************************************************************//**
+ * @file entropy_pool.h
+ * @brief TRNG entropy pool with health tests and DRBG
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#ifndef ENTROPY_POOL_H
+#define ENTROPY_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Words of TRNG output held in RAM, a power of two
+#ifndef ENTROPY_POOL_WORDS
+#define ENTROPY_POOL_WORDS          256
+#endif
+
+// Words tested but not used after the TRNG is started or restarted, as the
+// start-up health testing of SP 800-90B (1024 samples)
+#ifndef ENTROPY_POOL_STARTUP_WORDS
+#define ENTROPY_POOL_STARTUP_WORDS  256
+#endif
+
+// Bytes generated before the DRBG is reseeded from the pool, and bytes after
+// which it refuses to generate more until it could be reseeded
+#ifndef ENTROPY_POOL_RESEED_BYTES
+#define ENTROPY_POOL_RESEED_BYTES   65536
+#endif
+#ifndef ENTROPY_POOL_RESEED_LIMIT
+#define ENTROPY_POOL_RESEED_LIMIT   (16 * ENTROPY_POOL_RESEED_BYTES)
+#endif
+
+typedef struct {
+  uint32_t words;           // Words added to the pool
+  uint32_t level;           // Words in the pool now
+  uint32_t rctFailures;     // Repetition count test failures
+  uint32_t aptFailures;     // Adaptive proportion test failures
+  uint32_t alarms;          // Noise alarms and health test failures of the TRNG
+  uint32_t reseeds;         // DRBG seedings
+} entropy_pool_stats_t;
+
+/***************************************************************************//**
+ * Configure the TRNG for conditioned output and start filling the pool from
+ * the TRNG interrupt.
+ ******************************************************************************/
+void entropy_pool_init(void);
+
+/***************************************************************************//**
+ * Check whether random data can be generated, that is whether the DRBG is
+ * seeded or the pool holds a seed.
+ ******************************************************************************/
+bool entropy_pool_ready(void);
+
+/***************************************************************************//**
+ * Get random bytes from the DRBG, reseeded from the pool every
+ * ENTROPY_POOL_RESEED_BYTES bytes.
+ *
+ * Not reentrant, call from one context only.
+ *
+ * @param[out] buffer Destination.
+ * @param[in] length Number of bytes.
+ *
+ * @return False if the DRBG could not be seeded, in which case the buffer is
+ * left unchanged.
+ ******************************************************************************/
+bool entropy_pool_get_random(uint8_t *buffer, size_t length);
+
+/***************************************************************************//**
+ * Get the pool counters.
+ ******************************************************************************/
+void entropy_pool_stats_get(entropy_pool_stats_t *stats);
+
+#endif // ENTROPY_POOL_H
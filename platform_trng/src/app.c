@@ -40,6 +40,11 @@
 #include "stdbool.h"
 
 #include "printf.h"
+#include "entropy_pool.h"
+
+// Bytes generated per call and calls made by the throughput benchmark
+#define BENCHMARK_BUFFER_SIZE   4096
+#define BENCHMARK_CALLS         16
 
 // Defining test data from gg11-rm section 32.3.4.1
 
@@ -89,11 +94,13 @@ uint32_t trng_test_out[] = {
   0x7586E1A7
 };
 
+static uint8_t benchmark_buffer[BENCHMARK_BUFFER_SIZE];
+
 // Function prototypes for Conditioning and Entropy Check
 bool trng_check_conditioning(void);
 bool trng_check_entropy(void);
-void trng_int_enable(void);
 void trng_reset(void);
+void trng_benchmark(void);
 
 /***************************************************************************//**
  * Initialize application.
@@ -117,14 +124,13 @@ void app_init(void)
   printf("TRNG Entropy Source Check -> %s\r\n\r\n",
          trng_status ? "PASSED" : "FAILED");
 
-  // software reset
-  trng_reset();
+  // Fill the entropy pool from the TRNG interrupt
+  entropy_pool_init();
 
-  // Enable Interrupts
-  trng_int_enable();
+  // Wait for the first seed, after the start-up tests
+  while (!entropy_pool_ready()) {}
 
-  // Enable trng
-  TRNG0->CONTROL |= TRNG_CONTROL_ENABLE;
+  trng_benchmark();
 }
 
 /***************************************************************************//**
@@ -132,9 +138,36 @@ void app_init(void)
  ******************************************************************************/
 void app_process_action(void)
 {
-  // get data from trng fifo
-  if (TRNG0->FIFOLEVEL > 0) {
-    printf("0x%08lX\r\n", __REV(TRNG0->FIFO));
+  static uint32_t alarms = 0;
+  static uint32_t failures = 0;
+  entropy_pool_stats_t stats;
+  uint8_t random[16];
+
+  // get data from the entropy pool
+  if (entropy_pool_get_random(random, sizeof(random))) {
+    printf("0x");
+    for (uint8_t i = 0; i < sizeof(random); i++) {
+      printf("%02X", random[i]);
+    }
+    printf("\r\n");
+  } else {
+    printf("No entropy available\r\n");
+  }
+
+  // state any alarm or health test failure since the last time
+  entropy_pool_stats_get(&stats);
+  if ((stats.alarms != alarms)
+      || ((stats.rctFailures + stats.aptFailures) != failures)) {
+    alarms = stats.alarms;
+    failures = stats.rctFailures + stats.aptFailures;
+    printf("\r\n====================================================\r\n");
+    printf("TRNG restarted after a failure\r\n");
+    printf("\t- %lu noise alarms or TRNG health test failures\r\n",
+           stats.alarms);
+    printf("\t- %lu repetition count test failures\r\n", stats.rctFailures);
+    printf("\t- %lu adaptive proportion test failures\r\n",
+           stats.aptFailures);
+    printf("====================================================\r\n");
   }
 
   // delay 500 ms
@@ -142,76 +175,42 @@ void app_process_action(void)
 }
 
 /***************************************************************************//**
- * TRNG0 Interrupt Handler
- *
- * Resets trng on test failure or noise alarm
+ * Measure the random data throughput of the entropy pool
  ******************************************************************************/
-void TRNG0_IRQHandler(void)
+void trng_benchmark(void)
 {
-  uint32_t temp = 0;
-
-  // get which interrupt flags are set
-  uint32_t flags = TRNG0->STATUS & 0x270;
-
-  // disable trng
-  TRNG0->CONTROL &= ~TRNG_CONTROL_ENABLE;
-
-  // empty fifo
-  while (TRNG0->FIFOLEVEL != 0) {
-    // dummy read to clear fifo before TRNG reset
-    temp |= TRNG0->FIFO;
-  }
-
-  // state which flag set
-  printf("\r\n====================================================\r\n");
-  printf("TRNG noise/failure flag set\r\n");
-  if (flags & _TRNG_STATUS_ALMIF_MASK >> _TRNG_STATUS_ALMIF_SHIFT) {
-    printf("\t- AIS32 Noise alarm detected\r\n");
-  }
-  if (flags & _TRNG_STATUS_PREIF_MASK >> _TRNG_STATUS_PREIF_SHIFT) {
-    printf("\t- AIS32 Preliminary Noise alarm detected\r\n");
-  }
-  if (flags & _TRNG_STATUS_APT4096IF_MASK >> _TRNG_STATUS_APT4096IF_SHIFT) {
-    printf(
-      "\t- Adaptive Proportion test (4096-sample window) failure detected\r\n");
-  }
-  if (flags & _TRNG_STATUS_APT64IF_MASK >> _TRNG_STATUS_APT64IF_SHIFT) {
-    printf(
-      "\t- Adaptive Proportion test (64-sample window) failure detected\r\n");
-  }
-  if (flags & _TRNG_STATUS_REPCOUNTIF_MASK >> _TRNG_STATUS_REPCOUNTIF_SHIFT) {
-    printf("\t- Repetition count test failure detected\r\n");
+  entropy_pool_stats_t stats;
+  uint32_t start, cycles;
+  uint32_t bytes = BENCHMARK_BUFFER_SIZE * BENCHMARK_CALLS;
+  uint32_t rate;
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  start = DWT->CYCCNT;
+  for (uint8_t i = 0; i < BENCHMARK_CALLS; i++) {
+    if (!entropy_pool_get_random(benchmark_buffer, BENCHMARK_BUFFER_SIZE)) {
+      printf("Entropy pool failed\r\n");
+      return;
+    }
   }
-  printf("Reseting TRNG\r\n");
-  printf("\r\n====================================================\r\n");
+  cycles = DWT->CYCCNT - start;
 
-  // software reset
-  trng_reset();
+  // Throughput in kB/s
+  rate = (uint32_t)(((uint64_t)bytes * CMU_ClockFreqGet(cmuClock_CORE))
+                    / cycles / 1000);
+  entropy_pool_stats_get(&stats);
 
-  // enable trng
-  TRNG0->CONTROL |= TRNG_CONTROL_ENABLE;
-}
-
-/***************************************************************************//**
- * Enable Interrupts for trng noise alarms
- *
- * Monitors the following:
- *  - AIS31 noise alarm
- *  - AIS31 preliminary noise alarm
- *  - 4096-sample adaptive proportion test failure
- *  - 64-sample adaptive proportion test failure
- *  - Repetition count test failure
- ******************************************************************************/
-void trng_int_enable(void)
-{
-  // Enable interrupts for all failure sources
-  TRNG0->CONTROL |= TRNG_CONTROL_ALMIEN | TRNG_CONTROL_PREIEN
-                    | TRNG_CONTROL_APT4096IEN | TRNG_CONTROL_APT64IEN
-                    | TRNG_CONTROL_REPCOUNTIEN;
-
-  // Enable NVIC
-  NVIC_ClearPendingIRQ(TRNG0_IRQn);
-  NVIC_EnableIRQ(TRNG0_IRQn);
+  printf("====================================================\r\n");
+  printf("Entropy pool throughput\r\n");
+  printf("====================================================\r\n");
+  printf("%-40s: %lu\r\n", "Bytes generated", bytes);
+  printf("%-40s: %lu\r\n", "CPU cycles", cycles);
+  printf("%-40s: %lu.%03lu MB/s\r\n", "Throughput", rate / 1000, rate % 1000);
+  printf("%-40s: %lu\r\n", "TRNG words pooled", stats.words);
+  printf("%-40s: %lu\r\n", "DRBG seedings", stats.reseeds);
+  printf("====================================================\r\n\r\n");
 }
 
 /***************************************************************************//**
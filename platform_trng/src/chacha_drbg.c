@@ -0,0 +1,169 @@
+/***************************************************************************//**
+ * @file chacha_drbg.c
+ * @brief ChaCha20 deterministic random bit generator
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "chacha_drbg.h"
+
+#define ROTL(x, n)  (((x) << (n)) | ((x) >> (32 - (n))))
+
+#define QUARTER_ROUND(a, b, c, d) \
+  do {                            \
+    a += b; d ^= a; d = ROTL(d, 16); \
+    c += d; b ^= c; b = ROTL(b, 12); \
+    a += b; d ^= a; d = ROTL(d, 8);  \
+    c += d; b ^= c; b = ROTL(b, 7);  \
+  } while (0)
+
+// Nonce of the key derivation on reseed, never reached by the request counter
+static const uint32_t reseedNonce[3] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF };
+
+/***************************************************************************//**
+ * Compute a ChaCha20 block.
+ ******************************************************************************/
+void chacha20_block(const uint32_t key[8],
+                    uint32_t counter,
+                    const uint32_t nonce[3],
+                    uint32_t block[16])
+{
+  uint32_t x[16];
+  uint32_t i;
+
+  // "expand 32-byte k"
+  x[0] = 0x61707865;
+  x[1] = 0x3320646e;
+  x[2] = 0x79622d32;
+  x[3] = 0x6b206574;
+  for (i = 0; i < 8; i++) {
+    x[4 + i] = key[i];
+  }
+  x[12] = counter;
+  x[13] = nonce[0];
+  x[14] = nonce[1];
+  x[15] = nonce[2];
+  memcpy(block, x, sizeof(x));
+
+  for (i = 0; i < 10; i++) {
+    QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+    QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+    QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+    QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+    QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+    QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+    QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+    QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+  }
+
+  for (i = 0; i < 16; i++) {
+    block[i] += x[i];
+  }
+}
+
+/***************************************************************************//**
+ * Store keystream words as bytes, least significant first.
+ ******************************************************************************/
+static void store_bytes(uint8_t *buffer, const uint32_t *words, size_t length)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  memcpy(buffer, words, length);
+#else
+  for (size_t i = 0; i < length; i++) {
+    buffer[i] = (uint8_t)(words[i >> 2] >> (8 * (i & 3)));
+  }
+#endif
+}
+
+/***************************************************************************//**
+ * Mix seed material into the key.
+ ******************************************************************************/
+void chacha_drbg_reseed(chacha_drbg_t *drbg, const uint32_t *seed)
+{
+  uint32_t block[16];
+
+  if (!drbg->seeded) {
+    memset(drbg, 0, sizeof(*drbg));
+  }
+
+  // The new key depends on the old one and on the seed, so that either
+  // being random is enough.
+  chacha20_block(drbg->key, drbg->reseeds, reseedNonce, block);
+  for (uint32_t i = 0; i < 8; i++) {
+    drbg->key[i] = block[i] ^ seed[i];
+  }
+  memset(block, 0, sizeof(block));
+
+  drbg->seeded = true;
+  drbg->reseeds++;
+}
+
+/***************************************************************************//**
+ * Generate random bytes.
+ ******************************************************************************/
+bool chacha_drbg_generate(chacha_drbg_t *drbg, uint8_t *buffer, size_t length)
+{
+  uint32_t block[16];
+  uint32_t counter = 0;
+
+  if (!drbg->seeded) {
+    return false;
+  }
+
+  while (length >= sizeof(block)) {
+    chacha20_block(drbg->key, counter++, drbg->nonce, block);
+    store_bytes(buffer, block, sizeof(block));
+    buffer += sizeof(block);
+    length -= sizeof(block);
+  }
+
+  if (length > 32) {
+    chacha20_block(drbg->key, counter++, drbg->nonce, block);
+    store_bytes(buffer, block, length);
+    length = 0;
+  }
+
+  // The next key is keystream that is never output. A tail of up to 32 bytes
+  // takes the other half of its block.
+  chacha20_block(drbg->key, counter, drbg->nonce, block);
+  store_bytes(buffer, &block[8], length);
+  memcpy(drbg->key, block, sizeof(drbg->key));
+  memset(block, 0, sizeof(block));
+
+  // Requests never reach the reseed nonce
+  if (++drbg->nonce[0] == 0) {
+    drbg->nonce[1]++;
+  }
+  return true;
+}
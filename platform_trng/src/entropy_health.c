@@ -0,0 +1,112 @@
+/***************************************************************************//**
+ * @file entropy_health.c
+ * @brief SP 800-90B continuous health tests
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#include "entropy_health.h"
+
+/***************************************************************************//**
+ * Start the tests over, keeping the failure counters.
+ ******************************************************************************/
+void entropy_health_reset(entropy_health_t *health)
+{
+  health->started = false;
+  health->rctCount = 0;
+  health->aptCount = 0;
+  health->aptIndex = 0;
+}
+
+/***************************************************************************//**
+ * Test one sample.
+ ******************************************************************************/
+bool entropy_health_sample(entropy_health_t *health, uint8_t sample)
+{
+  bool passed = true;
+
+  if (!health->started) {
+    health->started = true;
+    health->rctSample = sample;
+    health->rctCount = 1;
+    health->aptSample = sample;
+    health->aptCount = 1;
+    health->aptIndex = 1;
+    return true;
+  }
+
+  // Repetition count test: the same sample too many times in a row
+  if (sample == health->rctSample) {
+    if (++health->rctCount >= ENTROPY_HEALTH_RCT_CUTOFF) {
+      health->rctFailures++;
+      passed = false;
+    }
+  } else {
+    health->rctSample = sample;
+    health->rctCount = 1;
+  }
+
+  // Adaptive proportion test: the first sample of a window too often in it
+  if (health->aptIndex == ENTROPY_HEALTH_APT_WINDOW) {
+    health->aptSample = sample;
+    health->aptCount = 1;
+    health->aptIndex = 1;
+  } else {
+    if (sample == health->aptSample) {
+      if (++health->aptCount >= ENTROPY_HEALTH_APT_CUTOFF) {
+        health->aptFailures++;
+        passed = false;
+      }
+    }
+    health->aptIndex++;
+  }
+
+  if (!passed) {
+    entropy_health_reset(health);
+  }
+  return passed;
+}
+
+/***************************************************************************//**
+ * Test the four bytes of a word.
+ ******************************************************************************/
+bool entropy_health_word(entropy_health_t *health, uint32_t word)
+{
+  bool passed = true;
+
+  for (uint32_t i = 0; i < 4; i++) {
+    if (!entropy_health_sample(health, (uint8_t)(word >> (8 * i)))) {
+      passed = false;
+    }
+  }
+  return passed;
+}
@@ -0,0 +1,230 @@
+/***************************************************************************//**
+ * @file entropy_pool.c
+ * @brief TRNG entropy pool with health tests and DRBG
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+#include "em_cmu.h"
+#include "em_core.h"
+
+#include "chacha_drbg.h"
+#include "entropy_health.h"
+#include "entropy_pool.h"
+
+#if (ENTROPY_POOL_WORDS & (ENTROPY_POOL_WORDS - 1))
+#error "ENTROPY_POOL_WORDS must be a power of two"
+#endif
+
+#define TRNG_ALARMS (TRNG_STATUS_PREIF | TRNG_STATUS_ALMIF                   \
+                     | TRNG_STATUS_APT4096IF | TRNG_STATUS_APT64IF           \
+                     | TRNG_STATUS_REPCOUNTIF)
+
+// Ring of TRNG words, filled by the interrupt handler and emptied by
+// entropy_pool_get_random()
+static uint32_t pool[ENTROPY_POOL_WORDS];
+static volatile uint32_t poolHead = 0;
+static volatile uint32_t poolTail = 0;
+
+// Words still to be discarded after a (re)start
+static uint32_t startupWords;
+
+static entropy_health_t health;
+static chacha_drbg_t drbg;
+static uint32_t bytesSinceReseed;
+
+static volatile uint32_t poolWords;
+static volatile uint32_t poolAlarms;
+
+/***************************************************************************//**
+ * Soft reset the TRNG and start over with start-up testing. Anything in the
+ * pool was collected before the failure and is dropped.
+ ******************************************************************************/
+static void trng_restart(void)
+{
+  TRNG0->CONTROL &= ~TRNG_CONTROL_ENABLE;
+  while (TRNG0->FIFOLEVEL != 0) {
+    (void)TRNG0->FIFO;
+  }
+  TRNG0->CONTROL |= TRNG_CONTROL_SOFTRESET;
+  TRNG0->CONTROL &= ~TRNG_CONTROL_SOFTRESET;
+
+  poolTail = poolHead;
+  entropy_health_reset(&health);
+  startupWords = ENTROPY_POOL_STARTUP_WORDS;
+
+  TRNG0->CONTROL |= TRNG_CONTROL_FULLIEN | TRNG_CONTROL_ENABLE;
+}
+
+/***************************************************************************//**
+ * TRNG0 Interrupt Handler
+ *
+ * Moves the FIFO into the pool through the health tests, or restarts the
+ * TRNG on a noise alarm, a TRNG health test failure or a software health
+ * test failure.
+ ******************************************************************************/
+void TRNG0_IRQHandler(void)
+{
+  uint32_t status = TRNG0->STATUS;
+  uint32_t level, word;
+
+  if (status & TRNG_ALARMS) {
+    poolAlarms++;
+    trng_restart();
+    return;
+  }
+
+  level = TRNG0->FIFOLEVEL;
+  while (level-- > 0) {
+    word = TRNG0->FIFO;
+    if (!entropy_health_word(&health, word)) {
+      trng_restart();
+      return;
+    }
+    if (startupWords > 0) {
+      startupWords--;
+      continue;
+    }
+    if ((poolHead - poolTail) == ENTROPY_POOL_WORDS) {
+      // Pool full: let the FIFO fill up and the TRNG stop until words are
+      // taken out
+      TRNG0->CONTROL &= ~TRNG_CONTROL_FULLIEN;
+      break;
+    }
+    pool[poolHead & (ENTROPY_POOL_WORDS - 1)] = word;
+    poolHead++;
+    poolWords++;
+  }
+
+  // The flag is sticky, the FIFO fills up again from now on
+  TRNG0->STATUS &= ~TRNG_STATUS_FULLIF;
+}
+
+/***************************************************************************//**
+ * Take a seed out of the pool.
+ *
+ * @return False if the pool does not hold a whole seed.
+ ******************************************************************************/
+static bool pool_take_seed(uint32_t *seed)
+{
+  bool taken = false;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  if ((poolHead - poolTail) >= CHACHA_DRBG_SEED_WORDS) {
+    for (uint32_t i = 0; i < CHACHA_DRBG_SEED_WORDS; i++) {
+      seed[i] = pool[poolTail & (ENTROPY_POOL_WORDS - 1)];
+      pool[poolTail & (ENTROPY_POOL_WORDS - 1)] = 0;
+      poolTail++;
+    }
+    taken = true;
+    // There is room again
+    TRNG0->CONTROL |= TRNG_CONTROL_FULLIEN;
+  }
+  CORE_EXIT_ATOMIC();
+
+  return taken;
+}
+
+/***************************************************************************//**
+ * Start filling the pool.
+ ******************************************************************************/
+void entropy_pool_init(void)
+{
+  CMU_ClockEnable(cmuClock_TRNG0, true);
+
+  // Conditioned output with the NIST and AIS31 start-up tests
+  TRNG0->CONTROL &= ~(TRNG_CONTROL_ENABLE | TRNG_CONTROL_TESTEN
+                      | TRNG_CONTROL_CONDBYPASS | TRNG_CONTROL_BYPNIST
+                      | TRNG_CONTROL_BYPAIS31);
+  TRNG0->CONTROL |= TRNG_CONTROL_ALMIEN | TRNG_CONTROL_PREIEN
+                    | TRNG_CONTROL_APT4096IEN | TRNG_CONTROL_APT64IEN
+                    | TRNG_CONTROL_REPCOUNTIEN;
+
+  poolHead = 0;
+  poolTail = 0;
+  bytesSinceReseed = 0;
+  drbg.seeded = false;
+
+  NVIC_ClearPendingIRQ(TRNG0_IRQn);
+  NVIC_EnableIRQ(TRNG0_IRQn);
+
+  trng_restart();
+}
+
+/***************************************************************************//**
+ * Check whether random data can be generated.
+ ******************************************************************************/
+bool entropy_pool_ready(void)
+{
+  return drbg.seeded || ((poolHead - poolTail) >= CHACHA_DRBG_SEED_WORDS);
+}
+
+/***************************************************************************//**
+ * Get random bytes.
+ ******************************************************************************/
+bool entropy_pool_get_random(uint8_t *buffer, size_t length)
+{
+  uint32_t seed[CHACHA_DRBG_SEED_WORDS];
+
+  if (!drbg.seeded || (bytesSinceReseed >= ENTROPY_POOL_RESEED_BYTES)) {
+    if (pool_take_seed(seed)) {
+      chacha_drbg_reseed(&drbg, seed);
+      bytesSinceReseed = 0;
+    } else if (!drbg.seeded
+               || (bytesSinceReseed >= ENTROPY_POOL_RESEED_LIMIT)) {
+      // The TRNG keeps failing, do not stretch the last seed any further
+      return false;
+    }
+  }
+
+  chacha_drbg_generate(&drbg, buffer, length);
+  if (length > (ENTROPY_POOL_RESEED_LIMIT - bytesSinceReseed)) {
+    bytesSinceReseed = ENTROPY_POOL_RESEED_LIMIT;
+  } else {
+    bytesSinceReseed += length;
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * Get the pool counters.
+ ******************************************************************************/
+void entropy_pool_stats_get(entropy_pool_stats_t *stats)
+{
+  stats->words = poolWords;
+  stats->level = poolHead - poolTail;
+  stats->rctFailures = health.rctFailures;
+  stats->aptFailures = health.aptFailures;
+  stats->alarms = poolAlarms;
+  stats->reseeds = drbg.reseeds;
+}
@@ -0,0 +1,316 @@
+/***************************************************************************//**
+ * @file entropy_host_test.c
+ * @brief Host tests of the entropy pool DRBG and health tests
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2025 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+/*
+ * Host tests of the DRBG and of the health tests, with good and injected bad
+ * sources.
+ *
+ * Build:
+ *   cc -O2 -I../inc -o entropy_host_test entropy_host_test.c \
+ *      ../src/chacha_drbg.c ../src/entropy_health.c
+ *
+ * Usage:
+ *   entropy_host_test [megabytes]
+ *
+ *   megabytes: good source data run through the health tests, which must
+ *   not raise a false alarm (default 64)
+ *
+ * Exits with 1 if a test fails.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "chacha_drbg.h"
+#include "entropy_health.h"
+
+static uint32_t failed = 0;
+
+#define CHECK(condition, name)                    \
+  do {                                            \
+    if (condition) {                              \
+      printf("pass  %s\n", name);                 \
+    } else {                                      \
+      printf("FAIL  %s\n", name);                 \
+      failed++;                                   \
+    }                                             \
+  } while (0)
+
+/*
+ * Injected sources: each returns the next byte.
+ */
+typedef uint8_t (*source_t)(uint32_t index);
+
+static chacha_drbg_t goodDrbg;
+
+static uint8_t source_good(uint32_t index)
+{
+  static uint8_t buffer[4096];
+  static uint32_t position = sizeof(buffer);
+
+  (void)index;
+  if (position == sizeof(buffer)) {
+    chacha_drbg_generate(&goodDrbg, buffer, sizeof(buffer));
+    position = 0;
+  }
+  return buffer[position++];
+}
+
+// Output stuck at one value
+static uint8_t source_stuck(uint32_t index)
+{
+  (void)index;
+  return 0xA5;
+}
+
+// Good, then stuck after 100000 bytes
+static uint8_t source_late_stuck(uint32_t index)
+{
+  return (index < 100000) ? source_good(index) : 0x00;
+}
+
+// Only 4 bits of entropy per byte, never twice the same in a row
+static uint8_t source_biased(uint32_t index)
+{
+  static uint8_t last = 0;
+  uint8_t sample;
+
+  (void)index;
+  do {
+    sample = source_good(index) & 0x0F;
+  } while (sample == last);
+  last = sample;
+  return sample;
+}
+
+// One value every other byte, on the bytes starting the proportion windows.
+// The adaptive proportion test only counts the value starting a window.
+static uint8_t source_interleaved(uint32_t index)
+{
+  return (index & 1) ? source_good(index) : 0x00;
+}
+
+/***************************************************************************//**
+ * Run a source through the health tests.
+ *
+ * @return Index of the first failing sample, or count if none failed.
+ ******************************************************************************/
+static uint32_t health_run(source_t source, uint32_t count,
+                           entropy_health_t *health)
+{
+  memset(health, 0, sizeof(*health));
+  entropy_health_reset(health);
+  for (uint32_t i = 0; i < count; i++) {
+    if (!entropy_health_sample(health, source(i))) {
+      return i;
+    }
+  }
+  return count;
+}
+
+/***************************************************************************//**
+ * ChaCha20 block function test vector of RFC 8439 section 2.3.2.
+ ******************************************************************************/
+static void test_chacha20(void)
+{
+  static const uint32_t expected[16] = {
+    0xe4e7f110, 0x15593bd1, 0x1fdd0f50, 0xc47120a3,
+    0xc7f4d1c7, 0x0368c033, 0x9aaa2204, 0x4e6cd4c3,
+    0x466482d2, 0x09aa9f07, 0x05d7c214, 0xa2028bd9,
+    0xd19c12b5, 0xb94e16de, 0xe883d0cb, 0x4e3c50a2
+  };
+  static const uint32_t nonce[3] = { 0x09000000, 0x4a000000, 0x00000000 };
+  uint32_t key[8];
+  uint32_t block[16];
+
+  for (uint32_t i = 0; i < 8; i++) {
+    key[i] = 0x03020100 + 0x04040404 * i;
+  }
+  chacha20_block(key, 1, nonce, block);
+  CHECK(memcmp(block, expected, sizeof(block)) == 0,
+        "ChaCha20 block, RFC 8439 2.3.2");
+}
+
+/***************************************************************************//**
+ * DRBG behaviour.
+ ******************************************************************************/
+static void test_drbg(void)
+{
+  static const size_t lengths[] = { 0, 1, 31, 32, 33, 63, 64, 65, 1000 };
+  chacha_drbg_t a, b;
+  uint32_t seed[CHACHA_DRBG_SEED_WORDS], key[8];
+  uint8_t x[1000], y[1000];
+  bool same = true, differ = true;
+
+  memset(&a, 0, sizeof(a));
+  CHECK(!chacha_drbg_generate(&a, x, sizeof(x)), "unseeded DRBG refuses");
+
+  for (uint32_t i = 0; i < CHACHA_DRBG_SEED_WORDS; i++) {
+    seed[i] = 0x9E3779B9 * (i + 1);
+  }
+  memset(&b, 0, sizeof(b));
+  chacha_drbg_reseed(&a, seed);
+  chacha_drbg_reseed(&b, seed);
+  for (uint32_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+    memset(x, 0, sizeof(x));
+    memset(y, 0, sizeof(y));
+    chacha_drbg_generate(&a, x, lengths[i]);
+    chacha_drbg_generate(&b, y, lengths[i]);
+    same &= (memcmp(x, y, sizeof(x)) == 0);
+    // Nothing is written past the requested length
+    for (size_t j = lengths[i]; j < sizeof(x); j++) {
+      same &= (x[j] == 0);
+    }
+  }
+  CHECK(same, "same seed, same output, any length");
+
+  memcpy(key, a.key, sizeof(key));
+  chacha_drbg_generate(&a, x, 64);
+  chacha_drbg_generate(&a, y, 64);
+  CHECK((memcmp(x, y, 64) != 0) && (memcmp(key, a.key, sizeof(key)) != 0),
+        "requests differ and replace the key");
+  differ = (memcmp(&y[0], a.key, 32) != 0) && (memcmp(&y[32], a.key, 32) != 0);
+  CHECK(differ, "key is never output");
+
+  chacha_drbg_reseed(&a, seed);
+  chacha_drbg_generate(&a, x, 64);
+  chacha_drbg_generate(&b, y, 64);
+  chacha_drbg_generate(&b, y, 64);
+  CHECK(memcmp(x, y, 64) != 0, "reseed changes the output");
+
+  seed[0] ^= 1;
+  memset(&b, 0, sizeof(b));
+  chacha_drbg_reseed(&b, seed);
+  seed[0] ^= 1;
+  memset(&a, 0, sizeof(a));
+  chacha_drbg_reseed(&a, seed);
+  chacha_drbg_generate(&a, x, 64);
+  chacha_drbg_generate(&b, y, 64);
+  CHECK(memcmp(x, y, 64) != 0, "one seed bit changes the output");
+}
+
+/***************************************************************************//**
+ * Byte distribution and throughput of the DRBG.
+ ******************************************************************************/
+static void test_drbg_output(uint32_t megabytes)
+{
+  static uint8_t buffer[65536];
+  uint64_t counts[256] = { 0 };
+  uint64_t total = (uint64_t)megabytes << 20;
+  double chi2 = 0.0, expected, seconds;
+  clock_t start;
+
+  start = clock();
+  for (uint64_t done = 0; done < total; done += sizeof(buffer)) {
+    chacha_drbg_generate(&goodDrbg, buffer, sizeof(buffer));
+    for (uint32_t i = 0; i < sizeof(buffer); i++) {
+      counts[buffer[i]]++;
+    }
+  }
+  seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  expected = (double)total / 256;
+  for (uint32_t i = 0; i < 256; i++) {
+    chi2 += (counts[i] - expected) * (counts[i] - expected) / expected;
+  }
+  // 255 degrees of freedom, p = 0.0001 at either end
+  CHECK((chi2 > 180.0) && (chi2 < 350.0), "DRBG byte distribution");
+  printf("      chi-square %.1f over %u MB, %.1f MB/s with counting\n",
+         chi2, megabytes, seconds > 0 ? megabytes / seconds : 0.0);
+}
+
+/***************************************************************************//**
+ * Health tests against good and bad sources.
+ ******************************************************************************/
+static void test_health(uint32_t megabytes)
+{
+  entropy_health_t health;
+  uint32_t count = megabytes << 20;
+  uint32_t at;
+
+  at = health_run(source_good, count, &health);
+  CHECK(at == count, "good source passes");
+  printf("      %u MB, %u repetition and %u proportion failures\n",
+         megabytes, health.rctFailures, health.aptFailures);
+
+  at = health_run(source_stuck, 1000, &health);
+  CHECK((at == ENTROPY_HEALTH_RCT_CUTOFF - 1) && (health.rctFailures == 1),
+        "stuck source fails the repetition count test at once");
+
+  at = health_run(source_late_stuck, 200000, &health);
+  CHECK((at >= 100000) && (at < 100000 + ENTROPY_HEALTH_RCT_CUTOFF),
+        "source stuck later fails within the cutoff");
+
+  at = health_run(source_biased, 100000, &health);
+  CHECK((at < ENTROPY_HEALTH_APT_WINDOW) && (health.aptFailures == 1)
+        && (health.rctFailures == 0),
+        "4-bit source fails the adaptive proportion test in one window");
+
+  at = health_run(source_interleaved, 100000, &health);
+  CHECK((at < ENTROPY_HEALTH_APT_WINDOW) && (health.aptFailures == 1),
+        "source stuck every other byte fails the adaptive proportion test");
+
+  // The tests start over after a failure
+  memset(&health, 0, sizeof(health));
+  entropy_health_reset(&health);
+  for (uint32_t i = 0; i < 3 * ENTROPY_HEALTH_RCT_CUTOFF; i++) {
+    entropy_health_sample(&health, 0x5A);
+  }
+  CHECK(health.rctFailures == 3, "failures are counted once per cutoff");
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t megabytes = 64;
+  uint32_t seed[CHACHA_DRBG_SEED_WORDS];
+
+  if (argc > 1) {
+    megabytes = (uint32_t)strtoul(argv[1], NULL, 0);
+  }
+  for (uint32_t i = 0; i < CHACHA_DRBG_SEED_WORDS; i++) {
+    seed[i] = (uint32_t)time(NULL) * (2 * i + 1);
+  }
+  chacha_drbg_reseed(&goodDrbg, seed);
+
+  test_chacha20();
+  test_drbg();
+  test_drbg_output(megabytes);
+  test_health(megabytes);
+
+  printf("%s\n", failed ? "FAILED" : "all passed");
+  return failed ? 1 : 0;
+}